@@ -0,0 +1,464 @@
+#include "AssetArchive.h"
+#include "ContentHash.h"
+#include "Lz4.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT.
+    const uint64_t PitchAlignment = 256;
+    const uint64_t PlacementAlignment = 512;
+
+    inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+bool GetFormatBlockInfo(uint32_t dxgiFormat, uint32_t& blockDimension, uint32_t& bytesPerBlock)
+{
+    blockDimension = 1;
+
+    // Values are DXGI_FORMAT; this file has no dependency on the Windows headers.
+    if (dxgiFormat >= 1 && dxgiFormat <= 4)            // R32G32B32A32
+    {
+        bytesPerBlock = 16;
+    }
+    else if (dxgiFormat >= 9 && dxgiFormat <= 18)      // R16G16B16A16, R32G32
+    {
+        bytesPerBlock = 8;
+    }
+    else if ((dxgiFormat >= 23 && dxgiFormat <= 43) || dxgiFormat == 67 || (dxgiFormat >= 87 && dxgiFormat <= 93 && dxgiFormat != 89))
+    {
+        // R10G10B10A2, R11G11B10, R8G8B8A8, R16G16, R32, R9G9B9E5, B8G8R8A8/X8.
+        bytesPerBlock = 4;
+    }
+    else if ((dxgiFormat >= 48 && dxgiFormat <= 59) || dxgiFormat == 85 || dxgiFormat == 86)
+    {
+        // R8G8, R16, B5G6R5, B5G5R5A1.
+        bytesPerBlock = 2;
+    }
+    else if (dxgiFormat >= 60 && dxgiFormat <= 64)     // R8
+    {
+        bytesPerBlock = 1;
+    }
+    else if ((dxgiFormat >= 70 && dxgiFormat <= 72) || (dxgiFormat >= 79 && dxgiFormat <= 81))
+    {
+        // BC1, BC4.
+        blockDimension = 4;
+        bytesPerBlock = 8;
+    }
+    else if ((dxgiFormat >= 73 && dxgiFormat <= 78) || (dxgiFormat >= 82 && dxgiFormat <= 84) || (dxgiFormat >= 94 && dxgiFormat <= 99))
+    {
+        // BC2, BC3, BC5, BC6H, BC7.
+        blockDimension = 4;
+        bytesPerBlock = 16;
+    }
+    else
+    {
+        bytesPerBlock = 0;
+        return false;
+    }
+
+    return true;
+}
+
+uint64_t ComputeCopyableFootprints(
+    uint32_t dxgiFormat,
+    uint32_t width,
+    uint32_t height,
+    uint16_t arraySize,
+    uint16_t mipLevels,
+    std::vector<SubresourceFootprint>& footprints)
+{
+    uint32_t blockDimension, bytesPerBlock;
+    if (!GetFormatBlockInfo(dxgiFormat, blockDimension, bytesPerBlock))
+    {
+        throw std::invalid_argument("ComputeCopyableFootprints: unsupported format");
+    }
+
+    footprints.resize(static_cast<size_t>(arraySize) * mipLevels);
+
+    uint64_t offset = 0;
+    uint64_t totalBytes = 0;
+    for (uint16_t slice = 0; slice < arraySize; ++slice)
+    {
+        for (uint16_t mip = 0; mip < mipLevels; ++mip)
+        {
+            SubresourceFootprint& footprint = footprints[slice * mipLevels + mip];
+            footprint.Width = std::max(1u, width >> mip);
+            footprint.Height = std::max(1u, height >> mip);
+
+            const uint32_t blocksWide = (footprint.Width + blockDimension - 1) / blockDimension;
+            footprint.NumRows = (footprint.Height + blockDimension - 1) / blockDimension;
+            footprint.RowSizeInBytes = static_cast<uint64_t>(blocksWide) * bytesPerBlock;
+            footprint.RowPitch = static_cast<uint32_t>(AlignUp(footprint.RowSizeInBytes, PitchAlignment));
+
+            // Block compressed footprints are padded to whole blocks, like the runtime does.
+            footprint.Width = blocksWide * blockDimension;
+            footprint.Height = footprint.NumRows * blockDimension;
+
+            footprint.Offset = AlignUp(offset, PlacementAlignment);
+            offset = footprint.Offset + static_cast<uint64_t>(footprint.RowPitch) * footprint.NumRows;
+
+            // The last row of the last subresource is not padded to the pitch.
+            totalBytes = footprint.Offset + static_cast<uint64_t>(footprint.RowPitch) * (footprint.NumRows - 1) + footprint.RowSizeInBytes;
+        }
+    }
+
+    return totalBytes;
+}
+
+uint64_t HashAssetName(const char* name, size_t length)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<uint8_t>(name[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+AssetArchive::AssetArchive() :
+    m_data(nullptr),
+    m_size(0),
+#if defined(_WIN32)
+    m_file(INVALID_HANDLE_VALUE),
+    m_mapping(nullptr),
+#endif
+    m_header(nullptr),
+    m_assets(nullptr),
+    m_chunks(nullptr),
+    m_names(nullptr)
+{
+}
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+#if defined(_WIN32)
+
+void AssetArchive::Open(const char* path)
+{
+    std::wstring widePath(MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, &widePath[0], static_cast<int>(widePath.size()));
+    Open(widePath.c_str());
+}
+
+void AssetArchive::Open(const wchar_t* path)
+{
+    Close();
+
+    m_file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("AssetArchive: can't open file");
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+    {
+        Close();
+        throw std::runtime_error("AssetArchive: can't read file size");
+    }
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_data = m_mapping ? static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!m_data)
+    {
+        Close();
+        throw std::runtime_error("AssetArchive: can't map file");
+    }
+    m_size = static_cast<uint64_t>(size.QuadPart);
+
+    Validate();
+}
+
+void AssetArchive::Close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+    m_header = nullptr;
+    m_assets = nullptr;
+    m_chunks = nullptr;
+    m_names = nullptr;
+}
+
+void AssetArchive::Prefetch(uint32_t asset) const
+{
+    const AssetEntry& entry = m_assets[asset];
+    if (entry.ChunkCount == 0)
+    {
+        return;
+    }
+
+    const ArchiveChunk& first = m_chunks[entry.FirstChunk];
+    const ArchiveChunk& last = m_chunks[entry.FirstChunk + entry.ChunkCount - 1];
+
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<uint8_t*>(m_data + first.Offset);
+    range.NumberOfBytes = static_cast<SIZE_T>(last.Offset + last.CompressedSize - first.Offset);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+#else
+
+void AssetArchive::Open(const char* path)
+{
+    Close();
+
+    const int file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        throw std::runtime_error("AssetArchive: can't open file");
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        throw std::runtime_error("AssetArchive: can't read file size");
+    }
+
+    // The mapping keeps its own reference to the file.
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        throw std::runtime_error("AssetArchive: can't map file");
+    }
+
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = static_cast<uint64_t>(info.st_size);
+
+    Validate();
+}
+
+void AssetArchive::Close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_assets = nullptr;
+    m_chunks = nullptr;
+    m_names = nullptr;
+}
+
+void AssetArchive::Prefetch(uint32_t asset) const
+{
+    const AssetEntry& entry = m_assets[asset];
+    if (entry.ChunkCount == 0)
+    {
+        return;
+    }
+
+    const ArchiveChunk& first = m_chunks[entry.FirstChunk];
+    const ArchiveChunk& last = m_chunks[entry.FirstChunk + entry.ChunkCount - 1];
+
+    // madvise wants a page aligned start.
+    const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t begin = first.Offset & ~(pageSize - 1);
+    madvise(const_cast<uint8_t*>(m_data + begin), static_cast<size_t>(last.Offset + last.CompressedSize - begin), MADV_WILLNEED);
+}
+
+#endif
+
+void AssetArchive::Validate()
+{
+    auto fail = [this](const char* message)
+    {
+        Close();
+        throw std::runtime_error(message);
+    };
+
+    if (m_size < sizeof(AssetArchiveHeader))
+    {
+        fail("AssetArchive: file too small");
+    }
+
+    m_header = reinterpret_cast<const AssetArchiveHeader*>(m_data);
+    if (m_header->Magic != AssetArchiveMagic || m_header->Version != AssetArchiveVersion)
+    {
+        fail("AssetArchive: not an archive or unsupported version");
+    }
+
+    const uint64_t tocSize = static_cast<uint64_t>(m_header->AssetCount) * sizeof(AssetEntry);
+    const uint64_t chunkTableSize = static_cast<uint64_t>(m_header->ChunkCount) * sizeof(ArchiveChunk);
+    if (m_header->TocOffset > m_size || tocSize > m_size - m_header->TocOffset ||
+        m_header->ChunkTableOffset > m_size || chunkTableSize > m_size - m_header->ChunkTableOffset ||
+        m_header->NameTableOffset > m_size || m_header->NameTableSize > m_size - m_header->NameTableOffset ||
+        m_header->TocOffset % alignof(AssetEntry) != 0 || m_header->ChunkTableOffset % alignof(ArchiveChunk) != 0)
+    {
+        fail("AssetArchive: tables out of bounds");
+    }
+
+    m_assets = reinterpret_cast<const AssetEntry*>(m_data + m_header->TocOffset);
+    m_chunks = reinterpret_cast<const ArchiveChunk*>(m_data + m_header->ChunkTableOffset);
+    m_names = reinterpret_cast<const char*>(m_data + m_header->NameTableOffset);
+
+    // Check everything Decompress relies on once here, so loading never reads outside the file.
+    for (uint32_t a = 0; a < m_header->AssetCount; ++a)
+    {
+        const AssetEntry& asset = m_assets[a];
+        if (asset.FirstChunk > m_header->ChunkCount || asset.ChunkCount > m_header->ChunkCount - asset.FirstChunk ||
+            asset.NameOffset > m_header->NameTableSize || asset.NameLength > m_header->NameTableSize - asset.NameOffset)
+        {
+            fail("AssetArchive: asset entry out of bounds");
+        }
+
+        uint64_t payload = 0;
+        for (uint32_t c = asset.FirstChunk; c < asset.FirstChunk + asset.ChunkCount; ++c)
+        {
+            const ArchiveChunk& chunk = m_chunks[c];
+            if (chunk.Offset > m_size || chunk.CompressedSize > m_size - chunk.Offset ||
+                (chunk.Codec == ChunkCodec::Stored && chunk.CompressedSize != chunk.UncompressedSize) ||
+                (chunk.Codec != ChunkCodec::Stored && chunk.Codec != ChunkCodec::Lz4) ||
+                (c + 1 < asset.FirstChunk + asset.ChunkCount && chunk.UncompressedSize != m_header->ChunkSize))
+            {
+                fail("AssetArchive: chunk entry out of bounds");
+            }
+            payload += chunk.UncompressedSize;
+        }
+
+        if (payload != asset.PayloadSize)
+        {
+            fail("AssetArchive: chunk sizes don't add up to the payload size");
+        }
+    }
+}
+
+std::string AssetArchive::GetAssetName(uint32_t asset) const
+{
+    return std::string(m_names + m_assets[asset].NameOffset, m_assets[asset].NameLength);
+}
+
+uint32_t AssetArchive::Find(const char* name) const
+{
+    if (!m_header)
+    {
+        return NotFound;
+    }
+
+    const size_t length = strlen(name);
+    const uint64_t hash = HashAssetName(name, length);
+
+    const AssetEntry* end = m_assets + m_header->AssetCount;
+    const AssetEntry* it = std::lower_bound(m_assets, end, hash, [](const AssetEntry& entry, uint64_t value)
+    {
+        return entry.NameHash < value;
+    });
+
+    // Colliding hashes are adjacent; compare names to tell them apart.
+    for (; it != end && it->NameHash == hash; ++it)
+    {
+        if (it->NameLength == length && memcmp(m_names + it->NameOffset, name, length) == 0)
+        {
+            return static_cast<uint32_t>(it - m_assets);
+        }
+    }
+
+    return NotFound;
+}
+
+uint64_t AssetArchive::HashAssetContent(uint32_t asset) const
+{
+    const AssetEntry& entry = m_assets[asset];
+    std::vector<uint64_t> hashes(entry.ChunkCount * 2);
+    for (uint32_t c = 0; c < entry.ChunkCount; ++c)
+    {
+        const ArchiveChunk& chunk = m_chunks[entry.FirstChunk + c];
+        hashes[c * 2] = HashContent(m_data + chunk.Offset, chunk.CompressedSize);
+        hashes[c * 2 + 1] = (static_cast<uint64_t>(chunk.Codec) << 32) | chunk.UncompressedSize;
+    }
+    return HashContent(hashes.data(), hashes.size() * sizeof(uint64_t));
+}
+
+void AssetArchive::DecompressChunk(const ArchiveChunk& chunk, uint8_t* dest) const
+{
+    const uint8_t* source = m_data + chunk.Offset;
+
+    if (chunk.Codec == ChunkCodec::Stored)
+    {
+        memcpy(dest, source, chunk.UncompressedSize);
+    }
+    else
+    {
+        // LZ4 matches read back earlier output. dest is usually a write-combined upload heap
+        // where reads are uncached, so decode into a cache-sized scratch and copy it out.
+        thread_local std::vector<uint8_t> scratch;
+        scratch.resize(chunk.UncompressedSize);
+        if (!Lz4Decompress(source, chunk.CompressedSize, scratch.data(), chunk.UncompressedSize))
+        {
+            throw std::runtime_error("AssetArchive: corrupt chunk");
+        }
+        memcpy(dest, scratch.data(), chunk.UncompressedSize);
+    }
+}
+
+void AssetArchive::Decompress(uint32_t asset, void* dest, ThreadPool* pool) const
+{
+    const AssetEntry& entry = m_assets[asset];
+    uint8_t* const output = static_cast<uint8_t*>(dest);
+    const uint64_t chunkSize = m_header->ChunkSize;
+
+    // Every chunk but the last is ChunkSize bytes, so each one's destination is known up front
+    // and chunks can be decompressed in any order.
+    if (!pool || entry.ChunkCount < 2)
+    {
+        for (uint32_t c = 0; c < entry.ChunkCount; ++c)
+        {
+            DecompressChunk(m_chunks[entry.FirstChunk + c], output + c * chunkSize);
+        }
+        return;
+    }
+
+    pool->ParallelFor(entry.ChunkCount, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; ++c)
+        {
+            DecompressChunk(m_chunks[entry.FirstChunk + c], output + c * chunkSize);
+        }
+    });
+}
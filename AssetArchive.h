@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Packed asset archive.
+//
+// File layout:
+//   AssetArchiveHeader
+//   chunk payloads (compressed independently of each other)
+//   AssetEntry[AssetCount]     sorted by NameHash
+//   ArchiveChunk[ChunkCount]   every asset owns a contiguous run
+//   name table                 UTF-8, not null terminated
+//
+// An asset's payload is exactly what the GPU upload buffer must contain: texture subresources are
+// placed at the offsets and row pitches GetCopyableFootprints reports (see
+// ComputeCopyableFootprints), so loading is map, decompress every chunk straight into the mapped
+// upload memory in parallel, then one CopyTextureRegion per subresource. All values are
+// little endian.
+
+const uint32_t AssetArchiveMagic = 0x4B505844;      // "DXPK"
+const uint32_t AssetArchiveVersion = 1;
+
+enum class AssetType : uint32_t
+{
+    Buffer = 0,
+    Texture2D = 1,
+};
+
+// Zstandard is not a chunk codec: there is only a decoder (Zstd.h), and it decodes at about half
+// the speed of LZ4, which is what loading from the archive is bound by.
+enum class ChunkCodec : uint32_t
+{
+    Stored = 0,
+    Lz4 = 1,
+};
+
+struct AssetArchiveHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t AssetCount;
+    uint32_t ChunkCount;
+    uint32_t ChunkSize;         // Uncompressed size of every chunk but the last one of an asset.
+    uint32_t NameTableSize;
+    uint64_t TocOffset;
+    uint64_t ChunkTableOffset;
+    uint64_t NameTableOffset;
+};
+static_assert(sizeof(AssetArchiveHeader) == 48, "AssetArchiveHeader is part of the file format.");
+
+struct AssetEntry
+{
+    uint64_t NameHash;
+    uint32_t NameOffset;
+    uint32_t NameLength;
+    AssetType Type;
+    uint32_t Format;            // DXGI_FORMAT of a texture.
+    uint32_t Width;             // Texture width, or buffer size in bytes.
+    uint32_t Height;
+    uint16_t ArraySize;
+    uint16_t MipLevels;
+    uint32_t FirstChunk;
+    uint32_t ChunkCount;
+    uint32_t Reserved;
+    uint64_t PayloadSize;
+};
+static_assert(sizeof(AssetEntry) == 56, "AssetEntry is part of the file format.");
+
+struct ArchiveChunk
+{
+    uint64_t Offset;
+    uint32_t CompressedSize;
+    uint32_t UncompressedSize;
+    ChunkCodec Codec;
+    uint32_t Reserved;
+};
+static_assert(sizeof(ArchiveChunk) == 24, "ArchiveChunk is part of the file format.");
+
+// Same meaning as D3D12_PLACED_SUBRESOURCE_FOOTPRINT plus the GetCopyableFootprints row outputs.
+struct SubresourceFootprint
+{
+    uint64_t Offset;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t RowPitch;
+    uint32_t NumRows;
+    uint64_t RowSizeInBytes;
+};
+
+// Pixels per block edge (1 for uncompressed formats) and bytes per block, or false if the format
+// is not supported by the archive.
+bool GetFormatBlockInfo(uint32_t dxgiFormat, uint32_t& blockDimension, uint32_t& bytesPerBlock);
+
+// Footprints of every subresource of a 2D texture (mip fastest, then array slice), laid out the way
+// ID3D12Device::GetCopyableFootprints does with a base offset of 0. Returns the total size.
+uint64_t ComputeCopyableFootprints(
+    uint32_t dxgiFormat,
+    uint32_t width,
+    uint32_t height,
+    uint16_t arraySize,
+    uint16_t mipLevels,
+    std::vector<SubresourceFootprint>& footprints);
+
+// 64-bit FNV-1a of an asset name, as stored in AssetEntry::NameHash.
+uint64_t HashAssetName(const char* name, size_t length);
+
+// Read side of the archive. The file is memory mapped; nothing is copied until Decompress.
+class AssetArchive
+{
+public:
+    static const uint32_t NotFound = 0xFFFFFFFF;
+
+    AssetArchive();
+    ~AssetArchive();
+
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    // Throws std::runtime_error if the file can't be mapped or is not a valid archive.
+    void Open(const char* path);
+#if defined(_WIN32)
+    void Open(const wchar_t* path);
+#endif
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    uint32_t GetAssetCount() const { return m_header ? m_header->AssetCount : 0; }
+    const AssetEntry& GetAsset(uint32_t asset) const { return m_assets[asset]; }
+    std::string GetAssetName(uint32_t asset) const;
+
+    // Binary search on the name hash. Returns NotFound if the archive has no such asset.
+    uint32_t Find(const char* name) const;
+
+    // Content hash of the asset (HashContent of the chunk hashes), computed from the stored
+    // chunks without decompressing them, so a resource cache can find a copy already on the GPU
+    // before anything is read into an upload heap. Equal payloads stored with different codecs
+    // or chunk sizes hash differently, which only costs a missed share.
+    uint64_t HashAssetContent(uint32_t asset) const;
+
+    // Hints the OS to start reading the asset's chunks from disk.
+    void Prefetch(uint32_t asset) const;
+
+    // Decompresses the whole payload to dest, which must hold PayloadSize bytes. dest is only
+    // written, never read, so it can be mapped upload heap memory. Chunks are spread over the
+    // pool. Throws std::runtime_error on corrupt data.
+    void Decompress(uint32_t asset, void* dest, ThreadPool* pool = nullptr) const;
+
+private:
+    void Validate();
+    void DecompressChunk(const ArchiveChunk& chunk, uint8_t* dest) const;
+
+    const uint8_t* m_data;
+    uint64_t m_size;
+#if defined(_WIN32)
+    void* m_file;
+    void* m_mapping;
+#endif
+
+    const AssetArchiveHeader* m_header;
+    const AssetEntry* m_assets;
+    const ArchiveChunk* m_chunks;
+    const char* m_names;
+};
@@ -0,0 +1,491 @@
+#include "AssetPacker.h"
+#include "Lz4.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace
+{
+    const uint32_t DdsMagic = 0x20534444;       // "DDS "
+
+    const uint32_t DdsPixelFormatFourCC = 0x4;
+    const uint32_t DdsPixelFormatRgb = 0x40;
+    const uint32_t DdsCaps2CubeMap = 0x200;
+    const uint32_t DdsCaps2Volume = 0x200000;
+    const uint32_t DdsResourceMiscTextureCube = 0x4;
+    const uint32_t DdsDimensionTexture2D = 3;
+
+    struct DdsPixelFormat
+    {
+        uint32_t Size;
+        uint32_t Flags;
+        uint32_t FourCC;
+        uint32_t RgbBitCount;
+        uint32_t RBitMask;
+        uint32_t GBitMask;
+        uint32_t BBitMask;
+        uint32_t ABitMask;
+    };
+
+    struct DdsHeader
+    {
+        uint32_t Size;
+        uint32_t Flags;
+        uint32_t Height;
+        uint32_t Width;
+        uint32_t PitchOrLinearSize;
+        uint32_t Depth;
+        uint32_t MipMapCount;
+        uint32_t Reserved1[11];
+        DdsPixelFormat PixelFormat;
+        uint32_t Caps;
+        uint32_t Caps2;
+        uint32_t Caps3;
+        uint32_t Caps4;
+        uint32_t Reserved2;
+    };
+    static_assert(sizeof(DdsHeader) == 124, "DDS header size");
+
+    struct DdsHeaderDx10
+    {
+        uint32_t DxgiFormat;
+        uint32_t ResourceDimension;
+        uint32_t MiscFlag;
+        uint32_t ArraySize;
+        uint32_t MiscFlags2;
+    };
+
+    inline uint32_t MakeFourCC(char a, char b, char c, char d)
+    {
+        return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+    }
+
+    // DXGI_FORMAT of the legacy (pre DX10 header) pixel formats worth supporting.
+    uint32_t GetLegacyDdsFormat(const DdsPixelFormat& format)
+    {
+        if (format.Flags & DdsPixelFormatFourCC)
+        {
+            const uint32_t fourCC = format.FourCC;
+            if (fourCC == MakeFourCC('D', 'X', 'T', '1')) return 71;                                            // BC1_UNORM
+            if (fourCC == MakeFourCC('D', 'X', 'T', '2') || fourCC == MakeFourCC('D', 'X', 'T', '3')) return 74; // BC2_UNORM
+            if (fourCC == MakeFourCC('D', 'X', 'T', '4') || fourCC == MakeFourCC('D', 'X', 'T', '5')) return 77; // BC3_UNORM
+            if (fourCC == MakeFourCC('A', 'T', 'I', '1') || fourCC == MakeFourCC('B', 'C', '4', 'U')) return 80; // BC4_UNORM
+            if (fourCC == MakeFourCC('A', 'T', 'I', '2') || fourCC == MakeFourCC('B', 'C', '5', 'U')) return 83; // BC5_UNORM
+            return 0;
+        }
+
+        if ((format.Flags & DdsPixelFormatRgb) && format.RgbBitCount == 32)
+        {
+            if (format.RBitMask == 0x000000FF && format.GBitMask == 0x0000FF00 && format.BBitMask == 0x00FF0000) return 28;   // R8G8B8A8_UNORM
+            if (format.RBitMask == 0x00FF0000 && format.GBitMask == 0x0000FF00 && format.BBitMask == 0x000000FF) return 87;   // B8G8R8A8_UNORM
+        }
+
+        return 0;
+    }
+
+    // Sum of the tightly packed subresource sizes.
+    size_t GetTightTextureSize(uint32_t dxgiFormat, uint32_t width, uint32_t height, uint16_t arraySize, uint16_t mipLevels)
+    {
+        uint32_t blockDimension, bytesPerBlock;
+        GetFormatBlockInfo(dxgiFormat, blockDimension, bytesPerBlock);
+
+        size_t size = 0;
+        for (uint16_t mip = 0; mip < mipLevels; ++mip)
+        {
+            const size_t blocksWide = (std::max(1u, width >> mip) + blockDimension - 1) / blockDimension;
+            const size_t blocksHigh = (std::max(1u, height >> mip) + blockDimension - 1) / blockDimension;
+            size += blocksWide * blocksHigh * bytesPerBlock;
+        }
+        return size * arraySize;
+    }
+
+    std::string GetAssetNameFromPath(const std::string& path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        const size_t dot = name.find_last_of('.');
+        if (dot != std::string::npos && dot > 0)
+        {
+            name.resize(dot);
+        }
+        return name;
+    }
+
+    bool HasExtension(const std::string& path, const char* extension)
+    {
+        const size_t length = strlen(extension);
+        if (path.size() < length)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < length; ++i)
+        {
+            const char c = path[path.size() - length + i];
+            if ((c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c) != extension[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The tool runs inside the GUI executable, which has no console of its own and whose
+    // std::cout goes nowhere. Messages go to redirected output if there is some, else to the
+    // console of the command prompt that started it, else to a message box. They are also sent to
+    // the debugger.
+    void WriteToolMessage(const std::string& message, bool error)
+    {
+        const std::string line = message + "\n";
+#if defined(_WIN32)
+        OutputDebugStringA(line.c_str());
+
+        DWORD written = 0;
+        const HANDLE output = GetStdHandle(error ? STD_ERROR_HANDLE : STD_OUTPUT_HANDLE);
+        if (output != nullptr && output != INVALID_HANDLE_VALUE &&
+            WriteFile(output, line.data(), static_cast<DWORD>(line.size()), &written, nullptr))
+        {
+            return;
+        }
+
+        if (AttachConsole(ATTACH_PARENT_PROCESS) || GetLastError() == ERROR_ACCESS_DENIED)
+        {
+            const HANDLE console = CreateFileA("CONOUT$", GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+            if (console != INVALID_HANDLE_VALUE)
+            {
+                WriteFile(console, line.data(), static_cast<DWORD>(line.size()), &written, nullptr);
+                CloseHandle(console);
+                return;
+            }
+        }
+
+        MessageBoxA(nullptr, message.c_str(), "DX12Study asset packer", error ? MB_ICONERROR : MB_ICONINFORMATION);
+#else
+        fputs(line.c_str(), error ? stderr : stdout);
+#endif
+    }
+}
+
+AssetPacker::AssetPacker(ThreadPool* pool, uint32_t chunkSize) :
+    m_pool(pool),
+    m_chunkSize(chunkSize)
+{
+    if (chunkSize == 0)
+    {
+        throw std::invalid_argument("AssetPacker: chunk size must not be 0");
+    }
+}
+
+void AssetPacker::AddBuffer(const std::string& name, const void* data, size_t size)
+{
+    if (size > 0xFFFFFFFFull)
+    {
+        throw std::invalid_argument("AssetPacker: buffers are limited to 4 GB");
+    }
+
+    PendingAsset asset = {};
+    asset.Name = name;
+    asset.Entry.Type = AssetType::Buffer;
+    asset.Entry.Width = static_cast<uint32_t>(size);
+    asset.Entry.Height = 1;
+    asset.Entry.ArraySize = 1;
+    asset.Entry.MipLevels = 1;
+    asset.Payload.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    m_assets.push_back(std::move(asset));
+}
+
+void AssetPacker::AddTexture2D(
+    const std::string& name,
+    uint32_t dxgiFormat,
+    uint32_t width,
+    uint32_t height,
+    uint16_t arraySize,
+    uint16_t mipLevels,
+    const void* data,
+    size_t dataSize)
+{
+    uint32_t blockDimension, bytesPerBlock;
+    if (!GetFormatBlockInfo(dxgiFormat, blockDimension, bytesPerBlock))
+    {
+        throw std::invalid_argument("AssetPacker: unsupported texture format");
+    }
+    if (width == 0 || height == 0 || arraySize == 0 || mipLevels == 0)
+    {
+        throw std::invalid_argument("AssetPacker: empty texture");
+    }
+    if (dataSize < GetTightTextureSize(dxgiFormat, width, height, arraySize, mipLevels))
+    {
+        throw std::invalid_argument("AssetPacker: texture data is smaller than its description");
+    }
+
+    PendingAsset asset = {};
+    asset.Name = name;
+    asset.Entry.Type = AssetType::Texture2D;
+    asset.Entry.Format = dxgiFormat;
+    asset.Entry.Width = width;
+    asset.Entry.Height = height;
+    asset.Entry.ArraySize = arraySize;
+    asset.Entry.MipLevels = mipLevels;
+
+    // Re-lay the tightly packed rows at the upload footprint pitches. Padding stays zero, which
+    // costs next to nothing once compressed.
+    std::vector<SubresourceFootprint> footprints;
+    asset.Payload.assign(ComputeCopyableFootprints(dxgiFormat, width, height, arraySize, mipLevels, footprints), 0);
+
+    const uint8_t* source = static_cast<const uint8_t*>(data);
+    for (const SubresourceFootprint& footprint : footprints)
+    {
+        for (uint32_t row = 0; row < footprint.NumRows; ++row)
+        {
+            memcpy(&asset.Payload[footprint.Offset + static_cast<uint64_t>(row) * footprint.RowPitch], source, footprint.RowSizeInBytes);
+            source += footprint.RowSizeInBytes;
+        }
+    }
+
+    m_assets.push_back(std::move(asset));
+}
+
+void AssetPacker::AddDdsTexture(const std::string& name, const void* fileData, size_t fileSize)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(fileData);
+    if (fileSize < sizeof(uint32_t) + sizeof(DdsHeader))
+    {
+        throw std::invalid_argument("AssetPacker: DDS file too small");
+    }
+
+    uint32_t magic;
+    memcpy(&magic, bytes, sizeof(magic));
+    DdsHeader header;
+    memcpy(&header, bytes + sizeof(magic), sizeof(header));
+    if (magic != DdsMagic || header.Size != sizeof(DdsHeader) || header.PixelFormat.Size != sizeof(DdsPixelFormat))
+    {
+        throw std::invalid_argument("AssetPacker: not a DDS file");
+    }
+
+    size_t dataOffset = sizeof(magic) + sizeof(header);
+    uint32_t format = 0;
+    uint32_t arraySize = 1;
+    if ((header.PixelFormat.Flags & DdsPixelFormatFourCC) && header.PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0'))
+    {
+        if (fileSize < dataOffset + sizeof(DdsHeaderDx10))
+        {
+            throw std::invalid_argument("AssetPacker: DDS file too small");
+        }
+
+        DdsHeaderDx10 dx10;
+        memcpy(&dx10, bytes + dataOffset, sizeof(dx10));
+        dataOffset += sizeof(dx10);
+
+        if (dx10.ResourceDimension != DdsDimensionTexture2D)
+        {
+            throw std::invalid_argument("AssetPacker: only 2D DDS textures are supported");
+        }
+        format = dx10.DxgiFormat;
+        arraySize = std::max(1u, dx10.ArraySize) * ((dx10.MiscFlag & DdsResourceMiscTextureCube) ? 6 : 1);
+    }
+    else
+    {
+        if (header.Caps2 & DdsCaps2Volume)
+        {
+            throw std::invalid_argument("AssetPacker: only 2D DDS textures are supported");
+        }
+        format = GetLegacyDdsFormat(header.PixelFormat);
+        arraySize = (header.Caps2 & DdsCaps2CubeMap) ? 6 : 1;
+    }
+
+    if (arraySize > 0xFFFF)
+    {
+        throw std::invalid_argument("AssetPacker: DDS array too large");
+    }
+
+    AddTexture2D(
+        name,
+        format,
+        header.Width,
+        header.Height,
+        static_cast<uint16_t>(arraySize),
+        static_cast<uint16_t>(std::max(1u, header.MipMapCount)),
+        bytes + dataOffset,
+        fileSize - dataOffset);
+}
+
+void AssetPacker::Write(const std::string& path) const
+{
+    // The table of contents is sorted by name hash so the loader can binary search it.
+    std::vector<const PendingAsset*> order;
+    for (const PendingAsset& asset : m_assets)
+    {
+        order.push_back(&asset);
+    }
+    std::sort(order.begin(), order.end(), [](const PendingAsset* a, const PendingAsset* b)
+    {
+        const uint64_t hashA = HashAssetName(a->Name.data(), a->Name.size());
+        const uint64_t hashB = HashAssetName(b->Name.data(), b->Name.size());
+        return hashA != hashB ? hashA < hashB : a->Name < b->Name;
+    });
+
+    std::vector<AssetEntry> toc;
+    std::string names;
+    struct ChunkSource
+    {
+        const uint8_t* Data;
+        uint32_t Size;
+    };
+    std::vector<ChunkSource> sources;
+
+    for (const PendingAsset* asset : order)
+    {
+        AssetEntry entry = asset->Entry;
+        entry.NameHash = HashAssetName(asset->Name.data(), asset->Name.size());
+        entry.NameOffset = static_cast<uint32_t>(names.size());
+        entry.NameLength = static_cast<uint32_t>(asset->Name.size());
+        entry.FirstChunk = static_cast<uint32_t>(sources.size());
+        entry.PayloadSize = asset->Payload.size();
+        names += asset->Name;
+
+        for (size_t offset = 0; offset < asset->Payload.size(); offset += m_chunkSize)
+        {
+            const size_t size = std::min<size_t>(m_chunkSize, asset->Payload.size() - offset);
+            sources.push_back({ asset->Payload.data() + offset, static_cast<uint32_t>(size) });
+        }
+        entry.ChunkCount = static_cast<uint32_t>(sources.size()) - entry.FirstChunk;
+        toc.push_back(entry);
+    }
+
+    // Chunks are independent, so they compress in parallel just like they decompress.
+    std::vector<std::vector<uint8_t>> compressed(sources.size());
+    auto compressRange = [&](size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; ++c)
+        {
+            std::vector<uint8_t>& out = compressed[c];
+            out.resize(Lz4CompressBound(sources[c].Size));
+            const size_t size = Lz4Compress(sources[c].Data, sources[c].Size, out.data(), out.size());
+            // Keep chunks that don't shrink stored; they load with a plain memcpy.
+            out.resize(size > 0 && size < sources[c].Size ? size : 0);
+        }
+    };
+    if (m_pool)
+    {
+        m_pool->ParallelFor(sources.size(), 1, compressRange);
+    }
+    else
+    {
+        compressRange(0, sources.size());
+    }
+
+    AssetArchiveHeader header = {};
+    header.Magic = AssetArchiveMagic;
+    header.Version = AssetArchiveVersion;
+    header.AssetCount = static_cast<uint32_t>(toc.size());
+    header.ChunkCount = static_cast<uint32_t>(sources.size());
+    header.ChunkSize = m_chunkSize;
+    header.NameTableSize = static_cast<uint32_t>(names.size());
+
+    std::vector<ArchiveChunk> chunks(sources.size());
+    uint64_t offset = sizeof(AssetArchiveHeader);
+    for (size_t c = 0; c < sources.size(); ++c)
+    {
+        const bool stored = compressed[c].empty();
+        chunks[c].Offset = offset;
+        chunks[c].UncompressedSize = sources[c].Size;
+        chunks[c].CompressedSize = stored ? sources[c].Size : static_cast<uint32_t>(compressed[c].size());
+        chunks[c].Codec = stored ? ChunkCodec::Stored : ChunkCodec::Lz4;
+        chunks[c].Reserved = 0;
+        offset += chunks[c].CompressedSize;
+    }
+
+    const uint64_t tablePadding = (8 - offset % 8) % 8;
+    header.TocOffset = offset + tablePadding;
+    header.ChunkTableOffset = header.TocOffset + toc.size() * sizeof(AssetEntry);
+    header.NameTableOffset = header.ChunkTableOffset + chunks.size() * sizeof(ArchiveChunk);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("AssetPacker: can't create " + path);
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t c = 0; c < sources.size(); ++c)
+    {
+        if (compressed[c].empty())
+        {
+            file.write(reinterpret_cast<const char*>(sources[c].Data), sources[c].Size);
+        }
+        else
+        {
+            file.write(reinterpret_cast<const char*>(compressed[c].data()), compressed[c].size());
+        }
+    }
+    const char padding[8] = {};
+    file.write(padding, static_cast<std::streamsize>(tablePadding));
+    file.write(reinterpret_cast<const char*>(toc.data()), toc.size() * sizeof(AssetEntry));
+    file.write(reinterpret_cast<const char*>(chunks.data()), chunks.size() * sizeof(ArchiveChunk));
+    file.write(names.data(), names.size());
+
+    if (!file.flush())
+    {
+        throw std::runtime_error("AssetPacker: failed writing " + path);
+    }
+}
+
+int RunAssetPackerTool(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        WriteToolMessage(std::string("usage: ") + argv[0] + " <output archive> <input files...>", true);
+        return 1;
+    }
+
+    try
+    {
+        ThreadPool pool;
+        AssetPacker packer(&pool);
+
+        for (int i = 2; i < argc; ++i)
+        {
+            const std::string path = argv[i];
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+            {
+                throw std::runtime_error("can't open " + path);
+            }
+            const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+            const std::string name = GetAssetNameFromPath(path);
+            if (HasExtension(path, ".dds"))
+            {
+                packer.AddDdsTexture(name, data.data(), data.size());
+            }
+            else
+            {
+                packer.AddBuffer(name, data.data(), data.size());
+            }
+        }
+
+        packer.Write(argv[1]);
+        WriteToolMessage("packed " + std::to_string(packer.GetAssetCount()) + " assets into " + argv[1], false);
+    }
+    catch (const std::exception& e)
+    {
+        WriteToolMessage(std::string("error: ") + e.what(), true);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "AssetArchive.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Write side of AssetArchive. Texture data is laid out with the footprints the loader will use, so
+// the packer does the row pitch and placement work once, offline, instead of at every load.
+class AssetPacker
+{
+public:
+    // Large enough for LZ4 to find its matches, small enough to give every worker several chunks
+    // of a single 2k texture.
+    static const uint32_t DefaultChunkSize = 256 * 1024;
+
+    explicit AssetPacker(ThreadPool* pool = nullptr, uint32_t chunkSize = DefaultChunkSize);
+
+    void AddBuffer(const std::string& name, const void* data, size_t size);
+
+    // data holds every subresource back to back in subresource order (mip fastest, then array
+    // slice) with tightly packed rows, which is also how DDS files store them.
+    void AddTexture2D(
+        const std::string& name,
+        uint32_t dxgiFormat,
+        uint32_t width,
+        uint32_t height,
+        uint16_t arraySize,
+        uint16_t mipLevels,
+        const void* data,
+        size_t dataSize);
+
+    // Parses a DDS file (legacy or DX10 header) and adds its 2D texture or cube map.
+    void AddDdsTexture(const std::string& name, const void* fileData, size_t fileSize);
+
+    size_t GetAssetCount() const { return m_assets.size(); }
+
+    // Compresses every chunk (in parallel on the pool) and writes the archive.
+    // Throws std::runtime_error on I/O failure.
+    void Write(const std::string& path) const;
+
+private:
+    struct PendingAsset
+    {
+        std::string Name;
+        AssetEntry Entry;
+        std::vector<uint8_t> Payload;
+    };
+
+    ThreadPool* m_pool;
+    uint32_t m_chunkSize;
+    std::vector<PendingAsset> m_assets;
+};
+
+// Command line front end: packer <output archive> <input files...>
+// .dds inputs become textures, anything else a buffer. Assets are named after the file name
+// without directory and extension. Returns the process exit code.
+int RunAssetPackerTool(int argc, char* argv[]);
@@ -0,0 +1,758 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    const uint32_t TexelCount = BlockDimension * BlockDimension;
+
+    // Interpolation weights of 4-bit and 2-bit BC7 indices, in 64ths of the second endpoint.
+    const uint32_t Bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+    const uint32_t Bc7Weights2[4] = { 0, 21, 43, 64 };
+
+    // Fills axis with the direction of greatest variance of the texels' first channels (power
+    // iteration on the covariance matrix), and mean with their mean. A block of a single color
+    // gets a zero axis.
+    void FindPrincipalAxis(const float texels[][4], uint32_t channels, float mean[4], float axis[4])
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            mean[c] = 0.0f;
+            axis[c] = 0.0f;
+        }
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                mean[c] += texels[i][c];
+            }
+        }
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            mean[c] /= TexelCount;
+        }
+
+        float covariance[4][4] = {};
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            float d[4];
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                d[c] = texels[i][c] - mean[c];
+            }
+            for (uint32_t a = 0; a < channels; ++a)
+            {
+                for (uint32_t b = a; b < channels; ++b)
+                {
+                    covariance[a][b] += d[a] * d[b];
+                }
+            }
+        }
+        for (uint32_t a = 0; a < channels; ++a)
+        {
+            for (uint32_t b = 0; b < a; ++b)
+            {
+                covariance[a][b] = covariance[b][a];
+            }
+        }
+
+        // Start from the covariance column of the channel that varies most: it leans towards the
+        // principal axis, where the diagonal (or any fixed vector) is orthogonal to it for a ramp
+        // with one channel rising as another falls, and the iteration would stop at zero.
+        uint32_t widest = 0;
+        for (uint32_t c = 1; c < channels; ++c)
+        {
+            if (covariance[c][c] > covariance[widest][widest])
+            {
+                widest = c;
+            }
+        }
+        float v[4] = { covariance[0][widest], covariance[1][widest], covariance[2][widest], covariance[3][widest] };
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            float next[4] = {};
+            float largest = 0.0f;
+            for (uint32_t a = 0; a < channels; ++a)
+            {
+                for (uint32_t b = 0; b < channels; ++b)
+                {
+                    next[a] += covariance[a][b] * v[b];
+                }
+                largest = std::max(largest, std::fabs(next[a]));
+            }
+            if (largest == 0.0f)
+            {
+                return;
+            }
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                v[c] = next[c] / largest;
+            }
+        }
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            axis[c] = v[c];
+        }
+    }
+
+    // The texels at both ends of the principal axis: the initial endpoints.
+    void FindEndpoints(const float texels[][4], uint32_t channels, float low[4], float high[4])
+    {
+        float mean[4];
+        float axis[4];
+        FindPrincipalAxis(texels, channels, mean, axis);
+
+        uint32_t lowest = 0;
+        uint32_t highest = 0;
+        float lowestDot = INFINITY;
+        float highestDot = -INFINITY;
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            float dot = 0.0f;
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                dot += (texels[i][c] - mean[c]) * axis[c];
+            }
+            if (dot < lowestDot)
+            {
+                lowestDot = dot;
+                lowest = i;
+            }
+            if (dot > highestDot)
+            {
+                highestDot = dot;
+                highest = i;
+            }
+        }
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            low[c] = texels[lowest][c];
+            high[c] = texels[highest][c];
+        }
+    }
+
+    // Least squares endpoints for the texels with the weights (of the second endpoint, 0 to 1)
+    // their indices select. Returns false when every weight is the same.
+    bool SolveEndpoints(const float texels[][4], uint32_t channels, const float* weights, float first[4], float second[4])
+    {
+        float aa = 0.0f;
+        float bb = 0.0f;
+        float ab = 0.0f;
+        float ax[4] = {};
+        float bx[4] = {};
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            const float b = weights[i];
+            const float a = 1.0f - b;
+            aa += a * a;
+            bb += b * b;
+            ab += a * b;
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                ax[c] += a * texels[i][c];
+                bx[c] += b * texels[i][c];
+            }
+        }
+        const float determinant = aa * bb - ab * ab;
+        if (std::fabs(determinant) < 1e-6f)
+        {
+            return false;
+        }
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            first[c] = std::min(255.0f, std::max(0.0f, (ax[c] * bb - bx[c] * ab) / determinant));
+            second[c] = std::min(255.0f, std::max(0.0f, (bx[c] * aa - ax[c] * ab) / determinant));
+        }
+        return true;
+    }
+
+    inline uint32_t Quantize(float value, uint32_t maximum)
+    {
+        return static_cast<uint32_t>(std::min(static_cast<float>(maximum), std::max(0.0f, value * maximum / 255.0f + 0.5f)));
+    }
+
+    inline uint16_t To565(const float color[4])
+    {
+        return static_cast<uint16_t>(Quantize(color[0], 31) << 11 | Quantize(color[1], 63) << 5 | Quantize(color[2], 31));
+    }
+
+    inline void From565(uint16_t color, int rgb[3])
+    {
+        const int r = color >> 11;
+        const int g = (color >> 5) & 63;
+        const int b = color & 31;
+        rgb[0] = r << 3 | r >> 2;
+        rgb[1] = g << 2 | g >> 4;
+        rgb[2] = b << 3 | b >> 2;
+    }
+
+    // Chooses the nearest of the four colors of endpoints c0 and c1 (4-color mode, whatever their
+    // order) for each texel. Returns the squared error.
+    float IndexBc1(const float texels[][4], uint16_t c0, uint16_t c1, uint32_t indices[TexelCount])
+    {
+        int palette[4][3];
+        From565(c0, palette[0]);
+        From565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        float error = 0.0f;
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            float best = INFINITY;
+            for (uint32_t k = 0; k < 4; ++k)
+            {
+                float distance = 0.0f;
+                for (int c = 0; c < 3; ++c)
+                {
+                    const float d = texels[i][c] - palette[k][c];
+                    distance += d * d;
+                }
+                if (distance < best)
+                {
+                    best = distance;
+                    indices[i] = k;
+                }
+            }
+            error += best;
+        }
+        return error;
+    }
+
+    // Color block of BC1, and of BC3, which always decodes it with four colors.
+    void EncodeBc1(const float texels[][4], uint8_t* block)
+    {
+        float low[4];
+        float high[4];
+        FindEndpoints(texels, 3, low, high);
+
+        uint16_t c0 = To565(high);
+        uint16_t c1 = To565(low);
+        uint32_t indices[TexelCount];
+        float error = IndexBc1(texels, c0, c1, indices);
+
+        // Index 0 is c0, 1 is c1, 2 and 3 are 1/3 and 2/3 of the way to c1.
+        static const float Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        float weights[TexelCount];
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            weights[i] = Weights[indices[i]];
+        }
+        float first[4];
+        float second[4];
+        if (c0 != c1 && SolveEndpoints(texels, 3, weights, first, second))
+        {
+            const uint16_t r0 = To565(first);
+            const uint16_t r1 = To565(second);
+            uint32_t refined[TexelCount];
+            const float refinedError = IndexBc1(texels, r0, r1, refined);
+            if (refinedError < error)
+            {
+                c0 = r0;
+                c1 = r1;
+                memcpy(indices, refined, sizeof(indices));
+            }
+        }
+
+        // c0 > c1 selects the 4-color mode: swapping the endpoints swaps indices 0 and 1, and 2 and 3.
+        uint32_t flip = 0;
+        if (c0 < c1)
+        {
+            std::swap(c0, c1);
+            flip = 1;
+        }
+        uint32_t bits = 0;
+        if (c0 != c1)
+        {
+            for (uint32_t i = 0; i < TexelCount; ++i)
+            {
+                bits |= (indices[i] ^ flip) << (2 * i);
+            }
+        }
+        block[0] = static_cast<uint8_t>(c0);
+        block[1] = static_cast<uint8_t>(c0 >> 8);
+        block[2] = static_cast<uint8_t>(c1);
+        block[3] = static_cast<uint8_t>(c1 >> 8);
+        memcpy(block + 4, &bits, 4);
+    }
+
+    // Alpha block of BC3 (the BC4 format): 8 levels between the highest and the lowest alpha.
+    void EncodeBc3Alpha(const float texels[][4], uint8_t* block)
+    {
+        uint32_t alphas[TexelCount];
+        uint32_t lowest = 255;
+        uint32_t highest = 0;
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            alphas[i] = static_cast<uint32_t>(texels[i][3]);
+            lowest = std::min(lowest, alphas[i]);
+            highest = std::max(highest, alphas[i]);
+        }
+
+        uint64_t bits = 0;
+        if (highest > lowest)
+        {
+            // a0 > a1: index 0 is a0, 1 is a1, 2 to 7 step from a0 to a1 in sevenths.
+            uint32_t palette[8] = { highest, lowest };
+            for (uint32_t k = 2; k < 8; ++k)
+            {
+                palette[k] = ((8 - k) * highest + (k - 1) * lowest) / 7;
+            }
+            for (uint32_t i = 0; i < TexelCount; ++i)
+            {
+                uint32_t best = 0;
+                uint32_t bestDistance = 256;
+                for (uint32_t k = 0; k < 8; ++k)
+                {
+                    const uint32_t distance = alphas[i] > palette[k] ? alphas[i] - palette[k] : palette[k] - alphas[i];
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        best = k;
+                    }
+                }
+                bits |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+        block[0] = static_cast<uint8_t>(highest);
+        block[1] = static_cast<uint8_t>(lowest);
+        for (int i = 0; i < 6; ++i)
+        {
+            block[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+        }
+    }
+
+    // A BC7 mode 6 endpoint: 7 bits per channel and a p-bit shared by its channels, as the 8-bit
+    // values they decode to.
+    struct Bc7Endpoint
+    {
+        uint32_t Values[4];
+        uint32_t PBit;
+    };
+
+    Bc7Endpoint QuantizeBc7Endpoint(const float color[4])
+    {
+        Bc7Endpoint best = {};
+        float bestError = INFINITY;
+        for (uint32_t p = 0; p < 2; ++p)
+        {
+            Bc7Endpoint endpoint;
+            endpoint.PBit = p;
+            float error = 0.0f;
+            for (int c = 0; c < 4; ++c)
+            {
+                const float q = std::min(127.0f, std::max(0.0f, std::floor((color[c] - p) * 0.5f + 0.5f)));
+                endpoint.Values[c] = static_cast<uint32_t>(q) << 1 | p;
+                const float d = color[c] - endpoint.Values[c];
+                error += d * d;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                best = endpoint;
+            }
+        }
+        return best;
+    }
+
+    float IndexBc7(const float texels[][4], const Bc7Endpoint& e0, const Bc7Endpoint& e1, uint32_t indices[TexelCount])
+    {
+        float palette[16][4];
+        for (uint32_t k = 0; k < 16; ++k)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                palette[k][c] = static_cast<float>(((64 - Bc7Weights[k]) * e0.Values[c] + Bc7Weights[k] * e1.Values[c] + 32) >> 6);
+            }
+        }
+
+        float error = 0.0f;
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            float best = INFINITY;
+            for (uint32_t k = 0; k < 16; ++k)
+            {
+                float distance = 0.0f;
+                for (int c = 0; c < 4; ++c)
+                {
+                    const float d = texels[i][c] - palette[k][c];
+                    distance += d * d;
+                }
+                if (distance < best)
+                {
+                    best = distance;
+                    indices[i] = k;
+                }
+            }
+            error += best;
+        }
+        return error;
+    }
+
+    // Writes values LSB first into a 128-bit block.
+    class BlockBitWriter
+    {
+    public:
+        explicit BlockBitWriter(uint8_t* block) : m_block(block), m_position(0)
+        {
+            memset(block, 0, 16);
+        }
+
+        void Write(uint32_t value, uint32_t bits)
+        {
+            for (uint32_t i = 0; i < bits; ++i, ++m_position)
+            {
+                m_block[m_position / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (m_position % 8));
+            }
+        }
+
+    private:
+        uint8_t* m_block;
+        uint32_t m_position;
+    };
+
+    // Mode 6: one RGBA line, 7-bit endpoints plus p-bits, 4-bit indices. Returns the squared error.
+    float EncodeBc7Mode6(const float texels[][4], uint8_t* block)
+    {
+        float low[4];
+        float high[4];
+        FindEndpoints(texels, 4, low, high);
+
+        Bc7Endpoint e0 = QuantizeBc7Endpoint(low);
+        Bc7Endpoint e1 = QuantizeBc7Endpoint(high);
+        uint32_t indices[TexelCount];
+        float error = IndexBc7(texels, e0, e1, indices);
+
+        float weights[TexelCount];
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            weights[i] = Bc7Weights[indices[i]] / 64.0f;
+        }
+        float first[4];
+        float second[4];
+        if (SolveEndpoints(texels, 4, weights, first, second))
+        {
+            const Bc7Endpoint r0 = QuantizeBc7Endpoint(first);
+            const Bc7Endpoint r1 = QuantizeBc7Endpoint(second);
+            uint32_t refined[TexelCount];
+            const float refinedError = IndexBc7(texels, r0, r1, refined);
+            if (refinedError < error)
+            {
+                e0 = r0;
+                e1 = r1;
+                error = refinedError;
+                memcpy(indices, refined, sizeof(indices));
+            }
+        }
+
+        // The first texel's index is stored without its top bit, which must be 0.
+        if (indices[0] >= 8)
+        {
+            std::swap(e0, e1);
+            for (uint32_t i = 0; i < TexelCount; ++i)
+            {
+                indices[i] = 15 - indices[i];
+            }
+        }
+
+        BlockBitWriter writer(block);
+        writer.Write(1 << 6, 7);
+        for (int c = 0; c < 4; ++c)
+        {
+            writer.Write(e0.Values[c] >> 1, 7);
+            writer.Write(e1.Values[c] >> 1, 7);
+        }
+        writer.Write(e0.PBit, 1);
+        writer.Write(e1.PBit, 1);
+        writer.Write(indices[0], 3);
+        for (uint32_t i = 1; i < TexelCount; ++i)
+        {
+            writer.Write(indices[i], 4);
+        }
+        return error;
+    }
+
+    // A 7-bit endpoint channel of mode 5, which has no p-bit: the top bit is repeated below.
+    uint32_t QuantizeBc7Channel7(float value)
+    {
+        const int rounded = static_cast<int>(value * 127.0f / 255.0f + 0.5f);
+        uint32_t best = 0;
+        float bestError = INFINITY;
+        for (int q = std::max(0, rounded - 1); q <= std::min(127, rounded + 1); ++q)
+        {
+            const float error = std::fabs(static_cast<float>(q << 1 | q >> 6) - value);
+            if (error < bestError)
+            {
+                bestError = error;
+                best = static_cast<uint32_t>(q);
+            }
+        }
+        return best;
+    }
+
+    // Nearest of the four colors between the 8-bit endpoints, per texel. Returns the squared error.
+    float IndexBc7Color2(const float texels[][4], const uint32_t e0[3], const uint32_t e1[3], uint32_t indices[TexelCount])
+    {
+        float palette[4][3];
+        for (uint32_t k = 0; k < 4; ++k)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[k][c] = static_cast<float>(((64 - Bc7Weights2[k]) * e0[c] + Bc7Weights2[k] * e1[c] + 32) >> 6);
+            }
+        }
+        float error = 0.0f;
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            float best = INFINITY;
+            for (uint32_t k = 0; k < 4; ++k)
+            {
+                float distance = 0.0f;
+                for (int c = 0; c < 3; ++c)
+                {
+                    const float d = texels[i][c] - palette[k][c];
+                    distance += d * d;
+                }
+                if (distance < best)
+                {
+                    best = distance;
+                    indices[i] = k;
+                }
+            }
+            error += best;
+        }
+        return error;
+    }
+
+    // Mode 5: the color on one line and the alpha on its own, 2-bit indices each, for blocks whose
+    // alpha does not follow their color (cutouts). Returns the squared error.
+    float EncodeBc7Mode5(const float texels[][4], uint8_t* block)
+    {
+        float low[4];
+        float high[4];
+        FindEndpoints(texels, 3, low, high);
+
+        uint32_t q0[3];
+        uint32_t q1[3];
+        uint32_t e0[3];
+        uint32_t e1[3];
+        const auto quantize = [&](const float first[4], const float second[4])
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                q0[c] = QuantizeBc7Channel7(first[c]);
+                q1[c] = QuantizeBc7Channel7(second[c]);
+                e0[c] = q0[c] << 1 | q0[c] >> 6;
+                e1[c] = q1[c] << 1 | q1[c] >> 6;
+            }
+        };
+        quantize(low, high);
+        uint32_t colorIndices[TexelCount];
+        float error = IndexBc7Color2(texels, e0, e1, colorIndices);
+
+        float weights[TexelCount];
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            weights[i] = Bc7Weights2[colorIndices[i]] / 64.0f;
+        }
+        float first[4];
+        float second[4];
+        if (SolveEndpoints(texels, 3, weights, first, second))
+        {
+            uint32_t saved[4][3];
+            memcpy(saved, q0, sizeof(q0));
+            memcpy(saved[1], q1, sizeof(q1));
+            memcpy(saved[2], e0, sizeof(e0));
+            memcpy(saved[3], e1, sizeof(e1));
+            quantize(first, second);
+            uint32_t refined[TexelCount];
+            const float refinedError = IndexBc7Color2(texels, e0, e1, refined);
+            if (refinedError < error)
+            {
+                error = refinedError;
+                memcpy(colorIndices, refined, sizeof(colorIndices));
+            }
+            else
+            {
+                memcpy(q0, saved[0], sizeof(q0));
+                memcpy(q1, saved[1], sizeof(q1));
+                memcpy(e0, saved[2], sizeof(e0));
+                memcpy(e1, saved[3], sizeof(e1));
+            }
+        }
+
+        // Alpha: 8-bit endpoints at the lowest and highest alpha.
+        uint32_t a0 = 255;
+        uint32_t a1 = 0;
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            a0 = std::min(a0, static_cast<uint32_t>(texels[i][3]));
+            a1 = std::max(a1, static_cast<uint32_t>(texels[i][3]));
+        }
+        uint32_t alphaIndices[TexelCount];
+        for (uint32_t i = 0; i < TexelCount; ++i)
+        {
+            float best = INFINITY;
+            for (uint32_t k = 0; k < 4; ++k)
+            {
+                const float d = texels[i][3] - static_cast<float>(((64 - Bc7Weights2[k]) * a0 + Bc7Weights2[k] * a1 + 32) >> 6);
+                if (d * d < best)
+                {
+                    best = d * d;
+                    alphaIndices[i] = k;
+                }
+            }
+            error += best;
+        }
+
+        // Each index set stores its first index without the top bit.
+        if (colorIndices[0] >= 2)
+        {
+            std::swap(q0, q1);
+            for (uint32_t& index : colorIndices)
+            {
+                index = 3 - index;
+            }
+        }
+        if (alphaIndices[0] >= 2)
+        {
+            std::swap(a0, a1);
+            for (uint32_t& index : alphaIndices)
+            {
+                index = 3 - index;
+            }
+        }
+
+        BlockBitWriter writer(block);
+        writer.Write(1 << 5, 6);
+        writer.Write(0, 2);         // No channel rotation.
+        for (int c = 0; c < 3; ++c)
+        {
+            writer.Write(q0[c], 7);
+            writer.Write(q1[c], 7);
+        }
+        writer.Write(a0, 8);
+        writer.Write(a1, 8);
+        writer.Write(colorIndices[0], 1);
+        for (uint32_t i = 1; i < TexelCount; ++i)
+        {
+            writer.Write(colorIndices[i], 2);
+        }
+        writer.Write(alphaIndices[0], 1);
+        for (uint32_t i = 1; i < TexelCount; ++i)
+        {
+            writer.Write(alphaIndices[i], 2);
+        }
+        return error;
+    }
+
+    // Mode 6, or mode 5 when the alpha varies and that is closer.
+    void EncodeBc7(const float texels[][4], uint8_t* block)
+    {
+        const float error = EncodeBc7Mode6(texels, block);
+        bool varyingAlpha = false;
+        for (uint32_t i = 1; i < TexelCount; ++i)
+        {
+            varyingAlpha |= texels[i][3] != texels[0][3];
+        }
+        if (varyingAlpha && error > 0.0f)
+        {
+            uint8_t mode5[16];
+            if (EncodeBc7Mode5(texels, mode5) < error)
+            {
+                memcpy(block, mode5, sizeof(mode5));
+            }
+        }
+    }
+}
+
+uint32_t GetBlockSize(BlockFormat format)
+{
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+const char* GetBlockFormatName(BlockFormat format)
+{
+    static const char* const Names[] = { "BC1", "BC3", "BC7" };
+    static_assert(sizeof(Names) / sizeof(Names[0]) == static_cast<size_t>(BlockFormat::Count), "Every block format has a name.");
+    return format < BlockFormat::Count ? Names[static_cast<size_t>(format)] : "unknown";
+}
+
+uint32_t GetBlockFormatDxgi(BlockFormat format, bool srgb)
+{
+    // Values are DXGI_FORMAT; this file has no dependency on the Windows headers.
+    switch (format)
+    {
+    case BlockFormat::BC1: return srgb ? 72 : 71;
+    case BlockFormat::BC3: return srgb ? 78 : 77;
+    default: return srgb ? 99 : 98;
+    }
+}
+
+void EncodeBlock(BlockFormat format, const uint8_t texels[BlockDimension * BlockDimension * 4], void* block)
+{
+    float values[TexelCount][4];
+    for (uint32_t i = 0; i < TexelCount; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            values[i][c] = texels[i * 4 + c];
+        }
+    }
+
+    uint8_t* out = static_cast<uint8_t*>(block);
+    switch (format)
+    {
+    case BlockFormat::BC1:
+        EncodeBc1(values, out);
+        break;
+    case BlockFormat::BC3:
+        EncodeBc3Alpha(values, out);
+        EncodeBc1(values, out + 8);
+        break;
+    default:
+        EncodeBc7(values, out);
+        break;
+    }
+}
+
+void EncodeBlockRows(
+    BlockFormat format,
+    const uint8_t* source,
+    size_t sourceRowPitch,
+    uint32_t width,
+    uint32_t height,
+    uint32_t firstBlockRow,
+    uint32_t blockRowCount,
+    void* dest,
+    size_t destRowPitch)
+{
+    const uint32_t blockSize = GetBlockSize(format);
+    const uint32_t blocksWide = (width + BlockDimension - 1) / BlockDimension;
+    uint8_t texels[TexelCount * 4];
+    uint8_t block[16];
+    for (uint32_t row = firstBlockRow; row < firstBlockRow + blockRowCount; ++row)
+    {
+        uint8_t* out = static_cast<uint8_t*>(dest) + row * destRowPitch;
+        for (uint32_t column = 0; column < blocksWide; ++column)
+        {
+            for (uint32_t y = 0; y < BlockDimension; ++y)
+            {
+                const uint32_t sourceY = std::min(row * BlockDimension + y, height - 1);
+                const uint8_t* sourceRow = source + sourceY * sourceRowPitch;
+                for (uint32_t x = 0; x < BlockDimension; ++x)
+                {
+                    const uint32_t sourceX = std::min(column * BlockDimension + x, width - 1);
+                    memcpy(texels + (y * BlockDimension + x) * 4, sourceRow + sourceX * 4, 4);
+                }
+            }
+            EncodeBlock(format, texels, block);
+            memcpy(out + column * blockSize, block, blockSize);
+        }
+    }
+}
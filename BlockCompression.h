@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Block compressed formats the texture loaders encode into, from RGBA8 texels.
+enum class BlockFormat : uint8_t
+{
+    BC1,            // RGB, 8 bytes per 4x4 block. Alpha is dropped.
+    BC3,            // BC1 color plus interpolated alpha, 16 bytes.
+    BC7,            // RGBA, 16 bytes. Modes 6 and 5 only: one subset, no partitions.
+    Count
+};
+
+const uint32_t BlockDimension = 4;
+
+uint32_t GetBlockSize(BlockFormat format);
+const char* GetBlockFormatName(BlockFormat format);
+// The DXGI_FORMAT value, _SRGB or not.
+uint32_t GetBlockFormatDxgi(BlockFormat format, bool srgb);
+
+// Encodes one block of 4x4 RGBA8 texels, rows top to bottom, into block. The encoders fit the
+// endpoints along the principal axis of the texels then refine them once by least squares: made
+// for encoding at load time, not for the quality of offline compressors.
+void EncodeBlock(BlockFormat format, const uint8_t texels[BlockDimension * BlockDimension * 4], void* block);
+
+// Encodes block rows [firstBlockRow, firstBlockRow + blockRowCount) of an RGBA8 image into rows of
+// blocks at destRowPitch; dest points at the image's first block row. Blocks past the right or
+// bottom edge repeat the edge texels. The destination is written front to back and never read,
+// so it can be write-combined memory such as a mapped upload heap. Rows of blocks are
+// independent: split the rows of an image between threads.
+void EncodeBlockRows(
+    BlockFormat format,
+    const uint8_t* source,
+    size_t sourceRowPitch,
+    uint32_t width,
+    uint32_t height,
+    uint32_t firstBlockRow,
+    uint32_t blockRowCount,
+    void* dest,
+    size_t destRowPitch);
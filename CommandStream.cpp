@@ -0,0 +1,399 @@
+#include "CommandStream.h"
+#include "FrameAllocators.h"
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+    struct CommandInfo
+    {
+        const char* Name;
+        uint32_t FieldCount;
+        bool HasData;
+    };
+
+    const CommandInfo Commands[] =
+    {
+        { "DefineObject", 8, true },
+        { "FrameBegin", 2, false },
+        { "Present", 1, false },
+        { "ResetCommandList", 3, false },
+        { "CloseCommandList", 1, false },
+        { "ExecuteCommandList", 1, false },
+        { "SetPipelineState", 1, false },
+        { "SetGraphicsRootSignature", 1, false },
+        { "SetDescriptorHeaps", 2, false },
+        { "SetGraphicsRootDescriptorTable", 3, false },
+        { "SetGraphicsRootConstantBufferView", 3, false },
+        { "SetGraphicsRoot32BitConstants", 2, true },
+        { "SetViewport", 6, false },
+        { "SetScissorRect", 4, false },
+        { "SetRenderTarget", 2, false },
+        { "ClearRenderTarget", 10, false },
+        { "SetPrimitiveTopology", 1, false },
+        { "SetVertexBuffer", 5, false },
+        { "Draw", 4, false },
+        { "Transition", 4, false },
+        { "EndQuery", 3, false },
+        { "ResolveQueryData", 6, false },
+        { "WriteBuffer", 2, true },
+        { "CopyBufferToTexture", 9, false },
+        { "CopyBufferToTextureRegion", 10, false },
+        { "SetIndexBuffer", 4, false },
+        { "DrawIndexed", 5, false },
+        { "CopyBuffer", 5, false },
+    };
+    static_assert(sizeof(Commands) / sizeof(Commands[0]) == static_cast<size_t>(CommandOp::Count), "Every operation needs its description.");
+
+    // Chunks of a frame's packets; data larger than this gets a chunk of its own.
+    const size_t ChunkSize = 16 * 1024;
+    // Data smaller than this is stored raw: LZ4 can't gain enough to pay for its header.
+    const size_t MinCompressedSize = 64;
+    // Largest encoding of a 32-bit varint.
+    const size_t MaxVarintSize = 5;
+    // An LZ4 block can't expand more than this: a length byte of 255 is the most one input byte
+    // adds to the output.
+    const uint64_t MaxLz4Expansion = 255;
+
+    inline uint32_t ZigZag(uint32_t delta)
+    {
+        return (delta << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+    }
+
+    inline uint32_t UnZigZag(uint32_t value)
+    {
+        return (value >> 1) ^ (0u - (value & 1));
+    }
+
+    inline uint8_t* WriteVarint(uint8_t* out, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            *out++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<uint8_t>(value);
+        return out;
+    }
+
+    inline void WriteUint32(uint8_t* out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    inline uint32_t ReadUint32(const uint8_t* in)
+    {
+        return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24);
+    }
+}
+
+uint32_t GetCommandFieldCount(CommandOp op)
+{
+    return Commands[static_cast<size_t>(op)].FieldCount;
+}
+
+bool CommandHasData(CommandOp op)
+{
+    return Commands[static_cast<size_t>(op)].HasData;
+}
+
+const char* GetCommandOpName(CommandOp op)
+{
+    return op < CommandOp::Count ? Commands[static_cast<size_t>(op)].Name : "Unknown";
+}
+
+CommandStreamWriter::CommandStreamWriter(std::ostream& out) :
+    m_out(out),
+    m_setupArena(new LinearArena(ChunkSize * 4, MemoryTag(MemoryCategory::CpuStaging, "command stream"))),
+    m_previous{},
+    m_previousDelta{},
+    m_packetCount(0),
+    m_bytesWritten(0)
+{
+    m_arena = m_setupArena.get();
+
+    uint8_t header[8];
+    WriteUint32(header, CommandStreamMagic);
+    WriteUint32(header + 4, CommandStreamVersion);
+    m_out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    m_bytesWritten = sizeof(header);
+}
+
+CommandStreamWriter::~CommandStreamWriter()
+{
+}
+
+uint8_t* CommandStreamWriter::Reserve(size_t size)
+{
+    if (m_chunks.empty() || m_chunks.back().Capacity - m_chunks.back().Size < size)
+    {
+        const size_t capacity = std::max(ChunkSize, size);
+        m_chunks.push_back(Chunk{ m_arena->Allocate<uint8_t>(capacity), 0, capacity });
+    }
+    return m_chunks.back().Data + m_chunks.back().Size;
+}
+
+void CommandStreamWriter::Write(CommandOp op, std::initializer_list<uint32_t> fields, const void* data, size_t dataSize)
+{
+    uint32_t values[MaxCommandFields] = {};
+    std::copy(fields.begin(), fields.begin() + std::min<size_t>(fields.size(), MaxCommandFields), values);
+    Write(op, values, data, dataSize);
+}
+
+void CommandStreamWriter::Write(CommandOp op, const uint32_t* fields, const void* data, size_t dataSize)
+{
+    const size_t index = static_cast<size_t>(op);
+    const uint32_t fieldCount = Commands[index].FieldCount;
+    const bool hasData = Commands[index].HasData;
+    if (dataSize > UINT32_MAX)
+    {
+        throw std::runtime_error("Command data is too large.");
+    }
+
+    // Only the header and fields are reserved first: large data gets its own chunk below.
+    uint8_t* const start = Reserve(1 + fieldCount * MaxVarintSize);
+    uint8_t* out = start + 1;
+
+    bool repeat = fieldCount > 0 && !hasData;
+    for (uint32_t i = 0; i < fieldCount; ++i)
+    {
+        const uint32_t delta = fields[i] - m_previous[index][i];
+        repeat = repeat && delta == m_previousDelta[index][i];
+        m_previous[index][i] = fields[i];
+        m_previousDelta[index][i] = delta;
+    }
+
+    *start = static_cast<uint8_t>(index | (repeat ? CommandRepeatFlag : 0));
+    if (!repeat)
+    {
+        for (uint32_t i = 0; i < fieldCount; ++i)
+        {
+            out = WriteVarint(out, ZigZag(m_previousDelta[index][i]));
+        }
+    }
+    m_chunks.back().Size += out - start;
+    ++m_packetCount;
+
+    if (!hasData)
+    {
+        return;
+    }
+
+    const uint32_t size = static_cast<uint32_t>(dataSize);
+    const bool compress = size >= MinCompressedSize;
+    const size_t bound = compress ? Lz4CompressBound(size) : size;
+    uint8_t* const dataStart = Reserve(2 * MaxVarintSize + std::max<size_t>(bound, size));
+    out = WriteVarint(dataStart, size);
+
+    // Compress behind the largest stored size field, then close the gap if it is shorter.
+    size_t stored = 0;
+    if (compress)
+    {
+        stored = Lz4Compress(data, size, out + MaxVarintSize, bound);
+        if (stored >= size)
+        {
+            stored = 0;
+        }
+    }
+
+    if (stored != 0)
+    {
+        uint8_t* const compressed = out + MaxVarintSize;
+        out = WriteVarint(out, static_cast<uint32_t>(stored));
+        memmove(out, compressed, stored);
+        out += stored;
+    }
+    else
+    {
+        out = WriteVarint(out, 0);
+        if (size != 0)
+        {
+            memcpy(out, data, size);
+        }
+        out += size;
+    }
+    m_chunks.back().Size += out - dataStart;
+}
+
+void CommandStreamWriter::BeginFrame(LinearArena& arena, uint32_t frameNumber, uint32_t backBufferIndex)
+{
+    // Setup packets come first in the stream.
+    Flush();
+    m_arena = &arena;
+    Write(CommandOp::FrameBegin, { frameNumber, backBufferIndex });
+}
+
+void CommandStreamWriter::EndFrame()
+{
+    WriteChunks();
+    m_arena = m_setupArena.get();
+}
+
+void CommandStreamWriter::Flush()
+{
+    WriteChunks();
+    if (m_arena == m_setupArena.get())
+    {
+        m_setupArena->Reset();
+    }
+}
+
+void CommandStreamWriter::WriteChunks()
+{
+    for (const Chunk& chunk : m_chunks)
+    {
+        m_out.write(reinterpret_cast<const char*>(chunk.Data), chunk.Size);
+        m_bytesWritten += chunk.Size;
+    }
+    m_chunks.clear();
+
+    if (!m_out)
+    {
+        throw std::runtime_error("Can't write the command stream.");
+    }
+}
+
+CommandStreamReader::CommandStreamReader(const uint8_t* data, size_t size) :
+    m_data(data),
+    m_size(size),
+    m_offset(0)
+{
+    if (size < 8 || ReadUint32(data) != CommandStreamMagic)
+    {
+        throw std::runtime_error("Not a command stream.");
+    }
+    if (ReadUint32(data + 4) != CommandStreamVersion)
+    {
+        throw std::runtime_error("Unsupported command stream version.");
+    }
+    Rewind();
+}
+
+void CommandStreamReader::Rewind()
+{
+    m_offset = 8;
+    memset(m_previous, 0, sizeof(m_previous));
+    memset(m_previousDelta, 0, sizeof(m_previousDelta));
+}
+
+uint32_t CommandStreamReader::ReadVarint()
+{
+    uint32_t value = 0;
+    for (uint32_t shift = 0; shift < 35; shift += 7)
+    {
+        if (m_offset == m_size)
+        {
+            throw std::runtime_error("Truncated command stream.");
+        }
+        const uint8_t byte = m_data[m_offset++];
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (byte < 0x80)
+        {
+            return value;
+        }
+    }
+    throw std::runtime_error("Malformed command stream.");
+}
+
+bool CommandStreamReader::Next(CommandPacket& packet)
+{
+    if (m_offset == m_size)
+    {
+        return false;
+    }
+
+    const uint8_t header = m_data[m_offset++];
+    const size_t index = header & ~CommandRepeatFlag;
+    if (index >= static_cast<size_t>(CommandOp::Count))
+    {
+        throw std::runtime_error("Malformed command stream.");
+    }
+
+    packet.Op = static_cast<CommandOp>(index);
+    const uint32_t fieldCount = Commands[index].FieldCount;
+    const bool repeat = (header & CommandRepeatFlag) != 0;
+    for (uint32_t i = 0; i < fieldCount; ++i)
+    {
+        if (!repeat)
+        {
+            m_previousDelta[index][i] = UnZigZag(ReadVarint());
+        }
+        m_previous[index][i] += m_previousDelta[index][i];
+        packet.Fields[i] = m_previous[index][i];
+    }
+    for (uint32_t i = fieldCount; i < MaxCommandFields; ++i)
+    {
+        packet.Fields[i] = 0;
+    }
+
+    packet.Data = nullptr;
+    packet.DataSize = 0;
+    if (Commands[index].HasData)
+    {
+        const uint32_t size = ReadVarint();
+        const uint32_t stored = ReadVarint();
+        const size_t length = stored != 0 ? stored : size;
+        if (length > m_size - m_offset)
+        {
+            throw std::runtime_error("Truncated command stream.");
+        }
+
+        if (stored != 0)
+        {
+            // Checked before the buffer grows, so a damaged size can't ask for gigabytes.
+            if (size > stored * MaxLz4Expansion)
+            {
+                throw std::runtime_error("Malformed command stream data size.");
+            }
+            m_decompressed.resize(size);
+            if (!Lz4Decompress(m_data + m_offset, stored, m_decompressed.data(), size))
+            {
+                throw std::runtime_error("Malformed command stream data.");
+            }
+            packet.Data = m_decompressed.data();
+        }
+        else
+        {
+            packet.Data = m_data + m_offset;
+        }
+        packet.DataSize = size;
+        m_offset += length;
+    }
+    return true;
+}
+
+NullCommandBackend::NullCommandBackend() :
+    m_counts{},
+    m_dataBytes(0),
+    m_checksum(0)
+{
+}
+
+void NullCommandBackend::Execute(const CommandPacket& packet)
+{
+    ++m_counts[static_cast<size_t>(packet.Op)];
+    m_dataBytes += packet.DataSize;
+    for (size_t i = 0; i < packet.DataSize; i += 64)
+    {
+        m_checksum += packet.Data[i];
+    }
+}
+
+uint64_t ReplayCommandStream(CommandStreamReader& reader, CommandBackend& backend)
+{
+    uint64_t count = 0;
+    CommandPacket packet;
+    while (reader.Next(packet))
+    {
+        backend.Execute(packet);
+        ++count;
+    }
+    return count;
+}
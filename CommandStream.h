@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+class LinearArena;
+
+// Captured graphics API calls, for replaying frames offline. Calls are recorded with the ids of
+// the objects they use (assigned by DefineObject, in creation order) and plain 32-bit fields, so
+// the stream has no pointers or handles and the replay maps the ids to its own objects.
+enum class CommandOp : uint8_t
+{
+    DefineObject,                       // id, CommandObjectType, then description fields; data: name.
+    FrameBegin,                         // frame number, back buffer index.
+    Present,                            // sync interval.
+    ResetCommandList,                   // list, allocator, pipeline state (0: none).
+    CloseCommandList,                   // list.
+    ExecuteCommandList,                 // list.
+    SetPipelineState,                   // pipeline state.
+    SetGraphicsRootSignature,           // root signature.
+    SetDescriptorHeaps,                 // CBV/SRV/UAV heap, sampler heap (0: none).
+    SetGraphicsRootDescriptorTable,     // parameter, heap, descriptor index.
+    SetGraphicsRootConstantBufferView,  // parameter, resource, offset.
+    SetGraphicsRoot32BitConstants,      // parameter, first constant; data: the constants.
+    SetViewport,                        // x, y, width, height, min depth, max depth (float bits).
+    SetScissorRect,                     // left, top, right, bottom.
+    SetRenderTarget,                    // heap, descriptor index.
+    ClearRenderTarget,                  // heap, descriptor index, color (4 float bits), rect (4, empty: all).
+    SetPrimitiveTopology,               // topology.
+    SetVertexBuffer,                    // slot, resource, offset, size, stride.
+    Draw,                               // vertex count, instance count, first vertex, first instance.
+    Transition,                         // resource, subresource, state before, state after.
+    EndQuery,                           // query heap, query type, index.
+    ResolveQueryData,                   // query heap, query type, first, count, buffer, offset.
+    WriteBuffer,                        // resource, offset; data: the bytes written by the CPU.
+    CopyBufferToTexture,                // texture, subresource, buffer, offset, format, width, height, depth, row pitch.
+    CopyBufferToTextureRegion,          // texture, subresource, buffer, offset, format, width, height, row pitch, dest x, dest y (depth 1).
+    SetIndexBuffer,                     // resource, offset, size, format.
+    DrawIndexed,                        // index count, instance count, first index, base vertex (int bits), first instance.
+    CopyBuffer,                         // dest, dest offset, source, source offset, size.
+    Count
+};
+
+enum class CommandObjectType : uint32_t
+{
+    Resource,                           // Fields: dimension, width (low 32 bits), height, depth, format, heap type.
+    PipelineState,
+    RootSignature,
+    DescriptorHeap,                     // Fields: descriptor type, count.
+    QueryHeap,
+    CommandList,
+    CommandAllocator,
+};
+
+static const uint32_t MaxCommandFields = 10;
+
+// Number of fields of an operation and whether it carries data.
+uint32_t GetCommandFieldCount(CommandOp op);
+bool CommandHasData(CommandOp op);
+const char* GetCommandOpName(CommandOp op);
+
+inline uint32_t CommandFloatBits(float value)
+{
+    union { float f; uint32_t u; } bits;
+    bits.f = value;
+    return bits.u;
+}
+
+inline float CommandBitsFloat(uint32_t value)
+{
+    union { float f; uint32_t u; } bits;
+    bits.u = value;
+    return bits.f;
+}
+
+struct CommandPacket
+{
+    CommandOp Op;
+    uint32_t Fields[MaxCommandFields];
+    // Valid until the next packet is read.
+    const uint8_t* Data;
+    size_t DataSize;
+};
+
+// Stream format: the header ("DXCS", version), then packets. A packet is one byte, the operation,
+// followed by its fields, each the zigzag varint of its difference to the same field of the
+// previous packet of that operation. Consecutive draws, constant buffer views walking a buffer
+// and unchanged state then take a byte or two per field. When every field moved by the same
+// amount as last time (a draw loop) the operation byte has CommandRepeatFlag set and the fields
+// are left out. Data follows the fields: its size, its stored size (0 when stored raw) and the
+// bytes, compressed with LZ4 when that saves space.
+static const uint32_t CommandStreamMagic = 0x53435844;     // "DXCS"
+static const uint32_t CommandStreamVersion = 1;
+static const uint8_t CommandRepeatFlag = 0x80;
+
+// Encodes packets. The packets of a frame go into chunks taken from that frame's arena and are
+// written out at EndFrame, so recording costs no heap allocation and no I/O on the hot path.
+// Packets outside a frame (setup) use an arena of the writer and are written by Flush.
+// Not thread-safe: record from one thread.
+class CommandStreamWriter
+{
+public:
+    explicit CommandStreamWriter(std::ostream& out);
+    ~CommandStreamWriter();
+
+    CommandStreamWriter(const CommandStreamWriter&) = delete;
+    CommandStreamWriter& operator=(const CommandStreamWriter&) = delete;
+
+    // Missing fields are 0.
+    void Write(CommandOp op, std::initializer_list<uint32_t> fields, const void* data = nullptr, size_t dataSize = 0);
+    void Write(CommandOp op, const uint32_t* fields, const void* data = nullptr, size_t dataSize = 0);
+
+    // Writes FrameBegin; the arena must stay valid until EndFrame.
+    void BeginFrame(LinearArena& arena, uint32_t frameNumber, uint32_t backBufferIndex);
+    void EndFrame();
+    // Writes out the packets recorded outside a frame.
+    void Flush();
+
+    uint64_t GetPacketCount() const { return m_packetCount; }
+    // Bytes written to the stream so far, header included.
+    uint64_t GetBytesWritten() const { return m_bytesWritten; }
+
+private:
+    struct Chunk
+    {
+        uint8_t* Data;
+        size_t Size;
+        size_t Capacity;
+    };
+
+    uint8_t* Reserve(size_t size);
+    void WriteChunks();
+
+    std::ostream& m_out;
+    LinearArena* m_arena;                   // Frame arena, or m_setupArena.
+    std::unique_ptr<LinearArena> m_setupArena;
+    std::vector<Chunk> m_chunks;
+    uint32_t m_previous[static_cast<size_t>(CommandOp::Count)][MaxCommandFields];
+    uint32_t m_previousDelta[static_cast<size_t>(CommandOp::Count)][MaxCommandFields];
+    uint64_t m_packetCount;
+    uint64_t m_bytesWritten;
+};
+
+// Decodes a stream held in memory (a loaded or mapped file). Throws std::runtime_error on a
+// malformed stream; never reads outside the buffer.
+class CommandStreamReader
+{
+public:
+    CommandStreamReader(const uint8_t* data, size_t size);
+
+    // Returns false at the end of the stream.
+    bool Next(CommandPacket& packet);
+    // Back to the first packet.
+    void Rewind();
+
+    size_t GetOffset() const { return m_offset; }
+
+private:
+    uint32_t ReadVarint();
+
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset;
+    uint32_t m_previous[static_cast<size_t>(CommandOp::Count)][MaxCommandFields];
+    uint32_t m_previousDelta[static_cast<size_t>(CommandOp::Count)][MaxCommandFields];
+    std::vector<uint8_t> m_decompressed;
+};
+
+// Executes replayed packets.
+class CommandBackend
+{
+public:
+    virtual ~CommandBackend() {}
+    virtual void Execute(const CommandPacket& packet) = 0;
+};
+
+// Backend that only decodes: replaying through it measures the CPU cost of the stream itself,
+// and its counts tell what a capture contains.
+class NullCommandBackend : public CommandBackend
+{
+public:
+    NullCommandBackend();
+
+    void Execute(const CommandPacket& packet) override;
+
+    uint64_t GetCount(CommandOp op) const { return m_counts[static_cast<size_t>(op)]; }
+    uint64_t GetDataBytes() const { return m_dataBytes; }
+
+private:
+    uint64_t m_counts[static_cast<size_t>(CommandOp::Count)];
+    uint64_t m_dataBytes;
+    uint32_t m_checksum;                    // Reads the data, as a real backend would.
+};
+
+// Runs every remaining packet through the backend. Returns the number of packets.
+uint64_t ReplayCommandStream(CommandStreamReader& reader, CommandBackend& backend);
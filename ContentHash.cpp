@@ -0,0 +1,417 @@
+#include "ContentHash.h"
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HASH_AVX2 1
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HASH_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define HASH_NEON 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    const uint64_t Prime32_1 = 0x9E3779B1U;
+    const uint64_t Prime32_2 = 0x85EBCA77U;
+    const uint64_t Prime32_3 = 0xC2B2AE3DU;
+    const uint64_t Prime64_1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t Prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t Prime64_3 = 0x165667B19E3779F9ULL;
+    const uint64_t Prime64_4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t Prime64_5 = 0x27D4EB2F165667C5ULL;
+    const uint64_t PrimeMx1 = 0x165667919E3779F9ULL;
+    const uint64_t PrimeMx2 = 0x9FB21C651E98DF25ULL;
+
+    // Long inputs are hashed in 64-byte stripes into 8 accumulators. Each stripe moves 8 bytes
+    // further into the secret, so a block is 16 stripes, after which the accumulators are
+    // scrambled.
+    const size_t StripeSize = 64;
+    const size_t SecretConsumeRate = 8;
+    const size_t SecretSize = 192;
+    const size_t StripesPerBlock = (SecretSize - StripeSize) / SecretConsumeRate;
+    const size_t BlockSize = StripeSize * StripesPerBlock;
+    const size_t MidSizeMax = 240;
+    const size_t MidSizeSecretMin = 136;
+
+    alignas(64) const uint8_t Secret[SecretSize] =
+    {
+        0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+        0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+        0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+        0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+        0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+        0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+        0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+        0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+        0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+        0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+        0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+        0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+    };
+
+    // Loads are little-endian, as on every target of the renderer.
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint64_t Read64(const uint8_t* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t Swap32(uint32_t x)
+    {
+        return (x << 24) | ((x << 8) & 0x00ff0000U) | ((x >> 8) & 0x0000ff00U) | (x >> 24);
+    }
+
+    uint64_t Swap64(uint64_t x)
+    {
+        return (static_cast<uint64_t>(Swap32(static_cast<uint32_t>(x))) << 32) | Swap32(static_cast<uint32_t>(x >> 32));
+    }
+
+    uint64_t Rotl64(uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    // Low and high halves of the 128-bit product, xored.
+    uint64_t MulFold64(uint64_t a, uint64_t b)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        uint64_t high;
+        const uint64_t low = _umul128(a, b, &high);
+        return low ^ high;
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+        return (a * b) ^ __umulh(a, b);
+#elif defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+        const uint64_t lolo = (a & 0xffffffff) * (b & 0xffffffff);
+        const uint64_t hilo = (a >> 32) * (b & 0xffffffff);
+        const uint64_t lohi = (a & 0xffffffff) * (b >> 32);
+        const uint64_t hihi = (a >> 32) * (b >> 32);
+        const uint64_t cross = (lolo >> 32) + (hilo & 0xffffffff) + lohi;
+        const uint64_t high = (hilo >> 32) + (cross >> 32) + hihi;
+        const uint64_t low = (cross << 32) | (lolo & 0xffffffff);
+        return low ^ high;
+#endif
+    }
+
+    uint64_t Avalanche64(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= Prime64_2;
+        h ^= h >> 29;
+        h *= Prime64_3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    uint64_t Avalanche(uint64_t h)
+    {
+        h ^= h >> 37;
+        h *= PrimeMx1;
+        h ^= h >> 32;
+        return h;
+    }
+
+    uint64_t Rrmxmx(uint64_t h, uint64_t size)
+    {
+        h ^= Rotl64(h, 49) ^ Rotl64(h, 24);
+        h *= PrimeMx2;
+        h ^= (h >> 35) + size;
+        h *= PrimeMx2;
+        return h ^ (h >> 28);
+    }
+
+    uint64_t Hash0To16(const uint8_t* input, size_t size)
+    {
+        if (size > 8)
+        {
+            const uint64_t low = Read64(input) ^ (Read64(Secret + 24) ^ Read64(Secret + 32));
+            const uint64_t high = Read64(input + size - 8) ^ (Read64(Secret + 40) ^ Read64(Secret + 48));
+            return Avalanche(size + Swap64(low) + high + MulFold64(low, high));
+        }
+        if (size >= 4)
+        {
+            const uint64_t combined = Read32(input + size - 4) + (static_cast<uint64_t>(Read32(input)) << 32);
+            return Rrmxmx(combined ^ (Read64(Secret + 8) ^ Read64(Secret + 16)), size);
+        }
+        if (size > 0)
+        {
+            const uint32_t combined = (static_cast<uint32_t>(input[0]) << 16) | (static_cast<uint32_t>(input[size >> 1]) << 24)
+                | input[size - 1] | (static_cast<uint32_t>(size) << 8);
+            return Avalanche64(combined ^ static_cast<uint64_t>(Read32(Secret) ^ Read32(Secret + 4)));
+        }
+        return Avalanche64(Read64(Secret + 56) ^ Read64(Secret + 64));
+    }
+
+    uint64_t Mix16(const uint8_t* input, const uint8_t* secret)
+    {
+        return MulFold64(Read64(input) ^ Read64(secret), Read64(input + 8) ^ Read64(secret + 8));
+    }
+
+    // Pairs of 16-byte pieces from both ends, meeting in the middle.
+    uint64_t Hash17To128(const uint8_t* input, size_t size)
+    {
+        uint64_t acc = size * Prime64_1;
+        if (size > 32)
+        {
+            if (size > 64)
+            {
+                if (size > 96)
+                {
+                    acc += Mix16(input + 48, Secret + 96);
+                    acc += Mix16(input + size - 64, Secret + 112);
+                }
+                acc += Mix16(input + 32, Secret + 64);
+                acc += Mix16(input + size - 48, Secret + 80);
+            }
+            acc += Mix16(input + 16, Secret + 32);
+            acc += Mix16(input + size - 32, Secret + 48);
+        }
+        acc += Mix16(input, Secret);
+        acc += Mix16(input + size - 16, Secret + 16);
+        return Avalanche(acc);
+    }
+
+    uint64_t Hash129To240(const uint8_t* input, size_t size)
+    {
+        uint64_t acc = size * Prime64_1;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            acc += Mix16(input + 16 * i, Secret + 16 * i);
+        }
+        acc = Avalanche(acc);
+
+        uint64_t accEnd = Mix16(input + size - 16, Secret + MidSizeSecretMin - 17);
+        for (size_t i = 8; i < size / 16; ++i)
+        {
+            accEnd += Mix16(input + 16 * i, Secret + 16 * (i - 8) + 3);
+        }
+        return Avalanche(acc + accEnd);
+    }
+
+    // Consecutive stripes into the accumulators, the secret moving with each stripe: every lane
+    // adds the product of the low and high halves of its data xor secret, and the neighbouring
+    // lane adds the data itself.
+    void AccumulateScalar(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t stripeCount)
+    {
+        for (size_t stripe = 0; stripe < stripeCount; ++stripe)
+        {
+            for (size_t lane = 0; lane < 8; ++lane)
+            {
+                const uint64_t data = Read64(input + stripe * StripeSize + 8 * lane);
+                const uint64_t key = data ^ Read64(secret + stripe * SecretConsumeRate + 8 * lane);
+                acc[lane ^ 1] += data;
+                acc[lane] += (key & 0xffffffff) * (key >> 32);
+            }
+        }
+    }
+
+    void ScrambleScalar(uint64_t* acc, const uint8_t* secret)
+    {
+        for (size_t lane = 0; lane < 8; ++lane)
+        {
+            uint64_t a = acc[lane];
+            a ^= a >> 47;
+            a ^= Read64(secret + 8 * lane);
+            acc[lane] = a * Prime32_1;
+        }
+    }
+
+#if defined(HASH_AVX2)
+    // The accumulators stay in registers for the whole run of stripes.
+    void AccumulateVector(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t stripeCount)
+    {
+        __m256i lanes[2] = { _mm256_load_si256(reinterpret_cast<const __m256i*>(acc)), _mm256_load_si256(reinterpret_cast<const __m256i*>(acc) + 1) };
+        for (size_t stripe = 0; stripe < stripeCount; ++stripe)
+        {
+            const __m256i* stripeInput = reinterpret_cast<const __m256i*>(input + stripe * StripeSize);
+            const __m256i* stripeSecret = reinterpret_cast<const __m256i*>(secret + stripe * SecretConsumeRate);
+            for (size_t i = 0; i < 2; ++i)
+            {
+                const __m256i data = _mm256_loadu_si256(stripeInput + i);
+                const __m256i key = _mm256_xor_si256(data, _mm256_loadu_si256(stripeSecret + i));
+                const __m256i product = _mm256_mul_epu32(key, _mm256_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+                const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                lanes[i] = _mm256_add_epi64(product, _mm256_add_epi64(lanes[i], swapped));
+            }
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc), lanes[0]);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc) + 1, lanes[1]);
+    }
+
+    void ScrambleVector(uint64_t* acc, const uint8_t* secret)
+    {
+        __m256i* lanes = reinterpret_cast<__m256i*>(acc);
+        const __m256i prime = _mm256_set1_epi32(static_cast<int>(Prime32_1));
+        for (size_t i = 0; i < 2; ++i)
+        {
+            __m256i a = _mm256_xor_si256(lanes[i], _mm256_srli_epi64(lanes[i], 47));
+            a = _mm256_xor_si256(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i));
+            const __m256i low = _mm256_mul_epu32(a, prime);
+            const __m256i high = _mm256_mul_epu32(_mm256_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+            lanes[i] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+        }
+    }
+#elif defined(HASH_SSE2)
+    void AccumulateVector(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t stripeCount)
+    {
+        __m128i lanes[4];
+        for (size_t i = 0; i < 4; ++i)
+        {
+            lanes[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(acc) + i);
+        }
+        for (size_t stripe = 0; stripe < stripeCount; ++stripe)
+        {
+            const __m128i* stripeInput = reinterpret_cast<const __m128i*>(input + stripe * StripeSize);
+            const __m128i* stripeSecret = reinterpret_cast<const __m128i*>(secret + stripe * SecretConsumeRate);
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const __m128i data = _mm_loadu_si128(stripeInput + i);
+                const __m128i key = _mm_xor_si128(data, _mm_loadu_si128(stripeSecret + i));
+                const __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+                const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                lanes[i] = _mm_add_epi64(product, _mm_add_epi64(lanes[i], swapped));
+            }
+        }
+        for (size_t i = 0; i < 4; ++i)
+        {
+            _mm_store_si128(reinterpret_cast<__m128i*>(acc) + i, lanes[i]);
+        }
+    }
+
+    void ScrambleVector(uint64_t* acc, const uint8_t* secret)
+    {
+        __m128i* lanes = reinterpret_cast<__m128i*>(acc);
+        const __m128i prime = _mm_set1_epi32(static_cast<int>(Prime32_1));
+        for (size_t i = 0; i < 4; ++i)
+        {
+            __m128i a = _mm_xor_si128(lanes[i], _mm_srli_epi64(lanes[i], 47));
+            a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+            const __m128i low = _mm_mul_epu32(a, prime);
+            const __m128i high = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+            lanes[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+        }
+    }
+#elif defined(HASH_NEON)
+    void AccumulateVector(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t stripeCount)
+    {
+        uint64x2_t lanes[4];
+        for (size_t i = 0; i < 4; ++i)
+        {
+            lanes[i] = vld1q_u64(acc + 2 * i);
+        }
+        for (size_t stripe = 0; stripe < stripeCount; ++stripe)
+        {
+            const uint8_t* stripeInput = input + stripe * StripeSize;
+            const uint8_t* stripeSecret = secret + stripe * SecretConsumeRate;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(stripeInput + 16 * i));
+                const uint64x2_t key = veorq_u64(data, vreinterpretq_u64_u8(vld1q_u8(stripeSecret + 16 * i)));
+                lanes[i] = vaddq_u64(lanes[i], vextq_u64(data, data, 1));
+                lanes[i] = vmlal_u32(lanes[i], vmovn_u64(key), vshrn_n_u64(key, 32));
+            }
+        }
+        for (size_t i = 0; i < 4; ++i)
+        {
+            vst1q_u64(acc + 2 * i, lanes[i]);
+        }
+    }
+
+    void ScrambleVector(uint64_t* acc, const uint8_t* secret)
+    {
+        const uint32x2_t prime = vdup_n_u32(static_cast<uint32_t>(Prime32_1));
+        for (size_t i = 0; i < 4; ++i)
+        {
+            uint64x2_t a = vld1q_u64(acc + 2 * i);
+            a = veorq_u64(a, vshrq_n_u64(a, 47));
+            a = veorq_u64(a, vreinterpretq_u64_u8(vld1q_u8(secret + 16 * i)));
+            const uint64x2_t high = vmull_u32(vshrn_n_u64(a, 32), prime);
+            vst1q_u64(acc + 2 * i, vmlal_u32(vshlq_n_u64(high, 32), vmovn_u64(a), prime));
+        }
+    }
+#else
+    void AccumulateVector(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t stripeCount)
+    {
+        AccumulateScalar(acc, input, secret, stripeCount);
+    }
+
+    void ScrambleVector(uint64_t* acc, const uint8_t* secret)
+    {
+        ScrambleScalar(acc, secret);
+    }
+#endif
+
+    template <void (*Accumulate)(uint64_t*, const uint8_t*, const uint8_t*, size_t), void (*Scramble)(uint64_t*, const uint8_t*)>
+    uint64_t HashLong(const uint8_t* input, size_t size)
+    {
+        alignas(32) uint64_t acc[8] = { Prime32_3, Prime64_1, Prime64_2, Prime64_3, Prime64_4, Prime32_2, Prime64_5, Prime32_1 };
+
+        // Whole blocks, then the stripes left over; the final stripe, which may overlap the
+        // previous one, always ends at the last byte.
+        const size_t blockCount = (size - 1) / BlockSize;
+        for (size_t block = 0; block < blockCount; ++block)
+        {
+            Accumulate(acc, input + block * BlockSize, Secret, StripesPerBlock);
+            Scramble(acc, Secret + SecretSize - StripeSize);
+        }
+        const size_t stripeCount = ((size - 1) - blockCount * BlockSize) / StripeSize;
+        Accumulate(acc, input + blockCount * BlockSize, Secret, stripeCount);
+        Accumulate(acc, input + size - StripeSize, Secret + SecretSize - StripeSize - 7, 1);
+
+        uint64_t result = size * Prime64_1;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            result += MulFold64(acc[2 * i] ^ Read64(Secret + 11 + 16 * i), acc[2 * i + 1] ^ Read64(Secret + 11 + 16 * i + 8));
+        }
+        return Avalanche(result);
+    }
+
+    template <void (*Accumulate)(uint64_t*, const uint8_t*, const uint8_t*, size_t), void (*Scramble)(uint64_t*, const uint8_t*)>
+    uint64_t Hash(const void* data, size_t size)
+    {
+        const uint8_t* input = static_cast<const uint8_t*>(data);
+        if (size <= 16)
+        {
+            return Hash0To16(input, size);
+        }
+        if (size <= 128)
+        {
+            return Hash17To128(input, size);
+        }
+        if (size <= MidSizeMax)
+        {
+            return Hash129To240(input, size);
+        }
+        return HashLong<Accumulate, Scramble>(input, size);
+    }
+}
+
+uint64_t HashContent(const void* data, size_t size)
+{
+    return Hash<AccumulateVector, ScrambleVector>(data, size);
+}
+
+uint64_t HashContentReference(const void* data, size_t size)
+{
+    return Hash<AccumulateScalar, ScrambleScalar>(data, size);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 64-bit hash of a block of memory, for identifying resources by their content.
+//
+// The function is XXH3 64 (xxHash 0.8, default secret, seed 0): hashes match XXH3_64bits, so the
+// tools that pack assets can compute them with the reference library. Inputs up to 240 bytes take
+// a few multiplies; larger inputs run at memory speed with vector kernels (SSE2, AVX2, NEON;
+// chosen at compile time). Not a cryptographic hash: equal hashes mean equal content only with
+// overwhelming probability, and callers that cannot afford a collision compare the bytes too.
+uint64_t HashContent(const void* data, size_t size);
+
+// The scalar form of the long input loop, what the vector kernels are checked against.
+uint64_t HashContentReference(const void* data, size_t size);
@@ -0,0 +1,713 @@
+#include "Stdafx.h"
+#include "D3D12CommandCapture.h"
+#include "FrameAllocators.h"
+
+#include <algorithm>
+#include <cstring>
+
+D3D12CommandCapture::D3D12CommandCapture()
+{
+}
+
+D3D12CommandCapture::~D3D12CommandCapture()
+{
+}
+
+void D3D12CommandCapture::Open(const std::wstring& path)
+{
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file)
+    {
+        throw std::runtime_error("Can't create the command capture.");
+    }
+    m_writer.reset(new CommandStreamWriter(m_file));
+}
+
+void D3D12CommandCapture::Close()
+{
+    if (m_writer)
+    {
+        m_writer->Flush();
+        m_writer.reset();
+        m_file.close();
+    }
+}
+
+UINT32 D3D12CommandCapture::AddObject(ID3D12Object* object, CommandObjectType type, const char* name)
+{
+    m_objects.push_back(object);
+    const UINT32 id = static_cast<UINT32>(m_objects.size());
+    // An address can come back for a new object once the old one is released.
+    m_ids[object] = id;
+
+    Write(CommandOp::DefineObject, { id, static_cast<uint32_t>(type) }, name, strlen(name));
+    return id;
+}
+
+UINT32 D3D12CommandCapture::AddResource(ID3D12Resource* resource, const char* name)
+{
+    m_objects.push_back(resource);
+    const UINT32 id = static_cast<UINT32>(m_objects.size());
+    m_ids[resource] = id;
+
+    const D3D12_RESOURCE_DESC desc = resource->GetDesc();
+    D3D12_HEAP_PROPERTIES heapProperties = {};
+    resource->GetHeapProperties(&heapProperties, nullptr);
+    Write(CommandOp::DefineObject,
+        { id, static_cast<uint32_t>(CommandObjectType::Resource), static_cast<uint32_t>(desc.Dimension), static_cast<uint32_t>(desc.Width),
+          desc.Height, desc.DepthOrArraySize, static_cast<uint32_t>(desc.Format), static_cast<uint32_t>(heapProperties.Type) },
+        name, strlen(name));
+
+    // Buffers are found by GPU address, for views and root descriptors. Ranges of released
+    // buffers that the new one overlaps are dropped.
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+    {
+        const ResourceRange range = { resource->GetGPUVirtualAddress(), desc.Width, id };
+        m_resources.erase(std::remove_if(m_resources.begin(), m_resources.end(), [&range](const ResourceRange& other)
+        {
+            return other.Start < range.Start + range.Size && range.Start < other.Start + other.Size;
+        }), m_resources.end());
+        m_resources.insert(std::upper_bound(m_resources.begin(), m_resources.end(), range, [](const ResourceRange& a, const ResourceRange& b)
+        {
+            return a.Start < b.Start;
+        }), range);
+    }
+    return id;
+}
+
+UINT32 D3D12CommandCapture::AddDescriptorHeap(ID3D12Device* device, ID3D12DescriptorHeap* heap, const char* name)
+{
+    m_objects.push_back(heap);
+    const UINT32 id = static_cast<UINT32>(m_objects.size());
+    m_ids[heap] = id;
+
+    const D3D12_DESCRIPTOR_HEAP_DESC desc = heap->GetDesc();
+    DescriptorHeapRange range;
+    range.Id = id;
+    range.CpuStart = heap->GetCPUDescriptorHandleForHeapStart().ptr;
+    range.GpuStart = (desc.Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) ? heap->GetGPUDescriptorHandleForHeapStart().ptr : 0;
+    range.Count = desc.NumDescriptors;
+    range.Increment = device->GetDescriptorHandleIncrementSize(desc.Type);
+    m_heaps.push_back(range);
+
+    Write(CommandOp::DefineObject,
+        { id, static_cast<uint32_t>(CommandObjectType::DescriptorHeap), static_cast<uint32_t>(desc.Type), desc.NumDescriptors },
+        name, strlen(name));
+    return id;
+}
+
+UINT32 D3D12CommandCapture::GetId(const void* object) const
+{
+    if (!object)
+    {
+        return 0;
+    }
+    const auto found = m_ids.find(object);
+    if (found == m_ids.end())
+    {
+        throw std::runtime_error("Captured command uses an unregistered object.");
+    }
+    return found->second;
+}
+
+ID3D12Object* D3D12CommandCapture::GetById(UINT32 id) const
+{
+    if (id == 0)
+    {
+        return nullptr;
+    }
+    if (id > m_objects.size())
+    {
+        throw std::runtime_error("Replayed command uses an unknown object.");
+    }
+    return m_objects[id - 1];
+}
+
+void D3D12CommandCapture::FindDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE handle, UINT32& heap, UINT32& index) const
+{
+    for (const DescriptorHeapRange& range : m_heaps)
+    {
+        if (handle.ptr >= range.CpuStart && handle.ptr < range.CpuStart + static_cast<SIZE_T>(range.Count) * range.Increment)
+        {
+            heap = range.Id;
+            index = static_cast<UINT32>((handle.ptr - range.CpuStart) / range.Increment);
+            return;
+        }
+    }
+    throw std::runtime_error("Captured descriptor is in no registered heap.");
+}
+
+void D3D12CommandCapture::FindDescriptor(D3D12_GPU_DESCRIPTOR_HANDLE handle, UINT32& heap, UINT32& index) const
+{
+    for (const DescriptorHeapRange& range : m_heaps)
+    {
+        if (range.GpuStart != 0 && handle.ptr >= range.GpuStart && handle.ptr < range.GpuStart + static_cast<UINT64>(range.Count) * range.Increment)
+        {
+            heap = range.Id;
+            index = static_cast<UINT32>((handle.ptr - range.GpuStart) / range.Increment);
+            return;
+        }
+    }
+    throw std::runtime_error("Captured descriptor is in no registered heap.");
+}
+
+void D3D12CommandCapture::FindAddress(D3D12_GPU_VIRTUAL_ADDRESS address, UINT32& resource, UINT32& offset) const
+{
+    auto next = std::upper_bound(m_resources.begin(), m_resources.end(), address, [](D3D12_GPU_VIRTUAL_ADDRESS value, const ResourceRange& range)
+    {
+        return value < range.Start;
+    });
+    if (next == m_resources.begin() || address >= (next - 1)->Start + (next - 1)->Size)
+    {
+        throw std::runtime_error("Captured address is in no registered buffer.");
+    }
+    resource = (next - 1)->Id;
+    offset = static_cast<UINT32>(address - (next - 1)->Start);
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE D3D12CommandCapture::GetCpuDescriptor(UINT32 heap, UINT32 index) const
+{
+    for (const DescriptorHeapRange& range : m_heaps)
+    {
+        if (range.Id == heap && index < range.Count)
+        {
+            return D3D12_CPU_DESCRIPTOR_HANDLE{ range.CpuStart + static_cast<SIZE_T>(index) * range.Increment };
+        }
+    }
+    throw std::runtime_error("Replayed descriptor is in no registered heap.");
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE D3D12CommandCapture::GetGpuDescriptor(UINT32 heap, UINT32 index) const
+{
+    for (const DescriptorHeapRange& range : m_heaps)
+    {
+        if (range.Id == heap && range.GpuStart != 0 && index < range.Count)
+        {
+            return D3D12_GPU_DESCRIPTOR_HANDLE{ range.GpuStart + static_cast<UINT64>(index) * range.Increment };
+        }
+    }
+    throw std::runtime_error("Replayed descriptor is in no registered heap.");
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS D3D12CommandCapture::GetAddress(UINT32 resource, UINT32 offset) const
+{
+    return Get<ID3D12Resource>(resource)->GetGPUVirtualAddress() + offset;
+}
+
+void D3D12CommandCapture::BeginFrame(LinearArena& arena, UINT32 frameNumber, UINT32 backBufferIndex)
+{
+    if (m_writer)
+    {
+        m_writer->BeginFrame(arena, frameNumber, backBufferIndex);
+    }
+}
+
+void D3D12CommandCapture::EndFrame()
+{
+    if (m_writer)
+    {
+        m_writer->EndFrame();
+    }
+}
+
+void D3D12CommandCapture::Write(CommandOp op, std::initializer_list<uint32_t> fields, const void* data, size_t dataSize)
+{
+    if (m_writer)
+    {
+        m_writer->Write(op, fields, data, dataSize);
+    }
+}
+
+void D3D12CommandCapture::CaptureBufferWrite(ID3D12Resource* resource, UINT32 offset, const void* data, size_t size)
+{
+    if (m_writer)
+    {
+        m_writer->Write(CommandOp::WriteBuffer, { GetId(resource), offset }, data, size);
+    }
+}
+
+void D3D12CommandCapture::CaptureExecute(ID3D12CommandList* list)
+{
+    if (m_writer)
+    {
+        m_writer->Write(CommandOp::ExecuteCommandList, { GetId(list) });
+    }
+}
+
+void D3D12CommandCapture::CapturePresent(UINT syncInterval)
+{
+    if (m_writer)
+    {
+        m_writer->Write(CommandOp::Present, { syncInterval });
+    }
+}
+
+uint64_t D3D12CommandCapture::GetBytesWritten() const
+{
+    return m_writer ? m_writer->GetBytesWritten() : 0;
+}
+
+
+void CapturedCommandList::Reset(ID3D12CommandAllocator* allocator, ID3D12PipelineState* pipelineState)
+{
+    ThrowIfFailed(m_list->Reset(allocator, pipelineState));
+    CaptureOpen(allocator, pipelineState);
+}
+
+void CapturedCommandList::CaptureOpen(ID3D12CommandAllocator* allocator, ID3D12PipelineState* pipelineState)
+{
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::ResetCommandList, { m_capture.GetId(m_list), m_capture.GetId(allocator), m_capture.GetId(pipelineState) });
+    }
+}
+
+void CapturedCommandList::Close()
+{
+    ThrowIfFailed(m_list->Close());
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::CloseCommandList, { m_capture.GetId(m_list) });
+    }
+}
+
+void CapturedCommandList::SetPipelineState(ID3D12PipelineState* pipelineState)
+{
+    m_list->SetPipelineState(pipelineState);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::SetPipelineState, { m_capture.GetId(pipelineState) });
+    }
+}
+
+void CapturedCommandList::SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)
+{
+    m_list->SetGraphicsRootSignature(rootSignature);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::SetGraphicsRootSignature, { m_capture.GetId(rootSignature) });
+    }
+}
+
+void CapturedCommandList::SetDescriptorHeaps(UINT count, ID3D12DescriptorHeap* const* heaps)
+{
+    m_list->SetDescriptorHeaps(count, heaps);
+    if (m_capture.IsCapturing())
+    {
+        // At most one heap of each type can be set.
+        m_capture.Write(CommandOp::SetDescriptorHeaps, { count > 0 ? m_capture.GetId(heaps[0]) : 0, count > 1 ? m_capture.GetId(heaps[1]) : 0 });
+    }
+}
+
+void CapturedCommandList::SetGraphicsRootDescriptorTable(UINT parameter, D3D12_GPU_DESCRIPTOR_HANDLE handle)
+{
+    m_list->SetGraphicsRootDescriptorTable(parameter, handle);
+    if (m_capture.IsCapturing())
+    {
+        UINT32 heap;
+        UINT32 index;
+        m_capture.FindDescriptor(handle, heap, index);
+        m_capture.Write(CommandOp::SetGraphicsRootDescriptorTable, { parameter, heap, index });
+    }
+}
+
+void CapturedCommandList::SetGraphicsRootConstantBufferView(UINT parameter, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+    m_list->SetGraphicsRootConstantBufferView(parameter, address);
+    if (m_capture.IsCapturing())
+    {
+        UINT32 resource;
+        UINT32 offset;
+        m_capture.FindAddress(address, resource, offset);
+        m_capture.Write(CommandOp::SetGraphicsRootConstantBufferView, { parameter, resource, offset });
+    }
+}
+
+void CapturedCommandList::SetGraphicsRoot32BitConstants(UINT parameter, UINT count, const void* data, UINT firstConstant)
+{
+    m_list->SetGraphicsRoot32BitConstants(parameter, count, data, firstConstant);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::SetGraphicsRoot32BitConstants, { parameter, firstConstant }, data, count * sizeof(UINT32));
+    }
+}
+
+void CapturedCommandList::RSSetViewport(const D3D12_VIEWPORT& viewport)
+{
+    m_list->RSSetViewports(1, &viewport);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::SetViewport,
+            { CommandFloatBits(viewport.TopLeftX), CommandFloatBits(viewport.TopLeftY), CommandFloatBits(viewport.Width), CommandFloatBits(viewport.Height),
+              CommandFloatBits(viewport.MinDepth), CommandFloatBits(viewport.MaxDepth) });
+    }
+}
+
+void CapturedCommandList::RSSetScissorRect(const D3D12_RECT& rect)
+{
+    m_list->RSSetScissorRects(1, &rect);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::SetScissorRect,
+            { static_cast<uint32_t>(rect.left), static_cast<uint32_t>(rect.top), static_cast<uint32_t>(rect.right), static_cast<uint32_t>(rect.bottom) });
+    }
+}
+
+void CapturedCommandList::OMSetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE handle)
+{
+    m_list->OMSetRenderTargets(1, &handle, FALSE, nullptr);
+    if (m_capture.IsCapturing())
+    {
+        UINT32 heap;
+        UINT32 index;
+        m_capture.FindDescriptor(handle, heap, index);
+        m_capture.Write(CommandOp::SetRenderTarget, { heap, index });
+    }
+}
+
+void CapturedCommandList::ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE handle, const FLOAT color[4], const D3D12_RECT* rect)
+{
+    m_list->ClearRenderTargetView(handle, color, rect ? 1 : 0, rect);
+    if (m_capture.IsCapturing())
+    {
+        UINT32 heap;
+        UINT32 index;
+        m_capture.FindDescriptor(handle, heap, index);
+        const D3D12_RECT all = {};
+        const D3D12_RECT& r = rect ? *rect : all;
+        m_capture.Write(CommandOp::ClearRenderTarget,
+            { heap, index, CommandFloatBits(color[0]), CommandFloatBits(color[1]), CommandFloatBits(color[2]), CommandFloatBits(color[3]),
+              static_cast<uint32_t>(r.left), static_cast<uint32_t>(r.top), static_cast<uint32_t>(r.right), static_cast<uint32_t>(r.bottom) });
+    }
+}
+
+void CapturedCommandList::IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+{
+    m_list->IASetPrimitiveTopology(topology);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::SetPrimitiveTopology, { static_cast<uint32_t>(topology) });
+    }
+}
+
+void CapturedCommandList::IASetVertexBuffer(UINT slot, const D3D12_VERTEX_BUFFER_VIEW& view)
+{
+    m_list->IASetVertexBuffers(slot, 1, &view);
+    if (m_capture.IsCapturing())
+    {
+        UINT32 resource;
+        UINT32 offset;
+        m_capture.FindAddress(view.BufferLocation, resource, offset);
+        m_capture.Write(CommandOp::SetVertexBuffer, { slot, resource, offset, view.SizeInBytes, view.StrideInBytes });
+    }
+}
+
+void CapturedCommandList::DrawInstanced(UINT vertexCount, UINT instanceCount, UINT firstVertex, UINT firstInstance)
+{
+    m_list->DrawInstanced(vertexCount, instanceCount, firstVertex, firstInstance);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::Draw, { vertexCount, instanceCount, firstVertex, firstInstance });
+    }
+}
+
+void CapturedCommandList::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view)
+{
+    m_list->IASetIndexBuffer(&view);
+    if (m_capture.IsCapturing())
+    {
+        UINT32 resource;
+        UINT32 offset;
+        m_capture.FindAddress(view.BufferLocation, resource, offset);
+        m_capture.Write(CommandOp::SetIndexBuffer, { resource, offset, view.SizeInBytes, static_cast<uint32_t>(view.Format) });
+    }
+}
+
+void CapturedCommandList::DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT firstIndex, INT baseVertex, UINT firstInstance)
+{
+    m_list->DrawIndexedInstanced(indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::DrawIndexed, { indexCount, instanceCount, firstIndex, static_cast<uint32_t>(baseVertex), firstInstance });
+    }
+}
+
+void CapturedCommandList::ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers)
+{
+    m_list->ResourceBarrier(count, barriers);
+    if (m_capture.IsCapturing())
+    {
+        for (UINT i = 0; i < count; ++i)
+        {
+            const D3D12_RESOURCE_BARRIER& barrier = barriers[i];
+            if (barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+            {
+                m_capture.Write(CommandOp::Transition,
+                    { m_capture.GetId(barrier.Transition.pResource), barrier.Transition.Subresource,
+                      static_cast<uint32_t>(barrier.Transition.StateBefore), static_cast<uint32_t>(barrier.Transition.StateAfter) });
+            }
+        }
+    }
+}
+
+void CapturedCommandList::EndQuery(ID3D12QueryHeap* heap, D3D12_QUERY_TYPE type, UINT index)
+{
+    m_list->EndQuery(heap, type, index);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::EndQuery, { m_capture.GetId(heap), static_cast<uint32_t>(type), index });
+    }
+}
+
+void CapturedCommandList::ResolveQueryData(ID3D12QueryHeap* heap, D3D12_QUERY_TYPE type, UINT first, UINT count, ID3D12Resource* buffer, UINT64 offset)
+{
+    m_list->ResolveQueryData(heap, type, first, count, buffer, offset);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::ResolveQueryData,
+            { m_capture.GetId(heap), static_cast<uint32_t>(type), first, count, m_capture.GetId(buffer), static_cast<uint32_t>(offset) });
+    }
+}
+
+void CapturedCommandList::CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION& dest, const D3D12_TEXTURE_COPY_LOCATION& source)
+{
+    CopyTextureRegion(dest, 0, 0, source);
+}
+
+void CapturedCommandList::CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION& dest, UINT destX, UINT destY, const D3D12_TEXTURE_COPY_LOCATION& source)
+{
+    m_list->CopyTextureRegion(&dest, destX, destY, 0, &source, nullptr);
+    if (m_capture.IsCapturing() && source.Type == D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT && dest.Type == D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX)
+    {
+        const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = source.PlacedFootprint;
+        if (destX == 0 && destY == 0)
+        {
+            m_capture.Write(CommandOp::CopyBufferToTexture,
+                { m_capture.GetId(dest.pResource), dest.SubresourceIndex, m_capture.GetId(source.pResource), static_cast<uint32_t>(layout.Offset),
+                  static_cast<uint32_t>(layout.Footprint.Format), layout.Footprint.Width, layout.Footprint.Height, layout.Footprint.Depth, layout.Footprint.RowPitch });
+        }
+        else
+        {
+            m_capture.Write(CommandOp::CopyBufferToTextureRegion,
+                { m_capture.GetId(dest.pResource), dest.SubresourceIndex, m_capture.GetId(source.pResource), static_cast<uint32_t>(layout.Offset),
+                  static_cast<uint32_t>(layout.Footprint.Format), layout.Footprint.Width, layout.Footprint.Height, layout.Footprint.RowPitch, destX, destY });
+        }
+    }
+}
+
+void CapturedCommandList::CopyBufferRegion(ID3D12Resource* dest, UINT64 destOffset, ID3D12Resource* source, UINT64 sourceOffset, UINT64 size)
+{
+    m_list->CopyBufferRegion(dest, destOffset, source, sourceOffset, size);
+    if (m_capture.IsCapturing())
+    {
+        m_capture.Write(CommandOp::CopyBuffer,
+            { m_capture.GetId(dest), static_cast<uint32_t>(destOffset), m_capture.GetId(source), static_cast<uint32_t>(sourceOffset), static_cast<uint32_t>(size) });
+    }
+}
+
+void CapturedCommandList::UpdateSubresource(ID3D12Resource* dest, ID3D12Resource* intermediate, const D3D12_SUBRESOURCE_DATA& data)
+{
+    UpdateSubresources(m_list, dest, intermediate, 0, 0, 1, &data);
+    if (!m_capture.IsCapturing())
+    {
+        return;
+    }
+
+    // Capture the upload buffer the way UpdateSubresources laid it out: rows at the device's
+    // pitch, then the copy out of it.
+    ComPtr<ID3D12Device> device;
+    ThrowIfFailed(dest->GetDevice(IID_PPV_ARGS(&device)));
+    const D3D12_RESOURCE_DESC desc = dest->GetDesc();
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout;
+    UINT rowCount;
+    UINT64 rowSize;
+    UINT64 totalBytes;
+    device->GetCopyableFootprints(&desc, 0, 1, 0, &layout, &rowCount, &rowSize, &totalBytes);
+
+    ScratchScope scratch;
+    const size_t size = static_cast<size_t>(totalBytes - layout.Offset);
+    UINT8* pitched = scratch.Allocate<UINT8>(size);
+    for (UINT slice = 0; slice < layout.Footprint.Depth; ++slice)
+    {
+        for (UINT row = 0; row < rowCount; ++row)
+        {
+            memcpy(pitched + (static_cast<size_t>(slice) * rowCount + row) * layout.Footprint.RowPitch,
+                static_cast<const UINT8*>(data.pData) + slice * data.SlicePitch + row * data.RowPitch,
+                static_cast<size_t>(rowSize));
+        }
+    }
+    m_capture.CaptureBufferWrite(intermediate, static_cast<UINT32>(layout.Offset), pitched, size);
+    m_capture.Write(CommandOp::CopyBufferToTexture,
+        { m_capture.GetId(dest), 0, m_capture.GetId(intermediate), static_cast<uint32_t>(layout.Offset), static_cast<uint32_t>(layout.Footprint.Format),
+          layout.Footprint.Width, layout.Footprint.Height, layout.Footprint.Depth, layout.Footprint.RowPitch });
+}
+
+
+D3D12ReplayBackend::D3D12ReplayBackend(D3D12CommandCapture& objects, ID3D12CommandQueue* queue, IDXGISwapChain3* swapChain) :
+    m_objects(objects),
+    m_queue(queue),
+    m_swapChain(swapChain),
+    m_list(nullptr)
+{
+}
+
+void D3D12ReplayBackend::Execute(const CommandPacket& packet)
+{
+    const uint32_t* f = packet.Fields;
+    if (!m_list && packet.Op > CommandOp::ResetCommandList && packet.Op != CommandOp::WriteBuffer)
+    {
+        throw std::runtime_error("Replayed command before any command list reset.");
+    }
+
+    switch (packet.Op)
+    {
+    case CommandOp::DefineObject:
+        // The app created its objects itself; only check that it created as many.
+        if (f[0] == 0)
+        {
+            throw std::runtime_error("Malformed object definition.");
+        }
+        m_objects.GetById(f[0]);
+        break;
+    case CommandOp::FrameBegin:
+        break;
+    case CommandOp::Present:
+        ThrowIfFailed(m_swapChain->Present(f[0], 0));
+        break;
+    case CommandOp::ResetCommandList:
+    {
+        ID3D12CommandAllocator* allocator = m_objects.Get<ID3D12CommandAllocator>(f[1]);
+        m_list = m_objects.Get<ID3D12GraphicsCommandList>(f[0]);
+        ThrowIfFailed(allocator->Reset());
+        ThrowIfFailed(m_list->Reset(allocator, m_objects.Get<ID3D12PipelineState>(f[2])));
+        break;
+    }
+    case CommandOp::CloseCommandList:
+        ThrowIfFailed(m_objects.Get<ID3D12GraphicsCommandList>(f[0])->Close());
+        break;
+    case CommandOp::ExecuteCommandList:
+    {
+        ID3D12CommandList* lists[] = { m_objects.Get<ID3D12GraphicsCommandList>(f[0]) };
+        m_queue->ExecuteCommandLists(1, lists);
+        break;
+    }
+    case CommandOp::SetPipelineState:
+        m_list->SetPipelineState(m_objects.Get<ID3D12PipelineState>(f[0]));
+        break;
+    case CommandOp::SetGraphicsRootSignature:
+        m_list->SetGraphicsRootSignature(m_objects.Get<ID3D12RootSignature>(f[0]));
+        break;
+    case CommandOp::SetDescriptorHeaps:
+    {
+        ID3D12DescriptorHeap* heaps[] = { m_objects.Get<ID3D12DescriptorHeap>(f[0]), m_objects.Get<ID3D12DescriptorHeap>(f[1]) };
+        m_list->SetDescriptorHeaps(heaps[1] ? 2 : (heaps[0] ? 1 : 0), heaps);
+        break;
+    }
+    case CommandOp::SetGraphicsRootDescriptorTable:
+        m_list->SetGraphicsRootDescriptorTable(f[0], m_objects.GetGpuDescriptor(f[1], f[2]));
+        break;
+    case CommandOp::SetGraphicsRootConstantBufferView:
+        m_list->SetGraphicsRootConstantBufferView(f[0], m_objects.GetAddress(f[1], f[2]));
+        break;
+    case CommandOp::SetGraphicsRoot32BitConstants:
+        m_list->SetGraphicsRoot32BitConstants(f[0], static_cast<UINT>(packet.DataSize / sizeof(UINT32)), packet.Data, f[1]);
+        break;
+    case CommandOp::SetViewport:
+    {
+        const D3D12_VIEWPORT viewport = { CommandBitsFloat(f[0]), CommandBitsFloat(f[1]), CommandBitsFloat(f[2]), CommandBitsFloat(f[3]), CommandBitsFloat(f[4]), CommandBitsFloat(f[5]) };
+        m_list->RSSetViewports(1, &viewport);
+        break;
+    }
+    case CommandOp::SetScissorRect:
+    {
+        const D3D12_RECT rect = { static_cast<LONG>(f[0]), static_cast<LONG>(f[1]), static_cast<LONG>(f[2]), static_cast<LONG>(f[3]) };
+        m_list->RSSetScissorRects(1, &rect);
+        break;
+    }
+    case CommandOp::SetRenderTarget:
+    {
+        const D3D12_CPU_DESCRIPTOR_HANDLE handle = m_objects.GetCpuDescriptor(f[0], f[1]);
+        m_list->OMSetRenderTargets(1, &handle, FALSE, nullptr);
+        break;
+    }
+    case CommandOp::ClearRenderTarget:
+    {
+        const FLOAT color[] = { CommandBitsFloat(f[2]), CommandBitsFloat(f[3]), CommandBitsFloat(f[4]), CommandBitsFloat(f[5]) };
+        const D3D12_RECT rect = { static_cast<LONG>(f[6]), static_cast<LONG>(f[7]), static_cast<LONG>(f[8]), static_cast<LONG>(f[9]) };
+        const bool all = rect.right == rect.left && rect.bottom == rect.top;
+        m_list->ClearRenderTargetView(m_objects.GetCpuDescriptor(f[0], f[1]), color, all ? 0 : 1, all ? nullptr : &rect);
+        break;
+    }
+    case CommandOp::SetPrimitiveTopology:
+        m_list->IASetPrimitiveTopology(static_cast<D3D12_PRIMITIVE_TOPOLOGY>(f[0]));
+        break;
+    case CommandOp::SetVertexBuffer:
+    {
+        const D3D12_VERTEX_BUFFER_VIEW view = { m_objects.GetAddress(f[1], f[2]), f[3], f[4] };
+        m_list->IASetVertexBuffers(f[0], 1, &view);
+        break;
+    }
+    case CommandOp::Draw:
+        m_list->DrawInstanced(f[0], f[1], f[2], f[3]);
+        break;
+    case CommandOp::SetIndexBuffer:
+    {
+        const D3D12_INDEX_BUFFER_VIEW view = { m_objects.GetAddress(f[0], f[1]), f[2], static_cast<DXGI_FORMAT>(f[3]) };
+        m_list->IASetIndexBuffer(&view);
+        break;
+    }
+    case CommandOp::DrawIndexed:
+        m_list->DrawIndexedInstanced(f[0], f[1], f[2], static_cast<INT>(f[3]), f[4]);
+        break;
+    case CommandOp::Transition:
+    {
+        const D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
+            m_objects.Get<ID3D12Resource>(f[0]), static_cast<D3D12_RESOURCE_STATES>(f[2]), static_cast<D3D12_RESOURCE_STATES>(f[3]), f[1]);
+        m_list->ResourceBarrier(1, &barrier);
+        break;
+    }
+    case CommandOp::EndQuery:
+        m_list->EndQuery(m_objects.Get<ID3D12QueryHeap>(f[0]), static_cast<D3D12_QUERY_TYPE>(f[1]), f[2]);
+        break;
+    case CommandOp::ResolveQueryData:
+        m_list->ResolveQueryData(m_objects.Get<ID3D12QueryHeap>(f[0]), static_cast<D3D12_QUERY_TYPE>(f[1]), f[2], f[3], m_objects.Get<ID3D12Resource>(f[4]), f[5]);
+        break;
+    case CommandOp::WriteBuffer:
+    {
+        // Upload heaps only, like the app's own writes.
+        ID3D12Resource* resource = m_objects.Get<ID3D12Resource>(f[0]);
+        UINT8* pData;
+        const CD3DX12_RANGE readRange(0, 0);
+        ThrowIfFailed(resource->Map(0, &readRange, reinterpret_cast<void**>(&pData)));
+        memcpy(pData + f[1], packet.Data, packet.DataSize);
+        const CD3DX12_RANGE writeRange(f[1], f[1] + packet.DataSize);
+        resource->Unmap(0, &writeRange);
+        break;
+    }
+    case CommandOp::CopyBufferToTexture:
+    {
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout;
+        layout.Offset = f[3];
+        layout.Footprint = { static_cast<DXGI_FORMAT>(f[4]), f[5], f[6], f[7], f[8] };
+        const CD3DX12_TEXTURE_COPY_LOCATION dest(m_objects.Get<ID3D12Resource>(f[0]), f[1]);
+        const CD3DX12_TEXTURE_COPY_LOCATION source(m_objects.Get<ID3D12Resource>(f[2]), layout);
+        m_list->CopyTextureRegion(&dest, 0, 0, 0, &source, nullptr);
+        break;
+    }
+    case CommandOp::CopyBufferToTextureRegion:
+    {
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout;
+        layout.Offset = f[3];
+        layout.Footprint = { static_cast<DXGI_FORMAT>(f[4]), f[5], f[6], 1, f[7] };
+        const CD3DX12_TEXTURE_COPY_LOCATION dest(m_objects.Get<ID3D12Resource>(f[0]), f[1]);
+        const CD3DX12_TEXTURE_COPY_LOCATION source(m_objects.Get<ID3D12Resource>(f[2]), layout);
+        m_list->CopyTextureRegion(&dest, f[8], f[9], 0, &source, nullptr);
+        break;
+    }
+    case CommandOp::CopyBuffer:
+        m_list->CopyBufferRegion(m_objects.Get<ID3D12Resource>(f[0]), f[1], m_objects.Get<ID3D12Resource>(f[2]), f[3], f[4]);
+        break;
+    default:
+        throw std::runtime_error("Unknown replayed command.");
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "CommandStream.h"
+#include "DXSampleHelper.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Capture of the D3D12 calls of the app into a command stream, and the ids both the capture and
+// the replay use for the D3D12 objects. Objects are registered as they are created, whether or
+// not a capture is running, so that a replaying run, which creates the same objects in the same
+// order, gives them the ids the stream refers to.
+// The table does not hold references: ids of released objects must not be replayed (the setup
+// commands are not; only frames are).
+// 앱의 D3D12 호출을 커맨드 스트림으로 기록한다. 객체는 만들어진 순서대로 id 를 받으므로
+// 같은 순서로 객체를 만드는 재생 실행에서도 같은 id 가 된다.
+class D3D12CommandCapture
+{
+public:
+    D3D12CommandCapture();
+    ~D3D12CommandCapture();
+
+    // Starts writing everything recorded from now on to the file.
+    void Open(const std::wstring& path);
+    // Writes out what is pending and closes the file.
+    void Close();
+    bool IsCapturing() const { return m_writer != nullptr; }
+
+    // Registration. Returns the id, never 0 (0 stands for no object).
+    UINT32 AddObject(ID3D12Object* object, CommandObjectType type, const char* name);
+    UINT32 AddResource(ID3D12Resource* resource, const char* name);
+    UINT32 AddDescriptorHeap(ID3D12Device* device, ID3D12DescriptorHeap* heap, const char* name);
+
+    UINT32 GetId(const void* object) const;
+    ID3D12Object* GetById(UINT32 id) const;
+    template <typename T>
+    T* Get(UINT32 id) const { return static_cast<T*>(GetById(id)); }
+
+    // Translation between handles or addresses and (object id, index or offset).
+    void FindDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE handle, UINT32& heap, UINT32& index) const;
+    void FindDescriptor(D3D12_GPU_DESCRIPTOR_HANDLE handle, UINT32& heap, UINT32& index) const;
+    void FindAddress(D3D12_GPU_VIRTUAL_ADDRESS address, UINT32& resource, UINT32& offset) const;
+    D3D12_CPU_DESCRIPTOR_HANDLE GetCpuDescriptor(UINT32 heap, UINT32 index) const;
+    D3D12_GPU_DESCRIPTOR_HANDLE GetGpuDescriptor(UINT32 heap, UINT32 index) const;
+    D3D12_GPU_VIRTUAL_ADDRESS GetAddress(UINT32 resource, UINT32 offset) const;
+
+    // Recording; these do nothing unless capturing.
+    void BeginFrame(LinearArena& arena, UINT32 frameNumber, UINT32 backBufferIndex);
+    void EndFrame();
+    void Write(CommandOp op, std::initializer_list<uint32_t> fields, const void* data = nullptr, size_t dataSize = 0);
+    // The CPU wrote to a mapped buffer.
+    void CaptureBufferWrite(ID3D12Resource* resource, UINT32 offset, const void* data, size_t size);
+    void CaptureExecute(ID3D12CommandList* list);
+    void CapturePresent(UINT syncInterval);
+
+    uint64_t GetBytesWritten() const;
+
+private:
+    struct DescriptorHeapRange
+    {
+        UINT32 Id;
+        SIZE_T CpuStart;
+        UINT64 GpuStart;            // 0 unless shader visible.
+        UINT32 Count;
+        UINT32 Increment;
+    };
+
+    struct ResourceRange
+    {
+        UINT64 Start;
+        UINT64 Size;
+        UINT32 Id;
+    };
+
+    std::vector<ID3D12Object*> m_objects;               // By id - 1.
+    std::unordered_map<const void*, UINT32> m_ids;
+    std::vector<DescriptorHeapRange> m_heaps;
+    std::vector<ResourceRange> m_resources;             // Buffers, sorted by address.
+
+    std::ofstream m_file;
+    std::unique_ptr<CommandStreamWriter> m_writer;
+};
+
+// Records into a D3D12 command list and, when capturing, into the capture. It has the calls the
+// app makes, with the single viewport, render target... forms it uses.
+// 커맨드 리스트에 기록하면서 캡처 중이면 같은 호출을 스트림에도 기록한다.
+class CapturedCommandList
+{
+public:
+    CapturedCommandList(ID3D12GraphicsCommandList* list, D3D12CommandCapture& capture) : m_list(list), m_capture(capture) {}
+
+    ID3D12GraphicsCommandList* Get() const { return m_list; }
+
+    void Reset(ID3D12CommandAllocator* allocator, ID3D12PipelineState* pipelineState);
+    // For a list created open: records the reset its creation did.
+    void CaptureOpen(ID3D12CommandAllocator* allocator, ID3D12PipelineState* pipelineState);
+    void Close();
+
+    void SetPipelineState(ID3D12PipelineState* pipelineState);
+    void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature);
+    void SetDescriptorHeaps(UINT count, ID3D12DescriptorHeap* const* heaps);
+    void SetGraphicsRootDescriptorTable(UINT parameter, D3D12_GPU_DESCRIPTOR_HANDLE handle);
+    void SetGraphicsRootConstantBufferView(UINT parameter, D3D12_GPU_VIRTUAL_ADDRESS address);
+    void SetGraphicsRoot32BitConstants(UINT parameter, UINT count, const void* data, UINT firstConstant);
+    void RSSetViewport(const D3D12_VIEWPORT& viewport);
+    void RSSetScissorRect(const D3D12_RECT& rect);
+    void OMSetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE handle);
+    void ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE handle, const FLOAT color[4], const D3D12_RECT* rect);
+    void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology);
+    void IASetVertexBuffer(UINT slot, const D3D12_VERTEX_BUFFER_VIEW& view);
+    void DrawInstanced(UINT vertexCount, UINT instanceCount, UINT firstVertex, UINT firstInstance);
+    void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view);
+    void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT firstIndex, INT baseVertex, UINT firstInstance);
+    // Only transition barriers are captured.
+    void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers);
+    void EndQuery(ID3D12QueryHeap* heap, D3D12_QUERY_TYPE type, UINT index);
+    void ResolveQueryData(ID3D12QueryHeap* heap, D3D12_QUERY_TYPE type, UINT first, UINT count, ID3D12Resource* buffer, UINT64 offset);
+    // Buffer to texture copies only; the whole footprint is copied to (destX, destY), of 2D
+    // footprints when the destination is not the origin.
+    void CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION& dest, const D3D12_TEXTURE_COPY_LOCATION& source);
+    void CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION& dest, UINT destX, UINT destY, const D3D12_TEXTURE_COPY_LOCATION& source);
+    void CopyBufferRegion(ID3D12Resource* dest, UINT64 destOffset, ID3D12Resource* source, UINT64 sourceOffset, UINT64 size);
+    // UpdateSubresources for subresource 0, captured as the upload buffer write and the copy.
+    void UpdateSubresource(ID3D12Resource* dest, ID3D12Resource* intermediate, const D3D12_SUBRESOURCE_DATA& data);
+
+private:
+    ID3D12GraphicsCommandList* m_list;
+    D3D12CommandCapture& m_capture;
+};
+
+// Replays captured frames on the objects the app registered, with its own queue and swap chain.
+class D3D12ReplayBackend : public CommandBackend
+{
+public:
+    D3D12ReplayBackend(D3D12CommandCapture& objects, ID3D12CommandQueue* queue, IDXGISwapChain3* swapChain);
+
+    void Execute(const CommandPacket& packet) override;
+
+private:
+    D3D12CommandCapture& m_objects;
+    ID3D12CommandQueue* m_queue;
+    IDXGISwapChain3* m_swapChain;
+    ID3D12GraphicsCommandList* m_list;      // Set by the last ResetCommandList.
+};
@@ -1,36 +1,328 @@
 #include "Stdafx.h"
 #include "D3D12HelloTexture.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+// Clear color of the scene, also the optimized clear value of the scene target.
+static const float SceneClearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+
+// Root signatures and pipeline layouts, validated, hashed and serialized at compile time. A layout
+// that binds a register twice or goes over the root signature limit doesn't compile.
+// 루트 시그니처와 파이프라인 레이아웃은 컴파일 타임에 검증, 해시, 직렬화한다.
+
+// Scene: the texture SRV, the object constants as a root CBV, and a point sampler.
+static constexpr auto SceneRootLayout = MakeRootSignature(RootSignatureAllowInputLayout,
+    std::array<RootParameterLayout, 2>{ {
+        DescriptorTable(ShaderVisibility::Pixel, SrvRange(1, 0, 0, RangeDataStatic)),
+        RootDescriptor(RootParameterType::Cbv, 0, 0, RootDataStaticWhileSetAtExecute, ShaderVisibility::Vertex) } },
+    std::array<StaticSamplerLayout, 1>{ { StaticSampler(0, SamplerFilter::Point, AddressMode::Border, 0, ShaderVisibility::Pixel) } });
+static constexpr auto SceneRootBlob = SerializeRootSignature(SceneRootLayout);
+
+// Upscale pass: the scene target SRV, four constants (UV scale and clamp) and a bilinear sampler.
+// No input layout, the full screen triangle comes from SV_VertexID.
+static constexpr auto UpscaleRootLayout = MakeRootSignature(0,
+    std::array<RootParameterLayout, 2>{ {
+        DescriptorTable(ShaderVisibility::Pixel, SrvRange(1, 0, 0, RangeDataVolatile)),
+        RootConstants(4, 1, 0, ShaderVisibility::Pixel) } },
+    std::array<StaticSamplerLayout, 1>{ { StaticSampler(1, SamplerFilter::Linear, AddressMode::Clamp, 16, ShaderVisibility::Pixel) } });
+static constexpr auto UpscaleRootBlob = SerializeRootSignature(UpscaleRootLayout);
+
+// Sprites: the texture SRV, four constants mapping pixels to clip space and the upscale pass'
+// bilinear sampler.
+static constexpr auto SpriteRootLayout = MakeRootSignature(RootSignatureAllowInputLayout,
+    std::array<RootParameterLayout, 2>{ {
+        DescriptorTable(ShaderVisibility::Pixel, SrvRange(1, 0, 0, RangeDataStatic)),
+        RootConstants(4, 2, 0, ShaderVisibility::Vertex) } },
+    std::array<StaticSamplerLayout, 1>{ { StaticSampler(1, SamplerFilter::Linear, AddressMode::Clamp, 16, ShaderVisibility::Pixel) } });
+static constexpr auto SpriteRootBlob = SerializeRootSignature(SpriteRootLayout);
+
+// The sample's Vertex, which MeshVertex mirrors.
+static constexpr auto SceneInputLayout = MakeInputLayout(sizeof(MeshVertex), std::array<InputElementLayout, 2>{ {
+    { "POSITION", 0, LayoutFormat::R32G32B32Float, 0, offsetof(MeshVertex, Position) },
+    { "TEXCOORD", 0, LayoutFormat::R32G32Float, 0, offsetof(MeshVertex, Uv) } } });
+static constexpr auto SpriteInputLayout = MakeInputLayout(sizeof(SpriteVertex), std::array<InputElementLayout, 3>{ {
+    { "POSITION", 0, LayoutFormat::R32G32Float, 0, offsetof(SpriteVertex, X) },
+    { "TEXCOORD", 0, LayoutFormat::R16G16Unorm, 0, offsetof(SpriteVertex, Uv) },
+    { "COLOR", 0, LayoutFormat::R8G8B8A8Unorm, 0, offsetof(SpriteVertex, Color) } } });
+static constexpr auto NoInputLayout = MakeInputLayout(0, std::array<InputElementLayout, 0>{});
+static constexpr auto SceneInputElements = ToD3D12InputElements(SceneInputLayout);
+static constexpr auto SpriteInputElements = ToD3D12InputElements(SpriteInputLayout);
+static constexpr auto NoInputElements = ToD3D12InputElements(NoInputLayout);
+
+static constexpr PipelineStateLayout OpaqueState = { CullMode::Back, BlendMode::Opaque, LayoutFormat::R8G8B8A8Unorm };
+// Sprites may be mirrored: no culling.
+static constexpr PipelineStateLayout SpriteState = { CullMode::None, BlendMode::AlphaBlend, LayoutFormat::R8G8B8A8Unorm };
+
+static constexpr UINT64 ScenePipelineHash = CombineLayoutHashes(SceneRootLayout.Hash, SceneInputLayout.Hash, HashPipelineState(OpaqueState));
+static constexpr UINT64 UpscalePipelineHash = CombineLayoutHashes(UpscaleRootLayout.Hash, NoInputLayout.Hash, HashPipelineState(OpaqueState));
+static constexpr UINT64 SpritePipelineHash = CombineLayoutHashes(SpriteRootLayout.Hash, SpriteInputLayout.Hash, HashPipelineState(SpriteState));
+
+// LOD chain of an imported mesh: up to 5 levels, each with about half the triangles of the
+// previous one, and no collapse moving the surface by more than a tenth of the mesh's size.
+static const uint32_t MeshLodLevels = 5;
+static const float MeshLodReduction = 0.5f;
+static const float MeshLodMaxError = 0.1f;
+
+// Rounds value up to a multiple of alignment, a power of two.
+static UINT64 AlignUp(UINT64 value, UINT64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
 
-// static_cast:  Ÿӿ ȯ  Ÿ  ش.
+// static_cast: 컴파일 타임에 형변환에 대한 타입 오류를 잡아준다.
 D3D12HelloTexture::D3D12HelloTexture(UINT width, UINT height, std::wstring name) :
     DXSample(width, height, name),
-    m_frameIndex(0),
     m_viewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)),
     m_scissorRect(0, 0, static_cast<LONG>(width), static_cast<LONG>(height)),
-    m_fenceValue{},
-    m_rtvDescriptorSize(0)
+    m_rtvDescriptorSize(0),
+    m_srvDescriptorSize(0),
+    m_uma(false),
+    m_cacheCoherentUma(false),
+    m_standardSwizzle64KB(false),
+    m_standardSwizzleChecked(false),
+    m_sceneTargetWidth(0),
+    m_sceneTargetHeight(0),
+    m_outputWidth(width),
+    m_outputHeight(height),
+    m_renderScale(1.0f),
+    m_frameScale{},
+    m_indexBufferView(),
+    m_meshIndexCount(0),
+    m_animatedSquare(),
+    m_animationTime(0.0f),
+    m_pTextureUpdateData(nullptr),
+    m_textureUpdateCapacity(0),
+    m_spriteIndexBufferView(),
+    m_pSpriteVertices(nullptr),
+    m_pObjectConstants(nullptr),
+    m_frameCount(2),
+    m_frameIndex(0),
+    m_frameFenceValue{},
+    m_textureHandle(InvalidResource),
+    m_vertexBufferHandle(InvalidResource),
+    m_replayFinished(false),
+    m_timestampFrequency(0),
+    m_timestampFrame{},
+    m_frameNumber(0),
+    m_eyePosition(0.0f, 0.0f, -2.0f),
+    m_fieldOfView(XM_PIDIV4),
+    m_frameTimeMetric(m_metrics.GetHistogram("frame_time_ns")),
+    m_fenceWaitMetric(m_metrics.GetHistogram("fence_wait_ns")),
+    m_presentMetric(m_metrics.GetHistogram("present_ns")),
+    m_spriteBatchMetric(m_metrics.GetHistogram("sprite_batch_ns")),
+    m_uploadBytesMetric(m_metrics.GetCounter("upload_bytes")),
+    m_psoCacheHitMetric(m_metrics.GetCounter("pso_cache_hits")),
+    m_psoCacheMissMetric(m_metrics.GetCounter("pso_cache_misses")),
+    m_resourceCacheHitMetric(m_metrics.GetCounter("resource_cache_hits")),
+    m_resourceCacheMissMetric(m_metrics.GetCounter("resource_cache_misses")),
+    m_textureUpdateBytesMetric(m_metrics.GetCounter("texture_update_bytes")),
+    m_textureUpdateSavedMetric(m_metrics.GetCounter("texture_update_saved_bytes")),
+    m_rtvDescriptorsMetric(m_metrics.GetGauge("rtv_descriptors")),
+    m_srvDescriptorsMetric(m_metrics.GetGauge("cbv_srv_uav_descriptors")),
+    m_gpuMemoryUsageMetric(m_metrics.GetGauge("gpu_local_memory_usage")),
+    m_gpuMemoryBudgetMetric(m_metrics.GetGauge("gpu_local_memory_budget")),
+    m_renderScaleMetric(m_metrics.GetGauge("render_scale_percent")),
+    m_textureChangedMetric(m_metrics.GetGauge("texture_changed_percent")),
+    m_timeToFirstFrameMetric(m_metrics.GetGauge("time_to_first_frame_us")),
+    m_scenePipeline(InvalidPipeline),
+    m_upscalePipeline(InvalidPipeline),
+    m_spritePipeline(InvalidPipeline),
+    m_occlusion(320, 192, &m_threadPool),
+    m_triangleObject(0)
 {
+    // 메모리 추적기의 카테고리마다 현재 사용량과 최대 사용량 지표를 만든다.
+    for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); ++i)
+    {
+        const std::string category = GetMemoryCategoryName(static_cast<MemoryCategory>(i));
+        m_memoryLiveMetric[i] = m_metrics.GetGauge("memory_" + category + "_live_bytes");
+        m_memoryPeakMetric[i] = m_metrics.GetGauge("memory_" + category + "_peak_bytes");
+    }
 }
 
 
 void D3D12HelloTexture::OnInit()
 {
-    LoadPipeline();
-    LoadAssets();
+    m_startupTime = std::chrono::steady_clock::now();
+
+    // The command line may have changed the resolution and the number of frames in flight.
+    // 명령 줄 인자로 해상도와 버퍼링할 프레임 수가 바뀌었을 수 있다.
+    m_frameCount = m_framesInFlight;
+    m_viewport = CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float>(m_width), static_cast<float>(m_height));
+    m_scissorRect = CD3DX12_RECT(0, 0, static_cast<LONG>(m_width), static_cast<LONG>(m_height));
+    m_outputWidth = m_width;
+    m_outputHeight = m_height;
+
+    DynamicResolutionSettings resolutionSettings;
+    resolutionSettings.TargetMilliseconds = m_gpuBudgetMilliseconds;
+    m_resolution = DynamicResolutionController(resolutionSettings);
+
+    // Objects are defined in the capture as they are created, so it is opened first.
+    // 캡처에는 객체가 만들어질 때 정의가 기록되므로 먼저 연다.
+    if (!m_captureOutput.empty())
+    {
+        m_capture.Open(m_captureOutput);
+    }
+
+    // Startup runs as a task graph: the shaders compile, the checkerboard is generated and the mesh
+    // scanned on the pool while the device and the swap chain are created. Every object registered
+    // with the capture is created by the chain device -> swap chain -> root signatures ->
+    // pipelines -> assets, so that their ids are the same in every run.
+    // 시작 작업을 그래프로 실행한다. 셰이더 컴파일, 체커보드 생성, 메시 스캔은 장치와 스왑체인을
+    // 만드는 동안 스레드 풀에서 진행한다. 캡처에 등록하는 객체는 한 줄로 이어진 작업들이 만들어서
+    // 실행마다 같은 id 를 받는다.
+    {
+        ComPtr<IDXGIFactory4> factory;
+        ComPtr<ID3DBlob> shaders[ShaderCount];
+        std::vector<UINT8> checkerboard(TextureWidth * TextureHeight * TexturePixelSize);
+        std::unique_ptr<MeshImporter> mesh;
+        std::unique_ptr<Ktx2Texture> textureFile;
+
+        TaskGraph startup(&m_threadPool);
+        const TaskId device = startup.Add("device", [&]() { CreateDevice(factory); });
+        const TaskId swapChain = startup.Add("swap_chain", [&]() { LoadPipeline(factory.Get()); }, { device }, TaskAffinity::Caller);
+
+        static const char* const ShaderNames[ShaderCount] =
+        {
+            "compile_scene_vs", "compile_scene_ps", "compile_upscale_vs", "compile_upscale_ps", "compile_sprite_vs", "compile_sprite_ps"
+        };
+        TaskId compiles[ShaderCount];
+        for (int i = 0; i < ShaderCount; ++i)
+        {
+            const ShaderIndex shader = static_cast<ShaderIndex>(i);
+            compiles[i] = startup.Add(ShaderNames[i], [this, shader, &shaders]() { CompileShader(shader, shaders[shader]); });
+        }
+
+        const TaskId textureData = startup.Add("texture_data", [&]() { GenerateTextureData(checkerboard.data()); });
+        TaskId meshScan = textureData;
+        if (!m_meshPath.empty())
+        {
+            meshScan = startup.Add("mesh_scan", [&]()
+            {
+                mesh.reset(new MeshImporter(&m_threadPool));
+                mesh->Open(m_meshPath.c_str());
+            });
+            // Simplifying runs alongside the device and pipeline creation.
+            // 메시 단순화는 장치, 파이프라인 생성과 동시에 진행한다.
+            meshScan = startup.Add("mesh_lods", [&]() { BuildMeshLods(*mesh); }, { meshScan });
+        }
+        // Maps the KTX2 file and inflates its supercompressed levels; block compression happens in
+        // LoadAssets, straight into the upload heap.
+        // KTX2 파일을 매핑하고 초압축된 레벨을 푼다. BC 압축은 LoadAssets 에서 업로드 힙에 바로 한다.
+        TaskId textureFileOpen = textureData;
+        if (!m_texturePath.empty())
+        {
+            textureFileOpen = startup.Add("texture_file", [&]()
+            {
+                textureFile.reset(new Ktx2Texture());
+                textureFile->Open(m_texturePath.c_str(), &m_threadPool);
+            });
+        }
+
+        const TaskId rootSignatures = startup.Add("root_signatures", [&]() { CreateRootSignatures(); }, { swapChain });
+        const TaskId pipelines = startup.Add("pipelines", [&]() { RequestPipelines(shaders); },
+            { rootSignatures, compiles[SceneVertexShader], compiles[ScenePixelShader], compiles[UpscaleVertexShader],
+              compiles[UpscalePixelShader], compiles[SpriteVertexShader], compiles[SpritePixelShader] });
+        // On the window's thread too: when capturing, LoadAssets waits for the pipeline states, which
+        // compile on the pool, so it must not hold one of its workers.
+        startup.Add("assets", [&]() { LoadAssets(checkerboard.data(), mesh.get(), textureFile.get()); },
+            { pipelines, textureData, meshScan, textureFileOpen }, TaskAffinity::Caller);
+
+        startup.Run();
+        ReportStartup(startup);
+    }
+
+    m_frameArenas.reset(new FrameArenaRing(*m_directTimeline, m_frameCount));
+
+    if (!m_replayInput.empty())
+    {
+        std::ifstream file(m_replayInput, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("Can't open the command capture to replay.");
+        }
+        m_replayData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_replayReader.reset(new CommandStreamReader(m_replayData.data(), m_replayData.size()));
+        m_replayBackend.reset(new D3D12ReplayBackend(m_capture, m_commandQueue.Get(), m_swapChain.Get()));
+    }
+
+    if (m_benchmarkMode)
+    {
+        m_frameStatistics.Reserve(m_benchmarkFrames);
+        m_frameStatistics.SetContext("width", std::to_string(m_width));
+        m_frameStatistics.SetContext("height", std::to_string(m_height));
+        m_frameStatistics.SetContext("frames_in_flight", std::to_string(m_frameCount));
+        m_frameStatistics.SetContext("scene_scale", std::to_string(m_sceneScale));
+        m_frameStatistics.SetContext("warmup_frames", std::to_string(m_warmupFrames));
+        m_frameStatistics.SetContext("timestep", std::to_string(m_fixedTimestep));
+        m_frameStatistics.SetContext("warp", m_useWarpDevice ? "1" : "0");
+        m_frameStatistics.SetContext("dynamic_resolution", m_dynamicResolution ? "1" : "0");
+    }
+
+    // 지표 스냅샷을 내보낼 곳이 지정되었으면 연다.
+    if (!m_metricsOutput.empty())
+    {
+        m_metricsExporter.OpenFile(m_metricsOutput);
+    }
+    if (m_metricsPort != 0)
+    {
+        m_metricsExporter.OpenUdp(static_cast<uint16_t>(m_metricsPort));
+    }
+
+    m_lastUpdateTime = std::chrono::steady_clock::now();
+    m_lastFrameTime = m_lastUpdateTime;
+    m_lastMetricsSnapshot = m_lastUpdateTime;
+}
+
+// Publishes how long each startup task took, as gauges and in the benchmark report, and writes the
+// startup timeline and its critical path to the debugger output.
+// 시작 작업마다 걸린 시간을 지표와 벤치마크 결과에 남기고, 타임라인과 임계 경로를 디버거로 출력한다.
+void D3D12HelloTexture::ReportStartup(const TaskGraph& startup)
+{
+    const std::vector<TaskTiming>& timings = startup.GetTimings();
+    std::ostringstream report;
+    report << "Startup: " << startup.GetTotalNanoseconds() / 1000 << " us\n";
+    for (const TaskTiming& timing : timings)
+    {
+        const uint64_t microseconds = (timing.EndNanoseconds - timing.StartNanoseconds) / 1000;
+        m_metrics.GetGauge(std::string("startup_") + timing.Name + "_us")->Set(static_cast<int64_t>(microseconds));
+        report << "  " << timing.Name << ": " << timing.StartNanoseconds / 1000 << " - " << timing.EndNanoseconds / 1000
+               << " us" << (timing.OnCaller ? " (window thread)" : "") << "\n";
+    }
+
+    std::string criticalPath;
+    for (const TaskId id : startup.GetCriticalPath())
+    {
+        criticalPath += criticalPath.empty() ? "" : " > ";
+        criticalPath += timings[id].Name;
+    }
+    report << "  critical path: " << criticalPath << "\n";
+    OutputDebugStringA(report.str().c_str());
+
+    if (m_benchmarkMode)
+    {
+        m_frameStatistics.SetContext("startup_ms", std::to_string(startup.GetTotalNanoseconds() / 1e6));
+        m_frameStatistics.SetContext("startup_critical_path", criticalPath);
+    }
 }
 
 
-// Load the rendering pipeline dependencies.
-void D3D12HelloTexture::LoadPipeline()
+// Creates the device and its direct queue. Nothing here is registered with the capture, so it
+// can run alongside the other startup tasks.
+// 장치와 direct 큐를 만든다. 캡처에 등록하는 객체가 없으므로 다른 시작 작업과 동시에 실행할 수 있다.
+void D3D12HelloTexture::CreateDevice(ComPtr<IDXGIFactory4>& factory)
 {
     UINT dxgiFactoryFlags = 0;
 
 #if defined(_DEBUG)
     // Enable the debug layer (requires the Graphics Tools "optional feature").
     // NOTE: Enabling the debug layer after device creation will invalidate the active device.
-    //  ̾ ȰȭѴ.
-    // ġ    ̾ Ȱȭϸ Ȱ ġ ȿȭȴ.
+    // 디버그 레이어를 활성화한다.
+    // 장치 생성 후 디버그 레이어를 활성화하면 활성 장치가 무효화된다.
     {
         ComPtr<ID3D12Debug> debugController;
         if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController))))
@@ -38,13 +330,12 @@ void D3D12HelloTexture::LoadPipeline()
             debugController->EnableDebugLayer();
 
             // Enable additional debug layers.
-            // ߰  ̾ Ѵ.
+            // 추가 디버그 레이어를 사용한다.
             dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
         }
     }
 #endif
 
-    ComPtr<IDXGIFactory4> factory;
     ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&factory)));
 
     if (m_useWarpDevice)
@@ -57,31 +348,67 @@ void D3D12HelloTexture::LoadPipeline()
             D3D_FEATURE_LEVEL_11_0,
             IID_PPV_ARGS(&m_device)
         ));
+
+        // IDXGIAdapter3 (video memory queries) is optional; m_adapter stays null without it.
+        warpAdapter.As(&m_adapter);
     }
     else
     {
+        // The device created to probe the adapter is the one kept: no second creation.
+        // 어댑터를 확인하려고 만든 장치를 그대로 쓴다.
         ComPtr<IDXGIAdapter1> hardwareAdapter;
-        GetHardwareAdapter(factory.Get(), &hardwareAdapter);
+        GetHardwareAdapter(factory.Get(), &hardwareAdapter, false, &m_device);
+        if (!m_device)
+        {
+            ThrowIfFailed(D3D12CreateDevice(
+                hardwareAdapter.Get(),
+                D3D_FEATURE_LEVEL_11_0,
+                IID_PPV_ARGS(&m_device)
+            ));
+        }
 
-        ThrowIfFailed(D3D12CreateDevice(
-            hardwareAdapter.Get(),
-            D3D_FEATURE_LEVEL_11_0,
-            IID_PPV_ARGS(&m_device)
-        ));
+        hardwareAdapter.As(&m_adapter);
+    }
+
+    // Integrated adapters share memory with the CPU, which can then write textures in place.
+    // 통합 GPU 처럼 CPU 와 메모리를 공유하는 어댑터인지 확인한다. 그렇다면 텍스쳐를 CPU 가 바로 쓴다.
+    {
+        D3D12_FEATURE_DATA_ARCHITECTURE architecture = {};
+        if (SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_ARCHITECTURE, &architecture, sizeof(architecture))))
+        {
+            m_uma = architecture.UMA != FALSE;
+            m_cacheCoherentUma = architecture.CacheCoherentUMA != FALSE;
+        }
+
+        D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+        if (SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))))
+        {
+            m_standardSwizzle64KB = options.StandardSwizzle64KBSupported != FALSE;
+        }
     }
 
     // Describe and create the command queue.
-    // command queue desc  ۼѴ.
+    // command queue desc 를 작성한다.
     D3D12_COMMAND_QUEUE_DESC queueDesc = {};
     queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
     queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
 
     ThrowIfFailed(m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_commandQueue)));
 
+    // DX12 에선 fence 를 이용해 동기화를 진행한다.
+    // GPU 가 설정한 지점까지 명령을 처리하면 CPU 가 그것을 알 수 있게 해준다.
+    m_directTimeline.reset(new D3D12TimelineFence(m_device.Get(), m_commandQueue.Get()));
+}
+
+// Load the rendering pipeline dependencies: the swap chain and what the frames render with.
+// Runs on the window's thread, as DXGI expects of a swap chain for a window.
+// 스왑체인과 프레임 리소스를 만든다. 창의 스레드에서 실행한다.
+void D3D12HelloTexture::LoadPipeline(IDXGIFactory4* factory)
+{
     // Describe and create the swap chain.
-    // swap chain  desc ϰ Ѵ.
+    // swap chain 을 desc 하고 생성한다.
     DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
-    swapChainDesc.BufferCount = FrameCount;
+    swapChainDesc.BufferCount = m_frameCount;
     swapChainDesc.Width = m_width;
     swapChainDesc.Height = m_height;
     swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -100,7 +427,7 @@ void D3D12HelloTexture::LoadPipeline()
     ));
 
     // This sample does not support fullscreen transitions.
-    // alt + enter    üȭ ȯ ʴ´.
+    // alt + enter 를 눌렀을 때 전체화면으로 전환되지 않는다.
     ThrowIfFailed(factory->MakeWindowAssociation(Win32Application::GetHwnd(), DXGI_MWA_NO_ALT_ENTER));
 
     ThrowIfFailed(swapChain.As(&m_swapChain));
@@ -108,349 +435,606 @@ void D3D12HelloTexture::LoadPipeline()
 
 
     // Create descriptor heaps.
-    //  Ÿٰ ̴ ҽ Descriptor heaps  ۼѴ
-    // DX12  descriptor()  DX11  View  Ǿ̴.
+    // 렌더 타겟과 셰이더 리소스의 Descriptor heaps 을 작성한다
+    // DX12 에서 descriptor(서술자) 는 DX11 의 View 와 동의어이다.
     {
         // Describe and create a render target view (RTV) descriptor heap.
         D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-        rtvHeapDesc.NumDescriptors = FrameCount;
+        // One RTV per back buffer, then the scene target's.
+        rtvHeapDesc.NumDescriptors = m_frameCount + 1;
         rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
         rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
         ThrowIfFailed(m_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_rtvHeap)));
+        RegisterDescriptorHeap(m_rtvHeap.Get(), MemoryTag(MemoryCategory::Descriptors, "rtv heap"));
 
         // Describe and create a shader resource view (SRV) heap for the texture.
-        // ̴ ҽ 並  DESCRIPTOR HEAP  Ѵ.
+        // 셰이더 리소스 뷰를 위한 DESCRIPTOR HEAP 을 생성한다.
         D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-        srvHeapDesc.NumDescriptors = 1;
-        // DESCRIPTOR Type  Ѵ.
+        // 0: the texture, 1: the scene target read by the upscale pass, then the atlas pages.
+        srvHeapDesc.NumDescriptors = 2 + (m_atlasTextureCount > 0 ? MaxAtlasPages : 0);
+        // DESCRIPTOR Type 을 정한다.
         srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
         srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
         ThrowIfFailed(m_device->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&m_srvHeap)));
+        RegisterDescriptorHeap(m_srvHeap.Get(), MemoryTag(MemoryCategory::Descriptors, "srv heap"));
+
+        // The cache keeps the views of its textures in a heap of its own; they are copied into
+        // m_srvHeap.
+        // 캐시는 텍스쳐 뷰를 자체 힙에 두고, 쓸 때 m_srvHeap 으로 복사한다.
+        m_resourceCache.reset(new D3D12ResourceCache(m_device.Get(), m_releaseQueue));
+        RegisterDescriptorHeap(m_resourceCache->GetSrvHeap(), MemoryTag(MemoryCategory::Descriptors, "resource cache srv heap"));
         
-        // RTV Descriptor   صд.
+        // RTV Descriptor 의 증가값을 저장해둔다.
         m_rtvDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+        m_srvDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+        m_rtvDescriptorsMetric->Set(rtvHeapDesc.NumDescriptors);
+        m_srvDescriptorsMetric->Set(srvHeapDesc.NumDescriptors);
     }
 
 
 
     // Create frame resources.
-     //  ҽ .
+     // 프레임 리소스를 만든다.
     {
-        // GetCPUDescriptorHandleForHeapStart Լ  ù ũ ڵ  
-        CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
+        CreateBackBufferViews();
 
-        // Create a RTV for each frame.
-        //  ӿ  RTV  .
-        for (UINT n = 0; n < FrameCount; n++)
-        {
-            //  Ÿ ϰ
-            ThrowIfFailed(m_swapChain->GetBuffer(n, IID_PPV_ARGS(&m_renderTargets[n])));
-            m_device->CreateRenderTargetView(m_renderTargets[n].Get(), nullptr, rtvHandle);
-            // m_rtvDescriptorSize ŭ ̵Ѵ.
-            rtvHandle.Offset(1, m_rtvDescriptorSize);
-        }
+        // The scene target, sized for the largest render scale. It stays in the render target
+        // state except while the upscale pass reads it.
+        // 최대 배율 크기의 씬 렌더 타겟과 그 RTV, SRV 를 만든다.
+        const float maxScale = m_resolution.GetSettings().MaxScale;
+        DynamicResolutionController::GetRenderSize(maxScale, m_width, m_height, m_sceneTargetWidth, m_sceneTargetHeight);
+
+        const CD3DX12_RESOURCE_DESC sceneTargetDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+            DXGI_FORMAT_R8G8B8A8_UNORM, m_sceneTargetWidth, m_sceneTargetHeight, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+        const CD3DX12_CLEAR_VALUE clearValue(DXGI_FORMAT_R8G8B8A8_UNORM, SceneClearColor);
+        ThrowIfFailed(m_device->CreateCommittedResource(
+            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+            D3D12_HEAP_FLAG_NONE,
+            &sceneTargetDesc,
+            D3D12_RESOURCE_STATE_RENDER_TARGET,
+            &clearValue,
+            IID_PPV_ARGS(&m_sceneTarget)));
+        RegisterResource(m_sceneTarget.Get(), MemoryTag(MemoryCategory::Textures, "scene target"));
+
+        // Its RTV follows the back buffers' in the heap.
+        // 씬 타겟의 RTV 는 백 버퍼 RTV 들 다음 자리에 만든다.
+        m_device->CreateRenderTargetView(m_sceneTarget.Get(), nullptr,
+            CD3DX12_CPU_DESCRIPTOR_HANDLE(m_rtvHeap->GetCPUDescriptorHandleForHeapStart(), m_frameCount, m_rtvDescriptorSize));
+        m_device->CreateShaderResourceView(m_sceneTarget.Get(), nullptr, CD3DX12_CPU_DESCRIPTOR_HANDLE(m_srvHeap->GetCPUDescriptorHandleForHeapStart(), 1, m_srvDescriptorSize));
     }
 
-    // CommandAllocator  Ѵ.
-    for (UINT n = 0; n < 2; n++)
+    // CommandAllocator 들을 생성한다.
+    for (UINT n = 0; n < m_frameCount; n++)
     {
         ThrowIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_commandAllocator[n])));
+        m_capture.AddObject(m_commandAllocator[n].Get(), CommandObjectType::CommandAllocator, "frame allocator");
+    }
+
+    // Create the timestamp queries used to time each frame on the GPU.
+    // 프레임의 GPU 시간을 재기 위한 타임스탬프 쿼리 힙과 리드백 버퍼를 만든다.
+    {
+        D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+        queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+        queryHeapDesc.Count = MaxFrameCount * 2;
+        ThrowIfFailed(m_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&m_timestampHeap)));
+        m_capture.AddObject(m_timestampHeap.Get(), CommandObjectType::QueryHeap, "timestamp heap");
+
+        ThrowIfFailed(m_device->CreateCommittedResource(
+            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK),
+            D3D12_HEAP_FLAG_NONE,
+            &CD3DX12_RESOURCE_DESC::Buffer(MaxFrameCount * 2 * sizeof(UINT64)),
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&m_timestampReadback)));
+        RegisterResource(m_timestampReadback.Get(), MemoryTag(MemoryCategory::Buffers, "timestamp readback"));
+
+        ThrowIfFailed(m_commandQueue->GetTimestampFrequency(&m_timestampFrequency));
     }
 }
 
 
-// Load the sample assets.
-void D3D12HelloTexture::LoadAssets()
+// Gets the swap chain's buffers and creates an RTV for each, at the start of m_rtvHeap.
+// 스왑체인의 버퍼를 가져와 각각의 RTV 를 만든다.
+void D3D12HelloTexture::CreateBackBufferViews()
+{
+    // GetCPUDescriptorHandleForHeapStart 함수로 힙의 첫 디스크립터 핸들을 가져온 후
+    CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
+
+    // Create a RTV for each frame.
+    // 각 프레임에 대해 RTV 를 만든다.
+    for (UINT n = 0; n < m_frameCount; n++)
+    {
+        // 렌더 타겟을 생성하고
+        ThrowIfFailed(m_swapChain->GetBuffer(n, IID_PPV_ARGS(&m_renderTargets[n])));
+        // The swap chain owns its buffers and outlives OnDestroy.
+        RegisterResource(m_renderTargets[n].Get(), MemoryTag(MemoryCategory::Textures, "back buffer", true));
+        m_device->CreateRenderTargetView(m_renderTargets[n].Get(), nullptr, rtvHandle);
+        // m_rtvDescriptorSize 만큼 이동한다.
+        rtvHandle.Offset(1, m_rtvDescriptorSize);
+    }
+}
+
+// Creates the root signatures. They are registered with the capture, so they are created after
+// the objects of LoadPipeline and before those of LoadAssets, in every run.
+// 루트 시그니처는 캡처에 등록되므로 LoadPipeline 과 LoadAssets 사이에 만든다.
+void D3D12HelloTexture::CreateRootSignatures()
 {
     // Create the root signature.
-    // root signature  ׸ ȣ   ο ̴ ڿ ϰ, 
-    //  ڿ ̴ Է Ϳ  Ǵ Ѵ.
-    {
-        // ROOT_SIGNATURE   Ȯ  ϴ ü
-        D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
-
-        // This is the highest version the sample supports. If CheckFeatureSupport succeeds, the HighestVersion returned will not be greater than this.
-        featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
-
-        // ׷ī尡 Ʈ ñ״ó 1_1    1_0  
-        if (FAILED(m_device->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
-        {
-            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
-        }
-
-        // descriptor table Ʈ Ķ͸ Ϸ 
-        // CD3DX12_ROOT_PARAMETER   ä descriptor table     ü  ؾ Ѵ.
-        CD3DX12_DESCRIPTOR_RANGE1 ranges[1];
-        ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC);
-
-        // CD3DX12_DESCRIPTOR_RANGE 迭 迭 (range)   ϰ Descriptor Table  Init ش.
-        CD3DX12_ROOT_PARAMETER1 rootParameters[1];
-        rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_PIXEL);
-
-        // ÷ 
-        D3D12_STATIC_SAMPLER_DESC sampler = {};
-        // Ʈ ø 
-        sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
-        // 
-        sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-        // 
-        sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-        // 
-        sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-        sampler.MipLODBias = 0;
-        sampler.MaxAnisotropy = 0;
-        sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
-        sampler.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
-        sampler.MinLOD = 0.0f;
-        sampler.MaxLOD = D3D12_FLOAT32_MAX;
-        sampler.ShaderRegister = 0;
-        sampler.RegisterSpace = 0;
-        sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-        CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
-        rootSignatureDesc.Init_1_1(_countof(rootParameters), rootParameters, 1, &sampler, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
-
-        ComPtr<ID3DBlob> signature;
-        ComPtr<ID3DBlob> error;
-        
-        // Ʈ ñ״ó ϱ   ͵ ȭ
-        ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &signature, &error));
-        // Ʈ ñ״ó 
-        ThrowIfFailed(m_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&m_rootSignature)));
+    // root signature 는 그리기 호출 전에 렌더링 파이프라인에 묶이는 자원들을 정의하고, 
+    // 그 자원들이 셰이더의 입력 레지스터에 어떻게 대응되는지를 정의한다.
+    // 직렬화는 컴파일 타임에 끝났으므로 루트 시그니처마다 생성 호출 하나다.
+    m_rootSignature = CreatePrebakedRootSignature(m_device.Get(), SceneRootLayout, SceneRootBlob);
+    m_capture.AddObject(m_rootSignature.Get(), CommandObjectType::RootSignature, "root signature");
+
+    // 업스케일 패스의 루트 시그니처. 씬 타겟 SRV, 상수 4 개, 선형 샘플러를 쓴다.
+    m_upscaleRootSignature = CreatePrebakedRootSignature(m_device.Get(), UpscaleRootLayout, UpscaleRootBlob);
+    m_capture.AddObject(m_upscaleRootSignature.Get(), CommandObjectType::RootSignature, "upscale root signature");
+
+    // 스프라이트의 루트 시그니처. 텍스쳐 SRV, 픽셀을 클립 공간으로 바꾸는 상수 4 개, 선형 샘플러를 쓴다.
+    if (m_spriteCount > 0)
+    {
+        m_spriteRootSignature = CreatePrebakedRootSignature(m_device.Get(), SpriteRootLayout, SpriteRootBlob);
+        m_capture.AddObject(m_spriteRootSignature.Get(), CommandObjectType::RootSignature, "sprite root signature");
     }
+}
 
-    // Create the pipeline state, which includes compiling and loading shaders.
+// Compiles one entry point of Shaders.HLSL. Each is a startup task of its own.
+// 셰이더 진입점 하나를 컴파일한다. 진입점마다 별도의 시작 작업이다.
+void D3D12HelloTexture::CompileShader(ShaderIndex shader, ComPtr<ID3DBlob>& bytecode)
+{
+    static const struct
+    {
+        const char* EntryPoint;
+        const char* Target;
+    } Entries[ShaderCount] =
     {
-        ComPtr<ID3DBlob> vertexShader;
-        ComPtr<ID3DBlob> pixelShader;
+        { "VSMain", "vs_5_1" },
+        { "PSMain", "ps_5_1" },
+        { "VSUpscale", "vs_5_1" },
+        { "PSUpscale", "ps_5_1" },
+        { "VSSprite", "vs_5_1" },
+        { "PSSprite", "ps_5_1" },
+    };
 
 #if defined(_DEBUG)
-        // Enable better shader debugging with the graphics debugging tools.
-        //   /  /  / ȣ   ڵ忡 ϵ Ϸ Ѵ.
-        // ڵ  ߿ ȭ ܰ踦 ǳʶٵ Ϸ Ѵ.
-        UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+    // Enable better shader debugging with the graphics debugging tools.
+    // 디버그 파일 / 행 / 형식 / 기호 정보를 출력 코드에 삽입하도록 컴파일러에 지시한다.
+    // 코드 생성 중에 최적화 단계를 건너뛰도록 컴파일러에 지시한다.
+    UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
 #else
-        UINT compileFlags = 0;
+    UINT compileFlags = 0;
 #endif
-        ThrowIfFailed(D3DCompileFromFile(L"Shaders.HLSL", nullptr, nullptr, "VSMain", "vs_5_1", compileFlags, 0, &vertexShader, nullptr));
-        ThrowIfFailed(D3DCompileFromFile(L"Shaders.HLSL", nullptr, nullptr, "PSMain", "ps_5_1", compileFlags, 0, &pixelShader, nullptr));
+    ThrowIfFailed(D3DCompileFromFile(L"Shaders.HLSL", nullptr, nullptr, Entries[shader].EntryPoint, Entries[shader].Target, compileFlags, 0, &bytecode, nullptr));
+}
 
-        // Define the vertex input layout.
-        // Vertex ü   Ѵ.
-        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
-        {
-            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-            // UV ǥ̹Ƿ RG  
-            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-        };
+// Requests the pipeline states, from the shaders the startup tasks compiled.
+// 시작 작업들이 컴파일한 셰이더로 파이프라인 상태를 요청한다.
+void D3D12HelloTexture::RequestPipelines(const ComPtr<ID3DBlob>* shaders)
+{
+    // Create the pipeline state, which includes compiling and loading shaders.
+    // The pipeline states compile on worker threads while the rest of the setup runs; frames
+    // draw what they can until they are ready (see ResolvePipelines).
+    // 파이프라인 상태는 나머지 초기화가 진행되는 동안 워커 스레드에서 컴파일한다.
+    m_pipelineCompiler.reset(new D3D12PipelineCompiler(m_device.Get(), m_threadPool));
+    {
+        static_assert(sizeof(Vertex) == sizeof(MeshVertex), "SceneInputLayout describes Vertex.");
 
         // Describe and create the graphics pipeline state object (PSO).
-        // graphics pipeline state object  Ѵ.
+        // graphics pipeline state object 를 서술한다.
         D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
-        //  ؽ Desc
-        psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
-        //   Ʈ ñ״
+        // 컴파일 타임에 만든 버텍스 Desc
+        psoDesc.InputLayout = GetInputLayoutDesc(SceneInputElements);
+        // 위에서 생성한 루트 시그니쳐
         psoDesc.pRootSignature = m_rootSignature.Get();
-        //  ҷ ̴
-        psoDesc.VS = CD3DX12_SHADER_BYTECODE(vertexShader.Get());
-        psoDesc.PS = CD3DX12_SHADER_BYTECODE(pixelShader.Get());
-        psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
-        psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
-        psoDesc.DepthStencilState.DepthEnable = FALSE;
-        psoDesc.DepthStencilState.StencilEnable = FALSE;
-        // blend state   ũ
-        psoDesc.SampleMask = UINT_MAX;
-        // ⺻     , patch Ӽ ׼̼ǿ δٰ Ѵ.
-        psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-        // ÿ   Ÿ 
-        psoDesc.NumRenderTargets = 1;
-        //  Ÿ 
-        psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
-        psoDesc.SampleDesc.Count = 1;
-        ThrowIfFailed(m_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pipelineState)));
-    }
-
-
-    // Create the command list.
-    // command list 
-    ThrowIfFailed(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_commandAllocator[m_frameIndex].Get(), m_pipelineState.Get(), IID_PPV_ARGS(&m_commandList)));
-
-
-    // Create the vertex buffer.
-    // ؽ  
-    //  𿡼 UploadBuffer  ־,
-    // DefaultBuffer  ־, UpdateSubResources  εۿ Ϲݹ۷ ִ  õѴ.
-    //     ɰ 鿡 ٰ Ѵ.
+        // 위에서 불러온 셰이더
+        psoDesc.VS = CD3DX12_SHADER_BYTECODE(shaders[SceneVertexShader].Get());
+        psoDesc.PS = CD3DX12_SHADER_BYTECODE(shaders[ScenePixelShader].Get());
+        // 래스터라이저, 블렌드, 샘플 마스크, 위상 구조, 렌더 타겟 포맷
+        ApplyPipelineState(OpaqueState, psoDesc);
+        // Both pipelines are needed by the first frame. Their keys only hash the shaders at run
+        // time, the rest was hashed at compile time.
+        bool merged;
+        m_scenePipeline = m_pipelineCompiler->RequestWithLayoutHash(psoDesc, ScenePipelineHash, 0, &merged);
+        (merged ? m_psoCacheHitMetric : m_psoCacheMissMetric)->Add();
+
+        // Upscale pass pipeline: same render target format, no vertex input.
+        psoDesc.InputLayout = GetInputLayoutDesc(NoInputElements);
+        psoDesc.pRootSignature = m_upscaleRootSignature.Get();
+        psoDesc.VS = CD3DX12_SHADER_BYTECODE(shaders[UpscaleVertexShader].Get());
+        psoDesc.PS = CD3DX12_SHADER_BYTECODE(shaders[UpscalePixelShader].Get());
+        m_upscalePipeline = m_pipelineCompiler->RequestWithLayoutHash(psoDesc, UpscalePipelineHash, 0, &merged);
+        (merged ? m_psoCacheHitMetric : m_psoCacheMissMetric)->Add();
+
+        // Sprite pipeline: alpha blended over the scene.
+        if (m_spriteCount > 0)
+        {
+            psoDesc.InputLayout = GetInputLayoutDesc(SpriteInputElements);
+            psoDesc.pRootSignature = m_spriteRootSignature.Get();
+            psoDesc.VS = CD3DX12_SHADER_BYTECODE(shaders[SpriteVertexShader].Get());
+            psoDesc.PS = CD3DX12_SHADER_BYTECODE(shaders[SpritePixelShader].Get());
+            ApplyPipelineState(SpriteState, psoDesc);
+            m_spritePipeline = m_pipelineCompiler->RequestWithLayoutHash(psoDesc, SpritePipelineHash, 0, &merged);
+            (merged ? m_psoCacheHitMetric : m_psoCacheMissMetric)->Add();
+        }
+    }
+}
+
+// Load the sample assets. The checkerboard was generated, the mesh scanned and the texture file
+// opened by startup tasks.
+// 체커보드 생성, 메시 스캔, 텍스쳐 파일 열기는 시작 작업에서 이미 끝났다.
+void D3D12HelloTexture::LoadAssets(const UINT8* checkerboard, MeshImporter* mesh, const Ktx2Texture* textureFile)
+{
+    // Create the command list. The setup commands get an allocator of their own, released once
+    // they have executed, so the first frame can reset its allocator without waiting for them.
+    // command list 생성. 초기화 커맨드는 별도의 allocator 에 기록해 첫 프레임이 그 실행을 기다리지 않게 한다.
+    ComPtr<ID3D12CommandAllocator> setupAllocator;
+    ThrowIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&setupAllocator)));
+    // The setup commands are copies and barriers: no pipeline state needed.
+    ThrowIfFailed(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, setupAllocator.Get(), nullptr, IID_PPV_ARGS(&m_commandList)));
+    m_capture.AddObject(setupAllocator.Get(), CommandObjectType::CommandAllocator, "setup allocator");
+    m_capture.AddObject(m_commandList.Get(), CommandObjectType::CommandList, "command list");
+    CapturedCommandList commands(m_commandList.Get(), m_capture);
+    commands.CaptureOpen(setupAllocator.Get(), nullptr);
+
+
+    // Local bounds of what each object draws, and the scale that brings it to the triangle's size.
+    // 오브젝트가 그리는 도형의 로컬 경계와, 그것을 삼각형 크기로 맞추는 배율.
+    XMFLOAT3 localCenter(0.0f, 0.0f, 0.0f);
+    XMFLOAT3 localExtents(0.25f, 0.25f, 0.0f);
+    float localScale = 1.0f;
+
+    // The meshes' upload heaps are released with the texture's.
+    // 메시 업로드 힙은 텍스쳐 업로드 힙과 함께 해제한다.
+    ComPtr<ID3D12Resource> meshIndexUploadHeap;
+    ComPtr<ID3D12Resource> meshVertexUploadHeap;
+    if (mesh)
     {
+        CreateMesh(commands, *mesh, meshIndexUploadHeap, meshVertexUploadHeap, localCenter, localExtents);
+        const float largestExtent = max(localExtents.x, max(localExtents.y, localExtents.z));
+        localScale = largestExtent > 0.0f ? 0.25f / largestExtent : 1.0f;
+    }
+    else
+    {
+        // Create the vertex buffer.
+        // 버텍스 버퍼 생성
+        // 이 데모에서는 UploadBuffer만을 만들어 주었지만,
+        // DefaultBuffer를 같이 만들어주어서, UpdateSubResources를 통해 업로드버퍼에서 일반버퍼로 복사해주는 방식을 추천한다.
+        // 이 방법이 장기적으로 봤을때는 성능관리 측면에서 좋다고 한다.
         // Define the geometry for a triangle.
-        //  ġ, ÷
+        // 정점의 위치, 컬러값
         Vertex triangleVertices[] =
         {
-            { { 0.0f, 0.25f * m_aspectRatio, 0.0f }, { 0.5f, 0.0f } },
-            { { 0.25f, -0.25f * m_aspectRatio, 0.0f }, { 1.0f, 1.0f } },
-            { { -0.25f, -0.25f * m_aspectRatio, 0.0f }, { 0.0f, 1.0f } }
+            { { 0.0f, 0.25f, 0.0f }, { 0.5f, 0.0f } },
+            { { 0.25f, -0.25f, 0.0f }, { 1.0f, 1.0f } },
+            { { -0.25f, -0.25f, 0.0f }, { 0.0f, 1.0f } }
         };
 
         const UINT vertexBufferSize = sizeof(triangleVertices);
 
-        // Note: using upload heaps to transfer static data like vert buffers is not 
-        // recommended. Every time the GPU needs it, the upload heap will be marshalled 
-        // over. Please read up on Default Heap usage. An upload heap is used here for 
-        // code simplicity and because there are very few verts to actually transfer.
-        // ؽ ۿ   ͸ ϱ  ε  ϴ   ʴ´.
-        // GPU  ʿ   ε  ĵȴ. ⺻   о.
-        // ⼭ ε  ڵ ܼȭ , ׸    ִ Ʈ(verts)     Ǵ ̴
-        ThrowIfFailed(m_device->CreateCommittedResource(
-            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-            D3D12_HEAP_FLAG_NONE,
-            &CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(&m_vertexBuffer)));
-
-        // Copy the triangle data to the vertex buffer.
-        // ﰢ ͸  ۿ Ѵ.
-        UINT8* pVertexDataBegin;
-        CD3DX12_RANGE readRange(0, 0);      // We do not intend to read from this resource on the CPU.
-        // ڷḦ ϱ  map ȣ
-        ThrowIfFailed(m_vertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin)));
-        memcpy(pVertexDataBegin, triangleVertices, sizeof(triangleVertices));
-        // ڷḦ   Ŀ unmap ȣ
-        m_vertexBuffer->Unmap(0, nullptr);
+        // 같은 정점 데이터로 만든 버퍼가 캐시에 있으면 그것을 쓴다.
+        const ResourceKey vertexBufferKey = MakeBufferKey(triangleVertices, vertexBufferSize);
+        m_vertexBufferHandle = m_resourceCache->Acquire(vertexBufferKey);
+        if (m_vertexBufferHandle != InvalidResource)
+        {
+            m_vertexBuffer = m_resourceCache->GetResource(m_vertexBufferHandle);
+            m_resourceCacheHitMetric->Add();
+        }
+        else
+        {
+            // Note: using upload heaps to transfer static data like vert buffers is not 
+            // recommended. Every time the GPU needs it, the upload heap will be marshalled 
+            // over. Please read up on Default Heap usage. An upload heap is used here for 
+            // code simplicity and because there are very few verts to actually transfer.
+            // 버텍스 버퍼와 같은 정점 데이터를 전송하기 위해 업로드 힙을 사용하는 것은 권장되지 않는다.
+            // GPU 에서 필요로 할 때마다 업로드 힙이 정렬된다. 기본 힙 사용법을 읽어보라.
+            // 여기서 업로드 힙은 코드 단순화를 목적으로, 그리고 실제로 전송할 수 있는 버트(verts) 가 거의 없기 때문에 사용되는 것이다
+            ThrowIfFailed(m_device->CreateCommittedResource(
+                &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+                D3D12_HEAP_FLAG_NONE,
+                &CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&m_vertexBuffer)));
+            RegisterResource(m_vertexBuffer.Get(), MemoryTag(MemoryCategory::Buffers, "vertex buffer"));
+
+            // Copy the triangle data to the vertex buffer.
+            // 삼각형의 데이터를 정점 버퍼에 복사한다.
+            UINT8* pVertexDataBegin;
+            CD3DX12_RANGE readRange(0, 0);      // We do not intend to read from this resource on the CPU.
+            // 자료를 복사하기 전 map 호출
+            ThrowIfFailed(m_vertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin)));
+            memcpy(pVertexDataBegin, triangleVertices, sizeof(triangleVertices));
+            m_capture.CaptureBufferWrite(m_vertexBuffer.Get(), 0, triangleVertices, sizeof(triangleVertices));
+            m_uploadBytesMetric->Add(sizeof(triangleVertices));
+            // 자료를 모두 복사한 후에 unmap 호출
+            m_vertexBuffer->Unmap(0, nullptr);
+
+            m_vertexBufferHandle = m_resourceCache->InsertBuffer(vertexBufferKey, m_vertexBuffer.Get());
+            m_resourceCacheMissMetric->Add();
+        }
 
         // Initialize the vertex buffer view.
-        //   並 ʱȭ
-        //    descriptor  ʿ  ʴ´.
+        // 정점 버퍼 뷰를 초기화
+        // 정점 버퍼 뷰는 descriptor 를 필요로 하지 않는다.
         m_vertexBufferView.BufferLocation = m_vertexBuffer->GetGPUVirtualAddress();
         m_vertexBufferView.StrideInBytes = sizeof(Vertex);
         m_vertexBufferView.SizeInBytes = vertexBufferSize;
     }
 
+    // Create the scene objects and their constant buffer.
+    // 씬 오브젝트들과 오브젝트 상수 버퍼를 생성한다.
+    {
+        // A scene scale above 1 (-scenescale) replaces the single triangle with a grid of
+        // triangles that fills the view, so benchmarks can scale the per-object CPU work.
+        // scene scale 이 1 보다 크면 화면을 채우는 격자 모양으로 삼각형들을 배치한다.
+        const UINT objectCount = m_sceneScale;
+        const UINT columns = static_cast<UINT>(std::ceil(std::sqrt(static_cast<float>(objectCount))));
+        const float cellSize = 1.6f / columns;
+        const float objectScale = (objectCount > 1 ? cellSize / 0.6f : 1.0f) * localScale;
+        m_transforms.Reserve(objectCount);
+
+        for (UINT i = 0; i < objectCount; ++i)
+        {
+            const float x = objectCount > 1 ? -0.8f + (i % columns + 0.5f) * cellSize : 0.0f;
+            const float y = objectCount > 1 ? 0.8f - (i / columns + 0.5f) * cellSize : 0.0f;
+            const UINT object = m_transforms.AddObject(TransformSystem::NoParent, XMFLOAT3(x, y, 0.0f), XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f), objectScale);
+            m_transforms.SetSpin(object, XMFLOAT3(0.0f, 0.0f, 1.0f), XM_PIDIV4);
+            m_transforms.SetLocalBounds(object, localCenter, localExtents);
+        }
 
-    // Note: ComPtr's are CPU objects but this resource needs to stay in scope until
-    // the command list that references it has finished executing on the GPU.
-    // We will flush the GPU at the end of this method to ensure the resource is not
-    // prematurely destroyed.
-    // ComPtr  CPU ü  ҽ ̸ ϴ Ŀǵ Ʈ GPU   ĥ  ־ Ѵ.
-    //  ڿ ⿡ ı ʵ    GPU  ÷Ѵ.
-    // ؽĸ εϴ ۷ δ
-    ComPtr<ID3D12Resource> textureUploadHeap;
+        // Register every object with the culler in the same order so the ids match.
+        for (UINT object = 0; object < m_transforms.GetObjectCount(); ++object)
+        {
+            m_culler.AddObject(&m_transforms.GetWorldCenter(object).x, &m_transforms.GetWorldExtents(object).x);
+        }
 
-    // Create the texture.
-    {
-        // Describe and create a Texture2D.
-        // ؽĿ   Ѵ.
-        D3D12_RESOURCE_DESC textureDesc = {};
-        textureDesc.MipLevels = 1;
-        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        textureDesc.Width = TextureWidth;
-        textureDesc.Height = TextureHeight;
-        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-        textureDesc.DepthOrArraySize = 1;
-        textureDesc.SampleDesc.Count = 1;
-        textureDesc.SampleDesc.Quality = 0;
-        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-
-        // ڿ ϰ  Ӽ鿡 ϴ   ڿ ñ(commit)
-        ThrowIfFailed(m_device->CreateCommittedResource(
-            // D3D12_HEAP_TYPE_DEFAULT  ⺻ ̸  GPU   ڿ .
-            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-            // ڿ ñ   ϴ Ӽ Ÿ ÷
-            D3D12_HEAP_FLAG_NONE,
-            // ؽ Desc
-            &textureDesc,
-            // ڿ ʱ ¸ 
-            D3D12_RESOURCE_STATE_COPY_DEST,
-            nullptr,
-            IID_PPV_ARGS(&m_texture)));
+        // And with the LOD selector, when there is a mesh to draw at several levels. The bounds
+        // are set every frame in OnUpdate.
+        // 메시가 있으면 LOD 선택기에도 같은 순서로 등록한다.
+        if (mesh)
+        {
+            const float origin[3] = {};
+            for (UINT object = 0; object < m_transforms.GetObjectCount(); ++object)
+            {
+                m_lodSelector.AddInstance(origin, 0.0f, 1.0f, m_meshLods);
+            }
+        }
 
-        // ε   
-        const UINT64 uploadBufferSize = GetRequiredIntermediateSize(m_texture.Get(), 0, 1);
+        // Every mesh object is also an occluder, rasterized at the coarsest level. Its vertices
+        // are the mesh's own, so it stays inside the object's bounds, and its error is bounded by
+        // MeshLodMaxError. The world matrices are set every frame in OnUpdate. The triangle would
+        // only hide itself, so without a mesh the occluder set stays empty and every object
+        // passes the occlusion test.
+        // 메시 오브젝트는 가장 단순한 LOD 로 오클루더도 된다. 삼각형만 있을 때는 오클루더가 없다.
+
+        // Each object gets a 256 byte aligned slot, and each frame in flight its own set of slots,
+        // so the CPU never writes constants that the GPU may still be reading.
+        const UINT constantBufferSize = m_frameCount * m_transforms.GetObjectCount() * sizeof(ObjectConstants);
 
-        // Create the GPU upload buffer
-        // GPU ε ۸ 
         ThrowIfFailed(m_device->CreateCommittedResource(
             &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
             D3D12_HEAP_FLAG_NONE,
-            &CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
+            &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
             D3D12_RESOURCE_STATE_GENERIC_READ,
             nullptr,
-            IID_PPV_ARGS(&textureUploadHeap)));
-
-        // Copy data to the intermediate upload heap and then schedule a copy 
-        // from the upload heap to the Texture2D.
-        // ؽĸ ϰ
-        // ߰ ε  ͸ Ѵ
-        // ε  Texture2D  纻 Ѵ.
-        std::vector<UINT8> texture = GenerateTextureData();
-
-        // TextureData  Ѵ.
-        D3D12_SUBRESOURCE_DATA textureData = {};
-        textureData.pData = &texture[0];
-        textureData.RowPitch = TextureWidth * TexturePixelSize;
-        textureData.SlicePitch = textureData.RowPitch * TextureHeight;
-
-        //  ۼ 긮ҽ Ʈ Ѵ.
-        UpdateSubresources(m_commandList.Get(), m_texture.Get(), textureUploadHeap.Get(), 0, 0, 1, &textureData);
-        // ResourceBarrier   ¿ ȼ̴ ҽ · ȯѴ.
-        m_commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
-
-        // Describe and create a SRV for the texture.
-        // ؽĿ  SRV Desc  ϰ Ѵ.
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = textureDesc.Format;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
-        m_device->CreateShaderResourceView(m_texture.Get(), &srvDesc, m_srvHeap->GetCPUDescriptorHandleForHeapStart());
+            IID_PPV_ARGS(&m_objectConstantBuffer)));
+        RegisterResource(m_objectConstantBuffer.Get(), MemoryTag(MemoryCategory::Buffers, "object constants"));
+
+        // Map and initialize the constant buffer. We don't unmap this until the
+        // app closes. Keeping things mapped for the lifetime of the resource is okay.
+        // 업로드 힙은 계속 매핑해 두어도 되므로 앱이 끝날 때까지 Unmap 하지 않는다.
+        CD3DX12_RANGE readRange(0, 0);      // We do not intend to read from this resource on the CPU.
+        ThrowIfFailed(m_objectConstantBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_pObjectConstants)));
     }
 
-    // Close the command list and execute it to begin the initial GPU setup.
-    //  ؽ  ε,    ɵ ߰Ƿ close  ݾش.
-    ThrowIfFailed(m_commandList->Close());
-    ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
-    // Ŀǵ ť Ŀǵ Ʈ Ѵ.
-    m_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
 
+    // Note: ComPtr's are CPU objects but this resource needs to stay in scope until
+    // the command list that references it has finished executing on the GPU.
+    // At the end of this method it is handed to the deferred release queue, which keeps it
+    // alive until then.
+    // ComPtr 은 CPU 개체이지만 이 리소스는 이를 참조하는 커맨드 리스트가 GPU 에서 실행을 마칠때까지 살아 있어야 한다.
+    // 이 방법의 끝에서 지연 해제 큐에 넘겨, GPU 를 플러시하지 않고도 조기에 파괴되지 않게 한다.
+    // 텍스쳐를 업로드하는 버퍼로 쓰인다
+    ComPtr<ID3D12Resource> textureUploadHeap;
 
-    // Create synchronization objects and wait until assets have been uploaded to the GPU.
-    // DX12  fence  ̿ ȭ Ѵ.
-    // GPU     óϸ CPU  װ   ְ ش.
-    // fence  ϰ  gpu  ε   ٸ ڵ̴.
+    // Create the texture.
     {
-        // m_fence  ִ fence  Ѵ.
-        ThrowIfFailed(m_device->CreateFence(m_fenceValue[m_frameIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
-        //   m_fence  ִ    ϰ ȴ.
-        m_fenceValue[m_frameIndex]++;
+        D3D12_RESOURCE_STATES textureState = D3D12_RESOURCE_STATE_COPY_DEST;
+        ResourceKey textureKey;
+
+        // A texture file given on the command line comes first, then the packed archive next to
+        // the executable; the checkerboard is generated only when neither is there.
+        // 명령줄의 텍스쳐 파일, 실행 파일 옆의 에셋 아카이브 순으로 쓰고, 둘 다 없을 때만 체커보드를 생성한다.
+        if (textureFile)
+        {
+            LoadTextureFromKtx2(*textureFile, textureUploadHeap, textureKey);
+        }
+        else if (!LoadTextureFromArchive(GetAssetFullPath(L"Assets.pak"), "texture", textureUploadHeap, textureKey))
+        {
+            // Describe and create a Texture2D.
+            // 텍스쳐에 관한 정보를 서술한다.
+            D3D12_RESOURCE_DESC textureDesc = {};
+            textureDesc.MipLevels = 1;
+            textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            textureDesc.Width = TextureWidth;
+            textureDesc.Height = TextureHeight;
+            textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+            textureDesc.DepthOrArraySize = 1;
+            textureDesc.SampleDesc.Count = 1;
+            textureDesc.SampleDesc.Quality = 0;
+            textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+
+            const UINT8* texture = checkerboard;
+
+            // A texture made from the same pixels is already on the GPU: share it, with no upload.
+            // An animated texture changes every frame, so it is neither shared nor written in place.
+            // 같은 픽셀로 만든 텍스쳐가 이미 있으면 업로드 없이 그것을 공유한다.
+            // 애니메이션되는 텍스쳐는 매 프레임 바뀌므로 공유하지 않고 직접 쓰지도 않는다.
+            const bool animated = m_animatedTextureSize > 0;
+            if (!animated)
+            {
+                textureKey = MakeTextureKey(texture, TextureWidth * TextureHeight * TexturePixelSize, textureDesc.Format, TextureWidth, TextureHeight);
+                m_textureHandle = m_resourceCache->Acquire(textureKey);
+            }
+            if (m_textureHandle != InvalidResource)
+            {
+                m_texture = m_resourceCache->GetResource(m_textureHandle);
+            }
+            else if (!animated && CreateTextureInPlace(textureDesc, texture, TextureWidth * TexturePixelSize, "checkerboard texture"))
+            {
+                textureState = D3D12_RESOURCE_STATE_COMMON;
+            }
+            else
+            {
+                // 자원을 생성하고 지정된 속성들에 부합하는 힙에 그 자원을 맡긴다(commit)
+                ThrowIfFailed(m_device->CreateCommittedResource(
+                    // D3D12_HEAP_TYPE_DEFAULT 는 기본 힙이며 전적으로 GPU 가 접근할 자원들이 담긴다.
+                    &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+                    // 자원을 맡길 힙이 가졌으면 하는 속성을 나타내는 플래그
+                    D3D12_HEAP_FLAG_NONE,
+                    // 텍스쳐의 Desc
+                    &textureDesc,
+                    // 자원의 초기 상태를 지정
+                    D3D12_RESOURCE_STATE_COPY_DEST,
+                    nullptr,
+                    IID_PPV_ARGS(&m_texture)));
+                RegisterResource(m_texture.Get(), MemoryTag(MemoryCategory::Textures, "checkerboard texture"));
+
+                // 업로드할 버퍼의 사이즈를 저장
+                const UINT64 uploadBufferSize = GetRequiredIntermediateSize(m_texture.Get(), 0, 1);
+
+                // Create the GPU upload buffer
+                // GPU 업로드 버퍼를 생성
+                ThrowIfFailed(m_device->CreateCommittedResource(
+                    &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+                    D3D12_HEAP_FLAG_NONE,
+                    &CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
+                    D3D12_RESOURCE_STATE_GENERIC_READ,
+                    nullptr,
+                    IID_PPV_ARGS(&textureUploadHeap)));
+                RegisterResource(textureUploadHeap.Get(), MemoryTag(MemoryCategory::Upload, "texture upload heap"));
+
+                // Copy data to the intermediate upload heap and then schedule a copy 
+                // from the upload heap to the Texture2D.
+                // 텍스쳐를 생성하고
+                // 중간 업로드 힙에 데이터를 복사한다음
+                // 업로드 힙에서 Texture2D 로 복사본을 예약한다.
+                // The checkerboard is generated as RGBA8 and converted into the texture's format while
+                // it is written into the upload heap, at the device's row pitch. Same format: a copy.
+                // 체커보드는 RGBA8 로 만들고, 업로드 힙에 장치의 행 간격으로 쓰면서 텍스쳐 포맷으로 변환한다.
+                PixelFormat uploadFormat;
+                bool uploadSrgb;
+                if (!GetPixelFormatFromDxgi(textureDesc.Format, uploadFormat, uploadSrgb))
+                {
+                    throw std::runtime_error("Texture format has no pixel conversion.");
+                }
+                D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout;
+                m_device->GetCopyableFootprints(&textureDesc, 0, 1, 0, &layout, nullptr, nullptr, nullptr);
+
+                UINT8* pUploadData;
+                CD3DX12_RANGE readRange(0, 0);
+                ThrowIfFailed(textureUploadHeap->Map(0, &readRange, reinterpret_cast<void**>(&pUploadData)));
+                ConvertPixelRows(texture, TextureWidth * TexturePixelSize, PixelFormat::RGBA8,
+                    pUploadData + layout.Offset, layout.Footprint.RowPitch, uploadFormat, TextureWidth, TextureHeight);
+                m_capture.CaptureBufferWrite(textureUploadHeap.Get(), 0, pUploadData, static_cast<size_t>(uploadBufferSize));
+                textureUploadHeap->Unmap(0, nullptr);
+
+                // 업로드 힙에서 텍스쳐로 복사한다.
+                commands.CopyTextureRegion(CD3DX12_TEXTURE_COPY_LOCATION(m_texture.Get(), 0), CD3DX12_TEXTURE_COPY_LOCATION(textureUploadHeap.Get(), layout));
+                m_uploadBytesMetric->Add(uploadBufferSize);
+            }
+            if (animated)
+            {
+                CreateTextureAnimation(texture);
+            }
+        }
+        // A shared texture is already in the pixel shader resource state and has its view.
+        // 캐시에서 가져온 텍스쳐는 이미 셰이더 리소스 상태이고 뷰도 있다.
+        if (m_textureHandle != InvalidResource)
+        {
+            m_resourceCacheHitMetric->Add();
+        }
+        else
+        {
+            // ResourceBarrier 를 복사 상태에서 픽셀셰이더 리소스 상태로 전환한다.
+            commands.ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_texture.Get(), textureState, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+            // Describe the SRV for the texture; the cache creates it in its heap.
+            // 텍스쳐에 대한 SRV Desc 를 기술한다. SRV 는 캐시가 자체 힙에 만든다.
+            D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+            srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            const D3D12_RESOURCE_DESC textureDesc = m_texture->GetDesc();
+            srvDesc.Format = textureDesc.Format;
+            srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            srvDesc.Texture2D.MipLevels = textureDesc.MipLevels;
+            if (m_textureDirtyRegions)
+            {
+                // Not shared, so the view goes straight into the app's heap.
+                // 공유하지 않는 텍스쳐이므로 뷰를 앱의 힙에 바로 만든다.
+                m_device->CreateShaderResourceView(m_texture.Get(), &srvDesc, m_srvHeap->GetCPUDescriptorHandleForHeapStart());
+            }
+            else
+            {
+                m_textureHandle = m_resourceCache->InsertTexture(textureKey, m_texture.Get(), &srvDesc);
+                m_resourceCacheMissMetric->Add();
+            }
+        }
+        if (m_textureHandle != InvalidResource)
+        {
+            m_device->CopyDescriptorsSimple(1, m_srvHeap->GetCPUDescriptorHandleForHeapStart(), m_resourceCache->GetSrv(m_textureHandle), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        }
+    }
 
-        // Create an event handle to use for frame synchronization.
-        //  ȭ  ̺Ʈ ڵ .
-        m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-        if (m_fenceEvent == nullptr)
+    // The atlas is only drawn by the sprites.
+    // 아틀라스는 스프라이트만 그린다.
+    ComPtr<ID3D12Resource> atlasUploadHeap;
+    if (m_spriteCount > 0)
+    {
+        if (m_atlasTextureCount > 0)
         {
-            // ̺Ʈ   ÿ ó ڵ
-            ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+            CreateAtlas(commands, atlasUploadHeap);
         }
+        CreateSprites();
+    }
 
-        // Wait for the command list to execute; we are reusing the same command 
-        // list in our main loop but for now, we just want to wait for setup to 
-        // complete before continuing.
-        // Ŀǵ Ʈ   ٸ.
-        //     Ŀǵ Ʈ ϰ ִ.
-        WaitForGPU();
+    // Close the command list and execute it to begin the initial GPU setup.
+    // 위에서 텍스쳐 정보 업로드, 상태 전이 등의 명령들을 추가했으므로 close 로 닫아준다.
+    commands.Close();
+    ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
+    // 커맨드 큐에서 커맨드 리스트를 실행한다.
+    m_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+    m_capture.CaptureExecute(m_commandList.Get());
+
+    // Captures refer to objects by creation order, so when capturing or replaying the pipeline
+    // states are waited for here, to be registered at the same point in both runs.
+    // 캡처와 재생에서는 두 실행의 객체 등록 순서가 같도록 여기서 파이프라인을 기다린다.
+    if (m_capture.IsCapturing() || !m_replayInput.empty())
+    {
+        m_pipelineCompiler->WaitAll();
+        ResolvePipelines();
     }
+
+    // Don't wait for the upload. The queue executes in order, so the first frame's draws see the
+    // texture, and the upload heap and setup allocator are freed once the GPU passes this value.
+    // 업로드를 기다리지 않는다. 큐는 순서대로 실행되므로 첫 프레임은 텍스쳐가 올라간 뒤에 그려지고,
+    // 업로드 힙과 초기화용 allocator 는 GPU 가 이 fence 값을 지나면 해제된다.
+    const UINT64 setupFenceValue = m_directTimeline->Signal();
+    m_releaseQueue.Release(*m_directTimeline, setupFenceValue, textureUploadHeap.Detach());
+    m_releaseQueue.Release(*m_directTimeline, setupFenceValue, atlasUploadHeap.Detach());
+    m_releaseQueue.Release(*m_directTimeline, setupFenceValue, meshIndexUploadHeap.Detach());
+    m_releaseQueue.Release(*m_directTimeline, setupFenceValue, meshVertexUploadHeap.Detach());
+    m_releaseQueue.Release(*m_directTimeline, setupFenceValue, setupAllocator.Detach());
 }
 
-std::vector<UINT8> D3D12HelloTexture::GenerateTextureData()
+// Writes the checkerboard into pData, TextureWidth * TextureHeight * TexturePixelSize bytes.
+void D3D12HelloTexture::GenerateTextureData(UINT8* pData)
 {
     const UINT rowPitch = TextureWidth * TexturePixelSize;
     const UINT cellPitch = rowPitch >> 3;           // The width of a cell in the checkboard texture.
     const UINT cellHeight = TextureWidth >> 3;      // The width of a cell in the checkboard texture.
     const UINT textureSize = rowPitch * TextureHeight;
 
-    std::vector<UINT8> data(textureSize);
-    UINT8* pData = &data[0];
-
     for (UINT n = 0; n < textureSize; n += TexturePixelSize)
     {
         UINT x = n % rowPitch;
@@ -473,161 +1057,1509 @@ std::vector<UINT8> D3D12HelloTexture::GenerateTextureData()
             pData[n + 3] = 0xff;
         }
     }
-
-    return data;
 }
 
-
-// Update frame-based values.
-void D3D12HelloTexture::OnUpdate()
+// Sets up the animated texture from the checkerboard in pixels: the CPU images, the dirty region
+// tracker, and the upload buffer, m_frameCount parts of m_textureUpdateCapacity bytes.
+// 애니메이션용 CPU 이미지와 변경 영역 추적기, 프레임마다 한 부분씩 쓰는 업로드 버퍼를 만든다.
+void D3D12HelloTexture::CreateTextureAnimation(const UINT8* pixels)
 {
+    const size_t imageSize = TextureWidth * TextureHeight * TexturePixelSize;
+    m_textureBackground.assign(pixels, pixels + imageSize);
+    m_textureImage = m_textureBackground;
+    m_textureDirtyRegions = std::make_unique<DirtyRegionTracker>(TextureWidth, TextureHeight, 16);
+    m_textureUpdateRects.reserve(MaxTextureUpdateRects);
+
+    // The regions of a frame cover at most the image; twice the whole image at the copy row pitch
+    // leaves room for each region's row and start alignment. UploadTextureChanges falls back to
+    // the whole image if they ever need more.
+    const UINT64 rowPitch = AlignUp(TextureWidth * TexturePixelSize, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+    m_textureUpdateCapacity = AlignUp(2 * rowPitch * TextureHeight, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(m_frameCount * m_textureUpdateCapacity),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&m_textureUpdateBuffer)));
+    RegisterResource(m_textureUpdateBuffer.Get(), MemoryTag(MemoryCategory::Upload, "texture update buffer"));
 
+    CD3DX12_RANGE readRange(0, 0);
+    ThrowIfFailed(m_textureUpdateBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_pTextureUpdateData)));
 }
 
-// Render the scene.
-void D3D12HelloTexture::OnRender()
+// Moves the square over the checkerboard: the checkerboard is put back where it was, it is drawn
+// where it is now, and both areas are marked for upload.
+// 사각형이 있던 곳은 체커보드로 되돌리고 새 위치에 그린 뒤, 두 영역을 업로드 대상으로 표시한다.
+void D3D12HelloTexture::AnimateTexture(float deltaSeconds)
 {
-    // Record all the commands we need to render the scene into the command list.
-    //   ϴ  ʿ  Ŀǵ带 Ѵ.
-    PopulateCommandList();
+    const UINT rowPitch = TextureWidth * TexturePixelSize;
+    const UINT size = min(m_animatedTextureSize, min(TextureWidth, TextureHeight));
+    m_animationTime += deltaSeconds;
 
-    // Execute the command list.
-    ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+    for (UINT y = m_animatedSquare.Top; y < m_animatedSquare.Bottom; ++y)
+    {
+        const size_t offset = y * rowPitch + m_animatedSquare.Left * TexturePixelSize;
+        memcpy(&m_textureImage[offset], &m_textureBackground[offset], (m_animatedSquare.Right - m_animatedSquare.Left) * TexturePixelSize);
+    }
+    m_textureDirtyRegions->MarkDirty(m_animatedSquare);
 
-    // Present the frame.
-    ThrowIfFailed(m_swapChain->Present(1, 0));
+    // A Lissajous path, so the square crosses the texture in every direction.
+    const UINT x = static_cast<UINT>((0.5f + 0.5f * sinf(m_animationTime * 1.3f)) * (TextureWidth - size));
+    const UINT y = static_cast<UINT>((0.5f + 0.5f * sinf(m_animationTime * 0.7f)) * (TextureHeight - size));
+    m_animatedSquare = { x, y, x + size, y + size };
 
-    //   GPU ۾   ٸ Ŀ
-    //   CPU  Ѿ Լ.
-    MoveToNextFrame();
+    const UINT8 color[TexturePixelSize] = { 0xff, static_cast<UINT8>(x), static_cast<UINT8>(y), 0xff };
+    for (UINT row = m_animatedSquare.Top; row < m_animatedSquare.Bottom; ++row)
+    {
+        UINT8* pPixel = &m_textureImage[row * rowPitch + m_animatedSquare.Left * TexturePixelSize];
+        for (UINT column = 0; column < size; ++column, pPixel += TexturePixelSize)
+        {
+            memcpy(pPixel, color, TexturePixelSize);
+        }
+    }
+    m_textureDirtyRegions->MarkDirty(m_animatedSquare);
 }
 
-
-void D3D12HelloTexture::OnDestroy()
+// Copies the regions of the animated texture changed since the last frame. Each region gets a
+// placed footprint of its own in this frame's part of the upload buffer, rows aligned to
+// D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and start to D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, and one
+// CopyTextureRegion to its place in the texture.
+// 바뀐 영역마다 업로드 버퍼에 정렬된 footprint 를 잡아 쓰고, CopyTextureRegion 으로 그 위치에 복사한다.
+void D3D12HelloTexture::UploadTextureChanges(CapturedCommandList& commands)
 {
-    // Ensure that the GPU is no longer referencing resources that are about to be
-    // cleaned up by the destructor.
-    // GPU  Ҹڰ Ϸ ϴ ҽ  ʵ     Ѵ.
-    WaitForGPU();
+    if (m_textureDirtyRegions->Collect(m_textureUpdateRects, MaxTextureUpdateRects) == 0)
+    {
+        m_textureChangedMetric->Set(0);
+        return;
+    }
 
-    CloseHandle(m_fenceEvent);
-}
+    // Lay the regions out, offsets relative to this frame's part; if they do not fit, send the
+    // whole image instead.
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT layouts[MaxTextureUpdateRects];
+    const auto layOut = [&]()
+    {
+        UINT64 end = 0;
+        for (size_t i = 0; i < m_textureUpdateRects.size(); ++i)
+        {
+            const DirtyRect& rect = m_textureUpdateRects[i];
+            const UINT width = rect.Right - rect.Left;
+            const UINT height = rect.Bottom - rect.Top;
+            const UINT rowPitch = static_cast<UINT>(AlignUp(width * TexturePixelSize, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT));
+            layouts[i].Offset = AlignUp(end, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+            layouts[i].Footprint = { DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, rowPitch };
+            end = layouts[i].Offset + static_cast<UINT64>(rowPitch) * height;
+        }
+        return end;
+    };
+    UINT64 size = layOut();
+    if (size > m_textureUpdateCapacity)
+    {
+        m_textureUpdateRects.assign(1, DirtyRect{ 0, 0, TextureWidth, TextureHeight });
+        size = layOut();
+    }
 
+    const UINT64 frameOffset = m_frameIndex * m_textureUpdateCapacity;
 
-void D3D12HelloTexture::PopulateCommandList()
-{
-    // Command list allocators can only be reset when the associated 
-    // command lists have finished execution on the GPU; apps should use 
-    // fences to determine GPU execution progress.
-    // Command list allocator   Ŀǵ Ʈ
-    // GPU   Ϸ 쿡 缳   ִ.
-    // ׷Ƿ  ۸ ؼ commandAllocator   ʿϴ.
-    //  fence  Ͽ GPU   Ȳ Ȯؾ Ѵ.
-    ThrowIfFailed(m_commandAllocator[m_frameIndex]->Reset());
+    const UINT imageRowPitch = TextureWidth * TexturePixelSize;
+    UINT8* const pFrameData = m_pTextureUpdateData + frameOffset;
+    UINT64 changedBytes = 0;
+    for (size_t i = 0; i < m_textureUpdateRects.size(); ++i)
+    {
+        const DirtyRect& rect = m_textureUpdateRects[i];
+        const D3D12_SUBRESOURCE_FOOTPRINT& footprint = layouts[i].Footprint;
+        const UINT rowSize = footprint.Width * TexturePixelSize;
+        for (UINT row = 0; row < footprint.Height; ++row)
+        {
+            memcpy(pFrameData + layouts[i].Offset + row * footprint.RowPitch,
+                &m_textureImage[(rect.Top + row) * imageRowPitch + rect.Left * TexturePixelSize], rowSize);
+        }
+        changedBytes += static_cast<UINT64>(rowSize) * footprint.Height;
+        layouts[i].Offset += frameOffset;
+    }
+    m_capture.CaptureBufferWrite(m_textureUpdateBuffer.Get(), static_cast<UINT32>(frameOffset), pFrameData, static_cast<size_t>(size));
 
-    // However, when ExecuteCommandList() is called on a particular command 
-    // list, that command list can then be reset at any time and must be before 
-    // re-recording.
-    // ExecuteCommandList()  Ư Ŀǵ Ʈ Ǹ
-    // ش Ŀǵ Ʈ  ٽ   , ٽ ؾ Ѵ.
-    ThrowIfFailed(m_commandList->Reset(m_commandAllocator[m_frameIndex].Get(), m_pipelineState.Get()));
+    commands.ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_texture.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_DEST));
+    const CD3DX12_TEXTURE_COPY_LOCATION dest(m_texture.Get(), 0);
+    for (size_t i = 0; i < m_textureUpdateRects.size(); ++i)
+    {
+        commands.CopyTextureRegion(dest, m_textureUpdateRects[i].Left, m_textureUpdateRects[i].Top, CD3DX12_TEXTURE_COPY_LOCATION(m_textureUpdateBuffer.Get(), layouts[i]));
+    }
+    commands.ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
 
-    // Set necessary state.
-    // Ŀǵ Ʈ ʿ µ Ѵ.
-    m_commandList->SetGraphicsRootSignature(m_rootSignature.Get());
+    const UINT64 imageBytes = static_cast<UINT64>(imageRowPitch) * TextureHeight;
+    m_uploadBytesMetric->Add(size);
+    m_textureUpdateBytesMetric->Add(changedBytes);
+    m_textureUpdateSavedMetric->Add(imageBytes - min(changedBytes, imageBytes));
+    m_textureChangedMetric->Set(static_cast<int64_t>(changedBytes * 100 / imageBytes));
+}
 
-    ID3D12DescriptorHeap* ppHeaps[] = { m_srvHeap.Get() };
-    m_commandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+// Generates m_atlasTextureCount small textures, shaded discs of random sizes and colors, and
+// packs them into at most MaxAtlasPages pages of m_atlasLayout (textures that find no room are
+// left out). The pages are written into uploadHeap, the space between the textures transparent,
+// and copied into textures of their own with commands.
+// 작은 텍스쳐들을 만들어 아틀라스 페이지에 모으고, 업로드 힙을 거쳐 페이지 텍스쳐로 복사한다.
+void D3D12HelloTexture::CreateAtlas(CapturedCommandList& commands, ComPtr<ID3D12Resource>& uploadHeap)
+{
+    // Fixed seed: every run, and a replay, packs the same textures.
+    std::mt19937 random(7);
+    std::uniform_int_distribution<uint32_t> size(8, 96);
+    std::vector<uint32_t> widths(m_atlasTextureCount);
+    std::vector<uint32_t> heights(m_atlasTextureCount);
+    for (UINT i = 0; i < m_atlasTextureCount; ++i)
+    {
+        widths[i] = size(random);
+        heights[i] = size(random);
+    }
 
-    m_commandList->SetGraphicsRootDescriptorTable(0, m_srvHeap->GetGPUDescriptorHandleForHeapStart());
-    // ε  Ʈ , Ʈ ü 迭
-    m_commandList->RSSetViewports(1, &m_viewport);
-    m_commandList->RSSetScissorRects(1, &m_scissorRect);
+    AtlasSettings settings;
+    settings.PageWidth = AtlasPageSize;
+    settings.PageHeight = AtlasPageSize;
+    settings.MaxPages = MaxAtlasPages;
+    m_atlasLayout = PackTextureAtlas(widths.data(), heights.data(), widths.size(), settings);
+
+    // One upload heap, a page after another.
+    const CD3DX12_RESOURCE_DESC pageDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, AtlasPageSize, AtlasPageSize, 1, 1);
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+    UINT64 pageBytes;
+    m_device->GetCopyableFootprints(&pageDesc, 0, 1, 0, &footprint, nullptr, nullptr, &pageBytes);
+    pageBytes = AlignUp(pageBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+    const UINT64 uploadBytes = pageBytes * m_atlasLayout.PageCount;
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(uploadBytes),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&uploadHeap)));
+    RegisterResource(uploadHeap.Get(), MemoryTag(MemoryCategory::Upload, "atlas upload heap"));
+
+    UINT8* pUploadData;
+    CD3DX12_RANGE readRange(0, 0);
+    ThrowIfFailed(uploadHeap->Map(0, &readRange, reinterpret_cast<void**>(&pUploadData)));
+    memset(pUploadData, 0, static_cast<size_t>(uploadBytes));
+    for (UINT i = 0; i < m_atlasTextureCount; ++i)
+    {
+        const AtlasPlacement& placement = m_atlasLayout.Placements[i];
+        const UINT32 color = random() & 0x00ffffff;
+        if (placement.Page == AtlasNotPacked)
+        {
+            continue;
+        }
 
-    // Indicate that the back buffer will be used as a render target.
-    //  ۰  Ÿ   Ÿ.
-    m_commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_renderTargets[m_frameIndex].Get(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
+        // 텍스쳐는 스크래치 메모리에 만들고 페이지로 복사한다.
+        ScratchScope scratch;
+        UINT8* pixels = scratch.Allocate<UINT8>(placement.Width * placement.Height * TexturePixelSize);
+        for (UINT y = 0; y < placement.Height; ++y)
+        {
+            for (UINT x = 0; x < placement.Width; ++x)
+            {
+                // Darker towards the rim, transparent outside it.
+                const float dx = 2.0f * (x + 0.5f) / placement.Width - 1.0f;
+                const float dy = 2.0f * (y + 0.5f) / placement.Height - 1.0f;
+                const float distance = dx * dx + dy * dy;
+                const float shade = 1.0f - 0.5f * distance;
+                UINT8* pixel = pixels + (y * placement.Width + x) * TexturePixelSize;
+                pixel[0] = static_cast<UINT8>((color & 0xff) * shade);
+                pixel[1] = static_cast<UINT8>(((color >> 8) & 0xff) * shade);
+                pixel[2] = static_cast<UINT8>(((color >> 16) & 0xff) * shade);
+                pixel[3] = distance <= 1.0f ? 0xff : 0x00;
+            }
+        }
+        BlitToAtlas(placement, m_atlasLayout.Gutter, pixels, placement.Width * TexturePixelSize, TexturePixelSize,
+            pUploadData + placement.Page * pageBytes, footprint.Footprint.RowPitch);
+    }
+    m_capture.CaptureBufferWrite(uploadHeap.Get(), 0, pUploadData, static_cast<size_t>(uploadBytes));
+    uploadHeap->Unmap(0, nullptr);
+    m_uploadBytesMetric->Add(uploadBytes);
 
-    //    Ÿٰ,  ٽ ο ´
-    CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart(), m_frameIndex, m_rtvDescriptorSize);
-    //  Ÿ ,  Ÿ ,  Ÿ ũͿ  Ǿ ִٸ true,  ٽ 
-    m_commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+    D3D12_RESOURCE_BARRIER barriers[MaxAtlasPages];
+    for (UINT page = 0; page < m_atlasLayout.PageCount; ++page)
+    {
+        ThrowIfFailed(m_device->CreateCommittedResource(
+            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+            D3D12_HEAP_FLAG_NONE,
+            &pageDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&m_atlasPages[page])));
+        RegisterResource(m_atlasPages[page].Get(), MemoryTag(MemoryCategory::Textures, "atlas page"));
 
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT pageFootprint = footprint;
+        pageFootprint.Offset = page * pageBytes;
+        commands.CopyTextureRegion(CD3DX12_TEXTURE_COPY_LOCATION(m_atlasPages[page].Get(), 0), CD3DX12_TEXTURE_COPY_LOCATION(uploadHeap.Get(), pageFootprint));
+        barriers[page] = CD3DX12_RESOURCE_BARRIER::Transition(m_atlasPages[page].Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
-    // Record commands.
-    // Ŀǵ 
-    const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
-    //  Ÿ  Ŭ
-    m_commandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
-    // ⺻  .
-    m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    //  ,   ,  ù Ҹ Ű 
-    m_commandList->IASetVertexBuffers(0, 1, &m_vertexBufferView);
-    // ε   ׸.
-    // ε ۰ ִٸ drawIndexedinstnaced Լ  Ѵ.
-    //  , νϽ ,   ε, ؽ ۿ νϽ  ͸ б   ε ߰ 
-    m_commandList->DrawInstanced(3, 1, 0, 0);
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Format = pageDesc.Format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MipLevels = 1;
+        m_device->CreateShaderResourceView(m_atlasPages[page].Get(), &srvDesc, CD3DX12_CPU_DESCRIPTOR_HANDLE(m_srvHeap->GetCPUDescriptorHandleForHeapStart(), 2 + page, m_srvDescriptorSize));
+    }
+    commands.ResourceBarrier(m_atlasLayout.PageCount, barriers);
+}
 
-    // Indicate that the back buffer will now be used to present.
-    // ۰ present ϱ    Ÿ.
-    m_commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_renderTargets[m_frameIndex].Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
+// Reads the opened mesh into m_meshVertices and builds its LOD chain, m_meshLods. The importer
+// parses the file and the simplifier evaluates collapses on the thread pool.
+// OBJ 메시를 스레드 풀에서 파싱하고, 단순화해 LOD 체인을 만든다.
+void D3D12HelloTexture::BuildMeshLods(MeshImporter& importer)
+{
+    if (importer.GetIndexCount() == 0 || importer.GetIndexCount() > UINT_MAX)
+    {
+        throw std::runtime_error("The mesh has no triangles, or too many to draw at once.");
+    }
 
-    // ɵ  Ƿ close  ݾش.
-    ThrowIfFailed(m_commandList->Close());
+    // The mesh is read into memory rather than straight into the upload heaps: the simplifier
+    // reads the positions back, which write-combined memory is far too slow for. The vertex
+    // count is known once the indices are read.
+    // 단순화 과정에서 정점 위치를 다시 읽으므로 업로드 힙이 아닌 메모리로 읽는다.
+    // 정점 개수는 인덱스를 읽은 뒤에 정해진다.
+    std::vector<uint32_t> indices(importer.GetIndexCount());
+    importer.ReadIndices(indices.data());
+    m_meshVertices.resize(importer.GetVertexCount());
+    importer.ReadVertices(m_meshVertices.data());
+
+    // Every level indexes the same vertices, so the levels only add indices.
+    // 모든 LOD 가 같은 정점을 쓰므로 LOD 마다 인덱스만 늘어난다.
+    const MeshBounds& bounds = importer.GetBounds();
+    const float largestExtent = max(bounds.Max[0] - bounds.Min[0], max(bounds.Max[1] - bounds.Min[1], bounds.Max[2] - bounds.Min[2]));
+    const SimplifierMesh simplifierMesh = { indices.data(), indices.size(), m_meshVertices.data(), sizeof(MeshVertex), m_meshVertices.size() };
+    MeshSimplifier simplifier(&m_threadPool);
+    simplifier.GenerateLodChain(simplifierMesh, MeshLodLevels, MeshLodReduction, MeshLodMaxError * largestExtent, m_meshLods);
 }
 
+// Copies the mesh and its LOD chain into m_vertexBuffer and m_indexBuffer, default heap buffers
+// filled from one upload heap each, and returns the bounds of its positions.
+// 메시와 LOD 체인을 업로드 힙을 거쳐 기본 힙 버퍼로 복사한다.
+void D3D12HelloTexture::CreateMesh(CapturedCommandList& commands, MeshImporter& importer, ComPtr<ID3D12Resource>& indexUploadHeap, ComPtr<ID3D12Resource>& vertexUploadHeap, XMFLOAT3& center, XMFLOAT3& extents)
+{
+    static_assert(sizeof(Vertex) == sizeof(MeshVertex), "The importer writes the sample's vertices.");
 
+    // Creates the upload heap and the buffer, has write fill the mapped heap and copies it over.
+    const auto upload = [this, &commands](UINT64 size, const char* name, ComPtr<ID3D12Resource>& uploadHeap, ComPtr<ID3D12Resource>& buffer, const std::function<void(void*)>& write)
+    {
+        ThrowIfFailed(m_device->CreateCommittedResource(
+            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+            D3D12_HEAP_FLAG_NONE,
+            &CD3DX12_RESOURCE_DESC::Buffer(size),
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadHeap)));
+        RegisterResource(uploadHeap.Get(), MemoryTag(MemoryCategory::Upload, "mesh upload heap"));
+        ThrowIfFailed(m_device->CreateCommittedResource(
+            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+            D3D12_HEAP_FLAG_NONE,
+            &CD3DX12_RESOURCE_DESC::Buffer(size),
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&buffer)));
+        RegisterResource(buffer.Get(), MemoryTag(MemoryCategory::Buffers, name));
+
+        UINT8* pUploadData;
+        CD3DX12_RANGE readRange(0, 0);
+        ThrowIfFailed(uploadHeap->Map(0, &readRange, reinterpret_cast<void**>(&pUploadData)));
+        write(pUploadData);
+        m_capture.CaptureBufferWrite(uploadHeap.Get(), 0, pUploadData, static_cast<size_t>(size));
+        uploadHeap->Unmap(0, nullptr);
+
+        commands.CopyBufferRegion(buffer.Get(), 0, uploadHeap.Get(), 0, size);
+        m_uploadBytesMetric->Add(size);
+    };
+
+    // BuildMeshLods has read the mesh and built its levels, which are packed LOD 0 first.
+    // 메시와 LOD 들은 BuildMeshLods 가 이미 만들어 두었다.
+    const UINT64 indexBufferSize = m_meshLods.Indices.size() * sizeof(UINT32);
+    upload(indexBufferSize, "mesh index buffer", indexUploadHeap, m_indexBuffer, [this](void* pData)
+    {
+        memcpy(pData, m_meshLods.Indices.data(), m_meshLods.Indices.size() * sizeof(UINT32));
+    });
+    const UINT64 vertexBufferSize = m_meshVertices.size() * sizeof(Vertex);
+    upload(vertexBufferSize, "mesh vertex buffer", vertexUploadHeap, m_vertexBuffer, [this](void* pData)
+    {
+        memcpy(pData, m_meshVertices.data(), m_meshVertices.size() * sizeof(MeshVertex));
+    });
 
+    const D3D12_RESOURCE_BARRIER barriers[] =
+    {
+        CD3DX12_RESOURCE_BARRIER::Transition(m_indexBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_INDEX_BUFFER),
+        CD3DX12_RESOURCE_BARRIER::Transition(m_vertexBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER),
+    };
+    commands.ResourceBarrier(_countof(barriers), barriers);
+
+    m_indexBufferView.BufferLocation = m_indexBuffer->GetGPUVirtualAddress();
+    m_indexBufferView.SizeInBytes = static_cast<UINT>(indexBufferSize);
+    m_indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+    m_vertexBufferView.BufferLocation = m_vertexBuffer->GetGPUVirtualAddress();
+    m_vertexBufferView.StrideInBytes = sizeof(Vertex);
+    m_vertexBufferView.SizeInBytes = static_cast<UINT>(vertexBufferSize);
+    m_meshIndexCount = static_cast<UINT>(importer.GetIndexCount());
+
+    const MeshBounds& bounds = importer.GetBounds();
+    center = XMFLOAT3((bounds.Min[0] + bounds.Max[0]) * 0.5f, (bounds.Min[1] + bounds.Max[1]) * 0.5f, (bounds.Min[2] + bounds.Max[2]) * 0.5f);
+    extents = XMFLOAT3((bounds.Max[0] - bounds.Min[0]) * 0.5f, (bounds.Max[1] - bounds.Min[1]) * 0.5f, (bounds.Max[2] - bounds.Min[2]) * 0.5f);
+}
 
-// Wait for pending GPU work to complete.
-// GPU  ۾   ٸ.
-void D3D12HelloTexture::WaitForGPU()
+// Creates m_spriteCount sprites scattered over the window, each showing a corner of the texture
+// with a tint, or one of the atlas textures at half its size, the shared index buffer and the
+// vertex buffer, m_frameCount parts that stay mapped. Both buffers live in upload heaps: the
+// indices are small, and the vertices are rewritten every frame.
+// 스프라이트 레코드, 공유 인덱스 버퍼, 프레임마다 한 부분씩 쓰는 정점 버퍼를 만든다.
+void D3D12HelloTexture::CreateSprites()
 {
-    // Schedule a Signal command in the queue.
-    // commandQueue::signal  GPU  fence  ϴ ̰,
-    // fence::signal  cpu  fence  ϴ ̴.
-    // ⼭ gpu  fence  Ѵ.
-    //  signal Լ ϱ  gpu  Ҵ  ۾  ⼭ ȣ m_fenceValue  m_fence  ȴ.
-    ThrowIfFailed(m_commandQueue->Signal(m_fence.Get(), m_fenceValue[m_frameIndex]));
+    // Fixed seed: every run, and a replay, draws the same sprites.
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const auto packUv = [](float u, float v)
+    {
+        return static_cast<uint32_t>(u * 65535.0f + 0.5f) | (static_cast<uint32_t>(v * 65535.0f + 0.5f) << 16);
+    };
+
+    std::vector<UINT> atlasTextures;
+    for (UINT i = 0; i < m_atlasLayout.Placements.size(); ++i)
+    {
+        if (m_atlasLayout.Placements[i].Page != AtlasNotPacked)
+        {
+            atlasTextures.push_back(i);
+        }
+    }
+
+    m_sprites.resize(m_spriteCount);
+    m_spriteSpin.resize(m_spriteCount);
+    m_spriteTextures.resize(m_spriteCount);
+    for (UINT i = 0; i < m_spriteCount; ++i)
+    {
+        Sprite& sprite = m_sprites[i];
+        sprite.X = unit(random) * m_width;
+        sprite.Y = unit(random) * m_height;
+        sprite.Width = 8.0f + 40.0f * unit(random);
+        sprite.Height = 8.0f + 40.0f * unit(random);
+        sprite.Rotation = (2.0f * unit(random) - 1.0f) * XM_PI;
+        sprite.Color = 0xff000000 | (random() & 0x00ffffff);
+        const float u = 0.75f * unit(random);
+        const float v = 0.75f * unit(random);
+        sprite.UvMin = packUv(u, v);
+        sprite.UvMax = packUv(u + 0.25f, v + 0.25f);
+        m_spriteSpin[i] = 4.0f * unit(random) - 2.0f;
+        m_spriteTextures[i] = 0;
+        if (!atlasTextures.empty())
+        {
+            // The texture's own UVs, remapped to its place on the page.
+            const UINT texture = atlasTextures[random() % atlasTextures.size()];
+            const AtlasPlacement& placement = m_atlasLayout.Placements[texture];
+            float uvs[] = { 0.0f, 0.0f, 1.0f, 1.0f };
+            RemapUvs(m_atlasLayout.Remaps[texture], uvs, 2, 2 * sizeof(float));
+            sprite.Width = 0.5f * placement.Width;
+            sprite.Height = 0.5f * placement.Height;
+            sprite.UvMin = packUv(uvs[0], uvs[1]);
+            sprite.UvMax = packUv(uvs[2], uvs[3]);
+            m_spriteTextures[i] = 2 + placement.Page;
+        }
+    }
+    if (!atlasTextures.empty())
+    {
+        // Sprites of a page together, a run of the batcher each.
+        std::vector<UINT> order(m_spriteCount);
+        for (UINT i = 0; i < m_spriteCount; ++i)
+        {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [this](UINT a, UINT b) { return m_spriteTextures[a] < m_spriteTextures[b]; });
+        std::vector<Sprite> sprites(m_spriteCount);
+        std::vector<float> spin(m_spriteCount);
+        std::vector<UINT> textures(m_spriteCount);
+        for (UINT i = 0; i < m_spriteCount; ++i)
+        {
+            sprites[i] = m_sprites[order[i]];
+            spin[i] = m_spriteSpin[order[i]];
+            textures[i] = m_spriteTextures[order[i]];
+        }
+        m_sprites.swap(sprites);
+        m_spriteSpin.swap(spin);
+        m_spriteTextures.swap(textures);
+    }
+
+    const UINT indexBufferSize = SpriteBatch::MaxSpritesPerDraw * 6 * sizeof(uint16_t);
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(indexBufferSize),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&m_spriteIndexBuffer)));
+    RegisterResource(m_spriteIndexBuffer.Get(), MemoryTag(MemoryCategory::Buffers, "sprite index buffer"));
+
+    uint16_t* pIndices;
+    CD3DX12_RANGE readRange(0, 0);
+    ThrowIfFailed(m_spriteIndexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pIndices)));
+    BuildSpriteIndices(pIndices);
+    m_capture.CaptureBufferWrite(m_spriteIndexBuffer.Get(), 0, pIndices, indexBufferSize);
+    m_spriteIndexBuffer->Unmap(0, nullptr);
+    m_uploadBytesMetric->Add(indexBufferSize);
+
+    m_spriteIndexBufferView.BufferLocation = m_spriteIndexBuffer->GetGPUVirtualAddress();
+    m_spriteIndexBufferView.SizeInBytes = indexBufferSize;
+    m_spriteIndexBufferView.Format = DXGI_FORMAT_R16_UINT;
+
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(static_cast<UINT64>(m_frameCount) * m_spriteCount * 4 * sizeof(SpriteVertex)),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&m_spriteVertexBuffer)));
+    RegisterResource(m_spriteVertexBuffer.Get(), MemoryTag(MemoryCategory::Buffers, "sprite vertex buffer"));
+    ThrowIfFailed(m_spriteVertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_pSpriteVertices)));
+}
+
+// Spins the sprites and expands them into this frame's part of the vertex buffer, across the
+// thread pool. MoveToNextFrame has already waited for the GPU to finish with that part.
+// 스프라이트를 회전시키고 스레드 풀에서 이번 프레임 영역의 정점으로 펼친다.
+void D3D12HelloTexture::BatchSprites(float deltaSeconds)
+{
+    for (size_t i = 0; i < m_sprites.size(); ++i)
+    {
+        // Kept within [-pi, pi], where the batcher's sine is most precise.
+        float rotation = m_sprites[i].Rotation + m_spriteSpin[i] * deltaSeconds;
+        if (rotation > XM_PI)
+        {
+            rotation -= XM_2PI;
+        }
+        else if (rotation < -XM_PI)
+        {
+            rotation += XM_2PI;
+        }
+        m_sprites[i].Rotation = rotation;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const size_t frameVertices = m_sprites.size() * 4;
+    SpriteVertex* const pFrameVertices = m_pSpriteVertices + m_frameIndex * frameVertices;
+    m_spriteBatch.Begin();
+    for (size_t first = 0; first < m_sprites.size();)
+    {
+        size_t end = first + 1;
+        while (end < m_sprites.size() && m_spriteTextures[end] == m_spriteTextures[first])
+        {
+            ++end;
+        }
+        m_spriteBatch.Draw(m_spriteTextures[first], m_sprites.data() + first, end - first);
+        first = end;
+    }
+    m_spriteBatch.End(pFrameVertices, false, &m_threadPool);
+    m_spriteBatchMetric->Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+    m_capture.CaptureBufferWrite(m_spriteVertexBuffer.Get(), static_cast<UINT32>(m_frameIndex * frameVertices * sizeof(SpriteVertex)),
+        pFrameVertices, frameVertices * sizeof(SpriteVertex));
+    m_uploadBytesMetric->Add(frameVertices * sizeof(SpriteVertex));
+}
+
+// Draws the ranges of m_spriteBatch over the scene: a texture binding per range, and a draw per
+// SpriteBatch::MaxSpritesPerDraw quads, reaching them through the base vertex.
+// 범위마다 텍스쳐를 바인딩하고, 공유 인덱스 버퍼가 닿는 만큼씩 base vertex 를 옮겨 가며 그린다.
+void D3D12HelloTexture::DrawSprites(CapturedCommandList& commands)
+{
+    const UINT frameVertices = static_cast<UINT>(m_sprites.size() * 4);
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
+    vertexBufferView.BufferLocation = m_spriteVertexBuffer->GetGPUVirtualAddress() + static_cast<UINT64>(m_frameIndex) * frameVertices * sizeof(SpriteVertex);
+    vertexBufferView.SizeInBytes = frameVertices * sizeof(SpriteVertex);
+    vertexBufferView.StrideInBytes = sizeof(SpriteVertex);
+
+    // Sprite positions are in window pixels, whatever the render scale.
+    const float pixelToClip[] = { 2.0f / m_width, -2.0f / m_height, -1.0f, 1.0f };
+
+    commands.SetPipelineState(m_spritePipelineState.Get());
+    commands.SetGraphicsRootSignature(m_spriteRootSignature.Get());
+    commands.SetGraphicsRoot32BitConstants(1, _countof(pixelToClip), pixelToClip, 0);
+    commands.IASetIndexBuffer(m_spriteIndexBufferView);
+    commands.IASetVertexBuffer(0, vertexBufferView);
+    for (const SpriteBatchRange& range : m_spriteBatch.GetRanges())
+    {
+        // The texture is the SRV's slot in m_srvHeap.
+        commands.SetGraphicsRootDescriptorTable(0, CD3DX12_GPU_DESCRIPTOR_HANDLE(m_srvHeap->GetGPUDescriptorHandleForHeapStart(), range.Texture, m_srvDescriptorSize));
+        for (UINT first = 0; first < range.QuadCount; first += SpriteBatch::MaxSpritesPerDraw)
+        {
+            const UINT quads = min(range.QuadCount - first, SpriteBatch::MaxSpritesPerDraw);
+            commands.DrawIndexedInstanced(quads * 6, 1, 0, static_cast<INT>((range.FirstQuad + first) * 4), 0);
+        }
+    }
+}
+
+// On UMA adapters, creates m_texture in CPU-visible memory and writes the pixels (rows of
+// desc.Format, one subresource) straight into it: no upload heap, no copy on the GPU. With 64KB
+// standard swizzle the layout is known and the pixels are tiled on the CPU into the mapping; the
+// first such texture is read back through the driver to check the tiling, falling back to
+// WriteToSubresource if it differs. Otherwise WriteToSubresource lets the driver tile them.
+// The texture is left in the common state. Returns false, creating nothing, when the adapter is
+// not UMA, the texture has more than one subresource, or commands are being captured or replayed
+// (the capture only records buffer writes).
+// UMA 어댑터에서는 텍스쳐를 CPU 가 접근 가능한 메모리에 만들고 픽셀을 바로 쓴다.
+bool D3D12HelloTexture::CreateTextureInPlace(D3D12_RESOURCE_DESC desc, const UINT8* pixels, UINT rowPitch, const char* name)
+{
+    PixelFormat format;
+    bool srgb;
+    if (!m_uma || desc.MipLevels != 1 || desc.DepthOrArraySize != 1 || desc.Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D ||
+        m_capture.IsCapturing() || !m_replayInput.empty() || !GetPixelFormatFromDxgi(desc.Format, format, srgb))
+    {
+        return false;
+    }
+    const UINT width = static_cast<UINT>(desc.Width);
+    const UINT height = desc.Height;
+    const UINT bytesPerElement = GetPixelSize(format);
+
+    // Cache coherent UMA reads the CPU caches; otherwise the CPU writes must bypass them.
+    const CD3DX12_HEAP_PROPERTIES heapProperties(
+        m_cacheCoherentUma ? D3D12_CPU_PAGE_PROPERTY_WRITE_BACK : D3D12_CPU_PAGE_PROPERTY_WRITE_COMBINE, D3D12_MEMORY_POOL_L0);
+    desc.Layout = m_standardSwizzle64KB ? D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE : D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &heapProperties,
+        D3D12_HEAP_FLAG_NONE,
+        &desc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(&m_texture)));
+    RegisterResource(m_texture.Get(), MemoryTag(MemoryCategory::Textures, name));
+
+    if (m_standardSwizzle64KB)
+    {
+        UINT8* pTextureData;
+        ThrowIfFailed(m_texture->Map(0, nullptr, reinterpret_cast<void**>(&pTextureData)));
+        SwizzleStandard64KB(pixels, rowPitch, pTextureData, width, height, bytesPerElement);
+
+        if (!m_standardSwizzleChecked)
+        {
+            m_standardSwizzleChecked = true;
+            ScratchScope scratch;
+            UINT8* readback = scratch.Allocate<UINT8>(static_cast<size_t>(rowPitch) * height);
+            ThrowIfFailed(m_texture->ReadFromSubresource(readback, rowPitch, rowPitch * height, 0, nullptr));
+            for (UINT y = 0; y < height; ++y)
+            {
+                if (memcmp(readback + y * rowPitch, pixels + y * rowPitch, width * bytesPerElement) != 0)
+                {
+                    OutputDebugStringA("Standard swizzle tiling differs from the driver's; writing textures through WriteToSubresource.\n");
+                    m_standardSwizzle64KB = false;
+                    ThrowIfFailed(m_texture->WriteToSubresource(0, nullptr, pixels, rowPitch, rowPitch * height));
+                    break;
+                }
+            }
+        }
+        m_texture->Unmap(0, nullptr);
+    }
+    else
+    {
+        ThrowIfFailed(m_texture->Map(0, nullptr, nullptr));
+        ThrowIfFailed(m_texture->WriteToSubresource(0, nullptr, pixels, rowPitch, rowPitch * height));
+        m_texture->Unmap(0, nullptr);
+    }
+    return true;
+}
+
+
+// Creates m_texture from a texture asset of a packed archive and records its upload, and sets key
+// to the asset's cache key. When the cache already holds the texture, m_texture and
+// m_textureHandle are set from it and nothing is uploaded.
+// Returns false when the archive or the asset does not exist.
+bool D3D12HelloTexture::LoadTextureFromArchive(const std::wstring& path, const char* name, ComPtr<ID3D12Resource>& uploadHeap, ResourceKey& key)
+{
+    if (GetFileAttributesW(path.c_str()) == INVALID_FILE_ATTRIBUTES)
+    {
+        return false;
+    }
+
+    AssetArchive archive;
+    archive.Open(path.c_str());
+
+    const UINT32 asset = archive.Find(name);
+    if (asset == AssetArchive::NotFound)
+    {
+        return false;
+    }
+
+    const AssetEntry& entry = archive.GetAsset(asset);
+    if (entry.Type != AssetType::Texture2D || entry.ArraySize != 1)
+    {
+        throw std::runtime_error("Archive texture must be a single 2D texture.");
+    }
+
+    // The key comes from the compressed chunks, so a texture already on the GPU is found before
+    // anything is decompressed.
+    // 압축된 청크로 키를 만들어, 이미 올라간 텍스쳐는 압축을 풀기 전에 찾는다.
+    key.ContentHash = archive.HashAssetContent(asset);
+    key.ContentSize = entry.PayloadSize;
+    key.Format = entry.Format;
+    key.Width = entry.Width;
+    key.Height = entry.Height;
+    key.DepthOrArraySize = entry.ArraySize;
+    key.MipLevels = entry.MipLevels;
+    m_textureHandle = m_resourceCache->Acquire(key);
+    if (m_textureHandle != InvalidResource)
+    {
+        m_texture = m_resourceCache->GetResource(m_textureHandle);
+        return true;
+    }
+    archive.Prefetch(asset);
+
+    const D3D12_RESOURCE_DESC textureDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+        static_cast<DXGI_FORMAT>(entry.Format), entry.Width, entry.Height, entry.ArraySize, entry.MipLevels);
+
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+        D3D12_HEAP_FLAG_NONE,
+        &textureDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        nullptr,
+        IID_PPV_ARGS(&m_texture)));
+    RegisterResource(m_texture.Get(), MemoryTag(MemoryCategory::Textures, "archive texture"));
+
+    // The packer already placed every subresource at the offset and row pitch the device wants;
+    // make sure this device agrees before copying straight out of the payload.
+    // 패커가 미리 맞춰 둔 서브리소스 배치가 이 장치의 배치와 같은지 확인한다.
+    const UINT subresourceCount = entry.ArraySize * entry.MipLevels;
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(subresourceCount);
+    UINT64 totalBytes = 0;
+    m_device->GetCopyableFootprints(&textureDesc, 0, subresourceCount, 0, layouts.data(), nullptr, nullptr, &totalBytes);
+
+    std::vector<SubresourceFootprint> packedLayouts;
+    ComputeCopyableFootprints(entry.Format, entry.Width, entry.Height, entry.ArraySize, entry.MipLevels, packedLayouts);
+    for (UINT i = 0; i < subresourceCount; ++i)
+    {
+        if (layouts[i].Offset != packedLayouts[i].Offset || layouts[i].Footprint.RowPitch != packedLayouts[i].RowPitch)
+        {
+            throw std::runtime_error("Archive texture layout does not match the device.");
+        }
+    }
+
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(totalBytes > entry.PayloadSize ? totalBytes : entry.PayloadSize),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&uploadHeap)));
+    RegisterResource(uploadHeap.Get(), MemoryTag(MemoryCategory::Upload, "texture upload heap"));
+
+    // Chunks are decompressed in parallel directly into the upload heap; the texels are never
+    // staged in another CPU buffer.
+    // 청크들을 병렬로 업로드 힙에 바로 압축 해제한다.
+    UINT8* pUploadData;
+    CD3DX12_RANGE readRange(0, 0);
+    ThrowIfFailed(uploadHeap->Map(0, &readRange, reinterpret_cast<void**>(&pUploadData)));
+    archive.Decompress(asset, pUploadData, &m_threadPool);
+    m_capture.CaptureBufferWrite(uploadHeap.Get(), 0, pUploadData, static_cast<size_t>(totalBytes));
+    uploadHeap->Unmap(0, nullptr);
+    m_uploadBytesMetric->Add(totalBytes);
+
+    CapturedCommandList commands(m_commandList.Get(), m_capture);
+    for (UINT i = 0; i < subresourceCount; ++i)
+    {
+        const CD3DX12_TEXTURE_COPY_LOCATION dest(m_texture.Get(), i);
+        const CD3DX12_TEXTURE_COPY_LOCATION source(uploadHeap.Get(), layouts[i]);
+        commands.CopyTextureRegion(dest, source);
+    }
+
+    return true;
+}
+
+// Creates m_texture from a KTX2 file and records its upload, and sets key to its cache key. RGBA8
+// texels are block compressed into m_textureBlockFormat. When the cache already holds the
+// texture, m_texture and m_textureHandle are set from it and nothing is encoded or uploaded.
+void D3D12HelloTexture::LoadTextureFromKtx2(const Ktx2Texture& file, ComPtr<ID3D12Resource>& uploadHeap, ResourceKey& key)
+{
+    // D3D12 wants the top level of a block compressed texture to be whole blocks.
+    // BC 텍스쳐의 최상위 레벨은 블록 단위 크기여야 한다.
+    if (file.GetWidth() % BlockDimension != 0 || file.GetHeight() % BlockDimension != 0)
+    {
+        throw std::runtime_error("KTX2 texture width and height must be multiples of 4.");
+    }
+
+    const UINT32 format = file.GetDxgiFormat(m_textureBlockFormat);
+    std::vector<SubresourceFootprint> packedLayouts;
+    const UINT64 payloadSize = ComputeCopyableFootprints(format, file.GetWidth(), file.GetHeight(), 1, file.GetMipLevels(), packedLayouts);
+
+    // The key is the file's bytes plus the format they are encoded into, so a texture already on
+    // the GPU is found before anything is encoded.
+    // 파일 내용과 인코딩할 포맷으로 키를 만들어, 이미 올라간 텍스쳐는 인코딩하기 전에 찾는다.
+    key.ContentHash = file.HashFileContent();
+    key.ContentSize = payloadSize;
+    key.Format = format;
+    key.Width = file.GetWidth();
+    key.Height = file.GetHeight();
+    key.DepthOrArraySize = 1;
+    key.MipLevels = file.GetMipLevels();
+    m_textureHandle = m_resourceCache->Acquire(key);
+    if (m_textureHandle != InvalidResource)
+    {
+        m_texture = m_resourceCache->GetResource(m_textureHandle);
+        return;
+    }
 
-    // Wait until the fence has been processed.
-    // fence    
-    ThrowIfFailed(m_fence->SetEventOnCompletion(m_fenceValue[m_frameIndex], m_fenceEvent));
-    WaitForSingleObjectEx(m_fenceEvent, INFINITE, FALSE);
+    const D3D12_RESOURCE_DESC textureDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+        static_cast<DXGI_FORMAT>(format), file.GetWidth(), file.GetHeight(), 1, file.GetMipLevels());
+
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+        D3D12_HEAP_FLAG_NONE,
+        &textureDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        nullptr,
+        IID_PPV_ARGS(&m_texture)));
+    RegisterResource(m_texture.Get(), MemoryTag(MemoryCategory::Textures, "ktx2 texture"));
+
+    // Read writes each level at the offset and row pitch ComputeCopyableFootprints gives; make
+    // sure this device agrees.
+    // Read 가 쓰는 레벨 배치가 이 장치의 배치와 같은지 확인한다.
+    const UINT subresourceCount = file.GetMipLevels();
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(subresourceCount);
+    UINT64 totalBytes = 0;
+    m_device->GetCopyableFootprints(&textureDesc, 0, subresourceCount, 0, layouts.data(), nullptr, nullptr, &totalBytes);
+    for (UINT i = 0; i < subresourceCount; ++i)
+    {
+        if (layouts[i].Offset != packedLayouts[i].Offset || layouts[i].Footprint.RowPitch != packedLayouts[i].RowPitch)
+        {
+            throw std::runtime_error("KTX2 texture layout does not match the device.");
+        }
+    }
 
-    //  ӿ ϴ m_fenceValue  Ų.
-    m_fenceValue[m_frameIndex]++;
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(totalBytes > payloadSize ? totalBytes : payloadSize),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&uploadHeap)));
+    RegisterResource(uploadHeap.Get(), MemoryTag(MemoryCategory::Upload, "texture upload heap"));
+
+    // Rows of blocks of every level are encoded in parallel directly into the upload heap.
+    // 모든 레벨의 블록 행들을 병렬로 업로드 힙에 바로 인코딩한다.
+    UINT8* pUploadData;
+    CD3DX12_RANGE readRange(0, 0);
+    ThrowIfFailed(uploadHeap->Map(0, &readRange, reinterpret_cast<void**>(&pUploadData)));
+    file.Read(m_textureBlockFormat, packedLayouts.data(), pUploadData, &m_threadPool);
+    m_capture.CaptureBufferWrite(uploadHeap.Get(), 0, pUploadData, static_cast<size_t>(totalBytes));
+    uploadHeap->Unmap(0, nullptr);
+    m_uploadBytesMetric->Add(totalBytes);
+
+    CapturedCommandList commands(m_commandList.Get(), m_capture);
+    for (UINT i = 0; i < subresourceCount; ++i)
+    {
+        const CD3DX12_TEXTURE_COPY_LOCATION dest(m_texture.Get(), i);
+        const CD3DX12_TEXTURE_COPY_LOCATION source(uploadHeap.Get(), layouts[i]);
+        commands.CopyTextureRegion(dest, source);
+    }
+}
+
+
+// Update frame-based values.
+void D3D12HelloTexture::OnUpdate()
+{
+    // The replay has ended and the window is closing: no more frames.
+    // 재생이 끝나 창이 닫히는 중이므로 프레임을 더 만들지 않는다.
+    if (m_replayFinished)
+    {
+        return;
+    }
+
+    // The slot's fence was already waited for in MoveToNextFrame, so this never blocks.
+    LinearArena& frameArena = m_frameArenas->BeginFrame();
+    m_capture.BeginFrame(frameArena, static_cast<UINT32>(m_frameNumber), m_frameIndex);
+    if (m_replayReader)
+    {
+        // 재생 중에는 기록된 커맨드가 프레임을 만든다.
+        return;
+    }
+    UpdateRenderResolution();
+
+    const auto now = std::chrono::steady_clock::now();
+    // A fixed timestep (benchmark mode) makes every run simulate exactly the same frames.
+    // 고정 시간 간격이 지정되면 측정한 시간 대신 그 값을 쓴다.
+    const float deltaSeconds = m_fixedTimestep > 0.0f ? m_fixedTimestep : std::chrono::duration<float>(now - m_lastUpdateTime).count();
+    m_lastUpdateTime = now;
+
+    // Animate every object and write its constants straight into the mapped upload heap.
+    // MoveToNextFrame has already waited for the GPU to finish with this frame's slots.
+    // 오브젝트들을 애니메이션하고 상수를 매핑된 업로드 힙에 바로 쓴다.
+    // 현재 프레임의 영역은 MoveToNextFrame 에서 GPU 가 다 쓴 것을 확인했으므로 덮어써도 안전하다.
+    const XMMATRIX viewProjection = GetViewProjection();
+    ObjectConstants* pFrameConstants = m_pObjectConstants + m_frameIndex * m_transforms.GetObjectCount();
+    m_transforms.Update(deltaSeconds, viewProjection, pFrameConstants, &m_threadPool);
+    m_capture.CaptureBufferWrite(m_objectConstantBuffer.Get(), static_cast<UINT32>(m_frameIndex * m_transforms.GetObjectCount() * sizeof(ObjectConstants)),
+        pFrameConstants, m_transforms.GetObjectCount() * sizeof(ObjectConstants));
+    m_uploadBytesMetric->Add(static_cast<UINT64>(m_transforms.GetObjectCount()) * sizeof(ObjectConstants));
+
+    // Pick the LOD of every object from its new bounds, at the viewport size this frame is
+    // rendered at. The world box gives the bounding sphere; the objects' scale is uniform, so the
+    // length of a world matrix row is the scale of the level errors.
+    // 새 바운드와 이번 프레임의 렌더 해상도로 오브젝트마다 그릴 LOD 를 고른다.
+    for (UINT object = 0; object < m_lodSelector.GetInstanceCount(); ++object)
+    {
+        const XMFLOAT3& extents = m_transforms.GetWorldExtents(object);
+        const float radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&extents)));
+        const XMFLOAT4X4& world = m_transforms.GetWorld(object);
+        const float scale = XMVectorGetX(XMVector3Length(XMVectorSet(world._11, world._12, world._13, 0.0f)));
+        m_lodSelector.SetInstanceBounds(object, &m_transforms.GetWorldCenter(object).x, radius, scale);
+    }
+    const float eye[3] = { m_eyePosition.x, m_eyePosition.y, m_eyePosition.z };
+    m_lodSelector.SetCamera(eye, m_fieldOfView, m_viewport.Height);
+    m_lodSelector.Update(&m_threadPool);
+
+    // Move the occluders with their objects and start the occlusion depth buffer. It is rasterized
+    // on the pool while the rest of the frame is prepared, and waited for just before the test.
+    // 오클루더를 이번 프레임의 위치로 옮기고, 프레임의 나머지를 준비하는 동안 깊이 버퍼를 그린다.
+    if (!m_meshLods.Levels.empty())
+    {
+        const LodLevel& coarsest = m_meshLods.Levels.back();
+        m_occlusion.ClearOccluders();
+        for (UINT object = 0; object < m_transforms.GetObjectCount(); ++object)
+        {
+            OccluderMesh occluder = { m_meshVertices[0].Position, sizeof(MeshVertex), static_cast<uint32_t>(m_meshVertices.size()),
+                m_meshLods.Indices.data() + coarsest.IndexOffset, coarsest.IndexCount, {} };
+            memcpy(occluder.World, &m_transforms.GetWorld(object).m[0][0], sizeof(occluder.World));
+            m_occlusion.AddOccluder(occluder);
+        }
+    }
+    XMFLOAT4X4 viewProjectionValues;
+    XMStoreFloat4x4(&viewProjectionValues, viewProjection);
+    m_occlusion.BeginFrame(&viewProjectionValues.m[0][0]);
+
+    // 텍스쳐 애니메이션은 CPU 이미지만 바꾸고, 업로드는 PopulateCommandList 에서 한다.
+    if (m_textureDirtyRegions)
+    {
+        AnimateTexture(deltaSeconds);
+    }
+    if (!m_sprites.empty())
+    {
+        BatchSprites(deltaSeconds);
+    }
+
+    // Refit the culling hierarchy with the new bounds and collect what is inside the frustum.
+    // 새 바운드로 BVH 를 갱신하고 절두체 안에 있는 오브젝트만 모은다.
+    for (UINT object = 0; object < m_transforms.GetObjectCount(); ++object)
+    {
+        m_culler.SetBounds(object, &m_transforms.GetWorldCenter(object).x, &m_transforms.GetWorldExtents(object).x);
+    }
+
+    FrustumPlanes frustum;
+    ExtractFrustumPlanes(&viewProjectionValues.m[0][0], frustum);
+    m_culler.Cull(frustum, m_visibleObjects, &m_threadPool);
+
+    // Drop what is hidden behind the occluders.
+    // 가려진 오브젝트를 제외한다.
+    m_occlusion.EndFrame(&viewProjectionValues.m[0][0]);
+    m_occlusion.FilterVisible(m_visibleObjects, &m_transforms.GetWorldCenter(0).x, &m_transforms.GetWorldExtents(0).x, sizeof(XMFLOAT3));
+}
+
+// Applies the scale picked by the dynamic resolution controller to the scene viewport.
+// 컨트롤러가 고른 배율을 씬 뷰포트에 적용한다. 이후의 LOD 선택도 이 해상도를 기준으로 한다.
+void D3D12HelloTexture::UpdateRenderResolution()
+{
+    m_renderScale = m_dynamicResolution ? m_resolution.GetScale() : 1.0f;
+
+    UINT width;
+    UINT height;
+    DynamicResolutionController::GetRenderSize(m_renderScale, m_width, m_height, width, height);
+    width = min(width, m_sceneTargetWidth);
+    height = min(height, m_sceneTargetHeight);
+
+    m_viewport = CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+    m_scissorRect = CD3DX12_RECT(0, 0, static_cast<LONG>(width), static_cast<LONG>(height));
+}
+
+XMMATRIX D3D12HelloTexture::GetViewProjection() const
+{
+    const XMMATRIX view = XMMatrixLookAtLH(XMLoadFloat3(&m_eyePosition), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const XMMATRIX projection = XMMatrixPerspectiveFovLH(m_fieldOfView, m_aspectRatio, 0.1f, 100.0f);
+    return XMMatrixMultiply(view, projection);
+}
+
+// Render the scene.
+void D3D12HelloTexture::OnRender()
+{
+    if (m_replayFinished)
+    {
+        return;
+    }
+    if (m_replayReader)
+    {
+        if (!ReplayFrame())
+        {
+            // Every captured frame ran. The frame OnUpdate began is closed, and the window asked to
+            // close once; the render thread may run a few more frames before it stops, and they
+            // are skipped from OnUpdate on.
+            // 기록된 프레임을 모두 재생했다. 시작된 프레임을 닫고 창 닫기는 한 번만 요청한다.
+            m_replayFinished = true;
+            m_capture.EndFrame();
+            m_frameArenas->EndFrame(m_directTimeline->Signal());
+            PostMessage(Win32Application::GetHwnd(), WM_CLOSE, 0, 0);
+            return;
+        }
+        m_capture.EndFrame();
+        MoveToNextFrame();
+        EndBenchmarkFrame();
+        UpdateMetrics();
+        return;
+    }
+
+    // Record all the commands we need to render the scene into the command list.
+    // 장면을 렌더링 하는 데에 필요한 모든 커맨드를 기록한다.
+    PopulateCommandList();
+
+    // Execute the command list.
+    ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
+    m_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+    m_capture.CaptureExecute(m_commandList.Get());
+
+    // Present the frame. Benchmarks run unthrottled so the numbers measure the work, not vsync.
+    // 벤치마크 중에는 수직 동기화를 끄고 Present 한다.
+    const UINT syncInterval = m_benchmarkMode ? 0 : 1;
+    const auto presentStart = std::chrono::steady_clock::now();
+    ThrowIfFailed(m_swapChain->Present(syncInterval, 0));
+    m_presentMetric->Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - presentStart).count());
+    m_capture.CapturePresent(syncInterval);
+    m_capture.EndFrame();
+
+    // 이전 프레임의 GPU 작업이 다 끝났는지 기다린 후에
+    // 다음 프레임의 CPU 계산으로 넘어가는 함수.
+    MoveToNextFrame();
+
+    EndBenchmarkFrame();
+    UpdateMetrics();
+}
+
+// Resizes the back buffers to the window, between two frames on the render thread. The scene
+// keeps its size and the upscale pass stretches it over the new buffers. Captures and replays
+// keep theirs, which are objects of the capture: DXGI scales them to the window instead.
+// 렌더 스레드에서 프레임 사이에 백 버퍼를 창 크기로 바꾼다. 씬의 크기는 그대로이고 업스케일
+// 패스가 새 버퍼에 맞춰 늘린다. 캡처와 재생 중에는 백 버퍼를 유지한다.
+void D3D12HelloTexture::OnSizeChanged(UINT width, UINT height)
+{
+    const bool minimized = width == 0 || height == 0;
+    if (minimized || (width == m_outputWidth && height == m_outputHeight) || m_capture.IsCapturing() || m_replayBackend)
+    {
+        return;
+    }
+
+    // ResizeBuffers needs every reference to the buffers gone, the GPU's included.
+    // 백 버퍼에 대한 참조가 GPU 의 것까지 모두 없어야 크기를 바꿀 수 있다.
+    WaitForGPU();
+    for (UINT n = 0; n < m_frameCount; n++)
+    {
+        m_renderTargets[n].Reset();
+    }
+    ThrowIfFailed(m_swapChain->ResizeBuffers(m_frameCount, width, height, DXGI_FORMAT_UNKNOWN, 0));
+    CreateBackBufferViews();
+
+    m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
+    m_outputWidth = width;
+    m_outputHeight = height;
+}
+
+
+void D3D12HelloTexture::OnDestroy()
+{
+    // Ensure that the GPU is no longer referencing resources that are about to be
+    // cleaned up by the destructor.
+    // GPU 가 소멸자가 정리하려고 하는 리소스를 참조하지 않도록 이전 프레임이 끝날 때까지 대기한다.
+    // OnDestroy also runs after a frame threw. When that was a lost device, the queue can't signal
+    // any more and nothing it holds will run, so there is nothing to wait for.
+    // 장치가 제거된 뒤라면 큐가 signal 할 수 없고 남은 작업도 실행되지 않으므로 기다리지 않는다.
+    if (m_device->GetDeviceRemovedReason() == S_OK)
+    {
+        WaitForGPU();
+    }
+    m_releaseQueue.Collect();
+
+    // The last frame's packets are in its arena: write them out before the arenas go.
+    m_capture.Close();
+
+    m_objectConstantBuffer->Unmap(0, nullptr);
+    m_pObjectConstants = nullptr;
+    if (m_textureUpdateBuffer)
+    {
+        m_textureUpdateBuffer->Unmap(0, nullptr);
+        m_pTextureUpdateData = nullptr;
+    }
+    if (m_spriteVertexBuffer)
+    {
+        m_spriteVertexBuffer->Unmap(0, nullptr);
+        m_pSpriteVertices = nullptr;
+    }
+
+    // Release what the app owns, so that anything still tracked afterwards is a leak, and write
+    // the memory report to the debugger output.
+    // 앱이 가진 메모리를 해제한 뒤에도 추적 중인 할당은 누수로 보고한다.
+    m_frameArenas.reset();
+    m_pipelineCompiler.reset();
+    m_resourceCache.reset();
+    m_vertexBuffer.Reset();
+    m_indexBuffer.Reset();
+    m_texture.Reset();
+    for (UINT page = 0; page < MaxAtlasPages; ++page)
+    {
+        m_atlasPages[page].Reset();
+    }
+    m_textureUpdateBuffer.Reset();
+    m_spriteIndexBuffer.Reset();
+    m_spriteVertexBuffer.Reset();
+    m_objectConstantBuffer.Reset();
+    m_sceneTarget.Reset();
+    m_timestampReadback.Reset();
+    m_rtvHeap.Reset();
+    m_srvHeap.Reset();
+
+    std::ostringstream report;
+    GetMemoryTracker().WriteLeakReport(report);
+    OutputDebugStringA(report.str().c_str());
+}
+
+
+void D3D12HelloTexture::PopulateCommandList()
+{
+    // Command list allocators can only be reset when the associated 
+    // command lists have finished execution on the GPU; apps should use 
+    // fences to determine GPU execution progress.
+    // Command list allocator 는 관련 커맨드 리스트가
+    // GPU 에서 실행을 완료한 경우에면 재설정 될 수 있다.
+    // 그러므로 프레임 버퍼링을 위해선 commandAllocator 두 개가 필요하다.
+    // 앱은 fence 를 사용하여 GPU 실행 진행 상황을 확인해야 한다.
+    ThrowIfFailed(m_commandAllocator[m_frameIndex]->Reset());
+
+    // However, when ExecuteCommandList() is called on a particular command 
+    // list, that command list can then be reset at any time and must be before 
+    // re-recording.
+    // ExecuteCommandList() 가 특정 커맨드 리스트에서 실행되면
+    // 해당 커맨드 리스트를 언제든지 다시 설정할 수 있으며, 다시 기록해야 한다.
+    ResolvePipelines();
+    CapturedCommandList commands(m_commandList.Get(), m_capture);
+    commands.Reset(m_commandAllocator[m_frameIndex].Get(), m_pipelineState.Get());
+
+    // 이 프레임의 GPU 시작 시각을 기록한다.
+    commands.EndQuery(m_timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, m_frameIndex * 2);
+
+    // 애니메이션되는 텍스쳐의 바뀐 영역을 그리기 전에 복사한다.
+    if (m_textureDirtyRegions)
+    {
+        UploadTextureChanges(commands);
+    }
+
+    // Set necessary state.
+    // 커맨드 리스트에 필요한 상태들을 설정한다.
+    commands.SetGraphicsRootSignature(m_rootSignature.Get());
+
+    ID3D12DescriptorHeap* ppHeaps[] = { m_srvHeap.Get() };
+    commands.SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+
+    commands.SetGraphicsRootDescriptorTable(0, m_srvHeap->GetGPUDescriptorHandleForHeapStart());
+    // 바인딩 할 뷰포트의 수, 뷰포트의 구조체의 배열
+    commands.RSSetViewport(m_viewport);
+    commands.RSSetScissorRect(m_scissorRect);
+
+    // The scene is drawn at the render scale into the scene target; the back buffer is only
+    // written by the upscale pass below.
+    // 씬은 렌더 배율 크기로 씬 타겟에 그린다. 백 버퍼는 아래의 업스케일 패스에서만 쓴다.
+    // 렌더링에 사용될 렌더 타겟과, 뎁스 스텐실을 파이프라인에 묶는다
+    const CD3DX12_CPU_DESCRIPTOR_HANDLE sceneRtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart(), m_frameCount, m_rtvDescriptorSize);
+    // 렌더 타겟의 개수, 렌더 타겟의 포인터, 렌더 타겟이 디스크립터에 연속적으로 저장되어 있다면 true, 뎁스 스텐실 뷰
+    commands.OMSetRenderTarget(sceneRtvHandle);
+    m_frameScale[m_frameIndex] = m_renderScale;
+
+
+    // Record commands.
+    // 커맨드 기록
+    // 렌더 타겟 색상 클리어. 그려질 영역만 지운다.
+    commands.ClearRenderTargetView(sceneRtvHandle, SceneClearColor, &m_scissorRect);
+    // 기본도형 위상구조 설정.
+    commands.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    // 시작 슬롯, 정점 버퍼의 개수, 버퍼의 첫 원소를 가리키는 포인터
+    commands.IASetVertexBuffer(0, m_vertexBufferView);
+    if (m_meshIndexCount > 0)
+    {
+        commands.IASetIndexBuffer(m_indexBufferView);
+    }
+
+    // Only the objects that survived culling in OnUpdate are drawn, once their pipeline is ready.
+    // OnUpdate 에서 컬링을 통과한 오브젝트만 그린다. 파이프라인이 아직 컴파일 중이면 건너뛴다.
+    if (m_pipelineState)
+    {
+        for (UINT object : m_visibleObjects)
+        {
+            commands.SetGraphicsRootConstantBufferView(1, GetObjectConstantsAddress(object));
+            if (m_meshIndexCount > 0)
+            {
+                // The level picked in OnUpdate, a range of the shared index buffer.
+                // 메시는 OnUpdate 에서 고른 LOD 의 인덱스 범위로 그린다.
+                const LodLevel& level = m_lodSelector.GetSelectedLevel(object);
+                commands.DrawIndexedInstanced(level.IndexCount, 1, level.IndexOffset, 0, 0);
+            }
+            else
+            {
+                // 인덱스가 없는 정점들을 그린다.
+                // 인덱스 버퍼가 있다면 drawIndexedinstnaced 함수를 써야 한다.
+                // 정점의 개수, 인스턴스의 개수, 최초의 정점 인덱스, 버텍스 버퍼에서 인스턴스 당 데이터를 읽기 전에 각 인덱스에 추가된 값
+                commands.DrawInstanced(3, 1, 0, 0);
+            }
+        }
+    }
+
+    // 스프라이트는 씬 위에 그린다. 파이프라인이 준비되기 전에는 건너뛴다.
+    if (!m_sprites.empty() && m_spritePipelineState)
+    {
+        DrawSprites(commands);
+    }
+
+    // Upscale: the scene target becomes a shader resource and the back buffer a render target.
+    // 씬 타겟은 셰이더 리소스로, 백 버퍼는 렌더 타겟으로 전환한다.
+    {
+        const D3D12_RESOURCE_BARRIER barriers[] =
+        {
+            CD3DX12_RESOURCE_BARRIER::Transition(m_sceneTarget.Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+            CD3DX12_RESOURCE_BARRIER::Transition(m_renderTargets[m_frameIndex].Get(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET),
+        };
+        commands.ResourceBarrier(_countof(barriers), barriers);
+    }
+
+    const CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart(), m_frameIndex, m_rtvDescriptorSize);
+    commands.OMSetRenderTarget(rtvHandle);
+
+    const CD3DX12_VIEWPORT outputViewport(0.0f, 0.0f, static_cast<float>(m_outputWidth), static_cast<float>(m_outputHeight));
+    const CD3DX12_RECT outputScissorRect(0, 0, static_cast<LONG>(m_outputWidth), static_cast<LONG>(m_outputHeight));
+    commands.RSSetViewport(outputViewport);
+    commands.RSSetScissorRect(outputScissorRect);
+
+    // UVs of the rendered region, clamped half a texel inside so bilinear filtering never
+    // blends in texels of the unused part of the target.
+    const float targetWidth = static_cast<float>(m_sceneTargetWidth);
+    const float targetHeight = static_cast<float>(m_sceneTargetHeight);
+    const float upscaleConstants[] =
+    {
+        m_viewport.Width / targetWidth,
+        m_viewport.Height / targetHeight,
+        (m_viewport.Width - 0.5f) / targetWidth,
+        (m_viewport.Height - 0.5f) / targetHeight,
+    };
+
+    if (m_upscalePipelineState)
+    {
+        commands.SetPipelineState(m_upscalePipelineState.Get());
+        commands.SetGraphicsRootSignature(m_upscaleRootSignature.Get());
+        commands.SetGraphicsRootDescriptorTable(0, CD3DX12_GPU_DESCRIPTOR_HANDLE(m_srvHeap->GetGPUDescriptorHandleForHeapStart(), 1, m_srvDescriptorSize));
+        commands.SetGraphicsRoot32BitConstants(1, _countof(upscaleConstants), upscaleConstants, 0);
+        commands.DrawInstanced(3, 1, 0, 0);
+    }
+    else
+    {
+        // 업스케일 파이프라인이 준비될 때까지는 백 버퍼를 지우기만 한다.
+        commands.ClearRenderTargetView(rtvHandle, SceneClearColor, nullptr);
+    }
+
+    // Indicate that the back buffer will now be used to present.
+    // 백버퍼가 present 하기 위해 사용될 것임을 나타낸다. 씬 타겟은 다음 프레임을 위해 렌더 타겟으로 되돌린다.
+    {
+        const D3D12_RESOURCE_BARRIER barriers[] =
+        {
+            CD3DX12_RESOURCE_BARRIER::Transition(m_renderTargets[m_frameIndex].Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT),
+            CD3DX12_RESOURCE_BARRIER::Transition(m_sceneTarget.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET),
+        };
+        commands.ResourceBarrier(_countof(barriers), barriers);
+    }
+
+    // Record the end timestamp and copy this frame's pair to the readback buffer.
+    // 끝 시각을 기록하고 이 프레임의 타임스탬프 두 개를 리드백 버퍼로 복사한다.
+    commands.EndQuery(m_timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, m_frameIndex * 2 + 1);
+    commands.ResolveQueryData(m_timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, m_frameIndex * 2, 2, m_timestampReadback.Get(), m_frameIndex * 2 * sizeof(UINT64));
+    m_timestampFrame[m_frameIndex] = m_frameNumber + 1;
+
+    // 명령들을 모두 끝냈으므로 close 로 닫아준다.
+    commands.Close();
+}
+
+// Picks up the pipeline states that have finished compiling. Asking for one still queued moves
+// it to the front of the compile queue.
+// 컴파일이 끝난 파이프라인 상태를 가져온다.
+void D3D12HelloTexture::ResolvePipelines()
+{
+    auto resolve = [this](PipelineHandle handle, ComPtr<ID3D12PipelineState>& pipelineState, const char* name)
+    {
+        if (pipelineState)
+        {
+            return;
+        }
+        // Wait rethrows the error of a failed compile, as a synchronous compile would have thrown.
+        pipelineState = m_pipelineCompiler->GetCompiler().GetStatus(handle) == PipelineStatus::Failed ?
+            m_pipelineCompiler->Wait(handle) : m_pipelineCompiler->TryGet(handle);
+        if (pipelineState)
+        {
+            m_capture.AddObject(pipelineState.Get(), CommandObjectType::PipelineState, name);
+        }
+    };
+    resolve(m_scenePipeline, m_pipelineState, "pipeline state");
+    resolve(m_upscalePipeline, m_upscalePipelineState, "upscale pipeline state");
+    if (m_spritePipeline != InvalidPipeline)
+    {
+        resolve(m_spritePipeline, m_spritePipelineState, "sprite pipeline state");
+    }
+}
+
+// Replays the next captured frame, up to and including its Present. Returns false at the end of
+// the capture. The setup commands of the capture are skipped: this run did its own setup.
+// 기록된 다음 프레임을 Present 까지 재생한다. 캡처의 초기화 커맨드는 건너뛴다.
+bool D3D12HelloTexture::ReplayFrame()
+{
+    CommandPacket packet;
+    bool inFrame = false;
+    while (m_replayReader->Next(packet))
+    {
+        if (packet.Op == CommandOp::FrameBegin)
+        {
+            // The swap chain decides which back buffer comes next; the frames line up only if it
+            // runs through them in the order the captured run got them.
+            if (packet.Fields[1] != m_frameIndex)
+            {
+                throw std::runtime_error("Replay is out of step with the swap chain.");
+            }
+            inFrame = true;
+        }
+        if (inFrame || packet.Op == CommandOp::DefineObject)
+        {
+            m_replayBackend->Execute(packet);
+        }
+        if (inFrame && packet.Op == CommandOp::Present)
+        {
+            m_frameScale[m_frameIndex] = 1.0f;
+            m_timestampFrame[m_frameIndex] = m_frameNumber + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Tracks the memory of a resource and gives it its capture id.
+// 리소스의 메모리를 추적하고 캡처 id 를 준다.
+void D3D12HelloTexture::RegisterResource(ID3D12Resource* resource, const MemoryTag& tag)
+{
+    TrackD3D12Resource(m_device.Get(), resource, tag);
+    m_capture.AddResource(resource, tag.Name);
+}
+
+void D3D12HelloTexture::RegisterDescriptorHeap(ID3D12DescriptorHeap* heap, const MemoryTag& tag)
+{
+    TrackD3D12DescriptorHeap(m_device.Get(), heap, tag);
+    m_capture.AddDescriptorHeap(m_device.Get(), heap, tag.Name);
+}
+
+
+
+
+// GPU address of the constant buffer slot of an object for the current frame.
+// 현재 프레임에서 해당 오브젝트가 사용할 상수 버퍼 슬롯의 GPU 주소.
+D3D12_GPU_VIRTUAL_ADDRESS D3D12HelloTexture::GetObjectConstantsAddress(UINT object) const
+{
+    const UINT64 slot = static_cast<UINT64>(m_frameIndex) * m_transforms.GetObjectCount() + object;
+    return m_objectConstantBuffer->GetGPUVirtualAddress() + slot * sizeof(ObjectConstants);
+}
+
+// Wait for pending GPU work to complete.
+// GPU 의 작업이 끝날 때까지 기다림.
+void D3D12HelloTexture::WaitForGPU()
+{
+    // Schedule a Signal command in the queue and wait until the fence has been processed.
+    // commandQueue::signal 은 GPU 측에서 fence 값을 설정하는 것이고,
+    // fence::signal 은 cpu 측에서 fence 값을 설정하는 것이다.
+    // 여기서는 gpu 측에서 fence 값을 설정하고, 그 값에 도달할 때까지 대기한다.
+    m_directTimeline->Flush();
 }
 
 void D3D12HelloTexture::MoveToNextFrame()
 {
     // Schedule a Signal command in the queue.
-    //   m_fenceValue  
-    const UINT64 currentFenceValue = m_fenceValue[m_frameIndex];
-    ThrowIfFailed(m_commandQueue->Signal(m_fence.Get(), currentFenceValue));
+    // 이 프레임의 커맨드 뒤에 signal 한 값을 이 슬롯에 기억해 둔다.
+    m_frameFenceValue[m_frameIndex] = m_directTimeline->Signal();
+    m_frameArenas->EndFrame(m_frameFenceValue[m_frameIndex]);
 
     // Update the frame index.
-    //  backbuffer  index   Ѵ.
-    //   CPU ۾ ٴ ǹ̷ GPU  ۾ϴµ ʿ  Ͱ  ԷµǾٴ ̴
-    //   ӿ GPU     ٸ  frameindex  ٲ۴.
+    // 현재의 backbuffer 의 index 를 멤버변수에 저장한다.
+    // 현재 프레임의 CPU 작업이 끝났다는 의미로 GPU 가 작업하는데 필요한 렌더링 데이터가 모두 입력되었다는 뜻이다
+    // 이제 이전 프레임에 GPU 에 내린 명령이 끝났는지 기다리기 위해 frameindex 값을 바꾼다.
     m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
 
     // If the next frame is not ready to be rendered yet, wait until it is ready.
-    //   GPU ۾   ʾҴٸ  if    ȴ.
-    // GetCompletedValue Լ   m_fence ü ȿ ִ fence value  ޾ƿ,
-    // ̸  ӿ  m_fenceValue[m_frameIndex]  ϰ ִ
-    // SetEventOnCompletion   fence  Ư    ߻ؾ ϴ ̺Ʈ Ѵ.
-    // ȣ   Ѵ.
-    if (m_fence->GetCompletedValue() < m_fenceValue[m_frameIndex])
-    {
-        // GPU   ӿ Ҵ   ļ gpu  óϴ fence  ڷ  fence   Ǹ
-        // Event  true  Ǿ  ӿ  GPU  ٴ  ˷.
-        ThrowIfFailed(m_fence->SetEventOnCompletion(m_fenceValue[m_frameIndex], m_fenceEvent));
-        WaitForSingleObjectEx(m_fenceEvent, INFINITE, FALSE);
-    }
-
-    // Set the fence value for the next frame.
-    //    fence value  Ѵ. (  Ӹ 1 Ѵ)
-    m_fenceValue[m_frameIndex] = currentFenceValue + 1;
+    // 이 슬롯을 마지막으로 쓴 프레임의 GPU 작업이 아직 끝나지 않았다면 그 fence 값에 도달할 때까지 대기한다.
+    // 이미 끝났다면 바로 돌아온다.
+    // Frames that don't wait are recorded as 0 so the histogram counts every frame.
+    const auto waitStart = std::chrono::steady_clock::now();
+    m_directTimeline->Wait(m_frameFenceValue[m_frameIndex]);
+    m_fenceWaitMetric->Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart).count());
+
+    // Free what the GPU has finished with.
+    // GPU 가 다 쓴 객체들을 해제한다.
+    m_releaseQueue.Collect();
+
+    // The GPU is done with the frame that last used this index, so its timestamps are ready.
+    // 이 인덱스를 마지막으로 쓴 프레임의 GPU 작업이 끝났으므로 타임스탬프를 읽을 수 있다.
+    ReadGpuTimestamps(m_frameIndex);
+}
+
+// Reads the timestamps of the frame recorded in the given slot, if any.
+// 해당 슬롯에 기록된 프레임의 GPU 시간을 읽는다.
+void D3D12HelloTexture::ReadGpuTimestamps(UINT frameIndex)
+{
+    const UINT64 frame = m_timestampFrame[frameIndex];
+    if (frame == 0)
+    {
+        return;
+    }
+    m_timestampFrame[frameIndex] = 0;
+
+    const CD3DX12_RANGE readRange(frameIndex * 2 * sizeof(UINT64), (frameIndex * 2 + 2) * sizeof(UINT64));
+    UINT64* pTimestamps;
+    ThrowIfFailed(m_timestampReadback->Map(0, &readRange, reinterpret_cast<void**>(&pTimestamps)));
+    const UINT64 begin = pTimestamps[frameIndex * 2];
+    const UINT64 end = pTimestamps[frameIndex * 2 + 1];
+    const CD3DX12_RANGE writeRange(0, 0);
+    m_timestampReadback->Unmap(0, &writeRange);
+
+    if (end < begin)
+    {
+        return;
+    }
+    const double milliseconds = 1000.0 * static_cast<double>(end - begin) / static_cast<double>(m_timestampFrequency);
+
+    if (m_benchmarkMode && frame > m_warmupFrames && frame <= m_warmupFrames + m_benchmarkFrames)
+    {
+        m_frameStatistics.AddGpuFrame(milliseconds);
+    }
+
+    // The newest GPU time picks the scale of the frames recorded from now on.
+    // 가장 최근 GPU 시간으로 다음에 기록할 프레임들의 렌더 배율을 정한다.
+    if (m_dynamicResolution)
+    {
+        m_resolution.Update(static_cast<float>(milliseconds), m_frameScale[frameIndex]);
+    }
+}
+
+// Counts a finished frame and ends the benchmark run after its last frame.
+// 끝난 프레임을 세고, 벤치마크의 마지막 프레임이면 결과를 기록하고 종료한다.
+void D3D12HelloTexture::EndBenchmarkFrame()
+{
+    // CPU frame time is the wall time between consecutive frames, which includes waiting on the
+    // GPU and Present: it is the frame rate the user sees.
+    const auto now = std::chrono::steady_clock::now();
+    const double milliseconds = std::chrono::duration<double, std::milli>(now - m_lastFrameTime).count();
+    m_frameTimeMetric->Record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastFrameTime).count());
+    m_lastFrameTime = now;
+    ++m_frameNumber;
+
+    // The first frame has been presented: from here on the window shows the scene.
+    // 첫 프레임이 Present 되었다. 시작부터 여기까지가 첫 프레임까지의 시간이다.
+    if (m_frameNumber == 1)
+    {
+        const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(now - m_startupTime).count();
+        m_timeToFirstFrameMetric->Set(static_cast<int64_t>(microseconds));
+        if (m_benchmarkMode)
+        {
+            m_frameStatistics.SetContext("time_to_first_frame_ms", std::to_string(microseconds / 1000.0));
+        }
+    }
+
+    if (!m_benchmarkMode)
+    {
+        return;
+    }
+
+    const UINT64 lastFrame = static_cast<UINT64>(m_warmupFrames) + m_benchmarkFrames;
+    if (m_frameNumber > m_warmupFrames && m_frameNumber <= lastFrame)
+    {
+        m_frameStatistics.AddCpuFrame(milliseconds);
+    }
+
+    if (m_frameNumber == lastFrame)
+    {
+        // Collect the GPU times of the frames still in flight before reporting.
+        WaitForGPU();
+        for (UINT n = 0; n < m_frameCount; ++n)
+        {
+            ReadGpuTimestamps(n);
+        }
+
+        // 카테고리별 최대 메모리 사용량과 할당량(churn)도 결과에 남긴다.
+        for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); ++i)
+        {
+            const std::string category = GetMemoryCategoryName(static_cast<MemoryCategory>(i));
+            const MemoryCategoryStats stats = GetMemoryTracker().GetStats(static_cast<MemoryCategory>(i));
+            m_frameStatistics.SetContext("memory_" + category + "_peak_bytes", std::to_string(stats.PeakBytes));
+            m_frameStatistics.SetContext("memory_" + category + "_allocated_bytes", std::to_string(stats.AllocatedBytes));
+        }
+
+        WriteBenchmarkReport();
+        PostMessage(Win32Application::GetHwnd(), WM_CLOSE, 0, 0);
+    }
+}
+
+// Writes the benchmark summary as JSON, or as CSV when the output file ends in .csv.
+void D3D12HelloTexture::WriteBenchmarkReport()
+{
+    const std::wstring& path = m_benchmarkOutput;
+    const bool csv = path.size() >= 4 && _wcsicmp(path.c_str() + path.size() - 4, L".csv") == 0;
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Can't create the benchmark report.");
+    }
+
+    if (csv)
+    {
+        m_frameStatistics.WriteCsv(file);
+    }
+    else
+    {
+        m_frameStatistics.WriteJson(file);
+    }
+}
+
+// Takes a metrics snapshot every half second: the frame numbers go to the window title and the
+// whole snapshot to the exporter, which writes it on a worker thread.
+// 0.5 초마다 지표 스냅샷을 떠서 창 제목에 표시하고 익스포터로 내보낸다.
+void D3D12HelloTexture::UpdateMetrics()
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastMetricsSnapshot < std::chrono::milliseconds(500))
+    {
+        return;
+    }
+    m_lastMetricsSnapshot = now;
+
+    if (m_adapter)
+    {
+        DXGI_QUERY_VIDEO_MEMORY_INFO memoryInfo;
+        if (SUCCEEDED(m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &memoryInfo)))
+        {
+            m_gpuMemoryUsageMetric->Set(static_cast<int64_t>(memoryInfo.CurrentUsage));
+            m_gpuMemoryBudgetMetric->Set(static_cast<int64_t>(memoryInfo.Budget));
+        }
+    }
+
+    m_renderScaleMetric->Set(static_cast<int64_t>(m_renderScale * 100.0f + 0.5f));
+
+    for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); ++i)
+    {
+        const MemoryCategoryStats stats = GetMemoryTracker().GetStats(static_cast<MemoryCategory>(i));
+        m_memoryLiveMetric[i]->Set(static_cast<int64_t>(stats.LiveBytes));
+        m_memoryPeakMetric[i]->Set(static_cast<int64_t>(stats.PeakBytes));
+    }
+
+    const MetricsSnapshot snapshot = m_metrics.Snapshot();
+    const HistogramSummary* frameTime = snapshot.FindHistogram("frame_time_ns");
+    const HistogramSummary* fenceWait = snapshot.FindHistogram("fence_wait_ns");
+    const HistogramSummary* present = snapshot.FindHistogram("present_ns");
+
+    WCHAR text[128];
+    swprintf_s(text, L"%.2f ms (p99 %.2f) | fence %.2f ms | present %.2f ms | scale %u%%",
+        frameTime->P50 * 1e-6, frameTime->P99 * 1e-6, fenceWait->Mean * 1e-6, present->Mean * 1e-6, static_cast<UINT>(m_renderScale * 100.0f + 0.5f));
+    SetCustomWindowText(text);
+
+    if (m_metricsExporter.IsOpen())
+    {
+        m_threadPool.Submit([this, snapshot]() { m_metricsExporter.Export(snapshot); });
+    }
 }
\ No newline at end of file
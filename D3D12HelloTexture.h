@@ -1,7 +1,34 @@
 #pragma once
 
 
+#include "AssetArchive.h"
+#include "D3D12CommandCapture.h"
+#include "D3D12MemoryTracking.h"
+#include "D3D12PipelineCompiler.h"
+#include "D3D12PipelineLayout.h"
+#include "D3D12ResourceCache.h"
+#include "D3D12TimelineFence.h"
+#include "DirtyRegions.h"
 #include "DXSample.h"
+#include "DynamicResolution.h"
+#include "FrameAllocators.h"
+#include "FrameStatistics.h"
+#include "FrustumCuller.h"
+#include "Ktx2Texture.h"
+#include "LodSelector.h"
+#include "MeshImporter.h"
+#include "MetricsRegistry.h"
+#include "OcclusionCuller.h"
+#include "PixelConversion.h"
+#include "SpriteBatch.h"
+#include "TaskGraph.h"
+#include "TextureAtlas.h"
+#include "TextureSwizzle.h"
+#include "ThreadPool.h"
+#include "TransformSystem.h"
+
+#include <chrono>
+#include <memory>
 
 using namespace DirectX;
 
@@ -10,6 +37,8 @@ using namespace DirectX;
 // for the GPU lifetime of resources to avoid destroying objects that may still be
 // referenced by the GPU.
 // An example of this can be found in the class method: OnDestroy().
+// Resources dropped while the app runs go through m_releaseQueue, which holds them until the
+// GPU has passed their last use.
 using Microsoft::WRL::ComPtr;
 
 class D3D12HelloTexture : public DXSample
@@ -21,13 +50,17 @@ public:
     virtual void OnUpdate();
     virtual void OnRender();
     virtual void OnDestroy();
+    virtual void OnSizeChanged(UINT width, UINT height);
 
 private:
-    // üο   Ÿ( ) .  ΰ .
-    static const UINT FrameCount = 2;
+    // 스왑체인에 쓰일 렌더 타겟(백 버퍼)의 최대 개수. 실제 개수는 m_frameCount (기본 2).
+    static const UINT MaxFrameCount = 3;
     static const UINT TextureWidth = 256;
     static const UINT TextureHeight = 256;
     static const UINT TexturePixelSize = 4;    // The number of bytes used to represent a pixel in the texture.
+    static const size_t MaxTextureUpdateRects = 8;  // Copies per frame for the animated texture.
+    static const UINT AtlasPageSize = 1024;
+    static const UINT MaxAtlasPages = 4;            // Atlas page SRVs follow the scene target's in m_srvHeap.
 
 
     struct Vertex
@@ -41,13 +74,14 @@ private:
     CD3DX12_RECT m_scissorRect;
     ComPtr<IDXGISwapChain3> m_swapChain;
     ComPtr<ID3D12Device> m_device;
-    ComPtr<ID3D12Resource> m_renderTargets[FrameCount];
+    ComPtr<IDXGIAdapter3> m_adapter;        // For the video memory metrics; null if unsupported.
+    ComPtr<ID3D12Resource> m_renderTargets[MaxFrameCount];
 
-    // Command list allocator   Ŀǵ Ʈ
-    // GPU   Ϸ 쿡 缳   ִ.
-    //  fence  Ͽ GPU   Ȳ Ȯؾ Ѵ.
-    // ׷Ƿ 2  ۸ ϴ ϴ   2 ʿϴ.
-    ComPtr<ID3D12CommandAllocator> m_commandAllocator[2];
+    // Command list allocator 는 관련 커맨드 리스트가
+    // GPU 에서 실행을 완료한 경우에면 재설정 될 수 있다.
+    // 앱은 fence 를 사용하여 GPU 실행 진행 상황을 확인해야 한다.
+    // 그러므로 프레임 버퍼링 개수만큼 필요하다.
+    ComPtr<ID3D12CommandAllocator> m_commandAllocator[MaxFrameCount];
     ComPtr<ID3D12CommandQueue> m_commandQueue;
     ComPtr<ID3D12RootSignature> m_rootSignature;
     ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
@@ -55,25 +89,249 @@ private:
     ComPtr<ID3D12PipelineState> m_pipelineState;
     ComPtr<ID3D12GraphicsCommandList> m_commandList;
     UINT m_rtvDescriptorSize;
+    UINT m_srvDescriptorSize;
+
+    // Adapter architecture. On UMA adapters textures are created in CPU-visible memory and
+    // written in place (CreateTextureInPlace), skipping the upload heap and the GPU copy.
+    // UMA 어댑터에서는 텍스쳐를 업로드 힙과 GPU 복사 없이 CPU 가 제자리에 쓴다.
+    bool m_uma;
+    bool m_cacheCoherentUma;
+    bool m_standardSwizzle64KB;
+    bool m_standardSwizzleChecked;              // The first swizzled texture was read back and compared.
+
+    // Dynamic resolution. The scene is drawn into the top left corner of m_sceneTarget, which is
+    // allocated once at the largest scale, and the upscale pass stretches that region over the
+    // back buffer. Changing the scale only changes the viewport: nothing is reallocated.
+    // 씬은 최대 배율 크기로 한 번 만든 m_sceneTarget 의 왼쪽 위 영역에 그리고,
+    // 업스케일 패스가 그 영역을 백 버퍼 전체로 늘려 그린다. 배율이 바뀌어도 뷰포트만 바뀐다.
+    ComPtr<ID3D12Resource> m_sceneTarget;
+    ComPtr<ID3D12RootSignature> m_upscaleRootSignature;
+    ComPtr<ID3D12PipelineState> m_upscalePipelineState;
+    UINT m_sceneTargetWidth;
+    UINT m_sceneTargetHeight;
+    // The back buffers' size, which follows the window's. The scene keeps m_width x m_height.
+    // 백 버퍼 크기는 창 크기를 따르고, 씬은 시작할 때의 크기를 유지한다.
+    UINT m_outputWidth;
+    UINT m_outputHeight;
+    DynamicResolutionController m_resolution;
+    float m_renderScale;                        // Scale of the frame being recorded.
+    float m_frameScale[MaxFrameCount];          // Scale each timestamp slot was rendered at.
 
     // App resources.
     ComPtr<ID3D12Resource> m_vertexBuffer;
     D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView;
     ComPtr<ID3D12Resource> m_texture;
 
+    // Mesh (-mesh <file.obj>): imported into default heap vertex and index buffers, drawn by every
+    // object in place of the triangle. The index buffer holds every level of m_meshLods, and each
+    // object draws the level m_lodSelector picked for it. m_meshIndexCount is 0 without a mesh.
+    // 메시는 기본 힙의 정점/인덱스 버퍼로 올리고, 모든 오브젝트가 삼각형 대신 그린다.
+    // 인덱스 버퍼에는 모든 LOD 가 들어 있고, 오브젝트마다 고른 LOD 를 그린다.
+    ComPtr<ID3D12Resource> m_indexBuffer;
+    D3D12_INDEX_BUFFER_VIEW m_indexBufferView;
+    UINT m_meshIndexCount;
+    LodChain m_meshLods;
+    std::vector<MeshVertex> m_meshVertices;     // Read by BuildMeshLods; the occluders' positions.
+
+    // Animated texture (-animatetexture). The CPU keeps the image, with the moving square drawn
+    // over the checkerboard, and the regions changed since the last upload; only those are copied,
+    // through an upload buffer that stays mapped, with a part per frame in flight.
+    // 움직이는 사각형을 그린 텍스쳐 이미지를 CPU 에 두고, 바뀐 영역만 업로드 버퍼를 거쳐 복사한다.
+    std::vector<UINT8> m_textureImage;
+    std::vector<UINT8> m_textureBackground;     // The checkerboard alone, to erase the square.
+    std::unique_ptr<DirtyRegionTracker> m_textureDirtyRegions;
+    std::vector<DirtyRect> m_textureUpdateRects;
+    DirtyRect m_animatedSquare;
+    float m_animationTime;
+    ComPtr<ID3D12Resource> m_textureUpdateBuffer;
+    UINT8* m_pTextureUpdateData;
+    UINT64 m_textureUpdateCapacity;             // Bytes per frame.
+
+    // Sprites (-sprites <count>): records spun every frame and expanded by m_spriteBatch into
+    // this frame's part of a vertex buffer that stays mapped, drawn with one shared index buffer.
+    // 스프라이트 레코드를 매 프레임 정점으로 펼쳐 매핑된 업로드 버퍼에 바로 쓰고, 공유 인덱스 버퍼로 그린다.
+    std::vector<Sprite> m_sprites;
+    std::vector<float> m_spriteSpin;            // Radians per second.
+    std::vector<UINT> m_spriteTextures;         // SRV slot of each sprite's texture; equal ones are adjacent.
+    SpriteBatch m_spriteBatch;
+    ComPtr<ID3D12RootSignature> m_spriteRootSignature;
+    ComPtr<ID3D12PipelineState> m_spritePipelineState;
+    ComPtr<ID3D12Resource> m_spriteIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW m_spriteIndexBufferView;
+    ComPtr<ID3D12Resource> m_spriteVertexBuffer;
+    SpriteVertex* m_pSpriteVertices;
+
+    // Texture atlas (-atlas <count>): the generated textures and where they were packed. Each page
+    // is a texture of its own, its SRV in slot 2 + page of m_srvHeap, so sprites of any texture on
+    // a page are one range of m_spriteBatch: one descriptor table and one draw.
+    // 생성한 텍스쳐들을 페이지에 모아, 같은 페이지의 스프라이트는 한 번에 그린다.
+    AtlasLayout m_atlasLayout;
+    ComPtr<ID3D12Resource> m_atlasPages[MaxAtlasPages];
+
+    // 오브젝트 상수 버퍼. 한 번 Map 한 뒤 앱이 끝날 때까지 매핑된 채로 둔다.
+    // 프레임마다 m_frameCount 개의 영역 중 현재 프레임의 영역에만 쓴다.
+    ComPtr<ID3D12Resource> m_objectConstantBuffer;
+    ObjectConstants* m_pObjectConstants;
+
     // Synchronization objects.
+    UINT m_frameCount;
     UINT m_frameIndex;
-    HANDLE m_fenceEvent;
-    ComPtr<ID3D12Fence> m_fence;
 
-    //  2 ۸ϹǷ fence value 2  Ѵ.
-    UINT64 m_fenceValue[2];
+    // Timeline of the direct queue. Each frame slot remembers the value signaled after the last
+    // frame that used it, and reusing the slot waits for that value only.
+    // 프레임 슬롯마다 그 슬롯을 마지막으로 쓴 프레임 뒤에 signal 한 값을 기억해 두고,
+    // 슬롯을 다시 쓸 때는 그 값만 기다린다.
+    std::unique_ptr<D3D12TimelineFence> m_directTimeline;
+    UINT64 m_frameFenceValue[MaxFrameCount];
+
+    // Objects the GPU may still be using, released once their fence value has completed, so
+    // nothing has to flush the GPU to free memory.
+    // GPU 가 아직 쓰고 있을 수 있는 객체는 fence 값이 끝난 뒤에 해제한다.
+    DeferredReleaseQueue m_releaseQueue;
+
+    // Textures and buffers shared by content: loading what is already on the GPU takes a
+    // reference instead of creating and uploading it again. Evictions go through m_releaseQueue.
+    // 내용이 같은 텍스쳐와 버퍼는 한 번만 만들고 참조를 공유한다.
+    std::unique_ptr<D3D12ResourceCache> m_resourceCache;
+    ResourceHandle m_textureHandle;
+    ResourceHandle m_vertexBufferHandle;
+
+    // CPU memory for data that lives as long as its frame, such as what the frame's commands refer
+    // to. The frame's arena is reset once the GPU has passed that frame's fence value.
+    // 프레임 동안만 필요한 CPU 메모리. GPU 가 그 프레임의 fence 값을 지나면 재사용한다.
+    std::unique_ptr<FrameArenaRing> m_frameArenas;
+
+    // Command capture and replay. Every object is registered with m_capture as it is created, in
+    // both modes, so a replaying run gives its objects the ids of the captured run. Replay runs
+    // the captured frames in place of OnUpdate and PopulateCommandList.
+    // 커맨드 캡처와 재생. 객체는 두 모드 모두에서 만들어질 때 등록하므로
+    // 재생 실행의 객체는 캡처한 실행과 같은 id 를 받는다.
+    D3D12CommandCapture m_capture;
+    std::vector<UINT8> m_replayData;
+    std::unique_ptr<CommandStreamReader> m_replayReader;
+    std::unique_ptr<D3D12ReplayBackend> m_replayBackend;
+    bool m_replayFinished;                      // Every captured frame ran; frames are skipped until the window closes.
+
+    // GPU frame timing: two timestamps per frame (start and end of the command list), resolved to
+    // a readback buffer and read once the frame's fence has completed.
+    // 프레임마다 커맨드 리스트의 시작과 끝에 타임스탬프를 기록해 GPU 시간을 잰다.
+    ComPtr<ID3D12QueryHeap> m_timestampHeap;
+    ComPtr<ID3D12Resource> m_timestampReadback;
+    UINT64 m_timestampFrequency;
+    UINT64 m_timestampFrame[MaxFrameCount];     // Frame number recorded in each slot, 0 if none.
+
+    // Benchmark run state.
+    FrameStatistics m_frameStatistics;
+    UINT64 m_frameNumber;
+    std::chrono::steady_clock::time_point m_lastFrameTime;
+    std::chrono::steady_clock::time_point m_startupTime;    // Start of OnInit, for the time to first frame.
+
+    // Camera used for per-frame visibility and LOD decisions.
+    XMFLOAT3 m_eyePosition;
+    float m_fieldOfView;
+
+    // Picks each object's mesh LOD by its error in pixels. Instance ids are object ids; there are
+    // no instances without a mesh.
+    // 화면에서의 오차(픽셀)를 기준으로 오브젝트마다 LOD 를 고른다.
+    LodSelector m_lodSelector;
+
+    // Runtime metrics. The hot paths keep the metric pointers and only touch atomics; a snapshot
+    // is taken twice a second for the window title and the exporter. Declared before the thread
+    // pool so that a pending export never outlives the exporter.
+    // 런타임 지표. 매 프레임 갱신은 원자적 연산뿐이고, 0.5 초마다 스냅샷을 떠서 창 제목과 익스포터로 보낸다.
+    MetricsRegistry m_metrics;
+    MetricsExporter m_metricsExporter;
+    MetricHistogram* m_frameTimeMetric;         // Nanoseconds.
+    MetricHistogram* m_fenceWaitMetric;         // Nanoseconds.
+    MetricHistogram* m_presentMetric;           // Nanoseconds.
+    MetricHistogram* m_spriteBatchMetric;       // Nanoseconds to expand the frame's sprites.
+    MetricCounter* m_uploadBytesMetric;
+    MetricCounter* m_psoCacheHitMetric;
+    MetricCounter* m_psoCacheMissMetric;
+    MetricCounter* m_resourceCacheHitMetric;
+    MetricCounter* m_resourceCacheMissMetric;
+    MetricCounter* m_textureUpdateBytesMetric;
+    MetricCounter* m_textureUpdateSavedMetric;  // Bytes full uploads of the animated texture would add.
+    MetricGauge* m_rtvDescriptorsMetric;
+    MetricGauge* m_srvDescriptorsMetric;
+    MetricGauge* m_gpuMemoryUsageMetric;        // Bytes of local video memory.
+    MetricGauge* m_gpuMemoryBudgetMetric;
+    MetricGauge* m_renderScaleMetric;           // Percent of the window size, per axis.
+    MetricGauge* m_textureChangedMetric;        // Percent of the animated texture uploaded last frame.
+    MetricGauge* m_timeToFirstFrameMetric;      // Microseconds from OnInit to the first Present.
+    MetricGauge* m_memoryLiveMetric[static_cast<size_t>(MemoryCategory::Count)];   // Bytes per category.
+    MetricGauge* m_memoryPeakMetric[static_cast<size_t>(MemoryCategory::Count)];
+    std::chrono::steady_clock::time_point m_lastMetricsSnapshot;
+
+    // CPU worker threads shared by the per-frame systems.
+    ThreadPool m_threadPool;
+
+    // Pipeline states compile on the pool; the members above are set once they are ready.
+    // Declared after the pool, which has to outlive it.
+    // 파이프라인 상태는 스레드 풀에서 컴파일하고, 준비되면 위의 멤버에 넣는다.
+    std::unique_ptr<D3D12PipelineCompiler> m_pipelineCompiler;
+    PipelineHandle m_scenePipeline;
+    PipelineHandle m_upscalePipeline;
+    PipelineHandle m_spritePipeline;
+    TransformSystem m_transforms;
+
+    // 커맨드 기록 전에 절두체 밖의 오브젝트를 걸러낸다.
+    // 컬러의 오브젝트 ID 는 TransformSystem 의 오브젝트 ID 와 같다.
+    FrustumCuller m_culler;
+    std::vector<UINT> m_visibleObjects;
+
+    // 절두체 컬링을 통과한 오브젝트 중 가려진 것을 CPU 깊이 버퍼로 걸러낸다.
+    // 메시 오브젝트가 오클루더이고, 래스터화는 OnUpdate 에서 프레임 준비와 겹쳐 실행한다.
+    OcclusionCuller m_occlusion;
+    UINT m_triangleObject;
+    std::chrono::steady_clock::time_point m_lastUpdateTime;
+
+    // The entry points of Shaders.HLSL, each compiled by a startup task of its own.
+    enum ShaderIndex
+    {
+        SceneVertexShader,
+        ScenePixelShader,
+        UpscaleVertexShader,
+        UpscalePixelShader,
+        SpriteVertexShader,
+        SpritePixelShader,
+        ShaderCount
+    };
 
-    void LoadPipeline();
-    void LoadAssets();
-    std::vector<UINT8> GenerateTextureData();
+    void CreateDevice(ComPtr<IDXGIFactory4>& factory);
+    void LoadPipeline(IDXGIFactory4* factory);
+    void CreateBackBufferViews();
+    void CreateRootSignatures();
+    void CompileShader(ShaderIndex shader, ComPtr<ID3DBlob>& bytecode);
+    void RequestPipelines(const ComPtr<ID3DBlob>* shaders);
+    void LoadAssets(const UINT8* checkerboard, MeshImporter* mesh, const Ktx2Texture* textureFile);
+    void ReportStartup(const TaskGraph& startup);
+    void GenerateTextureData(UINT8* pData);
+    bool CreateTextureInPlace(D3D12_RESOURCE_DESC desc, const UINT8* pixels, UINT rowPitch, const char* name);
+    bool LoadTextureFromArchive(const std::wstring& path, const char* name, ComPtr<ID3D12Resource>& uploadHeap, ResourceKey& key);
+    void LoadTextureFromKtx2(const Ktx2Texture& file, ComPtr<ID3D12Resource>& uploadHeap, ResourceKey& key);
+    void CreateTextureAnimation(const UINT8* pixels);
+    void AnimateTexture(float deltaSeconds);
+    void UploadTextureChanges(CapturedCommandList& commands);
+    void CreateAtlas(CapturedCommandList& commands, ComPtr<ID3D12Resource>& uploadHeap);
+    void BuildMeshLods(MeshImporter& importer);
+    void CreateMesh(CapturedCommandList& commands, MeshImporter& importer, ComPtr<ID3D12Resource>& indexUploadHeap, ComPtr<ID3D12Resource>& vertexUploadHeap, XMFLOAT3& center, XMFLOAT3& extents);
+    void CreateSprites();
+    void BatchSprites(float deltaSeconds);
+    void DrawSprites(CapturedCommandList& commands);
     void PopulateCommandList();
+    void ResolvePipelines();
+    bool ReplayFrame();
+    void RegisterResource(ID3D12Resource* resource, const MemoryTag& tag);
+    void RegisterDescriptorHeap(ID3D12DescriptorHeap* heap, const MemoryTag& tag);
+    D3D12_GPU_VIRTUAL_ADDRESS GetObjectConstantsAddress(UINT object) const;
+    XMMATRIX GetViewProjection() const;
+    void UpdateRenderResolution();
 
     void MoveToNextFrame();
     void WaitForGPU();
+    void ReadGpuTimestamps(UINT frameIndex);
+    void EndBenchmarkFrame();
+    void UpdateMetrics();
+    void WriteBenchmarkReport();
 };
\ No newline at end of file
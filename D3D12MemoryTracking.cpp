@@ -0,0 +1,78 @@
+#include "Stdafx.h"
+#include "D3D12MemoryTracking.h"
+
+#include <atomic>
+
+namespace
+{
+    // {6A1E2C47-93B5-4D8E-A0F2-5C7B19D4E8A3}
+    const GUID MemoryTrackingGuid = { 0x6a1e2c47, 0x93b5, 0x4d8e, { 0xa0, 0xf2, 0x5c, 0x7b, 0x19, 0xd4, 0xe8, 0xa3 } };
+
+    // Untracks its key when its last reference, held by the tracked object, is released.
+    class TrackingToken : public IUnknown
+    {
+    public:
+        explicit TrackingToken(const void* key) : m_key(key), m_references(1) {}
+
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+        {
+            if (!ppvObject)
+            {
+                return E_POINTER;
+            }
+            if (riid != __uuidof(IUnknown))
+            {
+                *ppvObject = nullptr;
+                return E_NOINTERFACE;
+            }
+            AddRef();
+            *ppvObject = static_cast<IUnknown*>(this);
+            return S_OK;
+        }
+
+        ULONG STDMETHODCALLTYPE AddRef() override
+        {
+            return ++m_references;
+        }
+
+        ULONG STDMETHODCALLTYPE Release() override
+        {
+            const ULONG references = --m_references;
+            if (references == 0)
+            {
+                GetMemoryTracker().Untrack(m_key);
+                delete this;
+            }
+            return references;
+        }
+
+    private:
+        const void* m_key;
+        std::atomic<ULONG> m_references;
+    };
+
+    void Track(ID3D12Object* object, UINT64 size, const MemoryTag& tag)
+    {
+        // The object takes its own reference to the token. Tracking an object again replaces its
+        // token, and releasing the old one untracks the old size before the new one is tracked.
+        ComPtr<TrackingToken> token;
+        token.Attach(new TrackingToken(object));
+        if (SUCCEEDED(object->SetPrivateDataInterface(MemoryTrackingGuid, token.Get())))
+        {
+            GetMemoryTracker().Track(object, size, tag);
+        }
+    }
+}
+
+void TrackD3D12Resource(ID3D12Device* device, ID3D12Resource* resource, const MemoryTag& tag)
+{
+    const D3D12_RESOURCE_DESC desc = resource->GetDesc();
+    const D3D12_RESOURCE_ALLOCATION_INFO info = device->GetResourceAllocationInfo(0, 1, &desc);
+    Track(resource, info.SizeInBytes, tag);
+}
+
+void TrackD3D12DescriptorHeap(ID3D12Device* device, ID3D12DescriptorHeap* heap, const MemoryTag& tag)
+{
+    const D3D12_DESCRIPTOR_HEAP_DESC desc = heap->GetDesc();
+    Track(heap, static_cast<UINT64>(desc.NumDescriptors) * device->GetDescriptorHandleIncrementSize(desc.Type), tag);
+}
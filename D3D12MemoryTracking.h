@@ -0,0 +1,15 @@
+#pragma once
+
+#include "DXSampleHelper.h"
+#include "MemoryTracker.h"
+
+// Reports D3D12 objects to GetMemoryTracker(). The object is untracked when it is destroyed,
+// whichever reference goes last (a ComPtr, the deferred release queue, the swap chain), through
+// a small COM object stored in its private data: the object releases it when it dies.
+// D3D12 객체를 메모리 추적기에 등록한다. 객체가 파괴될 때 자동으로 등록이 해제된다.
+
+// Tracks the allocation size the device reports for the resource's description.
+void TrackD3D12Resource(ID3D12Device* device, ID3D12Resource* resource, const MemoryTag& tag);
+
+// Tracks the descriptors of the heap, at the device's descriptor size.
+void TrackD3D12DescriptorHeap(ID3D12Device* device, ID3D12DescriptorHeap* heap, const MemoryTag& tag);
@@ -0,0 +1,202 @@
+#include "Stdafx.h"
+#include "D3D12PipelineCompiler.h"
+
+#include <cstring>
+#include <memory>
+
+namespace
+{
+    // 64-bit FNV-1a, as the asset archive uses for names.
+    class PipelineHasher
+    {
+    public:
+        PipelineHasher() : m_hash(14695981039346656037ull) {}
+
+        void AddBytes(const void* data, size_t size)
+        {
+            const UINT8* bytes = static_cast<const UINT8*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                m_hash ^= bytes[i];
+                m_hash *= 1099511628211ull;
+            }
+        }
+
+        // Fields one at a time: the description structs have padding, which holds garbage.
+        template <typename T>
+        void Add(const T& value)
+        {
+            AddBytes(&value, sizeof(value));
+        }
+
+        void AddShader(const D3D12_SHADER_BYTECODE& shader)
+        {
+            Add(shader.BytecodeLength);
+            AddBytes(shader.pShaderBytecode, shader.BytecodeLength);
+        }
+
+        UINT64 Get() const { return m_hash; }
+
+    private:
+        UINT64 m_hash;
+    };
+
+    void CopyShader(const D3D12_SHADER_BYTECODE& source, std::vector<UINT8>& storage, D3D12_SHADER_BYTECODE& dest)
+    {
+        const UINT8* bytes = static_cast<const UINT8*>(source.pShaderBytecode);
+        storage.assign(bytes, bytes + source.BytecodeLength);
+        dest.pShaderBytecode = storage.empty() ? nullptr : storage.data();
+        dest.BytecodeLength = storage.size();
+    }
+
+    void ReleasePipeline(void* pipeline)
+    {
+        static_cast<ID3D12PipelineState*>(pipeline)->Release();
+    }
+}
+
+GraphicsPipelineDesc::GraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) :
+    m_desc(desc),
+    m_rootSignature(desc.pRootSignature)
+{
+    if (desc.StreamOutput.NumEntries != 0 || desc.CachedPSO.CachedBlobSizeInBytes != 0)
+    {
+        throw std::invalid_argument("Stream output and cached pipelines can't be compiled asynchronously.");
+    }
+
+    CopyShader(desc.VS, m_shaders[0], m_desc.VS);
+    CopyShader(desc.PS, m_shaders[1], m_desc.PS);
+    CopyShader(desc.DS, m_shaders[2], m_desc.DS);
+    CopyShader(desc.HS, m_shaders[3], m_desc.HS);
+    CopyShader(desc.GS, m_shaders[4], m_desc.GS);
+
+    m_inputElements.assign(desc.InputLayout.pInputElementDescs, desc.InputLayout.pInputElementDescs + desc.InputLayout.NumElements);
+    m_semanticNames.reserve(m_inputElements.size());
+    for (D3D12_INPUT_ELEMENT_DESC& element : m_inputElements)
+    {
+        m_semanticNames.push_back(element.SemanticName);
+        element.SemanticName = m_semanticNames.back().c_str();
+    }
+    m_desc.InputLayout.pInputElementDescs = m_inputElements.empty() ? nullptr : m_inputElements.data();
+}
+
+UINT64 HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+    PipelineHasher hasher;
+    hasher.Add(desc.pRootSignature);
+    hasher.AddShader(desc.VS);
+    hasher.AddShader(desc.PS);
+    hasher.AddShader(desc.DS);
+    hasher.AddShader(desc.HS);
+    hasher.AddShader(desc.GS);
+
+    hasher.Add(desc.BlendState.AlphaToCoverageEnable);
+    hasher.Add(desc.BlendState.IndependentBlendEnable);
+    for (const D3D12_RENDER_TARGET_BLEND_DESC& blend : desc.BlendState.RenderTarget)
+    {
+        hasher.Add(blend.BlendEnable);
+        hasher.Add(blend.LogicOpEnable);
+        hasher.Add(blend.SrcBlend);
+        hasher.Add(blend.DestBlend);
+        hasher.Add(blend.BlendOp);
+        hasher.Add(blend.SrcBlendAlpha);
+        hasher.Add(blend.DestBlendAlpha);
+        hasher.Add(blend.BlendOpAlpha);
+        hasher.Add(blend.LogicOp);
+        hasher.Add(blend.RenderTargetWriteMask);
+    }
+    hasher.Add(desc.SampleMask);
+
+    const D3D12_RASTERIZER_DESC& rasterizer = desc.RasterizerState;
+    hasher.Add(rasterizer.FillMode);
+    hasher.Add(rasterizer.CullMode);
+    hasher.Add(rasterizer.FrontCounterClockwise);
+    hasher.Add(rasterizer.DepthBias);
+    hasher.Add(rasterizer.DepthBiasClamp);
+    hasher.Add(rasterizer.SlopeScaledDepthBias);
+    hasher.Add(rasterizer.DepthClipEnable);
+    hasher.Add(rasterizer.MultisampleEnable);
+    hasher.Add(rasterizer.AntialiasedLineEnable);
+    hasher.Add(rasterizer.ForcedSampleCount);
+    hasher.Add(rasterizer.ConservativeRaster);
+
+    const D3D12_DEPTH_STENCIL_DESC& depthStencil = desc.DepthStencilState;
+    hasher.Add(depthStencil.DepthEnable);
+    hasher.Add(depthStencil.DepthWriteMask);
+    hasher.Add(depthStencil.DepthFunc);
+    hasher.Add(depthStencil.StencilEnable);
+    hasher.Add(depthStencil.StencilReadMask);
+    hasher.Add(depthStencil.StencilWriteMask);
+    hasher.Add(depthStencil.FrontFace);         // Four enums, no padding.
+    hasher.Add(depthStencil.BackFace);
+
+    hasher.Add(desc.InputLayout.NumElements);
+    for (UINT i = 0; i < desc.InputLayout.NumElements; ++i)
+    {
+        const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[i];
+        hasher.AddBytes(element.SemanticName, strlen(element.SemanticName) + 1);
+        hasher.Add(element.SemanticIndex);
+        hasher.Add(element.Format);
+        hasher.Add(element.InputSlot);
+        hasher.Add(element.AlignedByteOffset);
+        hasher.Add(element.InputSlotClass);
+        hasher.Add(element.InstanceDataStepRate);
+    }
+
+    hasher.Add(desc.IBStripCutValue);
+    hasher.Add(desc.PrimitiveTopologyType);
+    hasher.Add(desc.NumRenderTargets);
+    for (UINT i = 0; i < desc.NumRenderTargets; ++i)
+    {
+        hasher.Add(desc.RTVFormats[i]);
+    }
+    hasher.Add(desc.DSVFormat);
+    hasher.Add(desc.SampleDesc.Count);
+    hasher.Add(desc.SampleDesc.Quality);
+    hasher.Add(desc.NodeMask);
+    hasher.Add(desc.Flags);
+    return hasher.Get();
+}
+
+D3D12PipelineCompiler::D3D12PipelineCompiler(ID3D12Device* device, ThreadPool& pool, uint32_t maxConcurrent) :
+    m_device(device),
+    m_compiler(pool, ReleasePipeline, maxConcurrent)
+{
+}
+
+UINT64 HashGraphicsPipelineShaders(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 layoutHash)
+{
+    PipelineHasher hasher;
+    hasher.Add(layoutHash);
+    hasher.Add(desc.pRootSignature);
+    hasher.AddShader(desc.VS);
+    hasher.AddShader(desc.PS);
+    hasher.AddShader(desc.DS);
+    hasher.AddShader(desc.HS);
+    hasher.AddShader(desc.GS);
+    return hasher.Get();
+}
+
+PipelineHandle D3D12PipelineCompiler::Request(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 firstUse, bool* merged)
+{
+    return Request(HashGraphicsPipelineDesc(desc), desc, firstUse, merged);
+}
+
+PipelineHandle D3D12PipelineCompiler::RequestWithLayoutHash(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 layoutHash, UINT64 firstUse,
+    bool* merged)
+{
+    return Request(HashGraphicsPipelineShaders(desc, layoutHash), desc, firstUse, merged);
+}
+
+PipelineHandle D3D12PipelineCompiler::Request(UINT64 key, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 firstUse, bool* merged)
+{
+    // Copied before knowing whether the request merges: requests are rare, compiles are not cheap.
+    std::shared_ptr<GraphicsPipelineDesc> copy = std::make_shared<GraphicsPipelineDesc>(desc);
+    ID3D12Device* device = m_device.Get();
+    return m_compiler.Request(key, firstUse, [device, copy]() -> void*
+    {
+        ID3D12PipelineState* pipelineState = nullptr;
+        ThrowIfFailed(device->CreateGraphicsPipelineState(&copy->Get(), IID_PPV_ARGS(&pipelineState)));
+        return pipelineState;
+    }, merged);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "DXSampleHelper.h"
+#include "PipelineCompiler.h"
+
+#include <string>
+#include <vector>
+
+// A graphics pipeline description that owns what D3D12_GRAPHICS_PIPELINE_STATE_DESC points to
+// (shader bytecode, input layout, root signature), so it can be compiled later on another thread.
+// Stream output and cached blobs are not supported.
+class GraphicsPipelineDesc
+{
+public:
+    explicit GraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+    GraphicsPipelineDesc(const GraphicsPipelineDesc&) = delete;
+    GraphicsPipelineDesc& operator=(const GraphicsPipelineDesc&) = delete;
+
+    const D3D12_GRAPHICS_PIPELINE_STATE_DESC& Get() const { return m_desc; }
+
+private:
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC m_desc;
+    std::vector<UINT8> m_shaders[5];                // VS, PS, DS, HS, GS.
+    std::vector<D3D12_INPUT_ELEMENT_DESC> m_inputElements;
+    std::vector<std::string> m_semanticNames;
+    ComPtr<ID3D12RootSignature> m_rootSignature;
+};
+
+// Hash of everything that makes two graphics pipelines different: the shader bytecode, the input
+// layout and the fixed function state. The root signature counts by identity.
+UINT64 HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+// The same, for a pipeline whose input layout and fixed function state are described by
+// layoutHash, a hash computed at compile time (see CombineLayoutHashes): only the shader bytecode
+// and the root signature's identity are hashed at run time.
+UINT64 HashGraphicsPipelineShaders(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 layoutHash);
+
+// PipelineCompiler creating D3D12 graphics pipeline states. The pipelines belong to the compiler:
+// destroy it only once the GPU is done with them.
+class D3D12PipelineCompiler
+{
+public:
+    D3D12PipelineCompiler(ID3D12Device* device, ThreadPool& pool, uint32_t maxConcurrent = 0);
+
+    // The description is copied; what it points to can be released after the call.
+    PipelineHandle Request(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 firstUse, bool* merged = nullptr);
+    // Keyed by HashGraphicsPipelineShaders: desc must be the state layoutHash describes.
+    PipelineHandle RequestWithLayoutHash(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 layoutHash, UINT64 firstUse, bool* merged = nullptr);
+
+    ID3D12PipelineState* TryGet(PipelineHandle handle) { return static_cast<ID3D12PipelineState*>(m_compiler.TryGet(handle)); }
+    ID3D12PipelineState* Wait(PipelineHandle handle) { return static_cast<ID3D12PipelineState*>(m_compiler.Wait(handle)); }
+    void WaitAll() { m_compiler.WaitAll(); }
+
+    PipelineCompiler& GetCompiler() { return m_compiler; }
+
+private:
+    PipelineHandle Request(UINT64 key, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 firstUse, bool* merged);
+
+    ComPtr<ID3D12Device> m_device;
+    PipelineCompiler m_compiler;
+};
@@ -0,0 +1,138 @@
+#include "Stdafx.h"
+#include "D3D12PipelineLayout.h"
+
+#include <cstring>
+#include <vector>
+
+// PipelineLayout.h mirrors these values so that it compiles without the Windows headers.
+static_assert(static_cast<UINT>(ShaderVisibility::Pixel) == D3D12_SHADER_VISIBILITY_PIXEL, "ShaderVisibility matches D3D12.");
+static_assert(static_cast<UINT>(ShaderVisibility::Vertex) == D3D12_SHADER_VISIBILITY_VERTEX, "ShaderVisibility matches D3D12.");
+static_assert(static_cast<UINT>(DescriptorRangeType::Srv) == D3D12_DESCRIPTOR_RANGE_TYPE_SRV, "DescriptorRangeType matches D3D12.");
+static_assert(static_cast<UINT>(DescriptorRangeType::Sampler) == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, "DescriptorRangeType matches D3D12.");
+static_assert(static_cast<UINT>(RootParameterType::Constants) == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS, "RootParameterType matches D3D12.");
+static_assert(static_cast<UINT>(RootParameterType::Uav) == D3D12_ROOT_PARAMETER_TYPE_UAV, "RootParameterType matches D3D12.");
+static_assert(static_cast<UINT>(SamplerFilter::Linear) == D3D12_FILTER_MIN_MAG_MIP_LINEAR, "SamplerFilter matches D3D12.");
+static_assert(static_cast<UINT>(SamplerFilter::Anisotropic) == D3D12_FILTER_ANISOTROPIC, "SamplerFilter matches D3D12.");
+static_assert(static_cast<UINT>(AddressMode::Border) == D3D12_TEXTURE_ADDRESS_MODE_BORDER, "AddressMode matches D3D12.");
+static_assert(static_cast<UINT>(BorderColor::OpaqueWhite) == D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE, "BorderColor matches D3D12.");
+static_assert(static_cast<UINT>(LayoutFormat::R32G32B32Float) == DXGI_FORMAT_R32G32B32_FLOAT, "LayoutFormat matches DXGI.");
+static_assert(static_cast<UINT>(LayoutFormat::R16G16Unorm) == DXGI_FORMAT_R16G16_UNORM, "LayoutFormat matches DXGI.");
+static_assert(static_cast<UINT>(LayoutFormat::R8G8B8A8Unorm) == DXGI_FORMAT_R8G8B8A8_UNORM, "LayoutFormat matches DXGI.");
+static_assert(static_cast<UINT>(CullMode::None) == D3D12_CULL_MODE_NONE, "CullMode matches D3D12.");
+static_assert(RangeDataVolatile == D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE && RangeDataStatic == D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC,
+    "Descriptor range flags match D3D12.");
+static_assert(RootDataStaticWhileSetAtExecute == D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE, "Root descriptor flags match D3D12.");
+static_assert(RootSignatureAllowInputLayout == D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT, "Root signature flags match D3D12.");
+static_assert(DescriptorRangeAppend == D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND, "The append offset matches D3D12.");
+
+namespace
+{
+    // The layout as D3D12 descriptions, serialized by D3D12 for the version given.
+    ComPtr<ID3DBlob> SerializeAtRunTime(const RootParameterLayout* parameters, size_t parameterCount, const StaticSamplerLayout* samplers,
+        size_t samplerCount, uint32_t flags, D3D_ROOT_SIGNATURE_VERSION version)
+    {
+        // Reserved up front: the parameters point into it.
+        std::vector<D3D12_DESCRIPTOR_RANGE1> ranges;
+        ranges.reserve(parameterCount * MaxTableRanges);
+        std::vector<D3D12_ROOT_PARAMETER1> rootParameters(parameterCount);
+        for (size_t i = 0; i < parameterCount; ++i)
+        {
+            const RootParameterLayout& parameter = parameters[i];
+            D3D12_ROOT_PARAMETER1& rootParameter = rootParameters[i];
+            rootParameter.ParameterType = static_cast<D3D12_ROOT_PARAMETER_TYPE>(parameter.Type);
+            rootParameter.ShaderVisibility = static_cast<D3D12_SHADER_VISIBILITY>(parameter.Visibility);
+            switch (parameter.Type)
+            {
+            case RootParameterType::DescriptorTable:
+                rootParameter.DescriptorTable.NumDescriptorRanges = parameter.RangeCount;
+                rootParameter.DescriptorTable.pDescriptorRanges = ranges.data() + ranges.size();
+                for (UINT r = 0; r < parameter.RangeCount; ++r)
+                {
+                    const DescriptorRangeLayout& range = parameter.Ranges[r];
+                    ranges.push_back({ static_cast<D3D12_DESCRIPTOR_RANGE_TYPE>(range.Type), range.Count, range.BaseRegister, range.Space,
+                        static_cast<D3D12_DESCRIPTOR_RANGE_FLAGS>(range.Flags), range.TableOffset });
+                }
+                break;
+            case RootParameterType::Constants:
+                rootParameter.Constants = { parameter.Register, parameter.Space, parameter.Values };
+                break;
+            default:
+                rootParameter.Descriptor = { parameter.Register, parameter.Space, static_cast<D3D12_ROOT_DESCRIPTOR_FLAGS>(parameter.Flags) };
+                break;
+            }
+        }
+
+        std::vector<D3D12_STATIC_SAMPLER_DESC> staticSamplers(samplerCount);
+        for (size_t i = 0; i < samplerCount; ++i)
+        {
+            const StaticSamplerLayout& sampler = samplers[i];
+            const D3D12_TEXTURE_ADDRESS_MODE address = static_cast<D3D12_TEXTURE_ADDRESS_MODE>(sampler.Address);
+            staticSamplers[i] = { static_cast<D3D12_FILTER>(sampler.Filter), address, address, address, sampler.MipLodBias, sampler.MaxAnisotropy,
+                static_cast<D3D12_COMPARISON_FUNC>(sampler.ComparisonFunc), static_cast<D3D12_STATIC_BORDER_COLOR>(sampler.Border),
+                sampler.MinLod, sampler.MaxLod, sampler.Register, sampler.Space, static_cast<D3D12_SHADER_VISIBILITY>(sampler.Visibility) };
+        }
+
+        CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC desc;
+        desc.Init_1_1(static_cast<UINT>(parameterCount), rootParameters.data(), static_cast<UINT>(samplerCount), staticSamplers.data(),
+            static_cast<D3D12_ROOT_SIGNATURE_FLAGS>(flags));
+
+        ComPtr<ID3DBlob> signature;
+        ComPtr<ID3DBlob> error;
+        ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&desc, version, &signature, &error));
+        return signature;
+    }
+}
+
+void ApplyPipelineState(const PipelineStateLayout& state, D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+    desc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+    desc.RasterizerState.CullMode = static_cast<D3D12_CULL_MODE>(state.Cull);
+    desc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+    if (state.Blend == BlendMode::AlphaBlend)
+    {
+        D3D12_RENDER_TARGET_BLEND_DESC& blend = desc.BlendState.RenderTarget[0];
+        blend.BlendEnable = TRUE;
+        blend.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+        blend.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+        blend.BlendOp = D3D12_BLEND_OP_ADD;
+        blend.SrcBlendAlpha = D3D12_BLEND_ONE;
+        blend.DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA;
+        blend.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+    }
+    desc.DepthStencilState = {};
+    desc.DepthStencilState.DepthEnable = FALSE;
+    desc.DepthStencilState.StencilEnable = FALSE;
+    desc.SampleMask = UINT_MAX;
+    desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    desc.NumRenderTargets = 1;
+    desc.RTVFormats[0] = static_cast<DXGI_FORMAT>(state.RenderTargetFormat);
+    desc.SampleDesc.Count = 1;
+    desc.SampleDesc.Quality = 0;
+}
+
+ComPtr<ID3D12RootSignature> CreatePrebakedRootSignature(ID3D12Device* device, const void* blob, size_t blobSize,
+    const RootParameterLayout* parameters, size_t parameterCount, const StaticSamplerLayout* samplers, size_t samplerCount, uint32_t flags)
+{
+    ComPtr<ID3D12RootSignature> rootSignature;
+    if (SUCCEEDED(device->CreateRootSignature(0, blob, blobSize, IID_PPV_ARGS(&rootSignature))))
+    {
+#if defined(_DEBUG)
+        const ComPtr<ID3DBlob> reference = SerializeAtRunTime(parameters, parameterCount, samplers, samplerCount, flags, D3D_ROOT_SIGNATURE_VERSION_1_1);
+        if (reference->GetBufferSize() != blobSize || memcmp(reference->GetBufferPointer(), blob, blobSize) != 0)
+        {
+            OutputDebugStringA("Prebaked root signature differs from D3D12's serialization of its layout.\n");
+        }
+#endif
+        return rootSignature;
+    }
+
+    D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+    featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+    {
+        featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+    }
+    const ComPtr<ID3DBlob> signature = SerializeAtRunTime(parameters, parameterCount, samplers, samplerCount, flags, featureData.HighestVersion);
+    ThrowIfFailed(device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature)));
+    return rootSignature;
+}
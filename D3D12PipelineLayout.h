@@ -0,0 +1,45 @@
+#pragma once
+
+#include "DXSampleHelper.h"
+#include "PipelineLayout.h"
+
+// D3D12 objects from the compile-time descriptions of PipelineLayout.h.
+
+// The D3D12 input elements of a layout, built at compile time. Per-vertex data only.
+template <size_t ElementCount>
+constexpr std::array<D3D12_INPUT_ELEMENT_DESC, ElementCount> ToD3D12InputElements(const InputLayout<ElementCount>& layout)
+{
+    std::array<D3D12_INPUT_ELEMENT_DESC, ElementCount> elements = {};
+    for (size_t i = 0; i < ElementCount; ++i)
+    {
+        const InputElementLayout& element = layout.Elements[i];
+        elements[i] = { element.Semantic, element.SemanticIndex, static_cast<DXGI_FORMAT>(element.Format), element.Slot, element.Offset,
+            D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+    }
+    return elements;
+}
+
+template <size_t ElementCount>
+D3D12_INPUT_LAYOUT_DESC GetInputLayoutDesc(const std::array<D3D12_INPUT_ELEMENT_DESC, ElementCount>& elements)
+{
+    return { ElementCount ? elements.data() : nullptr, static_cast<UINT>(ElementCount) };
+}
+
+// Writes the fixed function state of the layout into desc, all of it but the shaders, the root
+// signature and the input layout.
+void ApplyPipelineState(const PipelineStateLayout& state, D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+// Creates the root signature from its blob serialized at compile time: one CreateRootSignature
+// call. If the device rejects it (a device without root signature 1.1), the layout is serialized
+// at run time for the highest version the device supports. Debug builds also compare the blob
+// with D3D12's serializer and report a difference to the debugger output.
+ComPtr<ID3D12RootSignature> CreatePrebakedRootSignature(ID3D12Device* device, const void* blob, size_t blobSize,
+    const RootParameterLayout* parameters, size_t parameterCount, const StaticSamplerLayout* samplers, size_t samplerCount, uint32_t flags);
+
+template <size_t ParameterCount, size_t SamplerCount>
+ComPtr<ID3D12RootSignature> CreatePrebakedRootSignature(ID3D12Device* device, const RootSignatureLayout<ParameterCount, SamplerCount>& layout,
+    const SerializedRootSignature<ParameterCount, SamplerCount>& blob)
+{
+    return CreatePrebakedRootSignature(device, blob.Bytes.data(), blob.Size, layout.Parameters.data(), ParameterCount,
+        layout.Samplers.data(), SamplerCount, layout.Flags);
+}
@@ -0,0 +1,59 @@
+#include "Stdafx.h"
+#include "D3D12ResourceCache.h"
+
+namespace
+{
+    void ReleaseResource(void* resource)
+    {
+        static_cast<ID3D12Resource*>(resource)->Release();
+    }
+}
+
+D3D12ResourceCache::D3D12ResourceCache(ID3D12Device* device, DeferredReleaseQueue& releaseQueue, UINT descriptorCapacity) :
+    m_device(device),
+    m_srvDescriptorSize(device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)),
+    m_cache(releaseQueue, ReleaseResource, descriptorCapacity)
+{
+    D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+    srvHeapDesc.NumDescriptors = descriptorCapacity;
+    srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    ThrowIfFailed(m_device->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&m_srvHeap)));
+}
+
+ResourceHandle D3D12ResourceCache::Insert(const ResourceKey& key, ID3D12Resource* resource, bool* inserted, const D3D12_SHADER_RESOURCE_VIEW_DESC* srvDesc)
+{
+    const D3D12_RESOURCE_DESC desc = resource->GetDesc();
+    const D3D12_RESOURCE_ALLOCATION_INFO allocation = m_device->GetResourceAllocationInfo(0, 1, &desc);
+
+    // The view is written before the entry can be found, so a concurrent hit never copies an
+    // empty descriptor.
+    std::function<void(uint32_t)> initialize;
+    if (desc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER)
+    {
+        initialize = [this, resource, srvDesc](uint32_t descriptor)
+        {
+            m_device->CreateShaderResourceView(resource, srvDesc,
+                CD3DX12_CPU_DESCRIPTOR_HANDLE(m_srvHeap->GetCPUDescriptorHandleForHeapStart(), descriptor, m_srvDescriptorSize));
+        };
+    }
+
+    // The cache's own reference, handed over to it.
+    resource->AddRef();
+    return m_cache.Insert(key, resource, allocation.SizeInBytes, inserted, initialize);
+}
+
+ResourceHandle D3D12ResourceCache::InsertTexture(const ResourceKey& key, ID3D12Resource* texture, const D3D12_SHADER_RESOURCE_VIEW_DESC* srvDesc, bool* inserted)
+{
+    return Insert(key, texture, inserted, srvDesc);
+}
+
+ResourceHandle D3D12ResourceCache::InsertBuffer(const ResourceKey& key, ID3D12Resource* buffer, bool* inserted)
+{
+    return Insert(key, buffer, inserted, nullptr);
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE D3D12ResourceCache::GetSrv(ResourceHandle handle) const
+{
+    return CD3DX12_CPU_DESCRIPTOR_HANDLE(m_srvHeap->GetCPUDescriptorHandleForHeapStart(), m_cache.GetDescriptor(handle), m_srvDescriptorSize);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "DXSampleHelper.h"
+#include "ResourceCache.h"
+
+// ResourceCache of D3D12 resources, with one shader resource view per texture kept in a heap of
+// the cache's own. The heap is not shader visible: copy a view into the descriptor table that
+// uses it (CopyDescriptorsSimple). Evicted resources go through the release queue; the views of
+// evicted textures are only ever copied from, so their slots are reused at once.
+class D3D12ResourceCache
+{
+public:
+    D3D12ResourceCache(ID3D12Device* device, DeferredReleaseQueue& releaseQueue, UINT descriptorCapacity = 256);
+
+    ResourceHandle Acquire(const ResourceKey& key) { return m_cache.Acquire(key); }
+
+    // Adds a resource created after a miss; the cache takes a reference of its own. A texture gets
+    // a view from srvDesc (nullptr: the default view of the resource). When another load added the
+    // key first, its entry is returned and the resource passed in is not kept.
+    ResourceHandle InsertTexture(const ResourceKey& key, ID3D12Resource* texture, const D3D12_SHADER_RESOURCE_VIEW_DESC* srvDesc, bool* inserted = nullptr);
+    ResourceHandle InsertBuffer(const ResourceKey& key, ID3D12Resource* buffer, bool* inserted = nullptr);
+
+    void Release(ResourceHandle handle, TimelineFence& timeline, UINT64 lastUse) { m_cache.Release(handle, timeline, lastUse); }
+    size_t Trim(UINT64 maxUnreferencedBytes) { return m_cache.Trim(maxUnreferencedBytes); }
+
+    ID3D12Resource* GetResource(ResourceHandle handle) const { return static_cast<ID3D12Resource*>(m_cache.GetResource(handle)); }
+    D3D12_CPU_DESCRIPTOR_HANDLE GetSrv(ResourceHandle handle) const;
+
+    ID3D12DescriptorHeap* GetSrvHeap() const { return m_srvHeap.Get(); }
+    ResourceCache& GetCache() { return m_cache; }
+
+private:
+    ResourceHandle Insert(const ResourceKey& key, ID3D12Resource* resource, bool* inserted, const D3D12_SHADER_RESOURCE_VIEW_DESC* srvDesc);
+
+    ComPtr<ID3D12Device> m_device;
+    ComPtr<ID3D12DescriptorHeap> m_srvHeap;
+    UINT m_srvDescriptorSize;
+    ResourceCache m_cache;
+};
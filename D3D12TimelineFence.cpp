@@ -0,0 +1,32 @@
+#include "Stdafx.h"
+#include "D3D12TimelineFence.h"
+
+D3D12TimelineFence::D3D12TimelineFence(ID3D12Device* device, ID3D12CommandQueue* queue) :
+    m_queue(queue)
+{
+    ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+}
+
+void D3D12TimelineFence::QueueWait(D3D12TimelineFence& other, UINT64 value)
+{
+    ThrowIfFailed(m_queue->Wait(other.GetFence(), value));
+}
+
+void D3D12TimelineFence::SignalValue(uint64_t value)
+{
+    ThrowIfFailed(m_queue->Signal(m_fence.Get(), value));
+}
+
+uint64_t D3D12TimelineFence::QueryCompletedValue()
+{
+    return m_fence->GetCompletedValue();
+}
+
+void D3D12TimelineFence::WaitForValue(uint64_t value)
+{
+    // TimelineFence::Wait may be called from several threads at once. A shared auto-reset event
+    // would wake only one of them, and could be set by an earlier value than the one waited for.
+    // Without an event, SetEventOnCompletion blocks the calling thread until the fence reaches
+    // the value.
+    ThrowIfFailed(m_fence->SetEventOnCompletion(value, nullptr));
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "DXSampleHelper.h"
+#include "TimelineFence.h"
+
+// TimelineFence of a D3D12 command queue: the values are signaled on the queue into its own fence.
+// 커맨드 큐 하나와 그 큐가 signal 하는 fence 하나로 이루어진 타임라인.
+class D3D12TimelineFence : public TimelineFence
+{
+public:
+    D3D12TimelineFence(ID3D12Device* device, ID3D12CommandQueue* queue);
+
+    ID3D12Fence* GetFence() const { return m_fence.Get(); }
+
+    // Makes this timeline's queue wait on the GPU (not the CPU) for a value of another timeline.
+    void QueueWait(D3D12TimelineFence& other, UINT64 value);
+
+protected:
+    void SignalValue(uint64_t value) override;
+    uint64_t QueryCompletedValue() override;
+    void WaitForValue(uint64_t value) override;
+
+private:
+    ComPtr<ID3D12CommandQueue> m_queue;
+    ComPtr<ID3D12Fence> m_fence;
+};
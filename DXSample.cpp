@@ -3,12 +3,26 @@
 
 using namespace Microsoft::WRL;
 
-// m_useWarpDevice: d3d12   ʴ ϵ Ϸ true.
+// m_useWarpDevice: d3d12 를 지원하지 않는 하드웨어에서 사용하려면 true.
 DXSample::DXSample(UINT width, UINT height, std::wstring name) :
     m_width(width),
     m_height(height),
     m_title(name),
-    m_useWarpDevice(false)
+    m_useWarpDevice(false),
+    m_benchmarkMode(false),
+    m_benchmarkFrames(1000),
+    m_warmupFrames(100),
+    m_framesInFlight(2),
+    m_sceneScale(1),
+    m_fixedTimestep(0.0f),
+    m_benchmarkOutput(L"benchmark.json"),
+    m_metricsPort(0),
+    m_dynamicResolution(true),
+    m_gpuBudgetMilliseconds(15.0f),
+    m_animatedTextureSize(0),
+    m_spriteCount(0),
+    m_atlasTextureCount(0),
+    m_textureBlockFormat(BlockFormat::BC7)
 {
     WCHAR assetsPath[512];
     GetAssetsPath(assetsPath, _countof(assetsPath));
@@ -28,13 +42,16 @@ std::wstring DXSample::GetAssetFullPath(LPCWSTR assetName)
 }
 
 // Helper function for acquiring the first available hardware adapter that supports Direct3D 12.
-// If no such adapter can be found, *ppAdapter will be set to nullptr.
-// DXGIFactory COMü Ͽ,  ֻ ս  GPU Ű ͸ ŽϿ, ȯѴ.
+// If no such adapter can be found, *ppAdapter will be set to nullptr. If ppDevice is not null, it
+// receives the device created on the adapter found.
+// 장치 포인터를 넘기면 어댑터를 확인하면서 만든 장치를 그대로 돌려준다.
+// DXGIFactory COM객체를 통하여, 가장 최상의 퍼포먼스를 보여줄 GPU를 가리키는 포인터를 탐색하여, 반환한다.
 _Use_decl_annotations_
 void DXSample::GetHardwareAdapter(
     IDXGIFactory1* pFactory,
     IDXGIAdapter1** ppAdapter,
-    bool requestHighPerformanceAdapter)
+    bool requestHighPerformanceAdapter,
+    ID3D12Device** ppDevice)
 {
     *ppAdapter = nullptr;
 
@@ -61,9 +78,9 @@ void DXSample::GetHardwareAdapter(
                 continue;
             }
 
-            // Check to see whether the adapter supports Direct3D 12, but don't create the
-            // actual device yet.
-            if (SUCCEEDED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_11_0, _uuidof(ID3D12Device), nullptr)))
+            // Check to see whether the adapter supports Direct3D 12. When the caller wants the
+            // device, the check creates it, instead of creating it a second time afterwards.
+            if (SUCCEEDED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_11_0, _uuidof(ID3D12Device), reinterpret_cast<void**>(ppDevice))))
             {
                 break;
             }
@@ -84,9 +101,9 @@ void DXSample::GetHardwareAdapter(
                 continue;
             }
 
-            // Check to see whether the adapter supports Direct3D 12, but don't create the
-            // actual device yet.
-            if (SUCCEEDED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_11_0, _uuidof(ID3D12Device), nullptr)))
+            // Check to see whether the adapter supports Direct3D 12. When the caller wants the
+            // device, the check creates it, instead of creating it a second time afterwards.
+            if (SUCCEEDED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_11_0, _uuidof(ID3D12Device), reinterpret_cast<void**>(ppDevice))))
             {
                 break;
             }
@@ -96,17 +113,19 @@ void DXSample::GetHardwareAdapter(
     *ppAdapter = adapter.Detach();
 }
 
-// Helper function for setting the window's title text.
+// Helper function for setting the window's title text. Called on the render thread, so the
+// window thread sets it: SetWindowText would wait for that thread.
 void DXSample::SetCustomWindowText(LPCWSTR text)
 {
-    std::wstring windowText = m_title + L": " + text;
-    SetWindowText(Win32Application::GetHwnd(), windowText.c_str());
+    Win32Application::PostWindowText(m_title + L": " + text);
 }
 
 // Helper function for parsing any supplied command line args.
 _Use_decl_annotations_
 void DXSample::ParseCommandLineArgs(WCHAR* argv[], int argc)
 {
+    int dynamicResolution = -1;     // -1 when not given on the command line.
+
     for (int i = 1; i < argc; ++i)
     {
         if (_wcsnicmp(argv[i], L"-warp", wcslen(argv[i])) == 0 ||
@@ -114,6 +133,139 @@ void DXSample::ParseCommandLineArgs(WCHAR* argv[], int argc)
         {
             m_useWarpDevice = true;
             m_title = m_title + L" (WARP)";
+            continue;
+        }
+
+        // Options below are exact matches, with either '-' or '/', most taking one value.
+        // 아래 옵션들은 '-' 또는 '/' 로 시작하며 대부분 값을 하나 받는다.
+        if (argv[i][0] != L'-' && argv[i][0] != L'/')
+        {
+            continue;
+        }
+        const WCHAR* option = argv[i] + 1;
+        const WCHAR* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (_wcsicmp(option, L"benchmark") == 0)
+        {
+            m_benchmarkMode = true;
+            continue;
+        }
+        if (!value)
+        {
+            continue;
+        }
+
+        const UINT number = static_cast<UINT>(wcstoul(value, nullptr, 10));
+        bool consumed = true;
+        if (_wcsicmp(option, L"frames") == 0)
+        {
+            m_benchmarkFrames = max(1u, number);
+        }
+        else if (_wcsicmp(option, L"warmup") == 0)
+        {
+            m_warmupFrames = number;
+        }
+        else if (_wcsicmp(option, L"width") == 0)
+        {
+            m_width = max(1u, number);
+        }
+        else if (_wcsicmp(option, L"height") == 0)
+        {
+            m_height = max(1u, number);
+        }
+        else if (_wcsicmp(option, L"framesinflight") == 0)
+        {
+            m_framesInFlight = min(max(2u, number), 3u);
+        }
+        else if (_wcsicmp(option, L"scenescale") == 0)
+        {
+            m_sceneScale = max(1u, number);
+        }
+        else if (_wcsicmp(option, L"timestep") == 0)
+        {
+            m_fixedTimestep = max(0.0f, static_cast<float>(_wtof(value)));
+        }
+        else if (_wcsicmp(option, L"output") == 0)
+        {
+            m_benchmarkOutput = value;
+        }
+        else if (_wcsicmp(option, L"metrics") == 0)
+        {
+            m_metricsOutput = value;
+        }
+        else if (_wcsicmp(option, L"metricsport") == 0)
+        {
+            m_metricsPort = min(number, 65535u);
+        }
+        else if (_wcsicmp(option, L"dynres") == 0)
+        {
+            dynamicResolution = number != 0 ? 1 : 0;
+        }
+        else if (_wcsicmp(option, L"gpubudget") == 0)
+        {
+            m_gpuBudgetMilliseconds = max(1.0f, static_cast<float>(_wtof(value)));
+        }
+        else if (_wcsicmp(option, L"capture") == 0)
+        {
+            m_captureOutput = value;
+        }
+        else if (_wcsicmp(option, L"replay") == 0)
+        {
+            m_replayInput = value;
+        }
+        else if (_wcsicmp(option, L"animatetexture") == 0)
+        {
+            m_animatedTextureSize = number;
+        }
+        else if (_wcsicmp(option, L"sprites") == 0)
+        {
+            m_spriteCount = number;
+        }
+        else if (_wcsicmp(option, L"atlas") == 0)
+        {
+            m_atlasTextureCount = number;
+        }
+        else if (_wcsicmp(option, L"mesh") == 0)
+        {
+            m_meshPath = value;
+        }
+        else if (_wcsicmp(option, L"texture") == 0)
+        {
+            m_texturePath = value;
+        }
+        else if (_wcsicmp(option, L"textureformat") == 0)
+        {
+            if (_wcsicmp(value, L"bc1") == 0)
+            {
+                m_textureBlockFormat = BlockFormat::BC1;
+            }
+            else if (_wcsicmp(value, L"bc3") == 0)
+            {
+                m_textureBlockFormat = BlockFormat::BC3;
+            }
+            else if (_wcsicmp(value, L"bc7") == 0)
+            {
+                m_textureBlockFormat = BlockFormat::BC7;
+            }
+        }
+        else
+        {
+            consumed = false;
+        }
+
+        if (consumed)
+        {
+            ++i;
         }
     }
+
+    // A benchmark must replay the same simulation every run.
+    if (m_benchmarkMode && m_fixedTimestep == 0.0f)
+    {
+        m_fixedTimestep = 1.0f / 60.0f;
+    }
+    // The same goes for the resolution, unless dynamic resolution itself is being measured.
+    m_dynamicResolution = dynamicResolution < 0 ? !m_benchmarkMode : dynamicResolution != 0;
+
+    m_aspectRatio = static_cast<float>(m_width) / static_cast<float>(m_height);
 }
\ No newline at end of file
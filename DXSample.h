@@ -1,10 +1,11 @@
 #pragma once
 
+#include "BlockCompression.h"
 #include "DXSampleHelper.h"
 #include "Win32Application.h"
 
-// D3D   Ŭ θ Ŭ̸,
-// Ŭ  οϱ  ֿ Լ  Լ Ǿִ.
+// D3D 로직ㄷ이 실행될 클래스들의 부모 클래스이며,
+// 클래스에 다형성을 부여하기 위해 주요 함수는 가상 함수로 선언되어있다.
 class DXSample
 {
 public:
@@ -19,6 +20,9 @@ public:
     // Samples override the event handlers to handle specific messages.
     virtual void OnKeyDown(UINT8 /*key*/) {}
     virtual void OnKeyUp(UINT8 /*key*/) {}
+    // The client area's new size, on the render thread between frames. 0 x 0 when minimized, in
+    // which case no frame is rendered until the next size.
+    virtual void OnSizeChanged(UINT /*width*/, UINT /*height*/) {}
 
     // Accessors.
     UINT GetWidth() const { return m_width; }
@@ -33,7 +37,8 @@ protected:
     void GetHardwareAdapter(
         _In_ IDXGIFactory1* pFactory,
         _Outptr_result_maybenull_ IDXGIAdapter1** ppAdapter,
-        bool requestHighPerformanceAdapter = false);
+        bool requestHighPerformanceAdapter = false,
+        _Outptr_opt_result_maybenull_ ID3D12Device** ppDevice = nullptr);
 
     void SetCustomWindowText(LPCWSTR text);
 
@@ -45,6 +50,59 @@ protected:
     // Adapter info.
     bool m_useWarpDevice;
 
+    // Benchmark mode (-benchmark): a fixed number of frames with a fixed timestep, then a report
+    // and exit. 정해진 프레임 수만큼 고정된 시간 간격으로 실행하고 결과를 기록한 뒤 종료한다.
+    bool m_benchmarkMode;
+    UINT m_benchmarkFrames;
+    UINT m_warmupFrames;
+    UINT m_framesInFlight;
+    UINT m_sceneScale;
+    float m_fixedTimestep;          // Seconds per update; 0 uses the measured frame time.
+    std::wstring m_benchmarkOutput; // .json or .csv.
+
+    // Runtime metrics export (-metrics <file>, -metricsport <udp port>). Empty / 0 when unused.
+    // 런타임 지표 스냅샷을 파일(JSON Lines) 또는 로컬 UDP 포트로 내보낸다.
+    std::wstring m_metricsOutput;
+    UINT m_metricsPort;
+
+    // Dynamic resolution (-dynres 0|1, -gpubudget <ms>). On by default, off in benchmark mode so
+    // runs stay comparable. GPU 시간이 목표를 넘지 않도록 렌더 해상도를 프레임마다 조절한다.
+    bool m_dynamicResolution;
+    float m_gpuBudgetMilliseconds;
+
+    // Command capture (-capture <file>) records the D3D12 calls of the run; replay (-replay <file>)
+    // runs the captured frames instead of the app's own, with the same other options.
+    // 커맨드 스트림을 기록하거나, 기록한 프레임들을 앱 대신 재생한다.
+    std::wstring m_captureOutput;
+    std::wstring m_replayInput;
+
+    // Animated texture (-animatetexture <pixels>): a square of that size moves over the generated
+    // texture, which is updated each frame by uploading only the changed regions. 0: static.
+    // 텍스처 위를 움직이는 사각형을 그리고, 바뀐 영역만 매 프레임 업로드한다.
+    UINT m_animatedTextureSize;
+
+    // Sprite batching (-sprites <count>): that many spinning textured quads are expanded on the
+    // CPU and drawn over the scene each frame. 0: none.
+    // 지정한 개수의 스프라이트를 매 프레임 CPU 에서 정점으로 만들어 씬 위에 그린다.
+    UINT m_spriteCount;
+
+    // Texture atlas (-atlas <count>): with -sprites, the sprites show that many small generated
+    // textures, packed into a few atlas pages, instead of corners of the checkerboard. 0: none.
+    // 작은 텍스쳐들을 아틀라스 페이지 몇 장에 모아 스프라이트가 그 텍스쳐들을 그리게 한다.
+    UINT m_atlasTextureCount;
+
+    // Mesh (-mesh <file.obj>): the objects draw the triangles of a Wavefront OBJ file, imported
+    // in parallel, instead of the single triangle. Empty: the triangle.
+    // OBJ 파일의 메시를 병렬로 불러와 삼각형 대신 그린다.
+    std::wstring m_meshPath;
+
+    // Texture file (-texture <file.ktx2>, -textureformat bc1|bc3|bc7): a KTX2 texture replaces the
+    // archive's and the generated one. RGBA8 texels are block compressed into the given format,
+    // BC7 by default, while they are written into the upload heap. Empty: no file.
+    // KTX2 텍스쳐 파일을 불러온다. RGBA8 텍셀은 업로드 힙에 쓰면서 지정한 BC 포맷으로 압축한다.
+    std::wstring m_texturePath;
+    BlockFormat m_textureBlockFormat;
+
 private:
     // Root assets path.
     std::wstring m_assetsPath;
@@ -0,0 +1,256 @@
+#include "DirtyRegions.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+namespace
+{
+    // What merging two rectangles costs: the clean tiles their bounding box adds, then its area.
+    uint64_t MergeCost(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom, uint32_t dirtyTiles)
+    {
+        const uint64_t area = static_cast<uint64_t>(right - left) * (bottom - top);
+        const uint64_t waste = area > dirtyTiles ? area - dirtyTiles : 0;
+        return (waste << 32) | std::min<uint64_t>(area, 0xffffffff);
+    }
+}
+
+DirtyRegionTracker::DirtyRegionTracker(uint32_t width, uint32_t height, uint32_t tileSize) :
+    m_width(width),
+    m_height(height),
+    m_tileSize(tileSize),
+    m_dirtyTiles(0)
+{
+    if (width == 0 || height == 0 || tileSize == 0)
+    {
+        throw std::invalid_argument("DirtyRegionTracker: empty image or tile.");
+    }
+    m_tilesX = (width + tileSize - 1) / tileSize;
+    m_tilesY = (height + tileSize - 1) / tileSize;
+    m_tiles.assign(static_cast<size_t>(m_tilesX) * m_tilesY, 0);
+    m_rowDirty.assign(m_tilesY, 0);
+}
+
+void DirtyRegionTracker::MarkDirty(const DirtyRect& rect)
+{
+    const uint32_t right = std::min(rect.Right, m_width);
+    const uint32_t bottom = std::min(rect.Bottom, m_height);
+    if (rect.Left >= right || rect.Top >= bottom)
+    {
+        return;
+    }
+    m_stats.MarkedPixels += static_cast<uint64_t>(right - rect.Left) * (bottom - rect.Top);
+
+    const uint32_t tileRight = (right - 1) / m_tileSize + 1;
+    for (uint32_t ty = rect.Top / m_tileSize; ty <= (bottom - 1) / m_tileSize; ++ty)
+    {
+        uint8_t* row = &m_tiles[static_cast<size_t>(ty) * m_tilesX];
+        for (uint32_t tx = rect.Left / m_tileSize; tx < tileRight; ++tx)
+        {
+            if (!row[tx])
+            {
+                row[tx] = 1;
+                ++m_rowDirty[ty];
+                ++m_dirtyTiles;
+            }
+        }
+    }
+}
+
+void DirtyRegionTracker::MarkAllDirty()
+{
+    const DirtyRect all = { 0, 0, m_width, m_height };
+    MarkDirty(all);
+}
+
+size_t DirtyRegionTracker::Collect(std::vector<DirtyRect>& rects, size_t maxRects)
+{
+    rects.clear();
+    if (m_dirtyTiles == 0)
+    {
+        return 0;
+    }
+    maxRects = std::max<size_t>(maxRects, 1);
+
+    // Runs of dirty tiles along each row; a run with the same columns as a rectangle reaching the
+    // row above extends that rectangle down. Runs and open rectangles are both sorted by column.
+    m_merge.clear();
+    m_open.clear();
+    for (uint32_t ty = 0; ty < m_tilesY; ++ty)
+    {
+        m_nextOpen.clear();
+        if (m_rowDirty[ty] != 0)
+        {
+            uint8_t* row = &m_tiles[static_cast<size_t>(ty) * m_tilesX];
+            size_t open = 0;
+            for (uint32_t tx = 0; tx < m_tilesX;)
+            {
+                if (!row[tx])
+                {
+                    ++tx;
+                    continue;
+                }
+                const uint32_t left = tx;
+                for (; tx < m_tilesX && row[tx]; ++tx)
+                {
+                    row[tx] = 0;
+                }
+
+                while (open < m_open.size() && m_merge[m_open[open]].Left < left)
+                {
+                    ++open;
+                }
+                if (open < m_open.size() && m_merge[m_open[open]].Left == left && m_merge[m_open[open]].Right == tx)
+                {
+                    TileRect& extended = m_merge[m_open[open]];
+                    extended.Bottom = ty + 1;
+                    extended.DirtyTiles += tx - left;
+                    m_nextOpen.push_back(m_open[open]);
+                    ++open;
+                }
+                else
+                {
+                    m_merge.push_back(TileRect{ left, ty, tx, ty + 1, tx - left });
+                    m_nextOpen.push_back(static_cast<uint32_t>(m_merge.size() - 1));
+                }
+            }
+            m_rowDirty[ty] = 0;
+        }
+        m_open.swap(m_nextOpen);
+    }
+    m_stats.DirtyPixels += static_cast<uint64_t>(m_dirtyTiles) * m_tileSize * m_tileSize;
+    m_dirtyTiles = 0;
+
+    // Too many rectangles: merge neighbours in scan order, cheapest first. The rectangles form a
+    // list; the queue holds the cost of merging each one with the next, and entries made stale
+    // by an earlier merge are recognized by the version of the rectangle and skipped.
+    const size_t count = m_merge.size();
+    if (count > maxRects)
+    {
+        std::vector<uint32_t> next(count);
+        std::vector<uint32_t> previous(count);
+        std::vector<uint32_t> version(count, 0);
+        std::vector<bool> alive(count, true);
+        for (size_t i = 0; i < count; ++i)
+        {
+            next[i] = static_cast<uint32_t>(i + 1);
+            previous[i] = static_cast<uint32_t>(i - 1);
+        }
+
+        struct Candidate
+        {
+            uint64_t Cost;
+            uint32_t First;
+            uint32_t FirstVersion;
+            uint32_t SecondVersion;
+            bool operator>(const Candidate& other) const { return Cost != other.Cost ? Cost > other.Cost : First > other.First; }
+        };
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+        const auto push = [&](uint32_t first)
+        {
+            const uint32_t second = next[first];
+            const TileRect& a = m_merge[first];
+            const TileRect& b = m_merge[second];
+            queue.push(Candidate{
+                MergeCost(std::min(a.Left, b.Left), std::min(a.Top, b.Top), std::max(a.Right, b.Right), std::max(a.Bottom, b.Bottom), a.DirtyTiles + b.DirtyTiles),
+                first, version[first], version[second] });
+        };
+        for (uint32_t i = 0; i + 1 < count; ++i)
+        {
+            push(i);
+        }
+
+        for (size_t remaining = count; remaining > maxRects;)
+        {
+            const Candidate best = queue.top();
+            queue.pop();
+            const uint32_t first = best.First;
+            if (!alive[first] || next[first] >= count || version[first] != best.FirstVersion || version[next[first]] != best.SecondVersion)
+            {
+                continue;
+            }
+
+            const uint32_t second = next[first];
+            TileRect& a = m_merge[first];
+            const TileRect& b = m_merge[second];
+            a.Left = std::min(a.Left, b.Left);
+            a.Top = std::min(a.Top, b.Top);
+            a.Right = std::max(a.Right, b.Right);
+            a.Bottom = std::max(a.Bottom, b.Bottom);
+            a.DirtyTiles += b.DirtyTiles;
+            alive[second] = false;
+            next[first] = next[second];
+            if (next[first] < count)
+            {
+                previous[next[first]] = first;
+            }
+            ++version[first];
+            --remaining;
+
+            if (first > 0 && previous[first] < count)
+            {
+                push(previous[first]);
+            }
+            if (next[first] < count)
+            {
+                push(first);
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (alive[i])
+            {
+                m_merge[kept++] = m_merge[i];
+            }
+        }
+        m_merge.resize(kept);
+
+        // A merged box may swallow others whole; those copies would be repeated.
+        kept = 0;
+        for (size_t i = 0; i < m_merge.size(); ++i)
+        {
+            const TileRect& inner = m_merge[i];
+            bool contained = false;
+            for (size_t j = 0; j < m_merge.size() && !contained; ++j)
+            {
+                const TileRect& outer = m_merge[j];
+                contained = j != i && outer.Left <= inner.Left && outer.Top <= inner.Top && outer.Right >= inner.Right && outer.Bottom >= inner.Bottom
+                    && (j < i || outer.Left != inner.Left || outer.Top != inner.Top || outer.Right != inner.Right || outer.Bottom != inner.Bottom);
+            }
+            if (!contained)
+            {
+                m_merge[kept++] = inner;
+            }
+        }
+        m_merge.resize(kept);
+
+        // Overlapping boxes that add up to the whole image are better sent as one copy.
+        uint64_t area = 0;
+        for (const TileRect& tiles : m_merge)
+        {
+            area += static_cast<uint64_t>(tiles.Right - tiles.Left) * (tiles.Bottom - tiles.Top);
+        }
+        if (area >= static_cast<uint64_t>(m_tilesX) * m_tilesY)
+        {
+            m_merge.assign(1, TileRect{ 0, 0, m_tilesX, m_tilesY, 0 });
+        }
+    }
+
+    for (const TileRect& tiles : m_merge)
+    {
+        DirtyRect rect;
+        rect.Left = tiles.Left * m_tileSize;
+        rect.Top = tiles.Top * m_tileSize;
+        rect.Right = std::min(tiles.Right * m_tileSize, m_width);
+        rect.Bottom = std::min(tiles.Bottom * m_tileSize, m_height);
+        rects.push_back(rect);
+        m_stats.CollectedPixels += static_cast<uint64_t>(rect.Right - rect.Left) * (rect.Bottom - rect.Top);
+    }
+    ++m_stats.Collects;
+    m_stats.Rects += rects.size();
+    m_stats.ImagePixels += static_cast<uint64_t>(m_width) * m_height;
+    return rects.size();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A rectangle of pixels; Right and Bottom are exclusive.
+struct DirtyRect
+{
+    uint32_t Left;
+    uint32_t Top;
+    uint32_t Right;
+    uint32_t Bottom;
+};
+
+struct DirtyRegionStats
+{
+    uint64_t Collects = 0;          // Collect calls that returned rectangles.
+    uint64_t Rects = 0;
+    uint64_t MarkedPixels = 0;      // Area passed to MarkDirty, counting overlaps again.
+    uint64_t DirtyPixels = 0;       // Area of the dirty tiles.
+    uint64_t CollectedPixels = 0;   // Area of the rectangles returned: what gets uploaded.
+    uint64_t ImagePixels = 0;       // Image area for every Collect: what full uploads would take.
+};
+
+// Tracks which parts of a CPU-side image changed since they were last uploaded, so only those
+// are copied to the GPU.
+//
+// The image is divided into square tiles; marking a rectangle dirties the tiles it touches, so
+// any amount of drawing costs a bit per tile and repeated marks of one area are free. Collect
+// turns the dirty tiles into few rectangles: runs of dirty tiles along each tile row, stacked
+// with the identical runs of the rows below, then, while there are more than maxRects, the two
+// rectangles closest in scan order whose bounding box wastes the fewest clean tiles are merged.
+// Each rectangle is one copy command, with its own row alignment in the upload buffer, so a few
+// larger copies beat many small ones.
+// Not thread-safe.
+class DirtyRegionTracker
+{
+public:
+    DirtyRegionTracker(uint32_t width, uint32_t height, uint32_t tileSize = 32);
+
+    // The rectangle is clipped to the image; empty rectangles are ignored.
+    void MarkDirty(const DirtyRect& rect);
+    void MarkAllDirty();
+    bool IsDirty() const { return m_dirtyTiles != 0; }
+
+    // Replaces rects with rectangles covering every dirty tile, clipped to the image, and marks
+    // everything clean. Returns how many there are: 0 when nothing changed, at most maxRects
+    // (at least 1). Rectangles merged to stay under maxRects may overlap others.
+    size_t Collect(std::vector<DirtyRect>& rects, size_t maxRects = 16);
+
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+    uint32_t GetTileSize() const { return m_tileSize; }
+    const DirtyRegionStats& GetStats() const { return m_stats; }
+
+private:
+    // In tiles while collecting.
+    struct TileRect
+    {
+        uint32_t Left;
+        uint32_t Top;
+        uint32_t Right;
+        uint32_t Bottom;
+        uint32_t DirtyTiles;        // Tiles of the rectangle that are dirty; the rest is waste.
+    };
+
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_tileSize;
+    uint32_t m_tilesX;
+    uint32_t m_tilesY;
+    std::vector<uint8_t> m_tiles;       // Row-major, 1 when dirty.
+    std::vector<uint32_t> m_rowDirty;   // Dirty tiles per tile row, so clean rows are skipped.
+    uint32_t m_dirtyTiles;
+    // Collect's working memory, kept between calls.
+    std::vector<TileRect> m_merge;
+    std::vector<uint32_t> m_open;       // Rectangles reaching the previous tile row, by Left.
+    std::vector<uint32_t> m_nextOpen;
+    DirtyRegionStats m_stats;
+};
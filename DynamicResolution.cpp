@@ -0,0 +1,70 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+DynamicResolutionController::DynamicResolutionController(const DynamicResolutionSettings& settings) :
+    m_settings(settings)
+{
+    Reset(settings.MaxScale);
+}
+
+void DynamicResolutionController::Reset(float scale)
+{
+    m_scale = std::min(std::max(scale, m_settings.MinScale), m_settings.MaxScale);
+    // The integral term alone produces the scale when the error is zero.
+    m_integral = m_settings.Ki > 0.0f ? m_scale / m_settings.Ki : 0.0f;
+    m_previousError = 0.0f;
+    m_hasPreviousError = false;
+}
+
+float DynamicResolutionController::Update(float gpuMilliseconds, float frameScale)
+{
+    if (!(gpuMilliseconds > 0.0f) || !(frameScale > 0.0f))
+    {
+        return m_scale;
+    }
+
+    // What the measured frame would have cost at the current scale.
+    const float ratio = m_scale / frameScale;
+    const float estimate = gpuMilliseconds * ratio * ratio;
+    const float target = m_settings.TargetMilliseconds;
+
+    if (estimate > target * m_settings.PanicFactor)
+    {
+        // Far over budget: jump to the scale that fits the target and restart from there.
+        Reset(m_scale * std::sqrt(target / estimate));
+        return m_scale;
+    }
+
+    float error = (target - estimate) / target;
+    if (std::fabs(error) < m_settings.DeadBand)
+    {
+        error = 0.0f;
+    }
+    const float derivative = m_hasPreviousError ? error - m_previousError : 0.0f;
+    m_previousError = error;
+    m_hasPreviousError = true;
+
+    const float integral = m_integral + error;
+    const float output = m_settings.Kp * error + m_settings.Ki * integral + m_settings.Kd * derivative;
+    const float upper = std::min(m_settings.MaxScale, m_scale + m_settings.MaxScaleIncrease);
+    const float lower = m_settings.MinScale;
+
+    // Anti-windup: stop integrating while the output is clamped in the error's direction,
+    // otherwise a long stretch at the limit takes as long to unwind.
+    const bool saturated = (output > upper && error > 0.0f) || (output < lower && error < 0.0f);
+    if (!saturated)
+    {
+        m_integral = integral;
+    }
+
+    m_scale = std::min(std::max(output, lower), upper);
+    return m_scale;
+}
+
+void DynamicResolutionController::GetRenderSize(float scale, uint32_t fullWidth, uint32_t fullHeight, uint32_t& width, uint32_t& height)
+{
+    width = std::max(1u, static_cast<uint32_t>(fullWidth * scale + 0.5f));
+    height = std::max(1u, static_cast<uint32_t>(fullHeight * scale + 0.5f));
+}
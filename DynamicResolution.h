@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+struct DynamicResolutionSettings
+{
+    float TargetMilliseconds = 15.0f;   // GPU time to aim for, below the frame budget.
+    float MinScale = 0.5f;              // Per axis.
+    float MaxScale = 1.0f;
+
+    // Gains on the relative error (target - time) / target. The integral term holds the
+    // steady-state scale, so Ki also sets how fast the scale drifts back up under headroom.
+    float Kp = 0.15f;
+    float Ki = 0.08f;
+    float Kd = 0.05f;
+
+    // Errors smaller than this are treated as on target, so the scale does not hunt.
+    float DeadBand = 0.03f;
+    // A frame this many times over target skips the controller and rescales right away.
+    float PanicFactor = 1.5f;
+    // Largest scale increase per update. Decreases are not limited: a spike must be absorbed
+    // immediately, while growing back too fast overshoots.
+    float MaxScaleIncrease = 0.02f;
+};
+
+// Picks the render resolution scale from measured GPU frame times (PID controller).
+// GPU times arrive frames after the frame was recorded, so every measurement comes with the
+// scale that frame was rendered at and is first converted to the current scale, assuming GPU
+// time proportional to the pixel count. Portable: no graphics API dependency.
+class DynamicResolutionController
+{
+public:
+    explicit DynamicResolutionController(const DynamicResolutionSettings& settings = DynamicResolutionSettings());
+
+    // Feeds the GPU time of one frame and the scale it was rendered at; returns the new scale.
+    float Update(float gpuMilliseconds, float frameScale);
+
+    float GetScale() const { return m_scale; }
+    const DynamicResolutionSettings& GetSettings() const { return m_settings; }
+
+    // Back to the given scale (clamped) with a cleared history.
+    void Reset(float scale);
+
+    // Render size for a scale, rounded to whole pixels and at least 1x1.
+    static void GetRenderSize(float scale, uint32_t fullWidth, uint32_t fullHeight, uint32_t& width, uint32_t& height);
+
+private:
+    DynamicResolutionSettings m_settings;
+    float m_scale;
+    float m_integral;
+    float m_previousError;
+    bool m_hasPreviousError;
+};
@@ -0,0 +1,171 @@
+#include "FrameAllocators.h"
+#include "TimelineFence.h"
+
+#include <algorithm>
+
+namespace
+{
+    inline size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Scratch is for large temporaries too (a texture being generated), so blocks are large.
+    const size_t ScratchBlockSize = 1024 * 1024;
+}
+
+LinearArena::LinearArena(size_t blockSize, const MemoryTag& tag) :
+    m_blockSize(blockSize),
+    m_tag(tag),
+    m_block(0),
+    m_offset(0)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    for (const Block& block : m_blocks)
+    {
+        GetMemoryTracker().Untrack(block.Data.get());
+    }
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+    if (m_block < m_blocks.size())
+    {
+        Block& block = m_blocks[m_block];
+        // Align the address, not the offset: block data is only aligned to max_align_t.
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.Data.get());
+        const size_t offset = AlignUp(base + m_offset, alignment) - base;
+        if (offset + size <= block.Size)
+        {
+            m_offset = offset + size;
+            return block.Data.get() + offset;
+        }
+    }
+
+    // Move on to the next kept block that is large enough, or insert a new one after the current
+    // block. Smaller kept blocks are skipped for this allocation but stay for later frames.
+    const size_t required = size + alignment;
+    size_t next = m_blocks.empty() ? 0 : m_block + 1;
+    while (next < m_blocks.size() && m_blocks[next].Size < required)
+    {
+        ++next;
+    }
+    if (next == m_blocks.size())
+    {
+        const size_t blockSize = std::max(m_blockSize, required);
+        next = m_blocks.empty() ? 0 : m_block + 1;
+        m_blocks.insert(m_blocks.begin() + next, Block{ std::unique_ptr<uint8_t[]>(new uint8_t[blockSize]), blockSize });
+        GetMemoryTracker().Track(m_blocks[next].Data.get(), blockSize, m_tag);
+    }
+
+    m_block = next;
+    Block& block = m_blocks[m_block];
+    const uintptr_t base = reinterpret_cast<uintptr_t>(block.Data.get());
+    const size_t offset = AlignUp(base, alignment) - base;
+    m_offset = offset + size;
+    return block.Data.get() + offset;
+}
+
+size_t LinearArena::GetCapacity() const
+{
+    size_t capacity = 0;
+    for (const Block& block : m_blocks)
+    {
+        capacity += block.Size;
+    }
+    return capacity;
+}
+
+size_t LinearArena::GetUsedBytes() const
+{
+    size_t used = m_offset;
+    for (size_t i = 0; i < m_block && i < m_blocks.size(); ++i)
+    {
+        used += m_blocks[i].Size;
+    }
+    return used;
+}
+
+FrameArenaRing::FrameArenaRing(TimelineFence& timeline, uint32_t frameCount, size_t blockSize) :
+    m_timeline(timeline),
+    m_fenceValues(frameCount, 0),
+    m_current(0)
+{
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        m_arenas.emplace_back(new LinearArena(blockSize, MemoryTag(MemoryCategory::CpuStaging, "frame arena")));
+    }
+}
+
+LinearArena& FrameArenaRing::BeginFrame()
+{
+    m_current = (m_current + 1) % static_cast<uint32_t>(m_arenas.size());
+    m_timeline.Wait(m_fenceValues[m_current]);
+
+    LinearArena& arena = *m_arenas[m_current];
+    arena.Reset();
+    return arena;
+}
+
+void FrameArenaRing::EndFrame(uint64_t fenceValue)
+{
+    m_fenceValues[m_current] = fenceValue;
+}
+
+LinearArena& GetThreadScratch()
+{
+    // Lives until its thread exits, past any leak check of the app.
+    thread_local LinearArena scratch(ScratchBlockSize, MemoryTag(MemoryCategory::CpuStaging, "thread scratch", true));
+    return scratch;
+}
+
+FixedPool::FixedPool(size_t blockSize, size_t blocksPerSlab, const MemoryTag& tag) :
+    m_blockSize(AlignUp(std::max(blockSize, sizeof(FreeBlock)), alignof(std::max_align_t))),
+    m_blocksPerSlab(std::max<size_t>(blocksPerSlab, 1)),
+    m_tag(tag),
+    m_freeList(nullptr),
+    m_slabUsed(0)
+{
+}
+
+FixedPool::~FixedPool()
+{
+    for (const std::unique_ptr<uint8_t[]>& slab : m_slabs)
+    {
+        GetMemoryTracker().Untrack(slab.get());
+    }
+}
+
+void* FixedPool::Allocate()
+{
+    if (m_freeList)
+    {
+        FreeBlock* block = m_freeList;
+        m_freeList = block->Next;
+        return block;
+    }
+
+    // Carve blocks out of the newest slab lazily, so a new slab costs nothing until used.
+    if (m_slabs.empty() || m_slabUsed == m_blocksPerSlab)
+    {
+        m_slabs.emplace_back(new uint8_t[m_blockSize * m_blocksPerSlab]);
+        GetMemoryTracker().Track(m_slabs.back().get(), m_blockSize * m_blocksPerSlab, m_tag);
+        m_slabUsed = 0;
+    }
+    return m_slabs.back().get() + m_blockSize * m_slabUsed++;
+}
+
+void FixedPool::Free(void* block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->Next = m_freeList;
+    m_freeList = freeBlock;
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "MemoryTracker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+class TimelineFence;
+
+// CPU allocators for temporaries, so hot paths don't go through the global heap:
+// - LinearArena: bump allocation, everything freed at once by Reset or Rewind.
+// - FrameArenaRing: one arena per frame in flight, reset once the GPU has finished that frame.
+// - Thread scratch: a LinearArena per thread, used as a stack through ScratchScope.
+// - FixedPool: free list of equal sized blocks.
+// None of them is thread-safe; use one per thread (the scratch arenas are) or lock around them.
+// ArenaAllocator and PoolAllocator adapt them for standard containers.
+// Their blocks are reported to GetMemoryTracker() under the tag given at construction.
+
+class LinearArena
+{
+public:
+    // A position in the arena, to go back to with Rewind.
+    struct Marker
+    {
+        size_t Block;
+        size_t Offset;
+    };
+
+    // Memory is reserved in blocks of blockSize bytes, or more for a larger allocation.
+    explicit LinearArena(size_t blockSize = 64 * 1024, const MemoryTag& tag = MemoryTag(MemoryCategory::CpuStaging, "linear arena"));
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* Allocate(size_t count)
+    {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Frees everything. The blocks are kept, so an arena stops allocating once it has grown to
+    // its high water mark.
+    void Reset() { m_block = 0; m_offset = 0; }
+
+    Marker GetMarker() const { return { m_block, m_offset }; }
+    // Frees everything allocated after the marker was taken.
+    void Rewind(const Marker& marker) { m_block = marker.Block; m_offset = marker.Offset; }
+
+    size_t GetCapacity() const;
+    // Bytes up to the current position, counting what alignment and skipped block ends wasted.
+    size_t GetUsedBytes() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> Data;
+        size_t Size;
+    };
+
+    size_t m_blockSize;
+    MemoryTag m_tag;
+    std::vector<Block> m_blocks;
+    size_t m_block;
+    size_t m_offset;
+};
+
+// Per-frame arenas. BeginFrame moves to the next arena, waiting for the GPU to pass the fence
+// value recorded for it by EndFrame (normally long done), then resets it. Data that the frame's
+// commands refer to can live in the arena until the GPU is finished with them.
+class FrameArenaRing
+{
+public:
+    FrameArenaRing(TimelineFence& timeline, uint32_t frameCount, size_t blockSize = 256 * 1024);
+
+    LinearArena& BeginFrame();
+    // The fence value signaled after the current frame's commands.
+    void EndFrame(uint64_t fenceValue);
+
+    LinearArena& GetCurrent() { return *m_arenas[m_current]; }
+
+private:
+    TimelineFence& m_timeline;
+    std::vector<std::unique_ptr<LinearArena>> m_arenas;
+    std::vector<uint64_t> m_fenceValues;
+    uint32_t m_current;
+};
+
+// The calling thread's scratch arena, created on first use.
+LinearArena& GetThreadScratch();
+
+// Scratch allocations of a scope: everything allocated from the thread's scratch arena while it
+// is alive is freed when it ends. Scopes nest like the calls that create them.
+class ScratchScope
+{
+public:
+    ScratchScope() : m_arena(GetThreadScratch()), m_marker(m_arena.GetMarker()) {}
+    ~ScratchScope() { m_arena.Rewind(m_marker); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    template <typename T>
+    T* Allocate(size_t count) { return m_arena.Allocate<T>(count); }
+
+    LinearArena& GetArena() { return m_arena; }
+
+private:
+    LinearArena& m_arena;
+    LinearArena::Marker m_marker;
+};
+
+class FixedPool
+{
+public:
+    // Blocks are rounded up to the fundamental alignment and carved from slabs of blocksPerSlab.
+    explicit FixedPool(size_t blockSize, size_t blocksPerSlab = 256, const MemoryTag& tag = MemoryTag(MemoryCategory::Other, "fixed pool"));
+    ~FixedPool();
+
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    void* Allocate();
+    void Free(void* block);
+
+    size_t GetBlockSize() const { return m_blockSize; }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    size_t m_blockSize;
+    size_t m_blocksPerSlab;
+    MemoryTag m_tag;
+    std::vector<std::unique_ptr<uint8_t[]>> m_slabs;
+    FreeBlock* m_freeList;
+    size_t m_slabUsed;          // Blocks handed out from the newest slab.
+};
+
+// Standard allocator over a LinearArena. deallocate does nothing: the memory comes back when the
+// arena is reset or rewound, so the container must not outlive that.
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(LinearArena& arena) : m_arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.GetArena()) {}
+
+    T* allocate(size_t count) { return m_arena->Allocate<T>(count); }
+    void deallocate(T* /*pointer*/, size_t /*count*/) {}
+
+    LinearArena* GetArena() const { return m_arena; }
+
+private:
+    LinearArena* m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.GetArena() == b.GetArena(); }
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.GetArena() != b.GetArena(); }
+
+// Standard allocator over a FixedPool, for node based containers (list, map, unordered_map
+// nodes): single objects that fit a pool block come from the pool. Anything else (arrays,
+// bucket tables) falls back to the global heap, so size the pool for the container's node.
+template <typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+
+    explicit PoolAllocator(FixedPool& pool) : m_pool(&pool) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : m_pool(other.GetPool()) {}
+
+    T* allocate(size_t count)
+    {
+        if (FromPool(count))
+        {
+            return static_cast<T*>(m_pool->Allocate());
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count)
+    {
+        if (FromPool(count))
+        {
+            m_pool->Free(pointer);
+        }
+        else
+        {
+            ::operator delete(pointer);
+        }
+    }
+
+    FixedPool* GetPool() const { return m_pool; }
+
+private:
+    bool FromPool(size_t count) const
+    {
+        return count == 1 && sizeof(T) <= m_pool->GetBlockSize() && alignof(T) <= alignof(std::max_align_t);
+    }
+
+    FixedPool* m_pool;
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b) { return a.GetPool() == b.GetPool(); }
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b) { return a.GetPool() != b.GetPool(); }
+
+// A vector stored in a LinearArena, such as the thread's scratch arena.
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,173 @@
+#include "FrameStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    double Percentile(const std::vector<double>& sorted, double percent)
+    {
+        const size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * sorted.size()));
+        return sorted[rank > 0 ? rank - 1 : 0];
+    }
+
+    // Context values are free text; keep the CSV columns intact.
+    std::string EscapeCsv(const std::string& value)
+    {
+        if (value.find_first_of(",\"\n") == std::string::npos)
+        {
+            return value;
+        }
+
+        std::string escaped = "\"";
+        for (char c : value)
+        {
+            if (c == '"')
+            {
+                escaped += '"';
+            }
+            escaped += c;
+        }
+        return escaped + "\"";
+    }
+
+    std::string EscapeJson(const std::string& value)
+    {
+        std::string escaped;
+        for (char c : value)
+        {
+            switch (c)
+            {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    const char* digits = "0123456789abcdef";
+                    escaped += "\\u00";
+                    escaped += digits[(c >> 4) & 0xF];
+                    escaped += digits[c & 0xF];
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+        }
+        return escaped;
+    }
+
+    void WriteJsonSummary(std::ostream& out, const FrameTimeSummary& summary)
+    {
+        out << "{ \"frames\": " << summary.FrameCount
+            << ", \"mean_ms\": " << summary.Mean
+            << ", \"p50_ms\": " << summary.P50
+            << ", \"p95_ms\": " << summary.P95
+            << ", \"p99_ms\": " << summary.P99
+            << ", \"max_ms\": " << summary.Max
+            << ", \"stutters\": " << summary.StutterCount << " }";
+    }
+}
+
+FrameStatistics::FrameStatistics(double stutterFactor) :
+    m_stutterFactor(stutterFactor)
+{
+}
+
+void FrameStatistics::Reserve(size_t frameCount)
+{
+    m_cpu.reserve(frameCount);
+    m_gpu.reserve(frameCount);
+}
+
+void FrameStatistics::Clear()
+{
+    m_cpu.clear();
+    m_gpu.clear();
+}
+
+void FrameStatistics::SetContext(const std::string& key, const std::string& value)
+{
+    for (auto& entry : m_context)
+    {
+        if (entry.first == key)
+        {
+            entry.second = value;
+            return;
+        }
+    }
+    m_context.emplace_back(key, value);
+}
+
+FrameTimeSummary FrameStatistics::Summarize(const std::vector<double>& milliseconds, double stutterFactor)
+{
+    FrameTimeSummary summary = {};
+    if (milliseconds.empty())
+    {
+        return summary;
+    }
+
+    std::vector<double> sorted(milliseconds);
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for (double value : sorted)
+    {
+        total += value;
+    }
+
+    summary.FrameCount = sorted.size();
+    summary.Mean = total / sorted.size();
+    summary.P50 = Percentile(sorted, 50.0);
+    summary.P95 = Percentile(sorted, 95.0);
+    summary.P99 = Percentile(sorted, 99.0);
+    summary.Max = sorted.back();
+
+    const double threshold = summary.P50 * stutterFactor;
+    summary.StutterCount = sorted.end() - std::upper_bound(sorted.begin(), sorted.end(), threshold);
+    return summary;
+}
+
+void FrameStatistics::WriteCsv(std::ostream& out) const
+{
+    for (const auto& entry : m_context)
+    {
+        out << EscapeCsv(entry.first) << ',';
+    }
+    out << "series,frames,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,stutters\n";
+
+    const std::pair<const char*, FrameTimeSummary> series[] =
+    {
+        { "cpu", SummarizeCpu() },
+        { "gpu", SummarizeGpu() },
+    };
+    for (const auto& row : series)
+    {
+        for (const auto& entry : m_context)
+        {
+            out << EscapeCsv(entry.second) << ',';
+        }
+        const FrameTimeSummary& s = row.second;
+        out << row.first << ',' << s.FrameCount << ',' << s.Mean << ',' << s.P50 << ',' << s.P95 << ','
+            << s.P99 << ',' << s.Max << ',' << s.StutterCount << '\n';
+    }
+}
+
+void FrameStatistics::WriteJson(std::ostream& out) const
+{
+    out << "{\n  \"context\": {";
+    for (size_t i = 0; i < m_context.size(); ++i)
+    {
+        out << (i ? ", " : " ") << '"' << EscapeJson(m_context[i].first) << "\": \"" << EscapeJson(m_context[i].second) << '"';
+    }
+    out << (m_context.empty() ? "},\n" : " },\n");
+
+    out << "  \"stutter_factor\": " << m_stutterFactor << ",\n";
+    out << "  \"cpu\": ";
+    WriteJsonSummary(out, SummarizeCpu());
+    out << ",\n  \"gpu\": ";
+    WriteJsonSummary(out, SummarizeGpu());
+    out << "\n}\n";
+}
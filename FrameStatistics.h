@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Summary of one series of frame times, in milliseconds.
+struct FrameTimeSummary
+{
+    size_t FrameCount;
+    double Mean;
+    double P50;
+    double P95;
+    double P99;
+    double Max;
+    // Frames longer than the stutter factor times the median of the series.
+    size_t StutterCount;
+};
+
+// Collects CPU and GPU frame times of a benchmark run and writes the report the perf lab ingests.
+// CPU and GPU samples are separate series: GPU times arrive frames later, once their timestamps
+// have been read back, and may be missing when timestamps are unsupported.
+class FrameStatistics
+{
+public:
+    explicit FrameStatistics(double stutterFactor = 2.0);
+
+    void Reserve(size_t frameCount);
+    void Clear();
+
+    void AddCpuFrame(double milliseconds) { m_cpu.push_back(milliseconds); }
+    void AddGpuFrame(double milliseconds) { m_gpu.push_back(milliseconds); }
+
+    // Key/value pairs describing the run (resolution, scene scale...), written with the results.
+    void SetContext(const std::string& key, const std::string& value);
+
+    FrameTimeSummary SummarizeCpu() const { return Summarize(m_cpu, m_stutterFactor); }
+    FrameTimeSummary SummarizeGpu() const { return Summarize(m_gpu, m_stutterFactor); }
+
+    // Nearest rank percentiles. An empty series gives an all zero summary.
+    static FrameTimeSummary Summarize(const std::vector<double>& milliseconds, double stutterFactor);
+
+    // One header row, then one row per series ("cpu", "gpu") with the context as leading columns.
+    void WriteCsv(std::ostream& out) const;
+    void WriteJson(std::ostream& out) const;
+
+private:
+    double m_stutterFactor;
+    std::vector<double> m_cpu;
+    std::vector<double> m_gpu;
+    std::vector<std::pair<std::string, std::string>> m_context;
+};
@@ -0,0 +1,466 @@
+#include "FrustumCuller.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#else
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    const uint32_t AllPlanes = 0x3F;
+
+    // Enough independent subtrees per thread for the pool to balance uneven frusta.
+    const uint32_t TasksPerThread = 4;
+
+    void NormalizePlane(float plane[4])
+    {
+        const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        const float inverse = length > 0.0f ? 1.0f / length : 0.0f;
+        for (int i = 0; i < 4; ++i)
+        {
+            plane[i] *= inverse;
+        }
+    }
+}
+
+void ExtractFrustumPlanes(const float viewProjection[16], FrustumPlanes& out)
+{
+    // Column j of M holds the j-th clip space component: clip.j = dot(float4(v, 1), column j).
+    auto column = [viewProjection](int j, int row) { return viewProjection[row * 4 + j]; };
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const float x = column(0, i), y = column(1, i), z = column(2, i), w = column(3, i);
+        out.Planes[0][i] = w + x;   // Left:   x >= -w
+        out.Planes[1][i] = w - x;   // Right:  x <= w
+        out.Planes[2][i] = w + y;   // Bottom: y >= -w
+        out.Planes[3][i] = w - y;   // Top:    y <= w
+        out.Planes[4][i] = z;       // Near:   z >= 0
+        out.Planes[5][i] = w - z;   // Far:    z <= w
+    }
+
+    for (int p = 0; p < 6; ++p)
+    {
+        NormalizePlane(out.Planes[p]);
+    }
+}
+
+FrustumCuller::FrustumCuller(uint32_t leafSize) :
+    m_leafSize(std::max<uint32_t>(leafSize, 1)),
+    m_needsBuild(false),
+    m_needsRefit(false)
+{
+}
+
+uint32_t FrustumCuller::AddObject(const float center[3], const float extents[3])
+{
+    const uint32_t object = GetObjectCount();
+    m_centerX.push_back(0.0f);
+    m_centerY.push_back(0.0f);
+    m_centerZ.push_back(0.0f);
+    m_extentX.push_back(0.0f);
+    m_extentY.push_back(0.0f);
+    m_extentZ.push_back(0.0f);
+    m_radius.push_back(0.0f);
+    m_objectOfSlot.push_back(object);
+    m_slotOfObject.push_back(object);
+
+    SetBounds(object, center, extents);
+    m_needsBuild = true;
+    return object;
+}
+
+void FrustumCuller::SetBounds(uint32_t object, const float center[3], const float extents[3])
+{
+    const uint32_t slot = m_slotOfObject[object];
+    m_centerX[slot] = center[0];
+    m_centerY[slot] = center[1];
+    m_centerZ[slot] = center[2];
+    m_extentX[slot] = extents[0];
+    m_extentY[slot] = extents[1];
+    m_extentZ[slot] = extents[2];
+    m_radius[slot] = std::sqrt(extents[0] * extents[0] + extents[1] * extents[1] + extents[2] * extents[2]);
+    m_needsRefit = true;
+}
+
+uint32_t FrustumCuller::BuildRecursive(uint32_t* objects, uint32_t begin, uint32_t end, const std::vector<float>& centers)
+{
+    const uint32_t index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node());
+
+    const uint32_t count = end - begin;
+    if (count <= m_leafSize)
+    {
+        m_nodes[index].First = begin;
+        m_nodes[index].Count = count;
+        m_nodes[index].Skip = index + 1;
+        return index;
+    }
+
+    // Median split along the axis where the object centers spread the most.
+    float minCenter[3] = { INFINITY, INFINITY, INFINITY };
+    float maxCenter[3] = { -INFINITY, -INFINITY, -INFINITY };
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            minCenter[a] = std::min(minCenter[a], centers[objects[i] * 3 + a]);
+            maxCenter[a] = std::max(maxCenter[a], centers[objects[i] * 3 + a]);
+        }
+    }
+
+    int axis = 0;
+    for (int a = 1; a < 3; ++a)
+    {
+        if (maxCenter[a] - minCenter[a] > maxCenter[axis] - minCenter[axis])
+        {
+            axis = a;
+        }
+    }
+
+    const uint32_t middle = begin + count / 2;
+    std::nth_element(objects + begin, objects + middle, objects + end, [&centers, axis](uint32_t l, uint32_t r)
+    {
+        return centers[l * 3 + axis] < centers[r * 3 + axis];
+    });
+
+    BuildRecursive(objects, begin, middle, centers);
+    BuildRecursive(objects, middle, end, centers);
+
+    m_nodes[index].First = 0;
+    m_nodes[index].Count = 0;
+    m_nodes[index].Skip = static_cast<uint32_t>(m_nodes.size());
+    return index;
+}
+
+void FrustumCuller::Build()
+{
+    const uint32_t objectCount = GetObjectCount();
+
+    std::vector<float> centers(objectCount * 3);
+    std::vector<uint32_t> order(objectCount);
+    for (uint32_t object = 0; object < objectCount; ++object)
+    {
+        const uint32_t slot = m_slotOfObject[object];
+        centers[object * 3 + 0] = m_centerX[slot];
+        centers[object * 3 + 1] = m_centerY[slot];
+        centers[object * 3 + 2] = m_centerZ[slot];
+        order[object] = object;
+    }
+
+    m_nodes.clear();
+    m_nodes.reserve(objectCount / m_leafSize * 2 + 1);
+    if (objectCount > 0)
+    {
+        BuildRecursive(order.data(), 0, objectCount, centers);
+    }
+
+    // Reorder the bounds so that every leaf covers a contiguous run of slots.
+    auto permute = [&](std::vector<float>& values)
+    {
+        std::vector<float> sorted(objectCount);
+        for (uint32_t slot = 0; slot < objectCount; ++slot)
+        {
+            sorted[slot] = values[m_slotOfObject[order[slot]]];
+        }
+        values.swap(sorted);
+    };
+
+    permute(m_centerX);
+    permute(m_centerY);
+    permute(m_centerZ);
+    permute(m_extentX);
+    permute(m_extentY);
+    permute(m_extentZ);
+    permute(m_radius);
+
+    for (uint32_t slot = 0; slot < objectCount; ++slot)
+    {
+        m_objectOfSlot[slot] = order[slot];
+        m_slotOfObject[order[slot]] = slot;
+    }
+
+    m_needsBuild = false;
+    Refit();
+}
+
+void FrustumCuller::Refit()
+{
+    // Children always come after their parent, so a reverse walk sees them first.
+    for (size_t i = m_nodes.size(); i-- > 0;)
+    {
+        Node& node = m_nodes[i];
+        if (node.Count > 0)
+        {
+            float minBound[3] = { INFINITY, INFINITY, INFINITY };
+            float maxBound[3] = { -INFINITY, -INFINITY, -INFINITY };
+            for (uint32_t slot = node.First; slot < node.First + node.Count; ++slot)
+            {
+                minBound[0] = std::min(minBound[0], m_centerX[slot] - m_extentX[slot]);
+                minBound[1] = std::min(minBound[1], m_centerY[slot] - m_extentY[slot]);
+                minBound[2] = std::min(minBound[2], m_centerZ[slot] - m_extentZ[slot]);
+                maxBound[0] = std::max(maxBound[0], m_centerX[slot] + m_extentX[slot]);
+                maxBound[1] = std::max(maxBound[1], m_centerY[slot] + m_extentY[slot]);
+                maxBound[2] = std::max(maxBound[2], m_centerZ[slot] + m_extentZ[slot]);
+            }
+            for (int a = 0; a < 3; ++a)
+            {
+                node.Min[a] = minBound[a];
+                node.Max[a] = maxBound[a];
+            }
+        }
+        else
+        {
+            const Node& left = m_nodes[i + 1];
+            const Node& right = m_nodes[left.Skip];
+            for (int a = 0; a < 3; ++a)
+            {
+                node.Min[a] = std::min(left.Min[a], right.Min[a]);
+                node.Max[a] = std::max(left.Max[a], right.Max[a]);
+            }
+        }
+    }
+
+    m_needsRefit = false;
+}
+
+void FrustumCuller::AcceptLeaf(const Node& node, std::vector<uint32_t>& out) const
+{
+    out.insert(out.end(), m_objectOfSlot.begin() + node.First, m_objectOfSlot.begin() + node.First + node.Count);
+}
+
+// An object is outside when its center lies further behind any plane than the smaller of its
+// bounding sphere radius and its box's projected half size on the plane normal.
+void FrustumCuller::CullLeaf(const Node& node, uint32_t planeMask, const FrustumPlanes& frustum, std::vector<uint32_t>& out) const
+{
+    uint32_t slot = node.First;
+    const uint32_t end = node.First + node.Count;
+
+#if defined(__AVX__)
+    for (; slot + 8 <= end; slot += 8)
+    {
+        const __m256 cx = _mm256_loadu_ps(&m_centerX[slot]);
+        const __m256 cy = _mm256_loadu_ps(&m_centerY[slot]);
+        const __m256 cz = _mm256_loadu_ps(&m_centerZ[slot]);
+        const __m256 ex = _mm256_loadu_ps(&m_extentX[slot]);
+        const __m256 ey = _mm256_loadu_ps(&m_extentY[slot]);
+        const __m256 ez = _mm256_loadu_ps(&m_extentZ[slot]);
+        const __m256 radius = _mm256_loadu_ps(&m_radius[slot]);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            if (!(planeMask & (1u << p)))
+            {
+                continue;
+            }
+
+            const float* plane = frustum.Planes[p];
+            const __m256 distance = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane[0]), cx), _mm256_mul_ps(_mm256_set1_ps(plane[1]), cy)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane[2]), cz), _mm256_set1_ps(plane[3])));
+            const __m256 boxRadius = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::fabs(plane[0])), ex), _mm256_mul_ps(_mm256_set1_ps(std::fabs(plane[1])), ey)),
+                _mm256_mul_ps(_mm256_set1_ps(std::fabs(plane[2])), ez));
+            const __m256 reach = _mm256_min_ps(radius, boxRadius);
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        const int mask = _mm256_movemask_ps(inside);
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            if (mask & (1 << lane))
+            {
+                out.push_back(m_objectOfSlot[slot + lane]);
+            }
+        }
+    }
+#endif
+
+    for (; slot + 4 <= end; slot += 4)
+    {
+        const __m128 cx = _mm_loadu_ps(&m_centerX[slot]);
+        const __m128 cy = _mm_loadu_ps(&m_centerY[slot]);
+        const __m128 cz = _mm_loadu_ps(&m_centerZ[slot]);
+        const __m128 ex = _mm_loadu_ps(&m_extentX[slot]);
+        const __m128 ey = _mm_loadu_ps(&m_extentY[slot]);
+        const __m128 ez = _mm_loadu_ps(&m_extentZ[slot]);
+        const __m128 radius = _mm_loadu_ps(&m_radius[slot]);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            if (!(planeMask & (1u << p)))
+            {
+                continue;
+            }
+
+            const float* plane = frustum.Planes[p];
+            const __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), cx), _mm_mul_ps(_mm_set1_ps(plane[1]), cy)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), cz), _mm_set1_ps(plane[3])));
+            const __m128 boxRadius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::fabs(plane[0])), ex), _mm_mul_ps(_mm_set1_ps(std::fabs(plane[1])), ey)),
+                _mm_mul_ps(_mm_set1_ps(std::fabs(plane[2])), ez));
+            const __m128 reach = _mm_min_ps(radius, boxRadius);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()));
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            if (mask & (1 << lane))
+            {
+                out.push_back(m_objectOfSlot[slot + lane]);
+            }
+        }
+    }
+
+    for (; slot < end; ++slot)
+    {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; ++p)
+        {
+            if (!(planeMask & (1u << p)))
+            {
+                continue;
+            }
+
+            const float* plane = frustum.Planes[p];
+            const float distance = plane[0] * m_centerX[slot] + plane[1] * m_centerY[slot] + plane[2] * m_centerZ[slot] + plane[3];
+            const float boxRadius = std::fabs(plane[0]) * m_extentX[slot] + std::fabs(plane[1]) * m_extentY[slot] + std::fabs(plane[2]) * m_extentZ[slot];
+            inside = distance + std::min(m_radius[slot], boxRadius) >= 0.0f;
+        }
+
+        if (inside)
+        {
+            out.push_back(m_objectOfSlot[slot]);
+        }
+    }
+}
+
+void FrustumCuller::Traverse(uint32_t nodeIndex, uint32_t planeMask, const FrustumPlanes& frustum, std::vector<uint32_t>& out) const
+{
+    const Node& node = m_nodes[nodeIndex];
+
+    // Classify the node box; planes the box is fully inside of are dropped for the whole subtree.
+    const float center[3] = { (node.Min[0] + node.Max[0]) * 0.5f, (node.Min[1] + node.Max[1]) * 0.5f, (node.Min[2] + node.Max[2]) * 0.5f };
+    const float extents[3] = { (node.Max[0] - node.Min[0]) * 0.5f, (node.Max[1] - node.Min[1]) * 0.5f, (node.Max[2] - node.Min[2]) * 0.5f };
+
+    for (int p = 0; p < 6; ++p)
+    {
+        if (!(planeMask & (1u << p)))
+        {
+            continue;
+        }
+
+        const float* plane = frustum.Planes[p];
+        const float distance = plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3];
+        const float radius = std::fabs(plane[0]) * extents[0] + std::fabs(plane[1]) * extents[1] + std::fabs(plane[2]) * extents[2];
+        if (distance < -radius)
+        {
+            return;
+        }
+        if (distance >= radius)
+        {
+            planeMask &= ~(1u << p);
+        }
+    }
+
+    if (node.Count > 0)
+    {
+        if (planeMask == 0)
+        {
+            AcceptLeaf(node, out);
+        }
+        else
+        {
+            CullLeaf(node, planeMask, frustum, out);
+        }
+        return;
+    }
+
+    if (planeMask == 0)
+    {
+        // Fully inside: every leaf of the subtree is visible.
+        for (uint32_t i = nodeIndex + 1; i < node.Skip; ++i)
+        {
+            if (m_nodes[i].Count > 0)
+            {
+                AcceptLeaf(m_nodes[i], out);
+            }
+        }
+        return;
+    }
+
+    Traverse(nodeIndex + 1, planeMask, frustum, out);
+    Traverse(m_nodes[nodeIndex + 1].Skip, planeMask, frustum, out);
+}
+
+void FrustumCuller::Cull(const FrustumPlanes& frustum, std::vector<uint32_t>& visible, ThreadPool* pool)
+{
+    visible.clear();
+
+    if (m_needsBuild)
+    {
+        Build();
+    }
+    else if (m_needsRefit)
+    {
+        Refit();
+    }
+
+    if (m_nodes.empty())
+    {
+        return;
+    }
+
+    if (!pool)
+    {
+        Traverse(0, AllPlanes, frustum, visible);
+        return;
+    }
+
+    // Split the top of the tree into independent subtrees, breadth first.
+    const size_t targetTasks = static_cast<size_t>(pool->GetConcurrency()) * TasksPerThread;
+    m_taskRoots.assign(1, 0);
+    bool split = true;
+    while (split && m_taskRoots.size() < targetTasks)
+    {
+        split = false;
+        const size_t rootCount = m_taskRoots.size();
+        for (size_t i = 0; i < rootCount; ++i)
+        {
+            const uint32_t root = m_taskRoots[i];
+            if (m_nodes[root].Count == 0)
+            {
+                m_taskRoots[i] = root + 1;
+                m_taskRoots.push_back(m_nodes[root + 1].Skip);
+                split = true;
+            }
+        }
+    }
+
+    // Subtrees are kept in depth-first order so the output order matches a serial traversal.
+    std::sort(m_taskRoots.begin(), m_taskRoots.end());
+
+    m_taskVisible.resize(m_taskRoots.size());
+    pool->ParallelFor(m_taskRoots.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t task = begin; task < end; ++task)
+        {
+            m_taskVisible[task].clear();
+            Traverse(m_taskRoots[task], AllPlanes, frustum, m_taskVisible[task]);
+        }
+    });
+
+    for (const std::vector<uint32_t>& taskVisible : m_taskVisible)
+    {
+        visible.insert(visible.end(), taskVisible.begin(), taskVisible.end());
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Six normalized planes, a * x + b * y + c * z + d >= 0 on the inside.
+// Order: left, right, bottom, top, near, far.
+struct FrustumPlanes
+{
+    float Planes[6][4];
+};
+
+// Extracts the frustum planes of a row-major view-projection matrix that transforms row vectors
+// (DirectXMath convention, clip = v * M) with a [0, 1] depth range.
+void ExtractFrustumPlanes(const float viewProjection[16], FrustumPlanes& out);
+
+// Frustum culling over a flattened bounding volume hierarchy.
+// Object bounds are stored as structure of arrays in BVH leaf order, so every leaf is a
+// contiguous run that is tested 4 (SSE) or 8 (AVX) objects at a time against both the bounding
+// sphere and the box of each object. Nodes are laid out depth first: the left child of a node
+// always follows it and Skip points past its subtree, which is all a bottom-up refit needs.
+class FrustumCuller
+{
+public:
+    explicit FrustumCuller(uint32_t leafSize = 16);
+
+    // Objects added after the last Build trigger a rebuild on the next Cull.
+    uint32_t AddObject(const float center[3], const float extents[3]);
+
+    // Moves an object. The tree topology is kept; the next Cull refits the node bounds.
+    void SetBounds(uint32_t object, const float center[3], const float extents[3]);
+
+    uint32_t GetObjectCount() const { return static_cast<uint32_t>(m_slotOfObject.size()); }
+
+    void Build();
+    void Refit();
+
+    // Appends the ids of every object that intersects the frustum to visible (which is cleared
+    // first). The top of the tree is split into independent subtrees that run across the pool.
+    void Cull(const FrustumPlanes& frustum, std::vector<uint32_t>& visible, ThreadPool* pool = nullptr);
+
+private:
+    struct Node
+    {
+        float Min[3];
+        float Max[3];
+        uint32_t First;     // Leaf: first slot.
+        uint32_t Count;     // Leaf: object count. 0 for internal nodes.
+        uint32_t Skip;      // Index of the node following this subtree.
+        uint32_t Padding;
+    };
+
+    uint32_t BuildRecursive(uint32_t* objects, uint32_t begin, uint32_t end, const std::vector<float>& centers);
+    void Traverse(uint32_t node, uint32_t planeMask, const FrustumPlanes& frustum, std::vector<uint32_t>& out) const;
+    void CullLeaf(const Node& node, uint32_t planeMask, const FrustumPlanes& frustum, std::vector<uint32_t>& out) const;
+    void AcceptLeaf(const Node& node, std::vector<uint32_t>& out) const;
+
+    uint32_t m_leafSize;
+
+    // Object bounds, indexed by slot (BVH leaf order).
+    std::vector<float> m_centerX, m_centerY, m_centerZ;
+    std::vector<float> m_extentX, m_extentY, m_extentZ;
+    std::vector<float> m_radius;
+    std::vector<uint32_t> m_objectOfSlot;
+    std::vector<uint32_t> m_slotOfObject;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_taskRoots;
+    std::vector<std::vector<uint32_t>> m_taskVisible;
+    bool m_needsBuild;
+    bool m_needsRefit;
+};
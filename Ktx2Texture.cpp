@@ -0,0 +1,417 @@
+#include "Ktx2Texture.h"
+#include "ContentHash.h"
+#include "ThreadPool.h"
+#include "Zstd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const uint8_t Ktx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    // D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION.
+    const uint32_t MaxDimension = 16384;
+
+    // Blocks Read hands to a worker at a time; levels are cut into bands of whole block rows.
+    const uint32_t BandBlocks = 1024;
+
+    // Color models of the data format descriptor (Khronos Data Format Specification), which
+    // tell the Basis Universal payloads apart.
+    const uint8_t ColorModelEtc1s = 163;
+    const uint8_t ColorModelUastc = 166;
+
+    // Values are VkFormat; this file has no dependency on the Vulkan headers.
+    bool GetStoredFormat(uint32_t vkFormat, BlockFormat& format, bool& srgb)
+    {
+        switch (vkFormat)
+        {
+        case 37:    // R8G8B8A8_UNORM
+        case 43:    // R8G8B8A8_SRGB
+            format = BlockFormat::Count;
+            srgb = vkFormat == 43;
+            return true;
+        case 131:   // BC1_RGB_UNORM_BLOCK
+        case 132:   // BC1_RGB_SRGB_BLOCK
+        case 133:   // BC1_RGBA_UNORM_BLOCK
+        case 134:   // BC1_RGBA_SRGB_BLOCK
+            format = BlockFormat::BC1;
+            srgb = vkFormat == 132 || vkFormat == 134;
+            return true;
+        case 137:   // BC3_UNORM_BLOCK
+        case 138:   // BC3_SRGB_BLOCK
+            format = BlockFormat::BC3;
+            srgb = vkFormat == 138;
+            return true;
+        case 145:   // BC7_UNORM_BLOCK
+        case 146:   // BC7_SRGB_BLOCK
+            format = BlockFormat::BC7;
+            srgb = vkFormat == 146;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Bytes of one level as stored: RGBA8 texels, or rows of blocks.
+    uint64_t GetLevelSize(BlockFormat storedFormat, uint32_t width, uint32_t height)
+    {
+        if (storedFormat == BlockFormat::Count)
+        {
+            return static_cast<uint64_t>(width) * height * 4;
+        }
+        const uint64_t blocksWide = (width + BlockDimension - 1) / BlockDimension;
+        const uint64_t blocksHigh = (height + BlockDimension - 1) / BlockDimension;
+        return blocksWide * blocksHigh * GetBlockSize(storedFormat);
+    }
+
+    // Rows [FirstBlockRow, FirstBlockRow + BlockRowCount) of one level, the unit of work of Read.
+    struct LevelBand
+    {
+        uint32_t Level;
+        uint32_t FirstBlockRow;
+        uint32_t BlockRowCount;
+    };
+}
+
+Ktx2Texture::Ktx2Texture() :
+    m_data(nullptr),
+    m_size(0),
+#if defined(_WIN32)
+    m_file(INVALID_HANDLE_VALUE),
+    m_mapping(nullptr),
+#endif
+    m_header(nullptr),
+    m_storedFormat(BlockFormat::Count),
+    m_srgb(false)
+{
+}
+
+Ktx2Texture::~Ktx2Texture()
+{
+    Close();
+}
+
+#if defined(_WIN32)
+
+void Ktx2Texture::Open(const char* path, ThreadPool* pool)
+{
+    std::wstring widePath(MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, &widePath[0], static_cast<int>(widePath.size()));
+    Open(widePath.c_str(), pool);
+}
+
+void Ktx2Texture::Open(const wchar_t* path, ThreadPool* pool)
+{
+    Close();
+
+    m_file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Ktx2Texture: can't open file");
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+    {
+        Close();
+        throw std::runtime_error("Ktx2Texture: can't read file size");
+    }
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_data = m_mapping ? static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!m_data)
+    {
+        Close();
+        throw std::runtime_error("Ktx2Texture: can't map file");
+    }
+    m_size = static_cast<uint64_t>(size.QuadPart);
+
+    Validate();
+    Inflate(pool);
+}
+
+void Ktx2Texture::Close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+    m_header = nullptr;
+    m_levels.clear();
+    m_inflated.clear();
+}
+
+#else
+
+void Ktx2Texture::Open(const char* path, ThreadPool* pool)
+{
+    Close();
+
+    const int file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        throw std::runtime_error("Ktx2Texture: can't open file");
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        throw std::runtime_error("Ktx2Texture: can't read file size");
+    }
+
+    // The mapping keeps its own reference to the file.
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        throw std::runtime_error("Ktx2Texture: can't map file");
+    }
+
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = static_cast<uint64_t>(info.st_size);
+
+    Validate();
+    Inflate(pool);
+}
+
+void Ktx2Texture::Close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_levels.clear();
+    m_inflated.clear();
+}
+
+#endif
+
+void Ktx2Texture::Validate()
+{
+    auto fail = [this](const char* message)
+    {
+        Close();
+        throw std::runtime_error(message);
+    };
+
+    if (m_size < sizeof(Ktx2Header))
+    {
+        fail("Ktx2Texture: file too small");
+    }
+
+    m_header = reinterpret_cast<const Ktx2Header*>(m_data);
+    if (memcmp(m_header->Identifier, Ktx2Identifier, sizeof(Ktx2Identifier)) != 0)
+    {
+        fail("Ktx2Texture: not a KTX2 file");
+    }
+
+    // Basis Universal files have no VkFormat: the data format descriptor says which kind they are.
+    if (m_header->SupercompressionScheme == Ktx2Supercompression::BasisLZ)
+    {
+        fail("Ktx2Texture: Basis Universal ETC1S (BasisLZ) textures are not supported");
+    }
+    if (m_header->VkFormat == 0)
+    {
+        const uint64_t colorModel = static_cast<uint64_t>(m_header->DfdByteOffset) + 12;
+        if (m_header->DfdByteLength > 12 && colorModel < m_size &&
+            (m_data[colorModel] == ColorModelUastc || m_data[colorModel] == ColorModelEtc1s))
+        {
+            fail("Ktx2Texture: Basis Universal (UASTC, ETC1S) textures are not supported");
+        }
+        fail("Ktx2Texture: textures without a VkFormat are not supported");
+    }
+    if (m_header->SupercompressionScheme != Ktx2Supercompression::None && m_header->SupercompressionScheme != Ktx2Supercompression::Zstandard)
+    {
+        fail("Ktx2Texture: only Zstandard supercompression is supported");
+    }
+    if (!GetStoredFormat(m_header->VkFormat, m_storedFormat, m_srgb))
+    {
+        fail("Ktx2Texture: unsupported VkFormat (RGBA8, BC1, BC3 and BC7 are)");
+    }
+
+    const uint32_t width = m_header->PixelWidth;
+    const uint32_t height = m_header->PixelHeight;
+    if (width == 0 || height == 0 || width > MaxDimension || height > MaxDimension ||
+        m_header->PixelDepth != 0 || m_header->LayerCount > 1 || m_header->FaceCount != 1)
+    {
+        fail("Ktx2Texture: must be a single 2D texture");
+    }
+
+    uint32_t maxLevels = 1;
+    while ((std::max(width, height) >> maxLevels) != 0)
+    {
+        ++maxLevels;
+    }
+    const uint32_t levelCount = std::max(1u, m_header->LevelCount);
+    if (levelCount > maxLevels || sizeof(Ktx2Header) + static_cast<uint64_t>(levelCount) * sizeof(Ktx2Level) > m_size)
+    {
+        fail("Ktx2Texture: level index out of bounds");
+    }
+
+    // Check everything Inflate and Read rely on once here, so they never read outside the file.
+    const Ktx2Level* index = reinterpret_cast<const Ktx2Level*>(m_data + sizeof(Ktx2Header));
+    const bool supercompressed = m_header->SupercompressionScheme != Ktx2Supercompression::None;
+    m_levels.resize(levelCount);
+    for (uint32_t level = 0; level < levelCount; ++level)
+    {
+        const Ktx2Level& entry = index[level];
+        const uint64_t size = GetLevelSize(m_storedFormat, std::max(1u, width >> level), std::max(1u, height >> level));
+        if (entry.ByteOffset > m_size || entry.ByteLength > m_size - entry.ByteOffset ||
+            entry.UncompressedByteLength != size || (!supercompressed && entry.ByteLength != size))
+        {
+            fail("Ktx2Texture: level out of bounds or of the wrong size");
+        }
+        m_levels[level] = m_data + entry.ByteOffset;
+    }
+}
+
+void Ktx2Texture::Inflate(ThreadPool* pool)
+{
+    if (m_header->SupercompressionScheme != Ktx2Supercompression::Zstandard)
+    {
+        return;
+    }
+
+    // Each level is a Zstandard stream of its own. Zstandard matches read earlier output, so
+    // levels are inflated into memory of their own rather than into the upload heap.
+    const Ktx2Level* index = reinterpret_cast<const Ktx2Level*>(m_data + sizeof(Ktx2Header));
+    m_inflated.resize(m_levels.size());
+    auto inflateLevels = [&](size_t begin, size_t end)
+    {
+        for (size_t level = begin; level < end; ++level)
+        {
+            const Ktx2Level& entry = index[level];
+            std::vector<uint8_t>& data = m_inflated[level];
+            data.resize(static_cast<size_t>(entry.UncompressedByteLength));
+            if (!ZstdDecompress(m_data + entry.ByteOffset, static_cast<size_t>(entry.ByteLength), data.data(), data.size()))
+            {
+                throw std::runtime_error("Ktx2Texture: corrupt level");
+            }
+        }
+    };
+
+    try
+    {
+        if (pool && m_levels.size() > 1)
+        {
+            pool->ParallelFor(m_levels.size(), 1, inflateLevels);
+        }
+        else
+        {
+            inflateLevels(0, m_levels.size());
+        }
+    }
+    catch (...)
+    {
+        Close();
+        throw;
+    }
+
+    for (size_t level = 0; level < m_levels.size(); ++level)
+    {
+        m_levels[level] = m_inflated[level].data();
+    }
+}
+
+uint32_t Ktx2Texture::GetDxgiFormat(BlockFormat target) const
+{
+    return GetBlockFormatDxgi(IsBlockCompressed() ? m_storedFormat : target, m_srgb);
+}
+
+uint64_t Ktx2Texture::HashFileContent() const
+{
+    return HashContent(m_data, static_cast<size_t>(m_size));
+}
+
+void Ktx2Texture::Read(BlockFormat target, const SubresourceFootprint* footprints, void* dest, ThreadPool* pool) const
+{
+    const BlockFormat format = IsBlockCompressed() ? m_storedFormat : target;
+    const uint32_t blockSize = GetBlockSize(format);
+    uint8_t* const output = static_cast<uint8_t*>(dest);
+
+    // Bands of about BandBlocks blocks over every level, so the small levels don't leave
+    // workers idle at the end of each one.
+    std::vector<LevelBand> bands;
+    for (uint32_t level = 0; level < m_levels.size(); ++level)
+    {
+        const uint32_t width = std::max(1u, m_header->PixelWidth >> level);
+        const uint32_t height = std::max(1u, m_header->PixelHeight >> level);
+        const uint32_t blocksWide = (width + BlockDimension - 1) / BlockDimension;
+        const uint32_t blocksHigh = (height + BlockDimension - 1) / BlockDimension;
+        const uint32_t rowsPerBand = std::max(1u, BandBlocks / blocksWide);
+        for (uint32_t row = 0; row < blocksHigh; row += rowsPerBand)
+        {
+            bands.push_back({ level, row, std::min(rowsPerBand, blocksHigh - row) });
+        }
+    }
+
+    auto readBands = [&](size_t begin, size_t end)
+    {
+        for (size_t b = begin; b < end; ++b)
+        {
+            const LevelBand& band = bands[b];
+            const SubresourceFootprint& footprint = footprints[band.Level];
+            const uint32_t width = std::max(1u, m_header->PixelWidth >> band.Level);
+            const uint32_t height = std::max(1u, m_header->PixelHeight >> band.Level);
+            const uint8_t* source = m_levels[band.Level];
+            uint8_t* level = output + footprint.Offset;
+            if (!IsBlockCompressed())
+            {
+                EncodeBlockRows(format, source, static_cast<size_t>(width) * 4, width, height,
+                    band.FirstBlockRow, band.BlockRowCount, level, footprint.RowPitch);
+                continue;
+            }
+
+            // Stored blocks: only the row pitch differs.
+            const size_t rowSize = static_cast<size_t>((width + BlockDimension - 1) / BlockDimension) * blockSize;
+            for (uint32_t row = band.FirstBlockRow; row < band.FirstBlockRow + band.BlockRowCount; ++row)
+            {
+                memcpy(level + static_cast<size_t>(row) * footprint.RowPitch, source + row * rowSize, rowSize);
+            }
+        }
+    };
+
+    if (pool && bands.size() > 1)
+    {
+        pool->ParallelFor(bands.size(), 1, readBands);
+    }
+    else
+    {
+        readBands(0, bands.size());
+    }
+}
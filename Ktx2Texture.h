@@ -0,0 +1,119 @@
+#pragma once
+
+#include "AssetArchive.h"
+#include "BlockCompression.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// KTX 2.0 texture files (Khronos KTX File Format Specification 2.0).
+//
+// File layout:
+//   Ktx2Header
+//   Ktx2Level[LevelCount]      level 0 (the largest) first
+//   data format descriptor, key/value data, supercompression global data
+//   mip levels                 usually the smallest first, each one supercompressed on its own
+//
+// Supported: single 2D textures (no array layers, no cube faces) of RGBA8 texels, which are
+// encoded into BC1, BC3 or BC7 as they are read, or already block compressed as BC1, BC3 or BC7,
+// which are copied. Levels may be Zstandard supercompressed. Basis Universal payloads (ETC1S with
+// BasisLZ, UASTC) and zlib supercompression are rejected. All values are little endian.
+
+enum class Ktx2Supercompression : uint32_t
+{
+    None = 0,
+    BasisLZ = 1,
+    Zstandard = 2,
+    Zlib = 3,
+};
+
+struct Ktx2Header
+{
+    uint8_t Identifier[12];     // "\xABKTX 20\xBB\r\n\x1A\n"
+    uint32_t VkFormat;          // VkFormat; 0 (undefined) for Basis Universal.
+    uint32_t TypeSize;
+    uint32_t PixelWidth;
+    uint32_t PixelHeight;
+    uint32_t PixelDepth;
+    uint32_t LayerCount;
+    uint32_t FaceCount;
+    uint32_t LevelCount;        // 0: generate the mips at load time; only level 0 is stored.
+    Ktx2Supercompression SupercompressionScheme;
+    uint32_t DfdByteOffset;
+    uint32_t DfdByteLength;
+    uint32_t KvdByteOffset;
+    uint32_t KvdByteLength;
+    uint64_t SgdByteOffset;
+    uint64_t SgdByteLength;
+};
+static_assert(sizeof(Ktx2Header) == 80, "Ktx2Header is part of the file format.");
+
+struct Ktx2Level
+{
+    uint64_t ByteOffset;
+    uint64_t ByteLength;
+    uint64_t UncompressedByteLength;
+};
+static_assert(sizeof(Ktx2Level) == 24, "Ktx2Level is part of the file format.");
+
+// Read side of a KTX2 file. The file is memory mapped; supercompressed levels are inflated by Open.
+class Ktx2Texture
+{
+public:
+    Ktx2Texture();
+    ~Ktx2Texture();
+
+    Ktx2Texture(const Ktx2Texture&) = delete;
+    Ktx2Texture& operator=(const Ktx2Texture&) = delete;
+
+    // Throws std::runtime_error if the file can't be mapped, is not a valid KTX2 file or is not
+    // a kind this reader supports. Supercompressed levels are inflated across the pool.
+    void Open(const char* path, ThreadPool* pool = nullptr);
+#if defined(_WIN32)
+    void Open(const wchar_t* path, ThreadPool* pool = nullptr);
+#endif
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    uint32_t GetWidth() const { return m_header->PixelWidth; }
+    uint32_t GetHeight() const { return m_header->PixelHeight; }
+    uint16_t GetMipLevels() const { return static_cast<uint16_t>(m_levels.size()); }
+    bool IsSrgb() const { return m_srgb; }
+
+    // True when the levels are stored block compressed, so Read copies them whatever the target.
+    bool IsBlockCompressed() const { return m_storedFormat != BlockFormat::Count; }
+
+    // The DXGI_FORMAT Read writes: the stored block format, or target for RGBA8 texels.
+    uint32_t GetDxgiFormat(BlockFormat target) const;
+
+    // HashContent of the whole file, for a resource cache key.
+    uint64_t HashFileContent() const;
+
+    // Writes every level, block compressed, at footprints[level] in dest: the layout
+    // ComputeCopyableFootprints gives for GetDxgiFormat(target). dest is only written, never
+    // read, so it can be mapped upload heap memory. Rows of blocks of all the levels are spread
+    // over the pool.
+    void Read(BlockFormat target, const SubresourceFootprint* footprints, void* dest, ThreadPool* pool = nullptr) const;
+
+private:
+    void Validate();
+    void Inflate(ThreadPool* pool);
+
+    const uint8_t* m_data;
+    uint64_t m_size;
+#if defined(_WIN32)
+    void* m_file;
+    void* m_mapping;
+#endif
+
+    const Ktx2Header* m_header;
+    BlockFormat m_storedFormat;             // Count: RGBA8 texels.
+    bool m_srgb;
+
+    // Each level's bytes: in the mapping, or in m_inflated for a supercompressed file.
+    std::vector<const uint8_t*> m_levels;
+    std::vector<std::vector<uint8_t>> m_inflated;
+};
@@ -0,0 +1,121 @@
+#include "LodSelector.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Closest distance used for the projection, keeps the camera-inside-bounds case finite.
+    const float MinDistance = 1e-3f;
+}
+
+LodSelector::LodSelector(float pixelErrorThreshold, float hysteresis) :
+    m_eye{ 0.0f, 0.0f, 0.0f },
+    m_projectionScale(1.0f),
+    m_pixelErrorThreshold(pixelErrorThreshold),
+    m_hysteresis(hysteresis)
+{
+}
+
+void LodSelector::SetCamera(const float eye[3], float verticalFov, float viewportHeight)
+{
+    m_eye[0] = eye[0];
+    m_eye[1] = eye[1];
+    m_eye[2] = eye[2];
+    m_projectionScale = viewportHeight / (2.0f * std::tan(verticalFov * 0.5f));
+}
+
+uint32_t LodSelector::AddInstance(const float center[3], float radius, float scale, const LodChain& chain)
+{
+    LodInstance instance = {};
+    instance.Levels = chain.Levels.data();
+    instance.LevelCount = static_cast<uint32_t>(chain.Levels.size());
+    instance.SelectedLod = 0;
+    m_instances.push_back(instance);
+
+    const uint32_t id = static_cast<uint32_t>(m_instances.size() - 1);
+    SetInstanceBounds(id, center, radius, scale);
+    return id;
+}
+
+void LodSelector::SetInstanceBounds(uint32_t instance, const float center[3], float radius, float scale)
+{
+    LodInstance& i = m_instances[instance];
+    i.Center[0] = center[0];
+    i.Center[1] = center[1];
+    i.Center[2] = center[2];
+    i.Radius = radius;
+    i.Scale = scale;
+}
+
+const LodLevel& LodSelector::GetSelectedLevel(uint32_t instance) const
+{
+    const LodInstance& i = m_instances[instance];
+    return i.Levels[i.SelectedLod];
+}
+
+float LodSelector::ProjectError(float error, float distance) const
+{
+    return error * m_projectionScale / std::max(distance, MinDistance);
+}
+
+void LodSelector::SelectLod(LodInstance& instance) const
+{
+    if (instance.LevelCount == 0)
+    {
+        return;
+    }
+
+    // Distance to the nearest point of the bounds: the worst case for any part of the object.
+    const float dx = instance.Center[0] - m_eye[0];
+    const float dy = instance.Center[1] - m_eye[1];
+    const float dz = instance.Center[2] - m_eye[2];
+    const float distance = std::sqrt(dx * dx + dy * dy + dz * dz) - instance.Radius;
+
+    uint32_t lod = 0;
+    for (uint32_t l = 1; l < instance.LevelCount; ++l)
+    {
+        if (ProjectError(instance.Levels[l].Error * instance.Scale, distance) > m_pixelErrorThreshold)
+        {
+            break;
+        }
+        lod = l;
+    }
+
+    const uint32_t current = std::min(instance.SelectedLod, instance.LevelCount - 1);
+    if (lod > current)
+    {
+        // Only coarsen as far as the stricter threshold allows.
+        const float strictThreshold = m_pixelErrorThreshold * (1.0f - m_hysteresis);
+        uint32_t coarser = current;
+        while (coarser < lod &&
+            ProjectError(instance.Levels[coarser + 1].Error * instance.Scale, distance) <= strictThreshold)
+        {
+            ++coarser;
+        }
+        lod = coarser;
+    }
+
+    instance.SelectedLod = lod;
+}
+
+void LodSelector::Update(ThreadPool* pool)
+{
+    auto selectRange = [this](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            SelectLod(m_instances[i]);
+        }
+    };
+
+    if (pool)
+    {
+        pool->ParallelFor(m_instances.size(), 1024, selectRange);
+    }
+    else
+    {
+        selectRange(0, m_instances.size());
+    }
+}
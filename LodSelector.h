@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MeshSimplifier.h"
+
+class ThreadPool;
+
+// An object drawn with one of the levels of a LodChain.
+struct LodInstance
+{
+    float Center[3];            // World space bounding sphere.
+    float Radius;
+    float Scale;                // Object to world scale, applied to the level errors.
+    const LodLevel* Levels;     // Sorted from finest (0) to coarsest.
+    uint32_t LevelCount;
+    uint32_t SelectedLod;
+};
+
+// Runtime screen-space error LOD selection.
+// The geometric error of each level is projected to pixels at the instance's distance and the
+// coarsest level that stays under the pixel threshold is selected. Switching to a coarser level
+// requires an extra margin (hysteresis) so objects near the threshold don't pop every frame.
+class LodSelector
+{
+public:
+    LodSelector(float pixelErrorThreshold = 1.0f, float hysteresis = 0.2f);
+
+    void SetCamera(const float eye[3], float verticalFov, float viewportHeight);
+
+    uint32_t AddInstance(const float center[3], float radius, float scale, const LodChain& chain);
+    void SetInstanceBounds(uint32_t instance, const float center[3], float radius, float scale);
+    uint32_t GetSelectedLod(uint32_t instance) const { return m_instances[instance].SelectedLod; }
+    const LodLevel& GetSelectedLevel(uint32_t instance) const;
+    size_t GetInstanceCount() const { return m_instances.size(); }
+
+    // Re-selects the level of every instance. Runs in parallel when a pool is given.
+    void Update(ThreadPool* pool = nullptr);
+
+    // Projected size in pixels of an object space error at the given distance.
+    float ProjectError(float error, float distance) const;
+
+private:
+    void SelectLod(LodInstance& instance) const;
+
+    std::vector<LodInstance> m_instances;
+    float m_eye[3];
+    float m_projectionScale;    // viewportHeight / (2 * tan(fov / 2))
+    float m_pixelErrorThreshold;
+    float m_hysteresis;
+};
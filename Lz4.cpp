@@ -0,0 +1,263 @@
+#include "Lz4.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const size_t MinMatch = 4;
+    // The format requires the last 5 bytes to be literals and the last match to start at least
+    // 12 bytes before the end of the block.
+    const size_t LastLiterals = 5;
+    const size_t MatchFindLimit = 12;
+    const size_t MaxOffset = 65535;
+
+    const int HashBits = 12;
+
+    inline uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint32_t Hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - HashBits);
+    }
+
+    // Writes a length that did not fit in a token nibble: runs of 255 and a final remainder.
+    inline bool WriteLength(uint8_t*& out, const uint8_t* outEnd, size_t length)
+    {
+        while (length >= 255)
+        {
+            if (out >= outEnd)
+            {
+                return false;
+            }
+            *out++ = 255;
+            length -= 255;
+        }
+        if (out >= outEnd)
+        {
+            return false;
+        }
+        *out++ = static_cast<uint8_t>(length);
+        return true;
+    }
+
+    inline bool WriteSequence(
+        uint8_t*& out,
+        const uint8_t* outEnd,
+        const uint8_t* literals,
+        size_t literalLength,
+        size_t offset,
+        size_t matchLength)
+    {
+        if (out >= outEnd)
+        {
+            return false;
+        }
+
+        uint8_t* token = out++;
+        *token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+        if (literalLength >= 15 && !WriteLength(out, outEnd, literalLength - 15))
+        {
+            return false;
+        }
+
+        if (static_cast<size_t>(outEnd - out) < literalLength)
+        {
+            return false;
+        }
+        if (literalLength > 0)
+        {
+            memcpy(out, literals, literalLength);
+            out += literalLength;
+        }
+
+        // The final sequence of a block has literals only.
+        if (matchLength == 0)
+        {
+            return true;
+        }
+
+        if (outEnd - out < 2)
+        {
+            return false;
+        }
+        *out++ = static_cast<uint8_t>(offset & 0xFF);
+        *out++ = static_cast<uint8_t>(offset >> 8);
+
+        const size_t code = matchLength - MinMatch;
+        *token |= static_cast<uint8_t>(code >= 15 ? 15 : code);
+        return code < 15 || WriteLength(out, outEnd, code - 15);
+    }
+}
+
+size_t Lz4CompressBound(size_t sourceSize)
+{
+    return sourceSize + sourceSize / 255 + 16;
+}
+
+size_t Lz4Compress(const void* source, size_t sourceSize, void* dest, size_t destCapacity)
+{
+    const uint8_t* const input = static_cast<const uint8_t*>(source);
+    const uint8_t* const inputEnd = input + sourceSize;
+    uint8_t* out = static_cast<uint8_t*>(dest);
+    const uint8_t* const outEnd = out + destCapacity;
+
+    const uint8_t* anchor = input;
+
+    if (sourceSize > MatchFindLimit)
+    {
+        const uint8_t* const matchLimit = inputEnd - LastLiterals;
+        const uint8_t* const findLimit = inputEnd - MatchFindLimit;
+
+        // Positions are stored relative to the input; every entry starts at 0, which is harmless
+        // because candidates are verified before use.
+        std::vector<uint32_t> table(size_t(1) << HashBits, 0);
+
+        const uint8_t* ip = input + 1;
+        while (ip < findLimit)
+        {
+            const uint32_t sequence = Read32(ip);
+            const uint32_t hash = Hash(sequence);
+            const uint8_t* candidate = input + table[hash];
+            table[hash] = static_cast<uint32_t>(ip - input);
+
+            if (candidate >= ip || static_cast<size_t>(ip - candidate) > MaxOffset || Read32(candidate) != sequence)
+            {
+                // Skip faster through data that does not compress.
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            while (ip > anchor && candidate > input && ip[-1] == candidate[-1])
+            {
+                --ip;
+                --candidate;
+            }
+
+            size_t matchLength = MinMatch;
+            while (ip + matchLength < matchLimit && ip[matchLength] == candidate[matchLength])
+            {
+                ++matchLength;
+            }
+
+            if (!WriteSequence(out, outEnd, anchor, ip - anchor, ip - candidate, matchLength))
+            {
+                return 0;
+            }
+
+            ip += matchLength;
+            anchor = ip;
+
+            if (ip < findLimit)
+            {
+                table[Hash(Read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - input);
+            }
+        }
+    }
+
+    if (!WriteSequence(out, outEnd, anchor, inputEnd - anchor, 0, 0))
+    {
+        return 0;
+    }
+
+    return out - static_cast<uint8_t*>(dest);
+}
+
+bool Lz4Decompress(const void* source, size_t sourceSize, void* dest, size_t destSize)
+{
+    const uint8_t* in = static_cast<const uint8_t*>(source);
+    const uint8_t* const inEnd = in + sourceSize;
+    uint8_t* const outStart = static_cast<uint8_t*>(dest);
+    uint8_t* out = outStart;
+    uint8_t* const outEnd = out + destSize;
+
+    while (in < inEnd)
+    {
+        const uint8_t token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15)
+        {
+            uint8_t extra;
+            do
+            {
+                if (in >= inEnd)
+                {
+                    return false;
+                }
+                extra = *in++;
+                literalLength += extra;
+            } while (extra == 255);
+        }
+
+        if (static_cast<size_t>(inEnd - in) < literalLength || static_cast<size_t>(outEnd - out) < literalLength)
+        {
+            return false;
+        }
+        if (literalLength > 0)
+        {
+            memcpy(out, in, literalLength);
+            in += literalLength;
+            out += literalLength;
+        }
+
+        if (in == inEnd)
+        {
+            break;
+        }
+
+        if (inEnd - in < 2)
+        {
+            return false;
+        }
+        const size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > static_cast<size_t>(out - outStart))
+        {
+            return false;
+        }
+
+        size_t matchLength = (token & 15) + MinMatch;
+        if ((token & 15) == 15)
+        {
+            uint8_t extra;
+            do
+            {
+                if (in >= inEnd)
+                {
+                    return false;
+                }
+                extra = *in++;
+                matchLength += extra;
+            } while (extra == 255);
+        }
+
+        if (static_cast<size_t>(outEnd - out) < matchLength)
+        {
+            return false;
+        }
+
+        const uint8_t* match = out - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(out, match, matchLength);
+            out += matchLength;
+        }
+        else
+        {
+            // Overlapping copy repeats the last offset bytes (run-length style).
+            for (size_t i = 0; i < matchLength; ++i)
+            {
+                *out++ = *match++;
+            }
+        }
+    }
+
+    return out == outEnd;
+}
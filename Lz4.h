@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+// LZ4 block format (no frame header), byte compatible with the reference LZ4_compress_default /
+// LZ4_decompress_safe. Only the block format is implemented: sizes are stored by the caller, which
+// is all the asset archive needs and keeps the code free of external dependencies.
+
+// Worst case size of the compressed output.
+size_t Lz4CompressBound(size_t sourceSize);
+
+// Returns the compressed size, or 0 if the output does not fit in destCapacity.
+size_t Lz4Compress(const void* source, size_t sourceSize, void* dest, size_t destCapacity);
+
+// Decompresses a block that must expand to exactly destSize bytes. Malformed input never reads or
+// writes out of bounds; it just returns false.
+bool Lz4Decompress(const void* source, size_t sourceSize, void* dest, size_t destSize);
@@ -1,10 +1,18 @@
 #include "Stdafx.h"
+#include "AssetPacker.h"
 #include "D3D12HelloTexture.h"
 
-// ڸ Լ Ǹ м  ּ   .
+// 인텔리센스가 함수 정의를 분석할 때 주석 정보를 가져오도록 함.
 _Use_decl_annotations_
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance, LPSTR cmdLine, int nCmdShow)
 {
+    // "-pack <archive> <files...>" runs the asset packer instead of the sample.
+    // 첫 인자가 -pack 이면 샘플 대신 에셋 패커를 실행한다.
+    if (__argc >= 2 && _stricmp(__argv[1], "-pack") == 0)
+    {
+        return RunAssetPackerTool(__argc - 1, __argv + 1);
+    }
+
     D3D12HelloTexture sample(1280, 720, L"D3D12 Hello Texture");
     return Win32Application::Run(&sample, hInstance, nCmdShow);
 }
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+    const char* const CategoryNames[] =
+    {
+        "textures",
+        "buffers",
+        "upload",
+        "descriptors",
+        "cpu_staging",
+        "other",
+    };
+    static_assert(sizeof(CategoryNames) / sizeof(CategoryNames[0]) == static_cast<size_t>(MemoryCategory::Count), "A category has no name.");
+
+    const char* const SizeClassNames[MemorySizeClassCount] =
+    {
+        "<=256B", "<=4KB", "<=64KB", "<=1MB", "<=16MB", "<=256MB", ">256MB"
+    };
+
+    void UpdateMaximum(std::atomic<uint64_t>& maximum, uint64_t value)
+    {
+        uint64_t current = maximum.load(std::memory_order_relaxed);
+        while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+const char* GetMemoryCategoryName(MemoryCategory category)
+{
+    return category < MemoryCategory::Count ? CategoryNames[static_cast<size_t>(category)] : "unknown";
+}
+
+MemoryTracker::MemoryTracker() :
+    m_shards(new Shard[ShardCount])
+{
+    for (Counters& counters : m_counters)
+    {
+        counters.LiveBytes = 0;
+        counters.LiveCount = 0;
+        counters.PeakBytes = 0;
+        counters.AllocatedBytes = 0;
+        counters.AllocationCount = 0;
+        counters.FreeCount = 0;
+        for (std::atomic<uint64_t>& count : counters.LiveCountBySizeClass)
+        {
+            count = 0;
+        }
+    }
+}
+
+uint32_t MemoryTracker::GetSizeClass(uint64_t size)
+{
+    if (size <= 256)
+    {
+        return 0;
+    }
+    // Bits needed for size - 1, from 9 (up to 512) on: every 4 more bits is the next class.
+    uint32_t bits = 0;
+    for (uint64_t value = size - 1; value != 0; value >>= 1)
+    {
+        ++bits;
+    }
+    return std::min((bits - 9) / 4 + 1, MemorySizeClassCount - 1);
+}
+
+MemoryTracker::Shard& MemoryTracker::GetShard(const void* key) const
+{
+    // Allocations are at least 16 byte aligned, so the low bits carry nothing.
+    const uintptr_t address = reinterpret_cast<uintptr_t>(key);
+    return m_shards[((address >> 4) ^ (address >> 12)) % ShardCount];
+}
+
+void MemoryTracker::CountAllocation(uint64_t size, const MemoryTag& tag)
+{
+    Counters& counters = m_counters[static_cast<size_t>(tag.Category)];
+    const uint64_t live = counters.LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    UpdateMaximum(counters.PeakBytes, live);
+    counters.LiveCount.fetch_add(1, std::memory_order_relaxed);
+    counters.AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    counters.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    counters.LiveCountBySizeClass[GetSizeClass(size)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::CountFree(const Record& record)
+{
+    Counters& counters = m_counters[static_cast<size_t>(record.Tag.Category)];
+    counters.LiveBytes.fetch_sub(record.Size, std::memory_order_relaxed);
+    counters.LiveCount.fetch_sub(1, std::memory_order_relaxed);
+    counters.FreeCount.fetch_add(1, std::memory_order_relaxed);
+    counters.LiveCountBySizeClass[GetSizeClass(record.Size)].fetch_sub(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::Track(const void* key, uint64_t size, const MemoryTag& tag)
+{
+    if (tag.Category >= MemoryCategory::Count)
+    {
+        throw std::invalid_argument("Invalid memory category.");
+    }
+
+    Shard& shard = GetShard(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        auto inserted = shard.Records.emplace(key, Record{ size, tag });
+        if (!inserted.second)
+        {
+            CountFree(inserted.first->second);
+            inserted.first->second = Record{ size, tag };
+        }
+    }
+    CountAllocation(size, tag);
+}
+
+bool MemoryTracker::Untrack(const void* key)
+{
+    Shard& shard = GetShard(key);
+    Record record;
+    {
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        auto found = shard.Records.find(key);
+        if (found == shard.Records.end())
+        {
+            return false;
+        }
+        record = found->second;
+        shard.Records.erase(found);
+    }
+    CountFree(record);
+    return true;
+}
+
+MemoryCategoryStats MemoryTracker::GetStats(MemoryCategory category) const
+{
+    const Counters& counters = m_counters[static_cast<size_t>(category)];
+    MemoryCategoryStats stats;
+    stats.LiveBytes = counters.LiveBytes.load(std::memory_order_relaxed);
+    stats.LiveCount = counters.LiveCount.load(std::memory_order_relaxed);
+    stats.PeakBytes = counters.PeakBytes.load(std::memory_order_relaxed);
+    stats.AllocatedBytes = counters.AllocatedBytes.load(std::memory_order_relaxed);
+    stats.AllocationCount = counters.AllocationCount.load(std::memory_order_relaxed);
+    stats.FreeCount = counters.FreeCount.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < MemorySizeClassCount; ++i)
+    {
+        stats.LiveCountBySizeClass[i] = counters.LiveCountBySizeClass[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+uint64_t MemoryTracker::GetTotalLiveBytes() const
+{
+    uint64_t total = 0;
+    for (const Counters& counters : m_counters)
+    {
+        total += counters.LiveBytes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void MemoryTracker::ResetPeaks()
+{
+    for (Counters& counters : m_counters)
+    {
+        counters.PeakBytes.store(counters.LiveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+std::vector<MemoryTracker::LiveAllocation> MemoryTracker::GetLiveAllocations() const
+{
+    std::vector<LiveAllocation> allocations;
+    for (size_t i = 0; i < ShardCount; ++i)
+    {
+        Shard& shard = m_shards[i];
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        for (const auto& entry : shard.Records)
+        {
+            allocations.push_back(LiveAllocation{ entry.first, entry.second.Size, entry.second.Tag });
+        }
+    }
+
+    std::sort(allocations.begin(), allocations.end(), [](const LiveAllocation& a, const LiveAllocation& b)
+    {
+        if (a.Tag.Category != b.Tag.Category)
+        {
+            return a.Tag.Category < b.Tag.Category;
+        }
+        return a.Size > b.Size;
+    });
+    return allocations;
+}
+
+size_t MemoryTracker::WriteLeakReport(std::ostream& out) const
+{
+    out << "Memory by category (bytes)\n";
+    out << std::left << std::setw(13) << "category" << std::right
+        << std::setw(14) << "live" << std::setw(8) << "count" << std::setw(14) << "peak"
+        << std::setw(16) << "allocated" << std::setw(10) << "allocs" << std::setw(10) << "frees" << "  live by size class\n";
+
+    for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); ++i)
+    {
+        const MemoryCategoryStats stats = GetStats(static_cast<MemoryCategory>(i));
+        out << std::left << std::setw(13) << CategoryNames[i] << std::right
+            << std::setw(14) << stats.LiveBytes << std::setw(8) << stats.LiveCount << std::setw(14) << stats.PeakBytes
+            << std::setw(16) << stats.AllocatedBytes << std::setw(10) << stats.AllocationCount << std::setw(10) << stats.FreeCount << " ";
+        for (uint32_t sizeClass = 0; sizeClass < MemorySizeClassCount; ++sizeClass)
+        {
+            if (stats.LiveCountBySizeClass[sizeClass] != 0)
+            {
+                out << ' ' << SizeClassNames[sizeClass] << ':' << stats.LiveCountBySizeClass[sizeClass];
+            }
+        }
+        out << '\n';
+    }
+
+    size_t leaks = 0;
+    size_t persistent = 0;
+    for (const LiveAllocation& allocation : GetLiveAllocations())
+    {
+        if (allocation.Tag.Persistent)
+        {
+            ++persistent;
+            continue;
+        }
+        if (leaks == 0)
+        {
+            out << "Leaked allocations\n";
+        }
+        ++leaks;
+        out << "  " << GetMemoryCategoryName(allocation.Tag.Category) << ' ' << allocation.Size << " bytes "
+            << allocation.Tag.Name << " (" << allocation.Key << ")\n";
+    }
+
+    out << leaks << " leaked, " << persistent << " persistent allocations still live\n";
+    return leaks;
+}
+
+MemoryTracker& GetMemoryTracker()
+{
+    static MemoryTracker* tracker = new MemoryTracker();
+    return *tracker;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+// What an allocation is for. GPU memory (textures, buffers, upload heaps, descriptor heaps) and
+// CPU memory are tracked side by side.
+enum class MemoryCategory : uint8_t
+{
+    Textures,
+    Buffers,
+    Upload,
+    Descriptors,
+    CpuStaging,
+    Other,
+    Count
+};
+
+const char* GetMemoryCategoryName(MemoryCategory category);
+
+// How an allocation is reported. The name is not copied: pass a string literal.
+// Persistent allocations are expected to outlive the leak check (thread scratch arenas, buffers
+// owned by the swap chain) and are counted but not reported as leaks.
+struct MemoryTag
+{
+    MemoryTag(MemoryCategory category = MemoryCategory::Other, const char* name = "", bool persistent = false) :
+        Category(category), Name(name), Persistent(persistent) {}
+
+    MemoryCategory Category;
+    const char* Name;
+    bool Persistent;
+};
+
+// Sizes are grouped in classes growing by 16x from 256 bytes: <= 256 B, 4 KB, 64 KB, 1 MB, 16 MB,
+// 256 MB and larger.
+static const uint32_t MemorySizeClassCount = 7;
+
+struct MemoryCategoryStats
+{
+    uint64_t LiveBytes = 0;
+    uint64_t LiveCount = 0;
+    uint64_t PeakBytes = 0;             // Highest LiveBytes since the last ResetPeaks.
+    uint64_t AllocatedBytes = 0;        // Every byte ever tracked: the churn is its rate of change.
+    uint64_t AllocationCount = 0;
+    uint64_t FreeCount = 0;
+    uint64_t LiveCountBySizeClass[MemorySizeClassCount] = {};
+};
+
+// Accounts allocations by category: live, peak and allocated (churn) bytes, with a record of every
+// live allocation for the leak report. The allocation is identified by a key, normally its
+// address (a pointer to the memory, or to the API object owning it).
+// Thread-safe. Counting is a few relaxed atomics per call; the records are spread over shards with
+// a lock each, so threads tracking different allocations rarely contend.
+class MemoryTracker
+{
+public:
+    MemoryTracker();
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    // Tracking a key again replaces the earlier allocation, which is counted as freed.
+    void Track(const void* key, uint64_t size, const MemoryTag& tag);
+    // Returns false if the key is not tracked.
+    bool Untrack(const void* key);
+
+    MemoryCategoryStats GetStats(MemoryCategory category) const;
+    uint64_t GetTotalLiveBytes() const;
+    void ResetPeaks();
+
+    struct LiveAllocation
+    {
+        const void* Key;
+        uint64_t Size;
+        MemoryTag Tag;
+    };
+    // Sorted by category, then largest first.
+    std::vector<LiveAllocation> GetLiveAllocations() const;
+
+    // Writes the table of every category, then every live allocation that is not persistent.
+    // Call once everything should have been freed. Returns the number of leaks listed.
+    size_t WriteLeakReport(std::ostream& out) const;
+
+    static uint32_t GetSizeClass(uint64_t size);
+
+private:
+    struct Record
+    {
+        uint64_t Size;
+        MemoryTag Tag;
+    };
+
+    struct alignas(64) Shard
+    {
+        std::mutex Mutex;
+        std::unordered_map<const void*, Record> Records;
+    };
+
+    struct alignas(64) Counters
+    {
+        std::atomic<uint64_t> LiveBytes;
+        std::atomic<uint64_t> LiveCount;
+        std::atomic<uint64_t> PeakBytes;
+        std::atomic<uint64_t> AllocatedBytes;
+        std::atomic<uint64_t> AllocationCount;
+        std::atomic<uint64_t> FreeCount;
+        std::atomic<uint64_t> LiveCountBySizeClass[MemorySizeClassCount];
+    };
+
+    static const size_t ShardCount = 16;
+
+    Shard& GetShard(const void* key) const;
+    void CountAllocation(uint64_t size, const MemoryTag& tag);
+    void CountFree(const Record& record);
+
+    std::unique_ptr<Shard[]> m_shards;
+    Counters m_counters[static_cast<size_t>(MemoryCategory::Count)];
+};
+
+// The tracker the app and its allocators report to. It is never destroyed, so allocations freed
+// during static destruction can still be untracked.
+MemoryTracker& GetMemoryTracker();
+
+// Standard allocator that tracks every allocation under one tag, for containers whose memory
+// should show up in a category.
+template <typename T>
+class TrackedAllocator
+{
+public:
+    typedef T value_type;
+
+    explicit TrackedAllocator(const MemoryTag& tag) : m_tag(tag) {}
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U>& other) : m_tag(other.GetTag()) {}
+
+    T* allocate(size_t count)
+    {
+        T* pointer = static_cast<T*>(::operator new(count * sizeof(T)));
+        GetMemoryTracker().Track(pointer, count * sizeof(T), m_tag);
+        return pointer;
+    }
+
+    void deallocate(T* pointer, size_t /*count*/)
+    {
+        GetMemoryTracker().Untrack(pointer);
+        ::operator delete(pointer);
+    }
+
+    const MemoryTag& GetTag() const { return m_tag; }
+
+private:
+    MemoryTag m_tag;
+};
+
+template <typename T, typename U>
+bool operator==(const TrackedAllocator<T>&, const TrackedAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const TrackedAllocator<T>&, const TrackedAllocator<U>&) { return false; }
+
+template <typename T>
+using TrackedVector = std::vector<T, TrackedAllocator<T>>;
@@ -0,0 +1,913 @@
+#include "MeshImporter.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MESH_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MESH_NEON 1
+#endif
+
+namespace
+{
+    const uint32_t NoTexCoord = 0xffffffff;
+
+    // More significant digits can't change a float; the rest only scale the exponent.
+    const uint32_t MaxSignificantDigits = 19;
+
+    const uint32_t DigitPowers[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+    // Exact in float (5^10 < 2^24) and in double (5^22 < 2^53).
+    const float FloatPowers[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+    const double DoublePowers[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* const MalformedFace = "MeshImporter: malformed face.";
+    const char* const MalformedVertex = "MeshImporter: malformed vertex.";
+
+    // mask must not be 0.
+    inline uint32_t CountTrailingZeros(uint64_t mask)
+    {
+#if defined(_MSC_VER) && defined(_M_IX86)
+        unsigned long index;
+        if (_BitScanForward(&index, static_cast<unsigned long>(mask)))
+        {
+            return index;
+        }
+        _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+        return index + 32;
+#elif defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return index;
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+    }
+
+    inline bool IsDigit(char c)
+    {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    // Length of the run of decimal digits at text.
+    inline size_t CountDigits(const char* text, const char* end)
+    {
+        const char* p = text;
+#if MESH_SSE2
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i nine = _mm_set1_epi8(9);
+        while (end - p >= 16)
+        {
+            // Digits are the bytes 0 to 9 once '0' is subtracted, compared unsigned.
+            const __m128i values = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), zero);
+            const uint32_t digits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(values, nine), values)));
+            if (digits != 0xffff)
+            {
+                return (p - text) + CountTrailingZeros(~digits & 0xffff);
+            }
+            p += 16;
+        }
+#elif MESH_NEON
+        while (end - p >= 16)
+        {
+            const uint8x16_t values = vsubq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p)), vdupq_n_u8('0'));
+            const uint8x16_t others = vcgtq_u8(values, vdupq_n_u8(9));
+            // Narrowed to 4 bits per byte.
+            const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(others), 4)), 0);
+            if (mask != 0)
+            {
+                return (p - text) + CountTrailingZeros(mask) / 4;
+            }
+            p += 16;
+        }
+#endif
+        while (p < end && IsDigit(*p))
+        {
+            ++p;
+        }
+        return p - text;
+    }
+
+    // Value of the count (1 to 8) digits at text.
+    inline uint32_t ParseDigits(const char* text, size_t count, const char* end)
+    {
+        if (end - text >= 8)
+        {
+            // The first digit is the low byte. Shifting left drops what follows the digits and
+            // puts zeros in front; then pairs, quads and octets of digits are combined in place.
+            uint64_t digits;
+            memcpy(&digits, text, sizeof(digits));
+            digits = (digits << (8 * (8 - count))) & 0x0f0f0f0f0f0f0f0full;
+            digits = (digits * 10 + (digits >> 8)) & 0x00ff00ff00ff00ffull;
+            digits = (digits * 100 + (digits >> 16)) & 0x0000ffff0000ffffull;
+            return static_cast<uint32_t>(digits * 10000 + (digits >> 32));
+        }
+
+        uint32_t value = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            value = value * 10 + (text[i] - '0');
+        }
+        return value;
+    }
+
+    // Appends digits to mantissa, up to MaxSignificantDigits, and adjusts exponent: for the
+    // fraction, by the digits kept; for the integer part, by those dropped.
+    inline void AppendDigits(const char* digits, size_t length, bool fraction, const char* end, uint64_t& mantissa, uint32_t& significant, int& exponent)
+    {
+        size_t skipped = 0;
+        if (significant == 0)
+        {
+            while (skipped < length && digits[skipped] == '0')
+            {
+                ++skipped;
+            }
+        }
+
+        const size_t kept = std::min<size_t>(length - skipped, MaxSignificantDigits - significant);
+        for (size_t i = skipped; i < skipped + kept;)
+        {
+            const size_t count = std::min<size_t>(skipped + kept - i, 8);
+            mantissa = mantissa * DigitPowers[count] + ParseDigits(digits + i, count, end);
+            i += count;
+        }
+        significant += static_cast<uint32_t>(kept);
+        if (fraction)
+        {
+            exponent -= static_cast<int>(skipped + kept);
+        }
+        else
+        {
+            exponent += static_cast<int>(length - skipped - kept);
+        }
+    }
+
+    inline bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline const char* SkipSpaces(const char* p, const char* lineEnd)
+    {
+        while (p < lineEnd && IsSpace(*p))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    inline const char* FindLineEnd(const char* p, const char* end)
+    {
+        const void* newline = memchr(p, '\n', end - p);
+        return newline ? static_cast<const char*>(newline) : end;
+    }
+
+    enum class LineType
+    {
+        Other,
+        Position,
+        TexCoord,
+        Face,
+    };
+
+    // The kind of the line at p; p is moved past its keyword.
+    inline LineType ClassifyLine(const char*& p, const char* lineEnd)
+    {
+        p = SkipSpaces(p, lineEnd);
+        if (lineEnd - p >= 2)
+        {
+            if (p[0] == 'v' && IsSpace(p[1]))
+            {
+                p += 2;
+                return LineType::Position;
+            }
+            if (p[0] == 'f' && IsSpace(p[1]))
+            {
+                p += 2;
+                return LineType::Face;
+            }
+            if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && IsSpace(p[2]))
+            {
+                p += 3;
+                return LineType::TexCoord;
+            }
+        }
+        return LineType::Other;
+    }
+
+    // The corners of a face: its tokens up to a comment.
+    inline uint32_t CountCorners(const char* p, const char* lineEnd)
+    {
+        uint32_t corners = 0;
+        bool inToken = false;
+        for (; p < lineEnd && *p != '#'; ++p)
+        {
+            const bool space = IsSpace(*p);
+            corners += !space && !inToken;
+            inToken = !space;
+        }
+        return corners;
+    }
+
+    // An index ("12", "-3") at text: returns the character after it, or null if there is none.
+    inline const char* ParseIndex(const char* text, const char* end, int64_t& value)
+    {
+        const char* p = text;
+        const bool negative = p < end && *p == '-';
+        p += negative;
+        const size_t digits = CountDigits(p, end);
+        if (digits == 0 || digits > 10)
+        {
+            return nullptr;
+        }
+        const uint64_t number = digits > 8
+            ? static_cast<uint64_t>(ParseDigits(p, digits - 8, end)) * DigitPowers[8] + ParseDigits(p + digits - 8, 8, end)
+            : ParseDigits(p, digits, end);
+        value = negative ? -static_cast<int64_t>(number) : static_cast<int64_t>(number);
+        return p + digits;
+    }
+
+    // OBJ indices count from 1, or back from the last element defined so far when negative.
+    inline uint32_t ResolveIndex(int64_t index, uint32_t defined, uint32_t total)
+    {
+        const int64_t resolved = index > 0 ? index - 1 : static_cast<int64_t>(defined) + index;
+        if (index == 0 || resolved < 0 || resolved >= static_cast<int64_t>(total))
+        {
+            throw std::runtime_error("MeshImporter: a face refers to a missing vertex.");
+        }
+        return static_cast<uint32_t>(resolved);
+    }
+
+    // Elements defined before a line, for relative indices, and in the whole file.
+    struct IndexBase
+    {
+        uint32_t Positions;
+        uint32_t PositionCount;
+        uint32_t TexCoords;
+        uint32_t TexCoordCount;
+    };
+
+    // Parses the corners of the face at p: a position each, and a texture coordinate or
+    // NoTexCoord. Normals are skipped.
+    void ParseFace(const char* p, const char* lineEnd, const char* end, const IndexBase& base, std::vector<uint32_t>& positions, std::vector<uint32_t>& texCoords)
+    {
+        positions.clear();
+        texCoords.clear();
+        for (p = SkipSpaces(p, lineEnd); p < lineEnd && *p != '#'; p = SkipSpaces(p, lineEnd))
+        {
+            int64_t index;
+            p = ParseIndex(p, end, index);
+            if (!p)
+            {
+                throw std::runtime_error(MalformedFace);
+            }
+            positions.push_back(ResolveIndex(index, base.Positions, base.PositionCount));
+
+            uint32_t texCoord = NoTexCoord;
+            if (p < lineEnd && *p == '/')
+            {
+                ++p;
+                if (p < lineEnd && *p != '/')
+                {
+                    p = ParseIndex(p, end, index);
+                    if (!p)
+                    {
+                        throw std::runtime_error(MalformedFace);
+                    }
+                    texCoord = ResolveIndex(index, base.TexCoords, base.TexCoordCount);
+                }
+                if (p < lineEnd && *p == '/')
+                {
+                    p = ParseIndex(p + 1, end, index);
+                    if (!p)
+                    {
+                        throw std::runtime_error(MalformedFace);
+                    }
+                }
+            }
+            texCoords.push_back(texCoord);
+
+            if (p < lineEnd && !IsSpace(*p) && *p != '#')
+            {
+                throw std::runtime_error(MalformedFace);
+            }
+        }
+        if (positions.size() < 3)
+        {
+            throw std::runtime_error(MalformedFace);
+        }
+    }
+
+    // Parses count numbers of a "v" or "vt" line; more are ignored.
+    inline void ParseNumbers(const char* p, const char* lineEnd, const char* end, float* values, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            p = SkipSpaces(p, lineEnd);
+            p = p < lineEnd ? ParseMeshFloat(p, end, values[i]) : nullptr;
+            if (!p)
+            {
+                throw std::runtime_error(MalformedVertex);
+            }
+        }
+    }
+}
+
+const char* ParseMeshFloat(const char* text, const char* end, float& value)
+{
+    const char* p = text;
+    const bool negative = p < end && *p == '-';
+    p += p < end && (*p == '-' || *p == '+');
+
+    uint64_t mantissa = 0;
+    uint32_t significant = 0;
+    int exponent = 0;
+    const size_t integerDigits = CountDigits(p, end);
+    AppendDigits(p, integerDigits, false, end, mantissa, significant, exponent);
+    p += integerDigits;
+    size_t fractionDigits = 0;
+    if (p < end && *p == '.')
+    {
+        fractionDigits = CountDigits(p + 1, end);
+        AppendDigits(p + 1, fractionDigits, true, end, mantissa, significant, exponent);
+        p += 1 + fractionDigits;
+    }
+    if (integerDigits + fractionDigits == 0)
+    {
+        return nullptr;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char* digits = p + 1;
+        const bool negativeExponent = digits < end && *digits == '-';
+        digits += digits < end && (*digits == '-' || *digits == '+');
+        const size_t exponentDigits = CountDigits(digits, end);
+        if (exponentDigits > 0)
+        {
+            int written = 0;
+            for (size_t i = 0; i < exponentDigits && written < 100000; ++i)
+            {
+                written = written * 10 + (digits[i] - '0');
+            }
+            exponent += negativeExponent ? -written : written;
+            p = digits + exponentDigits;
+        }
+    }
+
+    // One correctly rounded operation when the mantissa and the power of ten are exact: in float
+    // it gives strtof's result, in double it may round a second time. Anything else is rare
+    // enough for strtof itself.
+    float result;
+    if (mantissa == 0)
+    {
+        result = 0.0f;
+    }
+    else if (mantissa <= (1u << 24) && exponent >= -10 && exponent <= 10)
+    {
+        const float scaled = static_cast<float>(mantissa);
+        result = exponent < 0 ? scaled / FloatPowers[-exponent] : scaled * FloatPowers[exponent];
+    }
+    else if (mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+        const double scaled = static_cast<double>(mantissa);
+        result = static_cast<float>(exponent < 0 ? scaled / DoublePowers[-exponent] : scaled * DoublePowers[exponent]);
+    }
+    else
+    {
+        char copy[64];
+        const size_t length = p - text;
+        if (length < sizeof(copy))
+        {
+            memcpy(copy, text, length);
+            copy[length] = '\0';
+            value = strtof(copy, nullptr);
+            return p;
+        }
+        result = static_cast<float>(static_cast<double>(mantissa) * std::pow(10.0, exponent));
+    }
+    value = negative ? -result : result;
+    return p;
+}
+
+const char* GetMeshImporterIsa()
+{
+#if MESH_SSE2
+    return "sse2";
+#elif MESH_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+MeshImporter::MeshImporter(ThreadPool* pool) :
+    m_pool(pool),
+    m_data(nullptr),
+    m_size(0),
+#if defined(_WIN32)
+    m_file(INVALID_HANDLE_VALUE),
+    m_mapping(nullptr),
+#endif
+    m_mapped(false),
+    m_indexCount(0),
+    m_bounds()
+{
+}
+
+MeshImporter::~MeshImporter()
+{
+    Close();
+}
+
+#if defined(_WIN32)
+
+void MeshImporter::Open(const char* path)
+{
+    std::wstring widePath(MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, &widePath[0], static_cast<int>(widePath.size()));
+    Open(widePath.c_str());
+}
+
+void MeshImporter::Open(const wchar_t* path)
+{
+    Close();
+
+    m_file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("MeshImporter: can't open file");
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+    {
+        Close();
+        throw std::runtime_error("MeshImporter: can't read file size");
+    }
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_data = m_mapping ? static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!m_data)
+    {
+        Close();
+        throw std::runtime_error("MeshImporter: can't map file");
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_mapped = true;
+
+    Scan();
+}
+
+#else
+
+void MeshImporter::Open(const char* path)
+{
+    Close();
+
+    const int file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        throw std::runtime_error("MeshImporter: can't open file");
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        throw std::runtime_error("MeshImporter: can't read file size");
+    }
+
+    // The mapping keeps its own reference to the file.
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        throw std::runtime_error("MeshImporter: can't map file");
+    }
+    // Read front to back, by every chunk at once.
+    madvise(data, static_cast<size_t>(info.st_size), MADV_WILLNEED);
+
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+    m_mapped = true;
+
+    Scan();
+}
+
+#endif
+
+void MeshImporter::OpenMemory(const char* text, size_t size)
+{
+    Close();
+
+    m_data = text;
+    m_size = size;
+    Scan();
+}
+
+void MeshImporter::Close()
+{
+#if defined(_WIN32)
+    if (m_mapped)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+    }
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+#else
+    if (m_mapped)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_chunks.clear();
+    m_texCoords.clear();
+    m_positionTexCoord.reset();
+    m_seams.clear();
+    m_indexCount = 0;
+    m_bounds = MeshBounds();
+    m_stats = MeshImportStats();
+}
+
+void MeshImporter::ParallelFor(size_t count, const std::function<void(size_t, size_t)>& fn) const
+{
+    if (m_pool)
+    {
+        m_pool->ParallelFor(count, 1, fn);
+    }
+    else if (count > 0)
+    {
+        fn(0, count);
+    }
+}
+
+void MeshImporter::Scan()
+{
+    const char* const dataEnd = m_data + m_size;
+    for (const char* begin = m_data; begin < dataEnd;)
+    {
+        const size_t remaining = dataEnd - begin;
+        const char* end = begin + (remaining < ChunkSize ? remaining : ChunkSize);
+        if (end < dataEnd)
+        {
+            end = std::min(FindLineEnd(end, dataEnd) + 1, dataEnd);
+        }
+        Chunk chunk = {};
+        chunk.Begin = begin;
+        chunk.End = end;
+        m_chunks.push_back(chunk);
+        begin = end;
+    }
+
+    // Count the vertex lines of every chunk, so relative indices can be resolved.
+    ParallelFor(m_chunks.size(), [this](size_t first, size_t last)
+    {
+        for (size_t c = first; c < last; ++c)
+        {
+            Chunk& chunk = m_chunks[c];
+            for (const char* line = chunk.Begin; line < chunk.End;)
+            {
+                const char* lineEnd = FindLineEnd(line, chunk.End);
+                const char* p = line;
+                const LineType type = ClassifyLine(p, lineEnd);
+                chunk.Positions += type == LineType::Position;
+                chunk.TexCoords += type == LineType::TexCoord;
+                line = lineEnd + 1;
+            }
+            ReleaseText(chunk);
+        }
+    });
+
+    uint64_t positions = 0;
+    uint64_t texCoords = 0;
+    for (Chunk& chunk : m_chunks)
+    {
+        chunk.FirstPosition = static_cast<uint32_t>(positions);
+        chunk.FirstTexCoord = static_cast<uint32_t>(texCoords);
+        positions += chunk.Positions;
+        texCoords += chunk.TexCoords;
+    }
+    if (positions >= NoTexCoord || texCoords >= NoTexCoord)
+    {
+        throw std::runtime_error("MeshImporter: too many vertices for 32-bit indices.");
+    }
+    m_stats.Bytes = m_size;
+    m_stats.Chunks = static_cast<uint32_t>(m_chunks.size());
+    m_stats.Positions = static_cast<uint32_t>(positions);
+    m_stats.TexCoords = static_cast<uint32_t>(texCoords);
+
+    // Read the texture coordinates, give each position the lowest one its corners use (the same
+    // whatever the order the chunks run in) and count the indices.
+    m_texCoords.resize(2 * static_cast<size_t>(m_stats.TexCoords));
+    m_positionTexCoord.reset(new std::atomic<uint32_t>[m_stats.Positions]);
+    for (uint32_t i = 0; i < m_stats.Positions; ++i)
+    {
+        m_positionTexCoord[i].store(NoTexCoord, std::memory_order_relaxed);
+    }
+    ParallelFor(m_chunks.size(), [this, dataEnd](size_t first, size_t last)
+    {
+        std::vector<uint32_t> positions;
+        std::vector<uint32_t> texCoords;
+        for (size_t c = first; c < last; ++c)
+        {
+            Chunk& chunk = m_chunks[c];
+            IndexBase base = { chunk.FirstPosition, m_stats.Positions, chunk.FirstTexCoord, m_stats.TexCoords };
+            for (const char* line = chunk.Begin; line < chunk.End;)
+            {
+                const char* lineEnd = FindLineEnd(line, chunk.End);
+                const char* p = line;
+                switch (ClassifyLine(p, lineEnd))
+                {
+                case LineType::Position:
+                    ++base.Positions;
+                    break;
+                case LineType::TexCoord:
+                {
+                    float* uv = &m_texCoords[2 * static_cast<size_t>(base.TexCoords)];
+                    ParseNumbers(p, lineEnd, dataEnd, uv, 2);
+                    uv[1] = 1.0f - uv[1];
+                    ++base.TexCoords;
+                    break;
+                }
+                case LineType::Face:
+                {
+                    // Without texture coordinates there is nothing to choose: the corners are
+                    // only counted, and checked by ReadIndices.
+                    size_t corners;
+                    if (m_stats.TexCoords == 0)
+                    {
+                        corners = CountCorners(p, lineEnd);
+                        if (corners < 3)
+                        {
+                            throw std::runtime_error(MalformedFace);
+                        }
+                    }
+                    else
+                    {
+                        ParseFace(p, lineEnd, dataEnd, base, positions, texCoords);
+                        for (size_t i = 0; i < positions.size(); ++i)
+                        {
+                            std::atomic<uint32_t>& lowest = m_positionTexCoord[positions[i]];
+                            uint32_t current = lowest.load(std::memory_order_relaxed);
+                            while (texCoords[i] < current && !lowest.compare_exchange_weak(current, texCoords[i], std::memory_order_relaxed))
+                            {
+                            }
+                        }
+                        corners = positions.size();
+                    }
+                    chunk.Indices += 3 * (corners - 2);
+                    break;
+                }
+                default:
+                    break;
+                }
+                line = lineEnd + 1;
+            }
+            ReleaseText(chunk);
+        }
+    });
+
+    uint64_t indices = 0;
+    for (Chunk& chunk : m_chunks)
+    {
+        chunk.FirstIndex = indices;
+        indices += chunk.Indices;
+    }
+    m_stats.Triangles = indices / 3;
+    m_indexCount = static_cast<size_t>(indices);
+}
+
+// The next pass reads the chunk again, from the file cache: dropping its pages keeps the
+// resident size at the chunks being parsed instead of the whole file. Windows trims the pages
+// of mapped files from the working set by itself when memory runs short.
+void MeshImporter::ReleaseText(const Chunk& chunk) const
+{
+#if !defined(_WIN32)
+    if (m_mapped)
+    {
+        const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const uintptr_t begin = (reinterpret_cast<uintptr_t>(chunk.Begin) + pageSize - 1) & ~(pageSize - 1);
+        const uintptr_t end = reinterpret_cast<uintptr_t>(chunk.End) & ~(pageSize - 1);
+        if (begin < end)
+        {
+            madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+        }
+    }
+#else
+    (void)chunk;
+#endif
+}
+
+void MeshImporter::ReadIndices(uint32_t* indices)
+{
+    const char* const dataEnd = m_data + m_size;
+    ParallelFor(m_chunks.size(), [this, indices, dataEnd](size_t first, size_t last)
+    {
+        std::vector<uint32_t> positions;
+        std::vector<uint32_t> texCoords;
+        std::vector<bool> seams;
+        for (size_t c = first; c < last; ++c)
+        {
+            Chunk& chunk = m_chunks[c];
+            chunk.Seams.clear();
+            IndexBase base = { chunk.FirstPosition, m_stats.Positions, chunk.FirstTexCoord, m_stats.TexCoords };
+            uint64_t slot = chunk.FirstIndex;
+            for (const char* line = chunk.Begin; line < chunk.End;)
+            {
+                const char* lineEnd = FindLineEnd(line, chunk.End);
+                const char* p = line;
+                switch (ClassifyLine(p, lineEnd))
+                {
+                case LineType::Position:
+                    ++base.Positions;
+                    break;
+                case LineType::TexCoord:
+                    ++base.TexCoords;
+                    break;
+                case LineType::Face:
+                {
+                    ParseFace(p, lineEnd, dataEnd, base, positions, texCoords);
+                    seams.resize(positions.size());
+                    for (size_t i = 0; i < positions.size(); ++i)
+                    {
+                        seams[i] = texCoords[i] != m_positionTexCoord[positions[i]].load(std::memory_order_relaxed);
+                    }
+
+                    // Fans, wound the other way round. Seam corners are written once the seam
+                    // vertices are numbered.
+                    for (size_t i = 1; i + 1 < positions.size(); ++i)
+                    {
+                        const size_t triangle[3] = { 0, i + 1, i };
+                        for (size_t corner : triangle)
+                        {
+                            if (seams[corner])
+                            {
+                                chunk.Seams.push_back(SeamCorner{ slot, Seam{ positions[corner], texCoords[corner] } });
+                            }
+                            else
+                            {
+                                indices[slot] = positions[corner];
+                            }
+                            ++slot;
+                        }
+                    }
+                    break;
+                }
+                default:
+                    break;
+                }
+                line = lineEnd + 1;
+            }
+            ReleaseText(chunk);
+        }
+    });
+
+    // Number the seam vertices after the positions, sorted by position so ReadVertices writes
+    // them along with it.
+    const auto seamOrder = [](const Seam& a, const Seam& b)
+    {
+        return a.Position != b.Position ? a.Position < b.Position : a.TexCoord < b.TexCoord;
+    };
+    m_seams.clear();
+    for (const Chunk& chunk : m_chunks)
+    {
+        for (const SeamCorner& corner : chunk.Seams)
+        {
+            m_seams.push_back(corner.Vertex);
+        }
+    }
+    std::sort(m_seams.begin(), m_seams.end(), seamOrder);
+    m_seams.erase(std::unique(m_seams.begin(), m_seams.end(), [](const Seam& a, const Seam& b)
+    {
+        return a.Position == b.Position && a.TexCoord == b.TexCoord;
+    }), m_seams.end());
+    if (static_cast<uint64_t>(m_stats.Positions) + m_seams.size() > NoTexCoord)
+    {
+        throw std::runtime_error("MeshImporter: too many vertices for 32-bit indices.");
+    }
+    m_stats.SeamVertices = static_cast<uint32_t>(m_seams.size());
+
+    ParallelFor(m_chunks.size(), [this, indices, seamOrder](size_t first, size_t last)
+    {
+        for (size_t c = first; c < last; ++c)
+        {
+            Chunk& chunk = m_chunks[c];
+            for (const SeamCorner& corner : chunk.Seams)
+            {
+                const size_t seam = std::lower_bound(m_seams.begin(), m_seams.end(), corner.Vertex, seamOrder) - m_seams.begin();
+                indices[corner.Slot] = m_stats.Positions + static_cast<uint32_t>(seam);
+            }
+            std::vector<SeamCorner>().swap(chunk.Seams);
+        }
+    });
+}
+
+void MeshImporter::ReadVertices(MeshVertex* vertices)
+{
+    const char* const dataEnd = m_data + m_size;
+    ParallelFor(m_chunks.size(), [this, vertices, dataEnd](size_t first, size_t last)
+    {
+        for (size_t c = first; c < last; ++c)
+        {
+            Chunk& chunk = m_chunks[c];
+            MeshBounds& bounds = chunk.Bounds;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                bounds.Min[axis] = std::numeric_limits<float>::max();
+                bounds.Max[axis] = -std::numeric_limits<float>::max();
+            }
+
+            uint32_t position = chunk.FirstPosition;
+            size_t seam = std::lower_bound(m_seams.begin(), m_seams.end(), chunk.FirstPosition, [](const Seam& a, uint32_t b) { return a.Position < b; }) - m_seams.begin();
+            for (const char* line = chunk.Begin; line < chunk.End;)
+            {
+                const char* lineEnd = FindLineEnd(line, chunk.End);
+                const char* p = line;
+                if (ClassifyLine(p, lineEnd) == LineType::Position)
+                {
+                    MeshVertex vertex;
+                    ParseNumbers(p, lineEnd, dataEnd, vertex.Position, 3);
+                    vertex.Position[2] = -vertex.Position[2];
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        bounds.Min[axis] = std::min(bounds.Min[axis], vertex.Position[axis]);
+                        bounds.Max[axis] = std::max(bounds.Max[axis], vertex.Position[axis]);
+                    }
+
+                    const uint32_t texCoord = m_positionTexCoord[position].load(std::memory_order_relaxed);
+                    vertex.Uv[0] = texCoord != NoTexCoord ? m_texCoords[2 * static_cast<size_t>(texCoord)] : 0.0f;
+                    vertex.Uv[1] = texCoord != NoTexCoord ? m_texCoords[2 * static_cast<size_t>(texCoord) + 1] : 0.0f;
+                    vertices[position] = vertex;
+
+                    for (; seam < m_seams.size() && m_seams[seam].Position == position; ++seam)
+                    {
+                        const uint32_t seamTexCoord = m_seams[seam].TexCoord;
+                        vertex.Uv[0] = seamTexCoord != NoTexCoord ? m_texCoords[2 * static_cast<size_t>(seamTexCoord)] : 0.0f;
+                        vertex.Uv[1] = seamTexCoord != NoTexCoord ? m_texCoords[2 * static_cast<size_t>(seamTexCoord) + 1] : 0.0f;
+                        vertices[m_stats.Positions + seam] = vertex;
+                    }
+                    ++position;
+                }
+                line = lineEnd + 1;
+            }
+            ReleaseText(chunk);
+        }
+    });
+
+    m_bounds = MeshBounds();
+    bool first = true;
+    for (const Chunk& chunk : m_chunks)
+    {
+        if (chunk.Positions == 0)
+        {
+            continue;
+        }
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            m_bounds.Min[axis] = first ? chunk.Bounds.Min[axis] : std::min(m_bounds.Min[axis], chunk.Bounds.Min[axis]);
+            m_bounds.Max[axis] = first ? chunk.Bounds.Max[axis] : std::max(m_bounds.Max[axis], chunk.Bounds.Max[axis]);
+        }
+        first = false;
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+// The sample's Vertex: position, then texture coordinates. 20 bytes.
+struct MeshVertex
+{
+    float Position[3];
+    float Uv[2];
+};
+static_assert(sizeof(MeshVertex) == 20, "MeshVertex has the layout of the sample's Vertex.");
+
+struct MeshBounds
+{
+    float Min[3];
+    float Max[3];
+};
+
+struct MeshImportStats
+{
+    uint64_t Bytes = 0;
+    uint32_t Chunks = 0;
+    uint32_t Positions = 0;         // "v" lines.
+    uint32_t TexCoords = 0;         // "vt" lines.
+    uint64_t Triangles = 0;         // After splitting polygons into fans.
+    uint32_t SeamVertices = 0;      // Vertices added for positions used with more than one "vt".
+};
+
+// Imports the triangles of a Wavefront OBJ file straight into a vertex and an index buffer,
+// without an intermediate copy of the mesh.
+//
+// The file is memory mapped and cut at line ends into chunks that are parsed in parallel on the
+// pool: Open counts the lines of each chunk, so that every chunk knows where its vertices and
+// indices go, and picks a texture coordinate for each position; ReadIndices and ReadVertices then
+// parse the chunks again, writing each index and vertex to its final place. Numbers are parsed
+// without strtof: SSE2 or NEON (chosen at compile time) find the digits 16 bytes at a time, and
+// they are converted 8 at a time in a 64-bit register.
+//
+// Each position is one vertex, with the lowest-numbered texture coordinate any face uses it with;
+// the other pairs of a position and a texture coordinate (texture seams) are vertices of their
+// own, after the positions. Normals, materials, groups, lines and points are ignored. Faces are
+// split into fans. The coordinates are converted to the sample's left-handed, top-down
+// convention: Z and V are flipped, and so is the winding of every triangle.
+//
+// Usage: Open, then ReadIndices into GetIndexCount() indices, then ReadVertices into
+// GetVertexCount() vertices. Both buffers are written, never read, so they can be mapped upload
+// memory. Errors throw std::runtime_error. Not thread-safe.
+class MeshImporter
+{
+public:
+    // Bytes of text per parallel job.
+    static const size_t ChunkSize = 1 << 20;
+
+    // pool may be null, in which case everything runs on the calling thread.
+    explicit MeshImporter(ThreadPool* pool = nullptr);
+    ~MeshImporter();
+
+    MeshImporter(const MeshImporter&) = delete;
+    MeshImporter& operator=(const MeshImporter&) = delete;
+
+    // Maps the file and scans it. Throws std::runtime_error if it can't be mapped or a face is
+    // malformed or refers to a missing vertex.
+    void Open(const char* path);
+#if defined(_WIN32)
+    void Open(const wchar_t* path);
+#endif
+    // The same on OBJ text in memory, which must stay valid until Close.
+    void OpenMemory(const char* text, size_t size);
+    void Close();
+
+    size_t GetIndexCount() const { return m_indexCount; }
+    // Known once ReadIndices has run.
+    size_t GetVertexCount() const { return m_stats.Positions + m_seams.size(); }
+    // Bounds of every position; valid once ReadVertices has run.
+    const MeshBounds& GetBounds() const { return m_bounds; }
+    const MeshImportStats& GetStats() const { return m_stats; }
+
+    void ReadIndices(uint32_t* indices);
+    void ReadVertices(MeshVertex* vertices);
+
+private:
+    // A vertex after the positions: the position with another texture coordinate.
+    struct Seam
+    {
+        uint32_t Position;
+        uint32_t TexCoord;
+    };
+
+    // An index written once the seam vertices are numbered.
+    struct SeamCorner
+    {
+        uint64_t Slot;
+        Seam Vertex;
+    };
+
+    struct Chunk
+    {
+        const char* Begin;
+        const char* End;
+        uint32_t FirstPosition;
+        uint32_t FirstTexCoord;
+        uint64_t FirstIndex;
+        uint32_t Positions;
+        uint32_t TexCoords;
+        uint64_t Indices;
+        MeshBounds Bounds;
+        std::vector<SeamCorner> Seams;
+    };
+
+    void Scan();
+    void ReleaseText(const Chunk& chunk) const;
+    void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& fn) const;
+
+    ThreadPool* m_pool;
+    const char* m_data;
+    size_t m_size;
+#if defined(_WIN32)
+    void* m_file;
+    void* m_mapping;
+#endif
+    bool m_mapped;
+
+    std::vector<Chunk> m_chunks;
+    std::vector<float> m_texCoords;                         // U, V (flipped) of each "vt".
+    std::unique_ptr<std::atomic<uint32_t>[]> m_positionTexCoord;  // Per position: lowest "vt" used, or none.
+    std::vector<Seam> m_seams;                              // Sorted.
+    size_t m_indexCount;
+    MeshBounds m_bounds;
+    MeshImportStats m_stats;
+};
+
+// Parses a decimal floating-point number ("-1.5", "2e-3") at text, reading no further than end.
+// Returns the character after it, or null if there is none. The result is strtof's, or when
+// the number has more than 7 significant digits, within one unit in the last place of it.
+const char* ParseMeshFloat(const char* text, const char* end, float& value);
+
+// The instruction set the number parser was compiled for: "sse2", "neon" or "scalar".
+const char* GetMeshImporterIsa();
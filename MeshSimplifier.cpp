@@ -0,0 +1,508 @@
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+    struct Float3
+    {
+        float x, y, z;
+    };
+
+    inline Float3 Sub(const Float3& a, const Float3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    inline float Dot(const Float3& a, const Float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    inline Float3 Cross(const Float3& a, const Float3& b)
+    {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    // Symmetric 4x4 matrix accumulating squared distances to a set of planes.
+    struct Quadric
+    {
+        double a00, a01, a02, a03;
+        double a11, a12, a13;
+        double a22, a23;
+        double a33;
+
+        void AddPlane(double a, double b, double c, double d, double weight)
+        {
+            a00 += weight * a * a; a01 += weight * a * b; a02 += weight * a * c; a03 += weight * a * d;
+            a11 += weight * b * b; a12 += weight * b * c; a13 += weight * b * d;
+            a22 += weight * c * c; a23 += weight * c * d;
+            a33 += weight * d * d;
+        }
+
+        void Add(const Quadric& q)
+        {
+            a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+            a11 += q.a11; a12 += q.a12; a13 += q.a13;
+            a22 += q.a22; a23 += q.a23;
+            a33 += q.a33;
+        }
+
+        double Evaluate(const Float3& p) const
+        {
+            const double x = p.x, y = p.y, z = p.z;
+            const double r = a00 * x * x + a11 * y * y + a22 * z * z +
+                2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                2.0 * (a03 * x + a13 * y + a23 * z) + a33;
+            return std::max(r, 0.0);
+        }
+    };
+
+    enum VertexKind : uint8_t
+    {
+        VertexKind_Manifold,    // Free to collapse onto any neighbour.
+        VertexKind_Border,      // May only collapse along a border edge.
+        VertexKind_Locked,      // Attribute seam or non-manifold; never moves.
+    };
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        float cost;
+    };
+
+    struct Plane
+    {
+        float a, b, c, d;
+        float area;
+    };
+
+    // Border edges are weighted heavily so they only collapse when the outline really is straight.
+    const double BorderWeight = 10.0;
+
+    inline uint64_t EdgeKey(uint32_t a, uint32_t b)
+    {
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    struct PositionHash
+    {
+        size_t operator()(const Float3& p) const
+        {
+            uint32_t bits[3];
+            memcpy(bits, &p, sizeof(bits));
+            return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+        }
+    };
+
+    struct PositionEqual
+    {
+        bool operator()(const Float3& a, const Float3& b) const
+        {
+            return a.x == b.x && a.y == b.y && a.z == b.z;
+        }
+    };
+}
+
+MeshSimplifier::MeshSimplifier(ThreadPool* pool) :
+    m_pool(pool)
+{
+}
+
+void MeshSimplifier::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fn) const
+{
+    if (m_pool)
+    {
+        m_pool->ParallelFor(count, grainSize, fn);
+    }
+    else if (count > 0)
+    {
+        fn(0, count);
+    }
+}
+
+float MeshSimplifier::Simplify(
+    const SimplifierMesh& mesh,
+    const uint32_t* indices,
+    size_t indexCount,
+    size_t targetIndexCount,
+    float maxError,
+    std::vector<uint32_t>& out) const
+{
+    if (indexCount % 3 != 0)
+    {
+        throw std::invalid_argument("MeshSimplifier: index count is not a multiple of 3");
+    }
+
+    const size_t vertexCount = mesh.VertexCount;
+    const uint8_t* positionBytes = static_cast<const uint8_t*>(mesh.Positions);
+
+    std::vector<Float3> positions(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        memcpy(&positions[v], positionBytes + v * mesh.PositionStride, sizeof(Float3));
+    }
+
+    out.assign(indices, indices + indexCount);
+    for (uint32_t index : out)
+    {
+        if (index >= vertexCount)
+        {
+            throw std::out_of_range("MeshSimplifier: index out of range");
+        }
+    }
+
+    // Weld vertices by position. A position shared by several vertices marks an attribute seam.
+    std::vector<uint32_t> welded(vertexCount);
+    std::vector<uint8_t> kind(vertexCount, VertexKind_Manifold);
+    {
+        std::unordered_map<Float3, uint32_t, PositionHash, PositionEqual> firstVertex;
+        firstVertex.reserve(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            auto result = firstVertex.emplace(positions[v], v);
+            welded[v] = result.first->second;
+            if (!result.second)
+            {
+                kind[v] = VertexKind_Locked;
+                kind[result.first->second] = VertexKind_Locked;
+            }
+        }
+    }
+
+    // Directed edge counts on the welded topology. An edge without its opposite is a border;
+    // an edge seen twice in the same direction is non-manifold.
+    // Collapses create new edges, so this is rebuilt after every pass.
+    std::unordered_map<uint64_t, uint32_t> edgeCounts;
+    auto buildEdges = [&]()
+    {
+        edgeCounts.clear();
+        edgeCounts.reserve(out.size());
+        for (size_t i = 0; i < out.size(); i += 3)
+        {
+            for (int e = 0; e < 3; ++e)
+            {
+                edgeCounts[EdgeKey(welded[out[i + e]], welded[out[i + (e + 1) % 3]])]++;
+            }
+        }
+    };
+
+    buildEdges();
+
+    auto isBorderEdge = [&](uint32_t a, uint32_t b)
+    {
+        return edgeCounts.find(EdgeKey(welded[b], welded[a])) == edgeCounts.end();
+    };
+
+    for (size_t i = 0; i < indexCount; i += 3)
+    {
+        for (int e = 0; e < 3; ++e)
+        {
+            const uint32_t a = out[i + e];
+            const uint32_t b = out[i + (e + 1) % 3];
+            if (edgeCounts[EdgeKey(welded[a], welded[b])] > 1)
+            {
+                kind[a] = VertexKind_Locked;
+                kind[b] = VertexKind_Locked;
+            }
+            else if (isBorderEdge(a, b))
+            {
+                if (kind[a] == VertexKind_Manifold) kind[a] = VertexKind_Border;
+                if (kind[b] == VertexKind_Manifold) kind[b] = VertexKind_Border;
+            }
+        }
+    }
+
+    // Triangle planes (parallel over triangles).
+    const size_t triCount = indexCount / 3;
+    std::vector<Plane> planes(triCount);
+    ParallelFor(triCount, 4096, [&](size_t begin, size_t end)
+    {
+        for (size_t t = begin; t < end; ++t)
+        {
+            const Float3& p0 = positions[out[t * 3 + 0]];
+            const Float3 n = Cross(Sub(positions[out[t * 3 + 1]], p0), Sub(positions[out[t * 3 + 2]], p0));
+            const float length = std::sqrt(Dot(n, n));
+            Plane& plane = planes[t];
+            if (length > 0.0f)
+            {
+                plane.a = n.x / length;
+                plane.b = n.y / length;
+                plane.c = n.z / length;
+                plane.d = -(plane.a * p0.x + plane.b * p0.y + plane.c * p0.z);
+                plane.area = length * 0.5f;
+            }
+            else
+            {
+                plane = {};
+            }
+        }
+    });
+
+    // Vertex -> triangle adjacency, rebuilt for the current triangles.
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacency;
+    auto buildAdjacency = [&]()
+    {
+        adjacencyOffsets.assign(vertexCount + 1, 0);
+        for (uint32_t index : out)
+        {
+            adjacencyOffsets[index + 1]++;
+        }
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        }
+
+        adjacency.resize(out.size());
+        std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < out.size(); ++i)
+        {
+            adjacency[cursor[out[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    };
+
+    buildAdjacency();
+
+    // Vertex quadrics (parallel over vertices, each one gathers its own triangles).
+    std::vector<Quadric> quadrics(vertexCount);
+    ParallelFor(vertexCount, 4096, [&](size_t begin, size_t end)
+    {
+        for (size_t v = begin; v < end; ++v)
+        {
+            Quadric q = {};
+            for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+            {
+                const Plane& p = planes[adjacency[a]];
+                q.AddPlane(p.a, p.b, p.c, p.d, p.area);
+            }
+            quadrics[v] = q;
+        }
+    });
+
+    // Border edges get an extra plane through the edge, perpendicular to the triangle.
+    for (size_t t = 0; t < triCount; ++t)
+    {
+        const Plane& plane = planes[t];
+        for (int e = 0; e < 3; ++e)
+        {
+            const uint32_t a = out[t * 3 + e];
+            const uint32_t b = out[t * 3 + (e + 1) % 3];
+            if (!isBorderEdge(a, b))
+            {
+                continue;
+            }
+
+            const Float3 edge = Sub(positions[b], positions[a]);
+            const float edgeLength = std::sqrt(Dot(edge, edge));
+            Float3 n = Cross(edge, { plane.a, plane.b, plane.c });
+            const float length = std::sqrt(Dot(n, n));
+            if (length == 0.0f)
+            {
+                continue;
+            }
+
+            n = { n.x / length, n.y / length, n.z / length };
+            const float d = -Dot(n, positions[a]);
+            const double weight = BorderWeight * edgeLength;
+            quadrics[a].AddPlane(n.x, n.y, n.z, d, weight);
+            quadrics[b].AddPlane(n.x, n.y, n.z, d, weight);
+        }
+    }
+
+    const double maxCost = static_cast<double>(maxError) * maxError;
+    double resultCost = 0.0;
+
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<uint8_t> passLocked(vertexCount);
+    std::vector<Collapse> collapses;
+
+    size_t currentTris = triCount;
+    const size_t targetTris = targetIndexCount / 3;
+
+    while (currentTris > targetTris)
+    {
+        // Gather the legal collapses of this pass.
+        collapses.clear();
+        for (size_t i = 0; i < out.size(); i += 3)
+        {
+            for (int e = 0; e < 3; ++e)
+            {
+                const uint32_t a = out[i + e];
+                const uint32_t b = out[i + (e + 1) % 3];
+                for (int dir = 0; dir < 2; ++dir)
+                {
+                    const uint32_t from = dir == 0 ? a : b;
+                    const uint32_t to = dir == 0 ? b : a;
+                    if (kind[from] == VertexKind_Manifold ||
+                        (kind[from] == VertexKind_Border && isBorderEdge(a, b)))
+                    {
+                        collapses.push_back({ from, to, 0.0f });
+                    }
+                }
+            }
+        }
+
+        if (collapses.empty())
+        {
+            break;
+        }
+
+        ParallelFor(collapses.size(), 8192, [&](size_t begin, size_t end)
+        {
+            for (size_t c = begin; c < end; ++c)
+            {
+                Quadric q = quadrics[collapses[c].from];
+                q.Add(quadrics[collapses[c].to]);
+                collapses[c].cost = static_cast<float>(q.Evaluate(positions[collapses[c].to]));
+            }
+        });
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            remap[v] = v;
+        }
+        std::fill(passLocked.begin(), passLocked.end(), 0);
+
+        size_t removedTris = 0;
+        size_t performed = 0;
+        for (const Collapse& collapse : collapses)
+        {
+            if (collapse.cost > maxCost || currentTris - removedTris <= targetTris)
+            {
+                break;
+            }
+
+            const uint32_t from = collapse.from;
+            const uint32_t to = collapse.to;
+            if (passLocked[from] || passLocked[to])
+            {
+                continue;
+            }
+
+            // Reject collapses that would flip a remaining triangle around 'from'.
+            bool flips = false;
+            size_t collapsedTris = 0;
+            for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1] && !flips; ++a)
+            {
+                const uint32_t* tri = &out[adjacency[a] * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to)
+                {
+                    collapsedTris++;
+                    continue;
+                }
+
+                Float3 before[3], after[3];
+                for (int k = 0; k < 3; ++k)
+                {
+                    before[k] = positions[tri[k]];
+                    after[k] = tri[k] == from ? positions[to] : positions[tri[k]];
+                }
+
+                const Float3 n0 = Cross(Sub(before[1], before[0]), Sub(before[2], before[0]));
+                const Float3 n1 = Cross(Sub(after[1], after[0]), Sub(after[2], after[0]));
+                flips = Dot(n0, n1) <= 0.0f;
+            }
+
+            if (flips)
+            {
+                continue;
+            }
+
+            remap[from] = to;
+            quadrics[to].Add(quadrics[from]);
+            resultCost = std::max(resultCost, static_cast<double>(collapse.cost));
+            removedTris += collapsedTris;
+            performed++;
+
+            // Everything in the 1-ring of 'from' now has stale geometry for this pass.
+            for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; ++a)
+            {
+                const uint32_t* tri = &out[adjacency[a] * 3];
+                passLocked[tri[0]] = 1;
+                passLocked[tri[1]] = 1;
+                passLocked[tri[2]] = 1;
+            }
+        }
+
+        if (performed == 0)
+        {
+            break;
+        }
+
+        // Apply the collapses and drop the triangles that became degenerate.
+        size_t write = 0;
+        for (size_t i = 0; i < out.size(); i += 3)
+        {
+            const uint32_t a = remap[out[i + 0]];
+            const uint32_t b = remap[out[i + 1]];
+            const uint32_t c = remap[out[i + 2]];
+            if (a != b && b != c && a != c)
+            {
+                out[write++] = a;
+                out[write++] = b;
+                out[write++] = c;
+            }
+        }
+        out.resize(write);
+        currentTris = write / 3;
+
+        buildAdjacency();
+        buildEdges();
+    }
+
+    return static_cast<float>(std::sqrt(resultCost));
+}
+
+void MeshSimplifier::GenerateLodChain(
+    const SimplifierMesh& mesh,
+    uint32_t maxLevels,
+    float reduction,
+    float maxError,
+    LodChain& out) const
+{
+    out.Indices.assign(mesh.Indices, mesh.Indices + mesh.IndexCount);
+    out.Levels.clear();
+    out.Levels.push_back({ 0, static_cast<uint32_t>(mesh.IndexCount), 0.0f });
+
+    std::vector<uint32_t> previous(mesh.Indices, mesh.Indices + mesh.IndexCount);
+    std::vector<uint32_t> simplified;
+    float error = 0.0f;
+
+    for (uint32_t level = 1; level < maxLevels; ++level)
+    {
+        const size_t target = static_cast<size_t>(previous.size() / 3 * reduction) * 3;
+        const float levelError = Simplify(mesh, previous.data(), previous.size(), target, maxError, simplified);
+
+        // Stop once simplification stalls (locked seams, error limit...).
+        if (simplified.empty() || simplified.size() * 20 > previous.size() * 19)
+        {
+            break;
+        }
+
+        // Each level is built from the previous one, so the errors add up.
+        error += levelError;
+
+        out.Levels.push_back({ static_cast<uint32_t>(out.Indices.size()), static_cast<uint32_t>(simplified.size()), error });
+        out.Indices.insert(out.Indices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+}
+
+void MeshSimplifier::GenerateLodChains(
+    const SimplifierMesh* meshes,
+    size_t meshCount,
+    uint32_t maxLevels,
+    float reduction,
+    float maxError,
+    LodChain* out) const
+{
+    ParallelFor(meshCount, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t m = begin; m < end; ++m)
+        {
+            GenerateLodChain(meshes[m], maxLevels, reduction, maxError, out[m]);
+        }
+    });
+}
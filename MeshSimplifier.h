@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class ThreadPool;
+
+// Source geometry for the simplifier. Positions are float3 read with a byte stride so the
+// sample's Vertex array can be passed in directly.
+struct SimplifierMesh
+{
+    const uint32_t* Indices;
+    size_t IndexCount;
+    const void* Positions;
+    size_t PositionStride;
+    size_t VertexCount;
+};
+
+struct LodLevel
+{
+    uint32_t IndexOffset;   // First index of this level in LodChain::Indices.
+    uint32_t IndexCount;
+    float Error;            // Object space geometric error bound of this level.
+};
+
+// Every level references the original vertex buffer, so only the index data differs between
+// levels. All levels are packed back to back (LOD 0 first) to live in one shared index buffer.
+struct LodChain
+{
+    std::vector<uint32_t> Indices;
+    std::vector<LodLevel> Levels;
+};
+
+// Quadric error metric simplifier based on half-edge collapses.
+// Collapsing a vertex onto one of its neighbours never creates new vertices, so the texture
+// coordinates of the remaining vertices stay exact. Vertices that were split for a UV (or any
+// other attribute) seam are locked, and border vertices may only slide along the border, which
+// keeps seams and silhouettes from cracking open.
+class MeshSimplifier
+{
+public:
+    // pool may be null, in which case everything runs on the calling thread.
+    explicit MeshSimplifier(ThreadPool* pool = nullptr);
+
+    // Simplifies the triangles in indices (which index into mesh's vertices) down to
+    // targetIndexCount, or until the next collapse would exceed maxError.
+    // Returns the geometric error of the result.
+    float Simplify(
+        const SimplifierMesh& mesh,
+        const uint32_t* indices,
+        size_t indexCount,
+        size_t targetIndexCount,
+        float maxError,
+        std::vector<uint32_t>& out) const;
+
+    // Builds up to maxLevels levels, each one keeping about reduction of the previous level's
+    // triangles. Generation stops early when a level can't be reduced meaningfully any more.
+    void GenerateLodChain(
+        const SimplifierMesh& mesh,
+        uint32_t maxLevels,
+        float reduction,
+        float maxError,
+        LodChain& out) const;
+
+    // Builds the LOD chains of several meshes in parallel.
+    void GenerateLodChains(
+        const SimplifierMesh* meshes,
+        size_t meshCount,
+        uint32_t maxLevels,
+        float reduction,
+        float maxError,
+        LodChain* out) const;
+
+private:
+    void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fn) const;
+
+    ThreadPool* m_pool;
+};
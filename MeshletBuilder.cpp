@@ -0,0 +1,447 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    const uint32_t InvalidIndex = 0xFFFFFFFF;
+
+    struct Float3
+    {
+        float x, y, z;
+    };
+
+    inline Float3 LoadPosition(const uint8_t* positions, size_t stride, uint32_t index)
+    {
+        Float3 p;
+        memcpy(&p, positions + stride * index, sizeof(p));
+        return p;
+    }
+
+    inline Float3 Sub(const Float3& a, const Float3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    inline Float3 Add(const Float3& a, const Float3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+    inline Float3 Scale(const Float3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+    inline float Dot(const Float3& a, const Float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    inline float Length(const Float3& a) { return std::sqrt(Dot(a, a)); }
+
+    inline Float3 Cross(const Float3& a, const Float3& b)
+    {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    inline uint8_t QuantizeUnorm8(float v, bool roundUp)
+    {
+        float scaled = std::min(std::max(v, 0.0f), 1.0f) * 255.0f;
+        return static_cast<uint8_t>(roundUp ? std::ceil(scaled) : scaled + 0.5f);
+    }
+
+    inline uint32_t AlignUp(uint32_t value, uint32_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Smallest offset alignment that is a multiple of both 16 bytes and the element stride.
+    inline uint32_t SectionAlignment(uint32_t stride)
+    {
+        uint32_t a = stride, b = 16;
+        while (b != 0)
+        {
+            uint32_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return stride / a * 16;
+    }
+}
+
+MeshletBuilder::MeshletBuilder(uint32_t maxVerts, uint32_t maxPrims) :
+    m_maxVerts(maxVerts),
+    m_maxPrims(maxPrims)
+{
+    if (maxVerts < 3 || maxVerts > 1024 || maxPrims == 0)
+    {
+        throw std::invalid_argument("MeshletBuilder: unsupported meshlet limits");
+    }
+}
+
+// Greedy, adjacency driven meshlet generation.
+// A meshlet grows from a seed triangle by always taking the neighbouring triangle that adds
+// the fewest new vertices, which keeps meshlets spatially compact (tight bounds, tight cones)
+// and maximises vertex reuse. When a meshlet runs out of neighbours it keeps filling from the
+// next unassigned triangle in index order, so disconnected islands don't leave meshlets half empty.
+void MeshletBuilder::Build(
+    const uint32_t* indices,
+    size_t indexCount,
+    const void* positions,
+    size_t vertexCount,
+    size_t positionStride,
+    MeshletMesh& out) const
+{
+    if (indexCount % 3 != 0)
+    {
+        throw std::invalid_argument("MeshletBuilder: index count is not a multiple of 3");
+    }
+
+    out.Meshlets.clear();
+    out.CullData.clear();
+    out.UniqueVertexIndices.clear();
+    out.PrimitiveIndices.clear();
+
+    const size_t triCount = indexCount / 3;
+
+    // Vertex -> triangle adjacency in compressed rows.
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        if (indices[i] >= vertexCount)
+        {
+            throw std::out_of_range("MeshletBuilder: index out of range");
+        }
+        adjacencyOffsets[indices[i] + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+
+    std::vector<uint32_t> adjacency(indexCount);
+    {
+        std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<uint8_t> emitted(triCount, 0);
+    size_t remaining = triCount;
+
+    // Degenerate triangles never reach the rasterizer, so drop them up front.
+    for (size_t t = 0; t < triCount; ++t)
+    {
+        const uint32_t* tri = indices + t * 3;
+        if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2])
+        {
+            emitted[t] = 1;
+            --remaining;
+        }
+    }
+
+    std::vector<uint32_t> localIndex(vertexCount, InvalidIndex);
+    std::vector<uint32_t> candidates;
+    size_t scanCursor = 0;
+
+    Meshlet current = {};
+
+    auto newVertexCount = [&](size_t t)
+    {
+        const uint32_t* tri = indices + t * 3;
+        return (localIndex[tri[0]] == InvalidIndex ? 1u : 0u) +
+            (localIndex[tri[1]] == InvalidIndex ? 1u : 0u) +
+            (localIndex[tri[2]] == InvalidIndex ? 1u : 0u);
+    };
+
+    auto fits = [&](uint32_t newVerts)
+    {
+        return current.VertCount + newVerts <= m_maxVerts && current.PrimCount < m_maxPrims;
+    };
+
+    auto addTriangle = [&](size_t t)
+    {
+        const uint32_t* tri = indices + t * 3;
+        uint32_t local[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t v = tri[k];
+            if (localIndex[v] == InvalidIndex)
+            {
+                localIndex[v] = current.VertCount++;
+                out.UniqueVertexIndices.push_back(v);
+
+                // Only a new vertex can bring in new neighbours.
+                for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+                {
+                    if (!emitted[adjacency[a]])
+                    {
+                        candidates.push_back(adjacency[a]);
+                    }
+                }
+            }
+            local[k] = localIndex[v];
+        }
+
+        out.PrimitiveIndices.push_back(PackTriangle(local[0], local[1], local[2]));
+        current.PrimCount++;
+        emitted[t] = 1;
+        --remaining;
+    };
+
+    auto flush = [&]()
+    {
+        if (current.PrimCount > 0)
+        {
+            for (uint32_t i = 0; i < current.VertCount; ++i)
+            {
+                localIndex[out.UniqueVertexIndices[current.VertOffset + i]] = InvalidIndex;
+            }
+            out.Meshlets.push_back(current);
+        }
+
+        current.VertCount = 0;
+        current.VertOffset = static_cast<uint32_t>(out.UniqueVertexIndices.size());
+        current.PrimCount = 0;
+        current.PrimOffset = static_cast<uint32_t>(out.PrimitiveIndices.size());
+        candidates.clear();
+    };
+
+    flush();
+
+    while (remaining > 0)
+    {
+        // Pick the neighbour that adds the fewest vertices; stop early on a perfect fit.
+        size_t best = InvalidIndex;
+        uint32_t bestScore = 4;
+        for (size_t k = 0; k < candidates.size();)
+        {
+            const uint32_t t = candidates[k];
+            if (emitted[t])
+            {
+                candidates[k] = candidates.back();
+                candidates.pop_back();
+                continue;
+            }
+
+            const uint32_t score = newVertexCount(t);
+            if (score < bestScore)
+            {
+                best = t;
+                bestScore = score;
+                if (score == 0)
+                {
+                    break;
+                }
+            }
+            ++k;
+        }
+
+        if (best != InvalidIndex)
+        {
+            if (fits(bestScore))
+            {
+                addTriangle(best);
+            }
+            else
+            {
+                flush();
+            }
+            continue;
+        }
+
+        // No neighbours left: continue with the next unassigned triangle in index order.
+        while (emitted[scanCursor])
+        {
+            ++scanCursor;
+        }
+
+        if (fits(newVertexCount(scanCursor)))
+        {
+            addTriangle(scanCursor);
+        }
+        else
+        {
+            flush();
+        }
+    }
+
+    flush();
+
+    const uint8_t* positionBytes = static_cast<const uint8_t*>(positions);
+    out.CullData.resize(out.Meshlets.size());
+    for (size_t m = 0; m < out.Meshlets.size(); ++m)
+    {
+        ComputeCullData(out.Meshlets[m], out, positionBytes, positionStride, out.CullData[m]);
+    }
+}
+
+void MeshletBuilder::ComputeCullData(
+    const Meshlet& meshlet,
+    const MeshletMesh& mesh,
+    const uint8_t* positions,
+    size_t positionStride,
+    MeshletCullData& cull) const
+{
+    const uint32_t* vertexIndices = mesh.UniqueVertexIndices.data() + meshlet.VertOffset;
+
+    // Bounding sphere (Ritter): start from the two most distant points found by two sweeps,
+    // then grow the sphere to enclose any point left outside.
+    Float3 center;
+    float radius;
+    {
+        const Float3 p0 = LoadPosition(positions, positionStride, vertexIndices[0]);
+        Float3 a = p0;
+        float maxDist = -1.0f;
+        for (uint32_t i = 0; i < meshlet.VertCount; ++i)
+        {
+            const Float3 p = LoadPosition(positions, positionStride, vertexIndices[i]);
+            const Float3 d = Sub(p, p0);
+            if (Dot(d, d) > maxDist)
+            {
+                maxDist = Dot(d, d);
+                a = p;
+            }
+        }
+
+        Float3 b = a;
+        maxDist = -1.0f;
+        for (uint32_t i = 0; i < meshlet.VertCount; ++i)
+        {
+            const Float3 p = LoadPosition(positions, positionStride, vertexIndices[i]);
+            const Float3 d = Sub(p, a);
+            if (Dot(d, d) > maxDist)
+            {
+                maxDist = Dot(d, d);
+                b = p;
+            }
+        }
+
+        center = Scale(Add(a, b), 0.5f);
+        radius = Length(Sub(b, a)) * 0.5f;
+
+        for (uint32_t i = 0; i < meshlet.VertCount; ++i)
+        {
+            const Float3 p = LoadPosition(positions, positionStride, vertexIndices[i]);
+            const float dist = Length(Sub(p, center));
+            if (dist > radius)
+            {
+                const float newRadius = (radius + dist) * 0.5f;
+                center = Add(center, Scale(Sub(p, center), (newRadius - radius) / dist));
+                radius = newRadius;
+            }
+        }
+    }
+
+    cull.BoundingSphere[0] = center.x;
+    cull.BoundingSphere[1] = center.y;
+    cull.BoundingSphere[2] = center.z;
+    cull.BoundingSphere[3] = radius;
+    cull.ApexOffset = 0.0f;
+
+    // Normal cone.
+    std::vector<Float3> normals;
+    std::vector<Float3> triPositions;
+    normals.reserve(meshlet.PrimCount);
+    triPositions.reserve(meshlet.PrimCount);
+
+    Float3 axis = { 0.0f, 0.0f, 0.0f };
+    for (uint32_t i = 0; i < meshlet.PrimCount; ++i)
+    {
+        uint32_t i0, i1, i2;
+        UnpackTriangle(mesh.PrimitiveIndices[meshlet.PrimOffset + i], i0, i1, i2);
+
+        const Float3 p0 = LoadPosition(positions, positionStride, vertexIndices[i0]);
+        const Float3 p1 = LoadPosition(positions, positionStride, vertexIndices[i1]);
+        const Float3 p2 = LoadPosition(positions, positionStride, vertexIndices[i2]);
+
+        // Clockwise front faces, matching the default rasterizer state.
+        Float3 n = Cross(Sub(p1, p0), Sub(p2, p0));
+        const float length = Length(n);
+        if (length <= 1e-20f)
+        {
+            // Zero area triangles have no facing, so they can't widen the cone.
+            continue;
+        }
+
+        n = Scale(n, 1.0f / length);
+        normals.push_back(n);
+        triPositions.push_back(p0);
+        axis = Add(axis, n);
+    }
+
+    const float axisLength = Length(axis);
+    float minDot = 1.0f;
+    if (axisLength > 1e-6f)
+    {
+        axis = Scale(axis, 1.0f / axisLength);
+        for (const Float3& n : normals)
+        {
+            minDot = std::min(minDot, Dot(axis, n));
+        }
+    }
+    else
+    {
+        minDot = -1.0f;
+    }
+
+    // Cones wider than ~84 degrees almost never cull anything; mark them degenerate.
+    if (minDot < 0.1f)
+    {
+        cull.NormalCone[0] = 127;
+        cull.NormalCone[1] = 127;
+        cull.NormalCone[2] = 127;
+        cull.NormalCone[3] = 255;
+        return;
+    }
+
+    // Move the apex back along the axis until it lies behind every triangle plane.
+    float maxT = 0.0f;
+    for (size_t i = 0; i < normals.size(); ++i)
+    {
+        const float dc = Dot(Sub(center, triPositions[i]), normals[i]);
+        const float dn = Dot(axis, normals[i]);
+        maxT = std::max(maxT, dc / dn);
+    }
+    cull.ApexOffset = maxT;
+
+    // The culling cone is the normal cone widened by 90 degrees and inverted:
+    // -cos(a + 90) = sin(a) = sqrt(1 - cos(a)^2). Rounding up keeps the test conservative.
+    const float coneCutoff = std::sqrt(1.0f - minDot * minDot);
+
+    cull.NormalCone[0] = QuantizeUnorm8(axis.x * 0.5f + 0.5f, false);
+    cull.NormalCone[1] = QuantizeUnorm8(axis.y * 0.5f + 0.5f, false);
+    cull.NormalCone[2] = QuantizeUnorm8(axis.z * 0.5f + 0.5f, false);
+    cull.NormalCone[3] = QuantizeUnorm8(coneCutoff, true);
+}
+
+std::vector<uint8_t> MeshletBuilder::Serialize(const MeshletMesh& mesh)
+{
+    MeshletBlobHeader header = {};
+    header.Magic = BlobMagic;
+    header.Version = BlobVersion;
+    header.MeshletCount = static_cast<uint32_t>(mesh.Meshlets.size());
+    header.UniqueVertexIndexCount = static_cast<uint32_t>(mesh.UniqueVertexIndices.size());
+    header.PrimitiveCount = static_cast<uint32_t>(mesh.PrimitiveIndices.size());
+
+    uint32_t offset = sizeof(MeshletBlobHeader);
+    offset = AlignUp(offset, SectionAlignment(sizeof(Meshlet)));
+    header.MeshletOffset = offset;
+    offset += header.MeshletCount * sizeof(Meshlet);
+
+    offset = AlignUp(offset, SectionAlignment(sizeof(MeshletCullData)));
+    header.CullDataOffset = offset;
+    offset += header.MeshletCount * sizeof(MeshletCullData);
+
+    offset = AlignUp(offset, SectionAlignment(sizeof(uint32_t)));
+    header.UniqueVertexIndexOffset = offset;
+    offset += header.UniqueVertexIndexCount * sizeof(uint32_t);
+
+    offset = AlignUp(offset, SectionAlignment(sizeof(uint32_t)));
+    header.PrimitiveOffset = offset;
+    offset += header.PrimitiveCount * sizeof(uint32_t);
+
+    header.TotalSize = AlignUp(offset, 16);
+
+    std::vector<uint8_t> blob(header.TotalSize, 0);
+    memcpy(blob.data(), &header, sizeof(header));
+    if (!mesh.Meshlets.empty())
+    {
+        memcpy(blob.data() + header.MeshletOffset, mesh.Meshlets.data(), mesh.Meshlets.size() * sizeof(Meshlet));
+        memcpy(blob.data() + header.CullDataOffset, mesh.CullData.data(), mesh.CullData.size() * sizeof(MeshletCullData));
+        memcpy(blob.data() + header.UniqueVertexIndexOffset, mesh.UniqueVertexIndices.data(), mesh.UniqueVertexIndices.size() * sizeof(uint32_t));
+        memcpy(blob.data() + header.PrimitiveOffset, mesh.PrimitiveIndices.data(), mesh.PrimitiveIndices.size() * sizeof(uint32_t));
+    }
+
+    return blob;
+}
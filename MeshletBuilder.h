@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// CPU preprocessing stage for the mesh shader path.
+// Splits an indexed triangle list into meshlets small enough for one mesh shader
+// thread group, and computes the per-meshlet bounds used for GPU culling.
+// This code only depends on the C++ standard library so it can be built and
+// profiled outside of the Windows project.
+
+// Matches the layout read by the mesh shader (StructuredBuffer<Meshlet>).
+struct Meshlet
+{
+    uint32_t VertCount;
+    uint32_t VertOffset;    // Into UniqueVertexIndices.
+    uint32_t PrimCount;
+    uint32_t PrimOffset;    // Into PrimitiveIndices.
+};
+
+// Per-meshlet culling data.
+// BoundingSphere: xyz = center, w = radius.
+// NormalCone: xyz = cone axis packed as UNORM8 ([-1, 1] -> [0, 255]),
+//             w = sin(cone half angle) packed as UNORM8. w == 255 means the cone is degenerate
+//             and the meshlet must never be backface culled.
+// ApexOffset: the cone apex is BoundingSphere.xyz - axis * ApexOffset.
+// Backface test in the shader: cull when dot(normalize(apex - eye), axis) >= w.
+struct MeshletCullData
+{
+    float BoundingSphere[4];
+    uint8_t NormalCone[4];
+    float ApexOffset;
+};
+
+struct MeshletMesh
+{
+    std::vector<Meshlet> Meshlets;
+    std::vector<MeshletCullData> CullData;
+    std::vector<uint32_t> UniqueVertexIndices;  // Meshlet-local vertex -> mesh vertex.
+    std::vector<uint32_t> PrimitiveIndices;     // Three 10-bit meshlet-local indices per triangle.
+};
+
+// Header of the GPU-ready blob written by MeshletBuilder::Serialize.
+// Every section offset is relative to the start of the blob and is a multiple of both
+// 16 and the section's element size, so each section can be viewed as a structured buffer
+// straight out of a single upload.
+struct MeshletBlobHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t MeshletCount;
+    uint32_t UniqueVertexIndexCount;
+    uint32_t PrimitiveCount;
+    uint32_t MeshletOffset;
+    uint32_t CullDataOffset;
+    uint32_t UniqueVertexIndexOffset;
+    uint32_t PrimitiveOffset;
+    uint32_t TotalSize;
+};
+
+class MeshletBuilder
+{
+public:
+    static const uint32_t BlobMagic = 0x4C48534D;   // 'MSHL'
+    static const uint32_t BlobVersion = 1;
+
+    // Mesh shader limits are 256 vertices / 256 primitives per group, but 64 / 124 keeps the
+    // output arrays inside the fast path on current hardware.
+    // Local indices are packed in 10 bits, so maxVerts may not exceed 1024.
+    MeshletBuilder(uint32_t maxVerts = 64, uint32_t maxPrims = 124);
+
+    // positions points at the first vertex's float3 position; positionStride is the distance in
+    // bytes between two consecutive positions (e.g. sizeof(Vertex)).
+    void Build(
+        const uint32_t* indices,
+        size_t indexCount,
+        const void* positions,
+        size_t vertexCount,
+        size_t positionStride,
+        MeshletMesh& out) const;
+
+    // Packs the meshlet mesh into a single blob that can be memcpy'd into an upload buffer.
+    static std::vector<uint8_t> Serialize(const MeshletMesh& mesh);
+
+    static uint32_t PackTriangle(uint32_t i0, uint32_t i1, uint32_t i2)
+    {
+        return (i0 & 0x3FF) | ((i1 & 0x3FF) << 10) | ((i2 & 0x3FF) << 20);
+    }
+
+    static void UnpackTriangle(uint32_t packed, uint32_t& i0, uint32_t& i1, uint32_t& i2)
+    {
+        i0 = packed & 0x3FF;
+        i1 = (packed >> 10) & 0x3FF;
+        i2 = (packed >> 20) & 0x3FF;
+    }
+
+private:
+    void ComputeCullData(
+        const Meshlet& meshlet,
+        const MeshletMesh& mesh,
+        const uint8_t* positions,
+        size_t positionStride,
+        MeshletCullData& cull) const;
+
+    uint32_t m_maxVerts;
+    uint32_t m_maxPrims;
+};
@@ -0,0 +1,396 @@
+#include "MetricsRegistry.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <intrin.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const intptr_t NoSocket = -1;
+
+    inline uint32_t HighestBit(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return index;
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    // Value of the bucket reached after rank values in bucket order; the bucket midpoint keeps
+    // the error within half a bucket either way.
+    uint64_t ValueAtRank(const std::vector<uint64_t>& counts, uint64_t rank)
+    {
+        uint64_t seen = 0;
+        for (uint32_t bucket = 0; bucket < counts.size(); ++bucket)
+        {
+            seen += counts[bucket];
+            if (seen >= rank && counts[bucket] > 0)
+            {
+                return MetricHistogram::GetBucketLowerBound(bucket) + (MetricHistogram::GetBucketWidth(bucket) - 1) / 2;
+            }
+        }
+        return 0;
+    }
+
+    void WriteJsonString(std::ostream& out, const std::string& value)
+    {
+        out << '"';
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << '"';
+    }
+
+#if defined(_WIN32)
+    void CloseSocket(intptr_t socket) { closesocket(static_cast<SOCKET>(socket)); }
+#else
+    void CloseSocket(intptr_t socket) { close(static_cast<int>(socket)); }
+#endif
+}
+
+MetricHistogram::MetricHistogram() :
+    m_buckets(new std::atomic<uint64_t>[BucketCount]),
+    m_sum(0)
+{
+    for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+    {
+        m_buckets[bucket].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint32_t MetricHistogram::GetBucketIndex(uint64_t value)
+{
+    if (value < SubBucketCount)
+    {
+        return static_cast<uint32_t>(value);
+    }
+
+    // [2^m, 2^(m+1)) is split in SubBucketCount buckets of width 2^(m - SubBucketBits).
+    const uint32_t magnitude = HighestBit(value);
+    const uint32_t shift = magnitude - SubBucketBits;
+    const uint32_t subBucket = static_cast<uint32_t>(value >> shift) - SubBucketCount;
+    return SubBucketCount + shift * SubBucketCount + subBucket;
+}
+
+uint64_t MetricHistogram::GetBucketLowerBound(uint32_t bucket)
+{
+    if (bucket < SubBucketCount)
+    {
+        return bucket;
+    }
+
+    const uint32_t shift = (bucket - SubBucketCount) / SubBucketCount;
+    const uint64_t subBucket = (bucket - SubBucketCount) % SubBucketCount;
+    return (SubBucketCount + subBucket) << shift;
+}
+
+uint64_t MetricHistogram::GetBucketWidth(uint32_t bucket)
+{
+    return bucket < SubBucketCount ? 1 : uint64_t(1) << ((bucket - SubBucketCount) / SubBucketCount);
+}
+
+void MetricHistogram::Read(std::vector<uint64_t>& counts, uint64_t& sum) const
+{
+    counts.resize(BucketCount);
+    for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+    {
+        counts[bucket] = m_buckets[bucket].load(std::memory_order_relaxed);
+    }
+    sum = m_sum.load(std::memory_order_relaxed);
+}
+
+const HistogramSummary* MetricsSnapshot::FindHistogram(const std::string& name) const
+{
+    for (const HistogramSummary& histogram : Histograms)
+    {
+        if (histogram.Name == name)
+        {
+            return &histogram;
+        }
+    }
+    return nullptr;
+}
+
+void MetricsSnapshot::WriteJson(std::ostream& out) const
+{
+    out << "{\"seconds\":" << Seconds << ",\"interval\":" << IntervalSeconds << ",\"counters\":{";
+    for (size_t i = 0; i < Counters.size(); ++i)
+    {
+        out << (i ? "," : "");
+        WriteJsonString(out, Counters[i].Name);
+        out << ":{\"total\":" << Counters[i].Total << ",\"rate\":" << Counters[i].PerSecond << '}';
+    }
+    out << "},\"gauges\":{";
+    for (size_t i = 0; i < Gauges.size(); ++i)
+    {
+        out << (i ? "," : "");
+        WriteJsonString(out, Gauges[i].Name);
+        out << ':' << Gauges[i].Value;
+    }
+    out << "},\"histograms\":{";
+    for (size_t i = 0; i < Histograms.size(); ++i)
+    {
+        const HistogramSummary& h = Histograms[i];
+        out << (i ? "," : "");
+        WriteJsonString(out, h.Name);
+        out << ":{\"count\":" << h.Count << ",\"mean\":" << h.Mean << ",\"p50\":" << h.P50 << ",\"p95\":" << h.P95
+            << ",\"p99\":" << h.P99 << ",\"max\":" << h.Max << '}';
+    }
+    out << "}}\n";
+}
+
+MetricsRegistry::MetricsRegistry() :
+    m_start(std::chrono::steady_clock::now()),
+    m_lastSnapshot(m_start)
+{
+}
+
+MetricCounter* MetricsRegistry::GetCounter(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Entry<MetricCounter>& entry : m_counters)
+    {
+        if (entry.Name == name)
+        {
+            return entry.Metric.get();
+        }
+    }
+    m_counters.push_back({ name, std::unique_ptr<MetricCounter>(new MetricCounter()) });
+    return m_counters.back().Metric.get();
+}
+
+MetricGauge* MetricsRegistry::GetGauge(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Entry<MetricGauge>& entry : m_gauges)
+    {
+        if (entry.Name == name)
+        {
+            return entry.Metric.get();
+        }
+    }
+    m_gauges.push_back({ name, std::unique_ptr<MetricGauge>(new MetricGauge()) });
+    return m_gauges.back().Metric.get();
+}
+
+MetricHistogram* MetricsRegistry::GetHistogram(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Entry<MetricHistogram>& entry : m_histograms)
+    {
+        if (entry.Name == name)
+        {
+            return entry.Metric.get();
+        }
+    }
+    m_histograms.push_back({ name, std::unique_ptr<MetricHistogram>(new MetricHistogram()) });
+    return m_histograms.back().Metric.get();
+}
+
+MetricsSnapshot MetricsRegistry::Snapshot()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto now = std::chrono::steady_clock::now();
+    MetricsSnapshot snapshot;
+    snapshot.Seconds = std::chrono::duration<double>(now - m_start).count();
+    snapshot.IntervalSeconds = std::chrono::duration<double>(now - m_lastSnapshot).count();
+    m_lastSnapshot = now;
+
+    m_lastCounterTotals.resize(m_counters.size(), 0);
+    for (size_t i = 0; i < m_counters.size(); ++i)
+    {
+        const uint64_t total = m_counters[i].Metric->Get();
+        const double delta = static_cast<double>(total - m_lastCounterTotals[i]);
+        snapshot.Counters.push_back({ m_counters[i].Name, total, snapshot.IntervalSeconds > 0.0 ? delta / snapshot.IntervalSeconds : 0.0 });
+        m_lastCounterTotals[i] = total;
+    }
+
+    for (const Entry<MetricGauge>& entry : m_gauges)
+    {
+        snapshot.Gauges.push_back({ entry.Name, entry.Metric->Get() });
+    }
+
+    m_lastHistogramCounts.resize(m_histograms.size(), std::vector<uint64_t>(MetricHistogram::BucketCount, 0));
+    m_lastHistogramSums.resize(m_histograms.size(), 0);
+    std::vector<uint64_t> counts;
+    for (size_t i = 0; i < m_histograms.size(); ++i)
+    {
+        uint64_t sum;
+        m_histograms[i].Metric->Read(counts, sum);
+
+        // Interval histogram = current totals minus the totals at the previous snapshot.
+        HistogramSummary summary = {};
+        summary.Name = m_histograms[i].Name;
+        std::vector<uint64_t>& last = m_lastHistogramCounts[i];
+        for (uint32_t bucket = 0; bucket < MetricHistogram::BucketCount; ++bucket)
+        {
+            const uint64_t current = counts[bucket];
+            counts[bucket] = current - last[bucket];
+            last[bucket] = current;
+            summary.Count += counts[bucket];
+            if (counts[bucket] > 0)
+            {
+                summary.Max = MetricHistogram::GetBucketLowerBound(bucket) + MetricHistogram::GetBucketWidth(bucket) - 1;
+            }
+        }
+
+        const uint64_t intervalSum = sum - m_lastHistogramSums[i];
+        m_lastHistogramSums[i] = sum;
+
+        if (summary.Count > 0)
+        {
+            summary.Mean = static_cast<double>(intervalSum) / summary.Count;
+            summary.P50 = ValueAtRank(counts, (summary.Count * 50 + 99) / 100);
+            summary.P95 = ValueAtRank(counts, (summary.Count * 95 + 99) / 100);
+            summary.P99 = ValueAtRank(counts, (summary.Count * 99 + 99) / 100);
+        }
+        snapshot.Histograms.push_back(summary);
+    }
+
+    return snapshot;
+}
+
+MetricsExporter::MetricsExporter() :
+    m_socket(NoSocket),
+    m_address{}
+{
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    if (m_socket != NoSocket)
+    {
+        CloseSocket(m_socket);
+#if defined(_WIN32)
+        WSACleanup();
+#endif
+    }
+}
+
+void MetricsExporter::OpenFile(const std::string& path)
+{
+    std::unique_ptr<std::ofstream> file(new std::ofstream(path, std::ios::app));
+    if (!*file)
+    {
+        throw std::runtime_error("MetricsExporter: can't open " + path);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_file = std::move(file);
+}
+
+#if defined(_WIN32)
+void MetricsExporter::OpenFile(const std::wstring& path)
+{
+    std::unique_ptr<std::ofstream> file(new std::ofstream(path, std::ios::app));
+    if (!*file)
+    {
+        throw std::runtime_error("MetricsExporter: can't open the metrics file");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_file = std::move(file);
+}
+#endif
+
+void MetricsExporter::OpenUdp(uint16_t port, const char* address)
+{
+    static_assert(sizeof(sockaddr_in) <= sizeof(m_address), "m_address must hold a sockaddr_in");
+
+    sockaddr_in destination = {};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(port);
+    if (inet_pton(AF_INET, address, &destination.sin_addr) != 1)
+    {
+        throw std::runtime_error("MetricsExporter: invalid address");
+    }
+
+#if defined(_WIN32)
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    {
+        throw std::runtime_error("MetricsExporter: WSAStartup failed");
+    }
+    const SOCKET created = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    const intptr_t handle = created == INVALID_SOCKET ? NoSocket : static_cast<intptr_t>(created);
+    if (handle == NoSocket)
+    {
+        WSACleanup();
+    }
+#else
+    const intptr_t handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#endif
+    if (handle == NoSocket)
+    {
+        throw std::runtime_error("MetricsExporter: can't create socket");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_socket != NoSocket)
+    {
+        CloseSocket(m_socket);
+#if defined(_WIN32)
+        WSACleanup();
+#endif
+    }
+    m_socket = handle;
+    memcpy(m_address, &destination, sizeof(destination));
+}
+
+bool MetricsExporter::IsOpen() const
+{
+    return m_file || m_socket != NoSocket;
+}
+
+void MetricsExporter::Export(const MetricsSnapshot& snapshot)
+{
+    std::ostringstream line;
+    snapshot.WriteJson(line);
+    const std::string text = line.str();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file)
+    {
+        m_file->write(text.data(), text.size());
+        m_file->flush();
+    }
+    if (m_socket != NoSocket)
+    {
+        // Fire and forget: nobody listening is not an error.
+#if defined(_WIN32)
+        sendto(static_cast<SOCKET>(m_socket), text.data(), static_cast<int>(text.size()), 0,
+            reinterpret_cast<const sockaddr*>(m_address), sizeof(sockaddr_in));
+#else
+        sendto(static_cast<int>(m_socket), text.data(), text.size(), 0,
+            reinterpret_cast<const sockaddr*>(m_address), sizeof(sockaddr_in));
+#endif
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Runtime metrics.
+// Counters, gauges and histograms are updated from any thread with relaxed atomics only: no locks,
+// no allocation, a few nanoseconds per update. Metrics are registered once by name (that part
+// takes a lock) and the returned pointer is kept by the code that updates it.
+
+class MetricCounter
+{
+public:
+    MetricCounter() : m_value(0) {}
+
+    void Add(uint64_t amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t Get() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> m_value;
+};
+
+class MetricGauge
+{
+public:
+    MetricGauge() : m_value(0) {}
+
+    void Set(int64_t value) { m_value.store(value, std::memory_order_relaxed); }
+    void Add(int64_t amount) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    int64_t Get() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> m_value;
+};
+
+// Log-linear (HDR style) histogram of unsigned 64-bit values.
+// Every power of two range is split into SubBucketCount equal buckets, so any recorded value is
+// known to within 1/32 (about 3%) over the whole 64-bit range with a fixed 1920 buckets.
+class MetricHistogram
+{
+public:
+    static const uint32_t SubBucketBits = 5;
+    static const uint32_t SubBucketCount = 1u << SubBucketBits;
+    static const uint32_t BucketCount = SubBucketCount + (64 - SubBucketBits) * SubBucketCount;
+
+    MetricHistogram();
+
+    void Record(uint64_t value)
+    {
+        m_buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    static uint32_t GetBucketIndex(uint64_t value);
+    static uint64_t GetBucketLowerBound(uint32_t bucket);
+    static uint64_t GetBucketWidth(uint32_t bucket);
+
+    // Copies the current bucket counts and the sum of all recorded values.
+    void Read(std::vector<uint64_t>& counts, uint64_t& sum) const;
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;
+    std::atomic<uint64_t> m_sum;
+};
+
+struct HistogramSummary
+{
+    std::string Name;
+    uint64_t Count;
+    double Mean;
+    uint64_t P50;
+    uint64_t P95;
+    uint64_t P99;
+    uint64_t Max;
+};
+
+struct MetricsSnapshot
+{
+    double Seconds;             // Since the registry was created.
+    double IntervalSeconds;     // Since the previous snapshot.
+
+    struct CounterValue
+    {
+        std::string Name;
+        uint64_t Total;
+        double PerSecond;       // Over the interval.
+    };
+    struct GaugeValue
+    {
+        std::string Name;
+        int64_t Value;
+    };
+
+    std::vector<CounterValue> Counters;
+    std::vector<GaugeValue> Gauges;
+    // Values recorded during the interval only.
+    std::vector<HistogramSummary> Histograms;
+
+    const HistogramSummary* FindHistogram(const std::string& name) const;
+
+    // A single line of JSON, so exported snapshots form a JSON Lines stream.
+    void WriteJson(std::ostream& out) const;
+};
+
+class MetricsRegistry
+{
+public:
+    MetricsRegistry();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // Returns the metric with that name, creating it on first use. The pointer stays valid for
+    // the lifetime of the registry.
+    MetricCounter* GetCounter(const std::string& name);
+    MetricGauge* GetGauge(const std::string& name);
+    MetricHistogram* GetHistogram(const std::string& name);
+
+    // Reads every metric. Histograms and counter rates cover the time since the previous call.
+    MetricsSnapshot Snapshot();
+
+private:
+    template <typename T>
+    struct Entry
+    {
+        std::string Name;
+        std::unique_ptr<T> Metric;
+    };
+
+    std::mutex m_mutex;
+    std::vector<Entry<MetricCounter>> m_counters;
+    std::vector<Entry<MetricGauge>> m_gauges;
+    std::vector<Entry<MetricHistogram>> m_histograms;
+
+    // State of the previous snapshot, to turn running totals into interval values.
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_lastSnapshot;
+    std::vector<uint64_t> m_lastCounterTotals;
+    std::vector<std::vector<uint64_t>> m_lastHistogramCounts;
+    std::vector<uint64_t> m_lastHistogramSums;
+};
+
+// Sends snapshots to a JSON Lines file and/or a local UDP port, one line (datagram) per snapshot.
+// Export may be called from a worker thread.
+class MetricsExporter
+{
+public:
+    MetricsExporter();
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Throw std::runtime_error on failure.
+    void OpenFile(const std::string& path);
+#if defined(_WIN32)
+    void OpenFile(const std::wstring& path);
+#endif
+    void OpenUdp(uint16_t port, const char* address = "127.0.0.1");
+
+    bool IsOpen() const;
+    void Export(const MetricsSnapshot& snapshot);
+
+private:
+    std::mutex m_mutex;
+    std::unique_ptr<std::ostream> m_file;
+    intptr_t m_socket;
+    uint8_t m_address[16];      // sockaddr_in, kept opaque to avoid socket headers here.
+};
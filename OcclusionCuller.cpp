@@ -0,0 +1,484 @@
+#include "OcclusionCuller.h"
+#include "FrameAllocators.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Thin wrappers so the tile rasterizer is written once for both vector widths.
+#if defined(__AVX2__)
+    typedef __m256 Lanes;
+    const uint32_t LaneCount = 8;
+    inline Lanes LaneSet(float v) { return _mm256_set1_ps(v); }
+    inline Lanes LaneOffsets() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+    inline Lanes LaneAdd(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+    inline Lanes LaneMul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+    inline Lanes LaneMin(Lanes a, Lanes b) { return _mm256_min_ps(a, b); }
+    inline Lanes LaneAnd(Lanes a, Lanes b) { return _mm256_and_ps(a, b); }
+    inline Lanes LaneGreaterEqual(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    inline Lanes LaneSelect(Lanes whenFalse, Lanes whenTrue, Lanes mask) { return _mm256_blendv_ps(whenFalse, whenTrue, mask); }
+    inline Lanes LaneLoad(const float* p) { return _mm256_loadu_ps(p); }
+    inline void LaneStore(float* p, Lanes v) { _mm256_storeu_ps(p, v); }
+    inline bool LaneAny(Lanes mask) { return _mm256_movemask_ps(mask) != 0; }
+#else
+    typedef __m128 Lanes;
+    const uint32_t LaneCount = 4;
+    inline Lanes LaneSet(float v) { return _mm_set1_ps(v); }
+    inline Lanes LaneOffsets() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+    inline Lanes LaneAdd(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+    inline Lanes LaneMul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+    inline Lanes LaneMin(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+    inline Lanes LaneAnd(Lanes a, Lanes b) { return _mm_and_ps(a, b); }
+    inline Lanes LaneGreaterEqual(Lanes a, Lanes b) { return _mm_cmpge_ps(a, b); }
+    inline Lanes LaneSelect(Lanes whenFalse, Lanes whenTrue, Lanes mask) { return _mm_or_ps(_mm_and_ps(mask, whenTrue), _mm_andnot_ps(mask, whenFalse)); }
+    inline Lanes LaneLoad(const float* p) { return _mm_loadu_ps(p); }
+    inline void LaneStore(float* p, Lanes v) { _mm_storeu_ps(p, v); }
+    inline bool LaneAny(Lanes mask) { return _mm_movemask_ps(mask) != 0; }
+#endif
+
+    // Texels of the Hi-Z level used for a box test, per axis.
+    const uint32_t MaxTestTexels = 4;
+
+    void MultiplyMatrix(const float a[16], const float b[16], float out[16])
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                out[r * 4 + c] = a[r * 4 + 0] * b[0 * 4 + c] + a[r * 4 + 1] * b[1 * 4 + c] +
+                    a[r * 4 + 2] * b[2 * 4 + c] + a[r * 4 + 3] * b[3 * 4 + c];
+            }
+        }
+    }
+
+    void TransformPoint(const float p[3], const float m[16], float out[4])
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            out[c] = p[0] * m[0 * 4 + c] + p[1] * m[1 * 4 + c] + p[2] * m[2 * 4 + c] + m[3 * 4 + c];
+        }
+    }
+}
+
+OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height, ThreadPool* pool) :
+    m_width(width),
+    m_height(height),
+    m_tilesX(width / TileWidth),
+    m_tilesY(height / TileHeight),
+    m_pool(pool),
+    m_viewProjection{},
+    m_pendingViewProjection{},
+    m_hasPending(false)
+{
+    if (width == 0 || height == 0 || width % TileWidth != 0 || height % TileHeight != 0)
+    {
+        throw std::invalid_argument("OcclusionCuller: resolution must be a multiple of the tile size");
+    }
+
+    m_tileBins.resize(m_tilesX * m_tilesY);
+    m_depth.assign(m_width * m_height, 1.0f);
+
+    uint32_t w = m_width, h = m_height;
+    while (w > 1 || h > 1)
+    {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        m_hiZWidth.push_back(w);
+        m_hiZHeight.push_back(h);
+        m_hiZ.emplace_back(w * h, 1.0f);
+    }
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+    if (m_hasPending)
+    {
+        m_pending.wait();
+    }
+}
+
+void OcclusionCuller::ClearOccluders()
+{
+    m_occluders.clear();
+}
+
+void OcclusionCuller::AddOccluder(const OccluderMesh& occluder)
+{
+    m_occluders.push_back(occluder);
+}
+
+void OcclusionCuller::BeginFrame(const float viewProjection[16])
+{
+    if (m_hasPending)
+    {
+        m_pending.wait();
+    }
+
+    memcpy(m_pendingViewProjection, viewProjection, sizeof(m_pendingViewProjection));
+
+    if (!m_pool)
+    {
+        Rasterize(m_pendingViewProjection);
+        return;
+    }
+
+    auto task = std::make_shared<std::packaged_task<void()>>([this]() { Rasterize(m_pendingViewProjection); });
+    m_pending = task->get_future();
+    m_hasPending = true;
+    m_pool->Submit([task]() { (*task)(); });
+}
+
+void OcclusionCuller::EndFrame(const float viewProjection[16])
+{
+    if (m_hasPending)
+    {
+        m_hasPending = false;
+        m_pending.get();
+    }
+
+    // The camera moved after the kick; testing against the stale buffer would not be conservative.
+    if (memcmp(viewProjection, m_viewProjection, sizeof(m_viewProjection)) != 0)
+    {
+        float copy[16];
+        memcpy(copy, viewProjection, sizeof(copy));
+        Rasterize(copy);
+    }
+}
+
+void OcclusionCuller::Rasterize(const float viewProjection[16])
+{
+    SetupTriangles(viewProjection);
+
+    // Bin triangles to the tiles their bounding box touches.
+    for (std::vector<uint32_t>& bin : m_tileBins)
+    {
+        bin.clear();
+    }
+    for (uint32_t t = 0; t < m_triangles.size(); ++t)
+    {
+        const Triangle& tri = m_triangles[t];
+        for (int32_t ty = tri.MinY / static_cast<int32_t>(TileHeight); ty <= tri.MaxY / static_cast<int32_t>(TileHeight); ++ty)
+        {
+            for (int32_t tx = tri.MinX / static_cast<int32_t>(TileWidth); tx <= tri.MaxX / static_cast<int32_t>(TileWidth); ++tx)
+            {
+                m_tileBins[ty * m_tilesX + tx].push_back(t);
+            }
+        }
+    }
+
+    const uint32_t tileCount = m_tilesX * m_tilesY;
+    if (m_pool)
+    {
+        m_pool->ParallelFor(tileCount, 1, [this](size_t begin, size_t end)
+        {
+            for (size_t tile = begin; tile < end; ++tile)
+            {
+                RasterizeTile(static_cast<uint32_t>(tile));
+            }
+        });
+    }
+    else
+    {
+        for (uint32_t tile = 0; tile < tileCount; ++tile)
+        {
+            RasterizeTile(tile);
+        }
+    }
+
+    BuildHiZ();
+    memmove(m_viewProjection, viewProjection, sizeof(m_viewProjection));
+}
+
+void OcclusionCuller::SetupTriangles(const float viewProjection[16])
+{
+    m_triangles.clear();
+
+    for (const OccluderMesh& occluder : m_occluders)
+    {
+        float worldViewProjection[16];
+        MultiplyMatrix(occluder.World, viewProjection, worldViewProjection);
+
+        // Runs on a worker every frame: the clip space positions go in that thread's scratch.
+        ScratchScope scratch;
+        const uint8_t* positions = static_cast<const uint8_t*>(occluder.Positions);
+        float* clip = scratch.Allocate<float>(occluder.VertexCount * 4);
+        for (uint32_t v = 0; v < occluder.VertexCount; ++v)
+        {
+            float p[3];
+            memcpy(p, positions + v * occluder.PositionStride, sizeof(p));
+            TransformPoint(p, worldViewProjection, &clip[v * 4]);
+        }
+
+        for (uint32_t i = 0; i + 2 < occluder.IndexCount; i += 3)
+        {
+            float x[3], y[3], z[3];
+            bool clipped = false;
+            for (int k = 0; k < 3; ++k)
+            {
+                const float* c = &clip[occluder.Indices[i + k] * 4];
+                // Triangles crossing the near plane are dropped. Losing an occluder only makes the
+                // culling less effective, never wrong.
+                if (c[3] <= 1e-5f || c[2] < 0.0f)
+                {
+                    clipped = true;
+                    break;
+                }
+
+                const float invW = 1.0f / c[3];
+                x[k] = (c[0] * invW * 0.5f + 0.5f) * m_width;
+                y[k] = (0.5f - c[1] * invW * 0.5f) * m_height;
+                z[k] = c[2] * invW;
+            }
+            if (clipped)
+            {
+                continue;
+            }
+
+            float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+            if (std::fabs(area) < 1e-8f)
+            {
+                continue;
+            }
+
+            // Both windings are rasterized; flip so the edge functions are positive inside.
+            if (area < 0.0f)
+            {
+                std::swap(x[1], x[2]);
+                std::swap(y[1], y[2]);
+                std::swap(z[1], z[2]);
+                area = -area;
+            }
+
+            Triangle tri;
+            tri.MinX = std::max(0, static_cast<int32_t>(std::floor(std::min(std::min(x[0], x[1]), x[2]))));
+            tri.MinY = std::max(0, static_cast<int32_t>(std::floor(std::min(std::min(y[0], y[1]), y[2]))));
+            tri.MaxX = std::min(static_cast<int32_t>(m_width) - 1, static_cast<int32_t>(std::ceil(std::max(std::max(x[0], x[1]), x[2]))));
+            tri.MaxY = std::min(static_cast<int32_t>(m_height) - 1, static_cast<int32_t>(std::ceil(std::max(std::max(y[0], y[1]), y[2]))));
+            if (tri.MinX > tri.MaxX || tri.MinY > tri.MaxY)
+            {
+                continue;
+            }
+
+            for (int e = 0; e < 3; ++e)
+            {
+                const int j = (e + 1) % 3;
+                tri.EdgeA[e] = -(y[j] - y[e]);
+                tri.EdgeB[e] = x[j] - x[e];
+                tri.EdgeC[e] = (y[j] - y[e]) * x[e] - (x[j] - x[e]) * y[e];
+            }
+
+            const float dx1 = x[1] - x[0], dy1 = y[1] - y[0], dz1 = z[1] - z[0];
+            const float dx2 = x[2] - x[0], dy2 = y[2] - y[0], dz2 = z[2] - z[0];
+            tri.DepthA = (dz1 * dy2 - dy1 * dz2) / area;
+            tri.DepthB = (dx1 * dz2 - dz1 * dx2) / area;
+            tri.DepthC = z[0] - tri.DepthA * x[0] - tri.DepthB * y[0];
+
+            m_triangles.push_back(tri);
+        }
+    }
+}
+
+void OcclusionCuller::RasterizeTile(uint32_t tile)
+{
+    const int32_t tileX = static_cast<int32_t>((tile % m_tilesX) * TileWidth);
+    const int32_t tileY = static_cast<int32_t>((tile / m_tilesX) * TileHeight);
+
+    for (int32_t y = tileY; y < tileY + static_cast<int32_t>(TileHeight); ++y)
+    {
+        std::fill_n(&m_depth[y * m_width + tileX], TileWidth, 1.0f);
+    }
+
+    const Lanes offsets = LaneOffsets();
+    const Lanes zero = LaneSet(0.0f);
+
+    for (uint32_t t : m_tileBins[tile])
+    {
+        const Triangle& tri = m_triangles[t];
+
+        const int32_t minY = std::max(tri.MinY, tileY);
+        const int32_t maxY = std::min(tri.MaxY, tileY + static_cast<int32_t>(TileHeight) - 1);
+        const int32_t maxX = std::min(tri.MaxX, tileX + static_cast<int32_t>(TileWidth) - 1);
+        // Start on a lane boundary; tiles are a multiple of the lane count wide.
+        const int32_t minX = std::max(tri.MinX, tileX) / static_cast<int32_t>(LaneCount) * static_cast<int32_t>(LaneCount);
+
+        const Lanes stepE0 = LaneSet(tri.EdgeA[0] * LaneCount);
+        const Lanes stepE1 = LaneSet(tri.EdgeA[1] * LaneCount);
+        const Lanes stepE2 = LaneSet(tri.EdgeA[2] * LaneCount);
+        const Lanes stepZ = LaneSet(tri.DepthA * LaneCount);
+
+        // Pixel centers are sampled.
+        const Lanes px = LaneAdd(LaneSet(minX + 0.5f), offsets);
+
+        for (int32_t y = minY; y <= maxY; ++y)
+        {
+            const float py = y + 0.5f;
+            Lanes e0 = LaneAdd(LaneMul(LaneSet(tri.EdgeA[0]), px), LaneSet(tri.EdgeB[0] * py + tri.EdgeC[0]));
+            Lanes e1 = LaneAdd(LaneMul(LaneSet(tri.EdgeA[1]), px), LaneSet(tri.EdgeB[1] * py + tri.EdgeC[1]));
+            Lanes e2 = LaneAdd(LaneMul(LaneSet(tri.EdgeA[2]), px), LaneSet(tri.EdgeB[2] * py + tri.EdgeC[2]));
+            Lanes z = LaneAdd(LaneMul(LaneSet(tri.DepthA), px), LaneSet(tri.DepthB * py + tri.DepthC));
+
+            float* row = &m_depth[y * m_width];
+            for (int32_t x = minX; x <= maxX; x += LaneCount)
+            {
+                const Lanes inside = LaneAnd(LaneAnd(LaneGreaterEqual(e0, zero), LaneGreaterEqual(e1, zero)), LaneGreaterEqual(e2, zero));
+                if (LaneAny(inside))
+                {
+                    const Lanes depth = LaneLoad(row + x);
+                    LaneStore(row + x, LaneSelect(depth, LaneMin(depth, z), inside));
+                }
+
+                e0 = LaneAdd(e0, stepE0);
+                e1 = LaneAdd(e1, stepE1);
+                e2 = LaneAdd(e2, stepE2);
+                z = LaneAdd(z, stepZ);
+            }
+        }
+    }
+}
+
+void OcclusionCuller::BuildHiZ()
+{
+    const float* source = m_depth.data();
+    uint32_t sourceWidth = m_width;
+    uint32_t sourceHeight = m_height;
+
+    for (size_t level = 0; level < m_hiZ.size(); ++level)
+    {
+        float* dest = m_hiZ[level].data();
+        const uint32_t width = m_hiZWidth[level];
+        const uint32_t height = m_hiZHeight[level];
+
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            const uint32_t y0 = y * 2;
+            const uint32_t y1 = std::min(y0 + 1, sourceHeight - 1);
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const uint32_t x0 = x * 2;
+                const uint32_t x1 = std::min(x0 + 1, sourceWidth - 1);
+                dest[y * width + x] = std::max(
+                    std::max(source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1]),
+                    std::max(source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]));
+            }
+        }
+
+        source = dest;
+        sourceWidth = width;
+        sourceHeight = height;
+    }
+}
+
+bool OcclusionCuller::IsVisible(const float center[3], const float extents[3]) const
+{
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    float minZ = INFINITY;
+
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        const float p[3] =
+        {
+            center[0] + ((corner & 1) ? extents[0] : -extents[0]),
+            center[1] + ((corner & 2) ? extents[1] : -extents[1]),
+            center[2] + ((corner & 4) ? extents[2] : -extents[2]),
+        };
+
+        float c[4];
+        TransformPoint(p, m_viewProjection, c);
+
+        // Boxes reaching the near plane are never occluded.
+        if (c[3] <= 1e-5f || c[2] < 0.0f)
+        {
+            return true;
+        }
+
+        const float invW = 1.0f / c[3];
+        const float sx = (c[0] * invW * 0.5f + 0.5f) * m_width;
+        const float sy = (0.5f - c[1] * invW * 0.5f) * m_height;
+        minX = std::min(minX, sx);
+        maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy);
+        maxY = std::max(maxY, sy);
+        minZ = std::min(minZ, c[2] * invW);
+    }
+
+    // Off screen is the frustum culler's call.
+    if (maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height)
+    {
+        return true;
+    }
+
+    const uint32_t x0 = static_cast<uint32_t>(std::max(minX, 0.0f));
+    const uint32_t y0 = static_cast<uint32_t>(std::max(minY, 0.0f));
+    const uint32_t x1 = static_cast<uint32_t>(std::min(maxX, m_width - 1.0f));
+    const uint32_t y1 = static_cast<uint32_t>(std::min(maxY, m_height - 1.0f));
+
+    // Coarsest level where the rectangle still spans only a few texels.
+    uint32_t level = 0;
+    while (level < m_hiZ.size() &&
+        ((x1 >> level) - (x0 >> level) >= MaxTestTexels || (y1 >> level) - (y0 >> level) >= MaxTestTexels))
+    {
+        ++level;
+    }
+
+    const float* texels = level == 0 ? m_depth.data() : m_hiZ[level - 1].data();
+    const uint32_t width = level == 0 ? m_width : m_hiZWidth[level - 1];
+
+    float maxDepth = 0.0f;
+    for (uint32_t y = y0 >> level; y <= (y1 >> level); ++y)
+    {
+        for (uint32_t x = x0 >> level; x <= (x1 >> level); ++x)
+        {
+            maxDepth = std::max(maxDepth, texels[y * width + x]);
+        }
+    }
+
+    return minZ <= maxDepth;
+}
+
+void OcclusionCuller::FilterVisible(std::vector<uint32_t>& objects, const float* centers, const float* extents, size_t boundsStride) const
+{
+    const uint8_t* centerBytes = reinterpret_cast<const uint8_t*>(centers);
+    const uint8_t* extentBytes = reinterpret_cast<const uint8_t*>(extents);
+
+    ScratchScope scratch;
+    uint8_t* visible = scratch.Allocate<uint8_t>(objects.size());
+    auto testRange = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const float* c = reinterpret_cast<const float*>(centerBytes + objects[i] * boundsStride);
+            const float* e = reinterpret_cast<const float*>(extentBytes + objects[i] * boundsStride);
+            visible[i] = IsVisible(c, e) ? 1 : 0;
+        }
+    };
+
+    if (m_pool)
+    {
+        m_pool->ParallelFor(objects.size(), 1024, testRange);
+    }
+    else
+    {
+        testRange(0, objects.size());
+    }
+
+    size_t write = 0;
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (visible[i])
+        {
+            objects[write++] = objects[i];
+        }
+    }
+    objects.resize(write);
+}
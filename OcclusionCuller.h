@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <vector>
+
+class ThreadPool;
+
+// Geometry rasterized into the occlusion depth buffer. Occluders should be simple, closed,
+// conservative (never larger than the real object) meshes: walls, terrain, big props.
+struct OccluderMesh
+{
+    const void* Positions;      // float3, PositionStride bytes apart.
+    size_t PositionStride;
+    uint32_t VertexCount;
+    const uint32_t* Indices;
+    uint32_t IndexCount;
+    float World[16];            // Row-major, row vector convention (DirectXMath).
+};
+
+// Software occlusion culling.
+// Occluders are rasterized on the CPU into a small depth buffer, split into tiles that are
+// rasterized independently on the thread pool (each tile only walks the triangles binned to it).
+// The inner loop shades 8 (AVX2) or 4 (SSE) pixels of a row at once. A max-depth pyramid (Hi-Z)
+// is then built so an object's screen rectangle can be tested against a handful of texels.
+//
+// BeginFrame kicks the rasterization asynchronously, so the app can start it a frame ahead
+// (as soon as the next camera is known) and overlap it with other CPU work. The results are
+// only used if the camera passed to EndFrame matches; otherwise the buffer is redrawn.
+class OcclusionCuller
+{
+public:
+    static const uint32_t TileWidth = 32;
+    static const uint32_t TileHeight = 16;
+
+    // width must be a multiple of TileWidth and height a multiple of TileHeight.
+    OcclusionCuller(uint32_t width = 320, uint32_t height = 192, ThreadPool* pool = nullptr);
+    ~OcclusionCuller();
+
+    // Not between BeginFrame and EndFrame: the rasterization in flight reads the occluders.
+    // The positions and indices are not copied and must outlive their use.
+    void ClearOccluders();
+    void AddOccluder(const OccluderMesh& occluder);
+
+    // Starts rasterizing the occluders for viewProjection on the pool.
+    void BeginFrame(const float viewProjection[16]);
+
+    // Waits for the depth buffer of viewProjection to be ready.
+    void EndFrame(const float viewProjection[16]);
+
+    // Rasterizes on the calling thread (and the pool) and builds the Hi-Z.
+    void Rasterize(const float viewProjection[16]);
+
+    // World space box test against the finished depth buffer. Returns false only when the box
+    // is certainly hidden behind the occluders.
+    bool IsVisible(const float center[3], const float extents[3]) const;
+
+    // Filters objects in place, keeping the visible ones. centers and extents are float3
+    // arrays indexed by object id.
+    void FilterVisible(std::vector<uint32_t>& objects, const float* centers, const float* extents, size_t boundsStride) const;
+
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+
+    // Depth of the nearest occluder per pixel, 1.0 where nothing was drawn.
+    const float* GetDepthBuffer() const { return m_depth.data(); }
+
+private:
+    struct Triangle
+    {
+        // Edge functions A * x + B * y + C, positive inside.
+        float EdgeA[3], EdgeB[3], EdgeC[3];
+        // Depth plane z = DepthA * x + DepthB * y + DepthC.
+        float DepthA, DepthB, DepthC;
+        int32_t MinX, MinY, MaxX, MaxY;
+    };
+
+    void SetupTriangles(const float viewProjection[16]);
+    void RasterizeTile(uint32_t tile);
+    void BuildHiZ();
+
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_tilesX;
+    uint32_t m_tilesY;
+    ThreadPool* m_pool;
+
+    std::vector<OccluderMesh> m_occluders;
+    std::vector<Triangle> m_triangles;
+    std::vector<std::vector<uint32_t>> m_tileBins;
+    std::vector<float> m_depth;
+
+    // Max depth pyramid; level 0 is the full resolution depth buffer's 2x2 reduction.
+    std::vector<std::vector<float>> m_hiZ;
+    std::vector<uint32_t> m_hiZWidth;
+    std::vector<uint32_t> m_hiZHeight;
+
+    float m_viewProjection[16];
+    float m_pendingViewProjection[16];
+    std::future<void> m_pending;
+    bool m_hasPending;
+};
@@ -0,0 +1,241 @@
+#include "PipelineCompiler.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+PipelineCompiler::PipelineCompiler(ThreadPool& pool, ReleaseFunction release, uint32_t maxConcurrent) :
+    m_pool(pool),
+    m_release(release),
+    m_maxConcurrent(maxConcurrent),
+    m_sequence(0),
+    m_pendingCount(0),
+    m_running(0),
+    m_stopping(false)
+{
+    if (m_maxConcurrent == 0)
+    {
+        const uint32_t workers = pool.GetConcurrency() - 1;
+        m_maxConcurrent = std::max<uint32_t>(workers / 2, 1);
+    }
+}
+
+PipelineCompiler::~PipelineCompiler()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        // Loops still waiting in the pool's queue get to run and return at once.
+        m_finished.wait(lock, [this] { return m_running == 0; });
+    }
+
+    for (Entry& entry : m_entries)
+    {
+        if (entry.Status == PipelineStatus::Ready)
+        {
+            m_release(entry.Pipeline);
+        }
+    }
+}
+
+PipelineCompiler::Entry& PipelineCompiler::GetEntry(PipelineHandle handle)
+{
+    if (handle == InvalidPipeline || handle > m_entries.size())
+    {
+        throw std::out_of_range("Unknown pipeline handle.");
+    }
+    return m_entries[handle - 1];
+}
+
+const PipelineCompiler::Entry& PipelineCompiler::GetEntry(PipelineHandle handle) const
+{
+    if (handle == InvalidPipeline || handle > m_entries.size())
+    {
+        throw std::out_of_range("Unknown pipeline handle.");
+    }
+    return m_entries[handle - 1];
+}
+
+void PipelineCompiler::Enqueue(PipelineHandle handle, uint64_t firstUse)
+{
+    GetEntry(handle).FirstUse = firstUse;
+    m_queue.push(QueueItem{ firstUse, m_sequence++, handle });
+}
+
+PipelineHandle PipelineCompiler::Request(uint64_t key, uint64_t firstUse, CompileFunction compile, bool* merged)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_stats.Requests;
+
+    const auto found = m_handles.find(key);
+    if (found != m_handles.end())
+    {
+        ++m_stats.Merged;
+        if (merged)
+        {
+            *merged = true;
+        }
+        Entry& entry = GetEntry(found->second);
+        if (entry.Status == PipelineStatus::Queued && firstUse < entry.FirstUse)
+        {
+            Enqueue(found->second, firstUse);
+        }
+        return found->second;
+    }
+
+    if (merged)
+    {
+        *merged = false;
+    }
+    m_entries.push_back(Entry{ firstUse, std::move(compile), PipelineStatus::Queued, nullptr, nullptr });
+    const PipelineHandle handle = static_cast<PipelineHandle>(m_entries.size());
+    m_handles.emplace(key, handle);
+    ++m_pendingCount;
+    Enqueue(handle, firstUse);
+
+    StartCompilers(lock);
+    return handle;
+}
+
+// Unlocks the lock: with no workers, Submit runs the loop right here.
+void PipelineCompiler::StartCompilers(std::unique_lock<std::mutex>& lock)
+{
+    if (m_stopping || m_running >= m_maxConcurrent)
+    {
+        return;
+    }
+    ++m_running;
+    lock.unlock();
+    m_pool.Submit([this] { RunCompiles(); });
+}
+
+void PipelineCompiler::RunCompiles()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping)
+    {
+        Entry* next = PopNext();
+        if (!next)
+        {
+            break;
+        }
+        CompileEntry(*next, lock);
+    }
+    --m_running;
+    m_finished.notify_all();
+}
+
+PipelineCompiler::Entry* PipelineCompiler::PopNext()
+{
+    while (!m_queue.empty())
+    {
+        const QueueItem item = m_queue.top();
+        m_queue.pop();
+        Entry& entry = GetEntry(item.Handle);
+        if (entry.Status == PipelineStatus::Queued && entry.FirstUse == item.FirstUse)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+// Called locked; the compile itself runs unlocked.
+void PipelineCompiler::CompileEntry(Entry& entry, std::unique_lock<std::mutex>& lock)
+{
+    entry.Status = PipelineStatus::Compiling;
+    CompileFunction compile = std::move(entry.Compile);
+    entry.Compile = nullptr;
+    lock.unlock();
+
+    const auto start = std::chrono::steady_clock::now();
+    void* pipeline = nullptr;
+    std::exception_ptr error;
+    try
+    {
+        pipeline = compile();
+        if (!pipeline)
+        {
+            throw std::runtime_error("Pipeline compile returned no pipeline.");
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    const uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    lock.lock();
+    entry.Pipeline = pipeline;
+    entry.Error = error;
+    entry.Status = error ? PipelineStatus::Failed : PipelineStatus::Ready;
+    --m_pendingCount;
+    ++(error ? m_stats.Failed : m_stats.Compiled);
+    m_stats.CompileNanoseconds += nanoseconds;
+    m_stats.MaxCompileNanoseconds = std::max(m_stats.MaxCompileNanoseconds, nanoseconds);
+    m_finished.notify_all();
+}
+
+void* PipelineCompiler::TryGet(PipelineHandle handle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = GetEntry(handle);
+    if (entry.Status == PipelineStatus::Ready)
+    {
+        return entry.Pipeline;
+    }
+    if (entry.Status == PipelineStatus::Queued && entry.FirstUse != 0)
+    {
+        Enqueue(handle, 0);
+    }
+    ++m_stats.NotReady;
+    return nullptr;
+}
+
+void* PipelineCompiler::Wait(PipelineHandle handle)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Entry& entry = GetEntry(handle);
+    if (entry.Status == PipelineStatus::Queued)
+    {
+        CompileEntry(entry, lock);
+    }
+    m_finished.wait(lock, [&entry] { return entry.Status == PipelineStatus::Ready || entry.Status == PipelineStatus::Failed; });
+
+    if (entry.Status == PipelineStatus::Failed)
+    {
+        std::rethrow_exception(entry.Error);
+    }
+    return entry.Pipeline;
+}
+
+// The calling thread compiles from the queue too, in priority order. Failures are not rethrown
+// here; Wait on the failed pipeline does.
+void PipelineCompiler::WaitAll()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (Entry* next = PopNext())
+    {
+        CompileEntry(*next, lock);
+    }
+    m_finished.wait(lock, [this] { return m_pendingCount == 0; });
+}
+
+PipelineStatus PipelineCompiler::GetStatus(PipelineHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return GetEntry(handle).Status;
+}
+
+size_t PipelineCompiler::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pendingCount;
+}
+
+PipelineCompilerStats PipelineCompiler::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+class ThreadPool;
+
+// Handle of a requested pipeline. 0 is never returned.
+typedef uint32_t PipelineHandle;
+static const PipelineHandle InvalidPipeline = 0;
+
+enum class PipelineStatus : uint8_t
+{
+    Queued,
+    Compiling,
+    Ready,
+    Failed,
+};
+
+struct PipelineCompilerStats
+{
+    uint64_t Requests = 0;
+    uint64_t Merged = 0;                // Requests answered by an earlier request of the same key.
+    uint64_t Compiled = 0;
+    uint64_t Failed = 0;
+    uint64_t NotReady = 0;              // TryGet calls that found the pipeline still compiling.
+    uint64_t CompileNanoseconds = 0;    // Summed over every compile.
+    uint64_t MaxCompileNanoseconds = 0;
+};
+
+// Compiles pipelines on the thread pool, the pipelines needed soonest first, so that loading does
+// not wait for every pipeline and a pipeline first needed mid-game does not stall the frame.
+// A pipeline is identified by a key, the hash of its description: requests for a key already
+// known are merged into the first one. The compile itself is a function supplied by the request,
+// which returns the pipeline object; the API specific part (and a simulated compile for testing
+// the scheduling) lives outside.
+// At most maxConcurrent compiles run at once, leaving the other workers to the per-frame jobs.
+// With no workers in the pool, a request compiles on the calling thread.
+// Thread-safe.
+class PipelineCompiler
+{
+public:
+    typedef std::function<void*()> CompileFunction;
+    typedef void (*ReleaseFunction)(void* pipeline);
+
+    // maxConcurrent 0: half the workers of the pool, at least one. The release function is called
+    // on every compiled pipeline when the compiler is destroyed.
+    PipelineCompiler(ThreadPool& pool, ReleaseFunction release, uint32_t maxConcurrent = 0);
+    // Waits for the compiles running, drops the queued ones and releases every pipeline.
+    ~PipelineCompiler();
+
+    PipelineCompiler(const PipelineCompiler&) = delete;
+    PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+    // firstUse orders the queue: when the pipeline is expected to be needed, in any unit shared by
+    // all the requests (a frame number, a loading stage). A request for a known key returns its
+    // handle, only moving its first use earlier, and sets *merged.
+    PipelineHandle Request(uint64_t key, uint64_t firstUse, CompileFunction compile, bool* merged = nullptr);
+
+    // The pipeline, or nullptr while it is not ready (or failed). Asking for a queued pipeline
+    // means it is needed now: it moves to the front of the queue.
+    void* TryGet(PipelineHandle handle);
+    // Blocks until the pipeline is ready; a queued one is compiled on the calling thread.
+    // Rethrows the exception of a failed compile.
+    void* Wait(PipelineHandle handle);
+    void WaitAll();
+
+    PipelineStatus GetStatus(PipelineHandle handle) const;
+    // Queued and compiling pipelines.
+    size_t GetPendingCount() const;
+    PipelineCompilerStats GetStats() const;
+
+private:
+    struct Entry
+    {
+        uint64_t FirstUse;
+        CompileFunction Compile;
+        PipelineStatus Status;
+        void* Pipeline;
+        std::exception_ptr Error;
+    };
+
+    // Queue items are not updated in place: moving a pipeline earlier pushes a new item, and items
+    // that no longer match their entry are skipped.
+    struct QueueItem
+    {
+        uint64_t FirstUse;
+        uint64_t Sequence;
+        PipelineHandle Handle;
+    };
+
+    struct Later
+    {
+        bool operator()(const QueueItem& a, const QueueItem& b) const
+        {
+            return a.FirstUse != b.FirstUse ? a.FirstUse > b.FirstUse : a.Sequence > b.Sequence;
+        }
+    };
+
+    Entry& GetEntry(PipelineHandle handle);
+    const Entry& GetEntry(PipelineHandle handle) const;
+    void Enqueue(PipelineHandle handle, uint64_t firstUse);
+    void StartCompilers(std::unique_lock<std::mutex>& lock);
+    void RunCompiles();
+    Entry* PopNext();
+    void CompileEntry(Entry& entry, std::unique_lock<std::mutex>& lock);
+
+    ThreadPool& m_pool;
+    ReleaseFunction m_release;
+    uint32_t m_maxConcurrent;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_finished;
+    std::deque<Entry> m_entries;                        // By handle - 1.
+    std::unordered_map<uint64_t, PipelineHandle> m_handles;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, Later> m_queue;
+    uint64_t m_sequence;
+    size_t m_pendingCount;
+    uint32_t m_running;                                 // Compile loops submitted to the pool.
+    bool m_stopping;
+    PipelineCompilerStats m_stats;
+};
@@ -0,0 +1,951 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Root signatures, input layouts and fixed function pipeline state, described at compile time.
+//
+// The descriptions are constexpr values: a layout that D3D12 would reject (registers bound twice,
+// a root signature over 64 DWORDs, overlapping vertex elements...) is a compile error, thrown by
+// the Make functions while the compiler evaluates them, and each description carries a stable
+// hash computed at compile time. SerializeRootSignature produces the blob
+// D3D12SerializeVersionedRootSignature would (version 1.1, in a DXBC container with its
+// checksum), also at compile time, so that creating the root signature at run time is a single
+// CreateRootSignature call on bytes in the executable's read-only data.
+//
+// The enumerations and flags have the values of their D3D12 and DXGI counterparts, so that
+// converting is a cast; D3D12PipelineLayout.cpp checks them against d3d12.h. This header itself
+// only needs the standard library.
+//
+// Usage:
+//     constexpr auto Layout = MakeRootSignature(RootSignatureAllowInputLayout,
+//         std::array<RootParameterLayout, 1>{ { DescriptorTable(ShaderVisibility::Pixel, SrvRange(1, 0)) } },
+//         std::array<StaticSamplerLayout, 0>{});
+//     constexpr auto Blob = SerializeRootSignature(Layout);
+
+// D3D12_SHADER_VISIBILITY.
+enum class ShaderVisibility : uint32_t
+{
+    All = 0,
+    Vertex = 1,
+    Hull = 2,
+    Domain = 3,
+    Geometry = 4,
+    Pixel = 5,
+};
+
+// D3D12_DESCRIPTOR_RANGE_TYPE.
+enum class DescriptorRangeType : uint32_t
+{
+    Srv = 0,
+    Uav = 1,
+    Cbv = 2,
+    Sampler = 3,
+};
+
+// D3D12_ROOT_PARAMETER_TYPE.
+enum class RootParameterType : uint32_t
+{
+    DescriptorTable = 0,
+    Constants = 1,
+    Cbv = 2,
+    Srv = 3,
+    Uav = 4,
+};
+
+// D3D12_FILTER, the ones the layouts use.
+enum class SamplerFilter : uint32_t
+{
+    Point = 0x00,
+    Linear = 0x15,
+    Anisotropic = 0x55,
+};
+
+// D3D12_TEXTURE_ADDRESS_MODE.
+enum class AddressMode : uint32_t
+{
+    Wrap = 1,
+    Mirror = 2,
+    Clamp = 3,
+    Border = 4,
+};
+
+// D3D12_STATIC_BORDER_COLOR.
+enum class BorderColor : uint32_t
+{
+    TransparentBlack = 0,
+    OpaqueBlack = 1,
+    OpaqueWhite = 2,
+};
+
+// DXGI_FORMAT, the vertex and render target formats the layouts use.
+enum class LayoutFormat : uint32_t
+{
+    R32G32B32A32Float = 2,
+    R32G32B32Float = 6,
+    R32G32Float = 16,
+    R8G8B8A8Unorm = 28,
+    R16G16Unorm = 35,
+    R32Float = 41,
+};
+
+// D3D12_CULL_MODE.
+enum class CullMode : uint32_t
+{
+    None = 1,
+    Front = 2,
+    Back = 3,
+};
+
+enum class BlendMode : uint8_t
+{
+    Opaque,
+    AlphaBlend,         // Source alpha over, the destination's alpha kept for the rest.
+};
+
+// D3D12_DESCRIPTOR_RANGE_FLAGS.
+static const uint32_t RangeDescriptorsVolatile = 0x1;
+static const uint32_t RangeDataVolatile = 0x2;
+static const uint32_t RangeDataStaticWhileSetAtExecute = 0x4;
+static const uint32_t RangeDataStatic = 0x8;
+// D3D12_ROOT_DESCRIPTOR_FLAGS.
+static const uint32_t RootDataVolatile = 0x2;
+static const uint32_t RootDataStaticWhileSetAtExecute = 0x4;
+static const uint32_t RootDataStatic = 0x8;
+// D3D12_ROOT_SIGNATURE_FLAGS.
+static const uint32_t RootSignatureAllowInputLayout = 0x1;
+static const uint32_t RootSignatureValidFlags = 0xfff;
+// D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND.
+static const uint32_t DescriptorRangeAppend = 0xffffffff;
+
+static const size_t MaxTableRanges = 4;
+static const uint32_t MaxRootSignatureDwords = 64;
+
+struct DescriptorRangeLayout
+{
+    DescriptorRangeType Type;
+    uint32_t Count;
+    uint32_t BaseRegister;
+    uint32_t Space;
+    uint32_t Flags;
+    uint32_t TableOffset;           // Descriptors from the start of the table, or DescriptorRangeAppend.
+};
+
+struct RootParameterLayout
+{
+    RootParameterType Type;
+    ShaderVisibility Visibility;
+    uint32_t Register;              // Root descriptors and constants.
+    uint32_t Space;
+    uint32_t Flags;                 // Root descriptors.
+    uint32_t Values;                // Constants: 32-bit values.
+    uint32_t RangeCount;            // Descriptor tables.
+    DescriptorRangeLayout Ranges[MaxTableRanges];
+};
+
+struct StaticSamplerLayout
+{
+    SamplerFilter Filter;
+    AddressMode Address;            // U, V and W.
+    float MipLodBias;
+    uint32_t MaxAnisotropy;
+    uint32_t ComparisonFunc;        // D3D12_COMPARISON_FUNC; 1 is NEVER.
+    BorderColor Border;
+    float MinLod;
+    float MaxLod;
+    uint32_t Register;
+    uint32_t Space;
+    ShaderVisibility Visibility;
+};
+
+template <size_t ParameterCount, size_t SamplerCount>
+struct RootSignatureLayout
+{
+    std::array<RootParameterLayout, ParameterCount> Parameters;
+    std::array<StaticSamplerLayout, SamplerCount> Samplers;
+    uint32_t Flags;
+    uint64_t Hash;
+};
+
+struct InputElementLayout
+{
+    const char* Semantic;
+    uint32_t SemanticIndex;
+    LayoutFormat Format;
+    uint32_t Slot;
+    uint32_t Offset;
+};
+
+template <size_t ElementCount>
+struct InputLayout
+{
+    std::array<InputElementLayout, ElementCount> Elements;
+    uint32_t Stride;                // Of slot 0, the only one checked against the elements.
+    uint64_t Hash;
+};
+
+// Everything of a graphics pipeline but its shaders, root signature and input layout. One opaque
+// or alpha blended render target, no depth, triangles, no multisampling.
+struct PipelineStateLayout
+{
+    CullMode Cull;
+    BlendMode Blend;
+    LayoutFormat RenderTargetFormat;
+};
+
+// The bytes of a serialized root signature, at most Capacity of them.
+template <size_t ParameterCount, size_t SamplerCount>
+struct SerializedRootSignature
+{
+    static const size_t Capacity = 32 + 4 + 8 + 24 + ParameterCount * (12 + 8 + MaxTableRanges * 24) + SamplerCount * 52;
+
+    std::array<uint8_t, Capacity> Bytes;
+    size_t Size;
+    uint64_t Hash;                  // Of the layout.
+};
+
+// FNV-1a over 32-bit values, for hashes computed at compile time. The values are hashed, not the
+// structures' bytes, so the hashes are the same with any compiler.
+class LayoutHasher
+{
+public:
+    constexpr LayoutHasher() : m_hash(0xcbf29ce484222325ull) {}
+
+    constexpr void Add(uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            m_hash = (m_hash ^ ((value >> (i * 8)) & 0xff)) * 0x100000001b3ull;
+        }
+    }
+
+    constexpr void AddString(const char* text)
+    {
+        for (; *text; ++text)
+        {
+            m_hash = (m_hash ^ static_cast<uint8_t>(*text)) * 0x100000001b3ull;
+        }
+        m_hash = m_hash * 0x100000001b3ull;
+    }
+
+    constexpr uint64_t Get() const { return m_hash; }
+
+private:
+    uint64_t m_hash;
+};
+
+// The bits of a finite float, at compile time (no bit_cast in C++17). Subnormals are rejected.
+constexpr uint32_t FloatBitsOf(float value)
+{
+    if (value == 0.0f)
+    {
+        return 0;
+    }
+    if (!(value >= -3.402823466e+38f && value <= 3.402823466e+38f))
+    {
+        throw std::invalid_argument("PipelineLayout: floats must be finite.");
+    }
+
+    uint32_t sign = 0;
+    if (value < 0.0f)
+    {
+        sign = 0x80000000u;
+        value = -value;
+    }
+    int exponent = 0;
+    while (value >= 2.0f)
+    {
+        value *= 0.5f;
+        ++exponent;
+    }
+    while (value < 1.0f)
+    {
+        value *= 2.0f;
+        --exponent;
+    }
+    if (exponent < -126)
+    {
+        throw std::invalid_argument("PipelineLayout: subnormal floats are not supported.");
+    }
+    return sign | static_cast<uint32_t>(exponent + 127) << 23 | static_cast<uint32_t>((value - 1.0f) * 8388608.0f);
+}
+
+// Builders.
+
+constexpr DescriptorRangeLayout DescriptorRange(DescriptorRangeType type, uint32_t count, uint32_t baseRegister, uint32_t space = 0,
+    uint32_t flags = 0, uint32_t tableOffset = DescriptorRangeAppend)
+{
+    DescriptorRangeLayout range = {};
+    range.Type = type;
+    range.Count = count;
+    range.BaseRegister = baseRegister;
+    range.Space = space;
+    range.Flags = flags;
+    range.TableOffset = tableOffset;
+    return range;
+}
+
+constexpr DescriptorRangeLayout SrvRange(uint32_t count, uint32_t baseRegister, uint32_t space = 0, uint32_t flags = 0)
+{
+    return DescriptorRange(DescriptorRangeType::Srv, count, baseRegister, space, flags);
+}
+
+template <typename... RangeLayouts>
+constexpr RootParameterLayout DescriptorTable(ShaderVisibility visibility, RangeLayouts... ranges)
+{
+    static_assert(sizeof...(RangeLayouts) >= 1 && sizeof...(RangeLayouts) <= MaxTableRanges, "DescriptorTable: 1 to MaxTableRanges ranges.");
+    const DescriptorRangeLayout list[] = { ranges... };
+    RootParameterLayout parameter = {};
+    parameter.Type = RootParameterType::DescriptorTable;
+    parameter.Visibility = visibility;
+    parameter.RangeCount = static_cast<uint32_t>(sizeof...(RangeLayouts));
+    for (size_t i = 0; i < sizeof...(RangeLayouts); ++i)
+    {
+        parameter.Ranges[i] = list[i];
+    }
+    return parameter;
+}
+
+constexpr RootParameterLayout RootConstants(uint32_t values, uint32_t shaderRegister, uint32_t space, ShaderVisibility visibility)
+{
+    RootParameterLayout parameter = {};
+    parameter.Type = RootParameterType::Constants;
+    parameter.Visibility = visibility;
+    parameter.Register = shaderRegister;
+    parameter.Space = space;
+    parameter.Values = values;
+    return parameter;
+}
+
+constexpr RootParameterLayout RootDescriptor(RootParameterType type, uint32_t shaderRegister, uint32_t space, uint32_t flags, ShaderVisibility visibility)
+{
+    RootParameterLayout parameter = {};
+    parameter.Type = type;
+    parameter.Visibility = visibility;
+    parameter.Register = shaderRegister;
+    parameter.Space = space;
+    parameter.Flags = flags;
+    return parameter;
+}
+
+constexpr StaticSamplerLayout StaticSampler(uint32_t shaderRegister, SamplerFilter filter, AddressMode address, uint32_t maxAnisotropy,
+    ShaderVisibility visibility, BorderColor border = BorderColor::TransparentBlack)
+{
+    StaticSamplerLayout sampler = {};
+    sampler.Filter = filter;
+    sampler.Address = address;
+    sampler.MipLodBias = 0.0f;
+    sampler.MaxAnisotropy = maxAnisotropy;
+    sampler.ComparisonFunc = 1;
+    sampler.Border = border;
+    sampler.MinLod = 0.0f;
+    sampler.MaxLod = 3.402823466e+38f;
+    sampler.Register = shaderRegister;
+    sampler.Space = 0;
+    sampler.Visibility = visibility;
+    return sampler;
+}
+
+// The size in DWORDs a root signature takes: 1 per table, 2 per root descriptor, 1 per constant.
+constexpr uint32_t GetRootSignatureDwords(const RootParameterLayout* parameters, size_t count)
+{
+    uint32_t dwords = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        switch (parameters[i].Type)
+        {
+        case RootParameterType::DescriptorTable:
+            dwords += 1;
+            break;
+        case RootParameterType::Constants:
+            dwords += parameters[i].Values;
+            break;
+        default:
+            dwords += 2;
+            break;
+        }
+    }
+    return dwords;
+}
+
+// A register range a root signature binds, to find the ones bound twice.
+struct LayoutBinding
+{
+    DescriptorRangeType Class;      // Constants are CBVs, static samplers samplers.
+    uint32_t Space;
+    uint32_t First;
+    uint32_t Last;
+    ShaderVisibility Visibility;
+};
+
+// The index-th binding of a root signature: the parameters' (a table's ranges in order), then
+// the static samplers'. Returns false past the last one.
+constexpr bool GetLayoutBinding(const RootParameterLayout* parameters, size_t parameterCount, const StaticSamplerLayout* samplers,
+    size_t samplerCount, size_t index, LayoutBinding& binding)
+{
+    for (size_t i = 0; i < parameterCount; ++i)
+    {
+        const RootParameterLayout& parameter = parameters[i];
+        binding.Visibility = parameter.Visibility;
+        binding.Space = parameter.Space;
+        binding.First = parameter.Register;
+        binding.Last = parameter.Register;
+        switch (parameter.Type)
+        {
+        case RootParameterType::DescriptorTable:
+            if (index < parameter.RangeCount)
+            {
+                const DescriptorRangeLayout& range = parameter.Ranges[index];
+                binding.Class = range.Type;
+                binding.Space = range.Space;
+                binding.First = range.BaseRegister;
+                binding.Last = range.Count == 0xffffffff ? 0xffffffff : range.BaseRegister + (range.Count - 1);
+                return true;
+            }
+            index -= parameter.RangeCount;
+            continue;
+        case RootParameterType::Constants:
+        case RootParameterType::Cbv:
+            binding.Class = DescriptorRangeType::Cbv;
+            break;
+        case RootParameterType::Srv:
+            binding.Class = DescriptorRangeType::Srv;
+            break;
+        case RootParameterType::Uav:
+            binding.Class = DescriptorRangeType::Uav;
+            break;
+        }
+        if (index == 0)
+        {
+            return true;
+        }
+        --index;
+    }
+    if (index < samplerCount)
+    {
+        binding.Class = DescriptorRangeType::Sampler;
+        binding.Space = samplers[index].Space;
+        binding.First = samplers[index].Register;
+        binding.Last = samplers[index].Register;
+        binding.Visibility = samplers[index].Visibility;
+        return true;
+    }
+    return false;
+}
+
+constexpr bool VisibilitiesOverlap(ShaderVisibility a, ShaderVisibility b)
+{
+    return a == ShaderVisibility::All || b == ShaderVisibility::All || a == b;
+}
+
+// Throws std::invalid_argument for what D3D12 would reject; at compile time, that is a compile
+// error quoting the message.
+constexpr void ValidateRootSignature(const RootParameterLayout* parameters, size_t parameterCount, const StaticSamplerLayout* samplers,
+    size_t samplerCount, uint32_t flags)
+{
+    if ((flags & ~RootSignatureValidFlags) != 0)
+    {
+        throw std::invalid_argument("PipelineLayout: unknown root signature flags.");
+    }
+    if (GetRootSignatureDwords(parameters, parameterCount) > MaxRootSignatureDwords)
+    {
+        throw std::invalid_argument("PipelineLayout: the root signature is over 64 DWORDs.");
+    }
+
+    for (size_t i = 0; i < parameterCount; ++i)
+    {
+        const RootParameterLayout& parameter = parameters[i];
+        if (parameter.Visibility > ShaderVisibility::Pixel)
+        {
+            throw std::invalid_argument("PipelineLayout: unknown shader visibility.");
+        }
+        switch (parameter.Type)
+        {
+        case RootParameterType::DescriptorTable:
+        {
+            if (parameter.RangeCount == 0 || parameter.RangeCount > MaxTableRanges)
+            {
+                throw std::invalid_argument("PipelineLayout: a descriptor table has 1 to MaxTableRanges ranges.");
+            }
+            const bool samplerTable = parameter.Ranges[0].Type == DescriptorRangeType::Sampler;
+            for (uint32_t r = 0; r < parameter.RangeCount; ++r)
+            {
+                const DescriptorRangeLayout& range = parameter.Ranges[r];
+                if (range.Count == 0)
+                {
+                    throw std::invalid_argument("PipelineLayout: a descriptor range is empty.");
+                }
+                if ((range.Type == DescriptorRangeType::Sampler) != samplerTable)
+                {
+                    throw std::invalid_argument("PipelineLayout: samplers can't share a table with other descriptors.");
+                }
+                const uint32_t dataFlags = range.Flags & (RangeDataVolatile | RangeDataStaticWhileSetAtExecute | RangeDataStatic);
+                if ((range.Flags & ~0xfu) != 0 || (dataFlags & (dataFlags - 1)) != 0)
+                {
+                    throw std::invalid_argument("PipelineLayout: conflicting descriptor range flags.");
+                }
+                if (samplerTable && (range.Flags & ~RangeDescriptorsVolatile) != 0)
+                {
+                    throw std::invalid_argument("PipelineLayout: sampler ranges have no data flags.");
+                }
+            }
+            break;
+        }
+        case RootParameterType::Constants:
+            if (parameter.Values == 0)
+            {
+                throw std::invalid_argument("PipelineLayout: root constants need at least one value.");
+            }
+            break;
+        case RootParameterType::Cbv:
+        case RootParameterType::Srv:
+        case RootParameterType::Uav:
+            if ((parameter.Flags & ~(RootDataVolatile | RootDataStaticWhileSetAtExecute | RootDataStatic)) != 0 ||
+                (parameter.Flags & (parameter.Flags - 1)) != 0)
+            {
+                throw std::invalid_argument("PipelineLayout: a root descriptor has at most one data flag.");
+            }
+            break;
+        default:
+            throw std::invalid_argument("PipelineLayout: unknown root parameter type.");
+        }
+    }
+
+    for (size_t i = 0; i < samplerCount; ++i)
+    {
+        if (samplers[i].Visibility > ShaderVisibility::Pixel || samplers[i].MaxAnisotropy > 16)
+        {
+            throw std::invalid_argument("PipelineLayout: invalid static sampler.");
+        }
+    }
+
+    LayoutBinding a = {};
+    for (size_t i = 0; GetLayoutBinding(parameters, parameterCount, samplers, samplerCount, i, a); ++i)
+    {
+        LayoutBinding b = {};
+        for (size_t j = i + 1; GetLayoutBinding(parameters, parameterCount, samplers, samplerCount, j, b); ++j)
+        {
+            if (a.Class == b.Class && a.Space == b.Space && a.First <= b.Last && b.First <= a.Last && VisibilitiesOverlap(a.Visibility, b.Visibility))
+            {
+                throw std::invalid_argument("PipelineLayout: a shader register is bound twice.");
+            }
+        }
+    }
+}
+
+template <size_t ParameterCount, size_t SamplerCount>
+constexpr RootSignatureLayout<ParameterCount, SamplerCount> MakeRootSignature(uint32_t flags,
+    const std::array<RootParameterLayout, ParameterCount>& parameters, const std::array<StaticSamplerLayout, SamplerCount>& samplers)
+{
+    ValidateRootSignature(parameters.data(), ParameterCount, samplers.data(), SamplerCount, flags);
+
+    LayoutHasher hasher;
+    hasher.Add(flags);
+    hasher.Add(static_cast<uint32_t>(ParameterCount));
+    for (const RootParameterLayout& parameter : parameters)
+    {
+        hasher.Add(static_cast<uint32_t>(parameter.Type));
+        hasher.Add(static_cast<uint32_t>(parameter.Visibility));
+        hasher.Add(parameter.Register);
+        hasher.Add(parameter.Space);
+        hasher.Add(parameter.Flags);
+        hasher.Add(parameter.Values);
+        hasher.Add(parameter.RangeCount);
+        for (uint32_t r = 0; r < parameter.RangeCount; ++r)
+        {
+            const DescriptorRangeLayout& range = parameter.Ranges[r];
+            hasher.Add(static_cast<uint32_t>(range.Type));
+            hasher.Add(range.Count);
+            hasher.Add(range.BaseRegister);
+            hasher.Add(range.Space);
+            hasher.Add(range.Flags);
+            hasher.Add(range.TableOffset);
+        }
+    }
+    hasher.Add(static_cast<uint32_t>(SamplerCount));
+    for (const StaticSamplerLayout& sampler : samplers)
+    {
+        hasher.Add(static_cast<uint32_t>(sampler.Filter));
+        hasher.Add(static_cast<uint32_t>(sampler.Address));
+        hasher.Add(FloatBitsOf(sampler.MipLodBias));
+        hasher.Add(sampler.MaxAnisotropy);
+        hasher.Add(sampler.ComparisonFunc);
+        hasher.Add(static_cast<uint32_t>(sampler.Border));
+        hasher.Add(FloatBitsOf(sampler.MinLod));
+        hasher.Add(FloatBitsOf(sampler.MaxLod));
+        hasher.Add(sampler.Register);
+        hasher.Add(sampler.Space);
+        hasher.Add(static_cast<uint32_t>(sampler.Visibility));
+    }
+
+    RootSignatureLayout<ParameterCount, SamplerCount> layout = {};
+    layout.Parameters = parameters;
+    layout.Samplers = samplers;
+    layout.Flags = flags;
+    layout.Hash = hasher.Get();
+    return layout;
+}
+
+// Bytes a vertex element of the format takes.
+constexpr uint32_t GetLayoutFormatSize(LayoutFormat format)
+{
+    switch (format)
+    {
+    case LayoutFormat::R32G32B32A32Float:
+        return 16;
+    case LayoutFormat::R32G32B32Float:
+        return 12;
+    case LayoutFormat::R32G32Float:
+        return 8;
+    case LayoutFormat::R8G8B8A8Unorm:
+    case LayoutFormat::R16G16Unorm:
+    case LayoutFormat::R32Float:
+        return 4;
+    }
+    throw std::invalid_argument("PipelineLayout: unknown format.");
+}
+
+constexpr bool LayoutStringsEqual(const char* a, const char* b)
+{
+    for (; *a && *a == *b; ++a, ++b)
+    {
+    }
+    return *a == *b;
+}
+
+// Elements are 4-byte aligned, within the stride in slot 0, don't overlap, and each semantic and
+// index is used once.
+template <size_t ElementCount>
+constexpr InputLayout<ElementCount> MakeInputLayout(uint32_t stride, const std::array<InputElementLayout, ElementCount>& elements)
+{
+    LayoutHasher hasher;
+    hasher.Add(stride);
+    hasher.Add(static_cast<uint32_t>(ElementCount));
+    for (size_t i = 0; i < ElementCount; ++i)
+    {
+        const InputElementLayout& element = elements[i];
+        const uint32_t size = GetLayoutFormatSize(element.Format);
+        if (element.Semantic == nullptr || *element.Semantic == '\0' ||
+            (element.Semantic[0] == 'S' && element.Semantic[1] == 'V' && element.Semantic[2] == '_'))
+        {
+            throw std::invalid_argument("PipelineLayout: vertex elements need a semantic, not a system value.");
+        }
+        if (element.Offset % 4 != 0)
+        {
+            throw std::invalid_argument("PipelineLayout: vertex elements are 4-byte aligned.");
+        }
+        if (element.Slot == 0 && element.Offset + size > stride)
+        {
+            throw std::invalid_argument("PipelineLayout: a vertex element goes past the stride.");
+        }
+        for (size_t j = 0; j < i; ++j)
+        {
+            const InputElementLayout& other = elements[j];
+            if (LayoutStringsEqual(element.Semantic, other.Semantic) && element.SemanticIndex == other.SemanticIndex)
+            {
+                throw std::invalid_argument("PipelineLayout: a semantic is used twice.");
+            }
+            if (element.Slot == other.Slot && element.Offset < other.Offset + GetLayoutFormatSize(other.Format) && other.Offset < element.Offset + size)
+            {
+                throw std::invalid_argument("PipelineLayout: vertex elements overlap.");
+            }
+        }
+
+        hasher.AddString(element.Semantic);
+        hasher.Add(element.SemanticIndex);
+        hasher.Add(static_cast<uint32_t>(element.Format));
+        hasher.Add(element.Slot);
+        hasher.Add(element.Offset);
+    }
+
+    InputLayout<ElementCount> layout = {};
+    layout.Elements = elements;
+    layout.Stride = stride;
+    layout.Hash = hasher.Get();
+    return layout;
+}
+
+constexpr uint64_t HashPipelineState(const PipelineStateLayout& state)
+{
+    LayoutHasher hasher;
+    hasher.Add(static_cast<uint32_t>(state.Cull));
+    hasher.Add(static_cast<uint32_t>(state.Blend));
+    hasher.Add(static_cast<uint32_t>(state.RenderTargetFormat));
+    return hasher.Get();
+}
+
+// One hash for everything of a pipeline but its shaders: the root signature's, the input
+// layout's and the fixed function state's.
+constexpr uint64_t CombineLayoutHashes(uint64_t rootSignature, uint64_t inputLayout, uint64_t state)
+{
+    LayoutHasher hasher;
+    const uint64_t hashes[] = { rootSignature, inputLayout, state };
+    for (const uint64_t hash : hashes)
+    {
+        hasher.Add(static_cast<uint32_t>(hash));
+        hasher.Add(static_cast<uint32_t>(hash >> 32));
+    }
+    return hasher.Get();
+}
+
+// The checksum of a DXBC container: MD5 rounds over the bytes after the checksum, with the
+// container format's own padding (the bit count first in the last block, not last).
+class ContainerChecksum
+{
+public:
+    static constexpr void Compute(const uint8_t* data, uint32_t size, uint32_t digest[4])
+    {
+        digest[0] = 0x67452301;
+        digest[1] = 0xefcdab89;
+        digest[2] = 0x98badcfe;
+        digest[3] = 0x10325476;
+
+        const uint32_t leftOver = size & 63;
+        const bool twoBlockPadding = leftOver >= 56;
+        const uint32_t fullBlocks = size / 64;
+        uint32_t block[16] = {};
+        for (uint32_t b = 0; b < fullBlocks; ++b)
+        {
+            LoadBlock(data + b * 64, 64, block);
+            Transform(digest, block);
+        }
+
+        // The last bytes, then 0x80 and zeros. When the size fits before them, the last block
+        // starts with the size in bits and ends with the size times two, plus one.
+        uint8_t tail[64] = {};
+        uint32_t at = twoBlockPadding ? 0 : 4;
+        for (uint32_t i = 0; i < leftOver; ++i)
+        {
+            tail[at++] = data[fullBlocks * 64 + i];
+        }
+        tail[at] = 0x80;
+        if (twoBlockPadding)
+        {
+            LoadBlock(tail, 64, block);
+            Transform(digest, block);
+            for (uint8_t& byte : tail)
+            {
+                byte = 0;
+            }
+        }
+        LoadBlock(tail, 64, block);
+        block[0] = size << 3;
+        block[15] = size << 1 | 1;
+        Transform(digest, block);
+    }
+
+    // Standard MD5 of the bytes, to check the rounds against other implementations.
+    static constexpr void ComputeMd5(const uint8_t* data, uint32_t size, uint32_t digest[4])
+    {
+        digest[0] = 0x67452301;
+        digest[1] = 0xefcdab89;
+        digest[2] = 0x98badcfe;
+        digest[3] = 0x10325476;
+
+        uint32_t block[16] = {};
+        const uint32_t fullBlocks = size / 64;
+        for (uint32_t b = 0; b < fullBlocks; ++b)
+        {
+            LoadBlock(data + b * 64, 64, block);
+            Transform(digest, block);
+        }
+        uint8_t tail[128] = {};
+        const uint32_t leftOver = size & 63;
+        for (uint32_t i = 0; i < leftOver; ++i)
+        {
+            tail[i] = data[fullBlocks * 64 + i];
+        }
+        tail[leftOver] = 0x80;
+        const uint32_t tailSize = leftOver < 56 ? 64 : 128;
+        const uint64_t bits = static_cast<uint64_t>(size) << 3;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            tail[tailSize - 8 + i] = static_cast<uint8_t>(bits >> (i * 8));
+        }
+        for (uint32_t offset = 0; offset < tailSize; offset += 64)
+        {
+            LoadBlock(tail + offset, 64, block);
+            Transform(digest, block);
+        }
+    }
+
+private:
+    static constexpr void LoadBlock(const uint8_t* bytes, uint32_t size, uint32_t block[16])
+    {
+        for (uint32_t i = 0; i < size / 4; ++i)
+        {
+            block[i] = static_cast<uint32_t>(bytes[i * 4]) | static_cast<uint32_t>(bytes[i * 4 + 1]) << 8 |
+                static_cast<uint32_t>(bytes[i * 4 + 2]) << 16 | static_cast<uint32_t>(bytes[i * 4 + 3]) << 24;
+        }
+    }
+
+    static constexpr void Transform(uint32_t digest[4], const uint32_t block[16])
+    {
+        constexpr uint32_t Sines[64] =
+        {
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+        };
+        constexpr uint32_t Shifts[16] = { 7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21 };
+
+        uint32_t a = digest[0];
+        uint32_t b = digest[1];
+        uint32_t c = digest[2];
+        uint32_t d = digest[3];
+        for (uint32_t i = 0; i < 64; ++i)
+        {
+            uint32_t f = 0;
+            uint32_t g = 0;
+            switch (i / 16)
+            {
+            case 0:
+                f = (b & c) | (~b & d);
+                g = i;
+                break;
+            case 1:
+                f = (d & b) | (~d & c);
+                g = (5 * i + 1) & 15;
+                break;
+            case 2:
+                f = b ^ c ^ d;
+                g = (3 * i + 5) & 15;
+                break;
+            default:
+                f = c ^ (b | ~d);
+                g = (7 * i) & 15;
+                break;
+            }
+            const uint32_t sum = a + f + Sines[i] + block[g];
+            const uint32_t shift = Shifts[(i / 16) * 4 + (i & 3)];
+            a = d;
+            d = c;
+            c = b;
+            b = b + (sum << shift | sum >> (32 - shift));
+        }
+        digest[0] += a;
+        digest[1] += b;
+        digest[2] += c;
+        digest[3] += d;
+    }
+};
+
+// Serializes the root signature as version 1.1, in a DXBC container holding one RTS0 part: the
+// layout of D3D12SerializeVersionedRootSignature's output, where the parameters follow the
+// header, each parameter's payload (a table's ranges after its header) follows them, in order,
+// and the static samplers come last. Offsets are from the start of the part.
+template <size_t ParameterCount, size_t SamplerCount>
+constexpr SerializedRootSignature<ParameterCount, SamplerCount> SerializeRootSignature(const RootSignatureLayout<ParameterCount, SamplerCount>& layout)
+{
+    typedef SerializedRootSignature<ParameterCount, SamplerCount> Result;
+    Result result = {};
+    uint8_t* bytes = &result.Bytes[0];
+    const auto put = [bytes](size_t offset, uint32_t value)
+    {
+        bytes[offset] = static_cast<uint8_t>(value);
+        bytes[offset + 1] = static_cast<uint8_t>(value >> 8);
+        bytes[offset + 2] = static_cast<uint8_t>(value >> 16);
+        bytes[offset + 3] = static_cast<uint8_t>(value >> 24);
+    };
+
+    // Container: "DXBC", checksum, version 1.0, size, one part at offset 36; part: "RTS0", size.
+    const size_t part = 44;
+    size_t at = part + 24 + ParameterCount * 12;
+    const size_t parameters = 24;
+    for (size_t i = 0; i < ParameterCount; ++i)
+    {
+        const RootParameterLayout& parameter = layout.Parameters[i];
+        const size_t entry = part + parameters + i * 12;
+        put(entry, static_cast<uint32_t>(parameter.Type));
+        put(entry + 4, static_cast<uint32_t>(parameter.Visibility));
+        put(entry + 8, static_cast<uint32_t>(at - part));
+        switch (parameter.Type)
+        {
+        case RootParameterType::DescriptorTable:
+            put(at, parameter.RangeCount);
+            put(at + 4, static_cast<uint32_t>(at + 8 - part));
+            at += 8;
+            for (uint32_t r = 0; r < parameter.RangeCount; ++r)
+            {
+                const DescriptorRangeLayout& range = parameter.Ranges[r];
+                put(at, static_cast<uint32_t>(range.Type));
+                put(at + 4, range.Count);
+                put(at + 8, range.BaseRegister);
+                put(at + 12, range.Space);
+                put(at + 16, range.Flags);
+                put(at + 20, range.TableOffset);
+                at += 24;
+            }
+            break;
+        case RootParameterType::Constants:
+            put(at, parameter.Register);
+            put(at + 4, parameter.Space);
+            put(at + 8, parameter.Values);
+            at += 12;
+            break;
+        default:
+            put(at, parameter.Register);
+            put(at + 4, parameter.Space);
+            put(at + 8, parameter.Flags);
+            at += 12;
+            break;
+        }
+    }
+
+    const size_t samplers = at - part;
+    for (const StaticSamplerLayout& sampler : layout.Samplers)
+    {
+        const uint32_t values[] =
+        {
+            static_cast<uint32_t>(sampler.Filter), static_cast<uint32_t>(sampler.Address), static_cast<uint32_t>(sampler.Address),
+            static_cast<uint32_t>(sampler.Address), FloatBitsOf(sampler.MipLodBias), sampler.MaxAnisotropy, sampler.ComparisonFunc,
+            static_cast<uint32_t>(sampler.Border), FloatBitsOf(sampler.MinLod), FloatBitsOf(sampler.MaxLod), sampler.Register,
+            sampler.Space, static_cast<uint32_t>(sampler.Visibility),
+        };
+        for (const uint32_t value : values)
+        {
+            put(at, value);
+            at += 4;
+        }
+    }
+
+    // RTS0 header: version 1.1, parameters, static samplers, flags.
+    put(part, 2);
+    put(part + 4, static_cast<uint32_t>(ParameterCount));
+    put(part + 8, static_cast<uint32_t>(parameters));
+    put(part + 12, static_cast<uint32_t>(SamplerCount));
+    put(part + 16, static_cast<uint32_t>(samplers));
+    put(part + 20, layout.Flags);
+
+    bytes[0] = 'D';
+    bytes[1] = 'X';
+    bytes[2] = 'B';
+    bytes[3] = 'C';
+    put(20, 1);
+    put(24, static_cast<uint32_t>(at));
+    put(28, 1);
+    put(32, 36);
+    bytes[36] = 'R';
+    bytes[37] = 'T';
+    bytes[38] = 'S';
+    bytes[39] = '0';
+    put(40, static_cast<uint32_t>(at - part));
+
+    uint32_t digest[4] = {};
+    ContainerChecksum::Compute(bytes + 20, static_cast<uint32_t>(at - 20), digest);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        put(4 + i * 4, digest[i]);
+    }
+
+    result.Size = at;
+    result.Hash = layout.Hash;
+    return result;
+}
@@ -0,0 +1,1182 @@
+#include "PixelConversion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PIXEL_AVX2 1
+// F16C comes with every AVX2 processor; GCC and Clang still want it asked for separately.
+#if defined(_MSC_VER) || defined(__F16C__)
+#define PIXEL_F16C 1
+#endif
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXEL_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PIXEL_NEON 1
+#endif
+
+namespace
+{
+    // Pixels decoded to float RGBA at a time: 4 KB of stack.
+    const size_t BlockPixels = 256;
+
+    inline uint32_t FloatBits(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline float BitsFloat(uint32_t bits)
+    {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Floats with a 5-bit exponent (bias 15): half (10-bit mantissa and a sign) and the 11 and
+    // 10 bit floats of R11G11B10 (6 and 5 bit mantissas, no sign).
+    // Decoding moves exponent and mantissa to the top of a float's and multiplies by 2^112, which
+    // rebiases the exponent and turns denormals into normals; all ones is made infinite or NaN.
+    const uint32_t SmallFloatMagic = 0x77800000;        // 2^112.
+
+    float SmallFloatToFloat(uint32_t bits, uint32_t mantissaBits, bool hasSign)
+    {
+        const uint32_t expMantissa = bits & ((1u << (5 + mantissaBits)) - 1);
+        const uint32_t shifted = expMantissa << (23 - mantissaBits);
+        const uint32_t infNan = shifted >= (0x1fu << 23) ? 0x7f800000u : 0;
+        float value = BitsFloat(shifted) * BitsFloat(SmallFloatMagic);
+        value = BitsFloat(FloatBits(value) | infNan);
+        return hasSign && ((bits >> (5 + mantissaBits)) & 1) ? -value : value;
+    }
+
+    // Round to nearest even. Too large becomes infinite; without a sign, negatives become 0. NaN
+    // keeps the top of its payload and is made quiet, as the F16C and NEON conversions do.
+    uint32_t FloatToSmallFloat(float value, uint32_t mantissaBits, bool hasSign)
+    {
+        uint32_t bits = FloatBits(value);
+        const uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        const uint32_t infinity = 0x1fu << mantissaBits;
+        uint32_t result;
+        if (bits > 0x7f800000u)
+        {
+            result = infinity | (1u << (mantissaBits - 1)) | ((bits & 0x7fffff) >> (23 - mantissaBits));
+        }
+        else if (sign && !hasSign)
+        {
+            return 0;
+        }
+        else if (bits >= 0x47800000u)                   // 2^16 and up.
+        {
+            result = infinity;
+        }
+        else
+        {
+            uint32_t shift;
+            uint32_t mantissa;
+            if (bits < (113u << 23))                    // Below 2^-14: denormal.
+            {
+                shift = 136 - (bits >> 23) - mantissaBits;
+                mantissa = (bits & 0x7fffff) | 0x800000;
+                if (shift >= 32 || bits == 0)
+                {
+                    mantissa = 0;
+                    shift = 0;
+                }
+            }
+            else
+            {
+                shift = 23 - mantissaBits;
+                mantissa = bits - (112u << 23);
+            }
+
+            result = shift ? mantissa >> shift : mantissa;
+            if (shift)
+            {
+                const uint32_t remainder = mantissa & ((1u << shift) - 1);
+                const uint32_t half = 1u << (shift - 1);
+                if (remainder > half || (remainder == half && (result & 1)))
+                {
+                    ++result;
+                }
+            }
+            result = std::min(result, infinity);
+        }
+        return hasSign ? result | (sign >> (31 - 5 - mantissaBits)) : result;
+    }
+
+    double SrgbToLinear(double value)
+    {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    double LinearToSrgb(double value)
+    {
+        return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+    }
+
+    // Linear to sRGB 8-bit goes through a table indexed by the top bits of the float, 2048 entries
+    // per power of two from 2^-13 (below it every value encodes to 0) to 1.
+    const uint32_t SrgbTableStart = 114u << 23;         // 2^-13.
+    const uint32_t SrgbTableShift = 12;
+    const uint32_t SrgbTableSize = (13u << 23) >> SrgbTableShift;
+
+    struct SrgbTables
+    {
+        float ToLinear[256];
+        uint8_t ToSrgb8[SrgbTableSize];
+
+        SrgbTables()
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                ToLinear[i] = static_cast<float>(SrgbToLinear(i / 255.0));
+            }
+            for (uint32_t i = 0; i < SrgbTableSize; ++i)
+            {
+                // Middle of the range of floats sharing the entry.
+                const float linear = BitsFloat(SrgbTableStart + (i << SrgbTableShift) + (1u << (SrgbTableShift - 1)));
+                ToSrgb8[i] = static_cast<uint8_t>(std::floor(LinearToSrgb(linear) * 255.0 + 0.5));
+            }
+        }
+    };
+
+    const SrgbTables& GetSrgbTables()
+    {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    // Clamped into the table instead of branching, which mispredicts on noisy images: the first
+    // entry encodes to 0 and the last (just below 1) to 255.
+    inline uint8_t EncodeSrgb8(float linear, const SrgbTables& tables)
+    {
+        float clamped = linear > BitsFloat(SrgbTableStart) ? linear : BitsFloat(SrgbTableStart);      // NaN too.
+        clamped = clamped < BitsFloat(0x3f7fffff) ? clamped : BitsFloat(0x3f7fffff);
+        return tables.ToSrgb8[(FloatBits(clamped) - SrgbTableStart) >> SrgbTableShift];
+    }
+
+    // Clamped to [0, 1], NaN to 0, then rounded: the same arithmetic as the vector kernels.
+    inline uint32_t EncodeUnorm(float value, float scale)
+    {
+        float clamped = value > 0.0f ? value : 0.0f;
+        clamped = clamped < 1.0f ? clamped : 1.0f;
+        return static_cast<uint32_t>(clamped * scale + 0.5f);
+    }
+
+#if defined(PIXEL_SSE2)
+    inline __m128 ClampUnit(__m128 value)
+    {
+        // maxps returns its second operand when either is NaN.
+        return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    }
+
+    inline __m128i EncodeUnorm(__m128 value, float scale)
+    {
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(ClampUnit(value), _mm_set1_ps(scale)), _mm_set1_ps(0.5f)));
+    }
+
+    // Input: exponent and mantissa placed at the float's (bit 23 up).
+    inline __m128 SmallFloatsToFloats(__m128i shifted)
+    {
+        const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(shifted), _mm_castsi128_ps(_mm_set1_epi32(SmallFloatMagic)));
+        const __m128i infNan = _mm_cmpgt_epi32(shifted, _mm_set1_epi32((0x1f << 23) - 1));
+        return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_and_si128(infNan, _mm_set1_epi32(0x7f800000))));
+    }
+
+    inline __m128i Select(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    // FloatToSmallFloat for four values. Normals round by adding just under half a step (plus the
+    // lowest kept bit, for ties to even) before shifting; a carry moves into the exponent as it
+    // should. Denormals are the value times 2^(14 + mantissaBits), converted with the default
+    // round to nearest even.
+    inline __m128i FloatsToSmallFloats(__m128 value, int mantissaBits, bool hasSign)
+    {
+        const __m128i bits = _mm_castps_si128(value);
+        const __m128i magnitude = _mm_and_si128(bits, _mm_set1_epi32(0x7fffffff));
+        const __m128i shift = _mm_cvtsi32_si128(23 - mantissaBits);
+
+        const __m128i lowestKept = _mm_and_si128(_mm_srl_epi32(magnitude, shift), _mm_set1_epi32(1));
+        const __m128i rounded = _mm_add_epi32(_mm_sub_epi32(magnitude, _mm_set1_epi32((112 << 23) - (1 << (22 - mantissaBits)) + 1)), lowestKept);
+        __m128i result = _mm_srl_epi32(rounded, shift);
+
+        const __m128 absolute = _mm_castsi128_ps(magnitude);
+        const __m128i denormal = _mm_cvtps_epi32(_mm_mul_ps(absolute, _mm_set1_ps(static_cast<float>(1 << (14 + mantissaBits)))));
+        result = Select(_mm_cmplt_epi32(magnitude, _mm_set1_epi32(113 << 23)), denormal, result);
+
+        const __m128i infinity = _mm_set1_epi32(0x1f << mantissaBits);
+        result = Select(_mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x477fffff)), infinity, result);
+        const __m128i nan = _mm_or_si128(_mm_set1_epi32((0x1f << mantissaBits) | (1 << (mantissaBits - 1))),
+            _mm_srl_epi32(_mm_and_si128(magnitude, _mm_set1_epi32(0x7fffff)), shift));
+        const __m128i isNan = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x7f800000));
+
+        if (hasSign)
+        {
+            result = Select(isNan, nan, result);
+            const __m128i sign = _mm_srli_epi32(_mm_andnot_si128(_mm_set1_epi32(0x7fffffff), bits), 31);
+            return _mm_or_si128(result, _mm_sll_epi32(sign, _mm_cvtsi32_si128(5 + mantissaBits)));
+        }
+        result = _mm_andnot_si128(_mm_srai_epi32(bits, 31), result);
+        return Select(isNan, nan, result);
+    }
+#endif
+
+#if defined(PIXEL_NEON)
+    inline uint32x4_t EncodeUnorm(float32x4_t value, float scale)
+    {
+        // vmaxnm returns the number when the other operand is NaN.
+        const float32x4_t clamped = vminq_f32(vmaxnmq_f32(value, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+        return vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(clamped, scale), vdupq_n_f32(0.5f)));
+    }
+
+    inline float32x4_t SmallFloatsToFloats(uint32x4_t shifted)
+    {
+        const float32x4_t scaled = vmulq_f32(vreinterpretq_f32_u32(shifted), vreinterpretq_f32_u32(vdupq_n_u32(SmallFloatMagic)));
+        const uint32x4_t infNan = vandq_u32(vcgtq_u32(shifted, vdupq_n_u32((0x1f << 23) - 1)), vdupq_n_u32(0x7f800000));
+        return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(scaled), infNan));
+    }
+
+    // See the SSE2 version.
+    inline uint32x4_t FloatsToSmallFloats(float32x4_t value, int mantissaBits, bool hasSign)
+    {
+        const uint32x4_t bits = vreinterpretq_u32_f32(value);
+        const uint32x4_t magnitude = vandq_u32(bits, vdupq_n_u32(0x7fffffff));
+        const int32x4_t shiftRight = vdupq_n_s32(mantissaBits - 23);
+
+        const uint32x4_t lowestKept = vandq_u32(vshlq_u32(magnitude, shiftRight), vdupq_n_u32(1));
+        const uint32x4_t rounded = vaddq_u32(vsubq_u32(magnitude, vdupq_n_u32((112u << 23) - (1u << (22 - mantissaBits)) + 1)), lowestKept);
+        uint32x4_t result = vshlq_u32(rounded, shiftRight);
+
+        const uint32x4_t denormal = vreinterpretq_u32_s32(vcvtnq_s32_f32(vmulq_n_f32(vabsq_f32(value), static_cast<float>(1 << (14 + mantissaBits)))));
+        result = vbslq_u32(vcltq_u32(magnitude, vdupq_n_u32(113u << 23)), denormal, result);
+        result = vbslq_u32(vcgtq_u32(magnitude, vdupq_n_u32(0x477fffff)), vdupq_n_u32(0x1fu << mantissaBits), result);
+        const uint32x4_t nan = vorrq_u32(vdupq_n_u32((0x1fu << mantissaBits) | (1u << (mantissaBits - 1))),
+            vshlq_u32(vandq_u32(magnitude, vdupq_n_u32(0x7fffff)), shiftRight));
+        const uint32x4_t isNan = vcgtq_u32(magnitude, vdupq_n_u32(0x7f800000));
+
+        if (hasSign)
+        {
+            result = vbslq_u32(isNan, nan, result);
+            return vorrq_u32(result, vshlq_u32(vshrq_n_u32(bits, 31), vdupq_n_s32(5 + mantissaBits)));
+        }
+        result = vbicq_u32(result, vcltq_s32(vreinterpretq_s32_u32(bits), vdupq_n_s32(0)));
+        return vbslq_u32(isNan, nan, result);
+    }
+#endif
+
+    // RGBA8 <-> BGRA8 without leaving the integers: red and blue trade places in each 32-bit
+    // pixel (little endian).
+    inline uint32_t SwapRedBlue(uint32_t pixel)
+    {
+        return (pixel & 0xff00ff00u) | ((pixel >> 16) & 0xffu) | ((pixel & 0xffu) << 16);
+    }
+
+    void SwapRedBlue(const uint8_t* source, uint8_t* dest, size_t count)
+    {
+        size_t i = 0;
+#if defined(PIXEL_AVX2)
+        {
+            const __m256i keep = _mm256_set1_epi32(static_cast<int>(0xff00ff00u));
+            const __m256i low = _mm256_set1_epi32(0xff);
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+                const __m256i swapped = _mm256_or_si256(_mm256_and_si256(x, keep),
+                    _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(x, 16), low), _mm256_slli_epi32(_mm256_and_si256(x, low), 16)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * 4), swapped);
+            }
+        }
+#endif
+#if defined(PIXEL_SSE2)
+        {
+            const __m128i keep = _mm_set1_epi32(static_cast<int>(0xff00ff00u));
+            const __m128i low = _mm_set1_epi32(0xff);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+                const __m128i swapped = _mm_or_si128(_mm_and_si128(x, keep),
+                    _mm_or_si128(_mm_and_si128(_mm_srli_epi32(x, 16), low), _mm_slli_epi32(_mm_and_si128(x, low), 16)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 4), swapped);
+            }
+        }
+#elif defined(PIXEL_NEON)
+        {
+            const uint32x4_t keep = vdupq_n_u32(0xff00ff00u);
+            const uint32x4_t low = vdupq_n_u32(0xff);
+            for (; i + 4 <= count; i += 4)
+            {
+                const uint32x4_t x = vreinterpretq_u32_u8(vld1q_u8(source + i * 4));
+                const uint32x4_t swapped = vorrq_u32(vandq_u32(x, keep),
+                    vorrq_u32(vandq_u32(vshrq_n_u32(x, 16), low), vshlq_n_u32(vandq_u32(x, low), 16)));
+                vst1q_u8(dest + i * 4, vreinterpretq_u8_u32(swapped));
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            uint32_t pixel;
+            memcpy(&pixel, source + i * 4, 4);
+            pixel = SwapRedBlue(pixel);
+            memcpy(dest + i * 4, &pixel, 4);
+        }
+    }
+
+    // Decoders: count pixels (at most BlockPixels) to float RGBA.
+
+    void DecodeRgba8(const uint8_t* source, bool bgra, bool srgb, float* out, size_t count)
+    {
+        size_t i = 0;
+        if (srgb)
+        {
+            // A table lookup per channel beats any arithmetic.
+            const SrgbTables& tables = GetSrgbTables();
+            const int red = bgra ? 2 : 0;
+            for (; i < count; ++i)
+            {
+                const uint8_t* pixel = source + i * 4;
+                out[i * 4 + 0] = tables.ToLinear[pixel[red]];
+                out[i * 4 + 1] = tables.ToLinear[pixel[1]];
+                out[i * 4 + 2] = tables.ToLinear[pixel[2 - red]];
+                out[i * 4 + 3] = pixel[3] * (1.0f / 255.0f);
+            }
+            return;
+        }
+
+#if defined(PIXEL_AVX2)
+        {
+            const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+                __m256 lo = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(x)), scale);
+                __m256 hi = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(x, 8))), scale);
+                if (bgra)
+                {
+                    lo = _mm256_shuffle_ps(lo, lo, _MM_SHUFFLE(3, 0, 1, 2));
+                    hi = _mm256_shuffle_ps(hi, hi, _MM_SHUFFLE(3, 0, 1, 2));
+                }
+                _mm256_storeu_ps(out + i * 4, lo);
+                _mm256_storeu_ps(out + i * 4 + 8, hi);
+            }
+        }
+#elif defined(PIXEL_SSE2)
+        {
+            const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+                const __m128i words[2] = { _mm_unpacklo_epi8(x, zero), _mm_unpackhi_epi8(x, zero) };
+                for (int p = 0; p < 4; ++p)
+                {
+                    const __m128i pixel = (p & 1) ? _mm_unpackhi_epi16(words[p >> 1], zero) : _mm_unpacklo_epi16(words[p >> 1], zero);
+                    __m128 value = _mm_mul_ps(_mm_cvtepi32_ps(pixel), scale);
+                    if (bgra)
+                    {
+                        value = _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 0, 1, 2));
+                    }
+                    _mm_storeu_ps(out + (i + p) * 4, value);
+                }
+            }
+        }
+#elif defined(PIXEL_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x4_t planes = vld4q_u8(source + i * 4);
+            if (bgra)
+            {
+                const uint8x16_t blue = planes.val[0];
+                planes.val[0] = planes.val[2];
+                planes.val[2] = blue;
+            }
+            for (int group = 0; group < 4; ++group)
+            {
+                float32x4x4_t values;
+                for (int c = 0; c < 4; ++c)
+                {
+                    const uint16x8_t words = vmovl_u8(group < 2 ? vget_low_u8(planes.val[c]) : vget_high_u8(planes.val[c]));
+                    const uint32x4_t channel = vmovl_u16((group & 1) ? vget_high_u16(words) : vget_low_u16(words));
+                    values.val[c] = vmulq_n_f32(vcvtq_f32_u32(channel), 1.0f / 255.0f);
+                }
+                vst4q_f32(out + (i + group * 4) * 4, values);
+            }
+        }
+#endif
+        const int red = bgra ? 2 : 0;
+        for (; i < count; ++i)
+        {
+            const uint8_t* pixel = source + i * 4;
+            out[i * 4 + 0] = pixel[red] * (1.0f / 255.0f);
+            out[i * 4 + 1] = pixel[1] * (1.0f / 255.0f);
+            out[i * 4 + 2] = pixel[2 - red] * (1.0f / 255.0f);
+            out[i * 4 + 3] = pixel[3] * (1.0f / 255.0f);
+        }
+    }
+
+    void DecodeHalf(const uint16_t* source, float* out, size_t count)
+    {
+        const size_t values = count * 4;
+        size_t i = 0;
+#if defined(PIXEL_F16C)
+        for (; i + 8 <= values; i += 8)
+        {
+            _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i))));
+        }
+#elif defined(PIXEL_SSE2)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i noSign = _mm_set1_epi32(0x7fff);
+            for (; i + 8 <= values; i += 8)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+                const __m128i halves[2] = { _mm_unpacklo_epi16(x, zero), _mm_unpackhi_epi16(x, zero) };
+                for (int h = 0; h < 2; ++h)
+                {
+                    const __m128i expMantissa = _mm_and_si128(halves[h], noSign);
+                    const __m128i sign = _mm_slli_epi32(_mm_xor_si128(halves[h], expMantissa), 16);
+                    const __m128 value = SmallFloatsToFloats(_mm_slli_epi32(expMantissa, 13));
+                    _mm_storeu_ps(out + i + h * 4, _mm_or_ps(value, _mm_castsi128_ps(sign)));
+                }
+            }
+        }
+#elif defined(PIXEL_NEON)
+        for (; i + 4 <= values; i += 4)
+        {
+            vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(source + i))));
+        }
+#endif
+        for (; i < values; ++i)
+        {
+            out[i] = SmallFloatToFloat(source[i], 10, true);
+        }
+    }
+
+    void DecodeRgb10A2(const uint32_t* source, float* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(PIXEL_SSE2)
+        {
+            const __m128i mask = _mm_set1_epi32(0x3ff);
+            const __m128 colorScale = _mm_set1_ps(1.0f / 1023.0f);
+            const __m128 alphaScale = _mm_set1_ps(1.0f / 3.0f);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+                __m128 r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(x, mask)), colorScale);
+                __m128 g = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(x, 10), mask)), colorScale);
+                __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(x, 20), mask)), colorScale);
+                __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x, 30)), alphaScale);
+                _MM_TRANSPOSE4_PS(r, g, b, a);
+                _mm_storeu_ps(out + i * 4, r);
+                _mm_storeu_ps(out + i * 4 + 4, g);
+                _mm_storeu_ps(out + i * 4 + 8, b);
+                _mm_storeu_ps(out + i * 4 + 12, a);
+            }
+        }
+#elif defined(PIXEL_NEON)
+        {
+            const uint32x4_t mask = vdupq_n_u32(0x3ff);
+            for (; i + 4 <= count; i += 4)
+            {
+                const uint32x4_t x = vld1q_u32(source + i);
+                float32x4x4_t values;
+                values.val[0] = vmulq_n_f32(vcvtq_f32_u32(vandq_u32(x, mask)), 1.0f / 1023.0f);
+                values.val[1] = vmulq_n_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(x, 10), mask)), 1.0f / 1023.0f);
+                values.val[2] = vmulq_n_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(x, 20), mask)), 1.0f / 1023.0f);
+                values.val[3] = vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(x, 30)), 1.0f / 3.0f);
+                vst4q_f32(out + i * 4, values);
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const uint32_t x = source[i];
+            out[i * 4 + 0] = (x & 0x3ff) * (1.0f / 1023.0f);
+            out[i * 4 + 1] = ((x >> 10) & 0x3ff) * (1.0f / 1023.0f);
+            out[i * 4 + 2] = ((x >> 20) & 0x3ff) * (1.0f / 1023.0f);
+            out[i * 4 + 3] = (x >> 30) * (1.0f / 3.0f);
+        }
+    }
+
+    void DecodeRg11B10(const uint32_t* source, float* out, size_t count)
+    {
+        size_t i = 0;
+#if defined(PIXEL_SSE2)
+        {
+            const __m128i mask11 = _mm_set1_epi32(0x7ff);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+                __m128 r = SmallFloatsToFloats(_mm_slli_epi32(_mm_and_si128(x, mask11), 17));
+                __m128 g = SmallFloatsToFloats(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(x, 11), mask11), 17));
+                __m128 b = SmallFloatsToFloats(_mm_slli_epi32(_mm_srli_epi32(x, 22), 18));
+                __m128 a = _mm_set1_ps(1.0f);
+                _MM_TRANSPOSE4_PS(r, g, b, a);
+                _mm_storeu_ps(out + i * 4, r);
+                _mm_storeu_ps(out + i * 4 + 4, g);
+                _mm_storeu_ps(out + i * 4 + 8, b);
+                _mm_storeu_ps(out + i * 4 + 12, a);
+            }
+        }
+#elif defined(PIXEL_NEON)
+        {
+            const uint32x4_t mask11 = vdupq_n_u32(0x7ff);
+            for (; i + 4 <= count; i += 4)
+            {
+                const uint32x4_t x = vld1q_u32(source + i);
+                float32x4x4_t values;
+                values.val[0] = SmallFloatsToFloats(vshlq_n_u32(vandq_u32(x, mask11), 17));
+                values.val[1] = SmallFloatsToFloats(vshlq_n_u32(vandq_u32(vshrq_n_u32(x, 11), mask11), 17));
+                values.val[2] = SmallFloatsToFloats(vshlq_n_u32(vshrq_n_u32(x, 22), 18));
+                values.val[3] = vdupq_n_f32(1.0f);
+                vst4q_f32(out + i * 4, values);
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const uint32_t x = source[i];
+            out[i * 4 + 0] = SmallFloatToFloat(x & 0x7ff, 6, false);
+            out[i * 4 + 1] = SmallFloatToFloat((x >> 11) & 0x7ff, 6, false);
+            out[i * 4 + 2] = SmallFloatToFloat(x >> 22, 5, false);
+            out[i * 4 + 3] = 1.0f;
+        }
+    }
+
+    // Operations on the decoded block.
+
+    void ApplySrgbToLinear(float* rgba, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                rgba[i * 4 + c] = static_cast<float>(SrgbToLinear(rgba[i * 4 + c]));
+            }
+        }
+    }
+
+    void ApplyLinearToSrgb(float* rgba, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                rgba[i * 4 + c] = static_cast<float>(LinearToSrgb(rgba[i * 4 + c]));
+            }
+        }
+    }
+
+    void PremultiplyAlpha(float* rgba, size_t count)
+    {
+        size_t i = 0;
+#if defined(PIXEL_SSE2)
+        {
+            const __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+            for (; i < count; ++i)
+            {
+                const __m128 value = _mm_loadu_ps(rgba + i * 4);
+                const __m128 scaled = _mm_mul_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3)));
+                _mm_storeu_ps(rgba + i * 4, _mm_or_ps(_mm_and_ps(colorMask, scaled), _mm_andnot_ps(colorMask, value)));
+            }
+        }
+#elif defined(PIXEL_NEON)
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4x4_t values = vld4q_f32(rgba + i * 4);
+            for (int c = 0; c < 3; ++c)
+            {
+                values.val[c] = vmulq_f32(values.val[c], values.val[3]);
+            }
+            vst4q_f32(rgba + i * 4, values);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                rgba[i * 4 + c] *= rgba[i * 4 + 3];
+            }
+        }
+    }
+
+    // Encoders: the block to the destination format, written front to back.
+
+    void EncodeRgba8(const float* rgba, bool bgra, bool srgb, uint8_t* dest, size_t count)
+    {
+        const int red = bgra ? 2 : 0;
+        size_t i = 0;
+        if (srgb)
+        {
+            const SrgbTables& tables = GetSrgbTables();
+#if defined(PIXEL_SSE2)
+            // The clamping and table indices four channels at a time; only the lookups are scalar.
+            const __m128 low = _mm_castsi128_ps(_mm_set1_epi32(SrgbTableStart));
+            const __m128 high = _mm_castsi128_ps(_mm_set1_epi32(0x3f7fffff));
+            const __m128i start = _mm_set1_epi32(SrgbTableStart);
+            for (; i < count; ++i)
+            {
+                const __m128 value = _mm_loadu_ps(rgba + i * 4);
+                const __m128i index = _mm_srli_epi32(_mm_sub_epi32(_mm_castps_si128(_mm_min_ps(_mm_max_ps(value, low), high)), start), SrgbTableShift);
+                alignas(16) uint32_t indices[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
+                uint8_t pixel[4];
+                pixel[red] = tables.ToSrgb8[indices[0]];
+                pixel[1] = tables.ToSrgb8[indices[1]];
+                pixel[2 - red] = tables.ToSrgb8[indices[2]];
+                pixel[3] = static_cast<uint8_t>(EncodeUnorm(rgba[i * 4 + 3], 255.0f));
+                memcpy(dest + i * 4, pixel, 4);
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                const float* value = rgba + i * 4;
+                uint8_t pixel[4];
+                pixel[red] = EncodeSrgb8(value[0], tables);
+                pixel[1] = EncodeSrgb8(value[1], tables);
+                pixel[2 - red] = EncodeSrgb8(value[2], tables);
+                pixel[3] = static_cast<uint8_t>(EncodeUnorm(value[3], 255.0f));
+                memcpy(dest + i * 4, pixel, 4);
+            }
+            return;
+        }
+
+#if defined(PIXEL_AVX2)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 scale = _mm256_set1_ps(255.0f);
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i quantized[4];
+                for (int p = 0; p < 4; ++p)
+                {
+                    __m256 value = _mm256_loadu_ps(rgba + i * 4 + p * 8);
+                    if (bgra)
+                    {
+                        value = _mm256_shuffle_ps(value, value, _MM_SHUFFLE(3, 0, 1, 2));
+                    }
+                    value = _mm256_min_ps(_mm256_max_ps(value, zero), one);
+                    quantized[p] = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, scale), half));
+                }
+                // The packs work within 128-bit lanes; the permute puts the pixels back in order.
+                const __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(quantized[0], quantized[1]), _mm256_packs_epi32(quantized[2], quantized[3]));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * 4), _mm256_permutevar8x32_epi32(bytes, order));
+            }
+        }
+#endif
+#if defined(PIXEL_SSE2)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i quantized[4];
+            for (int p = 0; p < 4; ++p)
+            {
+                __m128 value = _mm_loadu_ps(rgba + (i + p) * 4);
+                if (bgra)
+                {
+                    value = _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 0, 1, 2));
+                }
+                quantized[p] = EncodeUnorm(value, 255.0f);
+            }
+            const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(quantized[0], quantized[1]), _mm_packs_epi32(quantized[2], quantized[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 4), bytes);
+        }
+#elif defined(PIXEL_NEON)
+        for (; i + 8 <= count; i += 8)
+        {
+            const float32x4x4_t lo = vld4q_f32(rgba + i * 4);
+            const float32x4x4_t hi = vld4q_f32(rgba + i * 4 + 16);
+            uint8x8x4_t planes;
+            for (int c = 0; c < 4; ++c)
+            {
+                const uint16x8_t words = vcombine_u16(vmovn_u32(EncodeUnorm(lo.val[c], 255.0f)), vmovn_u32(EncodeUnorm(hi.val[c], 255.0f)));
+                planes.val[c == 3 ? 3 : (c == 1 ? 1 : (c == 0 ? red : 2 - red))] = vmovn_u16(words);
+            }
+            vst4_u8(dest + i * 4, planes);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float* value = rgba + i * 4;
+            uint8_t pixel[4];
+            pixel[red] = static_cast<uint8_t>(EncodeUnorm(value[0], 255.0f));
+            pixel[1] = static_cast<uint8_t>(EncodeUnorm(value[1], 255.0f));
+            pixel[2 - red] = static_cast<uint8_t>(EncodeUnorm(value[2], 255.0f));
+            pixel[3] = static_cast<uint8_t>(EncodeUnorm(value[3], 255.0f));
+            memcpy(dest + i * 4, pixel, 4);
+        }
+    }
+
+    void EncodeHalf(const float* rgba, uint16_t* dest, size_t count)
+    {
+        const size_t values = count * 4;
+        size_t i = 0;
+#if defined(PIXEL_F16C)
+        for (; i + 8 <= values; i += 8)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm256_cvtps_ph(_mm256_loadu_ps(rgba + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+#elif defined(PIXEL_SSE2)
+        for (; i + 8 <= values; i += 8)
+        {
+            const __m128i lo = FloatsToSmallFloats(_mm_loadu_ps(rgba + i), 10, true);
+            const __m128i hi = FloatsToSmallFloats(_mm_loadu_ps(rgba + i + 4), 10, true);
+            // packs would saturate the signed halves; move them into the low 16 bits signed first.
+            const __m128i packed = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), packed);
+        }
+#elif defined(PIXEL_NEON)
+        for (; i + 4 <= values; i += 4)
+        {
+            vst1_u16(dest + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(rgba + i))));
+        }
+#endif
+        for (; i < values; ++i)
+        {
+            dest[i] = static_cast<uint16_t>(FloatToSmallFloat(rgba[i], 10, true));
+        }
+    }
+
+    void EncodeRgb10A2(const float* rgba, uint32_t* dest, size_t count)
+    {
+        size_t i = 0;
+#if defined(PIXEL_SSE2)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 r = _mm_loadu_ps(rgba + i * 4);
+            __m128 g = _mm_loadu_ps(rgba + i * 4 + 4);
+            __m128 b = _mm_loadu_ps(rgba + i * 4 + 8);
+            __m128 a = _mm_loadu_ps(rgba + i * 4 + 12);
+            _MM_TRANSPOSE4_PS(r, g, b, a);
+            const __m128i packed = _mm_or_si128(
+                _mm_or_si128(EncodeUnorm(r, 1023.0f), _mm_slli_epi32(EncodeUnorm(g, 1023.0f), 10)),
+                _mm_or_si128(_mm_slli_epi32(EncodeUnorm(b, 1023.0f), 20), _mm_slli_epi32(EncodeUnorm(a, 3.0f), 30)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), packed);
+        }
+#elif defined(PIXEL_NEON)
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4x4_t values = vld4q_f32(rgba + i * 4);
+            const uint32x4_t packed = vorrq_u32(
+                vorrq_u32(EncodeUnorm(values.val[0], 1023.0f), vshlq_n_u32(EncodeUnorm(values.val[1], 1023.0f), 10)),
+                vorrq_u32(vshlq_n_u32(EncodeUnorm(values.val[2], 1023.0f), 20), vshlq_n_u32(EncodeUnorm(values.val[3], 3.0f), 30)));
+            vst1q_u32(dest + i, packed);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float* value = rgba + i * 4;
+            dest[i] = EncodeUnorm(value[0], 1023.0f) | (EncodeUnorm(value[1], 1023.0f) << 10) |
+                (EncodeUnorm(value[2], 1023.0f) << 20) | (EncodeUnorm(value[3], 3.0f) << 30);
+        }
+    }
+
+    void EncodeRg11B10(const float* rgba, uint32_t* dest, size_t count)
+    {
+        size_t i = 0;
+#if defined(PIXEL_SSE2)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 r = _mm_loadu_ps(rgba + i * 4);
+            __m128 g = _mm_loadu_ps(rgba + i * 4 + 4);
+            __m128 b = _mm_loadu_ps(rgba + i * 4 + 8);
+            __m128 a = _mm_loadu_ps(rgba + i * 4 + 12);
+            _MM_TRANSPOSE4_PS(r, g, b, a);
+            const __m128i packed = _mm_or_si128(_mm_or_si128(FloatsToSmallFloats(r, 6, false), _mm_slli_epi32(FloatsToSmallFloats(g, 6, false), 11)),
+                _mm_slli_epi32(FloatsToSmallFloats(b, 5, false), 22));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), packed);
+        }
+#elif defined(PIXEL_NEON)
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4x4_t values = vld4q_f32(rgba + i * 4);
+            const uint32x4_t packed = vorrq_u32(vorrq_u32(FloatsToSmallFloats(values.val[0], 6, false), vshlq_n_u32(FloatsToSmallFloats(values.val[1], 6, false), 11)),
+                vshlq_n_u32(FloatsToSmallFloats(values.val[2], 5, false), 22));
+            vst1q_u32(dest + i, packed);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float* value = rgba + i * 4;
+            dest[i] = FloatToSmallFloat(value[0], 6, false) | (FloatToSmallFloat(value[1], 6, false) << 11) |
+                (FloatToSmallFloat(value[2], 5, false) << 22);
+        }
+    }
+
+    void CheckFormat(PixelFormat format)
+    {
+        if (format >= PixelFormat::Count)
+        {
+            throw std::invalid_argument("Unknown pixel format.");
+        }
+    }
+
+    // Reference implementation: one pixel at a time, in double precision, independent of the
+    // bit tricks above.
+
+    struct Color
+    {
+        double Channel[4];
+    };
+
+    double ReferenceSmallFloat(uint32_t bits, uint32_t mantissaBits, bool hasSign)
+    {
+        const uint32_t exponent = (bits >> mantissaBits) & 0x1f;
+        const uint32_t mantissa = bits & ((1u << mantissaBits) - 1);
+        const bool negative = hasSign && ((bits >> (mantissaBits + 5)) & 1);
+        double value;
+        if (exponent == 0x1f)
+        {
+            value = mantissa ? NAN : INFINITY;
+        }
+        else if (exponent == 0)
+        {
+            value = std::ldexp(static_cast<double>(mantissa), -14 - static_cast<int>(mantissaBits));
+        }
+        else
+        {
+            value = std::ldexp(1.0 + std::ldexp(static_cast<double>(mantissa), -static_cast<int>(mantissaBits)), static_cast<int>(exponent) - 15);
+        }
+        return negative ? -value : value;
+    }
+
+    uint32_t ReferenceEncodeSmallFloat(double value, uint32_t mantissaBits, bool hasSign)
+    {
+        const uint32_t infinity = 0x1fu << mantissaBits;
+        if (std::isnan(value))
+        {
+            return infinity | (1u << (mantissaBits - 1));
+        }
+        const uint32_t sign = (hasSign && std::signbit(value)) ? 1u << (mantissaBits + 5) : 0;
+        if (!hasSign && value <= 0.0)
+        {
+            return 0;
+        }
+        value = std::fabs(value);
+
+        // The quantum of the binade holding the value (denormals share the lowest one), then round
+        // to nearest even in units of it.
+        int exponent = std::max(static_cast<int>(std::floor(std::log2(value))), -14);
+        if (std::isinf(value) || exponent > 15)
+        {
+            return sign | infinity;
+        }
+        double quantized = std::nearbyint(std::ldexp(value, static_cast<int>(mantissaBits) - exponent));
+        const double implicitOne = std::ldexp(1.0, static_cast<int>(mantissaBits));
+        if (quantized >= 2.0 * implicitOne)
+        {
+            quantized /= 2.0;
+            ++exponent;
+        }
+        if (exponent > 15)
+        {
+            return sign | infinity;
+        }
+        if (quantized < implicitOne)
+        {
+            return sign | static_cast<uint32_t>(quantized);
+        }
+        return sign | (static_cast<uint32_t>(exponent + 15) << mantissaBits) | static_cast<uint32_t>(quantized - implicitOne);
+    }
+
+    uint32_t ReferenceEncodeUnorm(double value, double scale)
+    {
+        value = std::isnan(value) ? 0.0 : std::min(std::max(value, 0.0), 1.0);
+        return static_cast<uint32_t>(std::floor(value * scale + 0.5));
+    }
+
+    Color ReferenceDecode(const uint8_t* pixel, PixelFormat format)
+    {
+        Color color;
+        uint32_t packed;
+        switch (format)
+        {
+        case PixelFormat::RGBA8:
+        case PixelFormat::BGRA8:
+            for (int c = 0; c < 4; ++c)
+            {
+                color.Channel[c] = pixel[c] / 255.0;
+            }
+            if (format == PixelFormat::BGRA8)
+            {
+                std::swap(color.Channel[0], color.Channel[2]);
+            }
+            break;
+        case PixelFormat::RGBA16F:
+            for (int c = 0; c < 4; ++c)
+            {
+                color.Channel[c] = ReferenceSmallFloat(pixel[c * 2] | (pixel[c * 2 + 1] << 8), 10, true);
+            }
+            break;
+        case PixelFormat::RGBA32F:
+            for (int c = 0; c < 4; ++c)
+            {
+                float value;
+                memcpy(&value, pixel + c * 4, 4);
+                color.Channel[c] = value;
+            }
+            break;
+        case PixelFormat::RGB10A2:
+            memcpy(&packed, pixel, 4);
+            color.Channel[0] = (packed & 0x3ff) / 1023.0;
+            color.Channel[1] = ((packed >> 10) & 0x3ff) / 1023.0;
+            color.Channel[2] = ((packed >> 20) & 0x3ff) / 1023.0;
+            color.Channel[3] = (packed >> 30) / 3.0;
+            break;
+        default:
+            memcpy(&packed, pixel, 4);
+            color.Channel[0] = ReferenceSmallFloat(packed & 0x7ff, 6, false);
+            color.Channel[1] = ReferenceSmallFloat((packed >> 11) & 0x7ff, 6, false);
+            color.Channel[2] = ReferenceSmallFloat(packed >> 22, 5, false);
+            color.Channel[3] = 1.0;
+            break;
+        }
+        return color;
+    }
+
+    void ReferenceEncode(const Color& color, PixelFormat format, uint8_t* pixel)
+    {
+        uint32_t packed;
+        switch (format)
+        {
+        case PixelFormat::RGBA8:
+        case PixelFormat::BGRA8:
+            for (int c = 0; c < 4; ++c)
+            {
+                pixel[c] = static_cast<uint8_t>(ReferenceEncodeUnorm(color.Channel[c], 255.0));
+            }
+            if (format == PixelFormat::BGRA8)
+            {
+                std::swap(pixel[0], pixel[2]);
+            }
+            break;
+        case PixelFormat::RGBA16F:
+            for (int c = 0; c < 4; ++c)
+            {
+                const uint32_t half = ReferenceEncodeSmallFloat(color.Channel[c], 10, true);
+                pixel[c * 2] = static_cast<uint8_t>(half);
+                pixel[c * 2 + 1] = static_cast<uint8_t>(half >> 8);
+            }
+            break;
+        case PixelFormat::RGBA32F:
+            for (int c = 0; c < 4; ++c)
+            {
+                const float value = static_cast<float>(color.Channel[c]);
+                memcpy(pixel + c * 4, &value, 4);
+            }
+            break;
+        case PixelFormat::RGB10A2:
+            packed = ReferenceEncodeUnorm(color.Channel[0], 1023.0) | (ReferenceEncodeUnorm(color.Channel[1], 1023.0) << 10) |
+                (ReferenceEncodeUnorm(color.Channel[2], 1023.0) << 20) | (ReferenceEncodeUnorm(color.Channel[3], 3.0) << 30);
+            memcpy(pixel, &packed, 4);
+            break;
+        default:
+            packed = ReferenceEncodeSmallFloat(color.Channel[0], 6, false) | (ReferenceEncodeSmallFloat(color.Channel[1], 6, false) << 11) |
+                (ReferenceEncodeSmallFloat(color.Channel[2], 5, false) << 22);
+            memcpy(pixel, &packed, 4);
+            break;
+        }
+    }
+}
+
+uint32_t GetPixelSize(PixelFormat format)
+{
+    CheckFormat(format);
+    static const uint32_t sizes[] = { 4, 4, 8, 16, 4, 4 };
+    return sizes[static_cast<size_t>(format)];
+}
+
+const char* GetPixelFormatName(PixelFormat format)
+{
+    static const char* const names[] = { "rgba8", "bgra8", "rgba16f", "rgba32f", "rgb10a2", "rg11b10f" };
+    return format < PixelFormat::Count ? names[static_cast<size_t>(format)] : "unknown";
+}
+
+bool GetPixelFormatFromDxgi(uint32_t dxgiFormat, PixelFormat& format, bool& srgb)
+{
+    // Values are DXGI_FORMAT; this file has no dependency on the Windows headers.
+    srgb = dxgiFormat == 29 || dxgiFormat == 91;
+    switch (dxgiFormat)
+    {
+    case 2:  format = PixelFormat::RGBA32F; return true;
+    case 10: format = PixelFormat::RGBA16F; return true;
+    case 24: format = PixelFormat::RGB10A2; return true;
+    case 26: format = PixelFormat::RG11B10F; return true;
+    case 28:
+    case 29: format = PixelFormat::RGBA8; return true;
+    case 87:
+    case 91: format = PixelFormat::BGRA8; return true;
+    default: return false;
+    }
+}
+
+void ConvertPixels(const void* source, PixelFormat sourceFormat, void* dest, PixelFormat destFormat, size_t pixelCount, uint32_t flags)
+{
+    CheckFormat(sourceFormat);
+    CheckFormat(destFormat);
+
+    const uint8_t* in = static_cast<const uint8_t*>(source);
+    uint8_t* out = static_cast<uint8_t*>(dest);
+    const bool sourceSrgb = (flags & PixelSourceSrgb) != 0;
+    const bool destSrgb = (flags & PixelDestSrgb) != 0;
+    const bool premultiply = (flags & PixelPremultiplyAlpha) != 0;
+
+    // Nothing to do to the values: a copy, or a swizzle that never leaves the integers.
+    if (sourceSrgb == destSrgb && !premultiply)
+    {
+        if (sourceFormat == destFormat)
+        {
+            memcpy(out, in, pixelCount * GetPixelSize(sourceFormat));
+            return;
+        }
+        if ((sourceFormat == PixelFormat::RGBA8 && destFormat == PixelFormat::BGRA8) ||
+            (sourceFormat == PixelFormat::BGRA8 && destFormat == PixelFormat::RGBA8))
+        {
+            SwapRedBlue(in, out, pixelCount);
+            return;
+        }
+    }
+
+    const bool source8 = sourceFormat == PixelFormat::RGBA8 || sourceFormat == PixelFormat::BGRA8;
+    const bool dest8 = destFormat == PixelFormat::RGBA8 || destFormat == PixelFormat::BGRA8;
+    const size_t sourceSize = GetPixelSize(sourceFormat);
+    const size_t destSize = GetPixelSize(destFormat);
+
+    float block[BlockPixels * 4];
+    for (size_t done = 0; done < pixelCount; )
+    {
+        const size_t count = std::min(BlockPixels, pixelCount - done);
+
+        switch (sourceFormat)
+        {
+        case PixelFormat::RGBA8:
+        case PixelFormat::BGRA8:
+            DecodeRgba8(in, sourceFormat == PixelFormat::BGRA8, sourceSrgb, block, count);
+            break;
+        case PixelFormat::RGBA16F:
+            DecodeHalf(reinterpret_cast<const uint16_t*>(in), block, count);
+            break;
+        case PixelFormat::RGBA32F:
+            memcpy(block, in, count * 16);
+            break;
+        case PixelFormat::RGB10A2:
+            DecodeRgb10A2(reinterpret_cast<const uint32_t*>(in), block, count);
+            break;
+        default:
+            DecodeRg11B10(reinterpret_cast<const uint32_t*>(in), block, count);
+            break;
+        }
+
+        if (sourceSrgb && !source8)
+        {
+            ApplySrgbToLinear(block, count);
+        }
+        if (premultiply)
+        {
+            PremultiplyAlpha(block, count);
+        }
+        if (destSrgb && !dest8)
+        {
+            ApplyLinearToSrgb(block, count);
+        }
+
+        switch (destFormat)
+        {
+        case PixelFormat::RGBA8:
+        case PixelFormat::BGRA8:
+            EncodeRgba8(block, destFormat == PixelFormat::BGRA8, destSrgb, out, count);
+            break;
+        case PixelFormat::RGBA16F:
+            EncodeHalf(block, reinterpret_cast<uint16_t*>(out), count);
+            break;
+        case PixelFormat::RGBA32F:
+            memcpy(out, block, count * 16);
+            break;
+        case PixelFormat::RGB10A2:
+            EncodeRgb10A2(block, reinterpret_cast<uint32_t*>(out), count);
+            break;
+        default:
+            EncodeRg11B10(block, reinterpret_cast<uint32_t*>(out), count);
+            break;
+        }
+
+        in += count * sourceSize;
+        out += count * destSize;
+        done += count;
+    }
+}
+
+void ConvertPixelRows(
+    const void* source,
+    size_t sourceRowPitch,
+    PixelFormat sourceFormat,
+    void* dest,
+    size_t destRowPitch,
+    PixelFormat destFormat,
+    uint32_t width,
+    uint32_t height,
+    uint32_t flags)
+{
+    for (uint32_t row = 0; row < height; ++row)
+    {
+        ConvertPixels(static_cast<const uint8_t*>(source) + row * sourceRowPitch, sourceFormat,
+            static_cast<uint8_t*>(dest) + row * destRowPitch, destFormat, width, flags);
+    }
+}
+
+void ConvertPixelsReference(const void* source, PixelFormat sourceFormat, void* dest, PixelFormat destFormat, size_t pixelCount, uint32_t flags)
+{
+    CheckFormat(sourceFormat);
+    CheckFormat(destFormat);
+
+    const uint8_t* in = static_cast<const uint8_t*>(source);
+    uint8_t* out = static_cast<uint8_t*>(dest);
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        Color color = ReferenceDecode(in + i * GetPixelSize(sourceFormat), sourceFormat);
+        for (int c = 0; c < 3; ++c)
+        {
+            double& value = color.Channel[c];
+            if (flags & PixelSourceSrgb)
+            {
+                value = SrgbToLinear(value);
+            }
+            if (flags & PixelPremultiplyAlpha)
+            {
+                value *= color.Channel[3];
+            }
+            if (flags & PixelDestSrgb)
+            {
+                value = LinearToSrgb(value);
+            }
+        }
+        ReferenceEncode(color, destFormat, out + i * GetPixelSize(destFormat));
+    }
+}
+
+const char* GetPixelConversionIsa()
+{
+#if defined(PIXEL_AVX2)
+    return "avx2";
+#elif defined(PIXEL_SSE2)
+    return "sse2";
+#elif defined(PIXEL_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
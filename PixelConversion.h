@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Uncompressed texel layouts the texture upload paths convert between. Channels are listed from
+// the lowest byte (or bits) up.
+enum class PixelFormat : uint8_t
+{
+    RGBA8,          // 8-bit unorm.
+    BGRA8,
+    RGBA16F,
+    RGBA32F,
+    RGB10A2,        // 10-bit unorm color, 2-bit unorm alpha.
+    RG11B10F,       // Unsigned 11, 11 and 10 bit floats; no alpha (reads as 1).
+    Count
+};
+
+uint32_t GetPixelSize(PixelFormat format);
+const char* GetPixelFormatName(PixelFormat format);
+
+// The PixelFormat of a DXGI_FORMAT value and whether it is an _SRGB format. Returns false for
+// formats the conversions do not handle.
+bool GetPixelFormatFromDxgi(uint32_t dxgiFormat, PixelFormat& format, bool& srgb);
+
+enum PixelConversionFlags : uint32_t
+{
+    PixelSourceSrgb = 1 << 0,           // The source colors are sRGB encoded.
+    PixelDestSrgb = 1 << 1,             // Encode the destination colors as sRGB.
+    PixelPremultiplyAlpha = 1 << 2,     // Multiply the colors by alpha, in linear space.
+};
+
+// Converts pixelCount pixels. Values are clamped to the range of the destination; NaN becomes 0
+// in unorm formats. The destination is written front to back and never read, so it can be
+// write-combined memory such as a mapped upload heap. Source and destination must not overlap.
+// Vector kernels (SSE2, AVX2 with F16C, NEON; chosen at compile time) cover the swizzles, 8-bit,
+// half, 10:10:10:2 and the decoding of 11:11:10; the rest of the work is scalar.
+void ConvertPixels(const void* source, PixelFormat sourceFormat, void* dest, PixelFormat destFormat, size_t pixelCount, uint32_t flags = 0);
+
+// Converts a rectangle of rows, for writing a texture into a footprint of an upload buffer.
+void ConvertPixelRows(
+    const void* source,
+    size_t sourceRowPitch,
+    PixelFormat sourceFormat,
+    void* dest,
+    size_t destRowPitch,
+    PixelFormat destFormat,
+    uint32_t width,
+    uint32_t height,
+    uint32_t flags = 0);
+
+// Straightforward scalar version of ConvertPixels, in double precision, that the kernels are
+// checked against. The kernels work in single precision (and encode sRGB into 8 bits with a
+// table), so a value next to a rounding boundary can come out one step off; nothing else differs.
+void ConvertPixelsReference(const void* source, PixelFormat sourceFormat, void* dest, PixelFormat destFormat, size_t pixelCount, uint32_t flags = 0);
+
+// The instruction set the kernels were compiled for: "avx2", "sse2", "neon" or "scalar".
+const char* GetPixelConversionIsa();
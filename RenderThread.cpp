@@ -0,0 +1,157 @@
+#include "RenderThread.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    uint64_t PackSize(uint32_t width, uint32_t height)
+    {
+        return static_cast<uint64_t>(width) << 32 | height;
+    }
+
+    bool IsPaused(uint64_t size)
+    {
+        return static_cast<uint32_t>(size >> 32) == 0 || static_cast<uint32_t>(size) == 0;
+    }
+}
+
+RenderThread::RenderThread() :
+    m_size(0),
+    m_stopRequested(false),
+    m_sleeping(false),
+    m_frames(0),
+    m_droppedEvents(0),
+    m_appliedSize(0)
+{
+}
+
+RenderThread::~RenderThread()
+{
+    if (m_thread.joinable())
+    {
+        RequestStop();
+        m_thread.join();
+    }
+}
+
+void RenderThread::Start(RenderThreadHandlers handlers, uint32_t width, uint32_t height)
+{
+    if (m_thread.joinable())
+    {
+        throw std::logic_error("RenderThread: already started.");
+    }
+
+    m_handlers = std::move(handlers);
+    m_appliedSize = PackSize(width, height);
+    // A size posted before Start (the window being shown) still counts: it is compared with the
+    // starting size on the first frame.
+    uint64_t expected = 0;
+    m_size.compare_exchange_strong(expected, m_appliedSize);
+    m_thread = std::thread(&RenderThread::Run, this);
+}
+
+bool RenderThread::PostEvent(const WindowEvent& event)
+{
+    if (!m_events.TryPush(event))
+    {
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    Wake();
+    return true;
+}
+
+void RenderThread::PostResize(uint32_t width, uint32_t height)
+{
+    m_size.store(PackSize(width, height));
+    Wake();
+}
+
+void RenderThread::RequestStop()
+{
+    m_stopRequested.store(true);
+    Wake();
+}
+
+std::exception_ptr RenderThread::Join()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    std::exception_ptr error = m_error;
+    m_error = nullptr;
+    return error;
+}
+
+// The render thread only sleeps while paused, and only after saying so: a poster that published
+// before seeing m_sleeping set is seen by the check under the lock, and one that sees it set
+// notifies under the lock, after the thread is waiting.
+void RenderThread::Wake()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+}
+
+bool RenderThread::HasWork() const
+{
+    return m_stopRequested.load() || !m_events.Empty() || m_size.load() != m_appliedSize;
+}
+
+void RenderThread::Run()
+{
+    try
+    {
+        while (!m_stopRequested.load())
+        {
+            WindowEvent event;
+            while (m_events.TryPop(event))
+            {
+                m_handlers.Event(event);
+            }
+
+            const uint64_t size = m_size.load();
+            if (size != m_appliedSize)
+            {
+                m_appliedSize = size;
+                m_handlers.Resize(static_cast<uint32_t>(size >> 32), static_cast<uint32_t>(size));
+            }
+
+            if (IsPaused(m_appliedSize))
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_sleeping.store(true);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                m_wake.wait(lock, [this]() { return HasWork(); });
+                m_sleeping.store(false);
+                continue;
+            }
+
+            m_handlers.Frame();
+            m_frames.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    catch (...)
+    {
+        m_error = std::current_exception();
+    }
+
+    // Also after a failed frame. What Shutdown throws is only kept when nothing failed before.
+    try
+    {
+        m_handlers.Shutdown();
+    }
+    catch (...)
+    {
+        if (!m_error)
+        {
+            m_error = std::current_exception();
+        }
+    }
+    m_handlers.Exited();
+}
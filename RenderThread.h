@@ -0,0 +1,101 @@
+#pragma once
+
+#include "SpscRing.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+enum class WindowEventType : uint8_t
+{
+    KeyDown,
+    KeyUp,
+};
+
+struct WindowEvent
+{
+    WindowEventType Type;
+    uint32_t Value;             // The key.
+};
+
+// What the render thread calls. All run on the render thread, in this order for a frame: the
+// events posted since the last frame, Resize if the size changed, then Frame.
+struct RenderThreadHandlers
+{
+    std::function<void(const WindowEvent&)> Event;
+    // The latest size the window thread posted; sizes posted in between are skipped. A size of
+    // zero (a minimized window) pauses the frames until the next non-zero one.
+    std::function<void(uint32_t width, uint32_t height)> Resize;
+    std::function<void()> Frame;
+    // After the last frame, once a stop was requested or a handler threw: the GPU still has to be
+    // flushed before what it uses is released.
+    std::function<void()> Shutdown;
+    // The very last call, always. Must not throw.
+    std::function<void()> Exited;
+};
+
+// Runs the frames on a thread of their own, so that the thread pumping the window's messages
+// never waits on rendering, nor rendering on the messages.
+//
+// Handoff with the window thread:
+// - Input goes through a lock-free SPSC ring. When it is full the event is dropped and counted:
+//   the window thread must never block, since the render thread may itself be waiting on it
+//   (SetWindowText sends a message to the window's thread).
+// - Resizes are state, not events: the window thread publishes the latest size in an atomic and
+//   the render thread applies it between frames.
+// - RequestStop asks for a stop; the render thread finishes its frame, calls Shutdown then
+//   Exited. The window thread keeps pumping messages until Exited tells it so, then calls Join.
+// - When a handler throws (a lost device, for one), the thread stops, still calls Shutdown then
+//   Exited, and Join returns the exception for the window thread to report.
+//
+// Usage: Start once, post from one thread, Join from that thread.
+class RenderThread
+{
+public:
+    static const size_t EventCapacity = 256;
+
+    RenderThread();
+    // Requests a stop and joins, discarding the thread's exception, if Join wasn't called.
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // width, height: the size the frames start at; Resize is only called when it changes.
+    void Start(RenderThreadHandlers handlers, uint32_t width, uint32_t height);
+
+    // Window thread. Returns false if the ring was full and the event was dropped.
+    bool PostEvent(const WindowEvent& event);
+    void PostResize(uint32_t width, uint32_t height);
+    void RequestStop();
+
+    // Waits for the thread to end and returns what ended it: the first exception a handler threw,
+    // or null after a requested stop. An exception is only returned once.
+    std::exception_ptr Join();
+
+    bool IsRunning() const { return m_thread.joinable(); }
+    uint64_t GetFrameCount() const { return m_frames.load(std::memory_order_relaxed); }
+    uint64_t GetDroppedEventCount() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+
+private:
+    void Run();
+    void Wake();
+    bool HasWork() const;
+
+    SpscRing<WindowEvent, EventCapacity> m_events;
+    std::atomic<uint64_t> m_size;               // Width << 32 | height, as last posted.
+    std::atomic<bool> m_stopRequested;
+    std::atomic<bool> m_sleeping;
+    std::atomic<uint64_t> m_frames;
+    std::atomic<uint64_t> m_droppedEvents;
+    std::mutex m_mutex;                         // Only to sleep while paused.
+    std::condition_variable m_wake;
+    RenderThreadHandlers m_handlers;
+    uint64_t m_appliedSize;                     // Render thread only.
+    std::exception_ptr m_error;                 // Read by Join, after the thread has ended.
+    std::thread m_thread;
+};
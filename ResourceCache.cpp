@@ -0,0 +1,243 @@
+#include "ResourceCache.h"
+#include "ContentHash.h"
+#include "TimelineFence.h"
+
+#include <stdexcept>
+
+ResourceKey MakeTextureKey(const void* data, size_t size, uint32_t format, uint32_t width, uint32_t height, uint16_t depthOrArraySize, uint16_t mipLevels)
+{
+    ResourceKey key;
+    key.ContentHash = HashContent(data, size);
+    key.ContentSize = size;
+    key.Format = format;
+    key.Width = width;
+    key.Height = height;
+    key.DepthOrArraySize = depthOrArraySize;
+    key.MipLevels = mipLevels;
+    return key;
+}
+
+ResourceKey MakeBufferKey(const void* data, size_t size)
+{
+    return MakeTextureKey(data, size, 0, 0, 0, 0, 0);
+}
+
+ResourceCache::ResourceCache(DeferredReleaseQueue& releaseQueue, ReleaseFunction release, uint32_t descriptorCapacity) :
+    m_releaseQueue(releaseQueue),
+    m_release(release)
+{
+    // Popped from the back, so the lowest slots are handed out first.
+    m_freeDescriptors.reserve(descriptorCapacity);
+    for (uint32_t descriptor = descriptorCapacity; descriptor > 0; --descriptor)
+    {
+        m_freeDescriptors.push_back(descriptor - 1);
+    }
+}
+
+ResourceCache::~ResourceCache()
+{
+    for (Entry& entry : m_entries)
+    {
+        if (entry.Resource)
+        {
+            m_release(entry.Resource);
+        }
+    }
+}
+
+ResourceCache::Entry& ResourceCache::GetEntry(ResourceHandle handle)
+{
+    if (handle == InvalidResource || handle > m_entries.size() || !m_entries[handle - 1].Resource)
+    {
+        throw std::out_of_range("Unknown resource handle.");
+    }
+    return m_entries[handle - 1];
+}
+
+const ResourceCache::Entry& ResourceCache::GetEntry(ResourceHandle handle) const
+{
+    if (handle == InvalidResource || handle > m_entries.size() || !m_entries[handle - 1].Resource)
+    {
+        throw std::out_of_range("Unknown resource handle.");
+    }
+    return m_entries[handle - 1];
+}
+
+ResourceHandle ResourceCache::Acquire(const ResourceKey& key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.Lookups;
+
+    const auto found = m_handles.find(key);
+    if (found == m_handles.end())
+    {
+        return InvalidResource;
+    }
+
+    Entry& entry = m_entries[found->second - 1];
+    if (entry.References++ == 0)
+    {
+        m_unreferenced.erase(entry.Unreferenced);
+        m_stats.UnreferencedBytes -= entry.Bytes;
+    }
+    ++m_stats.Hits;
+    m_stats.SavedBytes += entry.Bytes;
+    return found->second;
+}
+
+ResourceHandle ResourceCache::Insert(const ResourceKey& key, void* resource, uint64_t bytes, bool* inserted,
+    const std::function<void(uint32_t descriptor)>& initialize)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    const auto found = m_handles.find(key);
+    if (found != m_handles.end())
+    {
+        Entry& entry = m_entries[found->second - 1];
+        if (entry.References++ == 0)
+        {
+            m_unreferenced.erase(entry.Unreferenced);
+            m_stats.UnreferencedBytes -= entry.Bytes;
+        }
+        ++m_stats.Duplicates;
+        lock.unlock();
+
+        // Never handed out, so the GPU has not seen it.
+        m_release(resource);
+        if (inserted)
+        {
+            *inserted = false;
+        }
+        return found->second;
+    }
+
+    if (m_freeDescriptors.empty())
+    {
+        if (m_unreferenced.empty())
+        {
+            lock.unlock();
+            m_release(resource);
+            throw std::runtime_error("ResourceCache: out of descriptor slots.");
+        }
+        Evict(m_unreferenced.front());
+    }
+
+    const uint32_t descriptor = m_freeDescriptors.back();
+    if (initialize)
+    {
+        initialize(descriptor);
+    }
+    m_freeDescriptors.pop_back();
+
+    ResourceHandle handle;
+    if (!m_freeHandles.empty())
+    {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+    else
+    {
+        m_entries.push_back(Entry());
+        handle = static_cast<ResourceHandle>(m_entries.size());
+    }
+
+    Entry& entry = m_entries[handle - 1];
+    entry.Key = key;
+    entry.Resource = resource;
+    entry.Bytes = bytes;
+    entry.Descriptor = descriptor;
+    entry.References = 1;
+    entry.LastUseTimeline = nullptr;
+    entry.LastUse = 0;
+    m_handles.emplace(key, handle);
+
+    ++m_stats.Inserts;
+    ++m_stats.LiveCount;
+    m_stats.LiveBytes += bytes;
+    if (inserted)
+    {
+        *inserted = true;
+    }
+    return handle;
+}
+
+void ResourceCache::Release(ResourceHandle handle, TimelineFence& timeline, uint64_t lastUse)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = GetEntry(handle);
+    if (entry.References == 0)
+    {
+        throw std::logic_error("ResourceCache: released more often than acquired.");
+    }
+
+    if (entry.LastUseTimeline != &timeline || lastUse > entry.LastUse)
+    {
+        entry.LastUseTimeline = &timeline;
+        entry.LastUse = lastUse;
+    }
+    if (--entry.References == 0)
+    {
+        entry.Unreferenced = m_unreferenced.insert(m_unreferenced.end(), handle);
+        m_stats.UnreferencedBytes += entry.Bytes;
+    }
+}
+
+void ResourceCache::Evict(ResourceHandle handle)
+{
+    Entry& entry = m_entries[handle - 1];
+    if (entry.LastUseTimeline)
+    {
+        m_releaseQueue.Release(*entry.LastUseTimeline, entry.LastUse, entry.Resource, m_release);
+    }
+    else
+    {
+        m_release(entry.Resource);
+    }
+
+    m_unreferenced.erase(entry.Unreferenced);
+    m_handles.erase(entry.Key);
+    m_freeDescriptors.push_back(entry.Descriptor);
+    m_freeHandles.push_back(handle);
+
+    ++m_stats.Evictions;
+    --m_stats.LiveCount;
+    m_stats.LiveBytes -= entry.Bytes;
+    m_stats.UnreferencedBytes -= entry.Bytes;
+    entry.Resource = nullptr;
+}
+
+size_t ResourceCache::Trim(uint64_t maxUnreferencedBytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t evicted = 0;
+    while (m_stats.UnreferencedBytes > maxUnreferencedBytes)
+    {
+        Evict(m_unreferenced.front());
+        ++evicted;
+    }
+    return evicted;
+}
+
+void* ResourceCache::GetResource(ResourceHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return GetEntry(handle).Resource;
+}
+
+uint32_t ResourceCache::GetDescriptor(ResourceHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return GetEntry(handle).Descriptor;
+}
+
+ResourceKey ResourceCache::GetKey(ResourceHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return GetEntry(handle).Key;
+}
+
+ResourceCacheStats ResourceCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
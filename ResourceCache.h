@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class DeferredReleaseQueue;
+class TimelineFence;
+
+// Handle of a cached resource. 0 is never returned.
+typedef uint32_t ResourceHandle;
+static const ResourceHandle InvalidResource = 0;
+
+// What makes two resources interchangeable: the hash of the content they are created from and
+// the description it is interpreted with. Two loads of the same file, or two meshes baked from
+// the same source, get the same key; the same bytes as a different format or shape do not.
+struct ResourceKey
+{
+    uint64_t ContentHash;
+    uint64_t ContentSize;       // Bytes the hash was computed over.
+    uint32_t Format;            // DXGI_FORMAT of a texture; 0 for buffers.
+    uint32_t Width;             // Texture width; 0 for buffers.
+    uint32_t Height;
+    uint16_t DepthOrArraySize;
+    uint16_t MipLevels;
+
+    bool operator==(const ResourceKey& other) const
+    {
+        return ContentHash == other.ContentHash && ContentSize == other.ContentSize && Format == other.Format
+            && Width == other.Width && Height == other.Height && DepthOrArraySize == other.DepthOrArraySize
+            && MipLevels == other.MipLevels;
+    }
+};
+
+// Keys from the bytes a resource is created from (HashContent).
+ResourceKey MakeTextureKey(const void* data, size_t size, uint32_t format, uint32_t width, uint32_t height, uint16_t depthOrArraySize = 1, uint16_t mipLevels = 1);
+ResourceKey MakeBufferKey(const void* data, size_t size);
+
+struct ResourceCacheStats
+{
+    uint64_t Lookups = 0;
+    uint64_t Hits = 0;
+    uint64_t Inserts = 0;
+    uint64_t Duplicates = 0;            // Inserts of a key that was added meanwhile by another load.
+    uint64_t Evictions = 0;
+    uint64_t SavedBytes = 0;            // Resource bytes the hits did not have to create again.
+    uint64_t LiveCount = 0;
+    uint64_t LiveBytes = 0;
+    uint64_t UnreferencedBytes = 0;     // Part of LiveBytes nothing refers to, kept for reuse.
+};
+
+// Shares GPU resources between everything that loads the same content: a texture used by ten
+// materials, a mesh placed by three levels, is created and uploaded once.
+//
+// Entries are reference counted. A caller asks for its key first; on a miss it creates the
+// resource itself and adds it. Releasing the last reference does not destroy the resource: it
+// stays in the cache, remembering the timeline value after its last use, so the next load of the
+// same content is a hit. Trim evicts the least recently released unreferenced entries through the
+// deferred release queue with that value, so nothing the GPU may still read is freed early and
+// nothing has to wait for the GPU.
+// Each entry also owns a slot in a fixed range of descriptor indices, for the API layer to keep a
+// shared view of the resource in (see D3D12ResourceCache).
+// Thread-safe. The resource pointers are opaque; the release function destroys one.
+class ResourceCache
+{
+public:
+    typedef void (*ReleaseFunction)(void* resource);
+
+    ResourceCache(DeferredReleaseQueue& releaseQueue, ReleaseFunction release, uint32_t descriptorCapacity);
+    // Releases every resource right away, referenced or not: the owner must have waited for the
+    // GPU, as for DeferredReleaseQueue.
+    ~ResourceCache();
+
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    // A new reference to the resource of key, or InvalidResource on a miss.
+    ResourceHandle Acquire(const ResourceKey& key);
+
+    // Adds a resource created after a miss, taking over the caller's reference to it, and returns
+    // the first reference. If another load added the key in the meantime, that entry is returned
+    // instead, resource is released and *inserted is false. bytes is the GPU memory the resource
+    // takes. Frees unreferenced entries when no descriptor slot is left; throws std::runtime_error
+    // if every slot is referenced. initialize, if set, fills the descriptor slot before any other
+    // thread can acquire the entry (it runs with the cache locked).
+    ResourceHandle Insert(const ResourceKey& key, void* resource, uint64_t bytes, bool* inserted = nullptr,
+        const std::function<void(uint32_t descriptor)>& initialize = nullptr);
+
+    // Drops one reference. lastUse is the value of timeline signaled after the last GPU work of
+    // the releasing owner that used the resource. The entry remembers the latest value; an entry
+    // shared across timelines keeps the last one released, as for DeferredReleaseQueue.
+    void Release(ResourceHandle handle, TimelineFence& timeline, uint64_t lastUse);
+
+    // Evicts unreferenced entries, least recently released first, until the unreferenced entries
+    // take at most maxUnreferencedBytes. Returns how many were evicted.
+    size_t Trim(uint64_t maxUnreferencedBytes);
+
+    // A handle is valid from Acquire or Insert until its Release.
+    void* GetResource(ResourceHandle handle) const;
+    uint32_t GetDescriptor(ResourceHandle handle) const;
+    ResourceKey GetKey(ResourceHandle handle) const;
+
+    ResourceCacheStats GetStats() const;
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const ResourceKey& key) const { return static_cast<size_t>(key.ContentHash); }
+    };
+
+    struct Entry
+    {
+        ResourceKey Key;
+        void* Resource;                 // nullptr: free entry.
+        uint64_t Bytes;
+        uint32_t Descriptor;
+        uint32_t References;
+        TimelineFence* LastUseTimeline; // nullptr: never released, so never used on the GPU.
+        uint64_t LastUse;
+        std::list<ResourceHandle>::iterator Unreferenced;
+    };
+
+    Entry& GetEntry(ResourceHandle handle);
+    const Entry& GetEntry(ResourceHandle handle) const;
+    void Evict(ResourceHandle handle);
+
+    DeferredReleaseQueue& m_releaseQueue;
+    ReleaseFunction m_release;
+
+    mutable std::mutex m_mutex;
+    std::vector<Entry> m_entries;                                   // By handle - 1.
+    std::vector<ResourceHandle> m_freeHandles;
+    std::vector<uint32_t> m_freeDescriptors;
+    std::unordered_map<ResourceKey, ResourceHandle, KeyHash> m_handles;
+    std::list<ResourceHandle> m_unreferenced;                       // Least recently released first.
+    ResourceCacheStats m_stats;
+};
@@ -0,0 +1,303 @@
+#include "SpriteBatch.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SPRITE_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SPRITE_NEON 1
+#endif
+
+namespace
+{
+    // Sprites a job expands: 64 KB of vertices.
+    const size_t JobSprites = 1024;
+
+    const uint32_t LowHalf = 0x0000ffff;
+
+    // The texture corners of a sprite's vertices, in vertex order.
+    inline uint32_t TopRightUv(uint32_t uvMin, uint32_t uvMax) { return (uvMax & LowHalf) | (uvMin & ~LowHalf); }
+    inline uint32_t BottomLeftUv(uint32_t uvMin, uint32_t uvMax) { return (uvMin & LowHalf) | (uvMax & ~LowHalf); }
+
+    void ExpandSprite(const Sprite& sprite, float sine, float cosine, SpriteVertex* vertices)
+    {
+        // Half the rotated X axis (a) and Y axis (b) of the sprite.
+        const float ax = 0.5f * sprite.Width * cosine;
+        const float ay = 0.5f * sprite.Width * sine;
+        const float bx = -0.5f * sprite.Height * sine;
+        const float by = 0.5f * sprite.Height * cosine;
+
+        vertices[0] = { sprite.X - ax - bx, sprite.Y - ay - by, sprite.UvMin, sprite.Color };
+        vertices[1] = { sprite.X + ax - bx, sprite.Y + ay - by, TopRightUv(sprite.UvMin, sprite.UvMax), sprite.Color };
+        vertices[2] = { sprite.X - ax + bx, sprite.Y - ay + by, BottomLeftUv(sprite.UvMin, sprite.UvMax), sprite.Color };
+        vertices[3] = { sprite.X + ax + bx, sprite.Y + ay + by, sprite.UvMax, sprite.Color };
+    }
+
+#if SPRITE_SSE2 || SPRITE_NEON
+    // The few operations the kernel needs, on four floats (or their bits).
+#if SPRITE_SSE2
+    typedef __m128 Vector;
+
+    inline Vector Load(const float* p) { return _mm_loadu_ps(p); }
+    inline Vector Splat(float value) { return _mm_set1_ps(value); }
+    inline Vector SplatBits(uint32_t bits) { return _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(bits))); }
+    inline Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    inline Vector Sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    inline Vector Mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+    inline Vector And(Vector a, Vector b) { return _mm_and_ps(a, b); }
+    inline Vector Or(Vector a, Vector b) { return _mm_or_ps(a, b); }
+    inline Vector Xor(Vector a, Vector b) { return _mm_xor_ps(a, b); }
+    inline Vector LessEqual(Vector a, Vector b) { return _mm_cmple_ps(a, b); }
+    inline Vector Select(Vector mask, Vector a, Vector b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    inline Vector Round(Vector a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+
+    inline void Transpose(Vector& r0, Vector& r1, Vector& r2, Vector& r3)
+    {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+
+    // Bypasses the cache: the vertices are for the GPU, often in write-combined memory.
+    inline void StoreStream(SpriteVertex* p, Vector a) { _mm_stream_ps(reinterpret_cast<float*>(p), a); }
+    inline void EndStores() { _mm_sfence(); }
+#else
+    typedef float32x4_t Vector;
+
+    inline Vector Load(const float* p) { return vld1q_f32(p); }
+    inline Vector Splat(float value) { return vdupq_n_f32(value); }
+    inline Vector SplatBits(uint32_t bits) { return vreinterpretq_f32_u32(vdupq_n_u32(bits)); }
+    inline Vector Add(Vector a, Vector b) { return vaddq_f32(a, b); }
+    inline Vector Sub(Vector a, Vector b) { return vsubq_f32(a, b); }
+    inline Vector Mul(Vector a, Vector b) { return vmulq_f32(a, b); }
+    inline Vector And(Vector a, Vector b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    inline Vector Or(Vector a, Vector b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    inline Vector Xor(Vector a, Vector b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    inline Vector LessEqual(Vector a, Vector b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+    inline Vector Select(Vector mask, Vector a, Vector b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+    inline Vector Round(Vector a) { return vrndnq_f32(a); }
+
+    inline void Transpose(Vector& r0, Vector& r1, Vector& r2, Vector& r3)
+    {
+        const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+    inline void StoreStream(SpriteVertex* p, Vector a) { vst1q_f32(reinterpret_cast<float*>(p), a); }
+    inline void EndStores() {}
+#endif
+
+    // Sine and cosine of four angles: reduced to [-pi, pi], then to [-pi/2, pi/2] by
+    // sin(x) = sin(pi - x), and odd and even minimax polynomials (as in DirectXMath's
+    // XMVectorSinCos; error about 1e-7).
+    inline void SinCos(Vector angle, Vector& sine, Vector& cosine)
+    {
+        const float Pi = 3.141592654f;
+        const Vector signBit = SplatBits(0x80000000);
+
+        Vector x = Sub(angle, Mul(Round(Mul(angle, Splat(0.5f / Pi))), Splat(2.0f * Pi)));
+        const Vector sign = And(x, signBit);
+        const Vector reflected = Sub(Or(Splat(Pi), sign), x);
+        const Vector inRange = LessEqual(Xor(x, sign), Splat(0.5f * Pi));
+        x = Select(inRange, x, reflected);
+        const Vector cosineSign = Select(inRange, Splat(1.0f), Splat(-1.0f));
+
+        const Vector x2 = Mul(x, x);
+        Vector s = Add(Mul(Splat(-2.3889859e-08f), x2), Splat(2.7525562e-06f));
+        s = Add(Mul(s, x2), Splat(-0.00019840874f));
+        s = Add(Mul(s, x2), Splat(0.0083333310f));
+        s = Add(Mul(s, x2), Splat(-0.16666667f));
+        s = Add(Mul(s, x2), Splat(1.0f));
+        sine = Mul(s, x);
+
+        Vector c = Add(Mul(Splat(-2.6051615e-07f), x2), Splat(2.4760495e-05f));
+        c = Add(Mul(c, x2), Splat(-0.0013888378f));
+        c = Add(Mul(c, x2), Splat(0.041666638f));
+        c = Add(Mul(c, x2), Splat(-0.5f));
+        c = Add(Mul(c, x2), Splat(1.0f));
+        cosine = Mul(c, cosineSign);
+    }
+
+    // Four sprites, one per lane: the records are transposed into a vector per field, the four
+    // corners computed for all sprites at once, and each corner transposed back into the four
+    // sprites' vertices.
+    inline void ExpandFour(const Sprite* sprites, SpriteVertex* vertices)
+    {
+        Vector x = Load(&sprites[0].X);
+        Vector y = Load(&sprites[1].X);
+        Vector width = Load(&sprites[2].X);
+        Vector height = Load(&sprites[3].X);
+        Transpose(x, y, width, height);
+        Vector rotation = Load(&sprites[0].Rotation);
+        Vector color = Load(&sprites[1].Rotation);
+        Vector uvMin = Load(&sprites[2].Rotation);
+        Vector uvMax = Load(&sprites[3].Rotation);
+        Transpose(rotation, color, uvMin, uvMax);
+
+        Vector sine;
+        Vector cosine;
+        SinCos(rotation, sine, cosine);
+        const Vector halfWidth = Mul(width, Splat(0.5f));
+        const Vector halfHeight = Mul(height, Splat(0.5f));
+        const Vector ax = Mul(halfWidth, cosine);
+        const Vector ay = Mul(halfWidth, sine);
+        const Vector bx = Sub(Splat(0.0f), Mul(halfHeight, sine));
+        const Vector by = Mul(halfHeight, cosine);
+
+        const Vector lowHalf = SplatBits(LowHalf);
+        const Vector corners[4][3] =
+        {
+            { Sub(Sub(x, ax), bx), Sub(Sub(y, ay), by), uvMin },
+            { Sub(Add(x, ax), bx), Sub(Add(y, ay), by), Select(lowHalf, uvMax, uvMin) },
+            { Add(Sub(x, ax), bx), Add(Sub(y, ay), by), Select(lowHalf, uvMin, uvMax) },
+            { Add(Add(x, ax), bx), Add(Add(y, ay), by), uvMax },
+        };
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            Vector v0 = corners[corner][0];
+            Vector v1 = corners[corner][1];
+            Vector v2 = corners[corner][2];
+            Vector v3 = color;
+            Transpose(v0, v1, v2, v3);
+            StoreStream(vertices + corner, v0);
+            StoreStream(vertices + 4 + corner, v1);
+            StoreStream(vertices + 8 + corner, v2);
+            StoreStream(vertices + 12 + corner, v3);
+        }
+    }
+#endif
+}
+
+SpriteBatch::SpriteBatch() :
+    m_spriteCount(0)
+{
+}
+
+void SpriteBatch::Begin()
+{
+    m_runs.clear();
+    m_ranges.clear();
+    m_spriteCount = 0;
+}
+
+void SpriteBatch::Draw(uint32_t texture, const Sprite* sprites, size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    // Sprites that continue the last run, from the same array, extend it.
+    if (!m_runs.empty() && m_runs.back().Texture == texture && m_runs.back().Sprites + m_runs.back().Count == sprites)
+    {
+        m_runs.back().Count += count;
+    }
+    else
+    {
+        m_runs.push_back(Run{ texture, sprites, count });
+    }
+    m_spriteCount += count;
+}
+
+void SpriteBatch::End(SpriteVertex* vertices, bool sortByTexture, ThreadPool* pool)
+{
+    if (reinterpret_cast<uintptr_t>(vertices) % 16 != 0)
+    {
+        throw std::invalid_argument("SpriteBatch: vertices must be 16-byte aligned.");
+    }
+    if (sortByTexture)
+    {
+        std::stable_sort(m_runs.begin(), m_runs.end(), [](const Run& a, const Run& b) { return a.Texture < b.Texture; });
+    }
+
+    // One range per texture change, and the runs cut into jobs.
+    m_jobs.clear();
+    size_t quad = 0;
+    for (const Run& run : m_runs)
+    {
+        if (m_ranges.empty() || m_ranges.back().Texture != run.Texture)
+        {
+            m_ranges.push_back(SpriteBatchRange{ run.Texture, static_cast<uint32_t>(quad), 0 });
+        }
+        m_ranges.back().QuadCount += static_cast<uint32_t>(run.Count);
+
+        for (size_t first = 0; first < run.Count; first += JobSprites)
+        {
+            m_jobs.push_back(Job{ run.Sprites + first, std::min(JobSprites, run.Count - first), quad + first });
+        }
+        quad += run.Count;
+    }
+
+    const auto expand = [this, vertices](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Job& job = m_jobs[i];
+            ExpandSprites(job.Sprites, job.Count, vertices + 4 * job.FirstQuad);
+        }
+    };
+    if (pool && m_jobs.size() > 1)
+    {
+        pool->ParallelFor(m_jobs.size(), 1, expand);
+    }
+    else
+    {
+        expand(0, m_jobs.size());
+    }
+}
+
+void BuildSpriteIndices(uint16_t* indices)
+{
+    for (uint32_t quad = 0; quad < SpriteBatch::MaxSpritesPerDraw; ++quad)
+    {
+        const uint16_t first = static_cast<uint16_t>(quad * 4);
+        uint16_t* const triangles = indices + quad * 6;
+        triangles[0] = first;
+        triangles[1] = first + 1;
+        triangles[2] = first + 2;
+        triangles[3] = first + 2;
+        triangles[4] = first + 1;
+        triangles[5] = first + 3;
+    }
+}
+
+void ExpandSprites(const Sprite* sprites, size_t count, SpriteVertex* vertices)
+{
+    size_t i = 0;
+#if SPRITE_SSE2 || SPRITE_NEON
+    for (; i + 4 <= count; i += 4)
+    {
+        ExpandFour(sprites + i, vertices + 4 * i);
+    }
+    EndStores();
+#endif
+    for (; i < count; ++i)
+    {
+        ExpandSprite(sprites[i], std::sin(sprites[i].Rotation), std::cos(sprites[i].Rotation), vertices + 4 * i);
+    }
+}
+
+void ExpandSpritesReference(const Sprite* sprites, size_t count, SpriteVertex* vertices)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        ExpandSprite(sprites[i], std::sin(sprites[i].Rotation), std::cos(sprites[i].Rotation), vertices + 4 * i);
+    }
+}
+
+const char* GetSpriteBatchIsa()
+{
+#if SPRITE_SSE2
+    return "sse2";
+#elif SPRITE_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// A textured, tinted, rotated rectangle. 32 bytes, two vector loads.
+struct Sprite
+{
+    float X;                // Center, in pixels.
+    float Y;
+    float Width;
+    float Height;
+    float Rotation;         // Radians; positive turns the X axis towards the Y axis.
+    uint32_t Color;         // RGBA8, R in the low byte, multiplied with the texel.
+    uint32_t UvMin;         // Texture rectangle corners: two UNORM16 each, U in the low half.
+    uint32_t UvMax;
+};
+static_assert(sizeof(Sprite) == 32, "Sprite records are loaded as two 16 byte vectors.");
+
+// What a sprite expands into, four per sprite: top left, top right, bottom left, bottom right.
+// 16 bytes, one vector store.
+struct SpriteVertex
+{
+    float X;                // Pixels (DXGI_FORMAT_R32G32_FLOAT).
+    float Y;
+    uint32_t Uv;            // DXGI_FORMAT_R16G16_UNORM.
+    uint32_t Color;         // DXGI_FORMAT_R8G8B8A8_UNORM.
+};
+static_assert(sizeof(SpriteVertex) == 16, "Sprite vertices are written as one 16 byte vector.");
+
+// Sprites of one texture whose vertices are contiguous: quad i of the batch is vertices
+// 4 * (FirstQuad + i) to 4 * (FirstQuad + i) + 3.
+struct SpriteBatchRange
+{
+    uint32_t Texture;
+    uint32_t FirstQuad;
+    uint32_t QuadCount;
+};
+
+// Turns sprite records into quads for one shared, static index buffer.
+//
+// Draw queues runs of sprites by texture; End expands them all into vertices, splitting the work
+// across the thread pool, and lists the ranges to draw, one per texture change. With sorting,
+// runs of the same texture are grouped (keeping their order otherwise), for sprites that don't
+// depend on draw order; without it, the ranges follow the Draw calls. The vertices are written
+// front to back with non-temporal stores and never read, so they can go straight into a mapped
+// upload heap.
+// Every range is drawn with the indices of BuildSpriteIndices: 16-bit, at most
+// MaxSpritesPerDraw quads per draw, the range's vertices reached through the base vertex.
+// Vector kernels (SSE2, NEON; chosen at compile time) expand four sprites at a time, with a
+// polynomial sine and cosine.
+// The sprite records must stay valid until End. Not thread-safe.
+class SpriteBatch
+{
+public:
+    static const uint32_t MaxSpritesPerDraw = 16384;   // 65536 vertices, the reach of 16-bit indices.
+
+    SpriteBatch();
+
+    void Begin();
+    void Draw(uint32_t texture, const Sprite* sprites, size_t count);
+
+    // Writes 4 * GetSpriteCount() vertices to vertices, 16-byte aligned (throws
+    // std::invalid_argument otherwise), and fills the ranges.
+    void End(SpriteVertex* vertices, bool sortByTexture, ThreadPool* pool = nullptr);
+
+    size_t GetSpriteCount() const { return m_spriteCount; }
+    const std::vector<SpriteBatchRange>& GetRanges() const { return m_ranges; }
+
+private:
+    struct Run
+    {
+        uint32_t Texture;
+        const Sprite* Sprites;
+        size_t Count;
+    };
+
+    // A piece of a run, what one job expands.
+    struct Job
+    {
+        const Sprite* Sprites;
+        size_t Count;
+        size_t FirstQuad;
+    };
+
+    std::vector<Run> m_runs;
+    std::vector<Job> m_jobs;
+    std::vector<SpriteBatchRange> m_ranges;
+    size_t m_spriteCount;
+};
+
+// The index buffer every range is drawn with: MaxSpritesPerDraw quads, two triangles each,
+// 6 * MaxSpritesPerDraw indices. Clockwise, as seen with Y down.
+void BuildSpriteIndices(uint16_t* indices);
+
+// Expands count sprites into 4 * count vertices, 16-byte aligned, on the calling thread.
+void ExpandSprites(const Sprite* sprites, size_t count, SpriteVertex* vertices);
+
+// Scalar version of ExpandSprites, with the standard library's sine and cosine, that the kernels
+// are checked against. Positions differ by less than 1e-4 of the sprite size (the angles are
+// reduced in single precision).
+void ExpandSpritesReference(const Sprite* sprites, size_t count, SpriteVertex* vertices);
+
+// The instruction set the kernels were compiled for: "sse2", "neon" or "scalar".
+const char* GetSpriteBatchIsa();
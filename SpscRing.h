@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// A bounded single-producer, single-consumer queue without locks: one thread pushes, another
+// pops, and neither ever waits on the other. Capacity is a power of two.
+//
+// The producer only writes the tail and the consumer only the head, each on a cache line of its
+// own. Each side keeps a copy of the other's index and reads the shared one only when its copy
+// says the ring is full (or empty), so the two lines are exchanged once per batch rather than
+// once per element.
+//
+// Usage: TryPush on the producer's thread, TryPop on the consumer's. Empty may be called from
+// either, for a hint.
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscRing: Capacity is a power of two.");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing: elements are copied in and out.");
+
+public:
+    static const size_t CacheLineSize = 64;
+
+    SpscRing() : m_tail(0), m_cachedHead(0), m_head(0), m_cachedTail(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer. Returns false, and drops nothing, if the ring is full.
+    bool TryPush(const T& value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity)
+            {
+                return false;
+            }
+        }
+        m_items[tail & (Capacity - 1)] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer. Returns false if the ring is empty.
+    bool TryPop(T& value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+            {
+                return false;
+            }
+        }
+        value = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    // Producer's line.
+    alignas(CacheLineSize) std::atomic<size_t> m_tail;
+    size_t m_cachedHead;
+    // Consumer's line.
+    alignas(CacheLineSize) std::atomic<size_t> m_head;
+    size_t m_cachedTail;
+    alignas(CacheLineSize) T m_items[Capacity];
+};
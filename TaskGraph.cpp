@@ -0,0 +1,289 @@
+#include "TaskGraph.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+// Shared with the jobs queued on the pool, which may still be waiting for a worker when Run has
+// returned: such a job finds no ready task and leaves without touching the graph.
+struct TaskGraph::State
+{
+    typedef std::priority_queue<TaskId, std::vector<TaskId>, std::greater<TaskId>> ReadyQueue;
+
+    std::mutex Mutex;
+    std::condition_variable Changed;
+    std::vector<uint32_t> Remaining;            // Per task: dependencies not finished yet.
+    std::vector<bool> DependencyFailed;
+    ReadyQueue ReadyAny;
+    ReadyQueue ReadyCaller;
+    size_t Finished = 0;
+    size_t CallerPending = 0;                   // Caller tasks not finished.
+    std::exception_ptr Error;
+    std::chrono::steady_clock::time_point Start;
+
+    uint64_t Now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count();
+    }
+};
+
+namespace
+{
+    bool HasWorkers(ThreadPool* pool)
+    {
+        return pool && pool->GetConcurrency() > 1;
+    }
+}
+
+TaskGraph::TaskGraph(ThreadPool* pool) :
+    m_pool(pool),
+    m_totalNanoseconds(0),
+    m_ran(false)
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+}
+
+TaskId TaskGraph::Add(const char* name, std::function<void()> task, std::initializer_list<TaskId> dependencies, TaskAffinity affinity)
+{
+    if (m_ran)
+    {
+        throw std::invalid_argument("TaskGraph: tasks can't be added once the graph has run.");
+    }
+
+    const TaskId id = static_cast<TaskId>(m_tasks.size());
+    for (const TaskId dependency : dependencies)
+    {
+        if (dependency >= id)
+        {
+            throw std::invalid_argument("TaskGraph: a task can only depend on tasks added before it.");
+        }
+    }
+
+    Task entry;
+    entry.Name = name;
+    entry.Function = std::move(task);
+    entry.Dependencies.assign(dependencies.begin(), dependencies.end());
+    entry.Affinity = affinity;
+    m_tasks.push_back(std::move(entry));
+    for (const TaskId dependency : dependencies)
+    {
+        m_tasks[dependency].Dependents.push_back(id);
+    }
+    return id;
+}
+
+void TaskGraph::Run()
+{
+    if (m_ran)
+    {
+        throw std::invalid_argument("TaskGraph: the graph has already run.");
+    }
+    m_ran = true;
+
+    const size_t count = m_tasks.size();
+    m_timings.assign(count, TaskTiming{ nullptr, 0, 0, 0, false, false });
+    m_gatingDependency.resize(count);
+    auto state = std::make_shared<State>();
+    state->Remaining.resize(count);
+    state->DependencyFailed.assign(count, false);
+    state->Start = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(state->Mutex);
+        size_t readyAny = 0;
+        for (TaskId id = 0; id < count; ++id)
+        {
+            m_timings[id].Name = m_tasks[id].Name;
+            m_gatingDependency[id] = id;
+            state->Remaining[id] = static_cast<uint32_t>(m_tasks[id].Dependencies.size());
+            state->CallerPending += m_tasks[id].Affinity == TaskAffinity::Caller;
+            if (state->Remaining[id] == 0)
+            {
+                if (m_tasks[id].Affinity == TaskAffinity::Caller)
+                {
+                    state->ReadyCaller.push(id);
+                }
+                else
+                {
+                    state->ReadyAny.push(id);
+                    ++readyAny;
+                }
+            }
+        }
+        SubmitJobs(state, readyAny);
+    }
+
+    for (;;)
+    {
+        TaskId id;
+        {
+            std::unique_lock<std::mutex> lock(state->Mutex);
+            state->Changed.wait(lock, [&]() { return state->Finished == count || PopTask(*state, true, id); });
+            if (state->Finished == count)
+            {
+                break;
+            }
+        }
+        Execute(state, id, true);
+    }
+
+    m_totalNanoseconds = state->Now();
+    if (state->Error)
+    {
+        std::rethrow_exception(state->Error);
+    }
+}
+
+bool TaskGraph::PopTask(State& state, bool caller, TaskId& id) const
+{
+    if (caller && !state.ReadyCaller.empty())
+    {
+        id = state.ReadyCaller.top();
+        state.ReadyCaller.pop();
+        return true;
+    }
+    // While Caller tasks remain, the calling thread stays free for them, unless nothing else can
+    // run the others.
+    if (!state.ReadyAny.empty() && (!caller || state.CallerPending == 0 || !HasWorkers(m_pool)))
+    {
+        id = state.ReadyAny.top();
+        state.ReadyAny.pop();
+        return true;
+    }
+    return false;
+}
+
+// Records the end of a task and readies its dependents; those of a failed task are skipped, and
+// so on down the graph. Returns how many Any tasks became ready.
+size_t TaskGraph::Finish(State& state, TaskId finished, bool succeeded)
+{
+    size_t readyAny = 0;
+    std::vector<std::pair<TaskId, bool>> done(1, std::make_pair(finished, succeeded));
+    while (!done.empty())
+    {
+        const TaskId id = done.back().first;
+        const bool ok = done.back().second;
+        done.pop_back();
+
+        ++state.Finished;
+        state.CallerPending -= m_tasks[id].Affinity == TaskAffinity::Caller;
+        for (const TaskId dependent : m_tasks[id].Dependents)
+        {
+            state.DependencyFailed[dependent] = state.DependencyFailed[dependent] || !ok;
+            if (--state.Remaining[dependent] != 0)
+            {
+                continue;
+            }
+
+            m_gatingDependency[dependent] = id;
+            TaskTiming& timing = m_timings[dependent];
+            timing.ReadyNanoseconds = state.Now();
+            if (state.DependencyFailed[dependent])
+            {
+                timing.StartNanoseconds = timing.ReadyNanoseconds;
+                timing.EndNanoseconds = timing.ReadyNanoseconds;
+                done.push_back(std::make_pair(dependent, false));
+            }
+            else if (m_tasks[dependent].Affinity == TaskAffinity::Caller)
+            {
+                state.ReadyCaller.push(dependent);
+            }
+            else
+            {
+                state.ReadyAny.push(dependent);
+                ++readyAny;
+            }
+        }
+    }
+    return readyAny;
+}
+
+// One job per ready Any task. A job runs whichever task is first in line when a worker picks it
+// up; the calling thread may have taken the one it was queued for.
+void TaskGraph::SubmitJobs(const std::shared_ptr<State>& state, size_t count)
+{
+    if (!HasWorkers(m_pool))
+    {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        m_pool->Submit([this, state]()
+        {
+            TaskId id;
+            {
+                std::lock_guard<std::mutex> lock(state->Mutex);
+                if (!PopTask(*state, false, id))
+                {
+                    return;
+                }
+            }
+            Execute(state, id, false);
+        });
+    }
+}
+
+// Once the last task is recorded Run may return and the graph go: nothing is touched after the
+// lock is released.
+void TaskGraph::Execute(const std::shared_ptr<State>& state, TaskId id, bool onCaller)
+{
+    TaskTiming& timing = m_timings[id];
+    timing.OnCaller = onCaller;
+    timing.StartNanoseconds = state->Now();
+    bool succeeded = true;
+    try
+    {
+        m_tasks[id].Function();
+    }
+    catch (...)
+    {
+        succeeded = false;
+        std::lock_guard<std::mutex> lock(state->Mutex);
+        if (!state->Error)
+        {
+            state->Error = std::current_exception();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(state->Mutex);
+    timing.EndNanoseconds = state->Now();
+    timing.Ran = true;
+    SubmitJobs(state, Finish(*state, id, succeeded));
+    state->Changed.notify_all();
+}
+
+std::vector<TaskId> TaskGraph::GetCriticalPath() const
+{
+    std::vector<TaskId> path;
+    if (m_timings.empty())
+    {
+        return path;
+    }
+
+    TaskId last = 0;
+    for (TaskId id = 1; id < m_timings.size(); ++id)
+    {
+        if (m_timings[id].EndNanoseconds > m_timings[last].EndNanoseconds)
+        {
+            last = id;
+        }
+    }
+    for (TaskId id = last;; id = m_gatingDependency[id])
+    {
+        path.push_back(id);
+        if (m_gatingDependency[id] == id)
+        {
+            break;
+        }
+    }
+    return std::vector<TaskId>(path.rbegin(), path.rend());
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+typedef uint32_t TaskId;
+
+enum class TaskAffinity : uint8_t
+{
+    Any,            // A worker of the pool or the calling thread.
+    Caller,         // The thread that calls Run (APIs tied to the window's thread).
+};
+
+struct TaskTiming
+{
+    const char* Name;
+    uint64_t ReadyNanoseconds;      // When its last dependency finished, from the start of Run.
+    uint64_t StartNanoseconds;
+    uint64_t EndNanoseconds;
+    bool Ran;                       // False if skipped after a dependency failed.
+    bool OnCaller;
+};
+
+// Runs a set of tasks, each once the tasks it depends on have finished, so that independent work
+// (loading, compiling, creating objects...) overlaps on the thread pool instead of running one
+// stage after the other.
+//
+// Tasks can only depend on tasks added before them, so the graph has no cycles. Ready tasks run
+// in the order they were added: ties go to the earlier task. The calling thread runs the Caller
+// tasks and, while it has none, helps with the others; with a null pool or no workers, it runs
+// everything, in an order that respects the dependencies.
+//
+// Timings are kept for every task. The critical path is the chain of tasks that made the last one
+// finish when it did: each task on it was waiting for the one before, so it is what to shorten.
+//
+// Usage: Add the tasks, Run once. Not thread-safe; the tasks may call into the pool themselves.
+class TaskGraph
+{
+public:
+    // pool may be null, in which case everything runs on the calling thread.
+    explicit TaskGraph(ThreadPool* pool = nullptr);
+    ~TaskGraph();
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // name must outlive the graph. Throws std::invalid_argument for a dependency that is not an
+    // earlier task, or if the graph has already run.
+    TaskId Add(const char* name, std::function<void()> task, std::initializer_list<TaskId> dependencies = {}, TaskAffinity affinity = TaskAffinity::Any);
+
+    // Runs every task and returns once all have finished. When a task throws, the tasks that
+    // depend on it, directly or not, are skipped, the others still run, and the first exception
+    // is rethrown once everything has stopped.
+    void Run();
+
+    size_t GetTaskCount() const { return m_tasks.size(); }
+    // Valid after Run, by TaskId.
+    const std::vector<TaskTiming>& GetTimings() const { return m_timings; }
+    uint64_t GetTotalNanoseconds() const { return m_totalNanoseconds; }
+    // The tasks of the critical path, first to last.
+    std::vector<TaskId> GetCriticalPath() const;
+
+private:
+    struct Task
+    {
+        const char* Name;
+        std::function<void()> Function;
+        std::vector<TaskId> Dependencies;
+        std::vector<TaskId> Dependents;
+        TaskAffinity Affinity;
+    };
+
+    struct State;
+
+    // Called with the state's lock held, except Execute.
+    bool PopTask(State& state, bool caller, TaskId& id) const;
+    size_t Finish(State& state, TaskId finished, bool succeeded);
+    void SubmitJobs(const std::shared_ptr<State>& state, size_t count);
+    void Execute(const std::shared_ptr<State>& state, TaskId id, bool onCaller);
+
+    ThreadPool* m_pool;
+    std::vector<Task> m_tasks;
+    std::vector<TaskTiming> m_timings;
+    std::vector<TaskId> m_gatingDependency;     // Per task: the dependency that finished last, or itself.
+    uint64_t m_totalNanoseconds;
+    bool m_ran;
+};
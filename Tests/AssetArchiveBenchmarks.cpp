@@ -0,0 +1,102 @@
+#include "BenchmarkFramework.h"
+#include "TestFramework.h"
+
+#include "AssetArchive.h"
+#include "AssetPacker.h"
+#include "ThreadPool.h"
+
+#include <cstdio>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char* const ArchivePath = "AssetArchiveBenchmarks.dxpk";
+
+    // Drops the archive from the OS file cache so the next open reads it from disk. Only POSIX
+    // has a call for it that needs no privileges.
+    bool EvictFromFileCache(const char* path)
+    {
+#if defined(_WIN32)
+        (void)path;
+        return false;
+#else
+        const int file = open(path, O_RDONLY);
+        if (file < 0)
+        {
+            return false;
+        }
+        fdatasync(file);
+        const bool evicted = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        close(file);
+        return evicted;
+#endif
+    }
+
+    // Opens the archive and decompresses every asset, as a level load does.
+    void LoadAll(ThreadPool* pool, std::vector<uint8_t>& dest)
+    {
+        AssetArchive archive;
+        archive.Open(ArchivePath);
+        for (uint32_t asset = 0; asset < archive.GetAssetCount(); ++asset)
+        {
+            archive.Prefetch(asset);
+        }
+        for (uint32_t asset = 0; asset < archive.GetAssetCount(); ++asset)
+        {
+            dest.resize(static_cast<size_t>(archive.GetAsset(asset).PayloadSize));
+            archive.Decompress(asset, dest.data(), pool);
+        }
+    }
+}
+
+BENCHMARK(AssetArchive, Load)
+{
+    // 16 RGBA8 1024x1024 textures with full mip chains: gradients with sparse noise, about half
+    // of which LZ4 compresses, as with the sample textures.
+    ThreadPool pool;
+    AssetPacker packer(&pool);
+    TestRandom random;
+    size_t imageSize = 0;
+    for (uint32_t mip = 0; mip < 11; ++mip)
+    {
+        imageSize += size_t(1024 >> mip) * (1024 >> mip) * 4;
+    }
+    std::vector<uint8_t> image(imageSize);
+    for (size_t i = 0; i < image.size(); ++i)
+    {
+        image[i] = static_cast<uint8_t>((i / 4) % 1024 / 4 + (i % 4) * 40 + (random.NextByte() < 32 ? 1 : 0));
+    }
+    uint64_t payloadBytes = 0;
+    for (int texture = 0; texture < 16; ++texture)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "texture%d", texture);
+        packer.AddTexture2D(name, 28, 1024, 1024, 1, 11, image.data(), image.size());
+    }
+    Report("Pack 16 textures, pool", BestSeconds(1, [&]() { packer.Write(ArchivePath); }) * 1e3, "ms");
+
+    std::vector<uint8_t> dest;
+    {
+        AssetArchive archive;
+        archive.Open(ArchivePath);
+        for (uint32_t asset = 0; asset < archive.GetAssetCount(); ++asset)
+        {
+            payloadBytes += archive.GetAsset(asset).PayloadSize;
+        }
+    }
+
+    ReportBytes("Warm load, 1 thread", double(payloadBytes), BestSeconds(5, [&]() { LoadAll(nullptr, dest); }));
+    ReportBytes("Warm load, pool", double(payloadBytes), BestSeconds(5, [&]() { LoadAll(&pool, dest); }));
+    if (EvictFromFileCache(ArchivePath))
+    {
+        ReportBytes("Cold load, 1 thread", double(payloadBytes), BestSeconds(1, [&]() { LoadAll(nullptr, dest); }));
+        EvictFromFileCache(ArchivePath);
+        ReportBytes("Cold load, pool", double(payloadBytes), BestSeconds(1, [&]() { LoadAll(&pool, dest); }));
+    }
+    std::remove(ArchivePath);
+}
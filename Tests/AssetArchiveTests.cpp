@@ -0,0 +1,319 @@
+#include "TestFramework.h"
+
+#include "AssetArchive.h"
+#include "AssetPacker.h"
+#include "ThreadPool.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    const uint32_t FormatRgba8 = 28;    // DXGI_FORMAT_R8G8B8A8_UNORM
+    const uint32_t FormatBc1 = 71;      // DXGI_FORMAT_BC1_UNORM
+
+    // Half runs of repeated bytes, half noise: some chunks compress, some are stored.
+    std::vector<uint8_t> MakeBytes(size_t size, uint64_t seed)
+    {
+        TestRandom random(seed);
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            bytes[i] = (i / 4096) % 2 == 0 ? static_cast<uint8_t>(i / 64) : random.NextByte();
+        }
+        return bytes;
+    }
+
+    // Tightly packed subresources, mip fastest, as AddTexture2D takes them.
+    size_t GetTightSize(uint32_t format, uint32_t width, uint32_t height, uint16_t arraySize, uint16_t mipLevels)
+    {
+        uint32_t blockDimension, bytesPerBlock;
+        GetFormatBlockInfo(format, blockDimension, bytesPerBlock);
+        size_t size = 0;
+        for (uint16_t mip = 0; mip < mipLevels; ++mip)
+        {
+            const size_t blocksWide = ((width >> mip ? width >> mip : 1) + blockDimension - 1) / blockDimension;
+            const size_t blocksHigh = ((height >> mip ? height >> mip : 1) + blockDimension - 1) / blockDimension;
+            size += blocksWide * blocksHigh * bytesPerBlock;
+        }
+        return size * arraySize;
+    }
+
+    // Every row of the payload matches the tight source, subresource by subresource.
+    bool MatchesFootprints(const AssetEntry& entry, const uint8_t* tight, const std::vector<uint8_t>& payload)
+    {
+        std::vector<SubresourceFootprint> footprints;
+        const uint64_t total = ComputeCopyableFootprints(entry.Format, entry.Width, entry.Height, entry.ArraySize, entry.MipLevels, footprints);
+        if (total != entry.PayloadSize || total != payload.size())
+        {
+            return false;
+        }
+        for (const SubresourceFootprint& footprint : footprints)
+        {
+            for (uint32_t row = 0; row < footprint.NumRows; ++row)
+            {
+                if (memcmp(payload.data() + footprint.Offset + uint64_t(row) * footprint.RowPitch, tight, footprint.RowSizeInBytes) != 0)
+                {
+                    return false;
+                }
+                tight += footprint.RowSizeInBytes;
+            }
+        }
+        return true;
+    }
+
+    std::vector<uint8_t> ReadFile(const char* path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void WriteFile(const char* path, const uint8_t* data, size_t size)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+
+    bool OpenThrows(const char* path)
+    {
+        AssetArchive archive;
+        try
+        {
+            archive.Open(path);
+        }
+        catch (const std::runtime_error&)
+        {
+            return !archive.IsOpen();
+        }
+        return false;
+    }
+
+    // A DDS file: magic, header, optional DX10 header, then the tightly packed data.
+    std::vector<uint8_t> MakeDds(uint32_t width, uint32_t height, uint32_t mipLevels, const uint32_t* pixelFormat, const uint32_t* dx10, const std::vector<uint8_t>& data)
+    {
+        uint32_t words[1 + 31 + 5] = {};
+        words[0] = 0x20534444;      // "DDS "
+        words[1] = 124;             // Size
+        words[1 + 1] = 0x1007;      // Caps, height, width, pixel format
+        words[1 + 2] = height;
+        words[1 + 3] = width;
+        words[1 + 6] = mipLevels;
+        memcpy(&words[1 + 18], pixelFormat, 8 * sizeof(uint32_t));
+        words[1 + 26] = 0x1000;     // DDSCAPS_TEXTURE
+        size_t headerWords = 1 + 31;
+        if (dx10)
+        {
+            memcpy(&words[headerWords], dx10, 5 * sizeof(uint32_t));
+            headerWords += 5;
+        }
+        std::vector<uint8_t> file(headerWords * sizeof(uint32_t));
+        memcpy(file.data(), words, file.size());
+        file.insert(file.end(), data.begin(), data.end());
+        return file;
+    }
+
+    const char* const ArchivePath = "AssetArchiveTests.dxpk";
+    const char* const DamagedPath = "AssetArchiveTests.damaged.dxpk";
+}
+
+TEST(AssetArchive, FootprintsMatchD3D12)
+{
+    // 300x200 RGBA8 with 3 mips and 2 slices: rows padded to 256 bytes, subresources placed at
+    // multiples of 512 bytes, as GetCopyableFootprints reports them.
+    std::vector<SubresourceFootprint> footprints;
+    const uint64_t total = ComputeCopyableFootprints(FormatRgba8, 300, 200, 2, 3, footprints);
+    REQUIRE(footprints.size() == 6);
+    CHECK_EQUAL(uint64_t(0), footprints[0].Offset);
+    CHECK_EQUAL(1280u, footprints[0].RowPitch);
+    CHECK_EQUAL(200u, footprints[0].NumRows);
+    CHECK_EQUAL(uint64_t(1200), footprints[0].RowSizeInBytes);
+    CHECK_EQUAL(150u, footprints[1].Width);
+    CHECK_EQUAL(768u, footprints[1].RowPitch);
+    CHECK_EQUAL(uint64_t(256000), footprints[1].Offset);
+    CHECK_EQUAL(75u, footprints[2].Width);
+    CHECK_EQUAL(50u, footprints[2].Height);
+    for (size_t i = 1; i < footprints.size(); ++i)
+    {
+        const SubresourceFootprint& previous = footprints[i - 1];
+        CHECK_EQUAL(uint64_t(0), footprints[i].Offset % 512);
+        CHECK(footprints[i].Offset >= previous.Offset + uint64_t(previous.RowPitch) * (previous.NumRows - 1) + previous.RowSizeInBytes);
+    }
+    const SubresourceFootprint& last = footprints.back();
+    CHECK_EQUAL(last.Offset + uint64_t(last.RowPitch) * (last.NumRows - 1) + last.RowSizeInBytes, total);
+
+    // Block compressed: one row per 4 pixel rows, rounded up, and 8 bytes per 4x4 block.
+    ComputeCopyableFootprints(FormatBc1, 130, 70, 1, 1, footprints);
+    REQUIRE(footprints.size() == 1);
+    CHECK_EQUAL(18u, footprints[0].NumRows);
+    CHECK_EQUAL(uint64_t(33 * 8), footprints[0].RowSizeInBytes);
+    CHECK_EQUAL(512u, footprints[0].RowPitch);
+
+    bool threw = false;
+    try
+    {
+        ComputeCopyableFootprints(12345, 4, 4, 1, 1, footprints);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(AssetArchive, NameHashIsFnv1a)
+{
+    CHECK_EQUAL(0xCBF29CE484222325ull, HashAssetName("", 0));
+    CHECK_EQUAL(0xAF63DC4C8601EC8Cull, HashAssetName("a", 1));
+    CHECK_EQUAL(0x85944171F73967E8ull, HashAssetName("foobar", 6));
+}
+
+TEST(AssetArchive, RoundTrip)
+{
+    // Small chunks, so every asset but the tiny one spans several and the pool gets work.
+    ThreadPool pool(3);
+    AssetPacker packer(&pool, 16 * 1024);
+    const std::vector<uint8_t> buffer = MakeBytes(100000, 1);
+    const std::vector<uint8_t> tiny = MakeBytes(5, 2);
+    const std::vector<uint8_t> rgba = MakeBytes(GetTightSize(FormatRgba8, 300, 200, 2, 3), 3);
+    const std::vector<uint8_t> bc1 = MakeBytes(GetTightSize(FormatBc1, 130, 70, 1, 8), 4);
+    packer.AddBuffer("geometry/terrain.vb", buffer.data(), buffer.size());
+    packer.AddBuffer("tiny", tiny.data(), tiny.size());
+    packer.AddTexture2D("textures/albedo", FormatRgba8, 300, 200, 2, 3, rgba.data(), rgba.size());
+    packer.AddTexture2D("textures/normals", FormatBc1, 130, 70, 1, 8, bc1.data(), bc1.size());
+    CHECK_EQUAL(size_t(4), packer.GetAssetCount());
+    packer.Write(ArchivePath);
+
+    AssetArchive archive;
+    archive.Open(ArchivePath);
+    REQUIRE(archive.IsOpen());
+    CHECK_EQUAL(4u, archive.GetAssetCount());
+    CHECK_EQUAL(AssetArchive::NotFound, archive.Find("textures/missing"));
+
+    // The table is sorted by name hash for Find.
+    for (uint32_t i = 1; i < archive.GetAssetCount(); ++i)
+    {
+        CHECK(archive.GetAsset(i - 1).NameHash <= archive.GetAsset(i).NameHash);
+    }
+
+    const uint32_t bufferAsset = archive.Find("geometry/terrain.vb");
+    REQUIRE(bufferAsset != AssetArchive::NotFound);
+    CHECK_EQUAL(std::string("geometry/terrain.vb"), archive.GetAssetName(bufferAsset));
+    const AssetEntry& bufferEntry = archive.GetAsset(bufferAsset);
+    CHECK(bufferEntry.Type == AssetType::Buffer);
+    CHECK_EQUAL(uint64_t(buffer.size()), bufferEntry.PayloadSize);
+    CHECK_EQUAL(7u, bufferEntry.ChunkCount);
+    for (ThreadPool* decompressPool : { static_cast<ThreadPool*>(nullptr), &pool })
+    {
+        std::vector<uint8_t> payload(buffer.size());
+        archive.Decompress(bufferAsset, payload.data(), decompressPool);
+        CHECK(payload == buffer);
+    }
+
+    const uint32_t tinyAsset = archive.Find("tiny");
+    REQUIRE(tinyAsset != AssetArchive::NotFound);
+    std::vector<uint8_t> tinyPayload(tiny.size());
+    archive.Decompress(tinyAsset, tinyPayload.data());
+    CHECK(tinyPayload == tiny);
+
+    for (const char* name : { "textures/albedo", "textures/normals" })
+    {
+        const uint32_t asset = archive.Find(name);
+        REQUIRE(asset != AssetArchive::NotFound);
+        const AssetEntry& entry = archive.GetAsset(asset);
+        CHECK(entry.Type == AssetType::Texture2D);
+        for (ThreadPool* decompressPool : { static_cast<ThreadPool*>(nullptr), &pool })
+        {
+            std::vector<uint8_t> payload(static_cast<size_t>(entry.PayloadSize));
+            archive.Decompress(asset, payload.data(), decompressPool);
+            CHECK(MatchesFootprints(entry, entry.Format == FormatRgba8 ? rgba.data() : bc1.data(), payload));
+        }
+    }
+    CHECK_EQUAL(uint16_t(8), archive.GetAsset(archive.Find("textures/normals")).MipLevels);
+
+    archive.Close();
+    CHECK(!archive.IsOpen());
+    CHECK_EQUAL(0u, archive.GetAssetCount());
+    std::remove(ArchivePath);
+}
+
+TEST(AssetArchive, DdsTextures)
+{
+    // A legacy RGBA8 header and a DX10 header for a BC1 array of two.
+    const uint32_t rgbaFormat[8] = { 32, 0x41, 0, 32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000 };
+    const std::vector<uint8_t> rgba = MakeBytes(GetTightSize(FormatRgba8, 64, 32, 1, 7), 5);
+    const std::vector<uint8_t> rgbaDds = MakeDds(64, 32, 7, rgbaFormat, nullptr, rgba);
+
+    const uint32_t dx10Format[8] = { 32, 0x4, 0x30315844 };     // FourCC "DX10"
+    const uint32_t dx10[5] = { FormatBc1, 3, 0, 2, 0 };
+    const std::vector<uint8_t> bc1 = MakeBytes(GetTightSize(FormatBc1, 40, 24, 2, 1), 6);
+    const std::vector<uint8_t> bc1Dds = MakeDds(40, 24, 1, dx10Format, dx10, bc1);
+
+    AssetPacker packer;
+    packer.AddDdsTexture("rgba", rgbaDds.data(), rgbaDds.size());
+    packer.AddDdsTexture("bc1", bc1Dds.data(), bc1Dds.size());
+    packer.Write(ArchivePath);
+
+    AssetArchive archive;
+    archive.Open(ArchivePath);
+    const AssetEntry& rgbaEntry = archive.GetAsset(archive.Find("rgba"));
+    CHECK_EQUAL(FormatRgba8, rgbaEntry.Format);
+    CHECK_EQUAL(uint16_t(7), rgbaEntry.MipLevels);
+    const AssetEntry& bc1Entry = archive.GetAsset(archive.Find("bc1"));
+    CHECK_EQUAL(FormatBc1, bc1Entry.Format);
+    CHECK_EQUAL(uint16_t(2), bc1Entry.ArraySize);
+    for (const AssetEntry* entry : { &rgbaEntry, &bc1Entry })
+    {
+        std::vector<uint8_t> payload(static_cast<size_t>(entry->PayloadSize));
+        archive.Decompress(static_cast<uint32_t>(entry - &archive.GetAsset(0)), payload.data());
+        CHECK(MatchesFootprints(*entry, entry == &rgbaEntry ? rgba.data() : bc1.data(), payload));
+    }
+    archive.Close();
+    std::remove(ArchivePath);
+
+    // Not a DDS file.
+    bool threw = false;
+    try
+    {
+        packer.AddDdsTexture("text", "hello", 5);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(AssetArchive, RejectsDamagedFiles)
+{
+    CHECK(OpenThrows("AssetArchiveTests.missing.dxpk"));
+
+    const std::vector<uint8_t> buffer = MakeBytes(50000, 7);
+    AssetPacker packer(nullptr, 8192);
+    packer.AddBuffer("buffer", buffer.data(), buffer.size());
+    packer.Write(ArchivePath);
+    const std::vector<uint8_t> file = ReadFile(ArchivePath);
+    std::remove(ArchivePath);
+    REQUIRE(file.size() > sizeof(AssetArchiveHeader));
+
+    // Truncated anywhere: the tables at the end no longer fit.
+    for (size_t size : { size_t(0), size_t(10), sizeof(AssetArchiveHeader), file.size() / 2, file.size() - 1 })
+    {
+        WriteFile(DamagedPath, file.data(), size);
+        CHECK(OpenThrows(DamagedPath));
+    }
+
+    // A header that lies: wrong magic, wrong version, tables past the end, chunks past the end.
+    for (size_t field : { offsetof(AssetArchiveHeader, Magic), offsetof(AssetArchiveHeader, Version), offsetof(AssetArchiveHeader, TocOffset), offsetof(AssetArchiveHeader, ChunkCount) })
+    {
+        std::vector<uint8_t> damaged = file;
+        damaged[field + 2] ^= 0x5A;
+        WriteFile(DamagedPath, damaged.data(), damaged.size());
+        CHECK(OpenThrows(DamagedPath));
+    }
+    std::remove(DamagedPath);
+}
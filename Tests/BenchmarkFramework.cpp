@@ -0,0 +1,70 @@
+#include "BenchmarkFramework.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    struct BenchmarkCase
+    {
+        const char* Suite;
+        const char* Name;
+        BenchmarkFunction Function;
+    };
+
+    // Function local so registration from other files' static initializers finds it constructed.
+    std::vector<BenchmarkCase>& GetBenchmarkCases()
+    {
+        static std::vector<BenchmarkCase> benchmarkCases;
+        return benchmarkCases;
+    }
+}
+
+BenchmarkRegistrar::BenchmarkRegistrar(const char* suite, const char* name, BenchmarkFunction function)
+{
+    GetBenchmarkCases().push_back({ suite, name, function });
+}
+
+double BestSeconds(int runs, const std::function<void()>& fn)
+{
+    double best = 1e30;
+    for (int run = 0; run < runs; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+void Report(const char* name, double value, const char* unit)
+{
+    printf("  %-40s %12.2f %s\n", name, value, unit);
+    fflush(stdout);
+}
+
+void ReportBytes(const char* name, double bytes, double seconds)
+{
+    Report(name, bytes / seconds / 1e6, "MB/s");
+}
+
+int main(int argc, char** argv)
+{
+    for (const BenchmarkCase& benchmark : GetBenchmarkCases())
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+        {
+            selected |= strcmp(argv[i], benchmark.Suite) == 0;
+        }
+        if (selected)
+        {
+            printf("%s.%s\n", benchmark.Suite, benchmark.Name);
+            benchmark.Function();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+
+// Minimal benchmark registry, the counterpart of TestFramework.h for throughput numbers.
+//
+// BENCHMARK(Suite, Name) defines a benchmark. PortableBenchmarks runs every benchmark, or those
+// of the suites named on the command line. The numbers depend on the machine, so they are not
+// part of ctest: they compare builds (SSE2 and AVX2) and changes on one machine.
+
+typedef void (*BenchmarkFunction)();
+
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(const char* suite, const char* name, BenchmarkFunction function);
+};
+
+#define BENCHMARK(suite, name) \
+    static void suite##_##name##Benchmark(); \
+    static const BenchmarkRegistrar suite##_##name##BenchmarkRegistrar(#suite, #name, &suite##_##name##Benchmark); \
+    static void suite##_##name##Benchmark()
+
+// The fastest of runs calls of fn, in seconds.
+double BestSeconds(int runs, const std::function<void()>& fn);
+
+// One line of results: "name   value unit".
+void Report(const char* name, double value, const char* unit);
+// bytes processed in seconds, as MB/s.
+void ReportBytes(const char* name, double bytes, double seconds);
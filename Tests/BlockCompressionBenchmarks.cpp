@@ -0,0 +1,126 @@
+#include "BenchmarkFramework.h"
+#include "TestFramework.h"
+
+#include "AssetArchive.h"
+#include "BlockCompression.h"
+#include "Ktx2Texture.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const char* const TexturePath = "BlockCompressionBenchmarks.ktx2";
+
+    // Gradients with sparse noise, as with the sample textures.
+    std::vector<uint8_t> MakeImage(uint32_t width, uint32_t height)
+    {
+        TestRandom random;
+        std::vector<uint8_t> image(size_t(width) * height * 4);
+        for (size_t i = 0; i < image.size(); ++i)
+        {
+            image[i] = static_cast<uint8_t>((i / 4) % width / 4 + (i % 4) * 40 + (random.NextByte() < 32 ? 1 : 0));
+        }
+        return image;
+    }
+
+    // An RGBA8 KTX2 file of size x size texels with a full mip chain, levels smallest first.
+    // Returns the bytes of texels.
+    size_t WriteKtx2(uint32_t size)
+    {
+        uint32_t levelCount = 1;
+        while ((size >> levelCount) != 0)
+        {
+            ++levelCount;
+        }
+        std::vector<std::vector<uint8_t>> levels;
+        size_t texelBytes = 0;
+        for (uint32_t level = 0; level < levelCount; ++level)
+        {
+            levels.push_back(MakeImage(std::max(1u, size >> level), std::max(1u, size >> level)));
+            texelBytes += levels.back().size();
+        }
+
+        Ktx2Header header = {};
+        const uint8_t identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+        memcpy(header.Identifier, identifier, sizeof(identifier));
+        header.VkFormat = 37;
+        header.TypeSize = 1;
+        header.PixelWidth = size;
+        header.PixelHeight = size;
+        header.FaceCount = 1;
+        header.LevelCount = levelCount;
+        std::vector<Ktx2Level> index(levelCount);
+        uint64_t offset = sizeof(header) + levelCount * sizeof(Ktx2Level);
+        for (uint32_t level = levelCount; level-- > 0;)
+        {
+            index[level] = { offset, levels[level].size(), levels[level].size() };
+            offset += levels[level].size();
+        }
+
+        FILE* file = fopen(TexturePath, "wb");
+        if (!file)
+        {
+            return 0;
+        }
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(index.data(), sizeof(Ktx2Level), levelCount, file);
+        for (uint32_t level = levelCount; level-- > 0;)
+        {
+            fwrite(levels[level].data(), 1, levels[level].size(), file);
+        }
+        fclose(file);
+        return texelBytes;
+    }
+}
+
+BENCHMARK(BlockCompression, Encode)
+{
+    // RGBA8 megabytes in per second, on one thread.
+    const uint32_t size = 512;
+    const std::vector<uint8_t> image = MakeImage(size, size);
+    std::vector<uint8_t> blocks(size_t(size / 4) * (size / 4) * 16);
+    for (int f = 0; f < static_cast<int>(BlockFormat::Count); ++f)
+    {
+        const BlockFormat format = static_cast<BlockFormat>(f);
+        ReportBytes(GetBlockFormatName(format), double(image.size()), BestSeconds(3, [&]()
+        {
+            EncodeBlockRows(format, image.data(), size * 4, size, size, 0, size / 4, blocks.data(), (size / 4) * GetBlockSize(format));
+        }));
+    }
+}
+
+BENCHMARK(Ktx2Texture, Load)
+{
+    // A 2048x2048 RGBA8 file with its mips, opened and encoded into an upload-sized buffer, as
+    // -texture does: RGBA8 megabytes in per second.
+    const size_t texelBytes = WriteKtx2(2048);
+    if (texelBytes == 0)
+    {
+        Report("Can't write the texture", 0.0, "");
+        return;
+    }
+    ThreadPool pool;
+    std::vector<uint8_t> dest;
+    for (BlockFormat format : { BlockFormat::BC1, BlockFormat::BC7 })
+    {
+        for (ThreadPool* readPool : { static_cast<ThreadPool*>(nullptr), &pool })
+        {
+            const double seconds = BestSeconds(2, [&]()
+            {
+                Ktx2Texture texture;
+                texture.Open(TexturePath, readPool);
+                std::vector<SubresourceFootprint> footprints;
+                dest.resize(static_cast<size_t>(ComputeCopyableFootprints(texture.GetDxgiFormat(format), texture.GetWidth(), texture.GetHeight(), 1, texture.GetMipLevels(), footprints)));
+                texture.Read(format, footprints.data(), dest.data(), readPool);
+            });
+            char name[64];
+            snprintf(name, sizeof(name), "%s, %s", GetBlockFormatName(format), readPool ? "pool" : "1 thread");
+            ReportBytes(name, double(texelBytes), seconds);
+        }
+    }
+    remove(TexturePath);
+}
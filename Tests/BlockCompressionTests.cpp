@@ -0,0 +1,488 @@
+#include "TestFramework.h"
+
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    // Decoders written from the format specs, independently of the encoders. BC7 covers the two
+    // modes the encoder writes, rotation 0; anything else fails the decode.
+    void DecodeRgb565(uint16_t color, int rgb[3])
+    {
+        const int r = color >> 11;
+        const int g = (color >> 5) & 63;
+        const int b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    // BC1 color block; BC3 always uses the four-color palette.
+    void DecodeColorBlock(const uint8_t* block, uint8_t texels[64], bool fourColors)
+    {
+        const uint16_t color0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+        const uint16_t color1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+        int palette[4][4];
+        DecodeRgb565(color0, palette[0]);
+        DecodeRgb565(color1, palette[1]);
+        palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+        for (int c = 0; c < 3; ++c)
+        {
+            if (color0 > color1 || fourColors)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+                palette[3][3] = 0;
+            }
+        }
+
+        uint32_t indices;
+        memcpy(&indices, block + 4, sizeof(indices));
+        for (int i = 0; i < 16; ++i)
+        {
+            const int index = (indices >> (2 * i)) & 3;
+            for (int c = 0; c < 4; ++c)
+            {
+                texels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+            }
+        }
+    }
+
+    void DecodeAlphaBlock(const uint8_t* block, uint8_t texels[64])
+    {
+        int alpha[8] = { block[0], block[1] };
+        if (alpha[0] > alpha[1])
+        {
+            for (int i = 2; i < 8; ++i)
+            {
+                alpha[i] = ((8 - i) * alpha[0] + (i - 1) * alpha[1]) / 7;
+            }
+        }
+        else
+        {
+            for (int i = 2; i < 6; ++i)
+            {
+                alpha[i] = ((6 - i) * alpha[0] + (i - 1) * alpha[1]) / 5;
+            }
+            alpha[6] = 0;
+            alpha[7] = 255;
+        }
+
+        uint64_t indices = 0;
+        for (int i = 0; i < 6; ++i)
+        {
+            indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+        }
+        for (int i = 0; i < 16; ++i)
+        {
+            texels[i * 4 + 3] = static_cast<uint8_t>(alpha[(indices >> (3 * i)) & 7]);
+        }
+    }
+
+    class BitReader
+    {
+    public:
+        explicit BitReader(const uint8_t* bytes) : m_bytes(bytes), m_position(0) {}
+
+        int Read(int count)
+        {
+            int value = 0;
+            for (int i = 0; i < count; ++i, ++m_position)
+            {
+                value |= ((m_bytes[m_position / 8] >> (m_position % 8)) & 1) << i;
+            }
+            return value;
+        }
+        int GetPosition() const { return m_position; }
+
+    private:
+        const uint8_t* m_bytes;
+        int m_position;
+    };
+
+    uint8_t Interpolate(int endpoint0, int endpoint1, int weight)
+    {
+        return static_cast<uint8_t>(((64 - weight) * endpoint0 + weight * endpoint1 + 32) >> 6);
+    }
+
+    // Returns the mode, or -1 for blocks this decoder does not handle.
+    int DecodeBc7Block(const uint8_t* block, uint8_t texels[64])
+    {
+        static const int Weights2[4] = { 0, 21, 43, 64 };
+        static const int Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        BitReader bits(block);
+        int mode = 0;
+        while (mode < 8 && bits.Read(1) == 0)
+        {
+            ++mode;
+        }
+
+        int endpoints[2][4];
+        if (mode == 5)
+        {
+            if (bits.Read(2) != 0)
+            {
+                return -1;
+            }
+            for (int c = 0; c < 3; ++c)
+            {
+                for (int e = 0; e < 2; ++e)
+                {
+                    const int value = bits.Read(7);
+                    endpoints[e][c] = value << 1 | value >> 6;
+                }
+            }
+            endpoints[0][3] = bits.Read(8);
+            endpoints[1][3] = bits.Read(8);
+            for (int i = 0; i < 16; ++i)
+            {
+                const int index = bits.Read(i == 0 ? 1 : 2);
+                for (int c = 0; c < 3; ++c)
+                {
+                    texels[i * 4 + c] = Interpolate(endpoints[0][c], endpoints[1][c], Weights2[index]);
+                }
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                const int index = bits.Read(i == 0 ? 1 : 2);
+                texels[i * 4 + 3] = Interpolate(endpoints[0][3], endpoints[1][3], Weights2[index]);
+            }
+        }
+        else if (mode == 6)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                endpoints[0][c] = bits.Read(7) << 1;
+                endpoints[1][c] = bits.Read(7) << 1;
+            }
+            const int pbit0 = bits.Read(1);
+            const int pbit1 = bits.Read(1);
+            for (int c = 0; c < 4; ++c)
+            {
+                endpoints[0][c] |= pbit0;
+                endpoints[1][c] |= pbit1;
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                const int index = bits.Read(i == 0 ? 3 : 4);
+                for (int c = 0; c < 4; ++c)
+                {
+                    texels[i * 4 + c] = Interpolate(endpoints[0][c], endpoints[1][c], Weights4[index]);
+                }
+            }
+        }
+        else
+        {
+            return -1;
+        }
+        return bits.GetPosition() == 128 ? mode : -1;
+    }
+
+    bool DecodeBlock(BlockFormat format, const uint8_t* block, uint8_t texels[64])
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1:
+            DecodeColorBlock(block, texels, false);
+            return true;
+        case BlockFormat::BC3:
+            DecodeColorBlock(block + 8, texels, true);
+            DecodeAlphaBlock(block, texels);
+            return true;
+        default:
+            return DecodeBc7Block(block, texels) >= 0;
+        }
+    }
+
+    // Smooth gradients, hard edged patches and a little noise; alpha varies slowly.
+    std::vector<uint8_t> MakeImage(uint32_t width, uint32_t height)
+    {
+        TestRandom random;
+        std::vector<uint8_t> image(size_t(width) * height * 4);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const float fx = static_cast<float>(x) / width;
+                const float fy = static_cast<float>(y) / height;
+                float value[4] =
+                {
+                    128 + 100 * sinf(fx * 9 + fy * 3),
+                    128 + 90 * cosf(fy * 7 - fx * 2),
+                    60 + 150 * fx * fy,
+                    255 * (0.5f + 0.5f * sinf(fx * 5 + fy * 11))
+                };
+                if ((x / 24 + y / 32) % 3 == 0)
+                {
+                    value[0] = 230;
+                    value[1] = 40;
+                }
+                for (int c = 0; c < 4; ++c)
+                {
+                    const float noise = c < 3 ? static_cast<float>(random.NextBelow(9)) - 4 : 0;
+                    image[(size_t(y) * width + x) * 4 + c] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, value[c] + noise)));
+                }
+            }
+        }
+        return image;
+    }
+
+    struct ImageError
+    {
+        double RgbPsnr;
+        double AlphaPsnr;
+        bool Decoded;
+    };
+
+    ImageError MeasureImage(BlockFormat format, const std::vector<uint8_t>& image, uint32_t width, uint32_t height)
+    {
+        const uint32_t blockSize = GetBlockSize(format);
+        const uint32_t blocksWide = (width + 3) / 4;
+        const uint32_t blocksHigh = (height + 3) / 4;
+        std::vector<uint8_t> blocks(size_t(blocksWide) * blocksHigh * blockSize);
+        EncodeBlockRows(format, image.data(), width * 4, width, height, 0, blocksHigh, blocks.data(), blocksWide * blockSize);
+
+        double squaredError[4] = {};
+        ImageError result = { 0, 0, true };
+        for (uint32_t blockY = 0; blockY < blocksHigh; ++blockY)
+        {
+            for (uint32_t blockX = 0; blockX < blocksWide; ++blockX)
+            {
+                uint8_t texels[64];
+                result.Decoded &= DecodeBlock(format, blocks.data() + (size_t(blockY) * blocksWide + blockX) * blockSize, texels);
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    const uint32_t x = blockX * 4 + i % 4;
+                    const uint32_t y = blockY * 4 + i / 4;
+                    if (x >= width || y >= height)
+                    {
+                        continue;
+                    }
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        const double error = double(texels[i * 4 + c]) - image[(size_t(y) * width + x) * 4 + c];
+                        squaredError[c] += error * error;
+                    }
+                }
+            }
+        }
+
+        const double texelCount = double(width) * height;
+        auto psnr = [texelCount](double error) { return error == 0 ? 99.0 : 10 * log10(255.0 * 255.0 * texelCount / error); };
+        result.RgbPsnr = psnr((squaredError[0] + squaredError[1] + squaredError[2]) / 3);
+        result.AlphaPsnr = psnr(squaredError[3]);
+        return result;
+    }
+
+    void FillBlock(uint8_t texels[64], uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            texels[i * 4 + 0] = r;
+            texels[i * 4 + 1] = g;
+            texels[i * 4 + 2] = b;
+            texels[i * 4 + 3] = a;
+        }
+    }
+
+    int MaxError(const uint8_t expected[64], const uint8_t actual[64], int channels)
+    {
+        int maxError = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int c = 0; c < channels; ++c)
+            {
+                maxError = std::max(maxError, std::abs(int(expected[i * 4 + c]) - int(actual[i * 4 + c])));
+            }
+        }
+        return maxError;
+    }
+}
+
+TEST(BlockCompression, FormatProperties)
+{
+    CHECK_EQUAL(8u, GetBlockSize(BlockFormat::BC1));
+    CHECK_EQUAL(16u, GetBlockSize(BlockFormat::BC3));
+    CHECK_EQUAL(16u, GetBlockSize(BlockFormat::BC7));
+    // DXGI_FORMAT_BC1_UNORM and _SRGB, BC3, BC7.
+    CHECK_EQUAL(71u, GetBlockFormatDxgi(BlockFormat::BC1, false));
+    CHECK_EQUAL(72u, GetBlockFormatDxgi(BlockFormat::BC1, true));
+    CHECK_EQUAL(77u, GetBlockFormatDxgi(BlockFormat::BC3, false));
+    CHECK_EQUAL(78u, GetBlockFormatDxgi(BlockFormat::BC3, true));
+    CHECK_EQUAL(98u, GetBlockFormatDxgi(BlockFormat::BC7, false));
+    CHECK_EQUAL(99u, GetBlockFormatDxgi(BlockFormat::BC7, true));
+}
+
+TEST(BlockCompression, SolidBlocks)
+{
+    // Colors that RGB565 holds exactly must come back exactly from BC1 and BC3; any alpha from
+    // BC3; and any color within one step from BC7.
+    const uint8_t colors[][4] =
+    {
+        { 0, 0, 0, 255 }, { 255, 255, 255, 255 }, { 255, 0, 0, 0 }, { 0, 255, 0, 128 }, { 132, 130, 66, 17 }, { 8, 4, 255, 254 }
+    };
+    for (const uint8_t* color : colors)
+    {
+        uint8_t texels[64];
+        FillBlock(texels, color[0], color[1], color[2], color[3]);
+        uint8_t block[16];
+        uint8_t decoded[64];
+
+        EncodeBlock(BlockFormat::BC1, texels, block);
+        DecodeColorBlock(block, decoded, false);
+        CHECK_EQUAL(0, MaxError(texels, decoded, 3));
+        for (int i = 0; i < 16; ++i)
+        {
+            CHECK_EQUAL(255, decoded[i * 4 + 3]);
+        }
+
+        EncodeBlock(BlockFormat::BC3, texels, block);
+        REQUIRE(DecodeBlock(BlockFormat::BC3, block, decoded));
+        CHECK_EQUAL(0, MaxError(texels, decoded, 4));
+    }
+
+    TestRandom random;
+    for (int i = 0; i < 500; ++i)
+    {
+        uint8_t texels[64];
+        FillBlock(texels, random.NextByte(), random.NextByte(), random.NextByte(), random.NextByte());
+        uint8_t block[16];
+        uint8_t decoded[64];
+        EncodeBlock(BlockFormat::BC7, texels, block);
+        REQUIRE(DecodeBlock(BlockFormat::BC7, block, decoded));
+        CHECK(MaxError(texels, decoded, 4) <= 1);
+    }
+}
+
+TEST(BlockCompression, OpposingChannelRamp)
+{
+    // Red rising as green falls: the principal axis is orthogonal to the gray diagonal. Four
+    // BC1 colors over the ramp leave up to 40 of error; a collapsed block leaves 255.
+    uint8_t texels[64];
+    for (int i = 0; i < 16; ++i)
+    {
+        texels[i * 4 + 0] = static_cast<uint8_t>(i * 16);
+        texels[i * 4 + 1] = static_cast<uint8_t>(255 - i * 16);
+        texels[i * 4 + 2] = 90;
+        texels[i * 4 + 3] = 255;
+    }
+    for (BlockFormat format : { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC7 })
+    {
+        uint8_t block[16];
+        uint8_t decoded[64];
+        EncodeBlock(format, texels, block);
+        REQUIRE(DecodeBlock(format, block, decoded));
+        CHECK(MaxError(texels, decoded, 3) <= (format == BlockFormat::BC7 ? 4 : 48));
+    }
+}
+
+TEST(BlockCompression, ImageQuality)
+{
+    // Floors a little under what the encoders reach on this image; a drop means a regression.
+    const uint32_t width = 254;
+    const uint32_t height = 130;
+    const std::vector<uint8_t> image = MakeImage(width, height);
+
+    const ImageError bc1 = MeasureImage(BlockFormat::BC1, image, width, height);
+    CHECK(bc1.Decoded);
+    CHECK(bc1.RgbPsnr > 33);
+
+    const ImageError bc3 = MeasureImage(BlockFormat::BC3, image, width, height);
+    CHECK(bc3.Decoded);
+    CHECK(bc3.RgbPsnr > 33);
+    CHECK(bc3.AlphaPsnr > 45);
+
+    const ImageError bc7 = MeasureImage(BlockFormat::BC7, image, width, height);
+    CHECK(bc7.Decoded);
+    CHECK(bc7.RgbPsnr > 34);
+    CHECK(bc7.AlphaPsnr > 40);
+}
+
+TEST(BlockCompression, Bc7ModeSelection)
+{
+    // Opaque blocks use mode 6; blocks with alpha varying against the color use mode 5, which
+    // keeps alpha out of the color fit.
+    uint8_t texels[64];
+    for (int i = 0; i < 16; ++i)
+    {
+        texels[i * 4 + 0] = static_cast<uint8_t>(i * 16);
+        texels[i * 4 + 1] = static_cast<uint8_t>(255 - i * 16);
+        texels[i * 4 + 2] = 90;
+        texels[i * 4 + 3] = 255;
+    }
+    uint8_t block[16];
+    uint8_t decoded[64];
+    EncodeBlock(BlockFormat::BC7, texels, block);
+    CHECK_EQUAL(6, DecodeBc7Block(block, decoded));
+    CHECK(MaxError(texels, decoded, 4) <= 8);
+
+    // An alpha cutout: two shades of leaf in columns, opaque and clear texels in a checkerboard.
+    // No line through RGBA holds the four combinations; mode 5 fits color and alpha apart.
+    for (int i = 0; i < 16; ++i)
+    {
+        const bool left = i % 4 < 2;
+        texels[i * 4 + 0] = left ? 40 : 90;
+        texels[i * 4 + 1] = left ? 120 : 200;
+        texels[i * 4 + 2] = left ? 30 : 60;
+        texels[i * 4 + 3] = ((i + i / 4) & 1) != 0 ? 255 : 0;
+    }
+    EncodeBlock(BlockFormat::BC7, texels, block);
+    CHECK_EQUAL(5, DecodeBc7Block(block, decoded));
+    for (int i = 0; i < 16; ++i)
+    {
+        CHECK_EQUAL(int(texels[i * 4 + 3]), int(decoded[i * 4 + 3]));
+    }
+    CHECK(MaxError(texels, decoded, 3) <= 2);
+}
+
+TEST(BlockCompression, RowsMatchSingleBlocks)
+{
+    // 13x7 has partial blocks on the right and bottom; they repeat the edge texels.
+    const uint32_t width = 13;
+    const uint32_t height = 7;
+    const std::vector<uint8_t> image = MakeImage(width, height);
+    const uint32_t blocksWide = (width + 3) / 4;
+    const uint32_t blocksHigh = (height + 3) / 4;
+
+    for (int f = 0; f < static_cast<int>(BlockFormat::Count); ++f)
+    {
+        const BlockFormat format = static_cast<BlockFormat>(f);
+        const uint32_t blockSize = GetBlockSize(format);
+        const size_t destRowPitch = blocksWide * blockSize + 8;
+        std::vector<uint8_t> rows(destRowPitch * blocksHigh, 0xEE);
+        EncodeBlockRows(format, image.data(), width * 4, width, height, 0, 1, rows.data(), destRowPitch);
+        EncodeBlockRows(format, image.data(), width * 4, width, height, 1, 1, rows.data(), destRowPitch);
+
+        for (uint32_t blockY = 0; blockY < blocksHigh; ++blockY)
+        {
+            for (uint32_t blockX = 0; blockX < blocksWide; ++blockX)
+            {
+                uint8_t texels[64];
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    const uint32_t x = std::min(blockX * 4 + i % 4, width - 1);
+                    const uint32_t y = std::min(blockY * 4 + i / 4, height - 1);
+                    memcpy(texels + i * 4, image.data() + (size_t(y) * width + x) * 4, 4);
+                }
+                uint8_t block[16];
+                EncodeBlock(format, texels, block);
+                CHECK(memcmp(block, rows.data() + blockY * destRowPitch + blockX * blockSize, blockSize) == 0);
+            }
+            // The padding at the end of each row is never written.
+            for (size_t i = blocksWide * blockSize; i < destRowPitch; ++i)
+            {
+                CHECK_EQUAL(0xEE, int(rows[blockY * destRowPitch + i]));
+            }
+        }
+    }
+}
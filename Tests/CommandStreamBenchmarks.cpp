@@ -0,0 +1,69 @@
+#include "BenchmarkFramework.h"
+
+#include "CommandStream.h"
+#include "FrameAllocators.h"
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+    // One frame of the sample with drawCount objects: state setup, a constant buffer view and a
+    // draw per object, a few transitions and the present.
+    void RecordFrame(CommandStreamWriter& writer, LinearArena& arena, uint32_t frame, uint32_t drawCount)
+    {
+        writer.BeginFrame(arena, frame, frame % 3);
+        writer.Write(CommandOp::ResetCommandList, { 1, 2 + frame % 3, 3 });
+        writer.Write(CommandOp::SetGraphicsRootSignature, { 4 });
+        writer.Write(CommandOp::SetDescriptorHeaps, { 5, 0 });
+        writer.Write(CommandOp::SetViewport, { 0, 0, CommandFloatBits(1280.0f), CommandFloatBits(720.0f), 0, CommandFloatBits(1.0f) });
+        writer.Write(CommandOp::SetScissorRect, { 0, 0, 1280, 720 });
+        writer.Write(CommandOp::Transition, { 6 + frame % 3, 0, 0, 4 });
+        writer.Write(CommandOp::SetRenderTarget, { 7, frame % 3 });
+        writer.Write(CommandOp::SetPrimitiveTopology, { 4 });
+        writer.Write(CommandOp::SetVertexBuffer, { 0, 8, 0, 36 * 1024, 36 });
+        for (uint32_t draw = 0; draw < drawCount; ++draw)
+        {
+            writer.Write(CommandOp::SetGraphicsRootConstantBufferView, { 1, 9, draw * 256 });
+            writer.Write(CommandOp::Draw, { 36, 1, 0, 0 });
+        }
+        writer.Write(CommandOp::Transition, { 6 + frame % 3, 0, 4, 0 });
+        writer.Write(CommandOp::CloseCommandList, { 1 });
+        writer.Write(CommandOp::ExecuteCommandList, { 1 });
+        writer.Write(CommandOp::Present, { 0 });
+        writer.EndFrame();
+    }
+}
+
+BENCHMARK(CommandStream, RecordAndReplay)
+{
+    const uint32_t frameCount = 100;
+    const uint32_t drawCount = 10000;
+    std::string stream;
+    uint64_t packets = 0;
+    LinearArena arena(1024 * 1024);
+    const double recordSeconds = BestSeconds(3, [&]()
+    {
+        std::ostringstream out;
+        CommandStreamWriter writer(out);
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            arena.Reset();
+            RecordFrame(writer, arena, frame, drawCount);
+        }
+        packets = writer.GetPacketCount();
+        stream = out.str();
+    });
+    Report("Record", recordSeconds * 1e9 / packets, "ns/packet");
+    Report("Size", double(stream.size()) / packets, "bytes/packet");
+    Report("Size per frame", double(stream.size()) / frameCount / 1024, "KB");
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(stream.data());
+    const double replaySeconds = BestSeconds(5, [&]()
+    {
+        CommandStreamReader reader(data, stream.size());
+        NullCommandBackend backend;
+        ReplayCommandStream(reader, backend);
+    });
+    Report("Replay, null backend", packets / replaySeconds / 1e6, "M packets/s");
+}
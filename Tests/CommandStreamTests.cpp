@@ -0,0 +1,298 @@
+#include "TestFramework.h"
+
+#include "CommandStream.h"
+#include "FrameAllocators.h"
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct RecordedPacket
+    {
+        CommandOp Op;
+        uint32_t Fields[MaxCommandFields];
+        std::vector<uint8_t> Data;
+    };
+
+    // Random packets of every operation: fields that mostly walk in small steps, sometimes jump
+    // anywhere, and data that is sometimes compressible.
+    std::vector<RecordedPacket> MakePackets(size_t count, TestRandom& random)
+    {
+        std::vector<RecordedPacket> packets;
+        uint32_t walk[MaxCommandFields] = {};
+        for (size_t i = 0; i < count; ++i)
+        {
+            RecordedPacket packet = {};
+            packet.Op = static_cast<CommandOp>(random.NextBelow(static_cast<uint32_t>(CommandOp::Count)));
+            for (uint32_t f = 0; f < GetCommandFieldCount(packet.Op); ++f)
+            {
+                walk[f] += random.NextBelow(4) == 0 ? static_cast<uint32_t>(random.Next() >> 32) : random.NextBelow(8);
+                packet.Fields[f] = walk[f];
+            }
+            if (CommandHasData(packet.Op))
+            {
+                const uint32_t size = random.NextBelow(3) == 0 ? random.NextBelow(5000) : random.NextBelow(100);
+                const bool runs = random.NextBelow(2) == 0;
+                for (uint32_t b = 0; b < size; ++b)
+                {
+                    packet.Data.push_back(runs ? static_cast<uint8_t>(b / 32) : random.NextByte());
+                }
+            }
+            packets.push_back(packet);
+        }
+        return packets;
+    }
+
+    void WritePacket(CommandStreamWriter& writer, const RecordedPacket& packet)
+    {
+        writer.Write(packet.Op, packet.Fields, packet.Data.data(), packet.Data.size());
+    }
+
+    bool Matches(const CommandPacket& read, const RecordedPacket& written)
+    {
+        return read.Op == written.Op &&
+            memcmp(read.Fields, written.Fields, sizeof(read.Fields)) == 0 &&
+            read.DataSize == written.Data.size() &&
+            (written.Data.empty() || memcmp(read.Data, written.Data.data(), read.DataSize) == 0);
+    }
+
+    std::vector<uint8_t> GetBytes(const std::ostringstream& out)
+    {
+        const std::string text = out.str();
+        return std::vector<uint8_t>(text.begin(), text.end());
+    }
+}
+
+TEST(CommandStream, RoundTrip)
+{
+    // Setup packets, then frames recorded into a frame arena, read back field for field.
+    TestRandom random;
+    std::vector<RecordedPacket> packets = MakePackets(200, random);
+    std::ostringstream out;
+    {
+        CommandStreamWriter writer(out);
+        for (const RecordedPacket& packet : packets)
+        {
+            WritePacket(writer, packet);
+        }
+
+        LinearArena arena(64 * 1024);
+        for (uint32_t frame = 0; frame < 20; ++frame)
+        {
+            arena.Reset();
+            writer.BeginFrame(arena, frame, frame % 3);
+            RecordedPacket begin = {};
+            begin.Op = CommandOp::FrameBegin;
+            begin.Fields[0] = frame;
+            begin.Fields[1] = frame % 3;
+            packets.push_back(begin);
+            for (const RecordedPacket& packet : MakePackets(500, random))
+            {
+                WritePacket(writer, packet);
+                packets.push_back(packet);
+            }
+            writer.EndFrame();
+        }
+        writer.Flush();
+        CHECK_EQUAL(uint64_t(packets.size()), writer.GetPacketCount());
+        CHECK_EQUAL(uint64_t(out.str().size()), writer.GetBytesWritten());
+    }
+
+    const std::vector<uint8_t> bytes = GetBytes(out);
+    CommandStreamReader reader(bytes.data(), bytes.size());
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        size_t read = 0;
+        size_t mismatches = 0;
+        CommandPacket packet;
+        while (reader.Next(packet))
+        {
+            mismatches += read < packets.size() && Matches(packet, packets[read]) ? 0 : 1;
+            ++read;
+        }
+        CHECK_EQUAL(packets.size(), read);
+        CHECK_EQUAL(size_t(0), mismatches);
+        CHECK_EQUAL(bytes.size(), reader.GetOffset());
+        reader.Rewind();
+    }
+}
+
+TEST(CommandStream, DrawLoopsAreCompact)
+{
+    // Draws walking a vertex buffer repeat the same deltas: after the first two, one byte each.
+    std::ostringstream out;
+    CommandStreamWriter writer(out);
+    const uint64_t header = writer.GetBytesWritten();
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        writer.Write(CommandOp::Draw, { 6, 1, i * 6, 0 });
+    }
+    writer.Flush();
+    CHECK(writer.GetBytesWritten() - header < 1000 + 16);
+
+    // Large compressible data is stored compressed.
+    std::vector<uint8_t> zeros(64 * 1024);
+    const uint64_t before = writer.GetBytesWritten();
+    writer.Write(CommandOp::WriteBuffer, { 1, 0 }, zeros.data(), zeros.size());
+    writer.Flush();
+    CHECK(writer.GetBytesWritten() - before < 1024);
+
+    const std::vector<uint8_t> bytes = GetBytes(out);
+    CommandStreamReader reader(bytes.data(), bytes.size());
+    CommandPacket packet;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        REQUIRE(reader.Next(packet));
+        CHECK(packet.Op == CommandOp::Draw && packet.Fields[2] == i * 6 && packet.Fields[0] == 6);
+    }
+    REQUIRE(reader.Next(packet));
+    CHECK(packet.Op == CommandOp::WriteBuffer);
+    CHECK(packet.DataSize == zeros.size() && memcmp(packet.Data, zeros.data(), zeros.size()) == 0);
+    CHECK(!reader.Next(packet));
+}
+
+TEST(CommandStream, NullBackendReplay)
+{
+    std::ostringstream out;
+    {
+        CommandStreamWriter writer(out);
+        writer.Write(CommandOp::DefineObject, { 1, static_cast<uint32_t>(CommandObjectType::CommandList) }, "list", 4);
+        LinearArena arena(4096);
+        for (uint32_t frame = 0; frame < 3; ++frame)
+        {
+            writer.BeginFrame(arena, frame, frame);
+            writer.Write(CommandOp::ResetCommandList, { 1, 2, 0 });
+            writer.Write(CommandOp::SetViewport, { 0, 0, CommandFloatBits(1280.0f), CommandFloatBits(720.0f), 0, CommandFloatBits(1.0f) });
+            const float constants[4] = { 1, 2, 3, 4 };
+            writer.Write(CommandOp::SetGraphicsRoot32BitConstants, { 0, 0 }, constants, sizeof(constants));
+            for (uint32_t draw = 0; draw < 10; ++draw)
+            {
+                writer.Write(CommandOp::Draw, { 3, 1, draw * 3, 0 });
+            }
+            writer.Write(CommandOp::CloseCommandList, { 1 });
+            writer.Write(CommandOp::ExecuteCommandList, { 1 });
+            writer.Write(CommandOp::Present, { 1 });
+            writer.EndFrame();
+        }
+    }
+
+    const std::vector<uint8_t> bytes = GetBytes(out);
+    CommandStreamReader reader(bytes.data(), bytes.size());
+    NullCommandBackend backend;
+    CHECK_EQUAL(uint64_t(1 + 3 * 17), ReplayCommandStream(reader, backend));
+    CHECK_EQUAL(uint64_t(30), backend.GetCount(CommandOp::Draw));
+    CHECK_EQUAL(uint64_t(3), backend.GetCount(CommandOp::FrameBegin));
+    CHECK_EQUAL(uint64_t(3), backend.GetCount(CommandOp::Present));
+    CHECK_EQUAL(uint64_t(1), backend.GetCount(CommandOp::DefineObject));
+    CHECK_EQUAL(uint64_t(0), backend.GetCount(CommandOp::Transition));
+    CHECK_EQUAL(uint64_t(4 + 3 * 16), backend.GetDataBytes());
+
+    // The reader is at the end; nothing more to replay.
+    CHECK_EQUAL(uint64_t(0), ReplayCommandStream(reader, backend));
+    CHECK_EQUAL(std::string("Draw"), std::string(GetCommandOpName(CommandOp::Draw)));
+    CHECK_EQUAL(-2.5f, CommandBitsFloat(CommandFloatBits(-2.5f)));
+}
+
+TEST(CommandStream, RejectsMalformedStreams)
+{
+    TestRandom random;
+    const std::vector<RecordedPacket> packets = MakePackets(300, random);
+    std::ostringstream out;
+    {
+        CommandStreamWriter writer(out);
+        for (const RecordedPacket& packet : packets)
+        {
+            WritePacket(writer, packet);
+        }
+        writer.Flush();
+    }
+    const std::vector<uint8_t> bytes = GetBytes(out);
+
+    auto constructorThrows = [](const std::vector<uint8_t>& stream)
+    {
+        try
+        {
+            CommandStreamReader reader(stream.data(), stream.size());
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    };
+    std::vector<uint8_t> damaged = bytes;
+    damaged[0] ^= 1;
+    CHECK(constructorThrows(damaged));
+    damaged = bytes;
+    damaged[4] ^= 1;
+    CHECK(constructorThrows(damaged));
+    CHECK(constructorThrows(std::vector<uint8_t>(bytes.begin(), bytes.begin() + 7)));
+
+    // Cut anywhere or damaged anywhere, the reader throws or stops; it never reads past the end
+    // (each copy is exactly sized, for the sanitizers).
+    uint32_t clean = 0;
+    for (int trial = 0; trial < 400; ++trial)
+    {
+        std::vector<uint8_t> stream(bytes.begin(), bytes.begin() + 8 + random.NextBelow(static_cast<uint32_t>(bytes.size() - 8)));
+        if (trial % 2 == 1)
+        {
+            stream = bytes;
+            stream[8 + random.NextBelow(static_cast<uint32_t>(bytes.size() - 8))] ^= static_cast<uint8_t>(1 + random.NextBelow(255));
+        }
+        CommandStreamReader reader(stream.data(), stream.size());
+        NullCommandBackend backend;
+        try
+        {
+            ReplayCommandStream(reader, backend);
+            ++clean;
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        CHECK(reader.GetOffset() <= stream.size());
+    }
+    CHECK(clean < 400);
+}
+
+TEST(CommandStream, RejectsImpossibleExpansion)
+{
+    // One compressed WriteBuffer packet, whose data size is then raised to 4 GB: more than LZ4 can
+    // expand the stored bytes to. The reader rejects it before allocating for it.
+    std::ostringstream out;
+    {
+        CommandStreamWriter writer(out);
+        const std::vector<uint8_t> zeros(4096, 0);
+        writer.Write(CommandOp::WriteBuffer, { 0, 0 }, zeros.data(), zeros.size());
+        writer.Flush();
+    }
+    const std::vector<uint8_t> bytes = GetBytes(out);
+    // Header, operation, two one byte fields, then the size 4096 as a two byte varint.
+    REQUIRE(bytes.size() > 13 && bytes[11] == 0x80 && bytes[12] == 0x20);
+    {
+        CommandStreamReader reader(bytes.data(), bytes.size());
+        CommandPacket packet;
+        REQUIRE(reader.Next(packet));
+        CHECK_EQUAL(size_t(4096), packet.DataSize);
+    }
+
+    std::vector<uint8_t> damaged(bytes.begin(), bytes.begin() + 11);
+    const uint8_t hugeSize[] = { 0xff, 0xff, 0xff, 0xff, 0x0f };
+    damaged.insert(damaged.end(), hugeSize, hugeSize + sizeof(hugeSize));
+    damaged.insert(damaged.end(), bytes.begin() + 13, bytes.end());
+    CommandStreamReader reader(damaged.data(), damaged.size());
+    CommandPacket packet;
+    std::string message;
+    try
+    {
+        reader.Next(packet);
+    }
+    catch (const std::runtime_error& error)
+    {
+        message = error.what();
+    }
+    CHECK_EQUAL(std::string("Malformed command stream data size."), message);
+}
@@ -0,0 +1,69 @@
+#include "BenchmarkFramework.h"
+#include "TestFramework.h"
+#include "ZstdVectors.h"
+
+#include "Lz4.h"
+#include "Zstd.h"
+
+#include <vector>
+
+namespace
+{
+    // Gradients with sparse noise: about half compresses, as with the sample textures.
+    std::vector<uint8_t> MakeImage(uint32_t width, uint32_t height)
+    {
+        TestRandom random;
+        std::vector<uint8_t> image(size_t(width) * height * 4);
+        for (size_t i = 0; i < image.size(); ++i)
+        {
+            image[i] = static_cast<uint8_t>((i / 4) % width / 4 + (i % 4) * 40 + (random.NextByte() < 32 ? 1 : 0));
+        }
+        return image;
+    }
+}
+
+BENCHMARK(Lz4, Image)
+{
+    const std::vector<uint8_t> image = MakeImage(1024, 1024);
+    std::vector<uint8_t> compressed(Lz4CompressBound(image.size()));
+    size_t compressedSize = 0;
+    ReportBytes("Compress", double(image.size()), BestSeconds(3, [&]()
+    {
+        compressedSize = Lz4Compress(image.data(), image.size(), compressed.data(), compressed.size());
+    }));
+    Report("Ratio", double(image.size()) / double(compressedSize), ":1");
+    std::vector<uint8_t> output(image.size());
+    ReportBytes("Decompress", double(image.size()), BestSeconds(5, [&]()
+    {
+        Lz4Decompress(compressed.data(), compressedSize, output.data(), output.size());
+    }));
+}
+
+BENCHMARK(Zstd, Words)
+{
+    // The 6000 bytes of words of the reference frames, decoded from the level 19 frame, and the
+    // same text through LZ4 for comparison.
+    const size_t repeats = 2000;
+    std::vector<uint8_t> output(6000);
+    ReportBytes("Decompress (level 19)", 6000.0 * repeats, BestSeconds(5, [&]()
+    {
+        for (size_t i = 0; i < repeats; ++i)
+        {
+            ZstdDecompress(ZstdVectors::WordsLevel19, sizeof(ZstdVectors::WordsLevel19), output.data(), output.size());
+        }
+    }));
+    Report("Ratio (level 19)", 6000.0 / sizeof(ZstdVectors::WordsLevel19), ":1");
+
+    ZstdDecompress(ZstdVectors::WordsLevel19, sizeof(ZstdVectors::WordsLevel19), output.data(), output.size());
+    std::vector<uint8_t> compressed(Lz4CompressBound(output.size()));
+    const size_t compressedSize = Lz4Compress(output.data(), output.size(), compressed.data(), compressed.size());
+    std::vector<uint8_t> decompressed(output.size());
+    ReportBytes("Lz4 decompress, same text", 6000.0 * repeats, BestSeconds(5, [&]()
+    {
+        for (size_t i = 0; i < repeats; ++i)
+        {
+            Lz4Decompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size());
+        }
+    }));
+    Report("Lz4 ratio, same text", 6000.0 / compressedSize, ":1");
+}
@@ -0,0 +1,200 @@
+#include "TestFramework.h"
+#include "ZstdVectors.h"
+
+#include "Lz4.h"
+#include "Zstd.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Text of a few repeated words: literals for the Huffman coder and matches for the sequences.
+    std::vector<uint8_t> MakeWords(size_t size)
+    {
+        static const char* const Words[] =
+        {
+            "texture ", "level ", "block ", "frame ", "fence ", "upload ", "heap ", "the ", "a ", "mip\n", "0123 ", "queue "
+        };
+        TestRandom random;
+        std::string text;
+        while (text.size() < size)
+        {
+            text += Words[(random.Next() >> 56) % (sizeof(Words) / sizeof(Words[0]))];
+        }
+        return std::vector<uint8_t>(text.begin(), text.begin() + size);
+    }
+
+    std::vector<uint8_t> MakeNoise(size_t size)
+    {
+        TestRandom random;
+        std::vector<uint8_t> bytes(size);
+        for (uint8_t& byte : bytes)
+        {
+            byte = random.NextByte();
+        }
+        return bytes;
+    }
+
+    // Pixel-like data: smooth runs with a little noise, what the asset archive mostly holds.
+    std::vector<uint8_t> MakeImage(size_t size)
+    {
+        TestRandom random;
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            bytes[i] = static_cast<uint8_t>((i / 4) % 64 + (i % 4) * 50 + (random.NextByte() & 3));
+        }
+        return bytes;
+    }
+
+    void CheckLz4RoundTrip(const std::vector<uint8_t>& source)
+    {
+        std::vector<uint8_t> compressed(Lz4CompressBound(source.size()));
+        const size_t compressedSize = Lz4Compress(source.data(), source.size(), compressed.data(), compressed.size());
+        REQUIRE(compressedSize != 0 || source.empty());
+
+        std::vector<uint8_t> decompressed(source.size() + 1, 0xCD);
+        CHECK(Lz4Decompress(compressed.data(), compressedSize, decompressed.data(), source.size()));
+        CHECK(std::equal(source.begin(), source.end(), decompressed.begin()));
+        CHECK_EQUAL(0xCD, decompressed[source.size()]);
+    }
+
+    bool DecompressZstd(const uint8_t* frame, size_t frameSize, std::vector<uint8_t>& output, size_t size)
+    {
+        output.assign(size, 0);
+        return ZstdDecompress(frame, frameSize, output.data(), output.size());
+    }
+
+    std::vector<uint8_t> Concatenate(const std::vector<uint8_t>& first, const std::vector<uint8_t>& second)
+    {
+        std::vector<uint8_t> result(first);
+        result.insert(result.end(), second.begin(), second.end());
+        return result;
+    }
+}
+
+TEST(Lz4, RoundTrip)
+{
+    for (size_t size : { size_t(0), size_t(1), size_t(12), size_t(13), size_t(100), size_t(65536), size_t(300000) })
+    {
+        CheckLz4RoundTrip(MakeWords(size));
+        CheckLz4RoundTrip(MakeNoise(size));
+        CheckLz4RoundTrip(MakeImage(size));
+        CheckLz4RoundTrip(std::vector<uint8_t>(size, 7));
+    }
+}
+
+TEST(Lz4, CompressesRedundantData)
+{
+    // Random words leave little for a compressor without entropy coding; a run compresses to
+    // almost nothing.
+    const std::vector<uint8_t> words = MakeWords(100000);
+    std::vector<uint8_t> compressed(Lz4CompressBound(words.size()));
+    size_t compressedSize = Lz4Compress(words.data(), words.size(), compressed.data(), compressed.size());
+    CHECK(compressedSize != 0 && compressedSize < words.size() / 2);
+
+    const std::vector<uint8_t> zeros(100000, 0);
+    compressedSize = Lz4Compress(zeros.data(), zeros.size(), compressed.data(), compressed.size());
+    CHECK(compressedSize != 0 && compressedSize < zeros.size() / 200);
+}
+
+TEST(Lz4, RejectsWrongSizesAndTruncation)
+{
+    const std::vector<uint8_t> source = MakeWords(5000);
+    std::vector<uint8_t> compressed(Lz4CompressBound(source.size()));
+    const size_t compressedSize = Lz4Compress(source.data(), source.size(), compressed.data(), compressed.size());
+    std::vector<uint8_t> output(source.size() + 1);
+
+    CHECK(!Lz4Decompress(compressed.data(), compressedSize, output.data(), source.size() - 1));
+    CHECK(!Lz4Decompress(compressed.data(), compressedSize, output.data(), source.size() + 1));
+    for (size_t size = 0; size < compressedSize; size += 7)
+    {
+        CHECK(!Lz4Decompress(compressed.data(), size, output.data(), source.size()));
+    }
+
+    // A destination too small for the output.
+    std::vector<uint8_t> small(Lz4CompressBound(source.size()) / 2);
+    CHECK_EQUAL(size_t(0), Lz4Compress(MakeNoise(5000).data(), 5000, small.data(), small.size()));
+}
+
+TEST(Lz4, CorruptInputStaysInBounds)
+{
+    const std::vector<uint8_t> source = MakeImage(4000);
+    std::vector<uint8_t> compressed(Lz4CompressBound(source.size()));
+    const size_t compressedSize = Lz4Compress(source.data(), source.size(), compressed.data(), compressed.size());
+    compressed.resize(compressedSize);
+
+    // Only the result is unknown; run under a sanitizer to check the bounds.
+    std::vector<uint8_t> output(source.size());
+    TestRandom random(7);
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::vector<uint8_t> corrupt = compressed;
+        corrupt[random.NextBelow(static_cast<uint32_t>(corrupt.size()))] ^= static_cast<uint8_t>(1 << random.NextBelow(8));
+        Lz4Decompress(corrupt.data(), corrupt.size(), output.data(), output.size());
+    }
+}
+
+TEST(Zstd, DecodesReferenceFrames)
+{
+    const std::vector<uint8_t> words = MakeWords(6000);
+    std::vector<uint8_t> output;
+
+    CHECK(DecompressZstd(ZstdVectors::WordsLevel1, sizeof(ZstdVectors::WordsLevel1), output, words.size()));
+    CHECK(output == words);
+    CHECK(DecompressZstd(ZstdVectors::WordsLevel3, sizeof(ZstdVectors::WordsLevel3), output, words.size()));
+    CHECK(output == words);
+    CHECK(DecompressZstd(ZstdVectors::WordsLevel19, sizeof(ZstdVectors::WordsLevel19), output, words.size()));
+    CHECK(output == words);
+}
+
+TEST(Zstd, DecodesRleRawAndSkippableFrames)
+{
+    const std::vector<uint8_t> expected = Concatenate(std::vector<uint8_t>(1000, 'a'), MakeNoise(200));
+    std::vector<uint8_t> output;
+    CHECK(DecompressZstd(ZstdVectors::RleRawWithSkippable, sizeof(ZstdVectors::RleRawWithSkippable), output, expected.size()));
+    CHECK(output == expected);
+}
+
+TEST(Zstd, RejectsWrongSizesAndTruncation)
+{
+    const uint8_t* frame = ZstdVectors::WordsLevel3;
+    const size_t frameSize = sizeof(ZstdVectors::WordsLevel3);
+    std::vector<uint8_t> output;
+
+    CHECK(!DecompressZstd(frame, frameSize, output, 5999));
+    CHECK(!DecompressZstd(frame, frameSize, output, 6001));
+    for (size_t size = 0; size < frameSize; ++size)
+    {
+        CHECK(!DecompressZstd(frame, size, output, 6000));
+    }
+}
+
+TEST(Zstd, RejectsBadChecksum)
+{
+    std::vector<uint8_t> frame(ZstdVectors::WordsLevel19, ZstdVectors::WordsLevel19 + sizeof(ZstdVectors::WordsLevel19));
+    frame.back() ^= 0x01;
+    std::vector<uint8_t> output;
+    CHECK(!DecompressZstd(frame.data(), frame.size(), output, 6000));
+}
+
+TEST(Zstd, CorruptInputStaysInBounds)
+{
+    const uint8_t* const frames[] = { ZstdVectors::WordsLevel1, ZstdVectors::WordsLevel19 };
+    const size_t frameSizes[] = { sizeof(ZstdVectors::WordsLevel1), sizeof(ZstdVectors::WordsLevel19) };
+
+    // Only the result is unknown; run under a sanitizer to check the bounds.
+    std::vector<uint8_t> output(6000);
+    TestRandom random(11);
+    for (int f = 0; f < 2; ++f)
+    {
+        for (int i = 0; i < 3000; ++i)
+        {
+            std::vector<uint8_t> corrupt(frames[f], frames[f] + frameSizes[f]);
+            corrupt[random.NextBelow(static_cast<uint32_t>(corrupt.size()))] ^= static_cast<uint8_t>(1 << random.NextBelow(8));
+            ZstdDecompress(corrupt.data(), corrupt.size(), output.data(), output.size());
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#include "BenchmarkFramework.h"
+#include "TestFramework.h"
+
+#include "ContentHash.h"
+
+#include <vector>
+
+BENCHMARK(ContentHash, Throughput)
+{
+    // Large payloads (textures, archive chunks) and short keys.
+    std::vector<uint8_t> bytes(16 * 1024 * 1024);
+    TestRandom random;
+    for (uint8_t& byte : bytes)
+    {
+        byte = random.NextByte();
+    }
+    volatile uint64_t sink = 0;
+    ReportBytes("16 MB", double(bytes.size()), BestSeconds(5, [&]() { sink = sink + HashContent(bytes.data(), bytes.size()); }));
+    ReportBytes("64 B keys", 64.0 * 100000, BestSeconds(5, [&]()
+    {
+        for (size_t i = 0; i < 100000; ++i)
+        {
+            sink = sink + HashContent(bytes.data() + i * 64, 64);
+        }
+    }));
+    ReportBytes("Reference, 16 MB", double(bytes.size()), BestSeconds(1, [&]() { sink = sink + HashContentReference(bytes.data(), bytes.size()); }));
+}
@@ -0,0 +1,102 @@
+#include "TestFramework.h"
+
+#include "ContentHash.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    std::vector<uint8_t> MakeBytes(size_t size)
+    {
+        TestRandom random;
+        std::vector<uint8_t> bytes(size);
+        for (uint8_t& byte : bytes)
+        {
+            byte = random.NextByte();
+        }
+        return bytes;
+    }
+
+    // XXH3_64bits of the first Size bytes of MakeBytes, from the reference xxHash library. The
+    // sizes cover each of its code paths (0, 1-3, 4-8, 9-16, 17-128, 129-240, long) and the ends
+    // of its stripes and blocks.
+    struct ReferenceHash
+    {
+        size_t Size;
+        uint64_t Hash;
+    };
+
+    const ReferenceHash ReferenceHashes[] =
+    {
+        { 0, 0x2D06800538D394C2ull },
+        { 1, 0x32CD626F54BA457Eull },
+        { 3, 0x35C59C63F67C71A2ull },
+        { 4, 0x014BD96CDB45C430ull },
+        { 8, 0x065D72EAA49E406Bull },
+        { 9, 0xB5D7BCF9493DD00Eull },
+        { 16, 0x0C9057C1B3EF2E34ull },
+        { 17, 0xFEEDDBF262130327ull },
+        { 64, 0x48BFB9D77B4958FEull },
+        { 128, 0x218476E38AAED14Bull },
+        { 129, 0x9FD3F0D53E509B70ull },
+        { 240, 0xEC4B87AD468105D4ull },
+        { 241, 0x6F7BEF3AD1555088ull },
+        { 255, 0x8574A58419642E9Full },
+        { 256, 0xF5F373E77768F425ull },
+        { 1024, 0xC768E7D19AABF178ull },
+        { 1025, 0xACCE310A930447F1ull },
+        { 4096, 0xF001877CB36E0278ull },
+        { 100000, 0x3A9EA31FDBBD930Dull },
+    };
+}
+
+TEST(ContentHash, MatchesReferenceXxh3)
+{
+    const std::vector<uint8_t> bytes = MakeBytes(100000);
+    for (const ReferenceHash& reference : ReferenceHashes)
+    {
+        CHECK_EQUAL(reference.Hash, HashContent(bytes.data(), reference.Size));
+        CHECK_EQUAL(reference.Hash, HashContentReference(bytes.data(), reference.Size));
+    }
+}
+
+TEST(ContentHash, VectorKernelsMatchScalar)
+{
+    const std::vector<uint8_t> bytes = MakeBytes(20000);
+    for (size_t size = 0; size <= 2100; ++size)
+    {
+        CHECK_EQUAL(HashContentReference(bytes.data(), size), HashContent(bytes.data(), size));
+    }
+    for (size_t size = 2100; size <= bytes.size(); size += 997)
+    {
+        CHECK_EQUAL(HashContentReference(bytes.data(), size), HashContent(bytes.data(), size));
+    }
+}
+
+TEST(ContentHash, IndependentOfAlignment)
+{
+    const std::vector<uint8_t> bytes = MakeBytes(5000);
+    std::vector<uint8_t> shifted(bytes.size() + 64);
+    for (size_t size : { size_t(7), size_t(200), size_t(1500), size_t(5000) })
+    {
+        const uint64_t expected = HashContent(bytes.data(), size);
+        for (size_t offset = 1; offset < 64; ++offset)
+        {
+            memcpy(shifted.data() + offset, bytes.data(), size);
+            CHECK_EQUAL(expected, HashContent(shifted.data() + offset, size));
+        }
+    }
+}
+
+TEST(ContentHash, SensitiveToEveryByte)
+{
+    std::vector<uint8_t> bytes = MakeBytes(1000);
+    const uint64_t original = HashContent(bytes.data(), bytes.size());
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] ^= 1;
+        CHECK(HashContent(bytes.data(), bytes.size()) != original);
+        bytes[i] ^= 1;
+    }
+}
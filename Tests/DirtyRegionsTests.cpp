@@ -0,0 +1,236 @@
+#include "TestFramework.h"
+
+#include "DirtyRegions.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    // Pixel-level reference: what was marked, and whether the rectangles cover it.
+    class PixelMask
+    {
+    public:
+        PixelMask(uint32_t width, uint32_t height) : m_width(width), m_height(height), m_pixels(size_t(width) * height, 0) {}
+
+        void Mark(const DirtyRect& rect)
+        {
+            for (uint32_t y = rect.Top; y < std::min(rect.Bottom, m_height); ++y)
+            {
+                for (uint32_t x = rect.Left; x < std::min(rect.Right, m_width); ++x)
+                {
+                    m_pixels[size_t(y) * m_width + x] = 1;
+                }
+            }
+        }
+
+        bool CoveredBy(const std::vector<DirtyRect>& rects, size_t count) const
+        {
+            std::vector<uint8_t> covered(m_pixels.size(), 0);
+            for (size_t i = 0; i < count; ++i)
+            {
+                for (uint32_t y = rects[i].Top; y < rects[i].Bottom; ++y)
+                {
+                    std::fill(covered.begin() + size_t(y) * m_width + rects[i].Left, covered.begin() + size_t(y) * m_width + rects[i].Right, uint8_t(1));
+                }
+            }
+            for (size_t i = 0; i < m_pixels.size(); ++i)
+            {
+                if (m_pixels[i] != 0 && covered[i] == 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void Clear() { std::fill(m_pixels.begin(), m_pixels.end(), uint8_t(0)); }
+
+    private:
+        uint32_t m_width;
+        uint32_t m_height;
+        std::vector<uint8_t> m_pixels;
+    };
+
+    bool InsideImage(const DirtyRect& rect, uint32_t width, uint32_t height)
+    {
+        return rect.Left < rect.Right && rect.Top < rect.Bottom && rect.Right <= width && rect.Bottom <= height;
+    }
+
+    uint64_t GetArea(const DirtyRect& rect)
+    {
+        return uint64_t(rect.Right - rect.Left) * (rect.Bottom - rect.Top);
+    }
+
+    DirtyRect MakeRandomRect(TestRandom& random, uint32_t width, uint32_t height)
+    {
+        // Mostly small strokes, some past the edges of the image.
+        const uint32_t left = random.NextBelow(width + 20);
+        const uint32_t top = random.NextBelow(height + 20);
+        return { left, top, left + 1 + random.NextBelow(60), top + 1 + random.NextBelow(40) };
+    }
+}
+
+TEST(DirtyRegions, CleanTrackerCollectsNothing)
+{
+    DirtyRegionTracker tracker(300, 200);
+    std::vector<DirtyRect> rects;
+    CHECK(!tracker.IsDirty());
+    CHECK_EQUAL(size_t(0), tracker.Collect(rects));
+
+    // Empty and fully clipped rectangles are ignored.
+    tracker.MarkDirty({ 10, 10, 10, 50 });
+    tracker.MarkDirty({ 10, 10, 50, 10 });
+    tracker.MarkDirty({ 300, 0, 400, 100 });
+    tracker.MarkDirty({ 0, 200, 100, 300 });
+    CHECK(!tracker.IsDirty());
+    CHECK_EQUAL(size_t(0), tracker.Collect(rects));
+}
+
+TEST(DirtyRegions, MarkAllDirtyCollectsTheImage)
+{
+    DirtyRegionTracker tracker(300, 200);
+    tracker.MarkAllDirty();
+    std::vector<DirtyRect> rects;
+    REQUIRE(tracker.Collect(rects) == 1);
+    CHECK_EQUAL(0u, rects[0].Left);
+    CHECK_EQUAL(0u, rects[0].Top);
+    CHECK_EQUAL(300u, rects[0].Right);
+    CHECK_EQUAL(200u, rects[0].Bottom);
+    CHECK(!tracker.IsDirty());
+}
+
+TEST(DirtyRegions, RectsCoverMarkedPixels)
+{
+    // Sizes that are and are not multiples of the tile.
+    const uint32_t sizes[][3] = { { 256, 128, 32 }, { 301, 177, 32 }, { 97, 61, 8 }, { 40, 40, 64 } };
+    TestRandom random;
+    for (const uint32_t* size : sizes)
+    {
+        const uint32_t width = size[0];
+        const uint32_t height = size[1];
+        DirtyRegionTracker tracker(width, height, size[2]);
+        PixelMask mask(width, height);
+        std::vector<DirtyRect> rects;
+
+        for (int frame = 0; frame < 200; ++frame)
+        {
+            const uint32_t marks = random.NextBelow(12);
+            for (uint32_t i = 0; i < marks; ++i)
+            {
+                const DirtyRect rect = MakeRandomRect(random, width, height);
+                tracker.MarkDirty(rect);
+                mask.Mark(rect);
+            }
+
+            const size_t maxRects = 1 + random.NextBelow(8);
+            const size_t count = tracker.Collect(rects, maxRects);
+            CHECK(count <= maxRects);
+            CHECK(!tracker.IsDirty());
+            bool inside = true;
+            for (size_t i = 0; i < count; ++i)
+            {
+                inside &= InsideImage(rects[i], width, height);
+            }
+            CHECK(inside);
+            CHECK(mask.CoveredBy(rects, count));
+            mask.Clear();
+        }
+    }
+}
+
+TEST(DirtyRegions, UnmergedRectsAreExactTiles)
+{
+    // Without the merge limit the rectangles are the dirty tiles exactly: disjoint, tile
+    // aligned, nothing clean inside.
+    const uint32_t width = 333;
+    const uint32_t height = 250;
+    const uint32_t tileSize = 16;
+    const uint32_t tilesX = (width + tileSize - 1) / tileSize;
+    const uint32_t tilesY = (height + tileSize - 1) / tileSize;
+    DirtyRegionTracker tracker(width, height, tileSize);
+    TestRandom random(3);
+    std::vector<DirtyRect> rects;
+
+    for (int frame = 0; frame < 100; ++frame)
+    {
+        std::vector<uint8_t> tiles(size_t(tilesX) * tilesY, 0);
+        for (uint32_t i = random.NextBelow(20); i > 0; --i)
+        {
+            const DirtyRect rect = MakeRandomRect(random, width, height);
+            tracker.MarkDirty(rect);
+            if (rect.Left >= width || rect.Top >= height)
+            {
+                continue;
+            }
+            for (uint32_t y = rect.Top / tileSize; y <= (std::min(rect.Bottom, height) - 1) / tileSize; ++y)
+            {
+                for (uint32_t x = rect.Left / tileSize; x <= (std::min(rect.Right, width) - 1) / tileSize; ++x)
+                {
+                    tiles[size_t(y) * tilesX + x] = 1;
+                }
+            }
+        }
+
+        const size_t count = tracker.Collect(rects, tilesX * tilesY);
+        std::vector<uint8_t> covered(tiles.size(), 0);
+        bool disjoint = true;
+        bool aligned = true;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const DirtyRect& rect = rects[i];
+            aligned &= rect.Left % tileSize == 0 && rect.Top % tileSize == 0;
+            aligned &= rect.Right % tileSize == 0 || rect.Right == width;
+            aligned &= rect.Bottom % tileSize == 0 || rect.Bottom == height;
+            for (uint32_t y = rect.Top / tileSize; y < (rect.Bottom + tileSize - 1) / tileSize; ++y)
+            {
+                for (uint32_t x = rect.Left / tileSize; x < (rect.Right + tileSize - 1) / tileSize; ++x)
+                {
+                    disjoint &= covered[size_t(y) * tilesX + x] == 0;
+                    covered[size_t(y) * tilesX + x] = 1;
+                }
+            }
+        }
+        CHECK(disjoint);
+        CHECK(aligned);
+        CHECK(covered == tiles);
+    }
+}
+
+TEST(DirtyRegions, MergesToOneRect)
+{
+    // Two far corners with a limit of one: the bounding box of both.
+    DirtyRegionTracker tracker(512, 512);
+    tracker.MarkDirty({ 5, 5, 10, 10 });
+    tracker.MarkDirty({ 500, 480, 510, 490 });
+    std::vector<DirtyRect> rects;
+    REQUIRE(tracker.Collect(rects, 1) == 1);
+    CHECK_EQUAL(0u, rects[0].Left);
+    CHECK_EQUAL(0u, rects[0].Top);
+    CHECK_EQUAL(512u, rects[0].Right);
+    CHECK_EQUAL(512u, rects[0].Bottom);
+}
+
+TEST(DirtyRegions, Stats)
+{
+    DirtyRegionTracker tracker(256, 256);
+    std::vector<DirtyRect> rects;
+    tracker.MarkDirty({ 0, 0, 10, 10 });
+    tracker.MarkDirty({ 5, 5, 15, 15 });
+    tracker.MarkDirty({ 100, 100, 140, 110 });
+    const size_t count = tracker.Collect(rects);
+    tracker.Collect(rects);
+
+    uint64_t collected = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        collected += GetArea(rects[i]);
+    }
+    const DirtyRegionStats& stats = tracker.GetStats();
+    CHECK_EQUAL(uint64_t(1), stats.Collects);
+    CHECK_EQUAL(uint64_t(count), stats.Rects);
+    CHECK_EQUAL(uint64_t(100 + 100 + 400), stats.MarkedPixels);
+    // One tile, and 2x1 tiles from 96 to 160.
+    CHECK_EQUAL(uint64_t(3 * 32 * 32), stats.DirtyPixels);
+    CHECK_EQUAL(collected, stats.CollectedPixels);
+}
@@ -0,0 +1,161 @@
+#include "TestFramework.h"
+
+#include "DynamicResolution.h"
+
+#include <cmath>
+#include <deque>
+#include <vector>
+
+namespace
+{
+    // A GPU whose frame time is proportional to the pixel count, with results read back
+    // Latency frames after the frame was recorded, as the sample's timestamp queries are.
+    struct SimulatedGpu
+    {
+        static const size_t Latency = 2;
+
+        float FullResolutionMilliseconds;
+        float Noise = 0.0f;             // Relative, uniform in [-Noise, Noise].
+        std::deque<float> InFlight;     // Scales of the frames not read back yet.
+        TestRandom Random;
+
+        explicit SimulatedGpu(float fullResolutionMilliseconds) : FullResolutionMilliseconds(fullResolutionMilliseconds) {}
+
+        float Time(float scale)
+        {
+            const float jitter = Noise * (Random.NextBelow(2001) / 1000.0f - 1.0f);
+            return FullResolutionMilliseconds * scale * scale * (1.0f + jitter);
+        }
+    };
+
+    // Runs frameCount frames and returns the scale of each.
+    std::vector<float> Run(DynamicResolutionController& controller, SimulatedGpu& gpu, size_t frameCount)
+    {
+        std::vector<float> scales;
+        for (size_t frame = 0; frame < frameCount; ++frame)
+        {
+            gpu.InFlight.push_back(controller.GetScale());
+            scales.push_back(controller.GetScale());
+            if (gpu.InFlight.size() > SimulatedGpu::Latency)
+            {
+                const float frameScale = gpu.InFlight.front();
+                gpu.InFlight.pop_front();
+                controller.Update(gpu.Time(frameScale), frameScale);
+            }
+        }
+        return scales;
+    }
+}
+
+TEST(DynamicResolution, ConvergesToTarget)
+{
+    // 25 ms at full resolution against a 15 ms target: the steady scale is sqrt(15 / 25).
+    DynamicResolutionController controller;
+    SimulatedGpu gpu(25.0f);
+    gpu.Noise = 0.02f;
+    const std::vector<float> scales = Run(controller, gpu, 600);
+
+    const float expected = std::sqrt(15.0f / 25.0f);
+    bool settled = true;
+    for (size_t frame = 300; frame < scales.size(); ++frame)
+    {
+        settled &= std::fabs(scales[frame] - expected) < 0.03f;
+    }
+    CHECK(settled);
+    CHECK(std::fabs(gpu.Time(controller.GetScale()) - 15.0f) < 15.0f * 0.08f);
+}
+
+TEST(DynamicResolution, HysteresisHoldsTheScale)
+{
+    // Times within the dead band of the target leave the scale alone, noise or not.
+    DynamicResolutionController controller;
+    controller.Reset(0.8f);
+    SimulatedGpu gpu(15.0f / (0.8f * 0.8f));
+    gpu.Noise = 0.025f;
+    const std::vector<float> scales = Run(controller, gpu, 500);
+    bool steady = true;
+    for (float scale : scales)
+    {
+        steady &= std::fabs(scale - 0.8f) < 1e-4f;
+    }
+    CHECK(steady);
+}
+
+TEST(DynamicResolution, GrowsBackSlowly)
+{
+    // After a heavy scene, lots of headroom: the scale climbs at most MaxScaleIncrease a frame
+    // and reaches full resolution.
+    DynamicResolutionController controller;
+    controller.Reset(0.5f);
+    SimulatedGpu gpu(8.0f);
+    const std::vector<float> scales = Run(controller, gpu, 400);
+    bool limited = true;
+    for (size_t frame = 1; frame < scales.size(); ++frame)
+    {
+        limited &= scales[frame] - scales[frame - 1] <= controller.GetSettings().MaxScaleIncrease + 1e-6f;
+    }
+    CHECK(limited);
+    CHECK_EQUAL(1.0f, controller.GetScale());
+    CHECK(scales[20] < 1.0f);
+}
+
+TEST(DynamicResolution, PanicDropsAtOnce)
+{
+    // A frame three times over target goes straight to the scale that fits it.
+    DynamicResolutionController controller;
+    const float scale = controller.Update(45.0f, 1.0f);
+    CHECK(std::fabs(scale - std::sqrt(15.0f / 45.0f)) < 1e-5f);
+
+    // A late measurement of a frame rendered at another scale is converted first: 60 ms at full
+    // scale is 15 ms at half scale, on target, not a reason to panic.
+    DynamicResolutionController converted;
+    converted.Reset(0.5f);
+    CHECK_EQUAL(0.5f, converted.Update(60.0f, 1.0f));
+}
+
+TEST(DynamicResolution, ClampsAndUnwinds)
+{
+    // Far too heavy even at MinScale: the scale stays there, not below.
+    DynamicResolutionController controller;
+    SimulatedGpu gpu(200.0f);
+    std::vector<float> scales = Run(controller, gpu, 300);
+    bool clamped = true;
+    for (float scale : scales)
+    {
+        clamped &= scale >= controller.GetSettings().MinScale && scale <= controller.GetSettings().MaxScale;
+    }
+    CHECK(clamped);
+    CHECK_EQUAL(controller.GetSettings().MinScale, controller.GetScale());
+
+    // The integral did not wind up at the limit: once the load is gone the scale starts
+    // climbing within a few frames.
+    gpu.FullResolutionMilliseconds = 10.0f;
+    scales = Run(controller, gpu, 10);
+    CHECK(controller.GetScale() > controller.GetSettings().MinScale + 0.05f);
+
+    // Measurements that can't be right are ignored.
+    const float before = controller.GetScale();
+    CHECK_EQUAL(before, controller.Update(0.0f, 1.0f));
+    CHECK_EQUAL(before, controller.Update(-3.0f, 1.0f));
+    CHECK_EQUAL(before, controller.Update(NAN, 1.0f));
+    CHECK_EQUAL(before, controller.Update(16.0f, 0.0f));
+
+    controller.Reset(5.0f);
+    CHECK_EQUAL(controller.GetSettings().MaxScale, controller.GetScale());
+    controller.Reset(0.0f);
+    CHECK_EQUAL(controller.GetSettings().MinScale, controller.GetScale());
+}
+
+TEST(DynamicResolution, RenderSize)
+{
+    uint32_t width, height;
+    DynamicResolutionController::GetRenderSize(1.0f, 1920, 1080, width, height);
+    CHECK_EQUAL(1920u, width);
+    CHECK_EQUAL(1080u, height);
+    DynamicResolutionController::GetRenderSize(0.75f, 1280, 721, width, height);
+    CHECK_EQUAL(960u, width);
+    CHECK_EQUAL(541u, height);
+    DynamicResolutionController::GetRenderSize(0.001f, 100, 100, width, height);
+    CHECK_EQUAL(1u, width);
+    CHECK_EQUAL(1u, height);
+}
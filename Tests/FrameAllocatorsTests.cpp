@@ -0,0 +1,214 @@
+#include "TestFramework.h"
+
+#include "FrameAllocators.h"
+#include "TimelineFence.h"
+
+#include <cstring>
+#include <list>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    bool IsAligned(const void* pointer, size_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(pointer) % alignment == 0;
+    }
+}
+
+TEST(FrameAllocators, LinearArenaAlignsAndGrows)
+{
+    LinearArena arena(4096);
+    TestRandom random;
+    std::vector<std::pair<uint8_t*, size_t>> allocations;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const size_t size = 1 + random.NextBelow(random.NextBelow(50) == 0 ? 10000 : 100);
+        const size_t alignment = size_t(1) << random.NextBelow(9);
+        uint8_t* pointer = static_cast<uint8_t*>(arena.Allocate(size, alignment));
+        REQUIRE(pointer != nullptr);
+        CHECK(IsAligned(pointer, alignment));
+        memset(pointer, i & 0xFF, size);
+        allocations.push_back({ pointer, size });
+    }
+
+    // Nothing overlapped: every allocation still holds its own fill.
+    bool intact = true;
+    for (size_t i = 0; i < allocations.size(); ++i)
+    {
+        for (size_t j = 0; j < allocations[i].second; ++j)
+        {
+            intact &= allocations[i].first[j] == (i & 0xFF);
+        }
+    }
+    CHECK(intact);
+    CHECK(arena.GetUsedBytes() <= arena.GetCapacity());
+}
+
+TEST(FrameAllocators, LinearArenaReuseAfterReset)
+{
+    LinearArena arena(1024);
+    for (int i = 0; i < 100; ++i)
+    {
+        arena.Allocate(300);
+    }
+    const size_t capacity = arena.GetCapacity();
+    void* first = nullptr;
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        arena.Reset();
+        CHECK_EQUAL(size_t(0), arena.GetUsedBytes());
+        void* pointer = arena.Allocate(300);
+        if (frame == 0)
+        {
+            first = pointer;
+        }
+        // The same memory every frame, and no growth past the high water mark.
+        CHECK(pointer == first);
+        for (int i = 1; i < 100; ++i)
+        {
+            arena.Allocate(300);
+        }
+        CHECK_EQUAL(capacity, arena.GetCapacity());
+    }
+}
+
+TEST(FrameAllocators, LinearArenaRewind)
+{
+    LinearArena arena(256);
+    arena.Allocate(100);
+    const LinearArena::Marker marker = arena.GetMarker();
+    const size_t used = arena.GetUsedBytes();
+    void* afterMarker = arena.Allocate(64);
+    // Past the end of the block, so the rewind crosses blocks.
+    arena.Allocate(1000);
+    arena.Allocate(200);
+
+    arena.Rewind(marker);
+    CHECK_EQUAL(used, arena.GetUsedBytes());
+    CHECK(arena.Allocate(64) == afterMarker);
+}
+
+TEST(FrameAllocators, FrameArenaRingWaitsForFence)
+{
+    SimulatedTimelineFence timeline;
+    const uint32_t FrameCount = 3;
+    FrameArenaRing ring(timeline, FrameCount, 1024);
+
+    std::vector<uint64_t> fenceValues;
+    std::vector<void*> frameMemory;
+    for (uint32_t frame = 0; frame < 12; ++frame)
+    {
+        LinearArena& arena = ring.BeginFrame();
+        CHECK(&arena == &ring.GetCurrent());
+        CHECK_EQUAL(size_t(0), arena.GetUsedBytes());
+
+        // The arena is reused only once the GPU has finished the frame that last used it.
+        void* memory = arena.Allocate(64);
+        if (frame >= FrameCount)
+        {
+            CHECK(timeline.IsComplete(fenceValues[frame - FrameCount]));
+            CHECK(memory == frameMemory[frame - FrameCount]);
+        }
+        frameMemory.push_back(memory);
+
+        // Frames in flight are not complete yet: the simulated GPU lags behind.
+        if (frame >= 1)
+        {
+            CHECK(!timeline.IsComplete(timeline.GetLastSignaledValue()));
+        }
+        fenceValues.push_back(timeline.Signal());
+        ring.EndFrame(fenceValues.back());
+    }
+}
+
+TEST(FrameAllocators, ScratchScopesNest)
+{
+    LinearArena& scratch = GetThreadScratch();
+    const size_t before = scratch.GetUsedBytes();
+    {
+        ScratchScope outer;
+        int* numbers = outer.Allocate<int>(1000);
+        numbers[999] = 7;
+        const size_t outerUsed = scratch.GetUsedBytes();
+        {
+            ScratchScope inner;
+            inner.Allocate<double>(5000);
+            CHECK(scratch.GetUsedBytes() > outerUsed);
+        }
+        CHECK_EQUAL(outerUsed, scratch.GetUsedBytes());
+        CHECK_EQUAL(7, numbers[999]);
+
+        // Containers over the scope's arena.
+        ArenaVector<int> values{ ArenaAllocator<int>(outer.GetArena()) };
+        for (int i = 0; i < 10000; ++i)
+        {
+            values.push_back(i);
+        }
+        CHECK_EQUAL(9999, values.back());
+    }
+    CHECK_EQUAL(before, scratch.GetUsedBytes());
+
+    // Each thread has its own.
+    LinearArena* other = nullptr;
+    std::thread thread([&other]() { other = &GetThreadScratch(); });
+    thread.join();
+    CHECK(other != &scratch);
+}
+
+TEST(FrameAllocators, FixedPoolReusesBlocks)
+{
+    FixedPool pool(40, 16);
+    CHECK(pool.GetBlockSize() >= 40);
+    CHECK_EQUAL(size_t(0), pool.GetBlockSize() % alignof(std::max_align_t));
+
+    std::set<void*> live;
+    std::vector<void*> order;
+    TestRandom random;
+    for (int i = 0; i < 20000; ++i)
+    {
+        if (order.empty() || random.NextBelow(3) != 0)
+        {
+            void* block = pool.Allocate();
+            CHECK(IsAligned(block, alignof(std::max_align_t)));
+            CHECK(live.insert(block).second);
+            order.push_back(block);
+        }
+        else
+        {
+            const size_t index = random.NextBelow(static_cast<uint32_t>(order.size()));
+            pool.Free(order[index]);
+            live.erase(order[index]);
+            order[index] = order.back();
+            order.pop_back();
+        }
+    }
+
+    // A freed block is the next one handed out.
+    void* block = order.back();
+    pool.Free(block);
+    CHECK(pool.Allocate() == block);
+}
+
+TEST(FrameAllocators, PoolAllocatorContainers)
+{
+    FixedPool pool(64);
+    {
+        std::map<int, int, std::less<int>, PoolAllocator<std::pair<const int, int>>> map{ PoolAllocator<std::pair<const int, int>>(pool) };
+        std::list<int, PoolAllocator<int>> list{ PoolAllocator<int>(pool) };
+        for (int i = 0; i < 5000; ++i)
+        {
+            map[i * 7 % 5000] = i;
+            list.push_back(i);
+        }
+        for (int i = 0; i < 5000; i += 2)
+        {
+            map.erase(i);
+        }
+        CHECK_EQUAL(size_t(2500), map.size());
+        CHECK_EQUAL(size_t(5000), list.size());
+        CHECK_EQUAL(4999, list.back());
+    }
+}
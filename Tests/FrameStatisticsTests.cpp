@@ -0,0 +1,130 @@
+#include "TestFramework.h"
+
+#include "FrameStatistics.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(FrameStatistics, NearestRankPercentiles)
+{
+    // 1..100 in a scrambled order: the nearest rank of p is the value p itself.
+    std::vector<double> values;
+    for (int i = 0; i < 100; ++i)
+    {
+        values.push_back(double((i * 37) % 100 + 1));
+    }
+    const FrameTimeSummary summary = FrameStatistics::Summarize(values, 2.0);
+    CHECK_EQUAL(size_t(100), summary.FrameCount);
+    CHECK_EQUAL(50.5, summary.Mean);
+    CHECK_EQUAL(50.0, summary.P50);
+    CHECK_EQUAL(95.0, summary.P95);
+    CHECK_EQUAL(99.0, summary.P99);
+    CHECK_EQUAL(100.0, summary.Max);
+
+    // Ranks round up: of 10 values, p95 and p99 are both the largest, p50 the fifth.
+    const std::vector<double> ten = { 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+    const FrameTimeSummary small = FrameStatistics::Summarize(ten, 2.0);
+    CHECK_EQUAL(5.0, small.P50);
+    CHECK_EQUAL(10.0, small.P95);
+    CHECK_EQUAL(10.0, small.P99);
+
+    // One sample is every percentile; none is all zeros.
+    const FrameTimeSummary one = FrameStatistics::Summarize({ 16.6 }, 2.0);
+    CHECK_EQUAL(16.6, one.P50);
+    CHECK_EQUAL(16.6, one.P99);
+    const FrameTimeSummary none = FrameStatistics::Summarize({}, 2.0);
+    CHECK_EQUAL(size_t(0), none.FrameCount);
+    CHECK_EQUAL(0.0, none.Max);
+}
+
+TEST(FrameStatistics, StuttersAreLongerThanFactorTimesMedian)
+{
+    // Median 16: frames over 32 ms are stutters, 32 itself is not.
+    std::vector<double> frames(50, 16.0);
+    frames[3] = 32.0;
+    frames[10] = 33.0;
+    frames[20] = 100.0;
+    CHECK_EQUAL(size_t(2), FrameStatistics::Summarize(frames, 2.0).StutterCount);
+    CHECK_EQUAL(size_t(3), FrameStatistics::Summarize(frames, 1.5).StutterCount);
+
+    FrameStatistics statistics(3.0);
+    for (double frame : frames)
+    {
+        statistics.AddCpuFrame(frame);
+    }
+    CHECK_EQUAL(size_t(1), statistics.SummarizeCpu().StutterCount);
+    CHECK_EQUAL(size_t(0), statistics.SummarizeGpu().FrameCount);
+}
+
+TEST(FrameStatistics, CsvReport)
+{
+    FrameStatistics statistics;
+    statistics.SetContext("width", "1280");
+    statistics.SetContext("scene", "grid, \"large\"");
+    statistics.SetContext("width", "1920");
+    for (double frame : { 4.0, 2.0, 3.0, 1.0 })
+    {
+        statistics.AddCpuFrame(frame);
+        statistics.AddGpuFrame(frame / 2);
+    }
+
+    std::ostringstream csv;
+    statistics.WriteCsv(csv);
+    CHECK_EQUAL(std::string(
+        "width,scene,series,frames,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,stutters\n"
+        "1920,\"grid, \"\"large\"\"\",cpu,4,2.5,2,4,4,4,0\n"
+        "1920,\"grid, \"\"large\"\"\",gpu,4,1.25,1,2,2,2,0\n"), csv.str());
+}
+
+TEST(FrameStatistics, JsonReport)
+{
+    FrameStatistics statistics;
+    statistics.SetContext("gpu", "Adapter \"0\"\n");
+    statistics.AddCpuFrame(8.0);
+    statistics.AddCpuFrame(40.0);
+
+    std::ostringstream json;
+    statistics.WriteJson(json);
+    CHECK_EQUAL(std::string(
+        "{\n"
+        "  \"context\": { \"gpu\": \"Adapter \\\"0\\\"\\n\" },\n"
+        "  \"stutter_factor\": 2,\n"
+        "  \"cpu\": { \"frames\": 2, \"mean_ms\": 24, \"p50_ms\": 8, \"p95_ms\": 40, \"p99_ms\": 40, \"max_ms\": 40, \"stutters\": 1 },\n"
+        "  \"gpu\": { \"frames\": 0, \"mean_ms\": 0, \"p50_ms\": 0, \"p95_ms\": 0, \"p99_ms\": 0, \"max_ms\": 0, \"stutters\": 0 }\n"
+        "}\n"), json.str());
+}
+
+TEST(FrameStatistics, DeterministicRuns)
+{
+    // Two runs of the same fixed step frames give byte identical reports, whatever order the
+    // samples arrived in; Clear starts a new run.
+    std::vector<double> frames;
+    TestRandom random;
+    for (int i = 0; i < 1000; ++i)
+    {
+        frames.push_back(16.0 + random.NextBelow(4000) / 1000.0);
+    }
+    std::vector<double> reversed(frames.rbegin(), frames.rend());
+
+    FrameStatistics first;
+    FrameStatistics second;
+    first.SetContext("frames", "1000");
+    second.SetContext("frames", "1000");
+    second.AddCpuFrame(1000.0);
+    second.Clear();
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        first.AddCpuFrame(frames[i]);
+        second.AddCpuFrame(reversed[i]);
+    }
+
+    std::ostringstream firstJson, secondJson, firstCsv, secondCsv;
+    first.WriteJson(firstJson);
+    second.WriteJson(secondJson);
+    first.WriteCsv(firstCsv);
+    second.WriteCsv(secondCsv);
+    CHECK_EQUAL(firstJson.str(), secondJson.str());
+    CHECK_EQUAL(firstCsv.str(), secondCsv.str());
+}
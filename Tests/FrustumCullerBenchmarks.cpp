@@ -0,0 +1,67 @@
+#include "BenchmarkFramework.h"
+#include "TestFramework.h"
+
+#include "FrustumCuller.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <vector>
+
+BENCHMARK(FrustumCuller, Cull1M)
+{
+    // 1M instances in a 2 km square, seen from the middle by a 90 degree camera looking down +z:
+    // about a quarter are visible.
+    const uint32_t count = 1000000;
+    std::vector<float> bounds(count * 6);
+    TestRandom random;
+    FrustumCuller culler;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float* b = &bounds[i * 6];
+        b[0] = random.NextBelow(200000) / 100.0f - 1000.0f;
+        b[1] = random.NextBelow(2000) / 100.0f;
+        b[2] = random.NextBelow(200000) / 100.0f - 1000.0f;
+        b[3] = b[4] = b[5] = 0.5f + random.NextBelow(100) / 100.0f;
+        culler.AddObject(b, b + 3);
+    }
+    Report("Build", BestSeconds(1, [&]() { culler.Build(); }) * 1e3, "ms");
+
+    // Planes of a 90 degree frustum at the origin looking down +z, reaching 1000.
+    const float h = 0.70710678f;
+    const FrustumPlanes frustum = { { { h, 0, h, 0 }, { -h, 0, h, 0 }, { 0, h, h, 0 }, { 0, -h, h, 0 }, { 0, 0, 1, -0.1f }, { 0, 0, -1, 1000 } } };
+    std::vector<uint32_t> visible;
+    const double serial = BestSeconds(10, [&]() { culler.Cull(frustum, visible); });
+    Report("Cull 1M, 1 thread", serial * 1e3, "ms");
+    Report("Visible", double(visible.size()), "objects");
+    ThreadPool pool;
+    Report("Cull 1M, pool", BestSeconds(10, [&]() { culler.Cull(frustum, visible, &pool); }) * 1e3, "ms");
+
+    // Every object tested one by one, for comparison.
+    size_t bruteVisible = 0;
+    const double brute = BestSeconds(3, [&]()
+    {
+        bruteVisible = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float* b = &bounds[i * 6];
+            const float radius = std::sqrt(b[3] * b[3] + b[4] * b[4] + b[5] * b[5]);
+            bool inside = true;
+            for (const float* plane : frustum.Planes)
+            {
+                const float distance = plane[0] * b[0] + plane[1] * b[1] + plane[2] * b[2] + plane[3];
+                const float boxRadius = std::fabs(plane[0]) * b[3] + std::fabs(plane[1]) * b[4] + std::fabs(plane[2]) * b[5];
+                inside &= distance + std::fmin(radius, boxRadius) >= 0.0f;
+            }
+            bruteVisible += inside ? 1 : 0;
+        }
+    });
+    Report("Brute force 1M, 1 thread", brute * 1e3, "ms");
+
+    // Everything moves a little: refit, then cull.
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        bounds[i * 6 + 1] += 0.5f;
+        culler.SetBounds(i, &bounds[i * 6], &bounds[i * 6 + 3]);
+    }
+    Report("Refit 1M", BestSeconds(1, [&]() { culler.Refit(); }) * 1e3, "ms");
+}
@@ -0,0 +1,250 @@
+#include "TestFramework.h"
+
+#include "FrustumCuller.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Row vectors (clip = v * M): a camera at eye turned yaw radians about y, then a left-handed
+    // perspective with a [0, 1] depth range.
+    void MakeViewProjection(const float eye[3], float yaw, float m[16])
+    {
+        const float c = std::cos(yaw);
+        const float s = std::sin(yaw);
+        // The inverse of the camera's rotation and translation.
+        const float view[16] =
+        {
+            c, 0, s, 0,
+            0, 1, 0, 0,
+            -s, 0, c, 0,
+            -(eye[0] * c - eye[2] * s), -eye[1], -(eye[0] * s + eye[2] * c), 1,
+        };
+        const float nearZ = 0.5f;
+        const float farZ = 200.0f;
+        const float focal = 1.0f / std::tan(0.5f);
+        const float projection[16] =
+        {
+            focal / 1.5f, 0, 0, 0,
+            0, focal, 0, 0,
+            0, 0, farZ / (farZ - nearZ), 1,
+            0, 0, -nearZ * farZ / (farZ - nearZ), 0,
+        };
+        for (int r = 0; r < 4; ++r)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                float sum = 0.0f;
+                for (int i = 0; i < 4; ++i)
+                {
+                    sum += view[r * 4 + i] * projection[i * 4 + k];
+                }
+                m[r * 4 + k] = sum;
+            }
+        }
+    }
+
+    struct Bounds
+    {
+        float Center[3];
+        float Extents[3];
+    };
+
+    // The culler's test, in double precision: a box is in unless some plane has it entirely
+    // outside, by the lesser of its sphere and box reach. Margin is how far a box must be from
+    // the decision to count as clearly in or out; vector and scalar rounding differ inside it.
+    enum class Side { In, Out, Ambiguous };
+
+    Side Classify(const FrustumPlanes& frustum, const Bounds& bounds)
+    {
+        const double margin = 1e-3;
+        bool ambiguous = false;
+        const double radius = std::sqrt(double(bounds.Extents[0]) * bounds.Extents[0] + double(bounds.Extents[1]) * bounds.Extents[1] + double(bounds.Extents[2]) * bounds.Extents[2]);
+        for (const float* plane : frustum.Planes)
+        {
+            const double distance = double(plane[0]) * bounds.Center[0] + double(plane[1]) * bounds.Center[1] + double(plane[2]) * bounds.Center[2] + plane[3];
+            const double boxRadius = std::fabs(plane[0]) * bounds.Extents[0] + std::fabs(plane[1]) * bounds.Extents[1] + std::fabs(plane[2]) * bounds.Extents[2];
+            const double reach = distance + std::min(radius, boxRadius);
+            if (reach < -margin)
+            {
+                return Side::Out;
+            }
+            ambiguous |= reach < margin;
+        }
+        return ambiguous ? Side::Ambiguous : Side::In;
+    }
+
+    std::vector<Bounds> MakeObjects(uint32_t count, TestRandom& random)
+    {
+        std::vector<Bounds> objects(count);
+        for (Bounds& bounds : objects)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                bounds.Center[k] = random.NextBelow(40000) / 100.0f - 200.0f;
+                bounds.Extents[k] = 0.1f + random.NextBelow(300) / 100.0f;
+            }
+        }
+        return objects;
+    }
+
+    // Counts the objects the culler got wrong against Classify; the ambiguous ones may go
+    // either way.
+    uint32_t CountMismatches(const FrustumPlanes& frustum, const std::vector<Bounds>& objects, std::vector<uint32_t> visible, uint32_t* inCount)
+    {
+        std::sort(visible.begin(), visible.end());
+        uint32_t wrong = visible.end() == std::unique(visible.begin(), visible.end()) ? 0 : 1;
+        *inCount = 0;
+        for (uint32_t i = 0; i < objects.size(); ++i)
+        {
+            const Side side = Classify(frustum, objects[i]);
+            const bool found = std::binary_search(visible.begin(), visible.end(), i);
+            *inCount += side == Side::In ? 1 : 0;
+            wrong += (side == Side::In && !found) || (side == Side::Out && found) ? 1 : 0;
+        }
+        return wrong;
+    }
+}
+
+TEST(FrustumCuller, ExtractsNormalizedPlanes)
+{
+    const float eye[3] = { 0, 0, 0 };
+    float viewProjection[16];
+    MakeViewProjection(eye, 0.0f, viewProjection);
+    FrustumPlanes frustum;
+    ExtractFrustumPlanes(viewProjection, frustum);
+
+    for (const float* plane : frustum.Planes)
+    {
+        CHECK(std::fabs(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2] - 1.0f) < 1e-5f);
+        // A point straight ahead is inside every plane.
+        CHECK(plane[2] * 10.0f + plane[3] > 0.0f);
+    }
+    // Left, right, bottom, top, near, far: each point is outside its plane only.
+    const float outside[6][3] = { { -100, 0, 10 }, { 100, 0, 10 }, { 0, -100, 10 }, { 0, 100, 10 }, { 0, 0, 0.1f }, { 0, 0, 300 } };
+    for (int p = 0; p < 6; ++p)
+    {
+        for (int q = 0; q < 6; ++q)
+        {
+            const float* plane = frustum.Planes[q];
+            const float distance = plane[0] * outside[p][0] + plane[1] * outside[p][1] + plane[2] * outside[p][2] + plane[3];
+            CHECK((distance < 0.0f) == (p == q));
+        }
+    }
+    // The near and far planes sit at their distances.
+    CHECK(std::fabs(frustum.Planes[4][3] + 0.5f) < 1e-4f);
+    CHECK(std::fabs(frustum.Planes[5][3] - 200.0f) < 1e-2f);
+}
+
+TEST(FrustumCuller, MatchesBruteForce)
+{
+    TestRandom random;
+    const std::vector<Bounds> objects = MakeObjects(30000, random);
+    ThreadPool pool(3);
+    for (uint32_t leafSize : { 1u, 5u, 16u, 64u })
+    {
+        FrustumCuller culler(leafSize);
+        for (const Bounds& bounds : objects)
+        {
+            culler.AddObject(bounds.Center, bounds.Extents);
+        }
+        CHECK_EQUAL(uint32_t(objects.size()), culler.GetObjectCount());
+
+        for (int view = 0; view < 6; ++view)
+        {
+            const float eye[3] = { random.NextBelow(200) - 100.0f, random.NextBelow(20) - 10.0f, random.NextBelow(200) - 100.0f };
+            float viewProjection[16];
+            MakeViewProjection(eye, view * 1.1f, viewProjection);
+            FrustumPlanes frustum;
+            ExtractFrustumPlanes(viewProjection, frustum);
+
+            std::vector<uint32_t> visible;
+            culler.Cull(frustum, visible, view % 2 == 0 ? nullptr : &pool);
+            uint32_t inCount = 0;
+            CHECK_EQUAL(0u, CountMismatches(frustum, objects, visible, &inCount));
+            CHECK(inCount > 100);
+            CHECK(visible.size() < objects.size() / 2);
+        }
+    }
+}
+
+TEST(FrustumCuller, PoolKeepsSerialOrder)
+{
+    TestRandom random;
+    const std::vector<Bounds> objects = MakeObjects(50000, random);
+    FrustumCuller culler;
+    for (const Bounds& bounds : objects)
+    {
+        culler.AddObject(bounds.Center, bounds.Extents);
+    }
+    const float eye[3] = { 0, 0, -150 };
+    float viewProjection[16];
+    MakeViewProjection(eye, 0.2f, viewProjection);
+    FrustumPlanes frustum;
+    ExtractFrustumPlanes(viewProjection, frustum);
+
+    std::vector<uint32_t> serial;
+    culler.Cull(frustum, serial);
+    ThreadPool pool(3);
+    std::vector<uint32_t> pooled = { 1, 2, 3 };
+    culler.Cull(frustum, pooled, &pool);
+    CHECK(serial == pooled);
+    CHECK(!serial.empty());
+}
+
+TEST(FrustumCuller, RefitAndRebuild)
+{
+    TestRandom random;
+    std::vector<Bounds> objects = MakeObjects(8000, random);
+    FrustumCuller culler;
+    for (const Bounds& bounds : objects)
+    {
+        culler.AddObject(bounds.Center, bounds.Extents);
+    }
+    const float eye[3] = { 0, 0, -190 };
+    float viewProjection[16];
+    MakeViewProjection(eye, 0.0f, viewProjection);
+    FrustumPlanes frustum;
+    ExtractFrustumPlanes(viewProjection, frustum);
+    std::vector<uint32_t> visible;
+    culler.Cull(frustum, visible);
+
+    // Everything moves: the tree keeps its shape and is refitted, so the results stay exact.
+    for (uint32_t i = 0; i < objects.size(); ++i)
+    {
+        objects[i].Center[0] = random.NextBelow(40000) / 100.0f - 200.0f;
+        objects[i].Center[2] = random.NextBelow(40000) / 100.0f - 200.0f;
+        culler.SetBounds(i, objects[i].Center, objects[i].Extents);
+    }
+    culler.Cull(frustum, visible);
+    uint32_t inCount = 0;
+    CHECK_EQUAL(0u, CountMismatches(frustum, objects, visible, &inCount));
+
+    // Objects added after the build: the next Cull rebuilds and finds them.
+    const Bounds added[2] = { { { 0, 0, -150 }, { 1, 1, 1 } }, { { 0, 0, -250 }, { 1, 1, 1 } } };
+    for (const Bounds& bounds : added)
+    {
+        CHECK_EQUAL(uint32_t(objects.size()), culler.AddObject(bounds.Center, bounds.Extents));
+        objects.push_back(bounds);
+    }
+    culler.Cull(frustum, visible);
+    CHECK_EQUAL(0u, CountMismatches(frustum, objects, visible, &inCount));
+    CHECK(std::find(visible.begin(), visible.end(), uint32_t(objects.size() - 2)) != visible.end());
+    CHECK(std::find(visible.begin(), visible.end(), uint32_t(objects.size() - 1)) == visible.end());
+}
+
+TEST(FrustumCuller, EmptyCullerSeesNothing)
+{
+    FrustumCuller culler;
+    const float eye[3] = { 0, 0, 0 };
+    float viewProjection[16];
+    MakeViewProjection(eye, 0.0f, viewProjection);
+    FrustumPlanes frustum;
+    ExtractFrustumPlanes(viewProjection, frustum);
+    std::vector<uint32_t> visible = { 7 };
+    culler.Cull(frustum, visible);
+    CHECK(visible.empty());
+}
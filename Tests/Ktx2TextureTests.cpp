@@ -0,0 +1,357 @@
+#include "TestFramework.h"
+
+#include "AssetArchive.h"
+#include "BlockCompression.h"
+#include "ContentHash.h"
+#include "Ktx2Texture.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char* const TexturePath = "Ktx2TextureTests.ktx2";
+
+    // VkFormat values.
+    const uint32_t VkRgba8Unorm = 37;
+    const uint32_t VkRgba8Srgb = 43;
+    const uint32_t VkBc7Srgb = 146;
+
+    // DXGI_FORMAT values.
+    const uint32_t DxgiBc1Unorm = 71;
+    const uint32_t DxgiBc7UnormSrgb = 99;
+
+    std::vector<uint8_t> MakeBytes(size_t size, TestRandom& random)
+    {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            // Gradients with noise, so the blocks are not all alike.
+            bytes[i] = static_cast<uint8_t>(i / 4 % 61 * 4 + (random.NextByte() & 7));
+        }
+        return bytes;
+    }
+
+    // A Zstandard frame (RFC 8878) of raw blocks: valid input for any decoder, without an encoder.
+    std::vector<uint8_t> MakeRawZstdFrame(const std::vector<uint8_t>& content)
+    {
+        std::vector<uint8_t> frame = { 0x28, 0xB5, 0x2F, 0xFD, 0xE0 };
+        for (int i = 0; i < 8; ++i)
+        {
+            frame.push_back(static_cast<uint8_t>(static_cast<uint64_t>(content.size()) >> (i * 8)));
+        }
+        size_t at = 0;
+        do
+        {
+            const size_t size = std::min<size_t>(content.size() - at, 128 * 1024);
+            const uint32_t header = static_cast<uint32_t>(size) << 3 | (at + size == content.size() ? 1 : 0);
+            frame.push_back(static_cast<uint8_t>(header));
+            frame.push_back(static_cast<uint8_t>(header >> 8));
+            frame.push_back(static_cast<uint8_t>(header >> 16));
+            frame.insert(frame.end(), content.begin() + at, content.begin() + at + size);
+            at += size;
+        } while (at < content.size());
+        return frame;
+    }
+
+    struct Ktx2File
+    {
+        Ktx2Header Header;
+        std::vector<std::vector<uint8_t>> Levels;   // As stored: supercompressed or not.
+        std::vector<uint64_t> UncompressedSizes;
+        uint8_t ColorModel;                          // Of the data format descriptor.
+    };
+
+    // A file for width x height texels and levels levels of stored content. Zstandard levels are
+    // raw frames.
+    Ktx2File MakeFile(uint32_t vkFormat, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels, bool zstandard)
+    {
+        Ktx2File file = {};
+        static const uint8_t Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+        memcpy(file.Header.Identifier, Identifier, sizeof(Identifier));
+        file.Header.VkFormat = vkFormat;
+        file.Header.TypeSize = 1;
+        file.Header.PixelWidth = width;
+        file.Header.PixelHeight = height;
+        file.Header.FaceCount = 1;
+        file.Header.LevelCount = static_cast<uint32_t>(levels.size());
+        file.Header.SupercompressionScheme = zstandard ? Ktx2Supercompression::Zstandard : Ktx2Supercompression::None;
+        file.ColorModel = 1;    // KHR_DF_MODEL_RGBSDA.
+        for (const std::vector<uint8_t>& level : levels)
+        {
+            file.Levels.push_back(zstandard ? MakeRawZstdFrame(level) : level);
+            file.UncompressedSizes.push_back(level.size());
+        }
+        return file;
+    }
+
+    // Writes the header, the level index, a data format descriptor, then the levels smallest
+    // first, as libktx does.
+    void WriteFile(Ktx2File file, const char* path = TexturePath)
+    {
+        const size_t levelCount = file.Levels.size();
+        const size_t dfdOffset = sizeof(Ktx2Header) + levelCount * sizeof(Ktx2Level);
+        const size_t dfdLength = 44;
+        file.Header.DfdByteOffset = static_cast<uint32_t>(dfdOffset);
+        file.Header.DfdByteLength = static_cast<uint32_t>(dfdLength);
+
+        std::vector<uint8_t> bytes(dfdOffset + dfdLength);
+        bytes[dfdOffset] = static_cast<uint8_t>(dfdLength);
+        bytes[dfdOffset + 12] = file.ColorModel;
+        std::vector<Ktx2Level> index(levelCount);
+        for (size_t level = levelCount; level-- > 0;)
+        {
+            index[level].ByteOffset = bytes.size();
+            index[level].ByteLength = file.Levels[level].size();
+            index[level].UncompressedByteLength = file.UncompressedSizes[level];
+            bytes.insert(bytes.end(), file.Levels[level].begin(), file.Levels[level].end());
+        }
+        memcpy(bytes.data(), &file.Header, sizeof(Ktx2Header));
+        if (levelCount > 0)
+        {
+            memcpy(bytes.data() + sizeof(Ktx2Header), index.data(), levelCount * sizeof(Ktx2Level));
+        }
+
+        FILE* out = fopen(path, "wb");
+        REQUIRE(out != nullptr);
+        fwrite(bytes.data(), 1, bytes.size(), out);
+        fclose(out);
+    }
+
+    std::vector<std::vector<uint8_t>> MakeRgbaLevels(uint32_t width, uint32_t height, uint32_t levelCount, TestRandom& random)
+    {
+        std::vector<std::vector<uint8_t>> levels;
+        for (uint32_t level = 0; level < levelCount; ++level)
+        {
+            levels.push_back(MakeBytes(size_t(std::max(1u, width >> level)) * std::max(1u, height >> level) * 4, random));
+        }
+        return levels;
+    }
+
+    // Reads every level into footprints for format and returns the bytes.
+    std::vector<uint8_t> ReadAll(const Ktx2Texture& texture, BlockFormat target, std::vector<SubresourceFootprint>& footprints, ThreadPool* pool = nullptr)
+    {
+        const uint64_t total = ComputeCopyableFootprints(texture.GetDxgiFormat(target), texture.GetWidth(), texture.GetHeight(), 1, texture.GetMipLevels(), footprints);
+        std::vector<uint8_t> dest(static_cast<size_t>(total), 0xCD);
+        texture.Read(target, footprints.data(), dest.data(), pool);
+        return dest;
+    }
+
+    // The message Open throws for the file, or an empty string.
+    std::string GetOpenError(const Ktx2File& file)
+    {
+        WriteFile(file);
+        try
+        {
+            Ktx2Texture texture;
+            texture.Open(TexturePath);
+        }
+        catch (const std::runtime_error& error)
+        {
+            return error.what();
+        }
+        return std::string();
+    }
+}
+
+TEST(Ktx2Texture, EncodesRgbaLevels)
+{
+    // 64x40 with a full chain: the small levels are narrower than a block. Each level read is
+    // what encoding its texels directly gives, at the footprint's row pitch.
+    TestRandom random;
+    const uint32_t width = 64;
+    const uint32_t height = 40;
+    const std::vector<std::vector<uint8_t>> levels = MakeRgbaLevels(width, height, 7, random);
+    WriteFile(MakeFile(VkRgba8Srgb, width, height, levels, false));
+
+    Ktx2Texture texture;
+    texture.Open(TexturePath);
+    CHECK(texture.IsOpen());
+    CHECK_EQUAL(width, texture.GetWidth());
+    CHECK_EQUAL(uint16_t(7), texture.GetMipLevels());
+    CHECK(texture.IsSrgb());
+    CHECK(!texture.IsBlockCompressed());
+
+    ThreadPool pool(3);
+    for (int f = 0; f < static_cast<int>(BlockFormat::Count); ++f)
+    {
+        const BlockFormat format = static_cast<BlockFormat>(f);
+        CHECK_EQUAL(GetBlockFormatDxgi(format, true), texture.GetDxgiFormat(format));
+        std::vector<SubresourceFootprint> footprints;
+        const std::vector<uint8_t> read = ReadAll(texture, format, footprints, nullptr);
+        CHECK(read == ReadAll(texture, format, footprints, &pool));
+
+        size_t mismatches = 0;
+        for (uint32_t level = 0; level < 7; ++level)
+        {
+            const uint32_t levelWidth = std::max(1u, width >> level);
+            const uint32_t levelHeight = std::max(1u, height >> level);
+            const uint32_t blockRows = (levelHeight + 3) / 4;
+            std::vector<uint8_t> expected(size_t(footprints[level].RowPitch) * blockRows);
+            EncodeBlockRows(format, levels[level].data(), size_t(levelWidth) * 4, levelWidth, levelHeight, 0, blockRows, expected.data(), footprints[level].RowPitch);
+            for (uint32_t row = 0; row < blockRows; ++row)
+            {
+                const size_t offset = size_t(row) * footprints[level].RowPitch;
+                mismatches += memcmp(read.data() + footprints[level].Offset + offset, expected.data() + offset, static_cast<size_t>(footprints[level].RowSizeInBytes)) == 0 ? 0 : 1;
+            }
+        }
+        CHECK_EQUAL(size_t(0), mismatches);
+    }
+
+    texture.Close();
+    CHECK(!texture.IsOpen());
+    remove(TexturePath);
+}
+
+TEST(Ktx2Texture, CopiesStoredBlocks)
+{
+    // BC7 blocks are copied whatever the target, row by row to the footprint's pitch.
+    TestRandom random;
+    const uint32_t width = 100;
+    const uint32_t height = 36;
+    std::vector<std::vector<uint8_t>> levels;
+    for (uint32_t level = 0; level < 3; ++level)
+    {
+        const uint32_t blocksWide = (std::max(1u, width >> level) + 3) / 4;
+        const uint32_t blocksHigh = (std::max(1u, height >> level) + 3) / 4;
+        levels.push_back(MakeBytes(size_t(blocksWide) * blocksHigh * 16, random));
+    }
+    WriteFile(MakeFile(VkBc7Srgb, width, height, levels, false));
+
+    Ktx2Texture texture;
+    texture.Open(TexturePath);
+    CHECK(texture.IsBlockCompressed());
+    CHECK_EQUAL(DxgiBc7UnormSrgb, texture.GetDxgiFormat(BlockFormat::BC1));
+    std::vector<SubresourceFootprint> footprints;
+    const std::vector<uint8_t> read = ReadAll(texture, BlockFormat::BC1, footprints);
+    size_t mismatches = 0;
+    for (uint32_t level = 0; level < 3; ++level)
+    {
+        const size_t rowSize = static_cast<size_t>(footprints[level].RowSizeInBytes);
+        for (uint32_t row = 0; row < footprints[level].NumRows; ++row)
+        {
+            mismatches += memcmp(read.data() + footprints[level].Offset + size_t(row) * footprints[level].RowPitch, levels[level].data() + row * rowSize, rowSize) == 0 ? 0 : 1;
+        }
+    }
+    CHECK_EQUAL(size_t(0), mismatches);
+    texture.Close();
+    remove(TexturePath);
+}
+
+TEST(Ktx2Texture, ZstandardLevels)
+{
+    // Supercompressed levels (one over a 128 KB block) inflate to the same texels, on one thread
+    // or the pool.
+    TestRandom random;
+    const std::vector<std::vector<uint8_t>> levels = MakeRgbaLevels(256, 256, 9, random);
+    WriteFile(MakeFile(VkRgba8Unorm, 256, 256, levels, false));
+    Ktx2Texture plain;
+    plain.Open(TexturePath);
+    std::vector<SubresourceFootprint> footprints;
+    const std::vector<uint8_t> expected = ReadAll(plain, BlockFormat::BC1, footprints);
+    CHECK_EQUAL(DxgiBc1Unorm, plain.GetDxgiFormat(BlockFormat::BC1));
+    plain.Close();
+
+    WriteFile(MakeFile(VkRgba8Unorm, 256, 256, levels, true));
+    ThreadPool pool(2);
+    for (ThreadPool* openPool : { static_cast<ThreadPool*>(nullptr), &pool })
+    {
+        Ktx2Texture texture;
+        texture.Open(TexturePath, openPool);
+        CHECK(ReadAll(texture, BlockFormat::BC1, footprints) == expected);
+    }
+
+    // A level whose block size is off by one fails the open.
+    Ktx2File corrupt = MakeFile(VkRgba8Unorm, 256, 256, levels, true);
+    corrupt.Levels[4][13] ^= 0x08;
+    CHECK_EQUAL(std::string("Ktx2Texture: corrupt level"), GetOpenError(corrupt));
+    remove(TexturePath);
+}
+
+TEST(Ktx2Texture, RejectsUnsupportedFiles)
+{
+    // Basis Universal payloads are told apart from other files without a VkFormat.
+    TestRandom random;
+    const std::vector<std::vector<uint8_t>> levels = MakeRgbaLevels(16, 16, 1, random);
+    const Ktx2File good = MakeFile(VkRgba8Unorm, 16, 16, levels, false);
+    CHECK_EQUAL(std::string(), GetOpenError(good));
+
+    Ktx2File file = good;
+    file.Header.SupercompressionScheme = Ktx2Supercompression::BasisLZ;
+    CHECK_EQUAL(std::string("Ktx2Texture: Basis Universal ETC1S (BasisLZ) textures are not supported"), GetOpenError(file));
+    file = good;
+    file.Header.VkFormat = 0;
+    file.ColorModel = 166;
+    CHECK_EQUAL(std::string("Ktx2Texture: Basis Universal (UASTC, ETC1S) textures are not supported"), GetOpenError(file));
+    file.ColorModel = 1;
+    CHECK_EQUAL(std::string("Ktx2Texture: textures without a VkFormat are not supported"), GetOpenError(file));
+    file = good;
+    file.Header.SupercompressionScheme = Ktx2Supercompression::Zlib;
+    CHECK_EQUAL(std::string("Ktx2Texture: only Zstandard supercompression is supported"), GetOpenError(file));
+    file = good;
+    file.Header.VkFormat = 109;     // R32G32B32A32_SFLOAT.
+    CHECK_EQUAL(std::string("Ktx2Texture: unsupported VkFormat (RGBA8, BC1, BC3 and BC7 are)"), GetOpenError(file));
+
+    const std::string notSingle2D = "Ktx2Texture: must be a single 2D texture";
+    file = good;
+    file.Header.PixelDepth = 1;
+    CHECK_EQUAL(notSingle2D, GetOpenError(file));
+    file = good;
+    file.Header.LayerCount = 2;
+    CHECK_EQUAL(notSingle2D, GetOpenError(file));
+    file = good;
+    file.Header.FaceCount = 6;
+    CHECK_EQUAL(notSingle2D, GetOpenError(file));
+    file = good;
+    file.Header.PixelHeight = 0;
+    CHECK_EQUAL(notSingle2D, GetOpenError(file));
+
+    // Sizes and offsets that don't fit.
+    file = good;
+    file.Header.LevelCount = 6;
+    CHECK_EQUAL(std::string("Ktx2Texture: level index out of bounds"), GetOpenError(file));
+    file = good;
+    file.Levels[0].pop_back();
+    CHECK_EQUAL(std::string("Ktx2Texture: level out of bounds or of the wrong size"), GetOpenError(file));
+    file = good;
+    file.UncompressedSizes[0] += 4;
+    CHECK_EQUAL(std::string("Ktx2Texture: level out of bounds or of the wrong size"), GetOpenError(file));
+    file = good;
+    file.Header.Identifier[5] = '1';
+    CHECK_EQUAL(std::string("Ktx2Texture: not a KTX2 file"), GetOpenError(file));
+
+    bool threw = false;
+    try
+    {
+        Ktx2Texture texture;
+        texture.Open("Ktx2TextureTests.missing.ktx2");
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    remove(TexturePath);
+}
+
+TEST(Ktx2Texture, HashesTheWholeFile)
+{
+    TestRandom random;
+    WriteFile(MakeFile(VkRgba8Unorm, 8, 8, MakeRgbaLevels(8, 8, 4, random), false));
+    FILE* file = fopen(TexturePath, "rb");
+    REQUIRE(file != nullptr);
+    std::vector<uint8_t> bytes(1 << 16);
+    bytes.resize(fread(bytes.data(), 1, bytes.size(), file));
+    fclose(file);
+
+    Ktx2Texture texture;
+    texture.Open(TexturePath);
+    CHECK_EQUAL(HashContent(bytes.data(), bytes.size()), texture.HashFileContent());
+    texture.Close();
+    remove(TexturePath);
+}
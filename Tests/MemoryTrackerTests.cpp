@@ -0,0 +1,179 @@
+#include "TestFramework.h"
+
+#include "MemoryTracker.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Distinct, 16 byte aligned keys that need no memory behind them.
+    const void* Key(uintptr_t index)
+    {
+        return reinterpret_cast<const void*>((index + 1) * 64);
+    }
+}
+
+TEST(MemoryTracker, CategoryAccounting)
+{
+    MemoryTracker tracker;
+    tracker.Track(Key(0), 1000, MemoryTag(MemoryCategory::Textures, "albedo"));
+    tracker.Track(Key(1), 3000, MemoryTag(MemoryCategory::Textures, "normals"));
+    tracker.Track(Key(2), 500, MemoryTag(MemoryCategory::Upload, "staging"));
+
+    MemoryCategoryStats textures = tracker.GetStats(MemoryCategory::Textures);
+    CHECK_EQUAL(uint64_t(4000), textures.LiveBytes);
+    CHECK_EQUAL(uint64_t(2), textures.LiveCount);
+    CHECK_EQUAL(uint64_t(4000), textures.PeakBytes);
+    CHECK_EQUAL(uint64_t(2), textures.LiveCountBySizeClass[1]);
+    CHECK_EQUAL(uint64_t(4500), tracker.GetTotalLiveBytes());
+
+    // Freeing keeps the peak and the churn.
+    CHECK(tracker.Untrack(Key(1)));
+    CHECK(!tracker.Untrack(Key(1)));
+    CHECK(!tracker.Untrack(Key(99)));
+    textures = tracker.GetStats(MemoryCategory::Textures);
+    CHECK_EQUAL(uint64_t(1000), textures.LiveBytes);
+    CHECK_EQUAL(uint64_t(4000), textures.PeakBytes);
+    CHECK_EQUAL(uint64_t(4000), textures.AllocatedBytes);
+    CHECK_EQUAL(uint64_t(2), textures.AllocationCount);
+    CHECK_EQUAL(uint64_t(1), textures.FreeCount);
+    tracker.ResetPeaks();
+    CHECK_EQUAL(uint64_t(1000), tracker.GetStats(MemoryCategory::Textures).PeakBytes);
+
+    // Tracking a key again frees the old allocation, even across categories.
+    tracker.Track(Key(0), 200, MemoryTag(MemoryCategory::Buffers, "vertices"));
+    CHECK_EQUAL(uint64_t(0), tracker.GetStats(MemoryCategory::Textures).LiveBytes);
+    CHECK_EQUAL(uint64_t(2), tracker.GetStats(MemoryCategory::Textures).FreeCount);
+    CHECK_EQUAL(uint64_t(200), tracker.GetStats(MemoryCategory::Buffers).LiveBytes);
+    CHECK_EQUAL(uint64_t(0), tracker.GetStats(MemoryCategory::Descriptors).AllocationCount);
+
+    bool threw = false;
+    try
+    {
+        tracker.Track(Key(5), 1, MemoryTag(MemoryCategory::Count));
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK_EQUAL(std::string("descriptors"), std::string(GetMemoryCategoryName(MemoryCategory::Descriptors)));
+}
+
+TEST(MemoryTracker, SizeClasses)
+{
+    CHECK_EQUAL(0u, MemoryTracker::GetSizeClass(0));
+    CHECK_EQUAL(0u, MemoryTracker::GetSizeClass(256));
+    CHECK_EQUAL(1u, MemoryTracker::GetSizeClass(257));
+    CHECK_EQUAL(1u, MemoryTracker::GetSizeClass(4096));
+    CHECK_EQUAL(2u, MemoryTracker::GetSizeClass(4097));
+    CHECK_EQUAL(2u, MemoryTracker::GetSizeClass(65536));
+    CHECK_EQUAL(3u, MemoryTracker::GetSizeClass(1 << 20));
+    CHECK_EQUAL(4u, MemoryTracker::GetSizeClass((1 << 20) + 1));
+    CHECK_EQUAL(5u, MemoryTracker::GetSizeClass(256ull << 20));
+    CHECK_EQUAL(6u, MemoryTracker::GetSizeClass((256ull << 20) + 1));
+    CHECK_EQUAL(6u, MemoryTracker::GetSizeClass(~uint64_t(0)));
+}
+
+TEST(MemoryTracker, LeakReport)
+{
+    MemoryTracker tracker;
+    tracker.Track(Key(0), 100, MemoryTag(MemoryCategory::Buffers, "index buffer"));
+    tracker.Track(Key(1), 70000, MemoryTag(MemoryCategory::Buffers, "vertex buffer"));
+    tracker.Track(Key(2), 4096, MemoryTag(MemoryCategory::CpuStaging, "thread scratch", true));
+    tracker.Track(Key(3), 64, MemoryTag(MemoryCategory::Descriptors, "srv heap"));
+    tracker.Track(Key(4), 1 << 20, MemoryTag(MemoryCategory::Textures, "freed"));
+    tracker.Untrack(Key(4));
+
+    // By category, then largest first.
+    const std::vector<MemoryTracker::LiveAllocation> live = tracker.GetLiveAllocations();
+    REQUIRE(live.size() == 4);
+    CHECK(live[0].Key == Key(1));
+    CHECK(live[1].Key == Key(0));
+    CHECK(live[2].Key == Key(3));
+    CHECK(live[3].Tag.Persistent);
+
+    std::ostringstream report;
+    CHECK_EQUAL(size_t(3), tracker.WriteLeakReport(report));
+    const std::string text = report.str();
+    CHECK(text.find("Leaked allocations\n") != std::string::npos);
+    CHECK(text.find("  buffers 70000 bytes vertex buffer (") < text.find("  buffers 100 bytes index buffer ("));
+    CHECK(text.find("  descriptors 64 bytes srv heap (") != std::string::npos);
+    CHECK(text.find("thread scratch") == std::string::npos);
+    CHECK(text.find("freed") == std::string::npos);
+    CHECK(text.find(" <=256B:1 <=1MB:1\n") != std::string::npos);
+    CHECK(text.find("3 leaked, 1 persistent allocations still live\n") != std::string::npos);
+
+    // Nothing left but persistent memory: no leak section.
+    tracker.Untrack(Key(0));
+    tracker.Untrack(Key(1));
+    tracker.Untrack(Key(3));
+    std::ostringstream clean;
+    CHECK_EQUAL(size_t(0), tracker.WriteLeakReport(clean));
+    CHECK(clean.str().find("Leaked allocations") == std::string::npos);
+    CHECK(clean.str().find("0 leaked, 1 persistent allocations still live\n") != std::string::npos);
+}
+
+TEST(MemoryTracker, ConcurrentTracking)
+{
+    // Threads track and free their own keys, spread over every shard.
+    MemoryTracker tracker;
+    const uint32_t ThreadCount = 4;
+    const uint32_t AllocationsPerThread = 50000;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back([&tracker, t]()
+        {
+            const MemoryCategory category = static_cast<MemoryCategory>(t % 2);
+            for (uint32_t i = 0; i < AllocationsPerThread; ++i)
+            {
+                const void* key = Key(uintptr_t(t) * AllocationsPerThread + i);
+                tracker.Track(key, 100 + i % 1000, MemoryTag(category, "worker"));
+                if (i % 4 != 0)
+                {
+                    tracker.Untrack(key);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    uint64_t expectedLive = 0;
+    for (uint32_t i = 0; i < AllocationsPerThread; i += 4)
+    {
+        expectedLive += 100 + i % 1000;
+    }
+    for (MemoryCategory category : { MemoryCategory::Textures, MemoryCategory::Buffers })
+    {
+        const MemoryCategoryStats stats = tracker.GetStats(category);
+        CHECK_EQUAL(uint64_t(2) * AllocationsPerThread, stats.AllocationCount);
+        CHECK_EQUAL(uint64_t(2) * AllocationsPerThread * 3 / 4, stats.FreeCount);
+        CHECK_EQUAL(2 * expectedLive, stats.LiveBytes);
+        CHECK_EQUAL(stats.AllocationCount - stats.FreeCount, stats.LiveCount);
+    }
+    CHECK_EQUAL(size_t(ThreadCount) * AllocationsPerThread / 4, tracker.GetLiveAllocations().size());
+}
+
+TEST(MemoryTracker, TrackedContainers)
+{
+    MemoryTracker& tracker = GetMemoryTracker();
+    const MemoryCategoryStats before = tracker.GetStats(MemoryCategory::Descriptors);
+    {
+        TrackedVector<uint32_t> handles{ TrackedAllocator<uint32_t>(MemoryTag(MemoryCategory::Descriptors, "handles")) };
+        handles.resize(1000);
+        const MemoryCategoryStats during = tracker.GetStats(MemoryCategory::Descriptors);
+        CHECK(during.LiveBytes >= before.LiveBytes + 4000);
+        CHECK(during.AllocationCount > before.AllocationCount);
+    }
+    const MemoryCategoryStats after = tracker.GetStats(MemoryCategory::Descriptors);
+    CHECK_EQUAL(before.LiveBytes, after.LiveBytes);
+    CHECK_EQUAL(before.LiveCount, after.LiveCount);
+}
@@ -0,0 +1,99 @@
+#include "BenchmarkFramework.h"
+
+#include "MeshImporter.h"
+#include "ThreadPool.h"
+
+#include <cstdio>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    const char* const ObjPath = "MeshImporterBenchmarks.obj";
+
+    // A size x size grid of textured quads, written a line at a time so that the text is never
+    // held in memory. Returns the file size.
+    size_t WriteGrid(uint32_t size)
+    {
+        FILE* file = fopen(ObjPath, "wb");
+        if (!file)
+        {
+            return 0;
+        }
+        for (uint32_t y = 0; y <= size; ++y)
+        {
+            for (uint32_t x = 0; x <= size; ++x)
+            {
+                fprintf(file, "v %.6f %.6f %.6f\n", x * 0.01f, 0.125f * ((x * 7 + y * 3) % 17), y * -0.01f);
+                fprintf(file, "vt %.6f %.6f\n", float(x) / size, float(y) / size);
+            }
+        }
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const uint32_t a = y * (size + 1) + x + 1;
+                const uint32_t b = a + size + 1;
+                fprintf(file, "f %u/%u %u/%u %u/%u %u/%u\n", a, a, a + 1, a + 1, b + 1, b + 1, b, b);
+            }
+        }
+        const size_t bytes = static_cast<size_t>(ftell(file));
+        fclose(file);
+        return bytes;
+    }
+
+    // The process's peak resident memory so far, in bytes; 0 where it is not available.
+    double GetPeakResidentBytes()
+    {
+#if defined(_WIN32)
+        return 0.0;
+#else
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss * 1024.0;
+#endif
+    }
+
+    void Import(ThreadPool* pool, std::vector<uint32_t>& indices, std::vector<MeshVertex>& vertices)
+    {
+        MeshImporter importer(pool);
+        importer.Open(ObjPath);
+        indices.resize(importer.GetIndexCount());
+        importer.ReadIndices(indices.data());
+        vertices.resize(importer.GetVertexCount());
+        importer.ReadVertices(vertices.data());
+    }
+}
+
+BENCHMARK(MeshImporter, Obj)
+{
+    // 700x700 quads: about 50 MB of text, 490k positions, 980k triangles.
+    const size_t bytes = WriteGrid(700);
+    if (bytes == 0)
+    {
+        Report("Can't write the mesh", 0.0, "");
+        return;
+    }
+
+    // Peak memory first, before anything else has grown the high-water mark: the importer
+    // holds at most the chunks being parsed of the mapped text, on top of its output.
+    std::vector<uint32_t> indices;
+    std::vector<MeshVertex> vertices;
+    const double peakBefore = GetPeakResidentBytes();
+    Import(nullptr, indices, vertices);
+    const double outputBytes = double(indices.size()) * sizeof(uint32_t) + double(vertices.size()) * sizeof(MeshVertex);
+    if (peakBefore > 0.0)
+    {
+        Report("Peak memory over the output", (GetPeakResidentBytes() - peakBefore - outputBytes) / 1e6, "MB");
+        Report("  file", bytes / 1e6, "MB");
+        Report("  output", outputBytes / 1e6, "MB");
+    }
+
+    ReportBytes("1 thread", double(bytes), BestSeconds(3, [&]() { Import(nullptr, indices, vertices); }));
+    ThreadPool pool;
+    ReportBytes("Pool", double(bytes), BestSeconds(3, [&]() { Import(&pool, indices, vertices); }));
+    remove(ObjPath);
+}
@@ -0,0 +1,375 @@
+#include "TestFramework.h"
+
+#include "MeshImporter.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // A corner of an imported triangle, by value.
+    struct Corner
+    {
+        float Position[3];
+        float Uv[2];
+
+        bool operator==(const Corner& other) const
+        {
+            return memcmp(this, &other, sizeof(Corner)) == 0;
+        }
+    };
+
+    // The triangle corners of OBJ text, read line by line with the standard library, with the
+    // importer's conventions: Z and V flipped, fans wound the other way round, (0, 0) for
+    // corners without a texture coordinate.
+    std::vector<Corner> ParseNaive(const std::string& text)
+    {
+        std::vector<float> positions;
+        std::vector<float> texCoords;
+        std::vector<Corner> corners;
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            line = line.substr(0, line.find('#'));
+            std::istringstream tokens(line);
+            std::string keyword;
+            tokens >> keyword;
+            if (keyword == "v")
+            {
+                std::string x, y, z;
+                tokens >> x >> y >> z;
+                positions.push_back(strtof(x.c_str(), nullptr));
+                positions.push_back(strtof(y.c_str(), nullptr));
+                positions.push_back(-strtof(z.c_str(), nullptr));
+            }
+            else if (keyword == "vt")
+            {
+                std::string u, v;
+                tokens >> u >> v;
+                texCoords.push_back(strtof(u.c_str(), nullptr));
+                texCoords.push_back(1.0f - strtof(v.c_str(), nullptr));
+            }
+            else if (keyword == "f")
+            {
+                std::vector<Corner> face;
+                std::string token;
+                while (tokens >> token)
+                {
+                    Corner corner = {};
+                    const long position = strtol(token.c_str(), nullptr, 10);
+                    const size_t p = position > 0 ? position - 1 : positions.size() / 3 + position;
+                    memcpy(corner.Position, &positions[3 * p], sizeof(corner.Position));
+                    const size_t slash = token.find('/');
+                    if (slash != std::string::npos && slash + 1 < token.size() && token[slash + 1] != '/')
+                    {
+                        const long texCoord = strtol(token.c_str() + slash + 1, nullptr, 10);
+                        const size_t t = texCoord > 0 ? texCoord - 1 : texCoords.size() / 2 + texCoord;
+                        memcpy(corner.Uv, &texCoords[2 * t], sizeof(corner.Uv));
+                    }
+                    face.push_back(corner);
+                }
+                for (size_t i = 1; i + 1 < face.size(); ++i)
+                {
+                    corners.push_back(face[0]);
+                    corners.push_back(face[i + 1]);
+                    corners.push_back(face[i]);
+                }
+            }
+        }
+        return corners;
+    }
+
+    // Random OBJ text: numbers in every notation, relative and absolute indices, corners with
+    // and without texture coordinates and normals, polygons, comments, other statements, CRLF
+    // and LF, and no newline at the end.
+    std::string MakeObj(size_t faceCount, TestRandom& random)
+    {
+        std::string text = "# generated\r\nmtllib scene.mtl\no object\n";
+        uint32_t positions = 0;
+        uint32_t texCoords = 0;
+        char line[256];
+        const auto number = [&random](char* out, size_t size)
+        {
+            const float value = (float(random.NextBelow(2000001)) - 1000000.0f) / float(1 + random.NextBelow(1000));
+            switch (random.NextBelow(4))
+            {
+            case 0: snprintf(out, size, "%.7g", value); break;
+            case 1: snprintf(out, size, "%.3e", value); break;
+            case 2: snprintf(out, size, "%d", int(value)); break;
+            default: snprintf(out, size, "%.4f", value); break;
+            }
+        };
+        for (size_t face = 0; face < faceCount; ++face)
+        {
+            while (positions < 4 || random.NextBelow(3) == 0)
+            {
+                char x[32], y[32], z[32];
+                number(x, sizeof(x));
+                number(y, sizeof(y));
+                number(z, sizeof(z));
+                snprintf(line, sizeof(line), random.NextBelow(8) == 0 ? "v  %s\t%s %s 1.0\r\n" : "v %s %s %s\n", x, y, z);
+                text += line;
+                ++positions;
+            }
+            while (texCoords < 4 || random.NextBelow(4) == 0)
+            {
+                snprintf(line, sizeof(line), "vt %.4f %.4f\n", random.NextBelow(10001) / 10000.0f, random.NextBelow(10001) / 10000.0f);
+                text += line;
+                ++texCoords;
+            }
+            if (random.NextBelow(10) == 0)
+            {
+                text += random.NextBelow(2) == 0 ? "vn 0 1 0\n" : "usemtl stone\ns 1\n";
+            }
+
+            text += "f";
+            const uint32_t cornerCount = 3 + (random.NextBelow(3) == 0 ? random.NextBelow(4) : 0);
+            for (uint32_t corner = 0; corner < cornerCount; ++corner)
+            {
+                const uint32_t position = random.NextBelow(positions);
+                const uint32_t texCoord = random.NextBelow(texCoords);
+                const bool relative = random.NextBelow(4) == 0;
+                const long p = relative ? -long(positions - position) : long(position + 1);
+                const long t = relative ? -long(texCoords - texCoord) : long(texCoord + 1);
+                switch (random.NextBelow(5))
+                {
+                case 0: snprintf(line, sizeof(line), " %ld", p); break;
+                case 1: snprintf(line, sizeof(line), " %ld//1", p); break;
+                case 2: snprintf(line, sizeof(line), " %ld/%ld/1", p, t); break;
+                default: snprintf(line, sizeof(line), "  %ld/%ld", p, t); break;
+                }
+                text += line;
+            }
+            text += random.NextBelow(20) == 0 ? " # quad\r\n" : "\n";
+        }
+        text += "f 1/1 2/2 3/3";
+        return text;
+    }
+
+    // The corners of the importer's triangles.
+    std::vector<Corner> Import(const std::string& text, ThreadPool* pool, MeshImportStats* stats = nullptr)
+    {
+        MeshImporter importer(pool);
+        importer.OpenMemory(text.data(), text.size());
+        std::vector<uint32_t> indices(importer.GetIndexCount());
+        importer.ReadIndices(indices.data());
+        std::vector<MeshVertex> vertices(importer.GetVertexCount());
+        importer.ReadVertices(vertices.data());
+        if (stats)
+        {
+            *stats = importer.GetStats();
+        }
+
+        std::vector<Corner> corners(indices.size());
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            memcpy(&corners[i], &vertices.at(indices[i]), sizeof(Corner));
+        }
+        return corners;
+    }
+
+    bool Throws(const std::string& text)
+    {
+        try
+        {
+            Import(text, nullptr);
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+TEST(MeshImporter, ParsesFloatsLikeStrtof)
+{
+    // Up to 7 significant digits the result is strtof's exactly; with more, within one unit in
+    // the last place.
+    TestRandom random;
+    uint32_t inexact = 0;
+    uint32_t farOff = 0;
+    for (int i = 0; i < 200000; ++i)
+    {
+        uint32_t bits = static_cast<uint32_t>(random.Next());
+        bits = (bits & 0x80000000u) | (bits & 0x007fffffu) | ((96 + random.NextBelow(64)) << 23);
+        float source;
+        memcpy(&source, &bits, sizeof(source));
+
+        char text[64];
+        const bool shortForm = i % 2 == 0;
+        snprintf(text, sizeof(text), shortForm ? "%.7g" : "%.9g", source);
+        const size_t length = strlen(text);
+        float parsed = 0.0f;
+        const char* end = ParseMeshFloat(text, text + length, parsed);
+        const float expected = strtof(text, nullptr);
+        if (end != text + length)
+        {
+            ++farOff;
+            continue;
+        }
+        int32_t parsedBits, expectedBits;
+        memcpy(&parsedBits, &parsed, sizeof(parsed));
+        memcpy(&expectedBits, &expected, sizeof(expected));
+        const int32_t distance = std::abs(parsedBits - expectedBits);
+        inexact += shortForm && distance != 0 ? 1 : 0;
+        farOff += distance > 1 ? 1 : 0;
+    }
+    CHECK_EQUAL(0u, inexact);
+    CHECK_EQUAL(0u, farOff);
+
+    // Bounded by end, and null where there is no number.
+    const char digits[] = "123456";
+    float value = 0.0f;
+    CHECK(ParseMeshFloat(digits, digits + 3, value) == digits + 3);
+    CHECK_EQUAL(123.0f, value);
+    const char* const notNumbers[] = { "x", "-", "", "e5" };
+    for (const char* text : notNumbers)
+    {
+        CHECK(ParseMeshFloat(text, text + strlen(text), value) == nullptr);
+    }
+}
+
+TEST(MeshImporter, GoldenMesh)
+{
+    // A quad, and a triangle that uses the third position with another texture coordinate.
+    const std::string text =
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 1 1 0\n"
+        "v 0 1 2\n"
+        "vt 0 0\n"
+        "vt 1 0\n"
+        "vt 1 1\n"
+        "vt 0 1\n"
+        "vt 0.5 0.5\n"
+        "f 1/1 2/2 3/3 4/4\n"
+        "f 3/5 4/4 1/1\n";
+    MeshImporter importer;
+    importer.OpenMemory(text.data(), text.size());
+    REQUIRE(importer.GetIndexCount() == 9);
+    uint32_t indices[9];
+    importer.ReadIndices(indices);
+    const uint32_t expectedIndices[] = { 0, 2, 1, 0, 3, 2, 4, 0, 3 };
+    CHECK(memcmp(indices, expectedIndices, sizeof(indices)) == 0);
+
+    REQUIRE(importer.GetVertexCount() == 5);
+    MeshVertex vertices[5];
+    importer.ReadVertices(vertices);
+    const MeshVertex expected[] = {
+        { { 0, 0, 0 }, { 0, 1 } },
+        { { 1, 0, 0 }, { 1, 1 } },
+        { { 1, 1, 0 }, { 1, 0 } },
+        { { 0, 1, -2 }, { 0, 0 } },
+        { { 1, 1, 0 }, { 0.5f, 0.5f } },
+    };
+    for (int i = 0; i < 5; ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            CHECK_EQUAL(expected[i].Position[axis], vertices[i].Position[axis]);
+        }
+        CHECK_EQUAL(expected[i].Uv[0], vertices[i].Uv[0]);
+        CHECK_EQUAL(expected[i].Uv[1], vertices[i].Uv[1]);
+    }
+
+    const MeshBounds& bounds = importer.GetBounds();
+    CHECK_EQUAL(0.0f, bounds.Min[0]);
+    CHECK_EQUAL(-2.0f, bounds.Min[2]);
+    CHECK_EQUAL(1.0f, bounds.Max[1]);
+    CHECK_EQUAL(0.0f, bounds.Max[2]);
+
+    const MeshImportStats& stats = importer.GetStats();
+    CHECK_EQUAL(uint64_t(text.size()), stats.Bytes);
+    CHECK_EQUAL(1u, stats.Chunks);
+    CHECK_EQUAL(4u, stats.Positions);
+    CHECK_EQUAL(5u, stats.TexCoords);
+    CHECK_EQUAL(uint64_t(3), stats.Triangles);
+    CHECK_EQUAL(1u, stats.SeamVertices);
+}
+
+TEST(MeshImporter, MatchesNaiveParser)
+{
+    TestRandom random;
+    for (int file = 0; file < 50; ++file)
+    {
+        const std::string text = MakeObj(1 + random.NextBelow(300), random);
+        CHECK(Import(text, nullptr) == ParseNaive(text));
+    }
+}
+
+TEST(MeshImporter, ChunksFromAFile)
+{
+    // Several chunks, so relative indices and seams cross chunk boundaries; mapped from a file,
+    // on one thread and on the pool.
+    TestRandom random;
+    std::string text;
+    while (text.size() < 3 * MeshImporter::ChunkSize)
+    {
+        text += MakeObj(10000, random) + "\n";
+    }
+    const char* const path = "MeshImporterTests.obj";
+    FILE* file = fopen(path, "wb");
+    REQUIRE(file != nullptr);
+    fwrite(text.data(), 1, text.size(), file);
+    fclose(file);
+
+    const std::vector<Corner> expected = ParseNaive(text);
+    ThreadPool pool(3);
+    for (ThreadPool* importPool : { static_cast<ThreadPool*>(nullptr), &pool })
+    {
+        MeshImporter importer(importPool);
+        importer.Open(path);
+        CHECK(importer.GetStats().Chunks >= 3);
+        std::vector<uint32_t> indices(importer.GetIndexCount());
+        importer.ReadIndices(indices.data());
+        std::vector<MeshVertex> vertices(importer.GetVertexCount());
+        importer.ReadVertices(vertices.data());
+        importer.Close();
+
+        REQUIRE(indices.size() == expected.size());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            Corner corner;
+            memcpy(&corner, &vertices.at(indices[i]), sizeof(corner));
+            mismatches += corner == expected[i] ? 0 : 1;
+        }
+        CHECK_EQUAL(size_t(0), mismatches);
+    }
+    remove(path);
+
+    bool threw = false;
+    try
+    {
+        MeshImporter importer;
+        importer.Open("MeshImporterTests.missing.obj");
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(MeshImporter, RejectsMalformedFaces)
+{
+    const std::string vertices = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\n";
+    CHECK(!Throws(vertices + "f 1 2 3\n"));
+    CHECK(Throws(vertices + "f 1 2\n"));
+    CHECK(Throws(vertices + "f 1 2 4\n"));
+    CHECK(Throws(vertices + "f 0 1 2\n"));
+    CHECK(Throws(vertices + "f -4 1 2\n"));
+    CHECK(Throws(vertices + "f 1/2 2 3\n"));
+    CHECK(Throws(vertices + "f 1 2 a\n"));
+    CHECK(Throws(vertices + "f 1 2 3x\n"));
+    CHECK(Throws("v 0 0\nf 1 1 1\n"));
+}
@@ -0,0 +1,69 @@
+#include "BenchmarkFramework.h"
+
+#include "LodSelector.h"
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // A 128K triangle height field, curved enough that the error bounds matter.
+    void MakeTerrain(std::vector<float>& positions, std::vector<uint32_t>& indices)
+    {
+        const uint32_t size = 256;
+        for (uint32_t y = 0; y <= size; ++y)
+        {
+            for (uint32_t x = 0; x <= size; ++x)
+            {
+                positions.insert(positions.end(), { float(x), float(y), std::sin(x * 0.1f) * std::cos(y * 0.07f) * 8.0f });
+            }
+        }
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const uint32_t a = y * (size + 1) + x;
+                indices.insert(indices.end(), { a, a + 1, a + size + 1, a + 1, a + size + 2, a + size + 1 });
+            }
+        }
+    }
+}
+
+BENCHMARK(MeshSimplifier, LodChain)
+{
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    MakeTerrain(positions, indices);
+    const SimplifierMesh mesh = { indices.data(), indices.size(), positions.data(), 3 * sizeof(float), positions.size() / 3 };
+
+    LodChain chain;
+    MeshSimplifier single;
+    const double singleSeconds = BestSeconds(2, [&]() { single.GenerateLodChain(mesh, 6, 0.5f, 4.0f, chain); });
+    Report("LOD chain, 128K triangles, 1 thread", indices.size() / 3 / singleSeconds / 1e3, "K triangles/s");
+
+    ThreadPool pool;
+    MeshSimplifier pooled(&pool);
+    const double pooledSeconds = BestSeconds(2, [&]() { pooled.GenerateLodChain(mesh, 6, 0.5f, 4.0f, chain); });
+    Report("LOD chain, 128K triangles, pool", indices.size() / 3 / pooledSeconds / 1e3, "K triangles/s");
+    Report("Levels", double(chain.Levels.size()), "");
+}
+
+BENCHMARK(LodSelector, Update)
+{
+    LodChain chain;
+    chain.Levels = { { 0, 3000, 0.0f }, { 3000, 1500, 0.01f }, { 4500, 750, 0.1f }, { 5250, 375, 1.0f } };
+    LodSelector selector;
+    for (uint32_t i = 0; i < 1000000; ++i)
+    {
+        const float center[3] = { float(i % 1000), 0.0f, float(i / 1000) };
+        selector.AddInstance(center, 1.0f, 1.0f, chain);
+    }
+    const float eye[3] = { 500.0f, 10.0f, -10.0f };
+    selector.SetCamera(eye, 1.0f, 1080.0f);
+
+    ThreadPool pool;
+    Report("Select 1M instances, 1 thread", BestSeconds(5, [&]() { selector.Update(); }) * 1e3, "ms");
+    Report("Select 1M instances, pool", BestSeconds(5, [&]() { selector.Update(&pool); }) * 1e3, "ms");
+}
@@ -0,0 +1,374 @@
+#include "TestFramework.h"
+
+#include "LodSelector.h"
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<float> Positions;
+        std::vector<uint32_t> Indices;
+
+        SimplifierMesh View() const
+        {
+            return { Indices.data(), Indices.size(), Positions.data(), 3 * sizeof(float), Positions.size() / 3 };
+        }
+    };
+
+    // A size x size grid of quads over z = height(x, y).
+    template <typename Height>
+    TestMesh MakeGrid(uint32_t size, Height height)
+    {
+        TestMesh mesh;
+        for (uint32_t y = 0; y <= size; ++y)
+        {
+            for (uint32_t x = 0; x <= size; ++x)
+            {
+                mesh.Positions.insert(mesh.Positions.end(), { float(x), float(y), height(float(x), float(y)) });
+            }
+        }
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const uint32_t a = y * (size + 1) + x;
+                mesh.Indices.insert(mesh.Indices.end(), { a, a + 1, a + size + 1, a + 1, a + size + 2, a + size + 1 });
+            }
+        }
+        return mesh;
+    }
+
+    TestMesh MakePlane(uint32_t size)
+    {
+        return MakeGrid(size, [](float, float) { return 0.0f; });
+    }
+
+    TestMesh MakeHills(uint32_t size)
+    {
+        return MakeGrid(size, [](float x, float y) { return std::sin(x * 0.3f) * std::cos(y * 0.2f) * 3.0f; });
+    }
+
+    // The z of every triangle normal; the grids start out all positive.
+    bool AllFaceUp(const TestMesh& mesh, const std::vector<uint32_t>& indices)
+    {
+        bool up = true;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            const float* a = &mesh.Positions[indices[i] * 3];
+            const float* b = &mesh.Positions[indices[i + 1] * 3];
+            const float* c = &mesh.Positions[indices[i + 2] * 3];
+            up &= (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]) > 0.0f;
+        }
+        return up;
+    }
+
+    bool Uses(const std::vector<uint32_t>& indices, uint32_t vertex)
+    {
+        return std::find(indices.begin(), indices.end(), vertex) != indices.end();
+    }
+
+    // A chain with the given level errors, each level half the triangles of the previous one.
+    LodChain MakeChain(std::initializer_list<float> errors)
+    {
+        LodChain chain;
+        uint32_t count = 3 << 10;
+        uint32_t offset = 0;
+        for (float error : errors)
+        {
+            chain.Levels.push_back({ offset, count, error });
+            offset += count;
+            count /= 2;
+        }
+        return chain;
+    }
+
+    const float Fov = 1.0471976f;       // 60 degrees: the projection scale is height / (2 tan 30).
+    const float ViewportHeight = 1000.0f;
+}
+
+TEST(MeshSimplifier, RejectsMalformedIndices)
+{
+    const TestMesh plane = MakePlane(2);
+    MeshSimplifier simplifier;
+    std::vector<uint32_t> out;
+    bool threw = false;
+    try
+    {
+        simplifier.Simplify(plane.View(), plane.Indices.data(), 4, 0, 1.0f, out);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+
+    const uint32_t outOfRange[3] = { 0, 1, 9 };
+    threw = false;
+    try
+    {
+        simplifier.Simplify(plane.View(), outOfRange, 3, 0, 1.0f, out);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(MeshSimplifier, PlaneCollapsesWithoutError)
+{
+    // Every interior collapse of a plane is free, and border vertices slide along the border.
+    const TestMesh plane = MakePlane(32);
+    MeshSimplifier simplifier;
+    std::vector<uint32_t> out;
+    const float error = simplifier.Simplify(plane.View(), plane.Indices.data(), plane.Indices.size(), plane.Indices.size() / 10, 0.01f, out);
+
+    CHECK(error < 1e-3f);
+    CHECK_EQUAL(size_t(0), out.size() % 3);
+    CHECK(out.size() <= plane.Indices.size() / 10 + 3 * 8);
+    CHECK(AllFaceUp(plane, out));
+    // The corners can't move: a corner collapse would change the outline.
+    CHECK(Uses(out, 0));
+    CHECK(Uses(out, 32));
+    CHECK(Uses(out, 33 * 32));
+    CHECK(Uses(out, 33 * 33 - 1));
+}
+
+TEST(MeshSimplifier, StopsAtMaxError)
+{
+    const TestMesh hills = MakeHills(40);
+    MeshSimplifier simplifier;
+    std::vector<uint32_t> strict;
+    std::vector<uint32_t> loose;
+    const float strictError = simplifier.Simplify(hills.View(), hills.Indices.data(), hills.Indices.size(), 0, 0.05f, strict);
+    const float looseError = simplifier.Simplify(hills.View(), hills.Indices.data(), hills.Indices.size(), 0, 0.5f, loose);
+
+    CHECK(strictError <= 0.05f);
+    CHECK(looseError <= 0.5f);
+    CHECK(strict.size() < hills.Indices.size());
+    CHECK(loose.size() < strict.size());
+    CHECK(AllFaceUp(hills, strict));
+}
+
+TEST(MeshSimplifier, SeamVerticesStayPut)
+{
+    // A texture seam down the middle of a plane: the column x = 8 is split into two vertices per
+    // position, one for each side. Neither copy may move, or the seam would open.
+    TestMesh plane = MakePlane(16);
+    const uint32_t firstSeamCopy = static_cast<uint32_t>(plane.Positions.size() / 3);
+    for (uint32_t y = 0; y <= 16; ++y)
+    {
+        const uint32_t original = y * 17 + 8;
+        plane.Positions.insert(plane.Positions.end(), { 8.0f, float(y), 0.0f });
+        // The triangles right of the seam use the copy.
+        for (size_t i = 0; i < plane.Indices.size(); i += 3)
+        {
+            bool right = true;
+            for (int k = 0; k < 3; ++k)
+            {
+                right &= plane.Indices[i + k] % 17 >= 8;
+            }
+            for (int k = 0; k < 3 && right; ++k)
+            {
+                if (plane.Indices[i + k] == original)
+                {
+                    plane.Indices[i + k] = firstSeamCopy + y;
+                }
+            }
+        }
+    }
+
+    MeshSimplifier simplifier;
+    std::vector<uint32_t> out;
+    simplifier.Simplify(plane.View(), plane.Indices.data(), plane.Indices.size(), 0, 0.01f, out);
+    CHECK(out.size() < plane.Indices.size() / 2);
+    uint32_t missing = 0;
+    for (uint32_t y = 0; y <= 16; ++y)
+    {
+        missing += Uses(out, y * 17 + 8) ? 0 : 1;
+        missing += Uses(out, firstSeamCopy + y) ? 0 : 1;
+    }
+    CHECK_EQUAL(0u, missing);
+}
+
+TEST(MeshSimplifier, LodChainLevels)
+{
+    const TestMesh hills = MakeHills(64);
+    MeshSimplifier simplifier;
+    LodChain chain;
+    simplifier.GenerateLodChain(hills.View(), 6, 0.5f, 1.0f, chain);
+    REQUIRE(chain.Levels.size() >= 3);
+    CHECK(chain.Levels.size() <= 6);
+
+    // Level 0 is the mesh, and the levels are packed back to back.
+    CHECK(std::equal(hills.Indices.begin(), hills.Indices.end(), chain.Indices.begin()));
+    CHECK_EQUAL(0.0f, chain.Levels[0].Error);
+    uint32_t offset = 0;
+    for (size_t l = 0; l < chain.Levels.size(); ++l)
+    {
+        const LodLevel& level = chain.Levels[l];
+        CHECK_EQUAL(offset, level.IndexOffset);
+        CHECK_EQUAL(0u, level.IndexCount % 3);
+        offset += level.IndexCount;
+        if (l > 0)
+        {
+            // Each level is meaningfully smaller, about halved, and no more accurate.
+            const LodLevel& previous = chain.Levels[l - 1];
+            CHECK(level.IndexCount * 20 <= previous.IndexCount * 19);
+            CHECK(level.IndexCount >= previous.IndexCount / 2 - 3 * 4);
+            CHECK(level.Error >= previous.Error);
+        }
+    }
+    CHECK_EQUAL(size_t(offset), chain.Indices.size());
+}
+
+TEST(MeshSimplifier, PoolMatchesSingleThread)
+{
+    const TestMesh meshes[3] = { MakeHills(30), MakePlane(24), MakeHills(12) };
+    SimplifierMesh views[3] = { meshes[0].View(), meshes[1].View(), meshes[2].View() };
+
+    MeshSimplifier single;
+    LodChain expected[3];
+    for (int m = 0; m < 3; ++m)
+    {
+        single.GenerateLodChain(views[m], 5, 0.5f, 1.0f, expected[m]);
+    }
+
+    ThreadPool pool(3);
+    MeshSimplifier pooled(&pool);
+    LodChain chains[3];
+    pooled.GenerateLodChains(views, 3, 5, 0.5f, 1.0f, chains);
+    for (int m = 0; m < 3; ++m)
+    {
+        CHECK(chains[m].Indices == expected[m].Indices);
+        REQUIRE(chains[m].Levels.size() == expected[m].Levels.size());
+        for (size_t l = 0; l < chains[m].Levels.size(); ++l)
+        {
+            CHECK_EQUAL(expected[m].Levels[l].IndexCount, chains[m].Levels[l].IndexCount);
+            CHECK_EQUAL(expected[m].Levels[l].Error, chains[m].Levels[l].Error);
+        }
+    }
+}
+
+TEST(LodSelector, ProjectError)
+{
+    LodSelector selector;
+    const float eye[3] = { 0, 0, 0 };
+    selector.SetCamera(eye, Fov, ViewportHeight);
+    const float scale = ViewportHeight / (2.0f * std::tan(Fov * 0.5f));
+    CHECK(std::fabs(selector.ProjectError(0.01f, 10.0f) - 0.01f * scale / 10.0f) < 1e-4f);
+    // Inside the bounds the distance is clamped, not negative.
+    CHECK(selector.ProjectError(0.01f, -5.0f) > 0.0f);
+}
+
+TEST(LodSelector, CoarserWithDistance)
+{
+    const LodChain chain = MakeChain({ 0.0f, 0.001f, 0.01f, 0.1f });
+    LodSelector selector(1.0f, 0.0f);
+    const float center[3] = { 0, 0, 0 };
+    selector.AddInstance(center, 1.0f, 1.0f, chain);
+
+    uint32_t previous = 0;
+    bool monotonic = true;
+    for (float distance = 1.5f; distance < 1000.0f; distance *= 1.2f)
+    {
+        const float eye[3] = { 0, 0, -distance };
+        selector.SetCamera(eye, Fov, ViewportHeight);
+        selector.Update();
+        const uint32_t lod = selector.GetSelectedLod(0);
+        monotonic &= lod >= previous;
+        previous = lod;
+
+        // The selected level is under the threshold, and the next one would not be.
+        const float surface = distance - 1.0f;
+        monotonic &= selector.ProjectError(chain.Levels[lod].Error, surface) <= 1.0f;
+        if (lod + 1 < chain.Levels.size())
+        {
+            monotonic &= selector.ProjectError(chain.Levels[lod + 1].Error, surface) > 1.0f;
+        }
+    }
+    CHECK(monotonic);
+    CHECK_EQUAL(3u, previous);
+
+    // Inside the bounds: the finest level.
+    const float inside[3] = { 0.2f, 0, 0 };
+    selector.SetCamera(inside, Fov, ViewportHeight);
+    selector.Update();
+    CHECK_EQUAL(0u, selector.GetSelectedLod(0));
+    CHECK(&selector.GetSelectedLevel(0) == &chain.Levels[0]);
+}
+
+TEST(LodSelector, HysteresisDelaysCoarsening)
+{
+    // One level with error 0.01 over a radius 0 instance: its projected error is 1 pixel at the
+    // distance d1 below, and 0.8 pixels (the hysteresis threshold) 25% farther.
+    const LodChain chain = MakeChain({ 0.0f, 0.01f });
+    LodSelector selector(1.0f, 0.2f);
+    const float center[3] = { 0, 0, 0 };
+    selector.AddInstance(center, 0.0f, 1.0f, chain);
+    const float d1 = 0.01f * ViewportHeight / (2.0f * std::tan(Fov * 0.5f));
+
+    auto selectAt = [&](float distance)
+    {
+        const float eye[3] = { 0, 0, -distance };
+        selector.SetCamera(eye, Fov, ViewportHeight);
+        selector.Update();
+        return selector.GetSelectedLod(0);
+    };
+
+    CHECK_EQUAL(0u, selectAt(d1 * 0.9f));
+    // Under 1 pixel but not under 0.8: stays fine.
+    CHECK_EQUAL(0u, selectAt(d1 * 1.1f));
+    // Under 0.8: coarsens.
+    CHECK_EQUAL(1u, selectAt(d1 * 1.3f));
+    // Back between the two: stays coarse.
+    CHECK_EQUAL(1u, selectAt(d1 * 1.1f));
+    // Over 1 pixel: refines right away.
+    CHECK_EQUAL(0u, selectAt(d1 * 0.95f));
+
+    // The scale multiplies the errors: twice the size, twice the distance.
+    const float eye[3] = { 0, 0, -d1 * 1.3f };
+    selector.SetCamera(eye, Fov, ViewportHeight);
+    selector.SetInstanceBounds(0, center, 0.0f, 2.0f);
+    selector.Update();
+    CHECK_EQUAL(0u, selector.GetSelectedLod(0));
+}
+
+TEST(LodSelector, PoolMatchesSingleThread)
+{
+    const LodChain chain = MakeChain({ 0.0f, 0.05f, 0.2f, 0.5f, 1.0f });
+    LodSelector single;
+    LodSelector pooled;
+    TestRandom random;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        const float center[3] = { random.NextBelow(2000) - 1000.0f, random.NextBelow(100) - 50.0f, random.NextBelow(2000) - 1000.0f };
+        const float radius = 0.5f + random.NextBelow(40) / 10.0f;
+        single.AddInstance(center, radius, 1.0f, chain);
+        pooled.AddInstance(center, radius, 1.0f, chain);
+    }
+    const float eye[3] = { 10, 2, -30 };
+    single.SetCamera(eye, Fov, ViewportHeight);
+    pooled.SetCamera(eye, Fov, ViewportHeight);
+
+    ThreadPool pool(3);
+    single.Update();
+    pooled.Update(&pool);
+    uint32_t different = 0;
+    uint32_t levelsUsed = 0;
+    for (uint32_t i = 0; i < single.GetInstanceCount(); ++i)
+    {
+        different += single.GetSelectedLod(i) != pooled.GetSelectedLod(i) ? 1 : 0;
+        levelsUsed |= 1u << single.GetSelectedLod(i);
+    }
+    CHECK_EQUAL(0u, different);
+    // The scene spans every level.
+    CHECK_EQUAL(0x1Fu, levelsUsed);
+}
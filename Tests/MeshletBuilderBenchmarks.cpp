@@ -0,0 +1,41 @@
+#include "BenchmarkFramework.h"
+
+#include "MeshletBuilder.h"
+
+#include <cmath>
+#include <vector>
+
+BENCHMARK(MeshletBuilder, Build)
+{
+    // A 1M triangle grid, bent so the cones are not all the same.
+    const uint32_t size = 708;
+    std::vector<float> positions;
+    for (uint32_t y = 0; y <= size; ++y)
+    {
+        for (uint32_t x = 0; x <= size; ++x)
+        {
+            positions.push_back(float(x));
+            positions.push_back(float(y));
+            positions.push_back(std::sin(x * 0.05f) * std::cos(y * 0.05f) * 20.0f);
+        }
+    }
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            const uint32_t a = y * (size + 1) + x;
+            indices.insert(indices.end(), { a, a + 1, a + size + 1, a + 1, a + size + 2, a + size + 1 });
+        }
+    }
+
+    MeshletBuilder builder;
+    MeshletMesh out;
+    const double seconds = BestSeconds(3, [&]()
+    {
+        builder.Build(indices.data(), indices.size(), positions.data(), positions.size() / 3, 3 * sizeof(float), out);
+    });
+    Report("Build 1M triangles (64/124)", indices.size() / 3 / seconds / 1e6, "M triangles/s");
+    Report("Meshlets", double(out.Meshlets.size()), "");
+    Report("Serialize", BestSeconds(5, [&]() { MeshletBuilder::Serialize(out); }) * 1e3, "ms");
+}
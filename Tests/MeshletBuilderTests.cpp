@@ -0,0 +1,358 @@
+#include "TestFramework.h"
+
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<float> Positions;       // xyz per vertex.
+        std::vector<uint32_t> Indices;
+    };
+
+    // A UV sphere: curved everywhere, so the meshlets get cones of every width.
+    TestMesh MakeSphere(uint32_t rings, uint32_t segments)
+    {
+        TestMesh mesh;
+        for (uint32_t r = 0; r <= rings; ++r)
+        {
+            const float theta = 3.14159265f * r / rings;
+            for (uint32_t s = 0; s <= segments; ++s)
+            {
+                const float phi = 2.0f * 3.14159265f * s / segments;
+                mesh.Positions.push_back(std::sin(theta) * std::cos(phi));
+                mesh.Positions.push_back(std::cos(theta));
+                mesh.Positions.push_back(std::sin(theta) * std::sin(phi));
+            }
+        }
+        for (uint32_t r = 0; r < rings; ++r)
+        {
+            for (uint32_t s = 0; s < segments; ++s)
+            {
+                const uint32_t a = r * (segments + 1) + s;
+                const uint32_t b = a + segments + 1;
+                const uint32_t quad[6] = { a, a + 1, b, a + 1, b + 1, b };
+                mesh.Indices.insert(mesh.Indices.end(), quad, quad + 6);
+            }
+        }
+        return mesh;
+    }
+
+    // The triangles of the input, less the degenerate ones, each rotated to start at its smallest
+    // index so that two lists compare whatever corner a triangle starts from.
+    std::vector<std::array<uint32_t, 3>> CanonicalTriangles(const uint32_t* indices, size_t indexCount)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i < indexCount; i += 3)
+        {
+            std::array<uint32_t, 3> t = { indices[i], indices[i + 1], indices[i + 2] };
+            if (t[0] == t[1] || t[1] == t[2] || t[0] == t[2])
+            {
+                continue;
+            }
+            while (t[0] > t[1] || t[0] > t[2])
+            {
+                t = { t[1], t[2], t[0] };
+            }
+            triangles.push_back(t);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // The mesh indices the meshlets draw, in meshlet order.
+    std::vector<uint32_t> ExpandMeshlets(const MeshletMesh& mesh)
+    {
+        std::vector<uint32_t> indices;
+        for (const Meshlet& meshlet : mesh.Meshlets)
+        {
+            for (uint32_t p = 0; p < meshlet.PrimCount; ++p)
+            {
+                uint32_t local[3];
+                MeshletBuilder::UnpackTriangle(mesh.PrimitiveIndices[meshlet.PrimOffset + p], local[0], local[1], local[2]);
+                for (uint32_t k : local)
+                {
+                    indices.push_back(k < meshlet.VertCount ? mesh.UniqueVertexIndices[meshlet.VertOffset + k] : 0xFFFFFFFF);
+                }
+            }
+        }
+        return indices;
+    }
+
+    const float* Position(const TestMesh& mesh, uint32_t vertex)
+    {
+        return mesh.Positions.data() + vertex * 3;
+    }
+
+    float DecodeUnorm8(uint8_t value) { return value / 255.0f * 2.0f - 1.0f; }
+}
+
+TEST(MeshletBuilder, RejectsUnsupportedLimits)
+{
+    uint32_t threw = 0;
+    for (const std::array<uint32_t, 2>& limits : { std::array<uint32_t, 2>{ 2, 124 }, std::array<uint32_t, 2>{ 1025, 124 }, std::array<uint32_t, 2>{ 64, 0 } })
+    {
+        try
+        {
+            MeshletBuilder builder(limits[0], limits[1]);
+        }
+        catch (const std::invalid_argument&)
+        {
+            ++threw;
+        }
+    }
+    CHECK_EQUAL(3u, threw);
+
+    // The limits themselves are fine.
+    MeshletBuilder smallest(3, 1);
+    MeshletBuilder largest(1024, 1024);
+}
+
+TEST(MeshletBuilder, RejectsMalformedIndices)
+{
+    const float positions[9] = {};
+    const uint32_t indices[4] = { 0, 1, 2, 0 };
+    const uint32_t outOfRange[3] = { 0, 1, 3 };
+    MeshletBuilder builder;
+    MeshletMesh out;
+
+    bool threw = false;
+    try
+    {
+        builder.Build(indices, 4, positions, 3, 3 * sizeof(float), out);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+
+    threw = false;
+    try
+    {
+        builder.Build(outOfRange, 3, positions, 3, 3 * sizeof(float), out);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(MeshletBuilder, RespectsLimitsAndCoversEveryTriangle)
+{
+    TestMesh mesh = MakeSphere(40, 64);
+    // A few degenerate triangles, which are dropped.
+    const uint32_t degenerate[6] = { 5, 5, 6, 7, 8, 7 };
+    mesh.Indices.insert(mesh.Indices.begin() + 300, degenerate, degenerate + 6);
+    const std::vector<std::array<uint32_t, 3>> expected = CanonicalTriangles(mesh.Indices.data(), mesh.Indices.size());
+
+    const uint32_t limits[][2] = { { 64, 124 }, { 3, 1 }, { 32, 16 }, { 256, 256 }, { 1024, 2048 } };
+    for (const uint32_t* limit : limits)
+    {
+        MeshletBuilder builder(limit[0], limit[1]);
+        MeshletMesh out;
+        builder.Build(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), mesh.Positions.size() / 3, 3 * sizeof(float), out);
+        REQUIRE(out.CullData.size() == out.Meshlets.size());
+
+        // Within the limits, and the sections follow each other without gaps.
+        uint32_t vertexOffset = 0;
+        uint32_t primitiveOffset = 0;
+        bool withinLimits = true;
+        for (const Meshlet& meshlet : out.Meshlets)
+        {
+            withinLimits &= meshlet.VertCount >= 3 && meshlet.VertCount <= limit[0];
+            withinLimits &= meshlet.PrimCount >= 1 && meshlet.PrimCount <= limit[1];
+            withinLimits &= meshlet.VertOffset == vertexOffset && meshlet.PrimOffset == primitiveOffset;
+            vertexOffset += meshlet.VertCount;
+            primitiveOffset += meshlet.PrimCount;
+        }
+        CHECK(withinLimits);
+        CHECK_EQUAL(size_t(vertexOffset), out.UniqueVertexIndices.size());
+        CHECK_EQUAL(size_t(primitiveOffset), out.PrimitiveIndices.size());
+
+        // Every triangle exactly once, with its winding.
+        const std::vector<uint32_t> drawn = ExpandMeshlets(out);
+        CHECK(CanonicalTriangles(drawn.data(), drawn.size()) == expected);
+        CHECK_EQUAL(expected.size() * 3, drawn.size());
+    }
+}
+
+TEST(MeshletBuilder, BoundingSphereContainsVertices)
+{
+    const TestMesh mesh = MakeSphere(30, 50);
+    MeshletBuilder builder;
+    MeshletMesh out;
+    builder.Build(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), mesh.Positions.size() / 3, 3 * sizeof(float), out);
+
+    uint32_t outside = 0;
+    for (size_t m = 0; m < out.Meshlets.size(); ++m)
+    {
+        const float* sphere = out.CullData[m].BoundingSphere;
+        for (uint32_t i = 0; i < out.Meshlets[m].VertCount; ++i)
+        {
+            const float* p = Position(mesh, out.UniqueVertexIndices[out.Meshlets[m].VertOffset + i]);
+            const float distance = std::sqrt((p[0] - sphere[0]) * (p[0] - sphere[0]) + (p[1] - sphere[1]) * (p[1] - sphere[1]) + (p[2] - sphere[2]) * (p[2] - sphere[2]));
+            outside += distance <= sphere[3] * 1.0001f + 1e-6f ? 0 : 1;
+        }
+    }
+    CHECK_EQUAL(0u, outside);
+}
+
+TEST(MeshletBuilder, FlatPatchConeFacesItsNormal)
+{
+    // A grid in the z = 0 plane; with this winding the triangle normals point up +z.
+    TestMesh mesh;
+    const uint32_t size = 8;
+    for (uint32_t y = 0; y <= size; ++y)
+    {
+        for (uint32_t x = 0; x <= size; ++x)
+        {
+            mesh.Positions.insert(mesh.Positions.end(), { float(x), float(y), 0.0f });
+        }
+    }
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            const uint32_t a = y * (size + 1) + x;
+            mesh.Indices.insert(mesh.Indices.end(), { a, a + 1, a + size + 1, a + 1, a + size + 2, a + size + 1 });
+        }
+    }
+    MeshletBuilder builder;
+    MeshletMesh out;
+    builder.Build(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), mesh.Positions.size() / 3, 3 * sizeof(float), out);
+    REQUIRE(out.Meshlets.size() >= 1);
+
+    for (const MeshletCullData& cull : out.CullData)
+    {
+        CHECK(cull.NormalCone[3] != 255);
+        CHECK(std::fabs(DecodeUnorm8(cull.NormalCone[0])) < 0.01f);
+        CHECK(std::fabs(DecodeUnorm8(cull.NormalCone[1])) < 0.01f);
+        CHECK(DecodeUnorm8(cull.NormalCone[2]) > 0.99f);
+        // A single plane: the apex can stay at the center.
+        CHECK(std::fabs(cull.ApexOffset) < 1e-4f);
+    }
+}
+
+TEST(MeshletBuilder, ConeCullsOnlyBackFacingMeshlets)
+{
+    // The shader's test, from eyes all around: whenever it culls a meshlet, every triangle of the
+    // meshlet must face away from the eye. Quantizing the axis to 8 bits costs up to half a step,
+    // which the rounded up cutoff covers for all but grazing angles.
+    const TestMesh mesh = MakeSphere(96, 160);
+    MeshletBuilder builder(64, 124);
+    MeshletMesh out;
+    builder.Build(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), mesh.Positions.size() / 3, 3 * sizeof(float), out);
+
+    TestRandom random;
+    uint32_t culled = 0;
+    uint32_t wrong = 0;
+    uint32_t degenerate = 0;
+    for (size_t m = 0; m < out.Meshlets.size(); ++m)
+    {
+        const MeshletCullData& cull = out.CullData[m];
+        if (cull.NormalCone[3] == 255)
+        {
+            ++degenerate;
+            continue;
+        }
+        const float axis[3] = { DecodeUnorm8(cull.NormalCone[0]), DecodeUnorm8(cull.NormalCone[1]), DecodeUnorm8(cull.NormalCone[2]) };
+        const float cutoff = cull.NormalCone[3] / 255.0f;
+        float apex[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            apex[k] = cull.BoundingSphere[k] - axis[k] * cull.ApexOffset;
+        }
+
+        for (int e = 0; e < 200; ++e)
+        {
+            const float eye[3] = { random.NextBelow(1000) / 100.0f - 5.0f, random.NextBelow(1000) / 100.0f - 5.0f, random.NextBelow(1000) / 100.0f - 5.0f };
+            float toApex[3] = { apex[0] - eye[0], apex[1] - eye[1], apex[2] - eye[2] };
+            const float length = std::sqrt(toApex[0] * toApex[0] + toApex[1] * toApex[1] + toApex[2] * toApex[2]);
+            if ((toApex[0] * axis[0] + toApex[1] * axis[1] + toApex[2] * axis[2]) / length < cutoff)
+            {
+                continue;
+            }
+
+            ++culled;
+            const Meshlet& meshlet = out.Meshlets[m];
+            for (uint32_t p = 0; p < meshlet.PrimCount; ++p)
+            {
+                uint32_t local[3];
+                MeshletBuilder::UnpackTriangle(out.PrimitiveIndices[meshlet.PrimOffset + p], local[0], local[1], local[2]);
+                const float* p0 = Position(mesh, out.UniqueVertexIndices[meshlet.VertOffset + local[0]]);
+                const float* p1 = Position(mesh, out.UniqueVertexIndices[meshlet.VertOffset + local[1]]);
+                const float* p2 = Position(mesh, out.UniqueVertexIndices[meshlet.VertOffset + local[2]]);
+                const float u[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+                const float v[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+                const float n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+                const float toEye[3] = { eye[0] - p0[0], eye[1] - p0[1], eye[2] - p0[2] };
+                if (n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f)
+                {
+                    // The poles' zero area triangles face nowhere.
+                    continue;
+                }
+                const float facing = (n[0] * toEye[0] + n[1] * toEye[1] + n[2] * toEye[2]) /
+                    std::sqrt((n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * (toEye[0] * toEye[0] + toEye[1] * toEye[1] + toEye[2] * toEye[2]));
+                // The front side is the side the normal points to; culled triangles face away.
+                wrong += facing <= 0.02f ? 0 : 1;
+            }
+        }
+    }
+    CHECK_EQUAL(0u, wrong);
+    // The test culled something, and most meshlets of a sphere this fine have usable cones.
+    CHECK(culled > 1000);
+    CHECK(degenerate * 4 < out.Meshlets.size());
+}
+
+TEST(MeshletBuilder, PackedTrianglesRoundTrip)
+{
+    const uint32_t triangles[][3] = { { 0, 1, 2 }, { 1023, 0, 512 }, { 7, 1023, 1023 } };
+    for (const uint32_t* t : triangles)
+    {
+        uint32_t i0, i1, i2;
+        MeshletBuilder::UnpackTriangle(MeshletBuilder::PackTriangle(t[0], t[1], t[2]), i0, i1, i2);
+        CHECK_EQUAL(t[0], i0);
+        CHECK_EQUAL(t[1], i1);
+        CHECK_EQUAL(t[2], i2);
+    }
+}
+
+TEST(MeshletBuilder, SerializedBlobMatchesMesh)
+{
+    const TestMesh mesh = MakeSphere(20, 20);
+    MeshletBuilder builder;
+    MeshletMesh out;
+    builder.Build(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), mesh.Positions.size() / 3, 3 * sizeof(float), out);
+    const std::vector<uint8_t> blob = MeshletBuilder::Serialize(out);
+    REQUIRE(blob.size() >= sizeof(MeshletBlobHeader));
+
+    MeshletBlobHeader header;
+    memcpy(&header, blob.data(), sizeof(header));
+    CHECK_EQUAL(MeshletBuilder::BlobMagic, header.Magic);
+    CHECK_EQUAL(MeshletBuilder::BlobVersion, header.Version);
+    CHECK_EQUAL(size_t(header.TotalSize), blob.size());
+    CHECK_EQUAL(out.Meshlets.size(), size_t(header.MeshletCount));
+    CHECK_EQUAL(out.UniqueVertexIndices.size(), size_t(header.UniqueVertexIndexCount));
+    CHECK_EQUAL(out.PrimitiveIndices.size(), size_t(header.PrimitiveCount));
+
+    // Each section aligned for a structured buffer view of its element, and holding the mesh.
+    CHECK_EQUAL(0u, header.MeshletOffset % 16);
+    CHECK_EQUAL(0u, header.CullDataOffset % 16);
+    CHECK_EQUAL(0u, header.CullDataOffset % sizeof(MeshletCullData));
+    CHECK_EQUAL(0u, header.UniqueVertexIndexOffset % 16);
+    CHECK_EQUAL(0u, header.PrimitiveOffset % 16);
+    REQUIRE(header.PrimitiveOffset + header.PrimitiveCount * sizeof(uint32_t) <= blob.size());
+    CHECK(memcmp(blob.data() + header.MeshletOffset, out.Meshlets.data(), out.Meshlets.size() * sizeof(Meshlet)) == 0);
+    CHECK(memcmp(blob.data() + header.CullDataOffset, out.CullData.data(), out.CullData.size() * sizeof(MeshletCullData)) == 0);
+    CHECK(memcmp(blob.data() + header.UniqueVertexIndexOffset, out.UniqueVertexIndices.data(), out.UniqueVertexIndices.size() * sizeof(uint32_t)) == 0);
+    CHECK(memcmp(blob.data() + header.PrimitiveOffset, out.PrimitiveIndices.data(), out.PrimitiveIndices.size() * sizeof(uint32_t)) == 0);
+}
@@ -0,0 +1,54 @@
+#include "BenchmarkFramework.h"
+
+#include "MetricsRegistry.h"
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Nanoseconds per update with threadCount threads updating the same metric.
+    template <typename Update>
+    double NanosecondsPerUpdate(uint32_t threadCount, Update update)
+    {
+        const uint32_t updates = 2000000;
+        const double seconds = BestSeconds(3, [&]()
+        {
+            std::vector<std::thread> threads;
+            for (uint32_t t = 0; t < threadCount; ++t)
+            {
+                threads.emplace_back([&]()
+                {
+                    for (uint32_t i = 0; i < updates; ++i)
+                    {
+                        update(i);
+                    }
+                });
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+        });
+        return seconds * 1e9 / updates;
+    }
+}
+
+BENCHMARK(MetricsRegistry, Update)
+{
+    MetricsRegistry registry;
+    MetricCounter* counter = registry.GetCounter("counter");
+    MetricHistogram* histogram = registry.GetHistogram("histogram");
+    const uint32_t threadCount = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() : 2;
+
+    Report("Counter add, 1 thread", NanosecondsPerUpdate(1, [&](uint32_t) { counter->Add(); }), "ns/record");
+    Report("Histogram record, 1 thread", NanosecondsPerUpdate(1, [&](uint32_t i) { histogram->Record(i * 2654435761u); }), "ns/record");
+    Report("Counter add, all threads", NanosecondsPerUpdate(threadCount, [&](uint32_t) { counter->Add(); }), "ns/record");
+    Report("Histogram record, all threads", NanosecondsPerUpdate(threadCount, [&](uint32_t i) { histogram->Record(i * 2654435761u); }), "ns/record");
+
+    for (int i = 0; i < 100; ++i)
+    {
+        registry.GetHistogram("histogram" + std::to_string(i))->Record(i);
+    }
+    Report("Snapshot, 101 histograms", BestSeconds(10, [&]() { registry.Snapshot(); }) * 1e6, "us");
+}
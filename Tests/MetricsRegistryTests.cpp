@@ -0,0 +1,207 @@
+#include "TestFramework.h"
+
+#include "MetricsRegistry.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(MetricsRegistry, BucketsCoverEveryValue)
+{
+    // Each value falls in its bucket's range, the buckets tile the range without gaps, and a
+    // bucket is never wider than 1/32 of its lower bound.
+    for (uint32_t bucket = 1; bucket < MetricHistogram::BucketCount; ++bucket)
+    {
+        const uint64_t previousEnd = MetricHistogram::GetBucketLowerBound(bucket - 1) + MetricHistogram::GetBucketWidth(bucket - 1);
+        CHECK_EQUAL(previousEnd, MetricHistogram::GetBucketLowerBound(bucket));
+    }
+    const uint32_t last = MetricHistogram::BucketCount - 1;
+    CHECK_EQUAL(~uint64_t(0), MetricHistogram::GetBucketLowerBound(last) + (MetricHistogram::GetBucketWidth(last) - 1));
+
+    TestRandom random;
+    bool inBucket = true;
+    bool precise = true;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const uint64_t value = random.Next() >> random.NextBelow(64);
+        const uint32_t bucket = MetricHistogram::GetBucketIndex(value);
+        const uint64_t lower = MetricHistogram::GetBucketLowerBound(bucket);
+        const uint64_t width = MetricHistogram::GetBucketWidth(bucket);
+        inBucket &= bucket < MetricHistogram::BucketCount && value >= lower && value - lower < width;
+        precise &= width == 1 || width <= lower / MetricHistogram::SubBucketCount;
+    }
+    CHECK(inBucket);
+    CHECK(precise);
+    CHECK_EQUAL(0u, MetricHistogram::GetBucketIndex(0));
+    CHECK_EQUAL(31u, MetricHistogram::GetBucketIndex(31));
+    CHECK_EQUAL(last, MetricHistogram::GetBucketIndex(~uint64_t(0)));
+}
+
+TEST(MetricsRegistry, HistogramPercentiles)
+{
+    // 1..10000 microseconds: every percentile within half a bucket (1/64) of the exact one.
+    MetricsRegistry registry;
+    MetricHistogram* histogram = registry.GetHistogram("frame_us");
+    for (uint64_t value = 1; value <= 10000; ++value)
+    {
+        histogram->Record(value);
+    }
+    const MetricsSnapshot snapshot = registry.Snapshot();
+    const HistogramSummary* summary = snapshot.FindHistogram("frame_us");
+    REQUIRE(summary != nullptr);
+    CHECK_EQUAL(uint64_t(10000), summary->Count);
+    CHECK_EQUAL(5000.5, summary->Mean);
+    auto near = [](uint64_t value, double expected) { return value >= expected * (1 - 1.0 / 64) && value <= expected * (1 + 1.0 / 64); };
+    CHECK(near(summary->P50, 5000));
+    CHECK(near(summary->P95, 9500));
+    CHECK(near(summary->P99, 9900));
+    // Max is the top of its bucket: never below the real one, at most a bucket (1/32) above.
+    CHECK(summary->Max >= 10000 && summary->Max <= 10000 + 10000 / 32);
+    CHECK(snapshot.FindHistogram("missing") == nullptr);
+
+    // Small values are exact.
+    MetricHistogram* small = registry.GetHistogram("small");
+    for (uint64_t value : { 3, 3, 3, 7, 20 })
+    {
+        small->Record(value);
+    }
+    const HistogramSummary* smallSummary = registry.Snapshot().FindHistogram("small");
+    REQUIRE(smallSummary != nullptr);
+    CHECK_EQUAL(uint64_t(3), smallSummary->P50);
+    CHECK_EQUAL(uint64_t(20), smallSummary->P99);
+    CHECK_EQUAL(uint64_t(20), smallSummary->Max);
+}
+
+TEST(MetricsRegistry, SnapshotsCoverTheInterval)
+{
+    MetricsRegistry registry;
+    MetricCounter* draws = registry.GetCounter("draws");
+    MetricGauge* memory = registry.GetGauge("memory");
+    MetricHistogram* latency = registry.GetHistogram("latency");
+    CHECK(registry.GetCounter("draws") == draws);
+    CHECK(registry.GetGauge("memory") == memory);
+    CHECK(registry.GetHistogram("latency") == latency);
+
+    draws->Add(10);
+    memory->Set(100);
+    for (int i = 0; i < 100; ++i)
+    {
+        latency->Record(1000);
+    }
+    const MetricsSnapshot first = registry.Snapshot();
+    REQUIRE(first.Counters.size() == 1 && first.Gauges.size() == 1 && first.Histograms.size() == 1);
+    CHECK_EQUAL(uint64_t(10), first.Counters[0].Total);
+    CHECK_EQUAL(int64_t(100), first.Gauges[0].Value);
+    CHECK_EQUAL(uint64_t(100), first.Histograms[0].Count);
+
+    // The second snapshot only sees what happened since the first; counters keep their totals.
+    draws->Add(5);
+    memory->Add(-40);
+    latency->Record(10);
+    const MetricsSnapshot second = registry.Snapshot();
+    CHECK_EQUAL(uint64_t(15), second.Counters[0].Total);
+    CHECK_EQUAL(int64_t(60), second.Gauges[0].Value);
+    CHECK_EQUAL(uint64_t(1), second.Histograms[0].Count);
+    CHECK_EQUAL(10.0, second.Histograms[0].Mean);
+    CHECK_EQUAL(uint64_t(10), second.Histograms[0].Max);
+    CHECK(second.Seconds >= first.Seconds);
+    CHECK(second.IntervalSeconds <= second.Seconds);
+    CHECK(second.Counters[0].PerSecond >= 0.0);
+
+    const MetricsSnapshot idle = registry.Snapshot();
+    CHECK_EQUAL(uint64_t(0), idle.Histograms[0].Count);
+    CHECK_EQUAL(0.0, idle.Histograms[0].Mean);
+}
+
+TEST(MetricsRegistry, ConcurrentUpdates)
+{
+    // Threads update and register while the main thread takes snapshots: nothing is lost.
+    MetricsRegistry registry;
+    MetricCounter* counter = registry.GetCounter("events");
+    MetricHistogram* histogram = registry.GetHistogram("values");
+    const uint32_t ThreadCount = 4;
+    const uint32_t UpdatesPerThread = 100000;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            MetricGauge* gauge = registry.GetGauge("thread" + std::to_string(t));
+            for (uint32_t i = 0; i < UpdatesPerThread; ++i)
+            {
+                counter->Add();
+                histogram->Record(i);
+                gauge->Add(1);
+            }
+        });
+    }
+    uint64_t histogramCount = 0;
+    for (int i = 0; i < 20; ++i)
+    {
+        histogramCount += registry.Snapshot().FindHistogram("values")->Count;
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    const MetricsSnapshot snapshot = registry.Snapshot();
+    histogramCount += snapshot.FindHistogram("values")->Count;
+
+    CHECK_EQUAL(uint64_t(ThreadCount) * UpdatesPerThread, snapshot.Counters[0].Total);
+    CHECK_EQUAL(uint64_t(ThreadCount) * UpdatesPerThread, histogramCount);
+    CHECK_EQUAL(size_t(ThreadCount), snapshot.Gauges.size());
+    for (const MetricsSnapshot::GaugeValue& gauge : snapshot.Gauges)
+    {
+        CHECK_EQUAL(int64_t(UpdatesPerThread), gauge.Value);
+    }
+}
+
+TEST(MetricsRegistry, JsonLines)
+{
+    MetricsSnapshot snapshot;
+    snapshot.Seconds = 2.5;
+    snapshot.IntervalSeconds = 0.5;
+    snapshot.Counters.push_back({ "draws", 1200, 400 });
+    snapshot.Gauges.push_back({ "gpu \"local\" bytes", -3 });
+    snapshot.Histograms.push_back({ "frame_us", 30, 16666.5, 16600, 17000, 20000, 21000 });
+
+    std::ostringstream line;
+    snapshot.WriteJson(line);
+    CHECK_EQUAL(std::string(
+        "{\"seconds\":2.5,\"interval\":0.5,\"counters\":{\"draws\":{\"total\":1200,\"rate\":400}},"
+        "\"gauges\":{\"gpu \\\"local\\\" bytes\":-3},"
+        "\"histograms\":{\"frame_us\":{\"count\":30,\"mean\":16666.5,\"p50\":16600,\"p95\":17000,\"p99\":20000,\"max\":21000}}}\n"), line.str());
+
+    // The exporter appends one line per snapshot.
+    const char* path = "MetricsRegistryTests.jsonl";
+    std::remove(path);
+    {
+        MetricsExporter exporter;
+        CHECK(!exporter.IsOpen());
+        exporter.OpenFile(path);
+        CHECK(exporter.IsOpen());
+        exporter.Export(snapshot);
+        exporter.Export(snapshot);
+    }
+    std::ifstream file(path);
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(path);
+    CHECK_EQUAL(line.str() + line.str(), text);
+
+    bool threw = false;
+    try
+    {
+        MetricsExporter exporter;
+        exporter.OpenUdp(9000, "not an address");
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
@@ -0,0 +1,65 @@
+#include "BenchmarkFramework.h"
+#include "TestFramework.h"
+
+#include "OcclusionCuller.h"
+#include "ThreadPool.h"
+
+#include <vector>
+
+BENCHMARK(OcclusionCuller, Rasterize)
+{
+    // 3000 small triangles scattered in front of a 45 degree camera.
+    TestRandom random;
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < 3000; ++i)
+    {
+        const float x = random.NextBelow(400) / 10.0f - 20;
+        const float y = random.NextBelow(200) / 10.0f - 10;
+        const float z = 5 + random.NextBelow(500) / 10.0f;
+        for (int v = 0; v < 3; ++v)
+        {
+            positions.push_back(x + random.NextBelow(40) / 10.0f);
+            positions.push_back(y + random.NextBelow(40) / 10.0f);
+            positions.push_back(z);
+            indices.push_back(static_cast<uint32_t>(indices.size()));
+        }
+    }
+    OccluderMesh mesh = { positions.data(), 3 * sizeof(float), static_cast<uint32_t>(indices.size()), indices.data(), static_cast<uint32_t>(indices.size()), {} };
+    mesh.World[0] = mesh.World[5] = mesh.World[10] = mesh.World[15] = 1.0f;
+    float viewProjection[16] = {};
+    viewProjection[0] = 2.41421356f * 192 / 320;
+    viewProjection[5] = 2.41421356f;
+    viewProjection[10] = 100.0f / 99.9f;
+    viewProjection[11] = 1.0f;
+    viewProjection[14] = -10.0f / 99.9f;
+
+    OcclusionCuller single(320, 192);
+    single.AddOccluder(mesh);
+    Report("Rasterize 3000 triangles, 1 thread", BestSeconds(20, [&]() { single.Rasterize(viewProjection); }) * 1e3, "ms");
+
+    ThreadPool pool;
+    OcclusionCuller pooled(320, 192, &pool);
+    pooled.AddOccluder(mesh);
+    Report("Rasterize 3000 triangles, pool", BestSeconds(20, [&]() { pooled.Rasterize(viewProjection); }) * 1e3, "ms");
+
+    // Boxes tested against the buffer.
+    std::vector<float> centers;
+    std::vector<float> extents;
+    std::vector<uint32_t> objects;
+    for (uint32_t i = 0; i < 100000; ++i)
+    {
+        centers.insert(centers.end(), { random.NextBelow(400) / 10.0f - 20, random.NextBelow(200) / 10.0f - 10, 5 + random.NextBelow(600) / 10.0f });
+        extents.insert(extents.end(), { 0.5f, 0.5f, 0.5f });
+    }
+    const double seconds = BestSeconds(10, [&]()
+    {
+        objects.resize(100000);
+        for (uint32_t i = 0; i < 100000; ++i)
+        {
+            objects[i] = i;
+        }
+        pooled.FilterVisible(objects, centers.data(), extents.data(), 3 * sizeof(float));
+    });
+    Report("Test 100K boxes", 100000 / seconds / 1e6, "M boxes/s");
+}
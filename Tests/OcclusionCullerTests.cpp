@@ -0,0 +1,283 @@
+#include "TestFramework.h"
+
+#include "OcclusionCuller.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const uint32_t Width = 320;
+    const uint32_t Height = 192;
+    const float Near = 0.1f;
+    const float Far = 100.0f;
+    // 1 / tan(22.5 degrees): a 45 degree vertical field of view.
+    const float Focal = 1.0f / 0.41421356f;
+    const float Aspect = float(Width) / float(Height);
+
+    // Left-handed perspective, row vectors, camera at the origin looking down +z: clip z/w is
+    // Depth(z) for a point at view depth z.
+    void MakeViewProjection(float m[16])
+    {
+        memset(m, 0, 16 * sizeof(float));
+        m[0] = Focal / Aspect;
+        m[5] = Focal;
+        m[10] = Far / (Far - Near);
+        m[11] = 1.0f;
+        m[14] = -Near * Far / (Far - Near);
+    }
+
+    double Depth(double z)
+    {
+        return Far / (Far - Near) - Near * Far / (Far - Near) / z;
+    }
+
+    // The x of a column's pixel centers in normalized device coordinates.
+    double PixelNdcX(uint32_t x) { return (x + 0.5) / Width * 2.0 - 1.0; }
+
+    // The point of view depth z seen at a screen position, in pixels.
+    void Unproject(float screenX, float screenY, float z, float* position)
+    {
+        const float ndcX = screenX / Width * 2.0f - 1.0f;
+        const float ndcY = 1.0f - screenY / Height * 2.0f;
+        position[0] = ndcX * z * Aspect / Focal;
+        position[1] = ndcY * z / Focal;
+        position[2] = z;
+    }
+
+    // Quads and triangles over caller-owned arrays, with an identity world matrix.
+    OccluderMesh MakeMesh(const float* positions, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+    {
+        OccluderMesh mesh = { positions, 3 * sizeof(float), vertexCount, indices, indexCount, {} };
+        mesh.World[0] = mesh.World[5] = mesh.World[10] = mesh.World[15] = 1.0f;
+        return mesh;
+    }
+
+    const uint32_t QuadIndices[] = { 0, 1, 2, 0, 2, 3 };
+}
+
+TEST(OcclusionCuller, EmptyBufferIsFar)
+{
+    OcclusionCuller culler(Width, Height);
+    float viewProjection[16];
+    MakeViewProjection(viewProjection);
+    culler.Rasterize(viewProjection);
+
+    bool far = true;
+    for (uint32_t i = 0; i < Width * Height; ++i)
+    {
+        far &= culler.GetDepthBuffer()[i] == 1.0f;
+    }
+    CHECK(far);
+    const float center[3] = { 0, 0, 10 };
+    const float extents[3] = { 1, 1, 1 };
+    CHECK(culler.IsVisible(center, extents));
+}
+
+TEST(OcclusionCuller, GoldenDepthOfFacingWall)
+{
+    // A wall at z = 5 wider than the view: every pixel is at Depth(5).
+    const float positions[] = { -10, -10, 5, 10, -10, 5, 10, 10, 5, -10, 10, 5 };
+    OcclusionCuller culler(Width, Height);
+    culler.AddOccluder(MakeMesh(positions, 4, QuadIndices, 6));
+    float viewProjection[16];
+    MakeViewProjection(viewProjection);
+    culler.Rasterize(viewProjection);
+
+    const double expected = Depth(5.0);
+    double maxError = 0.0;
+    for (uint32_t i = 0; i < Width * Height; ++i)
+    {
+        maxError = std::max(maxError, std::fabs(culler.GetDepthBuffer()[i] - expected));
+    }
+    CHECK(maxError < 1e-6);
+}
+
+TEST(OcclusionCuller, GoldenDepthOfSlantedPlane)
+{
+    // The plane z = 5 + x / 2, seen through pixel center (nx, ny) in NDC, is at view depth
+    // z = 5 / (1 - nx * Aspect / (2 * Focal)): depth varies across the screen, non-linearly in
+    // z but linearly in screen space, which the rasterizer's plane equation has to reproduce.
+    const float positions[] = { -6, -8, 2, 6, -8, 8, 6, 8, 8, -6, 8, 2 };
+    OcclusionCuller culler(Width, Height);
+    culler.AddOccluder(MakeMesh(positions, 4, QuadIndices, 6));
+    float viewProjection[16];
+    MakeViewProjection(viewProjection);
+    culler.Rasterize(viewProjection);
+
+    double maxError = 0.0;
+    for (uint32_t y = 0; y < Height; ++y)
+    {
+        for (uint32_t x = 0; x < Width; ++x)
+        {
+            const double z = 5.0 / (1.0 - PixelNdcX(x) * Aspect / (2.0 * Focal));
+            maxError = std::max(maxError, std::fabs(culler.GetDepthBuffer()[y * Width + x] - Depth(z)));
+        }
+    }
+    CHECK(maxError < 2e-6);
+    // Depth grows to the right, where the plane recedes.
+    CHECK(culler.GetDepthBuffer()[Height / 2 * Width] < culler.GetDepthBuffer()[Height / 2 * Width + Width - 1]);
+}
+
+TEST(OcclusionCuller, GoldenCoverageOfTriangle)
+{
+    // A triangle given in pixels at z = 10. Pixel centers clearly inside get Depth(10), those
+    // clearly outside stay empty; centers within a hair of an edge depend on the fill rule and
+    // are not checked.
+    const float screen[3][2] = { { 37.2f, 20.7f }, { 290.6f, 71.3f }, { 101.9f, 180.4f } };
+    float positions[9];
+    for (int v = 0; v < 3; ++v)
+    {
+        Unproject(screen[v][0], screen[v][1], 10.0f, positions + v * 3);
+    }
+    const uint32_t indices[] = { 0, 1, 2 };
+    OcclusionCuller culler(Width, Height);
+    culler.AddOccluder(MakeMesh(positions, 3, indices, 3));
+    float viewProjection[16];
+    MakeViewProjection(viewProjection);
+    culler.Rasterize(viewProjection);
+
+    const double expected = Depth(10.0);
+    uint32_t wrong = 0;
+    uint32_t covered = 0;
+    for (uint32_t y = 0; y < Height; ++y)
+    {
+        for (uint32_t x = 0; x < Width; ++x)
+        {
+            // Signed distances of the pixel center to the edges, in pixels.
+            const double px = x + 0.5;
+            const double py = y + 0.5;
+            double nearest = 1e9;
+            bool inside = true;
+            for (int e = 0; e < 3; ++e)
+            {
+                const float* a = screen[e];
+                const float* b = screen[(e + 1) % 3];
+                const double cross = (b[0] - a[0]) * (py - a[1]) - (b[1] - a[1]) * (px - a[0]);
+                const double distance = cross / std::hypot(b[0] - a[0], b[1] - a[1]);
+                // The vertices are clockwise on screen (y down): inside is positive.
+                inside &= distance > 0.0;
+                nearest = std::min(nearest, std::fabs(distance));
+            }
+            if (nearest < 1e-3)
+            {
+                continue;
+            }
+            const float depth = culler.GetDepthBuffer()[y * Width + x];
+            if (inside)
+            {
+                ++covered;
+                wrong += std::fabs(depth - expected) < 1e-6 ? 0 : 1;
+            }
+            else
+            {
+                wrong += depth == 1.0f ? 0 : 1;
+            }
+        }
+    }
+    CHECK_EQUAL(0u, wrong);
+    CHECK(covered > 10000);
+}
+
+TEST(OcclusionCuller, NearestOccluderWins)
+{
+    // A far wall and a nearer one over the left half of the screen, added far first.
+    const float farWall[] = { -30, -30, 20, 30, -30, 20, 30, 30, 20, -30, 30, 20 };
+    const float nearWall[] = { -10, -10, 4, 0, -10, 4, 0, 10, 4, -10, 10, 4 };
+    OcclusionCuller culler(Width, Height);
+    culler.AddOccluder(MakeMesh(farWall, 4, QuadIndices, 6));
+    culler.AddOccluder(MakeMesh(nearWall, 4, QuadIndices, 6));
+    float viewProjection[16];
+    MakeViewProjection(viewProjection);
+    culler.Rasterize(viewProjection);
+
+    const float* depth = culler.GetDepthBuffer();
+    for (uint32_t y = 0; y < Height; y += 17)
+    {
+        CHECK(std::fabs(depth[y * Width + 10] - Depth(4.0)) < 1e-6);
+        CHECK(std::fabs(depth[y * Width + Width - 10] - Depth(20.0)) < 1e-6);
+    }
+}
+
+TEST(OcclusionCuller, PoolMatchesSingleThread)
+{
+    // Many overlapping triangles across tiles: the pooled tiles must match, bit for bit.
+    TestRandom random;
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < 300; ++i)
+    {
+        const float z = 3.0f + random.NextBelow(1000) / 50.0f;
+        for (int v = 0; v < 3; ++v)
+        {
+            float position[3];
+            Unproject(float(random.NextBelow(Width + 100)) - 50, float(random.NextBelow(Height + 100)) - 50, z + random.NextBelow(100) / 20.0f, position);
+            positions.insert(positions.end(), position, position + 3);
+            indices.push_back(static_cast<uint32_t>(indices.size()));
+        }
+    }
+    const OccluderMesh mesh = MakeMesh(positions.data(), static_cast<uint32_t>(indices.size()), indices.data(), static_cast<uint32_t>(indices.size()));
+    float viewProjection[16];
+    MakeViewProjection(viewProjection);
+
+    OcclusionCuller single(Width, Height);
+    single.AddOccluder(mesh);
+    single.Rasterize(viewProjection);
+
+    ThreadPool pool(3);
+    OcclusionCuller pooled(Width, Height, &pool);
+    pooled.AddOccluder(mesh);
+    pooled.BeginFrame(viewProjection);
+    pooled.EndFrame(viewProjection);
+
+    CHECK(memcmp(single.GetDepthBuffer(), pooled.GetDepthBuffer(), Width * Height * sizeof(float)) == 0);
+}
+
+TEST(OcclusionCuller, BoxVisibility)
+{
+    // A 10x10 wall at z = 5 in front of the camera.
+    const float positions[] = { -5, -5, 5, 5, -5, 5, 5, 5, 5, -5, 5, 5 };
+    ThreadPool pool(2);
+    OcclusionCuller culler(Width, Height, &pool);
+    culler.AddOccluder(MakeMesh(positions, 4, QuadIndices, 6));
+    float viewProjection[16];
+    MakeViewProjection(viewProjection);
+    culler.Rasterize(viewProjection);
+
+    const float extents[3] = { 1, 1, 1 };
+    const float behind[3] = { 0, 0, 10 };
+    const float inFront[3] = { 0, 0, 3 };
+    const float beside[3] = { 20, 0, 10 };
+    const float straddling[3] = { 0, 0, 5 };
+    const float atNearPlane[3] = { 0, 0, 0.5f };
+    CHECK(!culler.IsVisible(behind, extents));
+    CHECK(culler.IsVisible(inFront, extents));
+    CHECK(culler.IsVisible(beside, extents));
+    CHECK(culler.IsVisible(straddling, extents));
+    CHECK(culler.IsVisible(atNearPlane, extents));
+
+    // FilterVisible agrees with IsVisible, object by object, and keeps the order.
+    std::vector<float> centers;
+    std::vector<float> boxExtents;
+    std::vector<uint32_t> objects;
+    std::vector<uint32_t> expected;
+    TestRandom random;
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        const float center[3] = { random.NextBelow(400) / 20.0f - 10, random.NextBelow(400) / 20.0f - 10, 1 + random.NextBelow(400) / 20.0f };
+        const float extent[3] = { 0.1f + random.NextBelow(20) / 10.0f, 0.1f + random.NextBelow(20) / 10.0f, 0.1f + random.NextBelow(20) / 10.0f };
+        centers.insert(centers.end(), center, center + 3);
+        boxExtents.insert(boxExtents.end(), extent, extent + 3);
+        objects.push_back(i);
+        if (culler.IsVisible(center, extent))
+        {
+            expected.push_back(i);
+        }
+    }
+    culler.FilterVisible(objects, centers.data(), boxExtents.data(), 3 * sizeof(float));
+    CHECK(objects == expected);
+    CHECK(expected.size() < 5000);
+}
@@ -0,0 +1,243 @@
+#include "TestFramework.h"
+
+#include "PipelineCompiler.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Simulated pipelines: non-null pointers into this array, one per key.
+    int g_pipelines[1024];
+    std::atomic<uint32_t> g_released(0);
+
+    void ReleasePipeline(void* pipeline)
+    {
+        CHECK(pipeline >= static_cast<void*>(g_pipelines) && pipeline < static_cast<void*>(g_pipelines + 1024));
+        ++g_released;
+    }
+
+    void WaitUntilIdle(const PipelineCompiler& compiler)
+    {
+        while (compiler.GetPendingCount() != 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+TEST(PipelineCompiler, CompilesSoonestFirst)
+{
+    // One compiler thread, held on a first compile while the others queue up in a random order.
+    ThreadPool pool(1);
+    std::atomic<bool> gate(false);
+    std::mutex orderMutex;
+    std::vector<uint64_t> order;
+    {
+        PipelineCompiler compiler(pool, &ReleasePipeline, 1);
+        compiler.Request(1000, 0, [&]()
+        {
+            while (!gate)
+            {
+                std::this_thread::yield();
+            }
+            return static_cast<void*>(&g_pipelines[0]);
+        });
+        while (compiler.GetStatus(1) != PipelineStatus::Compiling)
+        {
+            std::this_thread::yield();
+        }
+
+        TestRandom random;
+        std::vector<PipelineHandle> handles;
+        std::vector<uint64_t> firstUses;
+        for (uint64_t key = 1; key <= 100; ++key)
+        {
+            const uint64_t firstUse = 1 + random.NextBelow(20);
+            firstUses.push_back(firstUse);
+            handles.push_back(compiler.Request(key, firstUse, [&, key]()
+            {
+                std::lock_guard<std::mutex> lock(orderMutex);
+                order.push_back(key);
+                return static_cast<void*>(&g_pipelines[key]);
+            }));
+            CHECK(compiler.GetStatus(handles.back()) == PipelineStatus::Queued);
+        }
+        CHECK_EQUAL(size_t(101), compiler.GetPendingCount());
+
+        // Asked for now: key 77 goes first. A request moving key 50 earlier, to use 0 as well,
+        // puts it right behind.
+        CHECK(compiler.TryGet(handles[76]) == nullptr);
+        bool merged = false;
+        CHECK_EQUAL(handles[49], compiler.Request(50, 0, []() { return static_cast<void*>(nullptr); }, &merged));
+        CHECK(merged);
+        firstUses[76] = 0;
+        firstUses[49] = 0;
+
+        gate = true;
+        WaitUntilIdle(compiler);
+
+        // Soonest first use first, in request order for the same first use; key 77 was moved to
+        // the front before key 50.
+        std::vector<uint64_t> expected;
+        for (uint64_t firstUse = 0; firstUse <= 20; ++firstUse)
+        {
+            for (uint64_t key = 1; key <= 100; ++key)
+            {
+                if (firstUses[key - 1] == firstUse)
+                {
+                    expected.push_back(key);
+                }
+            }
+        }
+        std::swap(expected[0], expected[1]);
+        CHECK(order == expected);
+        CHECK(compiler.TryGet(handles[76]) == &g_pipelines[77]);
+
+        const PipelineCompilerStats stats = compiler.GetStats();
+        CHECK_EQUAL(uint64_t(102), stats.Requests);
+        CHECK_EQUAL(uint64_t(1), stats.Merged);
+        CHECK_EQUAL(uint64_t(101), stats.Compiled);
+        CHECK_EQUAL(uint64_t(1), stats.NotReady);
+        CHECK(stats.MaxCompileNanoseconds <= stats.CompileNanoseconds);
+        g_released = 0;
+    }
+    // Every compiled pipeline released once.
+    CHECK_EQUAL(101u, g_released.load());
+}
+
+TEST(PipelineCompiler, DuplicateRequestsCompileOnce)
+{
+    // Threads request overlapping sets of keys at once: one compile per key, one handle per key.
+    ThreadPool pool(3);
+    std::atomic<uint32_t> compiles[64];
+    for (std::atomic<uint32_t>& count : compiles)
+    {
+        count = 0;
+    }
+    PipelineCompiler compiler(pool, &ReleasePipeline);
+    std::vector<std::vector<PipelineHandle>> handles(4, std::vector<PipelineHandle>(64));
+    std::atomic<uint32_t> merged(0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (uint32_t i = 0; i < 64; ++i)
+            {
+                const uint32_t key = (i + t * 16) % 64;
+                bool wasMerged = false;
+                handles[t][key] = compiler.Request(0xABCD0000ull + key, i, [&, key]()
+                {
+                    ++compiles[key];
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    return static_cast<void*>(&g_pipelines[key]);
+                }, &wasMerged);
+                merged += wasMerged ? 1 : 0;
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    compiler.WaitAll();
+
+    bool once = true;
+    bool sameHandle = true;
+    for (uint32_t key = 0; key < 64; ++key)
+    {
+        once &= compiles[key] == 1;
+        for (uint32_t t = 1; t < 4; ++t)
+        {
+            sameHandle &= handles[t][key] == handles[0][key];
+        }
+        once &= compiler.Wait(handles[0][key]) == &g_pipelines[key];
+    }
+    CHECK(once);
+    CHECK(sameHandle);
+    CHECK_EQUAL(192u, merged.load());
+    CHECK_EQUAL(uint64_t(64), compiler.GetStats().Compiled);
+    CHECK_EQUAL(uint64_t(192), compiler.GetStats().Merged);
+}
+
+TEST(PipelineCompiler, RespectsConcurrencyLimit)
+{
+    ThreadPool pool(4);
+    std::atomic<uint32_t> running(0);
+    std::atomic<uint32_t> maxRunning(0);
+    PipelineCompiler compiler(pool, &ReleasePipeline, 2);
+    for (uint64_t key = 0; key < 40; ++key)
+    {
+        compiler.Request(key, key, [&, key]()
+        {
+            const uint32_t now = ++running;
+            uint32_t seen = maxRunning;
+            while (now > seen && !maxRunning.compare_exchange_weak(seen, now))
+            {
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            --running;
+            return static_cast<void*>(&g_pipelines[key]);
+        });
+    }
+    WaitUntilIdle(compiler);
+    CHECK(maxRunning.load() <= 2);
+    CHECK_EQUAL(uint64_t(40), compiler.GetStats().Compiled);
+}
+
+TEST(PipelineCompiler, FailuresAndInlineCompiles)
+{
+    // Without workers, requests compile on the calling thread before Request returns.
+    ThreadPool pool(0);
+    PipelineCompiler compiler(pool, &ReleasePipeline);
+    const PipelineHandle good = compiler.Request(1, 0, []() { return static_cast<void*>(&g_pipelines[1]); });
+    CHECK(compiler.GetStatus(good) == PipelineStatus::Ready);
+    CHECK(compiler.TryGet(good) == &g_pipelines[1]);
+
+    const PipelineHandle throwing = compiler.Request(2, 0, []() -> void* { throw std::runtime_error("bad shader"); });
+    const PipelineHandle empty = compiler.Request(3, 0, []() -> void* { return nullptr; });
+    CHECK(compiler.GetStatus(throwing) == PipelineStatus::Failed);
+    CHECK(compiler.GetStatus(empty) == PipelineStatus::Failed);
+    CHECK(compiler.TryGet(throwing) == nullptr);
+
+    std::string message;
+    try
+    {
+        compiler.Wait(throwing);
+    }
+    catch (const std::runtime_error& error)
+    {
+        message = error.what();
+    }
+    CHECK_EQUAL(std::string("bad shader"), message);
+    bool threw = false;
+    try
+    {
+        compiler.Wait(empty);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK_EQUAL(uint64_t(2), compiler.GetStats().Failed);
+
+    threw = false;
+    try
+    {
+        compiler.GetStatus(InvalidPipeline);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
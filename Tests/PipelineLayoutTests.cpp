@@ -0,0 +1,169 @@
+#include "TestFramework.h"
+
+#include "PipelineLayout.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    // The sample's scene root signature: a table of one SRV, a root CBV and a static sampler.
+    constexpr auto SceneLayout = MakeRootSignature(RootSignatureAllowInputLayout,
+        std::array<RootParameterLayout, 2>{ {
+            DescriptorTable(ShaderVisibility::Pixel, SrvRange(1, 0, 0, RangeDataStatic)),
+            RootDescriptor(RootParameterType::Cbv, 0, 0, RootDataStaticWhileSetAtExecute, ShaderVisibility::Vertex) } },
+        std::array<StaticSamplerLayout, 1>{ { StaticSampler(0, SamplerFilter::Point, AddressMode::Border, 0, ShaderVisibility::Pixel) } });
+    constexpr auto SceneBlob = SerializeRootSignature(SceneLayout);
+
+    // The same with the constants of the upscale pass instead of the CBV.
+    constexpr auto ConstantsLayout = MakeRootSignature(RootSignatureAllowInputLayout,
+        std::array<RootParameterLayout, 2>{ {
+            DescriptorTable(ShaderVisibility::Pixel, SrvRange(1, 0, 0, RangeDataStatic)),
+            RootConstants(4, 1, 0, ShaderVisibility::Pixel) } },
+        std::array<StaticSamplerLayout, 1>{ { StaticSampler(0, SamplerFilter::Point, AddressMode::Border, 0, ShaderVisibility::Pixel) } });
+
+    constexpr auto VertexLayout = MakeInputLayout(20, std::array<InputElementLayout, 2>{ {
+        { "POSITION", 0, LayoutFormat::R32G32B32Float, 0, 0 },
+        { "TEXCOORD", 0, LayoutFormat::R32G32Float, 0, 12 } } });
+
+    constexpr uint32_t Read32(const uint8_t* bytes, size_t offset)
+    {
+        return static_cast<uint32_t>(bytes[offset]) | static_cast<uint32_t>(bytes[offset + 1]) << 8 |
+            static_cast<uint32_t>(bytes[offset + 2]) << 16 | static_cast<uint32_t>(bytes[offset + 3]) << 24;
+    }
+
+    constexpr std::array<uint32_t, 4> Md5(const char* text, uint32_t size)
+    {
+        uint8_t bytes[64] = {};
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            bytes[i] = static_cast<uint8_t>(text[i]);
+        }
+        uint32_t digest[4] = {};
+        ContainerChecksum::ComputeMd5(bytes, size, digest);
+        return { { digest[0], digest[1], digest[2], digest[3] } };
+    }
+
+    // What a builder throws, run at run time; an empty string if it didn't.
+    template <typename Builder>
+    std::string GetError(Builder build)
+    {
+        try
+        {
+            build();
+        }
+        catch (const std::invalid_argument& error)
+        {
+            return error.what();
+        }
+        return std::string();
+    }
+}
+
+// Everything below the namespace is checked by the compiler: serialization, hashing and the MD5
+// rounds of the container checksum all run in constant expressions.
+static_assert(SceneBlob.Size == 188, "Container, RTS0 header, 2 parameters, a range, a descriptor and a sampler.");
+static_assert(SceneBlob.Bytes[0] == 'D' && SceneBlob.Bytes[1] == 'X' && SceneBlob.Bytes[2] == 'B' && SceneBlob.Bytes[3] == 'C', "DXBC container.");
+static_assert(Read32(SceneBlob.Bytes.data(), 24) == SceneBlob.Size, "Container size.");
+static_assert(SceneBlob.Bytes[36] == 'R' && SceneBlob.Bytes[39] == '0', "RTS0 part.");
+static_assert(Read32(SceneBlob.Bytes.data(), 44) == 2, "Root signature version 1.1.");
+static_assert(SceneBlob.Hash == SceneLayout.Hash, "The blob carries the layout's hash.");
+static_assert(SceneLayout.Hash != ConstantsLayout.Hash, "Layouts that differ hash differently.");
+static_assert(FloatBitsOf(1.0f) == 0x3f800000 && FloatBitsOf(-2.5f) == 0xc0200000 && FloatBitsOf(3.402823466e+38f) == 0x7f7fffff, "Float bits.");
+static_assert(Md5("abc", 3)[0] == 0x98500190 && Md5("abc", 3)[3] == 0x727fe128, "MD5 of \"abc\".");
+static_assert(Md5("", 0)[0] == 0xd98c1dd4, "MD5 of nothing.");
+static_assert(VertexLayout.Hash != MakeInputLayout(20, std::array<InputElementLayout, 2>{ {
+    { "POSITION", 0, LayoutFormat::R32G32B32Float, 0, 0 },
+    { "TEXCOORD", 1, LayoutFormat::R32G32Float, 0, 12 } } }).Hash, "The semantic index is hashed.");
+static_assert(CombineLayoutHashes(SceneLayout.Hash, VertexLayout.Hash, HashPipelineState({ CullMode::Back, BlendMode::Opaque, LayoutFormat::R8G8B8A8Unorm }))
+    != CombineLayoutHashes(SceneLayout.Hash, VertexLayout.Hash, HashPipelineState({ CullMode::None, BlendMode::Opaque, LayoutFormat::R8G8B8A8Unorm })), "Fixed function state is hashed.");
+
+TEST(PipelineLayout, BlobParsesBack)
+{
+    // The RTS0 part, read the way the runtime does: offsets from the start of the part.
+    const uint8_t* const bytes = SceneBlob.Bytes.data();
+    const size_t part = Read32(bytes, 32) + 8;
+    CHECK_EQUAL(size_t(44), part);
+    CHECK_EQUAL(uint32_t(SceneBlob.Size - part), Read32(bytes, 40));
+    CHECK_EQUAL(2u, Read32(bytes, part + 4));
+    CHECK_EQUAL(1u, Read32(bytes, part + 12));
+    CHECK_EQUAL(RootSignatureAllowInputLayout, Read32(bytes, part + 20));
+
+    const size_t parameters = part + Read32(bytes, part + 8);
+    CHECK_EQUAL(0u, Read32(bytes, parameters));
+    CHECK_EQUAL(5u, Read32(bytes, parameters + 4));
+    const size_t table = part + Read32(bytes, parameters + 8);
+    CHECK_EQUAL(1u, Read32(bytes, table));
+    const size_t range = part + Read32(bytes, table + 4);
+    const uint32_t expectedRange[] = { 0, 1, 0, 0, RangeDataStatic, DescriptorRangeAppend };
+    for (size_t i = 0; i < 6; ++i)
+    {
+        CHECK_EQUAL(expectedRange[i], Read32(bytes, range + 4 * i));
+    }
+
+    CHECK_EQUAL(2u, Read32(bytes, parameters + 12));
+    CHECK_EQUAL(1u, Read32(bytes, parameters + 16));
+    const size_t descriptor = part + Read32(bytes, parameters + 20);
+    CHECK_EQUAL(0u, Read32(bytes, descriptor));
+    CHECK_EQUAL(RootDataStaticWhileSetAtExecute, Read32(bytes, descriptor + 8));
+
+    const size_t sampler = part + Read32(bytes, part + 16);
+    CHECK_EQUAL(SceneBlob.Size, sampler + 52);
+    CHECK_EQUAL(4u, Read32(bytes, sampler + 4));
+    CHECK_EQUAL(0x7f7fffffu, Read32(bytes, sampler + 36));
+    CHECK_EQUAL(5u, Read32(bytes, sampler + 48));
+
+    // Serializing at run time gives the same bytes and checksum as at compile time.
+    const auto runtimeLayout = MakeRootSignature(SceneLayout.Flags, SceneLayout.Parameters, SceneLayout.Samplers);
+    const auto runtimeBlob = SerializeRootSignature(runtimeLayout);
+    CHECK_EQUAL(SceneBlob.Size, runtimeBlob.Size);
+    CHECK(memcmp(SceneBlob.Bytes.data(), runtimeBlob.Bytes.data(), SceneBlob.Size) == 0);
+    CHECK_EQUAL(SceneLayout.Hash, runtimeLayout.Hash);
+}
+
+TEST(PipelineLayout, RejectsInvalidLayouts)
+{
+    const auto noSamplers = std::array<StaticSamplerLayout, 0>{};
+    CHECK_EQUAL(std::string("PipelineLayout: the root signature is over 64 DWORDs."), GetError([&]()
+    {
+        MakeRootSignature(0, std::array<RootParameterLayout, 2>{ { RootConstants(63, 0, 0, ShaderVisibility::All),
+            RootDescriptor(RootParameterType::Cbv, 1, 0, 0, ShaderVisibility::All) } }, noSamplers);
+    }));
+    CHECK_EQUAL(std::string("PipelineLayout: a shader register is bound twice."), GetError([&]()
+    {
+        MakeRootSignature(0, std::array<RootParameterLayout, 2>{ { DescriptorTable(ShaderVisibility::All, SrvRange(4, 0)),
+            RootDescriptor(RootParameterType::Srv, 3, 0, 0, ShaderVisibility::Pixel) } }, noSamplers);
+    }));
+    CHECK_EQUAL(std::string("PipelineLayout: samplers can't share a table with other descriptors."), GetError([&]()
+    {
+        MakeRootSignature(0, std::array<RootParameterLayout, 1>{ { DescriptorTable(ShaderVisibility::Pixel, SrvRange(1, 0),
+            DescriptorRange(DescriptorRangeType::Sampler, 1, 0)) } }, noSamplers);
+    }));
+    CHECK_EQUAL(std::string("PipelineLayout: conflicting descriptor range flags."), GetError([&]()
+    {
+        MakeRootSignature(0, std::array<RootParameterLayout, 1>{ { DescriptorTable(ShaderVisibility::Pixel,
+            SrvRange(1, 0, 0, RangeDataStatic | RangeDataVolatile)) } }, noSamplers);
+    }));
+    CHECK_EQUAL(std::string("PipelineLayout: vertex elements overlap."), GetError([]()
+    {
+        MakeInputLayout(20, std::array<InputElementLayout, 2>{ { { "POSITION", 0, LayoutFormat::R32G32B32Float, 0, 0 },
+            { "TEXCOORD", 0, LayoutFormat::R32G32Float, 0, 8 } } });
+    }));
+    CHECK_EQUAL(std::string("PipelineLayout: vertex elements are 4-byte aligned."), GetError([]()
+    {
+        MakeInputLayout(20, std::array<InputElementLayout, 1>{ { { "POSITION", 0, LayoutFormat::R32G32B32Float, 0, 2 } } });
+    }));
+    CHECK_EQUAL(std::string("PipelineLayout: a semantic is used twice."), GetError([]()
+    {
+        MakeInputLayout(24, std::array<InputElementLayout, 2>{ { { "POSITION", 0, LayoutFormat::R32G32B32Float, 0, 0 },
+            { "POSITION", 0, LayoutFormat::R32G32B32Float, 0, 12 } } });
+    }));
+
+    // The same register in two visibilities that don't overlap is fine.
+    CHECK_EQUAL(std::string(), GetError([&]()
+    {
+        MakeRootSignature(0, std::array<RootParameterLayout, 2>{ { DescriptorTable(ShaderVisibility::Vertex, SrvRange(1, 0)),
+            DescriptorTable(ShaderVisibility::Pixel, SrvRange(1, 0)) } }, noSamplers);
+    }));
+}
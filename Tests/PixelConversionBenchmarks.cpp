@@ -0,0 +1,48 @@
+#include "BenchmarkFramework.h"
+#include "TestFramework.h"
+
+#include "PixelConversion.h"
+
+#include <string>
+#include <vector>
+
+BENCHMARK(PixelConversion, Throughput)
+{
+    // A 1024x1024 texture through the conversions the upload paths use, in GB/s of source.
+    struct Case
+    {
+        const char* Name;
+        PixelFormat Source;
+        PixelFormat Dest;
+        uint32_t Flags;
+    };
+    const Case cases[] =
+    {
+        { "RGBA8 -> BGRA8", PixelFormat::RGBA8, PixelFormat::BGRA8, 0 },
+        { "RGBA8 sRGB -> RGBA16F", PixelFormat::RGBA8, PixelFormat::RGBA16F, PixelSourceSrgb },
+        { "RGBA8 premultiply", PixelFormat::RGBA8, PixelFormat::RGBA8, PixelPremultiplyAlpha },
+        { "RGBA32F -> RGBA8 sRGB", PixelFormat::RGBA32F, PixelFormat::RGBA8, PixelDestSrgb },
+        { "RGBA32F -> RGBA16F", PixelFormat::RGBA32F, PixelFormat::RGBA16F, 0 },
+        { "RGBA16F -> RGB10A2", PixelFormat::RGBA16F, PixelFormat::RGB10A2, 0 },
+        { "RG11B10F -> RGBA16F", PixelFormat::RG11B10F, PixelFormat::RGBA16F, 0 },
+    };
+
+    const size_t pixelCount = 1024 * 1024;
+    TestRandom random;
+    std::vector<float> colors(pixelCount * 4);
+    for (float& value : colors)
+    {
+        value = random.NextBelow(1001) / 1000.0f;
+    }
+    std::vector<uint8_t> source(pixelCount * 16);
+    std::vector<uint8_t> dest(pixelCount * 16);
+    for (const Case& c : cases)
+    {
+        ConvertPixels(colors.data(), PixelFormat::RGBA32F, source.data(), c.Source, pixelCount);
+        const double seconds = BestSeconds(5, [&]() { ConvertPixels(source.data(), c.Source, dest.data(), c.Dest, pixelCount, c.Flags); });
+        const std::string name = std::string(c.Name) + " (" + GetPixelConversionIsa() + ")";
+        Report(name.c_str(), pixelCount * GetPixelSize(c.Source) / seconds / 1e9, "GB/s");
+        const double referenceSeconds = BestSeconds(1, [&]() { ConvertPixelsReference(source.data(), c.Source, dest.data(), c.Dest, pixelCount, c.Flags); });
+        Report("  reference", pixelCount * GetPixelSize(c.Source) / referenceSeconds / 1e9, "GB/s");
+    }
+}
@@ -0,0 +1,235 @@
+#include "TestFramework.h"
+
+#include "PixelConversion.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const PixelFormat AllFormats[] =
+    {
+        PixelFormat::RGBA8, PixelFormat::BGRA8, PixelFormat::RGBA16F, PixelFormat::RGBA32F, PixelFormat::RGB10A2, PixelFormat::RG11B10F,
+    };
+
+    // Random colors, mostly in [0, 1] with some out of range, written in a format by the
+    // reference conversion so that every source format gets finite values.
+    std::vector<uint8_t> MakePixels(PixelFormat format, size_t pixelCount, TestRandom& random)
+    {
+        std::vector<float> colors(pixelCount * 4);
+        for (float& value : colors)
+        {
+            const uint32_t kind = random.NextBelow(16);
+            value = kind == 0 ? -float(random.NextBelow(1000)) / 1000.0f : kind == 1 ? 1.0f + random.NextBelow(100000) / 1000.0f : random.NextBelow(100001) / 100000.0f;
+        }
+        std::vector<uint8_t> pixels(pixelCount * GetPixelSize(format));
+        ConvertPixelsReference(colors.data(), PixelFormat::RGBA32F, pixels.data(), format, pixelCount);
+        return pixels;
+    }
+
+    // Fields of a destination pixel, as integers one step apart (floats by their bits, which
+    // order the same way as the values for a given sign).
+    uint32_t GetFields(const uint8_t* pixel, PixelFormat format, int64_t* fields)
+    {
+        uint32_t packed;
+        memcpy(&packed, pixel, sizeof(packed));
+        switch (format)
+        {
+        case PixelFormat::RGBA8:
+        case PixelFormat::BGRA8:
+            for (int c = 0; c < 4; ++c)
+            {
+                fields[c] = pixel[c];
+            }
+            return 4;
+        case PixelFormat::RGBA16F:
+            for (int c = 0; c < 4; ++c)
+            {
+                const uint32_t half = pixel[c * 2] | (pixel[c * 2 + 1] << 8);
+                fields[c] = (half & 0x8000) ? -int64_t(half & 0x7fff) : int64_t(half);
+            }
+            return 4;
+        case PixelFormat::RGB10A2:
+            fields[0] = packed & 0x3ff;
+            fields[1] = (packed >> 10) & 0x3ff;
+            fields[2] = (packed >> 20) & 0x3ff;
+            fields[3] = packed >> 30;
+            return 4;
+        case PixelFormat::RG11B10F:
+            fields[0] = packed & 0x7ff;
+            fields[1] = (packed >> 11) & 0x7ff;
+            fields[2] = packed >> 22;
+            return 3;
+        default:
+            return 0;
+        }
+    }
+
+    // Pixels that differ from the reference by more than one step in any channel (for 32-bit
+    // floats, by more than single precision rounding).
+    size_t CountMismatches(const uint8_t* actual, const uint8_t* expected, PixelFormat format, size_t pixelCount)
+    {
+        const uint32_t size = GetPixelSize(format);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            bool same = true;
+            if (format == PixelFormat::RGBA32F)
+            {
+                float a[4], e[4];
+                memcpy(a, actual + i * size, sizeof(a));
+                memcpy(e, expected + i * size, sizeof(e));
+                for (int c = 0; c < 4; ++c)
+                {
+                    same &= std::fabs(a[c] - e[c]) <= 1e-5f * std::fabs(e[c]) + 1e-7f;
+                }
+            }
+            else
+            {
+                int64_t a[4], e[4];
+                const uint32_t count = GetFields(actual + i * size, format, a);
+                GetFields(expected + i * size, format, e);
+                for (uint32_t c = 0; c < count; ++c)
+                {
+                    same &= a[c] - e[c] <= 1 && e[c] - a[c] <= 1;
+                }
+            }
+            mismatches += same ? 0 : 1;
+        }
+        return mismatches;
+    }
+}
+
+TEST(PixelConversion, EveryPairMatchesReference)
+{
+    // Every source and destination format with every flag, over an odd pixel count and from an
+    // unaligned source so that the vector loops and their tails both run.
+    TestRandom random;
+    const size_t pixelCount = 1037;
+    size_t failedPairs = 0;
+    for (PixelFormat source : AllFormats)
+    {
+        const std::vector<uint8_t> pixels = MakePixels(source, pixelCount, random);
+        std::vector<uint8_t> unaligned(pixels.size() + 1);
+        memcpy(unaligned.data() + 1, pixels.data(), pixels.size());
+        for (PixelFormat dest : AllFormats)
+        {
+            for (uint32_t flags = 0; flags < 8; ++flags)
+            {
+                const size_t destSize = pixelCount * GetPixelSize(dest);
+                std::vector<uint8_t> expected(destSize);
+                std::vector<uint8_t> actual(destSize + 1);
+                ConvertPixelsReference(pixels.data(), source, expected.data(), dest, pixelCount, flags);
+                ConvertPixels(unaligned.data() + 1, source, actual.data() + 1, dest, pixelCount, flags);
+                const size_t mismatches = CountMismatches(actual.data() + 1, expected.data(), dest, pixelCount);
+                if (mismatches != 0)
+                {
+                    printf("  %s -> %s flags %u: %zu pixels differ\n", GetPixelFormatName(source), GetPixelFormatName(dest), flags, mismatches);
+                    ++failedPairs;
+                }
+            }
+        }
+    }
+    CHECK_EQUAL(size_t(0), failedPairs);
+}
+
+TEST(PixelConversion, ExactWhereNoRoundingHappens)
+{
+    // Swizzles and copies between identical formats are bit exact.
+    TestRandom random;
+    const size_t pixelCount = 333;
+    const std::vector<uint8_t> rgba = MakePixels(PixelFormat::RGBA8, pixelCount, random);
+    std::vector<uint8_t> bgra(rgba.size());
+    std::vector<uint8_t> back(rgba.size());
+    ConvertPixels(rgba.data(), PixelFormat::RGBA8, bgra.data(), PixelFormat::BGRA8, pixelCount);
+    ConvertPixels(bgra.data(), PixelFormat::BGRA8, back.data(), PixelFormat::RGBA8, pixelCount);
+    CHECK(back == rgba);
+    CHECK_EQUAL(rgba[0], bgra[2]);
+    CHECK_EQUAL(rgba[2], bgra[0]);
+    CHECK_EQUAL(rgba[3], bgra[3]);
+
+    // 8-bit unorm through half and 32-bit floats and back.
+    for (PixelFormat wide : { PixelFormat::RGBA16F, PixelFormat::RGBA32F })
+    {
+        std::vector<uint8_t> widened(pixelCount * GetPixelSize(wide));
+        ConvertPixels(rgba.data(), PixelFormat::RGBA8, widened.data(), wide, pixelCount);
+        ConvertPixels(widened.data(), wide, back.data(), PixelFormat::RGBA8, pixelCount);
+        CHECK(back == rgba);
+    }
+
+    // sRGB decode then encode gives the same bytes.
+    std::vector<float> linear(pixelCount * 4);
+    ConvertPixels(rgba.data(), PixelFormat::RGBA8, linear.data(), PixelFormat::RGBA32F, pixelCount, PixelSourceSrgb);
+    ConvertPixels(linear.data(), PixelFormat::RGBA32F, back.data(), PixelFormat::RGBA8, pixelCount, PixelDestSrgb);
+    CHECK(back == rgba);
+}
+
+TEST(PixelConversion, SpecialValues)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float infinity = std::numeric_limits<float>::infinity();
+    const float colors[] = { nan, infinity, -infinity, -1.0f, 2.0f, 0.5f, 1.0f, 0.0f };
+    uint8_t rgba[8];
+    ConvertPixels(colors, PixelFormat::RGBA32F, rgba, PixelFormat::RGBA8, 2);
+    const uint8_t expected[8] = { 0, 255, 0, 0, 255, 128, 255, 0 };
+    CHECK(memcmp(rgba, expected, sizeof(expected)) == 0);
+
+    // Premultiplied alpha: colors scaled by alpha, alpha kept.
+    const float translucent[] = { 1.0f, 0.5f, 0.25f, 0.5f };
+    float premultiplied[4];
+    ConvertPixels(translucent, PixelFormat::RGBA32F, premultiplied, PixelFormat::RGBA32F, 1, PixelPremultiplyAlpha);
+    CHECK(premultiplied[0] == 0.5f && premultiplied[1] == 0.25f && premultiplied[2] == 0.125f && premultiplied[3] == 0.5f);
+
+    // 11:11:10 has no alpha: it reads as 1.
+    uint32_t packed = 0;
+    float decoded[4];
+    ConvertPixels(translucent, PixelFormat::RGBA32F, &packed, PixelFormat::RG11B10F, 1);
+    ConvertPixels(&packed, PixelFormat::RG11B10F, decoded, PixelFormat::RGBA32F, 1);
+    CHECK(decoded[0] == 1.0f && decoded[1] == 0.5f && decoded[2] == 0.25f && decoded[3] == 1.0f);
+}
+
+TEST(PixelConversion, RowsAndFormats)
+{
+    // Rows with padding on both sides: the padding of the destination is never written.
+    TestRandom random;
+    const uint32_t width = 37;
+    const uint32_t height = 5;
+    const std::vector<uint8_t> source = MakePixels(PixelFormat::RGBA8, size_t(width + 3) * height, random);
+    const size_t destPitch = width * 8 + 24;
+    std::vector<uint8_t> dest(destPitch * height, 0xCD);
+    ConvertPixelRows(source.data(), (width + 3) * 4, PixelFormat::RGBA8, dest.data(), destPitch, PixelFormat::RGBA16F, width, height, PixelSourceSrgb);
+
+    bool rowsMatch = true;
+    bool paddingKept = true;
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        std::vector<uint8_t> row(width * 8);
+        ConvertPixels(source.data() + y * (width + 3) * 4, PixelFormat::RGBA8, row.data(), PixelFormat::RGBA16F, width, PixelSourceSrgb);
+        rowsMatch &= memcmp(row.data(), dest.data() + y * destPitch, row.size()) == 0;
+        for (size_t x = width * 8; x < destPitch; ++x)
+        {
+            paddingKept &= dest[y * destPitch + x] == 0xCD;
+        }
+    }
+    CHECK(rowsMatch);
+    CHECK(paddingKept);
+
+    PixelFormat format;
+    bool srgb;
+    CHECK(GetPixelFormatFromDxgi(29, format, srgb) && format == PixelFormat::RGBA8 && srgb);
+    CHECK(GetPixelFormatFromDxgi(87, format, srgb) && format == PixelFormat::BGRA8 && !srgb);
+    CHECK(GetPixelFormatFromDxgi(91, format, srgb) && format == PixelFormat::BGRA8 && srgb);
+    CHECK(GetPixelFormatFromDxgi(10, format, srgb) && format == PixelFormat::RGBA16F);
+    CHECK(GetPixelFormatFromDxgi(2, format, srgb) && format == PixelFormat::RGBA32F);
+    CHECK(GetPixelFormatFromDxgi(24, format, srgb) && format == PixelFormat::RGB10A2);
+    CHECK(GetPixelFormatFromDxgi(26, format, srgb) && format == PixelFormat::RG11B10F);
+    CHECK(!GetPixelFormatFromDxgi(71, format, srgb));
+    CHECK_EQUAL(16u, GetPixelSize(PixelFormat::RGBA32F));
+    CHECK_EQUAL(4u, GetPixelSize(PixelFormat::RG11B10F));
+    const std::string isa = GetPixelConversionIsa();
+    CHECK(isa == "avx2" || isa == "sse2" || isa == "neon" || isa == "scalar");
+}
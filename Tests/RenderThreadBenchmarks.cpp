@@ -0,0 +1,117 @@
+#include "BenchmarkFramework.h"
+
+#include "RenderThread.h"
+#include "SpscRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const uint64_t ItemCount = 10000000;
+
+    // Items per second from one producer thread to one consumer thread.
+    template <typename Push, typename Pop>
+    double MeasureHandoff(Push push, Pop pop)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::thread consumer([&]()
+        {
+            uint64_t expected = 0;
+            uint64_t value;
+            while (expected < ItemCount)
+            {
+                if (pop(value))
+                {
+                    ++expected;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        for (uint64_t i = 0; i < ItemCount; ++i)
+        {
+            while (!push(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+        return ItemCount / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Median time from PostEvent to the start of its Event handler, one event at a time.
+    double MedianPostToHandleMicroseconds(bool paused)
+    {
+        typedef std::chrono::steady_clock Clock;
+        std::atomic<int64_t> handledAt(0);
+        RenderThreadHandlers handlers;
+        handlers.Event = [&](const WindowEvent&) { handledAt.store(Clock::now().time_since_epoch().count()); };
+        handlers.Resize = [](uint32_t, uint32_t) {};
+        handlers.Frame = []() { std::this_thread::sleep_for(std::chrono::microseconds(50)); };
+        handlers.Shutdown = []() {};
+        handlers.Exited = []() {};
+
+        RenderThread thread;
+        thread.Start(handlers, paused ? 0 : 640, paused ? 0 : 480);
+        std::vector<double> latencies;
+        for (int i = 0; i < 2000; ++i)
+        {
+            handledAt = 0;
+            const Clock::time_point posted = Clock::now();
+            thread.PostEvent({ WindowEventType::KeyDown, 0 });
+            while (handledAt.load() == 0)
+            {
+                std::this_thread::yield();
+            }
+            latencies.push_back(std::chrono::duration<double, std::micro>(Clock::duration(handledAt.load()) - posted.time_since_epoch()).count());
+        }
+        thread.RequestStop();
+        thread.Join();
+
+        std::nth_element(latencies.begin(), latencies.begin() + latencies.size() / 2, latencies.end());
+        return latencies[latencies.size() / 2];
+    }
+}
+
+BENCHMARK(SpscRing, Throughput)
+{
+    SpscRing<uint64_t, 256> ring;
+    Report("SpscRing", MeasureHandoff([&](uint64_t value) { return ring.TryPush(value); }, [&](uint64_t& value) { return ring.TryPop(value); }) / 1e6, "M items/s");
+
+    std::mutex mutex;
+    std::deque<uint64_t> queue;
+    Report("Mutex and deque", MeasureHandoff([&](uint64_t value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.size() == 256)
+        {
+            return false;
+        }
+        queue.push_back(value);
+        return true;
+    }, [&](uint64_t& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty())
+        {
+            return false;
+        }
+        value = queue.front();
+        queue.pop_front();
+        return true;
+    }) / 1e6, "M items/s");
+}
+
+BENCHMARK(RenderThread, Latency)
+{
+    Report("Post to handle, rendering", MedianPostToHandleMicroseconds(false), "us (median)");
+    Report("Post to handle, paused", MedianPostToHandleMicroseconds(true), "us (median)");
+}
@@ -0,0 +1,311 @@
+#include "TestFramework.h"
+
+#include "RenderThread.h"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // The handler calls, in order, as "frame", "event <type> <key>", "resize <w>x<h>",
+    // "shutdown" and "exited".
+    class CallLog
+    {
+    public:
+        void Add(const std::string& call)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_calls.push_back(call);
+        }
+
+        std::vector<std::string> Get() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_calls;
+        }
+
+        // The calls other than frames.
+        std::vector<std::string> GetWithoutFrames() const
+        {
+            std::vector<std::string> calls;
+            for (const std::string& call : Get())
+            {
+                if (call != "frame")
+                {
+                    calls.push_back(call);
+                }
+            }
+            return calls;
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<std::string> m_calls;
+    };
+
+    RenderThreadHandlers MakeHandlers(CallLog& log)
+    {
+        RenderThreadHandlers handlers;
+        handlers.Event = [&log](const WindowEvent& event)
+        {
+            log.Add("event " + std::to_string(static_cast<int>(event.Type)) + " " + std::to_string(event.Value));
+        };
+        handlers.Resize = [&log](uint32_t width, uint32_t height) { log.Add("resize " + std::to_string(width) + "x" + std::to_string(height)); };
+        handlers.Frame = [&log]()
+        {
+            log.Add("frame");
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        };
+        handlers.Shutdown = [&log]() { log.Add("shutdown"); };
+        handlers.Exited = [&log]() { log.Add("exited"); };
+        return handlers;
+    }
+
+    // Polls until done returns true; false after two seconds.
+    template <typename Condition>
+    bool WaitUntil(Condition done)
+    {
+        const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!done())
+        {
+            if (std::chrono::steady_clock::now() > end)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        return true;
+    }
+
+    const WindowEvent KeyDown = { WindowEventType::KeyDown, 65 };
+    const WindowEvent KeyUp = { WindowEventType::KeyUp, 65 };
+}
+
+TEST(RenderThread, EventsThenResizeThenFrame)
+{
+    // Frame 1 holds the thread while two events and two sizes arrive: the next frame starts
+    // with both events, in order, then the latest size only.
+    CallLog log;
+    std::atomic<bool> holding(false);
+    std::atomic<bool> release(false);
+    RenderThreadHandlers handlers = MakeHandlers(log);
+    handlers.Frame = [&]()
+    {
+        log.Add("frame");
+        holding = true;
+        while (!release)
+        {
+            std::this_thread::yield();
+        }
+    };
+
+    RenderThread thread;
+    thread.Start(handlers, 640, 480);
+    REQUIRE(WaitUntil([&]() { return holding.load(); }));
+    CHECK(thread.PostEvent(KeyDown));
+    CHECK(thread.PostEvent(KeyUp));
+    thread.PostResize(800, 600);
+    thread.PostResize(1024, 768);
+    release = true;
+    CHECK(WaitUntil([&]() { return thread.GetFrameCount() >= 3; }));
+    thread.RequestStop();
+    thread.Join();
+    CHECK(!thread.IsRunning());
+
+    const std::vector<std::string> calls = log.Get();
+    REQUIRE(calls.size() >= 7);
+    CHECK_EQUAL(std::string("frame"), calls[0]);
+    CHECK_EQUAL(std::string("event 0 65"), calls[1]);
+    CHECK_EQUAL(std::string("event 1 65"), calls[2]);
+    CHECK_EQUAL(std::string("resize 1024x768"), calls[3]);
+    CHECK_EQUAL(std::string("frame"), calls[4]);
+    CHECK_EQUAL(std::string("shutdown"), calls[calls.size() - 2]);
+    CHECK_EQUAL(std::string("exited"), calls.back());
+    CHECK_EQUAL(uint64_t(0), thread.GetDroppedEventCount());
+}
+
+TEST(RenderThread, PausesWhileMinimized)
+{
+    CallLog log;
+    RenderThread thread;
+    thread.Start(MakeHandlers(log), 640, 480);
+    REQUIRE(WaitUntil([&]() { return thread.GetFrameCount() >= 1; }));
+
+    // No frames at size zero, but events still run.
+    thread.PostResize(0, 0);
+    REQUIRE(WaitUntil([&]() { return log.GetWithoutFrames().size() == 1; }));
+    const uint64_t pausedAt = thread.GetFrameCount();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_EQUAL(pausedAt, thread.GetFrameCount());
+    thread.PostEvent(KeyDown);
+    CHECK(WaitUntil([&]() { return log.GetWithoutFrames().size() == 2; }));
+    CHECK_EQUAL(pausedAt, thread.GetFrameCount());
+
+    // Restoring the window wakes it.
+    thread.PostResize(640, 240);
+    CHECK(WaitUntil([&]() { return thread.GetFrameCount() > pausedAt + 2; }));
+
+    // A stop while paused still shuts down.
+    thread.PostResize(640, 0);
+    REQUIRE(WaitUntil([&]() { return log.GetWithoutFrames().size() == 4; }));
+    thread.RequestStop();
+    thread.Join();
+
+    const std::vector<std::string> expected = { "resize 0x0", "event 0 65", "resize 640x240", "resize 640x0", "shutdown", "exited" };
+    CHECK(log.GetWithoutFrames() == expected);
+}
+
+TEST(RenderThread, SizePostedBeforeStart)
+{
+    // The window is shown (and sized) before the thread starts: the first frame sees the size.
+    CallLog log;
+    RenderThread thread;
+    thread.PostResize(1280, 720);
+    thread.Start(MakeHandlers(log), 640, 480);
+    REQUIRE(WaitUntil([&]() { return thread.GetFrameCount() >= 1; }));
+
+    // Started once only.
+    bool threw = false;
+    try
+    {
+        thread.Start(MakeHandlers(log), 640, 480);
+    }
+    catch (const std::logic_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+
+    thread.RequestStop();
+    thread.Join();
+    const std::vector<std::string> calls = log.Get();
+    REQUIRE(calls.size() >= 2);
+    CHECK_EQUAL(std::string("resize 1280x720"), calls[0]);
+    CHECK_EQUAL(std::string("frame"), calls[1]);
+}
+
+TEST(RenderThread, ErrorEndsTheThread)
+{
+    // A frame throws (a lost device): no more frames, Shutdown still flushes, then Exited, and
+    // Join hands the exception over instead of throwing it.
+    CallLog log;
+    RenderThreadHandlers handlers = MakeHandlers(log);
+    handlers.Frame = [&log]()
+    {
+        log.Add("frame");
+        if (log.Get().size() == 3)
+        {
+            throw std::runtime_error("device removed");
+        }
+    };
+    RenderThread thread;
+    thread.Start(handlers, 640, 480);
+    REQUIRE(WaitUntil([&]() { return !log.Get().empty() && log.Get().back() == "exited"; }));
+
+    const std::exception_ptr error = thread.Join();
+    REQUIRE(error != nullptr);
+    std::string message;
+    try
+    {
+        std::rethrow_exception(error);
+    }
+    catch (const std::runtime_error& e)
+    {
+        message = e.what();
+    }
+    CHECK_EQUAL(std::string("device removed"), message);
+    CHECK_EQUAL(uint64_t(2), thread.GetFrameCount());
+    const std::vector<std::string> expected = { "frame", "frame", "frame", "shutdown", "exited" };
+    CHECK(log.Get() == expected);
+
+    // Handed over once.
+    CHECK(thread.Join() == nullptr);
+}
+
+TEST(RenderThread, FirstErrorIsKept)
+{
+    // Shutdown throws too after the failed frame: Join returns the frame's error.
+    CallLog log;
+    RenderThreadHandlers handlers = MakeHandlers(log);
+    handlers.Frame = []() { throw std::runtime_error("frame"); };
+    handlers.Shutdown = [&log]()
+    {
+        log.Add("shutdown");
+        throw std::runtime_error("shutdown");
+    };
+    RenderThread thread;
+    thread.Start(handlers, 640, 480);
+
+    std::string message;
+    try
+    {
+        std::rethrow_exception(thread.Join());
+    }
+    catch (const std::runtime_error& e)
+    {
+        message = e.what();
+    }
+    CHECK_EQUAL(std::string("frame"), message);
+    const std::vector<std::string> expected = { "shutdown", "exited" };
+    CHECK(log.Get() == expected);
+}
+
+TEST(RenderThread, DropsEventsWhenFull)
+{
+    // The first event holds the thread; the ring then takes EventCapacity more and drops the rest.
+    CallLog log;
+    std::atomic<bool> holding(false);
+    std::atomic<bool> release(false);
+    std::vector<uint32_t> keys;
+    RenderThreadHandlers handlers = MakeHandlers(log);
+    handlers.Event = [&](const WindowEvent& event)
+    {
+        keys.push_back(event.Value);
+        holding = true;
+        while (!release)
+        {
+            std::this_thread::yield();
+        }
+    };
+
+    RenderThread thread;
+    thread.Start(handlers, 640, 480);
+    CHECK(thread.PostEvent({ WindowEventType::KeyDown, 0 }));
+    REQUIRE(WaitUntil([&]() { return holding.load(); }));
+    uint32_t accepted = 0;
+    for (uint32_t key = 1; key <= RenderThread::EventCapacity + 10; ++key)
+    {
+        accepted += thread.PostEvent({ WindowEventType::KeyDown, key }) ? 1 : 0;
+    }
+    CHECK_EQUAL(uint32_t(RenderThread::EventCapacity), accepted);
+    CHECK_EQUAL(uint64_t(10), thread.GetDroppedEventCount());
+    release = true;
+    thread.RequestStop();
+    thread.Join();
+
+    REQUIRE(keys.size() == RenderThread::EventCapacity + 1);
+    bool ordered = true;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ordered &= keys[i] == i;
+    }
+    CHECK(ordered);
+}
+
+TEST(RenderThread, DestructorStops)
+{
+    CallLog log;
+    {
+        RenderThread thread;
+        thread.Start(MakeHandlers(log), 640, 480);
+        REQUIRE(WaitUntil([&]() { return thread.GetFrameCount() >= 1; }));
+    }
+    const std::vector<std::string> expected = { "shutdown", "exited" };
+    CHECK(log.GetWithoutFrames() == expected);
+}
@@ -0,0 +1,250 @@
+#include "TestFramework.h"
+
+#include "ResourceCache.h"
+#include "TimelineFence.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // Resources are indices into g_resources; the release function logs them in order.
+    int g_resources[16];
+    std::vector<int> g_released;
+
+    void ReleaseResource(void* resource)
+    {
+        g_released.push_back(static_cast<int>(static_cast<int*>(resource) - g_resources));
+    }
+
+    void* Resource(int index)
+    {
+        return &g_resources[index];
+    }
+
+    ResourceKey MakeKey(uint32_t content)
+    {
+        return MakeTextureKey(&content, sizeof(content), 28, 64, 64);
+    }
+}
+
+TEST(ResourceCache, HitsAndMisses)
+{
+    g_released.clear();
+    DeferredReleaseQueue queue;
+    SimulatedTimelineFence timeline;
+    {
+        ResourceCache cache(queue, ReleaseResource, 8);
+        const ResourceKey key = MakeKey(1);
+        CHECK_EQUAL(InvalidResource, cache.Acquire(key));
+        const ResourceHandle handle = cache.Insert(key, Resource(1), 1000);
+        CHECK(handle != InvalidResource);
+
+        // The same content is a hit, the same bytes as another format or size is not.
+        for (int i = 0; i < 3; ++i)
+        {
+            CHECK_EQUAL(handle, cache.Acquire(MakeKey(1)));
+        }
+        uint32_t content = 1;
+        CHECK_EQUAL(InvalidResource, cache.Acquire(MakeTextureKey(&content, sizeof(content), 29, 64, 64)));
+        CHECK_EQUAL(InvalidResource, cache.Acquire(MakeTextureKey(&content, sizeof(content), 28, 64, 32)));
+        CHECK_EQUAL(InvalidResource, cache.Acquire(MakeBufferKey(&content, sizeof(content))));
+        CHECK(cache.GetResource(handle) == Resource(1));
+        CHECK(cache.GetKey(handle) == key);
+
+        ResourceCacheStats stats = cache.GetStats();
+        CHECK_EQUAL(uint64_t(7), stats.Lookups);
+        CHECK_EQUAL(uint64_t(3), stats.Hits);
+        CHECK_EQUAL(uint64_t(1), stats.Inserts);
+        CHECK_EQUAL(uint64_t(3000), stats.SavedBytes);
+        CHECK_EQUAL(uint64_t(1), stats.LiveCount);
+        CHECK_EQUAL(uint64_t(1000), stats.LiveBytes);
+
+        // Still cached after the last reference goes, and a hit again.
+        for (int i = 0; i < 4; ++i)
+        {
+            cache.Release(handle, timeline, 1);
+        }
+        CHECK_EQUAL(uint64_t(1000), cache.GetStats().UnreferencedBytes);
+        CHECK_EQUAL(handle, cache.Acquire(key));
+        CHECK_EQUAL(uint64_t(0), cache.GetStats().UnreferencedBytes);
+        CHECK(g_released.empty());
+    }
+    // The destructor releases everything, referenced or not.
+    CHECK_EQUAL(size_t(1), g_released.size());
+}
+
+TEST(ResourceCache, DuplicateInsert)
+{
+    // Two loads missed the same key: the second resource is released at once and both share
+    // the first entry.
+    g_released.clear();
+    DeferredReleaseQueue queue;
+    SimulatedTimelineFence timeline;
+    ResourceCache cache(queue, ReleaseResource, 8);
+    bool inserted = false;
+    const ResourceHandle first = cache.Insert(MakeKey(2), Resource(1), 100, &inserted);
+    CHECK(inserted);
+    uint32_t initialized = 0;
+    const ResourceHandle second = cache.Insert(MakeKey(2), Resource(2), 100, &inserted, [&](uint32_t) { ++initialized; });
+    CHECK(!inserted);
+    CHECK_EQUAL(first, second);
+    CHECK_EQUAL(0u, initialized);
+    CHECK(cache.GetResource(first) == Resource(1));
+    REQUIRE(g_released.size() == 1);
+    CHECK_EQUAL(2, g_released[0]);
+
+    const ResourceCacheStats stats = cache.GetStats();
+    CHECK_EQUAL(uint64_t(1), stats.Inserts);
+    CHECK_EQUAL(uint64_t(1), stats.Duplicates);
+    CHECK_EQUAL(uint64_t(1), stats.LiveCount);
+
+    // Two references: one release keeps it referenced.
+    cache.Release(first, timeline, 0);
+    CHECK_EQUAL(size_t(0), cache.Trim(0));
+    cache.Release(first, timeline, 0);
+    CHECK_EQUAL(size_t(1), cache.Trim(0));
+}
+
+TEST(ResourceCache, EvictsLeastRecentlyReleasedFirst)
+{
+    g_released.clear();
+    DeferredReleaseQueue queue;
+    SimulatedTimelineFence timeline;
+    ResourceCache cache(queue, ReleaseResource, 8);
+    ResourceHandle handles[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        handles[i] = cache.Insert(MakeKey(10 + i), Resource(i), 100);
+    }
+
+    // Released 2, 0, 3; 1 stays referenced. Acquiring 0 again and releasing it moves it last.
+    cache.Release(handles[2], timeline, 0);
+    cache.Release(handles[0], timeline, 0);
+    cache.Release(handles[3], timeline, 0);
+    CHECK_EQUAL(handles[0], cache.Acquire(MakeKey(10)));
+    cache.Release(handles[0], timeline, 0);
+    CHECK_EQUAL(uint64_t(300), cache.GetStats().UnreferencedBytes);
+
+    CHECK_EQUAL(size_t(0), cache.Trim(300));
+    CHECK_EQUAL(size_t(1), cache.Trim(250));
+    CHECK_EQUAL(size_t(1), cache.Trim(100));
+    queue.Collect();
+    REQUIRE(g_released.size() == 2);
+    CHECK_EQUAL(2, g_released[0]);
+    CHECK_EQUAL(3, g_released[1]);
+    CHECK_EQUAL(InvalidResource, cache.Acquire(MakeKey(12)));
+    CHECK_EQUAL(handles[0], cache.Acquire(MakeKey(10)));
+    cache.Release(handles[0], timeline, 0);
+
+    CHECK_EQUAL(size_t(1), cache.Trim(0));
+    queue.Collect();
+    CHECK_EQUAL(size_t(3), g_released.size());
+    const ResourceCacheStats stats = cache.GetStats();
+    CHECK_EQUAL(uint64_t(3), stats.Evictions);
+    CHECK_EQUAL(uint64_t(1), stats.LiveCount);
+    CHECK_EQUAL(uint64_t(100), stats.LiveBytes);
+    CHECK_EQUAL(uint64_t(0), stats.UnreferencedBytes);
+}
+
+TEST(ResourceCache, EvictionWaitsForLastUse)
+{
+    // Evicted entries go through the deferred release queue with the latest lastUse given.
+    g_released.clear();
+    DeferredReleaseQueue queue;
+    SimulatedTimelineFence timeline;
+    ResourceCache cache(queue, ReleaseResource, 8);
+    const ResourceHandle handle = cache.Insert(MakeKey(3), Resource(3), 100);
+    CHECK_EQUAL(handle, cache.Acquire(MakeKey(3)));
+    const uint64_t early = timeline.Signal();
+    const uint64_t late = timeline.Signal();
+    cache.Release(handle, timeline, late);
+    cache.Release(handle, timeline, early);
+    CHECK_EQUAL(size_t(1), cache.Trim(0));
+    CHECK_EQUAL(size_t(1), queue.GetPendingCount());
+
+    timeline.Complete(early);
+    CHECK_EQUAL(size_t(0), queue.Collect());
+    CHECK(g_released.empty());
+    timeline.Complete(late);
+    CHECK_EQUAL(size_t(1), queue.Collect());
+    REQUIRE(g_released.size() == 1);
+    CHECK_EQUAL(3, g_released[0]);
+
+    // Gone from the cache as soon as it was trimmed; the handle is no longer valid.
+    CHECK_EQUAL(InvalidResource, cache.Acquire(MakeKey(3)));
+    bool threw = false;
+    try
+    {
+        cache.GetResource(handle);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(ResourceCache, DescriptorExhaustion)
+{
+    g_released.clear();
+    DeferredReleaseQueue queue;
+    SimulatedTimelineFence timeline;
+    ResourceCache cache(queue, ReleaseResource, 2);
+    std::vector<uint32_t> initialized;
+    const auto initialize = [&](uint32_t descriptor) { initialized.push_back(descriptor); };
+    const ResourceHandle a = cache.Insert(MakeKey(20), Resource(0), 100, nullptr, initialize);
+    const ResourceHandle b = cache.Insert(MakeKey(21), Resource(1), 100, nullptr, initialize);
+    CHECK_EQUAL(0u, cache.GetDescriptor(a));
+    CHECK_EQUAL(1u, cache.GetDescriptor(b));
+
+    // Every slot referenced: the insert fails and the new resource is released.
+    bool threw = false;
+    try
+    {
+        cache.Insert(MakeKey(22), Resource(2), 100, nullptr, initialize);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    REQUIRE(g_released.size() == 1);
+    CHECK_EQUAL(2, g_released[0]);
+
+    // An unreferenced entry gives up its slot to the next insert.
+    cache.Release(a, timeline, timeline.Signal());
+    const ResourceHandle c = cache.Insert(MakeKey(22), Resource(2), 100, nullptr, initialize);
+    CHECK_EQUAL(0u, cache.GetDescriptor(c));
+    CHECK_EQUAL(InvalidResource, cache.Acquire(MakeKey(20)));
+    REQUIRE(initialized.size() == 3);
+    CHECK_EQUAL(0u, initialized[0]);
+    CHECK_EQUAL(1u, initialized[1]);
+    CHECK_EQUAL(0u, initialized[2]);
+    timeline.Flush();
+    queue.Collect();
+    CHECK_EQUAL(size_t(2), g_released.size());
+
+    // Misuse of handles throws.
+    cache.Release(b, timeline, 0);
+    threw = false;
+    try
+    {
+        cache.Release(b, timeline, 0);
+    }
+    catch (const std::logic_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    threw = false;
+    try
+    {
+        cache.GetDescriptor(InvalidResource);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
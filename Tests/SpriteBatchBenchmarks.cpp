@@ -0,0 +1,38 @@
+#include "BenchmarkFramework.h"
+#include "TestFramework.h"
+
+#include "SpriteBatch.h"
+#include "ThreadPool.h"
+
+#include <vector>
+
+BENCHMARK(SpriteBatch, Expand)
+{
+    // 200k spinning sprites of 8 textures, as with -sprites 200000.
+    const size_t count = 200000;
+    TestRandom random;
+    std::vector<Sprite> sprites(count);
+    for (Sprite& sprite : sprites)
+    {
+        sprite = { float(random.NextBelow(1920)), float(random.NextBelow(1080)), 16, 16, random.NextBelow(6283) / 1000.0f, static_cast<uint32_t>(random.Next()), 0, 0xffffffff };
+    }
+    std::vector<SpriteVertex> storage(4 * count + 1);
+    SpriteVertex* vertices = reinterpret_cast<SpriteVertex*>((reinterpret_cast<uintptr_t>(storage.data()) + 15) & ~uintptr_t(15));
+
+    Report("Kernel", count / BestSeconds(10, [&]() { ExpandSprites(sprites.data(), count, vertices); }) / 1e3, "sprites/ms");
+    Report("Reference", count / BestSeconds(3, [&]() { ExpandSpritesReference(sprites.data(), count, vertices); }) / 1e3, "sprites/ms");
+
+    ThreadPool pool;
+    SpriteBatch batch;
+    const double seconds = BestSeconds(10, [&]()
+    {
+        batch.Begin();
+        for (size_t first = 0; first < count; first += count / 8)
+        {
+            batch.Draw(static_cast<uint32_t>(first / (count / 8)), sprites.data() + first, count / 8);
+        }
+        batch.End(vertices, true, &pool);
+    });
+    Report("Batch, pool", count / seconds / 1e3, "sprites/ms");
+    Report("Batch, pool", seconds * 1e3, "ms/frame");
+}
@@ -0,0 +1,200 @@
+#include "TestFramework.h"
+
+#include "SpriteBatch.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // Vertex storage for count sprites, 16-byte aligned as End requires.
+    class Vertices
+    {
+    public:
+        explicit Vertices(size_t spriteCount) : m_storage(4 * spriteCount + 1) {}
+
+        SpriteVertex* Get()
+        {
+            const uintptr_t address = reinterpret_cast<uintptr_t>(m_storage.data());
+            return reinterpret_cast<SpriteVertex*>((address + 15) & ~uintptr_t(15));
+        }
+
+    private:
+        std::vector<SpriteVertex> m_storage;
+    };
+
+    std::vector<Sprite> MakeSprites(size_t count, float maxAngle, TestRandom& random)
+    {
+        std::vector<Sprite> sprites(count);
+        for (Sprite& sprite : sprites)
+        {
+            sprite.X = random.NextBelow(20000) / 10.0f - 100;
+            sprite.Y = random.NextBelow(12000) / 10.0f - 100;
+            sprite.Width = 1 + random.NextBelow(2000) / 10.0f;
+            sprite.Height = 1 + random.NextBelow(2000) / 10.0f;
+            sprite.Rotation = (random.NextBelow(2000001) / 1000000.0f - 1) * maxAngle;
+            sprite.Color = static_cast<uint32_t>(random.Next());
+            sprite.UvMin = static_cast<uint32_t>(random.Next());
+            sprite.UvMax = static_cast<uint32_t>(random.Next() >> 32);
+        }
+        return sprites;
+    }
+}
+
+TEST(SpriteBatch, GoldenCorners)
+{
+    // 20x10 at (100, 50), upright and a quarter turn (the X axis turns to +Y, down the screen).
+    Sprite sprites[2] = {
+        { 100, 50, 20, 10, 0, 0xff0000ff, 0x00000000, 0xffffffff },
+        { 100, 50, 20, 10, 1.57079633f, 0x80808080, 0x20001000, 0x40003000 },
+    };
+    Vertices storage(2);
+    SpriteVertex* vertices = storage.Get();
+    ExpandSprites(sprites, 2, vertices);
+
+    const float expected[8][2] = {
+        { 90, 45 }, { 110, 45 }, { 90, 55 }, { 110, 55 },
+        { 105, 40 }, { 105, 60 }, { 95, 40 }, { 95, 60 },
+    };
+    for (int v = 0; v < 8; ++v)
+    {
+        CHECK(std::fabs(vertices[v].X - expected[v][0]) < 1e-4f);
+        CHECK(std::fabs(vertices[v].Y - expected[v][1]) < 1e-4f);
+        CHECK_EQUAL(sprites[v / 4].Color, vertices[v].Color);
+    }
+    CHECK_EQUAL(0x00000000u, vertices[0].Uv);
+    CHECK_EQUAL(0x0000ffffu, vertices[1].Uv);
+    CHECK_EQUAL(0xffff0000u, vertices[2].Uv);
+    CHECK_EQUAL(0xffffffffu, vertices[3].Uv);
+    CHECK_EQUAL(0x20001000u, vertices[4].Uv);
+    CHECK_EQUAL(0x20003000u, vertices[5].Uv);
+    CHECK_EQUAL(0x40001000u, vertices[6].Uv);
+    CHECK_EQUAL(0x40003000u, vertices[7].Uv);
+}
+
+TEST(SpriteBatch, KernelMatchesReference)
+{
+    // Counts that leave every remainder of the four-wide kernel, angles up to 100 radians.
+    TestRandom random;
+    for (size_t count : { size_t(1), size_t(2), size_t(3), size_t(4), size_t(7), size_t(50001) })
+    {
+        const std::vector<Sprite> sprites = MakeSprites(count, 100.0f, random);
+        Vertices kernelStorage(count);
+        Vertices referenceStorage(count);
+        SpriteVertex* kernel = kernelStorage.Get();
+        SpriteVertex* reference = referenceStorage.Get();
+        ExpandSprites(sprites.data(), count, kernel);
+        ExpandSpritesReference(sprites.data(), count, reference);
+
+        uint32_t mismatches = 0;
+        float worst = 0.0f;
+        for (size_t i = 0; i < 4 * count; ++i)
+        {
+            const Sprite& sprite = sprites[i / 4];
+            const float size = std::max(sprite.Width, sprite.Height);
+            worst = std::max(worst, std::fabs(kernel[i].X - reference[i].X) / size);
+            worst = std::max(worst, std::fabs(kernel[i].Y - reference[i].Y) / size);
+            mismatches += kernel[i].Uv == reference[i].Uv && kernel[i].Color == reference[i].Color ? 0 : 1;
+        }
+        CHECK_EQUAL(0u, mismatches);
+        CHECK(worst < 1e-4f);
+    }
+}
+
+TEST(SpriteBatch, Indices)
+{
+    // Two clockwise triangles (Y down) per quad, each quad on its own four vertices.
+    std::vector<uint16_t> indices(6 * SpriteBatch::MaxSpritesPerDraw);
+    BuildSpriteIndices(indices.data());
+    const uint16_t first[] = { 0, 1, 2, 2, 1, 3 };
+    CHECK(memcmp(indices.data(), first, sizeof(first)) == 0);
+    CHECK_EQUAL(65535, int(indices.back()));
+
+    const float corners[4][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } };
+    for (int t = 0; t < 2; ++t)
+    {
+        const float* a = corners[first[t * 3]];
+        const float* b = corners[first[t * 3 + 1]];
+        const float* c = corners[first[t * 3 + 2]];
+        CHECK((b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]) > 0);
+    }
+}
+
+TEST(SpriteBatch, Ranges)
+{
+    TestRandom random;
+    const std::vector<Sprite> sprites = MakeSprites(5000, 3.0f, random);
+    // Runs of textures 2, 2, 1, 2, 3, 1 and an empty one.
+    const uint32_t textures[] = { 2, 2, 1, 2, 3, 1, 4 };
+    const size_t counts[] = { 10, 1500, 3, 2000, 487, 1000, 0 };
+
+    SpriteBatch batch;
+    Vertices storage(5000);
+    for (bool sort : { false, true })
+    {
+        batch.Begin();
+        const Sprite* next = sprites.data();
+        for (int run = 0; run < 7; ++run)
+        {
+            batch.Draw(textures[run], next, counts[run]);
+            next += counts[run];
+        }
+        CHECK_EQUAL(size_t(5000), batch.GetSpriteCount());
+        batch.End(storage.Get(), sort);
+
+        // Unsorted: draw order, consecutive runs of one texture merged. Sorted: grouped by
+        // texture, each group in draw order.
+        const std::vector<SpriteBatchRange>& ranges = batch.GetRanges();
+        const SpriteBatchRange unsorted[] = { { 2, 0, 1510 }, { 1, 1510, 3 }, { 2, 1513, 2000 }, { 3, 3513, 487 }, { 1, 4000, 1000 } };
+        const SpriteBatchRange sorted[] = { { 1, 0, 1003 }, { 2, 1003, 3510 }, { 3, 4513, 487 } };
+        const SpriteBatchRange* expected = sort ? sorted : unsorted;
+        REQUIRE(ranges.size() == (sort ? 3u : 5u));
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            CHECK_EQUAL(expected[i].Texture, ranges[i].Texture);
+            CHECK_EQUAL(expected[i].FirstQuad, ranges[i].FirstQuad);
+            CHECK_EQUAL(expected[i].QuadCount, ranges[i].QuadCount);
+        }
+
+        // The quads follow the ranges: texture 1 sorted first is the run of 3, then the 1000.
+        const Sprite& firstQuad = sort ? sprites[1510] : sprites[0];
+        Vertices single(1);
+        ExpandSprites(&firstQuad, 1, single.Get());
+        CHECK(memcmp(single.Get(), storage.Get(), 4 * sizeof(SpriteVertex)) == 0);
+    }
+}
+
+TEST(SpriteBatch, PoolMatchesSingleThread)
+{
+    TestRandom random;
+    const std::vector<Sprite> sprites = MakeSprites(10000, 10.0f, random);
+    SpriteBatch batch;
+    Vertices single(10000);
+    Vertices pooled(10000);
+    batch.Begin();
+    batch.Draw(0, sprites.data(), 3333);
+    batch.Draw(1, sprites.data() + 3333, 6667);
+    batch.End(single.Get(), false);
+
+    ThreadPool pool(3);
+    batch.Begin();
+    batch.Draw(0, sprites.data(), 3333);
+    batch.Draw(1, sprites.data() + 3333, 6667);
+    batch.End(pooled.Get(), false, &pool);
+    CHECK(memcmp(single.Get(), pooled.Get(), 40000 * sizeof(SpriteVertex)) == 0);
+
+    bool threw = false;
+    try
+    {
+        batch.End(reinterpret_cast<SpriteVertex*>(reinterpret_cast<char*>(pooled.Get()) + 4), false);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
@@ -0,0 +1,82 @@
+#include "TestFramework.h"
+
+#include "SpscRing.h"
+
+#include <thread>
+
+TEST(SpscRing, FillAndDrain)
+{
+    SpscRing<uint32_t, 8> ring;
+    uint32_t value = 0;
+    CHECK(ring.Empty());
+    CHECK(!ring.TryPop(value));
+
+    // Several laps, so the indices wrap past the capacity.
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    for (int lap = 0; lap < 5; ++lap)
+    {
+        while (ring.TryPush(pushed))
+        {
+            ++pushed;
+        }
+        CHECK_EQUAL(popped + 8, pushed);
+        CHECK(!ring.Empty());
+
+        // Half out, then fill again: the ring holds 8 whatever the position.
+        for (int i = 0; i < 4; ++i)
+        {
+            REQUIRE(ring.TryPop(value));
+            CHECK_EQUAL(popped++, value);
+        }
+        CHECK(ring.TryPush(pushed++));
+        while (ring.TryPop(value))
+        {
+            CHECK_EQUAL(popped++, value);
+        }
+        CHECK_EQUAL(pushed, popped);
+        CHECK(ring.Empty());
+    }
+}
+
+TEST(SpscRing, TwoThreadsKeepOrder)
+{
+    // A small ring so the producer keeps finding it full and the consumer empty.
+    struct Item
+    {
+        uint64_t Sequence;
+        uint64_t Check;
+    };
+    const uint64_t ItemCount = 2000000;
+    SpscRing<Item, 64> ring;
+
+    std::thread producer([&ring]()
+    {
+        for (uint64_t i = 0; i < ItemCount; ++i)
+        {
+            const Item item = { i, ~i * 31 };
+            while (!ring.TryPush(item))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t outOfOrder = 0;
+    while (expected < ItemCount)
+    {
+        Item item;
+        if (!ring.TryPop(item))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        outOfOrder += item.Sequence != expected || item.Check != ~expected * 31;
+        ++expected;
+    }
+    producer.join();
+
+    CHECK_EQUAL(uint64_t(0), outOfOrder);
+    CHECK(ring.Empty());
+}
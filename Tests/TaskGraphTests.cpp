@@ -0,0 +1,195 @@
+#include "TestFramework.h"
+
+#include "TaskGraph.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void Spin(std::chrono::microseconds duration)
+    {
+        const auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+}
+
+TEST(TaskGraph, RunsAfterDependencies)
+{
+    for (uint32_t workers : { 0u, 3u })
+    {
+        ThreadPool pool(workers);
+        TaskGraph graph(&pool);
+
+        // A random graph: each task depends on up to three earlier ones.
+        const uint32_t TaskCount = 300;
+        std::unique_ptr<std::atomic<bool>[]> done(new std::atomic<bool>[TaskCount]);
+        std::vector<std::vector<TaskId>> dependencies(TaskCount);
+        std::atomic<uint32_t> violations(0);
+        TestRandom random(workers);
+        for (TaskId id = 0; id < TaskCount; ++id)
+        {
+            done[id] = false;
+            auto task = [&, id]()
+            {
+                for (TaskId dependency : dependencies[id])
+                {
+                    violations += done[dependency] ? 0 : 1;
+                }
+                Spin(std::chrono::microseconds(20));
+                done[id] = true;
+            };
+
+            const uint32_t count = id == 0 ? 0 : random.NextBelow(4);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                dependencies[id].push_back(random.NextBelow(id));
+            }
+            const std::vector<TaskId>& d = dependencies[id];
+            TaskId added;
+            switch (count)
+            {
+            case 0: added = graph.Add("task", task); break;
+            case 1: added = graph.Add("task", task, { d[0] }); break;
+            case 2: added = graph.Add("task", task, { d[0], d[1] }); break;
+            default: added = graph.Add("task", task, { d[0], d[1], d[2] }); break;
+            }
+            CHECK_EQUAL(id, added);
+        }
+        graph.Run();
+
+        CHECK_EQUAL(0u, violations.load());
+        bool allDone = true;
+        for (TaskId id = 0; id < TaskCount; ++id)
+        {
+            allDone &= done[id].load();
+        }
+        CHECK(allDone);
+
+        // The timings agree: nothing started before it was ready or before a dependency ended.
+        const std::vector<TaskTiming>& timings = graph.GetTimings();
+        REQUIRE(timings.size() == TaskCount);
+        bool ordered = true;
+        for (TaskId id = 0; id < TaskCount; ++id)
+        {
+            ordered &= timings[id].Ran && timings[id].ReadyNanoseconds <= timings[id].StartNanoseconds;
+            ordered &= timings[id].StartNanoseconds <= timings[id].EndNanoseconds;
+            for (TaskId dependency : dependencies[id])
+            {
+                ordered &= timings[dependency].EndNanoseconds <= timings[id].ReadyNanoseconds;
+            }
+        }
+        CHECK(ordered);
+    }
+}
+
+TEST(TaskGraph, CallerTasksRunOnCaller)
+{
+    ThreadPool pool(3);
+    TaskGraph graph(&pool);
+    const std::thread::id caller = std::this_thread::get_id();
+    std::atomic<uint32_t> wrongThread(0);
+    TaskId previous = graph.Add("first", []() {});
+    for (int i = 0; i < 50; ++i)
+    {
+        graph.Add("any", []() { Spin(std::chrono::microseconds(50)); }, { previous });
+        previous = graph.Add("caller", [&]() { wrongThread += std::this_thread::get_id() == caller ? 0 : 1; }, { previous }, TaskAffinity::Caller);
+    }
+    graph.Run();
+    CHECK_EQUAL(0u, wrongThread.load());
+
+    uint32_t onCaller = 0;
+    for (const TaskTiming& timing : graph.GetTimings())
+    {
+        onCaller += timing.OnCaller ? 1 : 0;
+    }
+    CHECK(onCaller >= 50);
+}
+
+TEST(TaskGraph, FailureSkipsDependents)
+{
+    for (uint32_t workers : { 0u, 2u })
+    {
+        ThreadPool pool(workers);
+        TaskGraph graph(&pool);
+        std::atomic<uint32_t> ran(0);
+        const TaskId root = graph.Add("root", [&]() { ++ran; });
+        const TaskId failing = graph.Add("failing", []() { throw std::runtime_error("load failed"); }, { root });
+        const TaskId child = graph.Add("child", [&]() { ++ran; }, { failing });
+        const TaskId grandchild = graph.Add("grandchild", [&]() { ++ran; }, { root, child });
+        const TaskId sibling = graph.Add("sibling", [&]() { ++ran; }, { root });
+
+        bool threw = false;
+        try
+        {
+            graph.Run();
+        }
+        catch (const std::runtime_error& error)
+        {
+            threw = std::string(error.what()) == "load failed";
+        }
+        CHECK(threw);
+        CHECK_EQUAL(2u, ran.load());
+
+        const std::vector<TaskTiming>& timings = graph.GetTimings();
+        CHECK(timings[root].Ran);
+        CHECK(!timings[child].Ran);
+        CHECK(!timings[grandchild].Ran);
+        CHECK(timings[sibling].Ran);
+    }
+}
+
+TEST(TaskGraph, RejectsInvalidGraphs)
+{
+    TaskGraph graph;
+    const TaskId first = graph.Add("first", []() {});
+    bool threw = false;
+    try
+    {
+        graph.Add("second", []() {}, { first + 1 });
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK_EQUAL(size_t(1), graph.GetTaskCount());
+
+    graph.Run();
+    threw = false;
+    try
+    {
+        graph.Add("late", []() {});
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(TaskGraph, CriticalPath)
+{
+    // a -> slow -> join and a -> fast -> join: the path goes through the slow branch.
+    ThreadPool pool(2);
+    TaskGraph graph(&pool);
+    const TaskId a = graph.Add("a", []() { Spin(std::chrono::microseconds(500)); });
+    const TaskId slow = graph.Add("slow", []() { Spin(std::chrono::milliseconds(20)); }, { a });
+    const TaskId fast = graph.Add("fast", []() { Spin(std::chrono::microseconds(500)); }, { a });
+    const TaskId join = graph.Add("join", []() {}, { fast, slow });
+    graph.Run();
+
+    const std::vector<TaskId> path = graph.GetCriticalPath();
+    REQUIRE(path.size() == 3);
+    CHECK_EQUAL(a, path[0]);
+    CHECK_EQUAL(slow, path[1]);
+    CHECK_EQUAL(join, path[2]);
+}
@@ -0,0 +1,86 @@
+#include "TestFramework.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+namespace
+{
+    struct TestCase
+    {
+        const char* Suite;
+        const char* Name;
+        TestFunction Function;
+    };
+
+    // Function local so registration from other files' static initializers finds it constructed.
+    std::vector<TestCase>& GetTestCases()
+    {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    size_t g_failures = 0;
+}
+
+TestRegistrar::TestRegistrar(const char* suite, const char* name, TestFunction function)
+{
+    GetTestCases().push_back({ suite, name, function });
+}
+
+void ReportFailure(const char* file, int line, const std::string& message)
+{
+    ++g_failures;
+    printf("  %s:%d: %s\n", file, line, message.c_str());
+}
+
+int main(int argc, char** argv)
+{
+    size_t run = 0;
+    size_t failed = 0;
+    for (const TestCase& test : GetTestCases())
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+        {
+            selected |= strcmp(argv[i], test.Suite) == 0;
+        }
+        if (!selected)
+        {
+            continue;
+        }
+
+        printf("%s.%s\n", test.Suite, test.Name);
+        fflush(stdout);
+        const size_t failuresBefore = g_failures;
+        const auto start = std::chrono::steady_clock::now();
+        try
+        {
+            test.Function();
+        }
+        catch (const TestAborted&)
+        {
+        }
+        catch (const std::exception& exception)
+        {
+            ReportFailure(__FILE__, __LINE__, std::string("unexpected exception: ") + exception.what());
+        }
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        ++run;
+        if (g_failures != failuresBefore)
+        {
+            ++failed;
+            printf("  FAILED (%.1f ms)\n", milliseconds);
+        }
+        else
+        {
+            printf("  ok (%.1f ms)\n", milliseconds);
+        }
+    }
+
+    printf("%zu tests, %zu failed\n", run, failed);
+    return run == 0 || failed != 0 ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+// Minimal test registry for the portable modules, so they can be checked on any platform without
+// a third-party framework.
+//
+// TEST(Suite, Name) defines a test; CHECK and CHECK_EQUAL record a failure and carry on,
+// REQUIRE stops the test. PortableTests runs every test, or those of the suites named on the
+// command line (one ctest entry per suite).
+
+typedef void (*TestFunction)();
+
+struct TestRegistrar
+{
+    TestRegistrar(const char* suite, const char* name, TestFunction function);
+};
+
+// Records a failed check; the test keeps running.
+void ReportFailure(const char* file, int line, const std::string& message);
+
+// Thrown by REQUIRE to stop the current test.
+struct TestAborted
+{
+};
+
+#define TEST(suite, name) \
+    static void suite##_##name(); \
+    static const TestRegistrar suite##_##name##Registrar(#suite, #name, &suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            ReportFailure(__FILE__, __LINE__, "CHECK(" #condition ")"); \
+        } \
+    } while (0)
+
+#define CHECK_EQUAL(expected, actual) \
+    do \
+    { \
+        const auto& checkExpected = (expected); \
+        const auto& checkActual = (actual); \
+        if (!(checkExpected == checkActual)) \
+        { \
+            std::ostringstream checkMessage; \
+            checkMessage << "CHECK_EQUAL(" #expected ", " #actual "): " << checkExpected << " != " << checkActual; \
+            ReportFailure(__FILE__, __LINE__, checkMessage.str()); \
+        } \
+    } while (0)
+
+#define REQUIRE(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            ReportFailure(__FILE__, __LINE__, "REQUIRE(" #condition ")"); \
+            throw TestAborted(); \
+        } \
+    } while (0)
+
+// Deterministic bytes (a 64-bit LCG, top byte of each step), the same for every run and platform.
+// Golden values in the tests were computed from this sequence with the reference libraries.
+class TestRandom
+{
+public:
+    explicit TestRandom(uint64_t seed = 0x9E3779B97F4A7C15ull) : m_state(seed) {}
+
+    uint64_t Next()
+    {
+        m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+        return m_state;
+    }
+    uint8_t NextByte() { return static_cast<uint8_t>(Next() >> 56); }
+    // Uniform enough in [0, bound) for tests.
+    uint32_t NextBelow(uint32_t bound) { return static_cast<uint32_t>((Next() >> 32) % bound); }
+
+private:
+    uint64_t m_state;
+};
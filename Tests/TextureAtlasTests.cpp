@@ -0,0 +1,231 @@
+#include "TestFramework.h"
+
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    struct TextureSizes
+    {
+        std::vector<uint32_t> Widths;
+        std::vector<uint32_t> Heights;
+    };
+
+    // Sprite and icon sized textures, powers of two and not.
+    TextureSizes MakeSizes(size_t count, uint32_t largest, uint64_t seed)
+    {
+        TestRandom random(seed);
+        TextureSizes sizes;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const bool powerOfTwo = random.NextBelow(2) == 0;
+            sizes.Widths.push_back(powerOfTwo ? 8u << random.NextBelow(4) : 1 + random.NextBelow(largest));
+            sizes.Heights.push_back(powerOfTwo ? 8u << random.NextBelow(4) : 1 + random.NextBelow(largest));
+        }
+        return sizes;
+    }
+
+    AtlasLayout Pack(const TextureSizes& sizes, const AtlasSettings& settings)
+    {
+        return PackTextureAtlas(sizes.Widths.data(), sizes.Heights.data(), sizes.Widths.size(), settings);
+    }
+
+    // Every packed placement has its size, is aligned for the mips with its gutter inside the
+    // page, and no two placements on a page overlap, gutters included.
+    bool CheckLayout(const AtlasLayout& layout, const TextureSizes& sizes, const AtlasSettings& settings)
+    {
+        const uint32_t alignment = 1u << (settings.MipLevels - 1);
+        const uint32_t gutter = layout.Gutter;
+        bool valid = layout.Placements.size() == sizes.Widths.size() && gutter == settings.Padding * alignment;
+
+        std::vector<std::vector<uint8_t>> pages(layout.PageCount, std::vector<uint8_t>(size_t(settings.PageWidth) * settings.PageHeight, 0));
+        uint32_t packed = 0;
+        for (size_t i = 0; i < layout.Placements.size() && valid; ++i)
+        {
+            const AtlasPlacement& placement = layout.Placements[i];
+            if (placement.Page == AtlasNotPacked)
+            {
+                continue;
+            }
+            ++packed;
+            valid &= placement.Page < layout.PageCount;
+            valid &= placement.Width == sizes.Widths[i] && placement.Height == sizes.Heights[i];
+            valid &= placement.X >= gutter && placement.Y >= gutter;
+            valid &= (placement.X - gutter) % alignment == 0 && (placement.Y - gutter) % alignment == 0;
+            valid &= placement.X + placement.Width + gutter <= settings.PageWidth;
+            valid &= placement.Y + placement.Height + gutter <= settings.PageHeight;
+            if (!valid)
+            {
+                break;
+            }
+
+            std::vector<uint8_t>& page = pages[placement.Page];
+            for (uint32_t y = placement.Y - gutter; y < placement.Y + placement.Height + gutter; ++y)
+            {
+                for (uint32_t x = placement.X - gutter; x < placement.X + placement.Width + gutter; ++x)
+                {
+                    valid &= page[size_t(y) * settings.PageWidth + x] == 0;
+                    page[size_t(y) * settings.PageWidth + x] = 1;
+                }
+            }
+        }
+        return valid && packed == layout.Stats.Packed;
+    }
+}
+
+TEST(TextureAtlas, PlacementsDoNotOverlap)
+{
+    for (uint32_t mipLevels = 1; mipLevels <= 4; ++mipLevels)
+    {
+        AtlasSettings settings;
+        settings.PageWidth = 512;
+        settings.PageHeight = 256;
+        settings.MipLevels = mipLevels;
+        const TextureSizes sizes = MakeSizes(300, 70, mipLevels);
+        const AtlasLayout layout = Pack(sizes, settings);
+        CHECK(CheckLayout(layout, sizes, settings));
+        CHECK_EQUAL(uint32_t(sizes.Widths.size()), layout.Stats.Packed);
+        CHECK_EQUAL(0u, layout.Stats.NotPacked);
+        CHECK(layout.PageCount > 1);
+    }
+}
+
+TEST(TextureAtlas, PacksDensely)
+{
+    // Equal squares fill a page exactly.
+    AtlasSettings settings;
+    settings.PageWidth = 256;
+    settings.PageHeight = 256;
+    settings.Padding = 0;
+    TextureSizes sizes;
+    sizes.Widths.assign(64, 32);
+    sizes.Heights.assign(64, 32);
+    const AtlasLayout layout = Pack(sizes, settings);
+    CHECK(CheckLayout(layout, sizes, settings));
+    CHECK_EQUAL(1u, layout.PageCount);
+
+    // Mixed sizes still use most of the area under the skylines.
+    settings.Padding = 1;
+    const TextureSizes mixed = MakeSizes(200, 40, 9);
+    const AtlasLayout mixedLayout = Pack(mixed, settings);
+    CHECK(CheckLayout(mixedLayout, mixed, settings));
+    CHECK(mixedLayout.Stats.TexelArea > mixedLayout.Stats.UsedArea * 6 / 10);
+    CHECK(mixedLayout.Stats.UsedArea <= mixedLayout.Stats.PageArea);
+}
+
+TEST(TextureAtlas, ReportsTexturesThatDoNotFit)
+{
+    AtlasSettings settings;
+    settings.PageWidth = 128;
+    settings.PageHeight = 128;
+    settings.MaxPages = 2;
+    TextureSizes sizes;
+    // Too wide once the gutter is added; then more 60x60 than two pages hold.
+    sizes.Widths = { 127, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60 };
+    sizes.Heights = { 10, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60 };
+    const AtlasLayout layout = Pack(sizes, settings);
+
+    CHECK(CheckLayout(layout, sizes, settings));
+    CHECK(layout.PageCount <= 2);
+    CHECK_EQUAL(AtlasNotPacked, layout.Placements[0].Page);
+    CHECK_EQUAL(8u, layout.Stats.Packed);
+    CHECK_EQUAL(3u, layout.Stats.NotPacked);
+    for (size_t i = 0; i < layout.Placements.size(); ++i)
+    {
+        if (layout.Placements[i].Page == AtlasNotPacked)
+        {
+            CHECK_EQUAL(1.0f, layout.Remaps[i].ScaleU);
+            CHECK_EQUAL(0.0f, layout.Remaps[i].OffsetU);
+        }
+    }
+}
+
+TEST(TextureAtlas, RejectsBadPages)
+{
+    AtlasSettings settings;
+    settings.PageWidth = 100;
+    settings.MipLevels = 4;
+    const uint32_t size = 8;
+    bool threw = false;
+    try
+    {
+        PackTextureAtlas(&size, &size, 1, settings);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(TextureAtlas, BlitExtendsEdgesIntoGutter)
+{
+    AtlasSettings settings;
+    settings.PageWidth = 64;
+    settings.PageHeight = 64;
+    settings.Padding = 2;
+    const uint32_t width = 5;
+    const uint32_t height = 3;
+    const AtlasLayout layout = PackTextureAtlas(&width, &height, 1, settings);
+    const AtlasPlacement& placement = layout.Placements[0];
+    REQUIRE(placement.Page == 0);
+
+    // Texel (x, y) holds y * 16 + x + 1; the page starts at zero.
+    std::vector<uint16_t> source(width * height);
+    for (uint32_t i = 0; i < width * height; ++i)
+    {
+        source[i] = static_cast<uint16_t>((i / width) * 16 + i % width + 1);
+    }
+    std::vector<uint16_t> page(64 * 64, 0);
+    BlitToAtlas(placement, layout.Gutter, source.data(), width * sizeof(uint16_t), sizeof(uint16_t), page.data(), 64 * sizeof(uint16_t));
+
+    const int gutter = static_cast<int>(layout.Gutter);
+    for (int y = 0; y < 64; ++y)
+    {
+        for (int x = 0; x < 64; ++x)
+        {
+            const int localX = x - static_cast<int>(placement.X);
+            const int localY = y - static_cast<int>(placement.Y);
+            uint16_t expected = 0;
+            if (localX >= -gutter && localX < static_cast<int>(width) + gutter && localY >= -gutter && localY < static_cast<int>(height) + gutter)
+            {
+                const int clampedX = std::min(std::max(localX, 0), static_cast<int>(width) - 1);
+                const int clampedY = std::min(std::max(localY, 0), static_cast<int>(height) - 1);
+                expected = source[clampedY * width + clampedX];
+            }
+            CHECK_EQUAL(expected, page[y * 64 + x]);
+        }
+    }
+}
+
+TEST(TextureAtlas, RemapsUvs)
+{
+    AtlasSettings settings;
+    settings.PageWidth = 256;
+    settings.PageHeight = 128;
+    const uint32_t widths[] = { 100, 30 };
+    const uint32_t heights[] = { 50, 20 };
+    const AtlasLayout layout = PackTextureAtlas(widths, heights, 2, settings);
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        const AtlasPlacement& placement = layout.Placements[i];
+        // Interleaved with a position, as in a vertex.
+        float vertices[3][4] = { { 9, 0, 0, 9 }, { 9, 1, 1, 9 }, { 9, 0.5f, 0.25f, 9 } };
+        RemapUvs(layout.Remaps[i], &vertices[0][1], 3, sizeof(vertices[0]));
+        for (const float* vertex : vertices)
+        {
+            CHECK_EQUAL(9.0f, vertex[0]);
+            CHECK_EQUAL(9.0f, vertex[3]);
+        }
+        CHECK(std::fabs(vertices[0][1] - float(placement.X) / 256) < 1e-6f);
+        CHECK(std::fabs(vertices[0][2] - float(placement.Y) / 128) < 1e-6f);
+        CHECK(std::fabs(vertices[1][1] - float(placement.X + placement.Width) / 256) < 1e-6f);
+        CHECK(std::fabs(vertices[1][2] - float(placement.Y + placement.Height) / 128) < 1e-6f);
+        CHECK(std::fabs(vertices[2][1] - (placement.X + placement.Width * 0.5f) / 256) < 1e-6f);
+    }
+}
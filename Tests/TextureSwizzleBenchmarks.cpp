@@ -0,0 +1,33 @@
+#include "BenchmarkFramework.h"
+
+#include "TextureSwizzle.h"
+
+#include <string>
+#include <vector>
+
+BENCHMARK(TextureSwizzle, Throughput)
+{
+    // A 4096x4096 RGBA8 texture (64 MB), and a BC1 one (8 MB of blocks).
+    struct Case
+    {
+        const char* Name;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t ElementSize;
+    };
+    const Case cases[] = { { "RGBA8 4096x4096", 4096, 4096, 4 }, { "BC1 4096x4096", 1024, 1024, 8 } };
+    for (const Case& c : cases)
+    {
+        const size_t bytes = size_t(c.Width) * c.Height * c.ElementSize;
+        std::vector<uint8_t> linear(bytes);
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            linear[i] = static_cast<uint8_t>(i * 7);
+        }
+        std::vector<uint8_t> tiled(static_cast<size_t>(GetStandardSwizzleSize(c.Width, c.Height, c.ElementSize)));
+        const size_t rowPitch = size_t(c.Width) * c.ElementSize;
+        Report((std::string(c.Name) + ", swizzle").c_str(), bytes / BestSeconds(5, [&]() { SwizzleStandard64KB(linear.data(), rowPitch, tiled.data(), c.Width, c.Height, c.ElementSize); }) / 1e9, "GB/s");
+        Report((std::string(c.Name) + ", unswizzle").c_str(), bytes / BestSeconds(5, [&]() { UnswizzleStandard64KB(tiled.data(), linear.data(), rowPitch, c.Width, c.Height, c.ElementSize); }) / 1e9, "GB/s");
+        Report((std::string(c.Name) + ", reference swizzle").c_str(), bytes / BestSeconds(1, [&]() { SwizzleStandard64KBReference(linear.data(), rowPitch, tiled.data(), c.Width, c.Height, c.ElementSize); }) / 1e9, "GB/s");
+    }
+}
@@ -0,0 +1,146 @@
+#include "TestFramework.h"
+
+#include "TextureSwizzle.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    const uint32_t ElementSizes[] = { 1, 2, 4, 8, 16 };
+
+    std::vector<uint8_t> MakeLinear(size_t rowPitch, uint32_t height, TestRandom& random)
+    {
+        std::vector<uint8_t> linear(rowPitch * height);
+        for (uint8_t& byte : linear)
+        {
+            byte = random.NextByte();
+        }
+        return linear;
+    }
+}
+
+TEST(TextureSwizzle, TileShapes)
+{
+    // 64KB tiles, square or twice as wide as high.
+    const uint32_t widths[] = { 256, 256, 128, 128, 64 };
+    const uint32_t heights[] = { 256, 128, 128, 64, 64 };
+    for (int i = 0; i < 5; ++i)
+    {
+        uint32_t tileWidth, tileHeight;
+        GetStandardSwizzleTileShape(ElementSizes[i], tileWidth, tileHeight);
+        CHECK_EQUAL(widths[i], tileWidth);
+        CHECK_EQUAL(heights[i], tileHeight);
+        CHECK_EQUAL(65536u, tileWidth * tileHeight * ElementSizes[i]);
+    }
+    CHECK_EQUAL(uint64_t(65536), GetStandardSwizzleSize(1, 1, 4));
+    CHECK_EQUAL(uint64_t(65536), GetStandardSwizzleSize(128, 128, 4));
+    CHECK_EQUAL(uint64_t(4 * 65536), GetStandardSwizzleSize(129, 129, 4));
+    CHECK_EQUAL(uint64_t(12 * 65536), GetStandardSwizzleSize(1000, 600, 1));
+
+    bool threw = false;
+    try
+    {
+        uint32_t tileWidth, tileHeight;
+        GetStandardSwizzleTileShape(3, tileWidth, tileHeight);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(TextureSwizzle, GoldenAddresses)
+{
+    // 32-bit elements: 16 bytes of a row stay together, then the coordinate bits interleave y
+    // first: element (0, 1) is the next 16 bytes, (4, 0) comes after the 4x4 block.
+    const uint32_t width = 128;
+    const uint32_t height = 128;
+    std::vector<uint32_t> linear(width * height);
+    for (uint32_t i = 0; i < width * height; ++i)
+    {
+        linear[i] = i;
+    }
+    std::vector<uint32_t> tiled(16384);
+    SwizzleStandard64KBReference(linear.data(), width * 4, tiled.data(), width, height, 4);
+    CHECK_EQUAL(0u, tiled[0]);
+    CHECK_EQUAL(3u, tiled[3]);
+    CHECK_EQUAL(width, tiled[4]);
+    CHECK_EQUAL(width * 3 + 3, tiled[15]);
+    CHECK_EQUAL(4u, tiled[16]);
+    CHECK_EQUAL(width * 4, tiled[32]);
+}
+
+TEST(TextureSwizzle, KernelsMatchReference)
+{
+    // Every element size over sizes that are and are not whole tiles, into destinations that
+    // are and are not 16-byte aligned (streaming stores or not). The padding is zeroed.
+    TestRandom random;
+    const uint32_t sizes[][2] = { { 1, 1 }, { 3, 5 }, { 64, 64 }, { 257, 130 }, { 300, 70 }, { 17, 400 } };
+    size_t failures = 0;
+    for (uint32_t elementSize : ElementSizes)
+    {
+        for (const auto& size : sizes)
+        {
+            const uint32_t width = size[0];
+            const uint32_t height = size[1];
+            const size_t rowPitch = width * elementSize + 8 * (width % 3);
+            const std::vector<uint8_t> linear = MakeLinear(rowPitch, height, random);
+            const size_t tiledSize = static_cast<size_t>(GetStandardSwizzleSize(width, height, elementSize));
+
+            std::vector<uint8_t> expected(tiledSize, 0);
+            SwizzleStandard64KBReference(linear.data(), rowPitch, expected.data(), width, height, elementSize);
+            for (size_t offset : { size_t(0), size_t(4) })
+            {
+                std::vector<uint8_t> storage(tiledSize + 32, 0xCD);
+                uint8_t* tiled = storage.data() + (16 - reinterpret_cast<uintptr_t>(storage.data()) % 16) + offset;
+                SwizzleStandard64KB(linear.data(), rowPitch, tiled, width, height, elementSize);
+                failures += memcmp(tiled, expected.data(), tiledSize) == 0 ? 0 : 1;
+
+                // Back to rows; the bytes past each row are left alone.
+                std::vector<uint8_t> rows(rowPitch * height, 0xEE);
+                std::vector<uint8_t> referenceRows(rowPitch * height, 0xEE);
+                UnswizzleStandard64KB(tiled, rows.data(), rowPitch, width, height, elementSize);
+                UnswizzleStandard64KBReference(expected.data(), referenceRows.data(), rowPitch, width, height, elementSize);
+                failures += rows == referenceRows ? 0 : 1;
+                for (uint32_t y = 0; y < height; ++y)
+                {
+                    failures += memcmp(rows.data() + y * rowPitch, linear.data() + y * rowPitch, width * elementSize) == 0 ? 0 : 1;
+                    for (size_t x = width * elementSize; x < rowPitch; ++x)
+                    {
+                        failures += rows[y * rowPitch + x] == 0xEE ? 0 : 1;
+                    }
+                }
+            }
+        }
+    }
+    CHECK_EQUAL(size_t(0), failures);
+}
+
+TEST(TextureSwizzle, EveryChunkOnce)
+{
+    // Tiling is a permutation: 16-byte chunks numbered in rows come out each exactly once.
+    const uint32_t width = 200;
+    const uint32_t height = 150;
+    std::vector<uint32_t> linear(width * height);
+    for (uint32_t i = 0; i < width * height; ++i)
+    {
+        linear[i] = i + 1;
+    }
+    std::vector<uint32_t> tiled(static_cast<size_t>(GetStandardSwizzleSize(width, height, 4) / 4));
+    SwizzleStandard64KB(linear.data(), width * 4, tiled.data(), width, height, 4);
+    std::vector<uint32_t> seen(width * height + 1, 0);
+    for (uint32_t value : tiled)
+    {
+        ++seen[value];
+    }
+    bool once = true;
+    for (uint32_t i = 1; i <= width * height; ++i)
+    {
+        once &= seen[i] == 1;
+    }
+    CHECK(once);
+    CHECK_EQUAL(tiled.size() - width * height, size_t(seen[0]));
+}
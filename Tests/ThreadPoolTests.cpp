@@ -0,0 +1,113 @@
+#include "TestFramework.h"
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+    // Runs a ParallelFor over [0, count) and checks each index ran exactly once, in chunks of at
+    // most grainSize; a pool without workers takes the whole range in one call.
+    bool RunsEachIndexOnce(ThreadPool& pool, size_t count, size_t grainSize)
+    {
+        const size_t largestChunk = pool.GetConcurrency() == 1 ? count : grainSize;
+        std::unique_ptr<std::atomic<uint32_t>[]> runs(new std::atomic<uint32_t>[count]);
+        for (size_t i = 0; i < count; ++i)
+        {
+            runs[i] = 0;
+        }
+        std::atomic<bool> badChunk(false);
+        pool.ParallelFor(count, grainSize, [&](size_t begin, size_t end)
+        {
+            badChunk = badChunk || begin >= end || end - begin > largestChunk || end > count;
+            for (size_t i = begin; i < end && i < count; ++i)
+            {
+                ++runs[i];
+            }
+        });
+
+        bool once = !badChunk;
+        for (size_t i = 0; i < count; ++i)
+        {
+            once &= runs[i] == 1;
+        }
+        return once;
+    }
+}
+
+TEST(ThreadPool, ParallelForRunsEachIndexOnce)
+{
+    for (uint32_t workers : { 0u, 1u, 3u })
+    {
+        ThreadPool pool(workers);
+        CHECK_EQUAL(workers + 1, pool.GetConcurrency());
+        CHECK(RunsEachIndexOnce(pool, 0, 16));
+        CHECK(RunsEachIndexOnce(pool, 1, 16));
+        CHECK(RunsEachIndexOnce(pool, 1000, 1));
+        CHECK(RunsEachIndexOnce(pool, 100000, 64));
+        CHECK(RunsEachIndexOnce(pool, 100001, 100000));
+    }
+}
+
+TEST(ThreadPool, NestedParallelFor)
+{
+    // Every outer chunk waits on an inner loop; the callers help, so nothing deadlocks even
+    // when there are more outer chunks than workers.
+    ThreadPool pool(2);
+    std::atomic<uint32_t> total(0);
+    pool.ParallelFor(16, 1, [&](size_t, size_t)
+    {
+        pool.ParallelFor(100, 7, [&](size_t begin, size_t end)
+        {
+            total += static_cast<uint32_t>(end - begin);
+        });
+    });
+    CHECK_EQUAL(1600u, total.load());
+}
+
+TEST(ThreadPool, ParallelForRethrows)
+{
+    ThreadPool pool(3);
+    std::atomic<uint32_t> chunks(0);
+    bool threw = false;
+    try
+    {
+        pool.ParallelFor(64, 1, [&](size_t begin, size_t)
+        {
+            ++chunks;
+            if (begin == 17)
+            {
+                throw std::runtime_error("chunk 17");
+            }
+        });
+    }
+    catch (const std::runtime_error& error)
+    {
+        threw = std::string(error.what()) == "chunk 17";
+    }
+    CHECK(threw);
+
+    // The pool is still usable.
+    CHECK(RunsEachIndexOnce(pool, 5000, 10));
+}
+
+TEST(ThreadPool, SubmitRunsEveryJob)
+{
+    std::atomic<uint32_t> ran(0);
+    {
+        ThreadPool pool(3);
+        for (int i = 0; i < 1000; ++i)
+        {
+            pool.Submit([&ran]() { ++ran; });
+        }
+        while (ran.load() != 1000)
+        {
+            std::this_thread::yield();
+        }
+    }
+    CHECK_EQUAL(1000u, ran.load());
+}
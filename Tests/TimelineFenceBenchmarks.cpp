@@ -0,0 +1,25 @@
+#include "BenchmarkFramework.h"
+
+#include "TimelineFence.h"
+
+#include <cstddef>
+
+BENCHMARK(TimelineFence, DeferredRelease)
+{
+    // A million releases, a new fence value every 1024 of them, then one collect: the cost per
+    // object of the queue itself.
+    SimulatedTimelineFence timeline;
+    DeferredReleaseQueue queue;
+    const size_t count = 1000000;
+    int object = 0;
+    const double seconds = BestSeconds(3, [&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            queue.Release(timeline, (i & 1023) == 0 ? timeline.Signal() : timeline.GetLastSignaledValue(), &object, [](void*) {});
+        }
+        timeline.Flush();
+        queue.Collect();
+    });
+    Report("Release + collect", count / seconds / 1e6, "M objects/s");
+}
@@ -0,0 +1,213 @@
+#include "TestFramework.h"
+
+#include "TimelineFence.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // A resource waiting in the queue: released once, and only after its fence value completed.
+    struct TrackedObject
+    {
+        SimulatedTimelineFence* Timeline;
+        uint64_t FenceValue;
+        std::atomic<uint32_t> Releases;
+        std::atomic<bool> ReleasedEarly;
+    };
+
+    void ReleaseTracked(void* object)
+    {
+        TrackedObject* tracked = static_cast<TrackedObject*>(object);
+        if (!tracked->Timeline->IsComplete(tracked->FenceValue))
+        {
+            tracked->ReleasedEarly = true;
+        }
+        ++tracked->Releases;
+    }
+
+    // COM style: the queue takes over a reference.
+    struct RefCounted
+    {
+        uint32_t References = 1;
+        void Release() { --References; }
+    };
+}
+
+TEST(TimelineFence, SignalAndComplete)
+{
+    SimulatedTimelineFence timeline;
+    CHECK_EQUAL(uint64_t(0), timeline.GetLastSignaledValue());
+    CHECK(timeline.IsComplete(0));
+
+    const uint64_t first = timeline.Signal();
+    const uint64_t second = timeline.Signal();
+    CHECK_EQUAL(uint64_t(1), first);
+    CHECK_EQUAL(uint64_t(2), second);
+    CHECK(!timeline.IsComplete(first));
+
+    timeline.Complete(first);
+    CHECK(timeline.IsComplete(first));
+    CHECK(!timeline.IsComplete(second));
+    CHECK_EQUAL(first, timeline.GetCompletedValue());
+
+    // Values never go back.
+    timeline.Complete(second);
+    timeline.Complete(first);
+    CHECK_EQUAL(second, timeline.GetCompletedValue());
+
+    // A CPU wait on the simulated timeline completes the value, as the GPU would have.
+    const uint64_t third = timeline.Signal();
+    timeline.Wait(third);
+    CHECK(timeline.IsComplete(third));
+    timeline.Flush();
+    CHECK_EQUAL(uint64_t(4), timeline.GetCompletedValue());
+}
+
+TEST(TimelineFence, WaitReturnsWhenCompletedElsewhere)
+{
+    SimulatedTimelineFence timeline;
+    std::atomic<bool> started(false);
+    const uint64_t value = timeline.Signal();
+    std::thread gpu([&]()
+    {
+        started = true;
+        timeline.Complete(value);
+    });
+    timeline.Wait(value);
+    CHECK(timeline.IsComplete(value));
+    gpu.join();
+    CHECK(started);
+}
+
+TEST(TimelineFence, ReleasesInFenceOrder)
+{
+    SimulatedTimelineFence graphics;
+    SimulatedTimelineFence copy;
+    DeferredReleaseQueue queue;
+    RefCounted a;
+    RefCounted b;
+    RefCounted c;
+
+    queue.Release(graphics, graphics.Signal(), &a);
+    queue.Release(copy, copy.Signal(), &b);
+    queue.Release(graphics, graphics.Signal(), &c);
+    queue.Release<RefCounted>(graphics, graphics.GetLastSignaledValue(), nullptr);
+    CHECK_EQUAL(size_t(3), queue.GetPendingCount());
+    CHECK_EQUAL(size_t(0), queue.Collect());
+
+    graphics.Complete(1);
+    CHECK_EQUAL(size_t(1), queue.Collect());
+    CHECK_EQUAL(0u, a.References);
+    CHECK_EQUAL(1u, b.References);
+    CHECK_EQUAL(1u, c.References);
+
+    copy.Complete(1);
+    graphics.Complete(2);
+    CHECK_EQUAL(size_t(2), queue.Collect());
+    CHECK_EQUAL(0u, b.References);
+    CHECK_EQUAL(0u, c.References);
+    CHECK_EQUAL(size_t(0), queue.GetPendingCount());
+}
+
+TEST(TimelineFence, DestructorReleasesTheRest)
+{
+    SimulatedTimelineFence timeline;
+    RefCounted object;
+    {
+        DeferredReleaseQueue queue;
+        queue.Release(timeline, timeline.Signal(), &object);
+    }
+    CHECK_EQUAL(0u, object.References);
+}
+
+TEST(TimelineFence, StressMillionsOfDeferredFrees)
+{
+    // Producer threads queue 2M objects on three timelines while a simulated GPU completes the
+    // values and the main thread collects, as the render loop does. Values along a timeline
+    // reach the queue out of order when producers race each other; such entries may be released
+    // late, never early.
+    const uint32_t ProducerCount = 4;
+    const uint32_t ObjectsPerProducer = 500000;
+    const uint32_t ObjectCount = ProducerCount * ObjectsPerProducer;
+    const uint32_t TimelineCount = 3;
+
+    SimulatedTimelineFence timelines[TimelineCount];
+    std::unique_ptr<TrackedObject[]> objects(new TrackedObject[ObjectCount]);
+    DeferredReleaseQueue queue;
+    std::atomic<uint32_t> producersDone(0);
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < ProducerCount; ++p)
+    {
+        producers.emplace_back([&, p]()
+        {
+            TestRandom random(p + 1);
+            for (uint32_t i = 0; i < ObjectsPerProducer; ++i)
+            {
+                SimulatedTimelineFence& timeline = timelines[random.NextBelow(TimelineCount)];
+                // A new value now and then, as submissions would; the last one otherwise.
+                const uint64_t value = random.NextBelow(64) == 0 ? timeline.Signal() : timeline.GetLastSignaledValue();
+                TrackedObject& object = objects[p * ObjectsPerProducer + i];
+                object.Timeline = &timeline;
+                object.FenceValue = value;
+                object.Releases = 0;
+                object.ReleasedEarly = false;
+                queue.Release(timeline, value, &object, &ReleaseTracked);
+            }
+            ++producersDone;
+        });
+    }
+
+    // The GPU trails the signals a little.
+    std::atomic<bool> stopGpu(false);
+    std::thread gpu([&]()
+    {
+        while (!stopGpu)
+        {
+            for (SimulatedTimelineFence& timeline : timelines)
+            {
+                const uint64_t signaled = timeline.GetLastSignaledValue();
+                if (signaled > 2)
+                {
+                    timeline.Complete(signaled - 2);
+                }
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    size_t collected = 0;
+    while (producersDone.load() != ProducerCount)
+    {
+        collected += queue.Collect();
+        std::this_thread::yield();
+    }
+    for (std::thread& producer : producers)
+    {
+        producer.join();
+    }
+    stopGpu = true;
+    gpu.join();
+
+    // The end of the frame loop: wait for the GPU, then everything goes.
+    for (SimulatedTimelineFence& timeline : timelines)
+    {
+        timeline.Flush();
+    }
+    collected += queue.Collect();
+
+    CHECK_EQUAL(size_t(ObjectCount), collected);
+    CHECK_EQUAL(size_t(0), queue.GetPendingCount());
+    uint32_t notOnce = 0;
+    uint32_t early = 0;
+    for (uint32_t i = 0; i < ObjectCount; ++i)
+    {
+        notOnce += objects[i].Releases != 1 ? 1 : 0;
+        early += objects[i].ReleasedEarly ? 1 : 0;
+    }
+    CHECK_EQUAL(0u, notOnce);
+    CHECK_EQUAL(0u, early);
+}
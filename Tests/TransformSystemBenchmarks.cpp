@@ -0,0 +1,82 @@
+#include "BenchmarkFramework.h"
+
+#include "ThreadPool.h"
+#include "TransformSystem.h"
+
+#include <memory>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+    // The one-struct-per-object layout the system replaces, for comparison.
+    struct AosObject
+    {
+        uint32_t Parent;
+        XMFLOAT3 Position;
+        XMFLOAT4 Rotation;
+        float Scale;
+        XMFLOAT3 SpinAxis;
+        float SpinSpeed;
+        XMFLOAT3 LocalExtents;
+        XMFLOAT4X4 World;
+        XMFLOAT3 WorldCenter;
+        XMFLOAT3 WorldExtents;
+    };
+
+    const uint32_t ObjectCount = 100000;
+}
+
+BENCHMARK(TransformSystem, Update)
+{
+    // The sample's scene shape: spinning roots with a child each for one in ten.
+    TransformSystem system;
+    std::vector<AosObject> objects;
+    system.Reserve(ObjectCount);
+    const XMFLOAT4 identity(0.0f, 0.0f, 0.0f, 1.0f);
+    for (uint32_t i = 0; i < ObjectCount; ++i)
+    {
+        const uint32_t parent = i % 10 == 9 ? i - 1 : TransformSystem::NoParent;
+        const XMFLOAT3 position(float(i % 100), float(i / 100 % 100), float(i / 10000));
+        system.AddObject(parent, position, identity, 1.0f);
+        system.SetSpin(i, XMFLOAT3(0.0f, 1.0f, 0.0f), 1.0f);
+        system.SetLocalBounds(i, XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+        objects.push_back({ parent, position, identity, 1.0f, XMFLOAT3(0.0f, 1.0f, 0.0f), 1.0f, XMFLOAT3(1.0f, 1.0f, 1.0f), {}, {}, {} });
+    }
+    std::unique_ptr<ObjectConstants[]> constants(new ObjectConstants[ObjectCount]);
+    const XMMATRIX viewProjection = XMMatrixIdentity();
+
+    const double aos = BestSeconds(5, [&]()
+    {
+        for (uint32_t i = 0; i < ObjectCount; ++i)
+        {
+            AosObject& object = objects[i];
+            const XMVECTOR rotation = XMQuaternionNormalize(XMQuaternionMultiply(XMLoadFloat4(&object.Rotation),
+                XMQuaternionRotationNormal(XMLoadFloat3(&object.SpinAxis), object.SpinSpeed * 0.016f)));
+            XMStoreFloat4(&object.Rotation, rotation);
+            XMMATRIX world = XMMatrixAffineTransformation(XMVectorReplicate(object.Scale), XMVectorZero(), rotation, XMLoadFloat3(&object.Position));
+            if (object.Parent != TransformSystem::NoParent)
+            {
+                world = XMMatrixMultiply(world, XMLoadFloat4x4(&objects[object.Parent].World));
+            }
+            XMStoreFloat4x4(&object.World, world);
+            const XMVECTOR extents = XMLoadFloat3(&object.LocalExtents);
+            XMVECTOR worldExtents = XMVectorMultiply(XMVectorAbs(world.r[0]), XMVectorSplatX(extents));
+            worldExtents = XMVectorMultiplyAdd(XMVectorAbs(world.r[1]), XMVectorSplatY(extents), worldExtents);
+            worldExtents = XMVectorMultiplyAdd(XMVectorAbs(world.r[2]), XMVectorSplatZ(extents), worldExtents);
+            XMStoreFloat3(&object.WorldCenter, world.r[3]);
+            XMStoreFloat3(&object.WorldExtents, worldExtents);
+            XMStoreFloat4x4(&constants[i].WorldViewProjection, XMMatrixTranspose(XMMatrixMultiply(world, viewProjection)));
+            XMStoreFloat4x4(&constants[i].World, XMMatrixTranspose(world));
+        }
+    });
+    Report("AoS reference, 100K objects", ObjectCount / aos / 1e3, "objects/ms");
+
+    const double single = BestSeconds(5, [&]() { system.Update(0.016f, viewProjection, constants.get()); });
+    Report("SoA, 100K objects, 1 thread", ObjectCount / single / 1e3, "objects/ms");
+
+    ThreadPool pool;
+    const double pooled = BestSeconds(5, [&]() { system.Update(0.016f, viewProjection, constants.get(), &pool); });
+    Report("SoA, 100K objects, pool", ObjectCount / pooled / 1e3, "objects/ms");
+}
@@ -0,0 +1,216 @@
+#include "TestFramework.h"
+
+#include "ThreadPool.h"
+#include "TransformSystem.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+    // The straightforward layout the system replaces: one struct per object, and each world
+    // matrix computed from its parent's by walking the parents, in object order.
+    struct ReferenceObject
+    {
+        uint32_t Parent;
+        XMFLOAT3 Position;
+        XMFLOAT4 Rotation;
+        float Scale;
+        XMFLOAT3 SpinAxis;
+        float SpinSpeed;
+        XMFLOAT3 LocalCenter;
+        XMFLOAT3 LocalExtents;
+        XMFLOAT4X4 World;
+        XMFLOAT3 WorldCenter;
+        XMFLOAT3 WorldExtents;
+    };
+
+    void UpdateReference(std::vector<ReferenceObject>& objects, float deltaSeconds)
+    {
+        for (ReferenceObject& object : objects)
+        {
+            XMVECTOR rotation = XMLoadFloat4(&object.Rotation);
+            if (object.SpinSpeed != 0.0f)
+            {
+                rotation = XMQuaternionNormalize(XMQuaternionMultiply(rotation, XMQuaternionRotationAxis(XMLoadFloat3(&object.SpinAxis), object.SpinSpeed * deltaSeconds)));
+                XMStoreFloat4(&object.Rotation, rotation);
+            }
+            XMMATRIX world = XMMatrixScaling(object.Scale, object.Scale, object.Scale) * XMMatrixRotationQuaternion(rotation) *
+                XMMatrixTranslation(object.Position.x, object.Position.y, object.Position.z);
+            if (object.Parent != TransformSystem::NoParent)
+            {
+                world = world * XMLoadFloat4x4(&objects[object.Parent].World);
+            }
+            XMStoreFloat4x4(&object.World, world);
+
+            // The world box: the box around the eight transformed corners.
+            XMFLOAT3 lower(1e30f, 1e30f, 1e30f);
+            XMFLOAT3 upper(-1e30f, -1e30f, -1e30f);
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                const XMFLOAT3 local(
+                    object.LocalCenter.x + (corner & 1 ? object.LocalExtents.x : -object.LocalExtents.x),
+                    object.LocalCenter.y + (corner & 2 ? object.LocalExtents.y : -object.LocalExtents.y),
+                    object.LocalCenter.z + (corner & 4 ? object.LocalExtents.z : -object.LocalExtents.z));
+                XMFLOAT3 p;
+                XMStoreFloat3(&p, XMVector3Transform(XMLoadFloat3(&local), world));
+                lower = XMFLOAT3(std::fmin(lower.x, p.x), std::fmin(lower.y, p.y), std::fmin(lower.z, p.z));
+                upper = XMFLOAT3(std::fmax(upper.x, p.x), std::fmax(upper.y, p.y), std::fmax(upper.z, p.z));
+            }
+            object.WorldCenter = XMFLOAT3((lower.x + upper.x) * 0.5f, (lower.y + upper.y) * 0.5f, (lower.z + upper.z) * 0.5f);
+            object.WorldExtents = XMFLOAT3((upper.x - lower.x) * 0.5f, (upper.y - lower.y) * 0.5f, (upper.z - lower.z) * 0.5f);
+        }
+    }
+
+    float RandomFloat(TestRandom& random, float low, float high)
+    {
+        return low + (high - low) * random.NextBelow(10001) / 10000.0f;
+    }
+
+    // A random forest: about a third of the objects are roots, the rest hang under an earlier
+    // object, some four or five levels deep.
+    void MakeScene(uint32_t count, TransformSystem& system, std::vector<ReferenceObject>& reference)
+    {
+        TestRandom random(count);
+        system.Reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ReferenceObject object = {};
+            object.Parent = i == 0 || random.NextBelow(3) == 0 ? TransformSystem::NoParent : i - 1 - random.NextBelow(std::min(i, 8u));
+            object.Position = XMFLOAT3(RandomFloat(random, -5, 5), RandomFloat(random, -5, 5), RandomFloat(random, -5, 5));
+            XMStoreFloat4(&object.Rotation, XMQuaternionRotationAxis(XMVectorSet(RandomFloat(random, -1, 1), RandomFloat(random, -1, 1), 1.0f, 0.0f), RandomFloat(random, -3, 3)));
+            object.Scale = RandomFloat(random, 0.5f, 1.5f);
+            object.SpinAxis = XMFLOAT3(0.0f, 1.0f, 0.0f);
+            if (random.NextBelow(2) == 0)
+            {
+                XMStoreFloat3(&object.SpinAxis, XMVector3Normalize(XMVectorSet(RandomFloat(random, -1, 1), 1.0f, RandomFloat(random, -1, 1), 0.0f)));
+                object.SpinSpeed = RandomFloat(random, -2, 2);
+            }
+            object.LocalCenter = XMFLOAT3(RandomFloat(random, -1, 1), RandomFloat(random, -1, 1), RandomFloat(random, -1, 1));
+            object.LocalExtents = XMFLOAT3(RandomFloat(random, 0.1f, 2), RandomFloat(random, 0.1f, 2), RandomFloat(random, 0.1f, 2));
+            reference.push_back(object);
+
+            CHECK_EQUAL(i, system.AddObject(object.Parent, object.Position, object.Rotation, object.Scale));
+            if (object.SpinSpeed != 0.0f)
+            {
+                system.SetSpin(i, object.SpinAxis, object.SpinSpeed);
+            }
+            system.SetLocalBounds(i, object.LocalCenter, object.LocalExtents);
+        }
+    }
+
+    // Within 1e-4 of the larger magnitude: errors grow a little with every level.
+    bool Near(float expected, float actual)
+    {
+        return std::fabs(expected - actual) <= 1e-4f * std::fmax(1.0f, std::fabs(expected));
+    }
+
+    XMMATRIX MakeViewProjection()
+    {
+        return XMMatrixTranslation(0.0f, -2.0f, 30.0f) * XMMatrixPerspectiveFovLH(0.8f, 16.0f / 9.0f, 0.1f, 100.0f);
+    }
+}
+
+TEST(TransformSystem, MatchesReferenceAoS)
+{
+    const uint32_t count = 3000;
+    TransformSystem system;
+    std::vector<ReferenceObject> reference;
+    MakeScene(count, system, reference);
+    std::unique_ptr<ObjectConstants[]> constants(new ObjectConstants[count]);
+    const XMMATRIX viewProjection = MakeViewProjection();
+
+    uint32_t wrong = 0;
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        const float deltaSeconds = 1.0f / 60.0f * (frame + 1);
+        system.Update(deltaSeconds, viewProjection, constants.get());
+        UpdateReference(reference, deltaSeconds);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const ReferenceObject& expected = reference[i];
+            XMFLOAT4X4 worldViewProjection;
+            XMStoreFloat4x4(&worldViewProjection, XMMatrixTranspose(XMLoadFloat4x4(&expected.World) * viewProjection));
+            for (int r = 0; r < 4; ++r)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    wrong += Near(expected.World.m[r][c], system.GetWorld(i).m[r][c]) ? 0 : 1;
+                    // The constants hold the transposed matrices.
+                    wrong += Near(expected.World.m[r][c], constants[i].World.m[c][r]) ? 0 : 1;
+                    wrong += Near(worldViewProjection.m[r][c], constants[i].WorldViewProjection.m[r][c]) ? 0 : 1;
+                }
+            }
+            const XMFLOAT3& center = system.GetWorldCenter(i);
+            const XMFLOAT3& extents = system.GetWorldExtents(i);
+            wrong += Near(expected.WorldCenter.x, center.x) && Near(expected.WorldCenter.y, center.y) && Near(expected.WorldCenter.z, center.z) ? 0 : 1;
+            wrong += Near(expected.WorldExtents.x, extents.x) && Near(expected.WorldExtents.y, extents.y) && Near(expected.WorldExtents.z, extents.z) ? 0 : 1;
+        }
+    }
+    CHECK_EQUAL(0u, wrong);
+}
+
+TEST(TransformSystem, PoolMatchesSingleThread)
+{
+    const uint32_t count = 20000;
+    TransformSystem single;
+    TransformSystem pooled;
+    std::vector<ReferenceObject> unused;
+    MakeScene(count, single, unused);
+    unused.clear();
+    MakeScene(count, pooled, unused);
+
+    std::unique_ptr<ObjectConstants[]> singleConstants(new ObjectConstants[count]);
+    std::unique_ptr<ObjectConstants[]> pooledConstants(new ObjectConstants[count]);
+    memset(singleConstants.get(), 0, count * sizeof(ObjectConstants));
+    memset(pooledConstants.get(), 0, count * sizeof(ObjectConstants));
+    const XMMATRIX viewProjection = MakeViewProjection();
+
+    ThreadPool pool(3);
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        single.Update(0.016f, viewProjection, singleConstants.get());
+        pooled.Update(0.016f, viewProjection, pooledConstants.get(), &pool);
+    }
+    CHECK(memcmp(singleConstants.get(), pooledConstants.get(), count * sizeof(ObjectConstants)) == 0);
+    uint32_t different = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        different += memcmp(&single.GetWorld(i), &pooled.GetWorld(i), sizeof(XMFLOAT4X4)) == 0 ? 0 : 1;
+    }
+    CHECK_EQUAL(0u, different);
+}
+
+TEST(TransformSystem, ChildrenFollowParents)
+{
+    // A parent moved after its child was added still carries the child along.
+    TransformSystem system;
+    const XMFLOAT4 identity(0.0f, 0.0f, 0.0f, 1.0f);
+    const uint32_t parent = system.AddObject(TransformSystem::NoParent, XMFLOAT3(0.0f, 0.0f, 0.0f), identity, 2.0f);
+    const uint32_t child = system.AddObject(parent, XMFLOAT3(1.0f, 0.0f, 0.0f), identity, 1.0f);
+    system.SetLocalPosition(parent, XMFLOAT3(10.0f, 0.0f, 0.0f));
+    // Without constants, only the world state is updated.
+    system.Update(0.0f, XMMatrixIdentity(), nullptr);
+
+    // Scaled by the parent, then moved with it.
+    CHECK(Near(12.0f, system.GetWorld(child).m[3][0]));
+    CHECK(Near(2.0f, system.GetWorld(child).m[0][0]));
+
+    bool threw = false;
+    try
+    {
+        system.AddObject(5, XMFLOAT3(0.0f, 0.0f, 0.0f), identity, 1.0f);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK_EQUAL(2u, system.GetObjectCount());
+}
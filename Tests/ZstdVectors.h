@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cstdint>
+
+// Zstandard frames written by the reference library (libzstd 1.5), for CompressionTests.cpp.
+//   WordsLevel1/3/19: MakeWords(6000) at levels 1, 3 and 19; level 19 has a content checksum.
+//   RleRawWithSkippable: 1000 bytes of 'a' (an RLE block), a skippable frame, then
+//   MakeNoise(200) (a raw block): three frames in a row.
+
+namespace ZstdVectors
+{
+    const uint8_t WordsLevel1[] =
+    {
+        0x28, 0xB5, 0x2F, 0xFD, 0x60, 0x70, 0x16, 0x55, 0x2A, 0x00, 0x62, 0x08, 0x17, 0x16, 0xA0, 0x27,
+        0x6D, 0xC0, 0xB6, 0x37, 0x9B, 0xBA, 0xC9, 0x7B, 0x59, 0x28, 0x19, 0x49, 0x55, 0x55, 0xFC, 0x0F,
+        0x47, 0x05, 0xF4, 0x28, 0x3F, 0x65, 0x52, 0xB8, 0xB4, 0xF4, 0xC3, 0xD6, 0x92, 0x7E, 0x48, 0x3F,
+        0xAC, 0x56, 0x4B, 0x3F, 0xAC, 0x25, 0xFD, 0xD0, 0xD2, 0xB2, 0xF4, 0x43, 0xFA, 0x21, 0xFD, 0xB0,
+        0x96, 0x3D, 0x4E, 0x26, 0x9C, 0x55, 0xFA, 0x61, 0xE9, 0x87, 0xC6, 0x08, 0x9B, 0x81, 0x20, 0x00,
+        0x28, 0xD4, 0x30, 0x3F, 0xB5, 0x2C, 0x63, 0x8F, 0xF2, 0xDA, 0xCA, 0xA4, 0x70, 0x29, 0x5B, 0x56,
+        0xCB, 0xC7, 0xE7, 0x50, 0x06, 0x62, 0x18, 0x42, 0x35, 0x83, 0x34, 0xA8, 0x92, 0x9F, 0x82, 0x64,
+        0xD8, 0xEF, 0x42, 0x08, 0x20, 0x60, 0x48, 0x2A, 0x30, 0x4B, 0xE7, 0x01, 0x12, 0x40, 0xC0, 0x71,
+        0x39, 0xCF, 0x24, 0xA2, 0x49, 0x92, 0x0E, 0xF3, 0x18, 0xC1, 0x02, 0x8F, 0x4B, 0x7D, 0x41, 0x43,
+        0xB7, 0x7D, 0x55, 0xA0, 0x21, 0x2D, 0x36, 0xBE, 0x10, 0xF4, 0xDB, 0xB3, 0x05, 0xD8, 0x24, 0x2C,
+        0x84, 0x15, 0x6D, 0xE5, 0x43, 0x36, 0x38, 0x3B, 0xD5, 0xEF, 0xE8, 0xC5, 0x7E, 0xD4, 0x01, 0xBF,
+        0xAA, 0xF9, 0x83, 0x51, 0x09, 0x37, 0x0C, 0xA1, 0x33, 0x96, 0x2D, 0x1B, 0xBA, 0xBC, 0x1B, 0x33,
+        0x89, 0x8C, 0x76, 0xD2, 0x45, 0x45, 0xED, 0xD6, 0xE0, 0x53, 0xE7, 0x23, 0x1F, 0x16, 0x40, 0xF4,
+        0xF6, 0xC0, 0xF7, 0x92, 0xE9, 0xC9, 0x2E, 0xFC, 0x42, 0xAE, 0x52, 0x19, 0x76, 0x6F, 0x7C, 0xB4,
+        0xA1, 0x0D, 0x98, 0x3E, 0x00, 0x9B, 0x31, 0x51, 0x0A, 0x67, 0x5C, 0x7A, 0x07, 0xA2, 0xEC, 0x01,
+        0x4C, 0x4D, 0x9B, 0x94, 0x59, 0x0C, 0x9A, 0x37, 0x80, 0xC4, 0xB2, 0xA9, 0x36, 0xBC, 0x23, 0xD5,
+        0x1D, 0x05, 0x52, 0xB0, 0xDD, 0xA7, 0x9C, 0xC1, 0x8F, 0xB6, 0x29, 0x56, 0xCA, 0xDD, 0x6A, 0xD2,
+        0x15, 0xD5, 0x14, 0x33, 0xF6, 0x16, 0xFF, 0x14, 0x14, 0x81, 0x43, 0xC7, 0xEB, 0x78, 0xAC, 0x55,
+        0x2B, 0x41, 0x1D, 0x73, 0x46, 0xF9, 0x12, 0x81, 0x88, 0x77, 0xD0, 0xA9, 0x99, 0xCB, 0xFE, 0x20,
+        0xE7, 0xA1, 0x6D, 0xAB, 0xD1, 0x1B, 0xF1, 0x34, 0xBB, 0x0A, 0x09, 0xDD, 0x85, 0x18, 0x98, 0x5D,
+        0x3D, 0xE3, 0x56, 0xB7, 0xE4, 0x73, 0x30, 0x30, 0x90, 0x58, 0xA0, 0x01, 0xEE, 0x55, 0x84, 0x80,
+        0x72, 0x59, 0xFD, 0x5A, 0x3D, 0x93, 0x00, 0xDB, 0xF8, 0xC8, 0x08, 0x1D, 0xE4, 0xC7, 0x85, 0x95,
+        0x6A, 0x3D, 0x82, 0xB2, 0xFB, 0xA2, 0x9D, 0x2F, 0x44, 0x64, 0xA5, 0xE6, 0xD3, 0x0D, 0x4D, 0xD7,
+        0xCB, 0xF2, 0xE5, 0x46, 0x98, 0x00, 0x58, 0x43, 0x7A, 0x56, 0xFA, 0xF1, 0x99, 0x59, 0x15, 0x4C,
+        0x56, 0x06, 0xDC, 0x91, 0x5D, 0x3D, 0x64, 0x11, 0x29, 0xFC, 0xAB, 0xB5, 0xB2, 0x4C, 0x53, 0xDB,
+        0x7D, 0x54, 0x93, 0xDE, 0x90, 0x48, 0xD8, 0x44, 0x83, 0x81, 0x13, 0x31, 0x97, 0x36, 0x69, 0x7B,
+        0x2A, 0x16, 0xB4, 0xD6, 0x5B, 0xF1, 0x2F, 0x1F, 0xC6, 0x74, 0x60, 0x1E, 0xC0, 0xDA, 0x78, 0x30,
+        0xC5, 0xB3, 0xA6, 0x14, 0x3E, 0xF4, 0xD8, 0x7D, 0x42, 0xFD, 0x28, 0x6D, 0xAE, 0x93, 0xD3, 0x16,
+        0x3B, 0xE7, 0x75, 0xD1, 0x85, 0xB3, 0x95, 0x9A, 0xA4, 0x64, 0x33, 0x84, 0xBC, 0x06, 0x8B, 0x54,
+        0xFB, 0x6D, 0x78, 0xBF, 0x82, 0x9E, 0x2A, 0x1D, 0x7F, 0x6D, 0x86, 0x72, 0xAC, 0x6B, 0xB1, 0x1A,
+        0xDC, 0x19, 0x95, 0x97, 0xAC, 0xBE, 0xBD, 0x02, 0x49, 0x1D, 0x30, 0x28, 0x1B, 0x81, 0x6B, 0x9E,
+        0x31, 0xBA, 0x4A, 0xA6, 0x77, 0x4F, 0x70, 0x57, 0x75, 0xF8, 0xC7, 0x60, 0xF9, 0x04, 0x5F, 0x98,
+        0x21, 0x0C, 0x80, 0x56, 0x23, 0xA9, 0x01, 0x5D, 0x0F, 0x32, 0xE2, 0xAF, 0x06, 0xFB, 0x16, 0xAE,
+        0x4D, 0x3F, 0x3F, 0x3F, 0x50, 0xCD, 0xD8, 0xD4, 0x1F, 0x26, 0x5F, 0x0C, 0x6F, 0xC2, 0xFE, 0xF1,
+        0xC4, 0x2E, 0xE2, 0xE1, 0x13, 0x04, 0xC6, 0x49, 0xB7, 0x11, 0x3A, 0x42, 0xB9, 0x34, 0x96, 0xC0,
+        0x0E, 0xE1, 0x4E, 0xF1, 0x76, 0xA3, 0x6A, 0x46, 0x94, 0xCE, 0xB0, 0xAA, 0x72, 0x89, 0x1F, 0xF0,
+        0x2B, 0xE0, 0x97, 0x33, 0xDE, 0x36, 0x30, 0xA4, 0xE8, 0xF9, 0x22, 0x48, 0x9D, 0x1E, 0x43, 0xF1,
+        0x73, 0xA8, 0x8B, 0x91, 0x55, 0x7F, 0xF6, 0x64, 0x8B, 0x5F, 0x70, 0xFC, 0x31, 0xE5, 0x7C, 0x36,
+        0x02, 0xB5, 0x1C, 0x0C, 0x2E, 0x1D, 0x93, 0x40, 0xB2, 0xC1, 0x3C, 0x7F, 0xD2, 0xF1, 0xB4, 0xB5,
+        0xEF, 0xF5, 0x27, 0xA7, 0x79, 0x5B, 0x7E, 0x01, 0x1E, 0x53, 0x40, 0xAD, 0x15, 0xA3, 0xD0, 0xCF,
+        0xF3, 0xEE, 0xC1, 0xC2, 0xCA, 0xE2, 0x19, 0x46, 0x3E, 0xD7, 0x5D, 0x6A, 0xED, 0x05, 0xF9, 0x32,
+        0xF7, 0x71, 0xD1, 0x2E, 0xFD, 0x38, 0x08, 0x07, 0x3C, 0x00, 0xA7, 0x1E, 0x0A, 0x95, 0xE9, 0xBF,
+        0xE2, 0x59, 0xF5, 0x95, 0x88, 0x64, 0xA2, 0x10, 0xA0, 0xC4, 0x9B, 0x0B, 0x32, 0xF7, 0x78, 0x9F,
+        0x09, 0xEE, 0x30, 0x0B, 0xE3, 0xE0, 0x64, 0x28, 0xA0, 0x81, 0xCC, 0x4E, 0x87, 0x5F, 0x8B, 0x67,
+        0xCA, 0xEB, 0xEF, 0xEF, 0xDF, 0x4A, 0x86, 0x80, 0x6E, 0x4D, 0xDC, 0x7F, 0x90, 0x03, 0xCF, 0xC8,
+        0x48, 0xDC, 0x26, 0x21, 0x4C, 0x43, 0xC5, 0xFF, 0xB7, 0x1B, 0xA8, 0x2B, 0x5F, 0x02, 0x6B, 0x9B,
+        0x3A, 0xB8, 0x54, 0x76, 0xDC, 0x40, 0x73, 0xE2, 0x1F, 0xD1, 0x9D, 0xDF, 0x55, 0x34, 0x98, 0xA4,
+        0xA0, 0xDB, 0xFE, 0x14, 0x9B, 0x06, 0xD8, 0xE3, 0xAA, 0x75, 0xFA, 0xBC, 0x10, 0xB9, 0x9E, 0x1A,
+        0x7B, 0x8D, 0x21, 0xF0, 0x1C, 0x40, 0x36, 0x70, 0x34, 0xE2, 0x7A, 0x61, 0x30, 0x2A, 0x3C, 0xDC,
+        0xC2, 0xAF, 0x76, 0x42, 0x36, 0xA8, 0xC6, 0x0C, 0x07, 0x3D, 0x78, 0x76, 0xEB, 0x8C, 0x94, 0x6E,
+        0x19, 0x33, 0x59, 0xA5, 0x30, 0x85, 0x9B, 0x99, 0x04, 0xA3, 0x19, 0x4F, 0xD2, 0x64, 0x64, 0xDB,
+        0xEB, 0x10, 0x4F, 0xC2, 0x53, 0x7C, 0x70, 0x49, 0x56, 0xA1, 0xCD, 0xC0, 0x99, 0xA6, 0xC2, 0xEE,
+        0xC8, 0xEF, 0x73, 0x5C, 0xFF, 0xD1, 0x1D, 0x85, 0x0F, 0x35, 0xCE, 0x0C, 0xDC, 0xDD, 0x72, 0x95,
+        0x63, 0x83, 0x84, 0xF7, 0x2A, 0x70, 0x44, 0x86, 0xDB, 0x12, 0x11, 0x4E, 0x9C, 0x42, 0x2F, 0x5F,
+        0x6A, 0x8E, 0xD3, 0xA1, 0x44, 0x7B, 0x0E, 0xE6, 0x3E, 0x85, 0xE6, 0x3D, 0x42, 0x08, 0xBB, 0x41,
+        0x21, 0xC9, 0xE2, 0xAD, 0x2D, 0x0B, 0x1D, 0x63, 0x42, 0x3A, 0x14, 0x67, 0x22, 0x66, 0x26, 0x50,
+        0x2C, 0x51, 0xE5, 0x6A, 0x8D, 0xA8, 0xA5, 0x40, 0xB3, 0xAD, 0x62, 0xE6, 0x1B, 0xBB, 0x42, 0xA0,
+        0xFC, 0x06, 0xBF, 0x8A, 0xFA, 0xBE, 0x45, 0xCB, 0xE1, 0xC5, 0x34, 0xD9, 0x72, 0xFE, 0x1B, 0x82,
+        0xCC, 0x4C, 0x8B, 0x82, 0xB5, 0x4B, 0x1A, 0x84, 0xF7, 0x60, 0xFC, 0x2A, 0xA6, 0x16, 0xB9, 0xB0,
+        0x83, 0x65, 0xA5, 0x3B, 0x58, 0x2C, 0x4F, 0x32, 0x74, 0x51, 0xA1, 0x3C, 0x40, 0x54, 0x20, 0xA8,
+        0x83, 0x43, 0xF8, 0xAE, 0xB1, 0x20, 0x5D, 0xD1, 0x8F, 0xC5, 0x01, 0xD7, 0x11, 0x6B, 0x6A, 0x60,
+        0xFF, 0xF8, 0xD1, 0x46, 0x12, 0xF5, 0x57, 0xCA, 0xD8, 0x2C, 0x20, 0x4F, 0x95, 0x1C, 0xFF, 0x10,
+        0xB3, 0x49, 0xC2, 0xEC, 0x22, 0x30, 0x4B, 0xFB, 0x1C, 0x99, 0xD2, 0xBA, 0x9E, 0x3E, 0xC8, 0xB5,
+        0x47, 0x40, 0xCB, 0x6E, 0x10, 0xB0, 0xD1, 0x94, 0x1A, 0x80, 0xE5, 0x60, 0xA0, 0xA8, 0xDC, 0x7F,
+        0xA1, 0xA0, 0x92, 0x73, 0x63, 0x63, 0x57, 0x30, 0x1C, 0x55, 0x89, 0xB9, 0x58, 0xA0, 0x03, 0x9C,
+        0x25, 0x43, 0x7F, 0x79, 0xB0, 0x3F, 0x22, 0x40, 0x8C, 0x5D, 0x2D, 0x06, 0xA9, 0xD6, 0x7A, 0xD5,
+        0x98, 0xDD, 0x09, 0xD0, 0xC9, 0xCB, 0x05, 0x8D, 0xC8, 0x0D, 0xBE, 0x37, 0x6A, 0xA3, 0x93, 0x9E,
+        0xBD, 0xE6, 0x3C, 0x81, 0x5E, 0x6B, 0xBD, 0x06, 0x50, 0x24, 0xA5, 0x6A, 0x64, 0xFC, 0x15, 0x15,
+        0x90, 0x14, 0x48, 0xC1, 0x83, 0x11, 0xF9, 0x50, 0x27, 0x3F, 0x2D, 0xD1, 0x9D, 0xB5, 0x2F, 0x0E,
+        0xD1, 0x22, 0x10, 0xD3, 0xE3, 0xA9, 0x08, 0x46, 0x64, 0xE3, 0x74, 0xCA, 0xB1, 0xC0, 0x46, 0x65,
+        0x4C, 0x77, 0xF9, 0x92, 0x81, 0xCC, 0x69, 0x3C, 0x53, 0x90, 0xD1, 0x0B, 0x39, 0x28, 0x7E, 0x2E,
+        0x0A, 0x05, 0xA8, 0x23, 0x6F, 0x68, 0xCA, 0xD9, 0xC3, 0x81, 0xC3, 0xF2, 0xF8, 0x3C, 0x41, 0xA4,
+        0xA5, 0xAB, 0xB3, 0x00, 0x95, 0x84, 0x60, 0x7F, 0x89, 0x15, 0x35, 0x32, 0x97, 0x47, 0xED, 0x4A,
+        0x50, 0x52, 0x72, 0x9C, 0xEC, 0xE3, 0x9C, 0x85, 0xA8, 0xB4, 0x2D, 0x5B, 0x1F, 0x69, 0x25, 0x56,
+        0x28, 0xF6, 0xEB, 0x19, 0xCD, 0x68, 0x41, 0x40, 0x89, 0xC6, 0xD7, 0x42, 0x93, 0x9E, 0xF2, 0x6B,
+        0xD0, 0x9E, 0x40, 0x96, 0x75, 0x59, 0xC5, 0x0D, 0x33, 0x8D, 0x23, 0x7B, 0xBB, 0x59, 0xDC, 0x06,
+        0x5F, 0xEC, 0x61, 0x99, 0x0E, 0x5D, 0x4F, 0x74, 0x71, 0x33, 0xFB, 0xF3, 0x24, 0x28, 0x61, 0x8A,
+        0xC7, 0x29, 0xA0, 0xE6, 0x20, 0x01, 0x5E, 0x2E, 0x7F, 0xBD, 0x60, 0x7D, 0x02, 0xBF, 0x40, 0x2F,
+        0x86, 0xDB, 0x99, 0x0E, 0xDB, 0xBE, 0xB0, 0x6E, 0x59, 0x80, 0xC0, 0x48, 0xE8, 0x0C, 0x46, 0xD6,
+        0x2F, 0x22, 0xA1, 0x18, 0xDB, 0x89, 0xD1, 0x01, 0xD5, 0xFC, 0xC4, 0xB3, 0x24, 0x1E, 0x16, 0x99,
+        0xB6, 0xEF, 0xBC, 0x59, 0x61, 0xE3, 0x57, 0xF3, 0x6A, 0x30, 0x29, 0x93, 0x5D, 0x77, 0xDA, 0x8C,
+        0x11, 0x23, 0xCB, 0x57, 0x4F, 0x07, 0x2B, 0x5A, 0xCA, 0xEE, 0x11, 0xDF, 0xFA, 0xBA, 0xA9, 0xB3,
+        0xA9, 0x73, 0x4C, 0x8F, 0x93, 0x66, 0xB3, 0xCC, 0x6D, 0x8A, 0x6D, 0x50, 0x3C, 0x25, 0x7E, 0xA1,
+        0x27, 0x9B, 0x7E, 0x64, 0x0D, 0xB2, 0x54, 0x1A, 0xC1, 0x63, 0xD1, 0xDA, 0x18, 0x9C, 0x30, 0x81,
+        0xA5, 0x29, 0x20, 0x7C, 0xF2, 0xA1, 0xE0, 0xEE, 0x42, 0x2D, 0xB1, 0xC4, 0x7E, 0x96, 0x63, 0x0E,
+        0x9A, 0x24, 0x6F, 0x05,
+    };
+
+    const uint8_t WordsLevel3[] =
+    {
+        0x28, 0xB5, 0x2F, 0xFD, 0x60, 0x70, 0x16, 0xCD, 0x25, 0x00, 0x62, 0x04, 0x0F, 0x16, 0x90, 0xC5,
+        0x39, 0x00, 0x51, 0x88, 0xC9, 0xB6, 0xD5, 0x50, 0xD4, 0x66, 0xC9, 0xF2, 0xFF, 0x5B, 0x33, 0xF8,
+        0x18, 0xDB, 0x14, 0x20, 0x98, 0xB6, 0x6D, 0xBE, 0xCA, 0x15, 0xF8, 0x72, 0x80, 0x08, 0xBA, 0x03,
+        0x7E, 0x05, 0x31, 0x08, 0x87, 0xD3, 0x61, 0x1A, 0x59, 0x1D, 0xF4, 0xAD, 0x37, 0xCA, 0x4F, 0x6F,
+        0xAB, 0xEE, 0xF3, 0xB9, 0x34, 0x31, 0xE9, 0x8C, 0x3A, 0x82, 0x59, 0xA8, 0xA2, 0x5F, 0x92, 0xB4,
+        0x7F, 0x06, 0x32, 0x08, 0x20, 0x20, 0x18, 0x12, 0x0F, 0x54, 0x69, 0xD8, 0x07, 0x12, 0xE0, 0x70,
+        0x60, 0x14, 0x11, 0x22, 0x41, 0x5B, 0xD2, 0x24, 0xC9, 0x70, 0x63, 0x92, 0x4D, 0x1F, 0x9A, 0x25,
+        0xEC, 0xE9, 0x2B, 0xE0, 0xA8, 0xD0, 0x1E, 0x39, 0xA0, 0xB0, 0x88, 0x62, 0xD6, 0x3C, 0x92, 0x35,
+        0x1E, 0x24, 0x77, 0xEA, 0x44, 0x7B, 0xB5, 0xA2, 0x1B, 0xBE, 0x63, 0x69, 0x39, 0x2F, 0xEC, 0x04,
+        0xF9, 0x17, 0x39, 0x7B, 0x69, 0x79, 0x54, 0xA9, 0x80, 0xF9, 0x8F, 0x78, 0x87, 0xC3, 0x10, 0x89,
+        0xF5, 0xBF, 0xFC, 0x5C, 0xAE, 0xD1, 0x89, 0x1F, 0x9E, 0x6E, 0x1A, 0x6C, 0x5A, 0x46, 0x60, 0xDF,
+        0xF5, 0xC6, 0xCA, 0xEA, 0x95, 0x42, 0xB7, 0xC6, 0x7F, 0x9C, 0xA1, 0xC3, 0x66, 0x71, 0x9E, 0x8A,
+        0xC3, 0xD4, 0x36, 0x49, 0x81, 0x38, 0x7F, 0x68, 0x21, 0x6E, 0xB8, 0x11, 0x3D, 0x6E, 0x82, 0x99,
+        0x6E, 0x77, 0x89, 0xD7, 0x57, 0xA8, 0x20, 0xAC, 0x63, 0x9F, 0x6E, 0xA9, 0xB6, 0xD9, 0x42, 0x46,
+        0x1A, 0x8B, 0x37, 0xA2, 0x7D, 0x38, 0x05, 0xE9, 0x15, 0x19, 0xE8, 0x3A, 0xBA, 0xC6, 0x98, 0x9D,
+        0x6E, 0x20, 0x1A, 0x9B, 0x0B, 0x11, 0x14, 0x8C, 0xDD, 0xA0, 0x0D, 0x3B, 0x1E, 0xF0, 0xCE, 0x31,
+        0x8B, 0xC6, 0xEC, 0x64, 0x53, 0x54, 0xC0, 0x6F, 0x1D, 0xDC, 0x49, 0x88, 0x87, 0x6A, 0x4D, 0x04,
+        0xA5, 0xED, 0x55, 0xAF, 0xCE, 0x08, 0x37, 0x84, 0x69, 0xE6, 0x4B, 0xA0, 0x0F, 0xC1, 0xC3, 0xF5,
+        0x1E, 0x8A, 0x86, 0x99, 0xA6, 0x04, 0x8B, 0xF7, 0xD9, 0xF6, 0xA6, 0x59, 0x65, 0xE2, 0xB5, 0xCB,
+        0xCC, 0x42, 0xF7, 0xC2, 0xF7, 0x9A, 0xF0, 0x8E, 0x8F, 0x86, 0x11, 0x0E, 0x29, 0x46, 0xC4, 0x33,
+        0x01, 0x0B, 0xA4, 0x85, 0x6C, 0xCB, 0x45, 0x97, 0x06, 0xCE, 0x02, 0x41, 0xE2, 0xA7, 0x8F, 0x98,
+        0xE6, 0xF1, 0xA3, 0x79, 0x03, 0xAA, 0x19, 0x01, 0x3D, 0x09, 0x2C, 0x38, 0x57, 0xBF, 0x4C, 0xE8,
+        0x43, 0x51, 0xDE, 0x88, 0x23, 0xDF, 0xBB, 0x94, 0x2D, 0x43, 0x8F, 0x09, 0x31, 0x4A, 0xA6, 0x51,
+        0x0C, 0xE6, 0xC4, 0x3E, 0x74, 0xE9, 0xED, 0x0C, 0xF1, 0xAF, 0x41, 0x49, 0xEF, 0xCD, 0x3C, 0xB1,
+        0x2F, 0xA8, 0x46, 0x78, 0x9F, 0x27, 0x5F, 0xC9, 0x3E, 0x77, 0x85, 0x49, 0x98, 0xDA, 0x0C, 0x04,
+        0xB0, 0xE5, 0xCA, 0xC8, 0xBB, 0xD6, 0x0D, 0x17, 0x66, 0x67, 0xCF, 0xDF, 0x54, 0x73, 0x12, 0x85,
+        0x3D, 0x48, 0xE5, 0x36, 0xAB, 0x0A, 0x0B, 0xBD, 0x59, 0x40, 0xE6, 0xDE, 0xF8, 0x98, 0x81, 0x8E,
+        0x01, 0xC2, 0xA9, 0x43, 0x30, 0x4F, 0x8D, 0xEE, 0xA8, 0xDD, 0x48, 0x80, 0xE2, 0x9A, 0x1E, 0x62,
+        0x5C, 0xD6, 0x79, 0x74, 0xB1, 0x45, 0xF3, 0xD5, 0xA6, 0x5B, 0x2C, 0x08, 0xB3, 0x55, 0x49, 0x92,
+        0xD7, 0x24, 0xA0, 0x95, 0xC2, 0x8A, 0xC1, 0xFF, 0x2F, 0xDD, 0x8E, 0xBD, 0xA6, 0x99, 0xA2, 0x05,
+        0x25, 0xF1, 0x20, 0x88, 0x2D, 0x82, 0x3F, 0x17, 0x72, 0xC3, 0xFD, 0x4F, 0xD9, 0x18, 0xA8, 0x84,
+        0x89, 0x78, 0x32, 0x74, 0x80, 0xD9, 0xEA, 0x74, 0xAE, 0xC2, 0xFE, 0xAD, 0x72, 0x9D, 0x70, 0xE1,
+        0x60, 0xC2, 0xF5, 0x86, 0x48, 0xB0, 0x8E, 0x75, 0x90, 0x0E, 0x46, 0x00, 0x79, 0x1E, 0x99, 0xEC,
+        0x70, 0x99, 0xD8, 0x8E, 0x80, 0x2D, 0x30, 0xB3, 0x18, 0xAA, 0xB1, 0xF1, 0x44, 0xC8, 0xFD, 0x86,
+        0xA7, 0x67, 0xA4, 0x1D, 0xE2, 0x57, 0x5B, 0x67, 0x70, 0x2C, 0xD0, 0x14, 0x49, 0x6E, 0xA6, 0x4C,
+        0xE4, 0x8E, 0x60, 0x12, 0x95, 0x7F, 0x68, 0xD1, 0xED, 0x19, 0x61, 0x2A, 0x6A, 0x36, 0x81, 0x10,
+        0xF6, 0x88, 0x61, 0x97, 0x72, 0x61, 0x58, 0xB0, 0x47, 0xE6, 0xB0, 0xA7, 0x85, 0xE3, 0xD4, 0x03,
+        0x72, 0x52, 0x7A, 0x92, 0xE2, 0x70, 0xEA, 0x20, 0xF1, 0xC0, 0x82, 0x79, 0xEA, 0xA0, 0x12, 0xCB,
+        0x58, 0x18, 0x8E, 0xBB, 0xFA, 0x7A, 0x51, 0xA8, 0xBE, 0x21, 0x64, 0x26, 0x32, 0x4D, 0x41, 0xC2,
+        0x38, 0x89, 0xFF, 0x88, 0xA9, 0x55, 0x90, 0xB3, 0xBE, 0x34, 0x30, 0x4A, 0xDD, 0x5A, 0x31, 0xB0,
+        0xCF, 0x56, 0x81, 0x23, 0x7C, 0x08, 0x34, 0x52, 0xC2, 0x02, 0xC0, 0x50, 0x5F, 0xB5, 0xE1, 0xFA,
+        0xA3, 0xD9, 0x2C, 0xE5, 0x0C, 0x4E, 0x85, 0xAE, 0xFE, 0x46, 0xB1, 0x61, 0x6F, 0x76, 0x0D, 0xF9,
+        0x13, 0xC1, 0x91, 0x4F, 0x46, 0x7D, 0x16, 0x66, 0x98, 0x36, 0xAE, 0xB4, 0xD5, 0x61, 0xF4, 0x25,
+        0x78, 0xCA, 0x87, 0xEE, 0x3B, 0x59, 0x29, 0x52, 0x83, 0x89, 0x00, 0x0C, 0xCD, 0xE3, 0x8B, 0xC8,
+        0x23, 0x0D, 0x73, 0xBC, 0x2A, 0x9B, 0xE5, 0xAB, 0xF9, 0x80, 0x89, 0x71, 0xC2, 0x42, 0xB9, 0xD2,
+        0x6F, 0x20, 0xE1, 0xAA, 0x7C, 0x20, 0xEA, 0x98, 0x2E, 0xF1, 0xDC, 0xB6, 0x7D, 0x4D, 0xFF, 0xA9,
+        0xBC, 0x59, 0x61, 0xBC, 0x84, 0x77, 0x9E, 0x18, 0xCD, 0x43, 0xA6, 0x94, 0x37, 0x38, 0x6B, 0x44,
+        0x18, 0x80, 0x8E, 0xD0, 0xD4, 0x79, 0x94, 0xBA, 0xF0, 0x8E, 0x7B, 0xD3, 0x20, 0x5C, 0xBB, 0x06,
+        0x33, 0x66, 0xEC, 0xD8, 0xF0, 0x76, 0x48, 0x98, 0xA9, 0x5A, 0xFC, 0x15, 0x01, 0xB6, 0xCA, 0x83,
+        0xFC, 0xB1, 0x65, 0x40, 0x2D, 0xEC, 0x72, 0x6E, 0x61, 0xAC, 0x06, 0xAD, 0x41, 0xC8, 0xB5, 0x53,
+        0x28, 0xE6, 0xDC, 0x9C, 0xE3, 0x0B, 0x80, 0x69, 0x87, 0x8F, 0xAD, 0x96, 0xEB, 0x4B, 0x0B, 0xDD,
+        0xEA, 0xE9, 0x17, 0x90, 0x02, 0xA0, 0x12, 0x6C, 0x9D, 0x14, 0x66, 0x5D, 0x00, 0xE0, 0x37, 0x83,
+        0x70, 0x7F, 0xE2, 0xEB, 0x89, 0x84, 0xEF, 0x97, 0x64, 0x9B, 0xEB, 0xF5, 0xFF, 0xB2, 0xB9, 0x77,
+        0xA6, 0x11, 0x6F, 0x6A, 0x3E, 0x01, 0x30, 0x75, 0xB8, 0x44, 0x57, 0x43, 0x92, 0x99, 0x7A, 0xC3,
+        0x73, 0xEE, 0x4F, 0x59, 0x16, 0xF5, 0x4A, 0x1C, 0x02, 0xD6, 0x4F, 0xEF, 0x88, 0x2D, 0xCA, 0x64,
+        0xB1, 0x3B, 0x94, 0x6E, 0x32, 0x38, 0xBE, 0x9C, 0xB7, 0x03, 0xDC, 0x4A, 0x86, 0x2B, 0xBF, 0x62,
+        0xF0, 0x18, 0x74, 0x13, 0x62, 0xAA, 0x15, 0xFD, 0x85, 0x4D, 0xCB, 0x6D, 0x71, 0x37, 0x76, 0x4C,
+        0x22, 0x60, 0xEE, 0xC6, 0x18, 0x5A, 0xE0, 0x20, 0x24, 0xA0, 0x56, 0x90, 0x8A, 0x9D, 0xEB, 0xA2,
+        0x96, 0x10, 0xE9, 0x41, 0x79, 0x83, 0xAF, 0x77, 0xA7, 0x9F, 0x14, 0xA4, 0x0C, 0x1C, 0x49, 0x0E,
+        0x33, 0x56, 0x7D, 0x7C, 0xBB, 0x99, 0x01, 0xDB, 0x05, 0x9E, 0x04, 0x1C, 0x5E, 0x7E, 0x72, 0x60,
+        0xB8, 0xC8, 0xB0, 0x00, 0xB5, 0xC1, 0xE4, 0x1E, 0xEE, 0xCA, 0x89, 0x9B, 0x24, 0x1D, 0xA0, 0x0A,
+        0x24, 0x08, 0x75, 0x64, 0x6B, 0xCF, 0x8C, 0x0D, 0x60, 0x5A, 0x6E, 0x14, 0x40, 0x26, 0x4F, 0xB1,
+        0x84, 0x7A, 0x84, 0x18, 0xF9, 0x79, 0x91, 0xFB, 0x20, 0x00, 0x2A, 0x66, 0xC0, 0xD6, 0x69, 0x42,
+        0xAA, 0x7C, 0xB6, 0xEB, 0x82, 0xFA, 0x27, 0x01, 0x89, 0x09, 0x4F, 0x6C, 0x6A, 0x4B, 0x71, 0xBA,
+        0x43, 0x6A, 0xC0, 0x52, 0xB1, 0xE6, 0x0A, 0x37, 0xBE, 0x68, 0xB1, 0xE0, 0x1B, 0x41, 0xEF, 0xF1,
+        0x3E, 0xC9, 0xD8, 0xE9, 0xF3, 0xB4, 0x1C, 0x74, 0xC5, 0x36, 0x1A, 0x05, 0xE1, 0x2B, 0xA6, 0x0C,
+        0x06, 0xD3, 0x0B, 0x4A, 0x48, 0x2F, 0xE8, 0x11, 0x4D, 0x96, 0x72, 0x1F, 0x21, 0xCA, 0xA6, 0x54,
+        0x1E, 0xA9, 0xC8, 0x35, 0x54, 0x0B, 0x93, 0x1E, 0xEA, 0x51, 0x33, 0x69, 0x0E, 0xD8, 0x40, 0x19,
+        0x3A, 0x8E, 0x62, 0x07, 0x42, 0x4A, 0xC3, 0xCD, 0xC5, 0x00, 0x0D, 0x9E, 0x04, 0x20, 0x37, 0xE0,
+        0xAC, 0x00, 0x74, 0xC5, 0x2D, 0xF7, 0xBF, 0xC6, 0x35, 0x92, 0xF4, 0x07, 0xC4, 0x54, 0x7C, 0xD9,
+        0xC5, 0x6C, 0xA0, 0x7C, 0x4E, 0x93, 0xF2, 0x4D, 0x74, 0x30, 0x24, 0x01, 0x25, 0x5E, 0xB4, 0xF6,
+        0xC2, 0xCC, 0xF4, 0xEC, 0xD4, 0x56, 0x2D, 0x7E, 0x8E, 0xB4, 0x07, 0x12, 0x6B, 0xA2, 0x78, 0x06,
+        0x5A, 0x8E, 0x52, 0x24, 0x2A, 0x34, 0x2B, 0x2B, 0xE6, 0x43, 0x0A, 0xF9, 0x05, 0x93, 0xEA, 0x10,
+        0x8C, 0xA3, 0xA0, 0xC7, 0x85, 0x42, 0x11, 0x8D, 0x18, 0xC5, 0x30, 0xD6, 0x2F, 0x92, 0xD4, 0x34,
+        0x17, 0x6F, 0xA7, 0x28, 0xCA, 0xB5, 0x06, 0x20, 0x1F, 0xA8, 0xA5, 0x29, 0xBC, 0xC2, 0x57, 0xF0,
+        0xC8, 0x17, 0x39, 0x46, 0x57, 0xD6, 0x55, 0xD1, 0x65, 0x2F, 0x07, 0xB9, 0x04, 0x70, 0x86, 0xB5,
+        0x3B, 0xDF, 0x0A,
+    };
+
+    const uint8_t WordsLevel19[] =
+    {
+        0x28, 0xB5, 0x2F, 0xFD, 0x64, 0x70, 0x16, 0x75, 0x1F, 0x00, 0x22, 0x85, 0x0F, 0x11, 0xA0, 0xED,
+        0x90, 0xAA, 0xC7, 0x2F, 0xBC, 0x63, 0xB5, 0xD1, 0xFF, 0x6D, 0x1D, 0xB8, 0x9F, 0x35, 0x30, 0xFF,
+        0xFF, 0xFF, 0xFF, 0x9F, 0xFA, 0xBF, 0x9C, 0x5D, 0xB9, 0x0F, 0xA0, 0x6A, 0x8C, 0x29, 0x33, 0x32,
+        0x44, 0x38, 0x7F, 0x0C, 0xCE, 0xA7, 0x5E, 0x6E, 0x97, 0x08, 0x9E, 0xD3, 0xB2, 0x71, 0x8C, 0x96,
+        0x53, 0xEF, 0x97, 0x27, 0xCF, 0xB8, 0xCB, 0x3C, 0x56, 0xF6, 0x01, 0x82, 0x08, 0xA8, 0x82, 0x2F,
+        0x85, 0xB4, 0xFF, 0x06, 0x22, 0x10, 0x08, 0x08, 0x09, 0x45, 0x9A, 0x38, 0x88, 0x1F, 0x12, 0x80,
+        0x10, 0xC0, 0x80, 0x11, 0x84, 0x2D, 0xC0, 0x1C, 0xA2, 0x09, 0x49, 0x55, 0xA1, 0x31, 0x67, 0x01,
+        0xAC, 0x17, 0x69, 0xCF, 0xBC, 0xAA, 0xF9, 0x42, 0x48, 0x60, 0xC3, 0xED, 0xA5, 0xAF, 0x91, 0x00,
+        0x60, 0x90, 0x8E, 0x44, 0xCB, 0x57, 0xB0, 0x94, 0x0E, 0x96, 0xB6, 0xCE, 0x89, 0xD4, 0x52, 0x76,
+        0x45, 0x2B, 0x54, 0xC1, 0x80, 0xA5, 0x00, 0x68, 0x89, 0x3E, 0xB7, 0x7E, 0x07, 0x4B, 0xFE, 0xC1,
+        0xD5, 0xF1, 0x3D, 0x4B, 0xD7, 0x37, 0x5A, 0xE0, 0x1F, 0xF7, 0xDA, 0x6B, 0x64, 0xA7, 0x6D, 0xF3,
+        0x37, 0xE6, 0x15, 0xF2, 0xEC, 0xE8, 0x2E, 0x47, 0x50, 0xB0, 0xA0, 0x14, 0x06, 0x91, 0xA5, 0xE5,
+        0x22, 0x96, 0xF5, 0x8A, 0x81, 0x06, 0xB0, 0x75, 0xF6, 0x94, 0x2E, 0x0D, 0x6E, 0x8C, 0x56, 0x59,
+        0xC4, 0xEC, 0x3C, 0xF7, 0x91, 0x31, 0x0B, 0x62, 0x09, 0xC6, 0x31, 0xCA, 0xCC, 0x22, 0x22, 0xD7,
+        0x1B, 0x6B, 0x7B, 0x5D, 0x60, 0x06, 0x13, 0x68, 0x8E, 0x70, 0x36, 0x4D, 0x21, 0x6F, 0xF9, 0x56,
+        0xF9, 0xCB, 0xDB, 0x16, 0x3F, 0xED, 0x64, 0x55, 0x57, 0xE2, 0x23, 0xCC, 0x91, 0x66, 0x46, 0x76,
+        0x65, 0x12, 0xA3, 0xF6, 0xB6, 0xDB, 0xF5, 0x83, 0x9A, 0x5E, 0x2E, 0x0D, 0xF4, 0x4E, 0xD0, 0x04,
+        0x70, 0x7C, 0xB7, 0x0A, 0x0E, 0x59, 0x85, 0x74, 0xE8, 0xB4, 0xFE, 0x1A, 0x00, 0x5B, 0xCD, 0x91,
+        0xDD, 0x17, 0x95, 0xF9, 0xA8, 0xE0, 0x49, 0xDF, 0xB8, 0x8C, 0xC3, 0x8F, 0x1C, 0x97, 0x5E, 0x17,
+        0x90, 0x4C, 0x47, 0xEE, 0x87, 0xEF, 0xBD, 0x97, 0xCD, 0xC8, 0x03, 0x46, 0xD0, 0x9E, 0x62, 0x2C,
+        0x33, 0x8E, 0x17, 0xDD, 0x87, 0xAA, 0xAC, 0xC1, 0x04, 0x21, 0x15, 0xF1, 0x8E, 0x96, 0x82, 0xA2,
+        0x93, 0xD5, 0x9C, 0x58, 0x05, 0xA0, 0x15, 0x54, 0x35, 0x2D, 0xB2, 0x57, 0x6F, 0x79, 0x4C, 0xE5,
+        0x9C, 0xA3, 0xDC, 0x50, 0xB8, 0x2E, 0x9A, 0x58, 0xC4, 0x08, 0x08, 0x63, 0x97, 0xD7, 0xB2, 0xC8,
+        0x63, 0xDB, 0xD8, 0x00, 0xAC, 0x21, 0xC1, 0x00, 0x35, 0x5A, 0xD9, 0xFB, 0xB3, 0x8D, 0x9C, 0x30,
+        0x89, 0xB0, 0xC2, 0x43, 0x33, 0x8D, 0x42, 0x61, 0x5A, 0xC4, 0xE9, 0x24, 0x82, 0x9B, 0x3E, 0x68,
+        0x7C, 0x89, 0x98, 0xB0, 0x47, 0x5D, 0x95, 0x08, 0x06, 0xB2, 0xED, 0x3E, 0x29, 0xF7, 0xB7, 0x37,
+        0x6A, 0x7E, 0x20, 0x81, 0x19, 0x63, 0xC1, 0x33, 0xF0, 0xD0, 0xF7, 0x04, 0xD7, 0x15, 0x86, 0x4B,
+        0xC1, 0x49, 0xAE, 0x81, 0x74, 0x4B, 0x97, 0xE7, 0xDC, 0x70, 0x97, 0x25, 0x00, 0x7B, 0x6A, 0x22,
+        0xAE, 0x33, 0x94, 0xFD, 0xC9, 0x1F, 0x82, 0x73, 0x42, 0x05, 0x0D, 0x1C, 0xBF, 0xCA, 0x6E, 0xE4,
+        0x35, 0x32, 0x09, 0xCD, 0x38, 0x79, 0x69, 0xF3, 0xED, 0xD3, 0xBD, 0x6A, 0x78, 0x84, 0x6F, 0x2B,
+        0xCB, 0x83, 0xBA, 0xC7, 0x67, 0x44, 0x95, 0x95, 0xD5, 0x34, 0x15, 0x48, 0x7B, 0xB8, 0xE3, 0xBC,
+        0x7E, 0xB2, 0x50, 0x8D, 0x02, 0xC3, 0xF8, 0x20, 0xED, 0xDF, 0x98, 0x27, 0xD2, 0x4A, 0x7E, 0x31,
+        0x6F, 0x11, 0x43, 0x60, 0xF5, 0x2A, 0xDC, 0x91, 0x66, 0x6A, 0x2A, 0xFD, 0xDD, 0xA7, 0xE2, 0x44,
+        0x48, 0x29, 0x60, 0xE0, 0x33, 0xDF, 0x5A, 0x37, 0x90, 0x81, 0x43, 0xE3, 0x24, 0xE0, 0x0C, 0x36,
+        0x3A, 0x5C, 0x0A, 0x46, 0x40, 0xF1, 0x63, 0x4E, 0xFF, 0x74, 0xE5, 0x0D, 0x4B, 0x7C, 0x34, 0x5B,
+        0x49, 0x2B, 0xEB, 0x17, 0x48, 0xAB, 0x54, 0x93, 0x6B, 0xF5, 0xA8, 0x36, 0x79, 0x71, 0x7D, 0x3D,
+        0xCF, 0xC0, 0xD1, 0xB2, 0xDC, 0x06, 0x68, 0x38, 0x28, 0x82, 0x6B, 0xA7, 0xD2, 0xBD, 0xA1, 0x52,
+        0x79, 0x1D, 0x20, 0x26, 0xED, 0x23, 0x57, 0x45, 0xA8, 0xC2, 0xF2, 0xA7, 0x42, 0xD2, 0xFC, 0x58,
+        0xEE, 0xBD, 0x34, 0x75, 0xCF, 0x42, 0xDA, 0xE9, 0xDD, 0x45, 0x93, 0x79, 0x0E, 0x06, 0xE1, 0x0B,
+        0x68, 0x35, 0x0B, 0xFD, 0xE2, 0x35, 0xB8, 0x83, 0xBE, 0x6A, 0x6B, 0x50, 0x6A, 0x16, 0x44, 0xEE,
+        0x61, 0x07, 0xCE, 0x89, 0xFE, 0x7B, 0x19, 0xA2, 0x20, 0xDD, 0x38, 0xAF, 0x17, 0x2C, 0x26, 0x34,
+        0x3A, 0x39, 0x15, 0x9F, 0x6C, 0x47, 0x16, 0xB3, 0x14, 0x17, 0x9F, 0x64, 0x64, 0x47, 0xC7, 0x7A,
+        0xE4, 0x5F, 0x36, 0x3A, 0xAE, 0x27, 0xA9, 0x53, 0x3C, 0x00, 0xC1, 0xB3, 0x8E, 0x06, 0x8A, 0x1B,
+        0x23, 0x2A, 0xE5, 0x2B, 0x82, 0x84, 0xE1, 0x23, 0xB9, 0x41, 0xD0, 0x23, 0x97, 0x0F, 0xEC, 0x61,
+        0x41, 0xAF, 0x79, 0x72, 0xFA, 0x7A, 0xA4, 0x4D, 0xCB, 0xD2, 0x9C, 0x12, 0x14, 0x96, 0x7D, 0x1A,
+        0x1D, 0xF9, 0x44, 0x79, 0x27, 0xD6, 0xA2, 0x84, 0x62, 0x43, 0x06, 0x76, 0xA4, 0x27, 0x1D, 0x29,
+        0x1E, 0x19, 0x3D, 0xC1, 0x1E, 0xD8, 0x9E, 0x69, 0x1E, 0x20, 0x5F, 0x1D, 0xFF, 0x15, 0x73, 0x00,
+        0xCC, 0x31, 0x56, 0x7D, 0x37, 0x11, 0x87, 0xCD, 0x27, 0x06, 0xC2, 0x2B, 0xB5, 0x5D, 0x67, 0xAF,
+        0x2B, 0x1A, 0x0A, 0x14, 0xCE, 0x17, 0xEF, 0x22, 0x21, 0x0A, 0x6B, 0xE2, 0x71, 0x10, 0x47, 0xEC,
+        0x30, 0x70, 0x0E, 0x9A, 0x1F, 0x0E, 0xF4, 0x84, 0x5A, 0x3A, 0xC5, 0x9C, 0xB9, 0x14, 0xCB, 0x9D,
+        0x0B, 0xC9, 0x1C, 0xD4, 0xC1, 0x64, 0x30, 0xE4, 0x28, 0x15, 0x33, 0x14, 0x5C, 0x6B, 0xA2, 0x4C,
+        0x4D, 0x1A, 0x16, 0x2D, 0x23, 0x7F, 0x0B, 0x3D, 0xB8, 0xA8, 0xBD, 0x57, 0xF7, 0x2F, 0x9B, 0x85,
+        0xB1, 0xB2, 0x39, 0x28, 0x8D, 0x24, 0xC6, 0x38, 0x35, 0x0D, 0xB7, 0x34, 0xAD, 0x4F, 0xBA, 0x1C,
+        0x62, 0xCA, 0x1B, 0x3D, 0x86, 0xC2, 0x10, 0xD8, 0x3D, 0xA6, 0x66, 0x35, 0x50, 0x4F, 0x2C, 0x03,
+        0x2B, 0x38, 0xDB, 0x9B, 0x57, 0x77, 0x0D, 0xF7, 0xA6, 0x0D, 0x1A, 0xA2, 0x33, 0xFD, 0xB1, 0xF2,
+        0xD2, 0x8C, 0x94, 0x57, 0xD0, 0xB9, 0x67, 0x50, 0x98, 0xE1, 0xCE, 0x98, 0xFA, 0x02, 0x07, 0xE2,
+        0x38, 0x2B, 0xE6, 0x5F, 0x9B, 0x06, 0xCE, 0xD9, 0x80, 0x04, 0xDE, 0x08, 0x08, 0xB7, 0xAF, 0x8F,
+        0x4F, 0xA0, 0x22, 0x9D, 0x36, 0xBC, 0x20, 0xB3, 0x05, 0x89, 0x52, 0x40, 0xC6, 0x39, 0x1B, 0x68,
+        0x35, 0xC4, 0x56, 0x88, 0x10, 0x1C, 0x0E, 0x92, 0xFB, 0x71, 0xC6, 0xEA, 0x5E, 0x18, 0x45, 0x05,
+        0x0A, 0xB9, 0x8E, 0xDF, 0x5C, 0x75, 0xB0, 0x78, 0xC9, 0x28, 0x40, 0xF6, 0x3E, 0x32, 0x3E, 0xAF,
+        0x30, 0x4B, 0x51, 0x76, 0x84, 0xD0, 0x5B, 0xD8, 0x94, 0x0E, 0x19, 0x51, 0x04, 0x1D, 0xA2, 0xA2,
+        0x10, 0x89, 0xD1, 0x28, 0xE2, 0xB0, 0xC4, 0x20, 0x20, 0x7D, 0x79, 0xD1, 0xDE, 0xA0, 0xF5, 0x55,
+        0x0C, 0x97, 0x0C, 0x1C, 0x07, 0x25, 0x90, 0x76, 0xC5, 0x68, 0xC3, 0xEE, 0x42, 0xD5, 0xDB, 0x64,
+        0x7C, 0x30, 0x9C, 0x80, 0x56, 0x47, 0xF2, 0xAD, 0x1C, 0x3D, 0xA3, 0x94,
+    };
+
+    const uint8_t RleRawWithSkippable[] =
+    {
+        0x28, 0xB5, 0x2F, 0xFD, 0x60, 0xE8, 0x02, 0x4D, 0x00, 0x00, 0x10, 0x61, 0x61, 0x01, 0x00, 0xE3,
+        0x2B, 0x80, 0x05, 0x50, 0x2A, 0x4D, 0x18, 0x05, 0x00, 0x00, 0x00, 0x73, 0x6B, 0x69, 0x70, 0x21,
+        0x28, 0xB5, 0x2F, 0xFD, 0x20, 0xC8, 0x41, 0x06, 0x00, 0x2C, 0xAA, 0xB3, 0xBC, 0x37, 0x64, 0xF6,
+        0x10, 0x7B, 0x68, 0xF2, 0x5A, 0x4C, 0xA0, 0x9E, 0x37, 0x96, 0xD4, 0xF4, 0xF5, 0x42, 0x8E, 0x7B,
+        0xD9, 0x7D, 0xF6, 0x92, 0xD9, 0x68, 0xAA, 0xCF, 0x13, 0x57, 0x2B, 0xD6, 0xA7, 0xA9, 0x39, 0x5B,
+        0x4B, 0xA6, 0x06, 0xCB, 0xA4, 0xD1, 0x8F, 0x86, 0x4F, 0x87, 0xB5, 0x66, 0x9A, 0x6E, 0xDF, 0xCE,
+        0xE3, 0x9D, 0x92, 0xE3, 0xEF, 0x1B, 0x1C, 0x8D, 0x61, 0x7F, 0xDE, 0x20, 0xA6, 0x74, 0xB5, 0x11,
+        0xFC, 0x8B, 0xE0, 0x77, 0x9F, 0x48, 0x0C, 0xEF, 0xC7, 0xB8, 0x9B, 0xC7, 0xFA, 0x3C, 0xB5, 0xF0,
+        0x43, 0x83, 0x05, 0x44, 0xEA, 0xFD, 0xDB, 0x5D, 0xB1, 0xA6, 0xBE, 0x13, 0x56, 0xAE, 0x5D, 0xFF,
+        0x34, 0x9D, 0x01, 0x09, 0x52, 0xAE, 0xD8, 0x47, 0x62, 0x60, 0xAA, 0xBC, 0x03, 0x4F, 0x79, 0x32,
+        0xB7, 0xA8, 0xF3, 0x98, 0xB8, 0xCC, 0x1C, 0x80, 0xBF, 0xAF, 0x56, 0x83, 0xE1, 0x84, 0xAF, 0x11,
+        0x25, 0x0A, 0xB8, 0x82, 0x3E, 0x42, 0xEC, 0xEE, 0x87, 0xAB, 0x0C, 0xAB, 0xE5, 0x4F, 0x1E, 0x73,
+        0x31, 0x22, 0x1A, 0x7B, 0x06, 0xE2, 0xBF, 0x26, 0x6C, 0x4C, 0x44, 0xB6, 0x19, 0x7E, 0x4F, 0x59,
+        0xDF, 0xCE, 0x99, 0x90, 0x8E, 0x77, 0xB6, 0xF7, 0x9B, 0x56, 0x02, 0x58, 0x54, 0xB8, 0x06, 0xC7,
+        0xC8, 0x04, 0x92, 0x6B, 0xDB, 0xA9, 0x3B, 0xB3, 0x09, 0x9C, 0xCA, 0x82, 0xB0, 0x89, 0x7B, 0xB8,
+        0x20,
+    };
+}
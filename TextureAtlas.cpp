@@ -0,0 +1,231 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+    // The packing works in cells of the placement alignment.
+    class SkylinePage
+    {
+    public:
+        SkylinePage(uint32_t width, uint32_t height) :
+            m_width(width),
+            m_height(height)
+        {
+            m_skyline.push_back(Segment{ 0, 0, width });
+        }
+
+        // The position of a width x height rectangle whose top ends lowest, on the narrowest
+        // segment among equals. Returns false if it fits nowhere.
+        bool Find(uint32_t width, uint32_t height, size_t& index, uint32_t& x, uint32_t& y) const
+        {
+            uint32_t bestTop = m_height + 1;
+            uint32_t bestSegmentWidth = 0;
+            for (size_t i = 0; i < m_skyline.size() && m_skyline[i].X + width <= m_width; ++i)
+            {
+                // The rectangle rests on the highest segment under it.
+                uint32_t bottom = 0;
+                uint32_t covered = 0;
+                for (size_t j = i; covered < width; ++j)
+                {
+                    bottom = std::max(bottom, m_skyline[j].Y);
+                    covered += m_skyline[j].Width;
+                }
+                const uint32_t top = bottom + height;
+                if (top <= m_height && (top < bestTop || (top == bestTop && m_skyline[i].Width < bestSegmentWidth)))
+                {
+                    bestTop = top;
+                    bestSegmentWidth = m_skyline[i].Width;
+                    index = i;
+                    x = m_skyline[i].X;
+                    y = bottom;
+                }
+            }
+            return bestTop <= m_height;
+        }
+
+        void Insert(size_t index, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+        {
+            m_skyline.insert(m_skyline.begin() + index, Segment{ x, y + height, width });
+
+            // The segments the rectangle covers are cut away.
+            const uint32_t right = x + width;
+            size_t next = index + 1;
+            while (next < m_skyline.size() && m_skyline[next].X < right)
+            {
+                Segment& segment = m_skyline[next];
+                const uint32_t covered = right - segment.X;
+                if (segment.Width <= covered)
+                {
+                    m_skyline.erase(m_skyline.begin() + next);
+                    continue;
+                }
+                segment.X += covered;
+                segment.Width -= covered;
+                break;
+            }
+
+            // Neighbours at the same height become one segment.
+            for (size_t i = index > 0 ? index - 1 : 0; i + 1 < m_skyline.size() && i <= index + 1;)
+            {
+                if (m_skyline[i].Y == m_skyline[i + 1].Y)
+                {
+                    m_skyline[i].Width += m_skyline[i + 1].Width;
+                    m_skyline.erase(m_skyline.begin() + i + 1);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+
+        // Cells under the skyline.
+        uint64_t GetUsedArea() const
+        {
+            uint64_t area = 0;
+            for (const Segment& segment : m_skyline)
+            {
+                area += static_cast<uint64_t>(segment.Width) * segment.Y;
+            }
+            return area;
+        }
+
+    private:
+        struct Segment
+        {
+            uint32_t X;
+            uint32_t Y;                 // Top of what is placed below it.
+            uint32_t Width;
+        };
+
+        uint32_t m_width;
+        uint32_t m_height;
+        std::vector<Segment> m_skyline;  // Left to right, covering the page width.
+    };
+}
+
+AtlasLayout PackTextureAtlas(const uint32_t* widths, const uint32_t* heights, size_t count, const AtlasSettings& settings)
+{
+    const uint32_t alignment = 1u << (std::max(settings.MipLevels, 1u) - 1);
+    if (settings.PageWidth == 0 || settings.PageHeight == 0 || settings.PageWidth % alignment != 0 || settings.PageHeight % alignment != 0)
+    {
+        throw std::invalid_argument("PackTextureAtlas: pages must be a non-zero multiple of the mip alignment.");
+    }
+
+    AtlasLayout layout;
+    layout.Gutter = settings.Padding * alignment;
+    layout.Placements.assign(count, AtlasPlacement{ AtlasNotPacked, 0, 0, 0, 0 });
+    layout.Remaps.assign(count, AtlasUvRemap{ 1.0f, 1.0f, 0.0f, 0.0f });
+
+    // Tallest first, then widest: the skyline stays flat for longest.
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [widths, heights](uint32_t a, uint32_t b)
+    {
+        return heights[a] != heights[b] ? heights[a] > heights[b] : (widths[a] != widths[b] ? widths[a] > widths[b] : a < b);
+    });
+
+    const uint32_t pageCellsX = settings.PageWidth / alignment;
+    const uint32_t pageCellsY = settings.PageHeight / alignment;
+    std::vector<SkylinePage> pages;
+    for (const uint32_t input : order)
+    {
+        const uint32_t width = widths[input];
+        const uint32_t height = heights[input];
+        const uint32_t cellsX = (width + 2 * layout.Gutter + alignment - 1) / alignment;
+        const uint32_t cellsY = (height + 2 * layout.Gutter + alignment - 1) / alignment;
+        if (width == 0 || height == 0 || cellsX > pageCellsX || cellsY > pageCellsY)
+        {
+            ++layout.Stats.NotPacked;
+            continue;
+        }
+
+        size_t page = 0;
+        size_t index = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        while (page < pages.size() && !pages[page].Find(cellsX, cellsY, index, x, y))
+        {
+            ++page;
+        }
+        if (page == pages.size())
+        {
+            if (settings.MaxPages != 0 && pages.size() == settings.MaxPages)
+            {
+                ++layout.Stats.NotPacked;
+                continue;
+            }
+            pages.emplace_back(pageCellsX, pageCellsY);
+            pages.back().Find(cellsX, cellsY, index, x, y);
+        }
+        pages[page].Insert(index, x, y, cellsX, cellsY);
+
+        AtlasPlacement& placement = layout.Placements[input];
+        placement.Page = static_cast<uint32_t>(page);
+        placement.X = x * alignment + layout.Gutter;
+        placement.Y = y * alignment + layout.Gutter;
+        placement.Width = width;
+        placement.Height = height;
+
+        AtlasUvRemap& remap = layout.Remaps[input];
+        remap.ScaleU = static_cast<float>(width) / settings.PageWidth;
+        remap.ScaleV = static_cast<float>(height) / settings.PageHeight;
+        remap.OffsetU = static_cast<float>(placement.X) / settings.PageWidth;
+        remap.OffsetV = static_cast<float>(placement.Y) / settings.PageHeight;
+
+        ++layout.Stats.Packed;
+        layout.Stats.TexelArea += static_cast<uint64_t>(width) * height;
+    }
+
+    layout.PageCount = static_cast<uint32_t>(pages.size());
+    for (const SkylinePage& page : pages)
+    {
+        layout.Stats.UsedArea += page.GetUsedArea() * alignment * alignment;
+    }
+    layout.Stats.PageArea = static_cast<uint64_t>(settings.PageWidth) * settings.PageHeight * pages.size();
+    return layout;
+}
+
+void BlitToAtlas(const AtlasPlacement& placement, uint32_t gutter, const void* source, size_t sourceRowPitch, uint32_t pixelSize, void* page, size_t pageRowPitch)
+{
+    if (placement.Page == AtlasNotPacked || placement.Width == 0 || placement.Height == 0)
+    {
+        throw std::invalid_argument("BlitToAtlas: the texture was not packed.");
+    }
+
+    const size_t rowSize = static_cast<size_t>(placement.Width) * pixelSize;
+    const int64_t height = placement.Height;
+    for (int64_t row = -static_cast<int64_t>(gutter); row < height + gutter; ++row)
+    {
+        // Rows of the gutter repeat the first and last row; columns, the first and last texel.
+        const int64_t sourceRowIndex = std::min(std::max(row, int64_t(0)), height - 1);
+        const uint8_t* sourceRow = static_cast<const uint8_t*>(source) + sourceRowIndex * sourceRowPitch;
+        uint8_t* dest = static_cast<uint8_t*>(page) + (placement.Y + row) * pageRowPitch + (placement.X - gutter) * static_cast<size_t>(pixelSize);
+
+        for (uint32_t i = 0; i < gutter; ++i, dest += pixelSize)
+        {
+            memcpy(dest, sourceRow, pixelSize);
+        }
+        memcpy(dest, sourceRow, rowSize);
+        dest += rowSize;
+        for (uint32_t i = 0; i < gutter; ++i, dest += pixelSize)
+        {
+            memcpy(dest, sourceRow + rowSize - pixelSize, pixelSize);
+        }
+    }
+}
+
+void RemapUvs(const AtlasUvRemap& remap, float* uvs, size_t count, size_t strideBytes)
+{
+    uint8_t* uv = reinterpret_cast<uint8_t*>(uvs);
+    for (size_t i = 0; i < count; ++i, uv += strideBytes)
+    {
+        float* pair = reinterpret_cast<float*>(uv);
+        pair[0] = pair[0] * remap.ScaleU + remap.OffsetU;
+        pair[1] = pair[1] * remap.ScaleV + remap.OffsetV;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct AtlasSettings
+{
+    uint32_t PageWidth = 2048;
+    uint32_t PageHeight = 2048;
+    uint32_t MaxPages = 0;      // 0: as many as needed.
+    uint32_t Padding = 1;       // Gutter texels around each texture at the top mip.
+    uint32_t MipLevels = 1;     // Mips the pages will have; placements stay apart at every one.
+};
+
+static const uint32_t AtlasNotPacked = 0xffffffff;
+
+// Where a texture went: Page, and the rectangle of its texels there (the gutter is around it).
+// Page is AtlasNotPacked for a texture larger than a page or that found no room in MaxPages.
+struct AtlasPlacement
+{
+    uint32_t Page;
+    uint32_t X;
+    uint32_t Y;
+    uint32_t Width;
+    uint32_t Height;
+};
+
+// Maps a texture's own UVs to the page's: uv * Scale + Offset.
+struct AtlasUvRemap
+{
+    float ScaleU;
+    float ScaleV;
+    float OffsetU;
+    float OffsetV;
+};
+
+struct AtlasStats
+{
+    uint32_t Packed = 0;
+    uint32_t NotPacked = 0;
+    uint64_t TexelArea = 0;     // Texels of the packed textures.
+    uint64_t UsedArea = 0;      // Page area under the skylines: texels, gutters and the holes below.
+    uint64_t PageArea = 0;      // Every page, the last one in full.
+};
+
+struct AtlasLayout
+{
+    uint32_t PageCount = 0;
+    uint32_t Gutter = 0;                            // Texels each placement is extended by.
+    std::vector<AtlasPlacement> Placements;         // By input.
+    std::vector<AtlasUvRemap> Remaps;               // By input; identity when not packed.
+    AtlasStats Stats;
+};
+
+// Packs textures of the given sizes into pages of an atlas, so that many small textures share a
+// resource, a descriptor and a draw. The pages can be separate textures or the slices of one
+// Texture2DArray, where Page is the slice.
+//
+// Skyline bin packing, bottom-left: the top edge of what is placed on a page is kept as a list of
+// horizontal segments, and each texture goes where its top ends lowest. Textures are placed
+// tallest first, each on the first page with room, a new page opening when none has.
+// Mip-safe gutters: with n mip levels every placement is aligned to 2^(n-1) texels and surrounded
+// by Padding * 2^(n-1) texels, so that down to the last mip each texture is at least Padding
+// texels from its neighbours and bilinear filtering never reads theirs. BlitToAtlas fills the
+// gutter with the texture's edge texels.
+// Throws std::invalid_argument when a page is empty or not a multiple of the alignment.
+AtlasLayout PackTextureAtlas(const uint32_t* widths, const uint32_t* heights, size_t count, const AtlasSettings& settings);
+
+// Copies a texture into its placement on a page and extends its edges into the gutter. Source
+// and page hold pixelSize-byte texels. The page is written, never read: it can be mapped
+// upload memory.
+void BlitToAtlas(const AtlasPlacement& placement, uint32_t gutter, const void* source, size_t sourceRowPitch, uint32_t pixelSize, void* page, size_t pageRowPitch);
+
+// Applies a remap to a vertex stream: count UV pairs, strideBytes apart.
+void RemapUvs(const AtlasUvRemap& remap, float* uvs, size_t count, size_t strideBytes);
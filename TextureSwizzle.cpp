@@ -0,0 +1,338 @@
+#include "TextureSwizzle.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SWIZZLE_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SWIZZLE_NEON 1
+#endif
+
+namespace
+{
+    const uint32_t TileBytes = 64 * 1024;
+    const uint32_t ChunkBytes = 16;
+    const uint32_t ChunksPerTile = TileBytes / ChunkBytes;
+
+    // Which bits of the 16-bit address within a tile take the x and the y bits of the element
+    // coordinate, lowest first; the remaining low bits are the byte within the element.
+    // Element sizes 1, 2, 4, 8, 16:
+    //   1:  Y7 X7 Y6 X6 Y5 X5 Y4 X4 Y3 Y2 Y1 Y0 X3 X2 X1 X0
+    //   2:  X7 Y6 X6 Y5 X5 Y4 X4 Y3 X3 Y2 Y1 Y0 X2 X1 X0 B0
+    //   4:  Y6 X6 Y5 X5 Y4 X4 Y3 X3 Y2 X2 Y1 Y0 X1 X0 B1 B0
+    //   8:  X6 Y5 X5 Y4 X4 Y3 X3 Y2 Y1 X2 X1 Y0 X0 B2 B1 B0
+    //   16: Y5 X5 Y4 X4 Y3 X3 Y2 X2 Y1 X1 Y0 X0 B3 B2 B1 B0
+    struct SwizzlePattern
+    {
+        uint32_t TileWidth;
+        uint32_t TileHeight;
+        uint32_t XMask;
+        uint32_t YMask;
+    };
+
+    const SwizzlePattern Patterns[] =
+    {
+        { 256, 256, 0x550f, 0xaaf0 },
+        { 256, 128, 0xaa8e, 0x5570 },
+        { 128, 128, 0x554c, 0xaab0 },
+        { 128, 64, 0xaa68, 0x5590 },
+        { 64, 64, 0x5550, 0xaaa0 },
+    };
+
+    uint32_t GetPatternIndex(uint32_t bytesPerElement)
+    {
+        switch (bytesPerElement)
+        {
+        case 1: return 0;
+        case 2: return 1;
+        case 4: return 2;
+        case 8: return 3;
+        case 16: return 4;
+        default: throw std::invalid_argument("Standard swizzle supports elements of 1, 2, 4, 8 or 16 bytes.");
+        }
+    }
+
+    // Spreads the low bits of value over the set bits of mask (PDEP).
+    uint32_t DepositBits(uint32_t value, uint32_t mask)
+    {
+        uint32_t result = 0;
+        for (uint32_t bit = 1; mask; bit <<= 1)
+        {
+            const uint32_t lowest = mask & (0u - mask);
+            if (value & bit)
+            {
+                result |= lowest;
+            }
+            mask &= mask - 1;
+        }
+        return result;
+    }
+
+    // Gathers the bits of value under mask into the low bits (PEXT).
+    uint32_t ExtractBits(uint32_t value, uint32_t mask)
+    {
+        uint32_t result = 0;
+        for (uint32_t bit = 1; mask; bit <<= 1)
+        {
+            const uint32_t lowest = mask & (0u - mask);
+            if (value & lowest)
+            {
+                result |= bit;
+            }
+            mask &= mask - 1;
+        }
+        return result;
+    }
+
+    // For each 16-byte chunk of a tile, in address order, where it starts in the tile's rectangle:
+    // the byte within the row and the row.
+    struct ChunkOrigin
+    {
+        uint16_t X;
+        uint16_t Y;
+    };
+
+    struct ChunkTables
+    {
+        ChunkOrigin Origins[5][ChunksPerTile];
+
+        ChunkTables()
+        {
+            for (uint32_t p = 0; p < 5; ++p)
+            {
+                const uint32_t bytesPerElement = 1u << p;
+                for (uint32_t chunk = 0; chunk < ChunksPerTile; ++chunk)
+                {
+                    const uint32_t address = chunk * ChunkBytes;
+                    Origins[p][chunk].X = static_cast<uint16_t>(ExtractBits(address, Patterns[p].XMask) * bytesPerElement);
+                    Origins[p][chunk].Y = static_cast<uint16_t>(ExtractBits(address, Patterns[p].YMask));
+                }
+            }
+        }
+    };
+
+    const ChunkOrigin* GetChunkOrigins(uint32_t patternIndex)
+    {
+        static const ChunkTables tables;
+        return tables.Origins[patternIndex];
+    }
+
+    inline void CopyChunk(uint8_t* dest, const uint8_t* source)
+    {
+#if defined(SWIZZLE_SSE2)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+#elif defined(SWIZZLE_NEON)
+        vst1q_u8(dest, vld1q_u8(source));
+#else
+        memcpy(dest, source, ChunkBytes);
+#endif
+    }
+
+    // Write-combined memory wants whole lines written in one go; streaming stores do that and
+    // keep the texture out of the CPU caches.
+    inline void StreamChunk(uint8_t* dest, const uint8_t* source)
+    {
+#if defined(SWIZZLE_SSE2)
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dest), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+#else
+        CopyChunk(dest, source);
+#endif
+    }
+
+    void StreamFence()
+    {
+#if defined(SWIZZLE_SSE2)
+        _mm_sfence();
+#endif
+    }
+
+    // A chunk that is partly or wholly outside the texture: the bytes inside, zeros elsewhere.
+    void GatherPartialChunk(uint8_t* chunk, const uint8_t* linear, size_t rowPitch, uint32_t x, uint32_t y, uint32_t rowBytes, uint32_t height)
+    {
+        memset(chunk, 0, ChunkBytes);
+        if (y < height && x < rowBytes)
+        {
+            const uint32_t count = rowBytes - x < ChunkBytes ? rowBytes - x : ChunkBytes;
+            memcpy(chunk, linear + y * rowPitch + x, count);
+        }
+    }
+
+    void CheckArguments(const void* linear, size_t rowPitch, const void* tiled, uint32_t width, uint32_t bytesPerElement)
+    {
+        GetPatternIndex(bytesPerElement);
+        if (!linear || !tiled || rowPitch < static_cast<size_t>(width) * bytesPerElement)
+        {
+            throw std::invalid_argument("Bad standard swizzle arguments.");
+        }
+    }
+}
+
+void GetStandardSwizzleTileShape(uint32_t bytesPerElement, uint32_t& tileWidth, uint32_t& tileHeight)
+{
+    const SwizzlePattern& pattern = Patterns[GetPatternIndex(bytesPerElement)];
+    tileWidth = pattern.TileWidth;
+    tileHeight = pattern.TileHeight;
+}
+
+uint64_t GetStandardSwizzleSize(uint32_t width, uint32_t height, uint32_t bytesPerElement)
+{
+    uint32_t tileWidth;
+    uint32_t tileHeight;
+    GetStandardSwizzleTileShape(bytesPerElement, tileWidth, tileHeight);
+    const uint64_t tilesAcross = (width + tileWidth - 1) / tileWidth;
+    const uint64_t tilesDown = (height + tileHeight - 1) / tileHeight;
+    return tilesAcross * tilesDown * TileBytes;
+}
+
+void SwizzleStandard64KB(const void* linear, size_t rowPitch, void* tiled, uint32_t width, uint32_t height, uint32_t bytesPerElement)
+{
+    CheckArguments(linear, rowPitch, tiled, width, bytesPerElement);
+
+    const uint32_t patternIndex = GetPatternIndex(bytesPerElement);
+    const SwizzlePattern& pattern = Patterns[patternIndex];
+    const ChunkOrigin* origins = GetChunkOrigins(patternIndex);
+    const uint32_t tileRowBytes = pattern.TileWidth * bytesPerElement;
+    const uint32_t rowBytes = width * bytesPerElement;
+    const uint32_t tilesAcross = (width + pattern.TileWidth - 1) / pattern.TileWidth;
+    const uint32_t tilesDown = (height + pattern.TileHeight - 1) / pattern.TileHeight;
+    const bool stream = (reinterpret_cast<uintptr_t>(tiled) & (ChunkBytes - 1)) == 0;
+
+    const uint8_t* source = static_cast<const uint8_t*>(linear);
+    uint8_t* dest = static_cast<uint8_t*>(tiled);
+    for (uint32_t tileY = 0; tileY < tilesDown; ++tileY)
+    {
+        for (uint32_t tileX = 0; tileX < tilesAcross; ++tileX, dest += TileBytes)
+        {
+            const uint32_t x0 = tileX * tileRowBytes;
+            const uint32_t y0 = tileY * pattern.TileHeight;
+            const uint8_t* tileSource = source + y0 * rowPitch + x0;
+
+            if (x0 + tileRowBytes <= rowBytes && y0 + pattern.TileHeight <= height)
+            {
+                if (stream)
+                {
+                    for (uint32_t chunk = 0; chunk < ChunksPerTile; ++chunk)
+                    {
+                        StreamChunk(dest + chunk * ChunkBytes, tileSource + origins[chunk].Y * rowPitch + origins[chunk].X);
+                    }
+                }
+                else
+                {
+                    for (uint32_t chunk = 0; chunk < ChunksPerTile; ++chunk)
+                    {
+                        CopyChunk(dest + chunk * ChunkBytes, tileSource + origins[chunk].Y * rowPitch + origins[chunk].X);
+                    }
+                }
+                continue;
+            }
+
+            // Edge tile.
+            for (uint32_t chunk = 0; chunk < ChunksPerTile; ++chunk)
+            {
+                const uint32_t x = x0 + origins[chunk].X;
+                const uint32_t y = y0 + origins[chunk].Y;
+                if (y < height && x + ChunkBytes <= rowBytes)
+                {
+                    CopyChunk(dest + chunk * ChunkBytes, source + y * rowPitch + x);
+                }
+                else
+                {
+                    uint8_t partial[ChunkBytes];
+                    GatherPartialChunk(partial, source, rowPitch, x, y, rowBytes, height);
+                    CopyChunk(dest + chunk * ChunkBytes, partial);
+                }
+            }
+        }
+    }
+
+    if (stream)
+    {
+        StreamFence();
+    }
+}
+
+void UnswizzleStandard64KB(const void* tiled, void* linear, size_t rowPitch, uint32_t width, uint32_t height, uint32_t bytesPerElement)
+{
+    CheckArguments(linear, rowPitch, tiled, width, bytesPerElement);
+
+    const uint32_t patternIndex = GetPatternIndex(bytesPerElement);
+    const SwizzlePattern& pattern = Patterns[patternIndex];
+    const ChunkOrigin* origins = GetChunkOrigins(patternIndex);
+    const uint32_t tileRowBytes = pattern.TileWidth * bytesPerElement;
+    const uint32_t rowBytes = width * bytesPerElement;
+    const uint32_t tilesAcross = (width + pattern.TileWidth - 1) / pattern.TileWidth;
+    const uint32_t tilesDown = (height + pattern.TileHeight - 1) / pattern.TileHeight;
+
+    const uint8_t* source = static_cast<const uint8_t*>(tiled);
+    uint8_t* dest = static_cast<uint8_t*>(linear);
+    for (uint32_t tileY = 0; tileY < tilesDown; ++tileY)
+    {
+        for (uint32_t tileX = 0; tileX < tilesAcross; ++tileX, source += TileBytes)
+        {
+            const uint32_t x0 = tileX * tileRowBytes;
+            const uint32_t y0 = tileY * pattern.TileHeight;
+            uint8_t* tileDest = dest + y0 * rowPitch + x0;
+
+            if (x0 + tileRowBytes <= rowBytes && y0 + pattern.TileHeight <= height)
+            {
+                for (uint32_t chunk = 0; chunk < ChunksPerTile; ++chunk)
+                {
+                    CopyChunk(tileDest + origins[chunk].Y * rowPitch + origins[chunk].X, source + chunk * ChunkBytes);
+                }
+                continue;
+            }
+
+            for (uint32_t chunk = 0; chunk < ChunksPerTile; ++chunk)
+            {
+                const uint32_t x = x0 + origins[chunk].X;
+                const uint32_t y = y0 + origins[chunk].Y;
+                if (y < height && x < rowBytes)
+                {
+                    const uint32_t count = rowBytes - x < ChunkBytes ? rowBytes - x : ChunkBytes;
+                    memcpy(dest + y * rowPitch + x, source + chunk * ChunkBytes, count);
+                }
+            }
+        }
+    }
+}
+
+void SwizzleStandard64KBReference(const void* linear, size_t rowPitch, void* tiled, uint32_t width, uint32_t height, uint32_t bytesPerElement)
+{
+    CheckArguments(linear, rowPitch, tiled, width, bytesPerElement);
+
+    const SwizzlePattern& pattern = Patterns[GetPatternIndex(bytesPerElement)];
+    const uint32_t tilesAcross = (width + pattern.TileWidth - 1) / pattern.TileWidth;
+    memset(tiled, 0, static_cast<size_t>(GetStandardSwizzleSize(width, height, bytesPerElement)));
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const uint64_t tile = static_cast<uint64_t>(y / pattern.TileHeight) * tilesAcross + x / pattern.TileWidth;
+            const uint64_t address = tile * TileBytes +
+                DepositBits(x % pattern.TileWidth, pattern.XMask) + DepositBits(y % pattern.TileHeight, pattern.YMask);
+            memcpy(static_cast<uint8_t*>(tiled) + address, static_cast<const uint8_t*>(linear) + y * rowPitch + x * bytesPerElement, bytesPerElement);
+        }
+    }
+}
+
+void UnswizzleStandard64KBReference(const void* tiled, void* linear, size_t rowPitch, uint32_t width, uint32_t height, uint32_t bytesPerElement)
+{
+    CheckArguments(linear, rowPitch, tiled, width, bytesPerElement);
+
+    const SwizzlePattern& pattern = Patterns[GetPatternIndex(bytesPerElement)];
+    const uint32_t tilesAcross = (width + pattern.TileWidth - 1) / pattern.TileWidth;
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const uint64_t tile = static_cast<uint64_t>(y / pattern.TileHeight) * tilesAcross + x / pattern.TileWidth;
+            const uint64_t address = tile * TileBytes +
+                DepositBits(x % pattern.TileWidth, pattern.XMask) + DepositBits(y % pattern.TileHeight, pattern.YMask);
+            memcpy(static_cast<uint8_t*>(linear) + y * rowPitch + x * bytesPerElement, static_cast<const uint8_t*>(tiled) + address, bytesPerElement);
+        }
+    }
+}
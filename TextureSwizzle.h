@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CPU tiling into D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE, so that on UMA adapters a texture in
+// CPU-visible memory can be written in its final layout, with no upload heap and no GPU copy.
+//
+// The layout covers a subresource with 64KB tiles, row-major. Within a tile the bits of the byte
+// address interleave the element coordinates in a fixed pattern per element size; every pattern
+// keeps 16 bytes of a row together, so tiling is a permutation of 16-byte chunks.
+// Element sizes are 1, 2, 4, 8 or 16 bytes (the 4x4 blocks of block compressed formats count as
+// elements). Only a single 2D subresource without mip tail is handled: mip 0 of a texture with
+// one mip level.
+
+// Tile size in elements. Throws std::invalid_argument for other element sizes.
+void GetStandardSwizzleTileShape(uint32_t bytesPerElement, uint32_t& tileWidth, uint32_t& tileHeight);
+
+// Bytes of the tiled subresource: whole tiles covering width x height elements.
+uint64_t GetStandardSwizzleSize(uint32_t width, uint32_t height, uint32_t bytesPerElement);
+
+// Linear rows to tiles. The destination is written front to back, whole tiles including the
+// padding outside the texture (zeroed), and never read: it can be the write-combined mapping of
+// the texture. A 16-byte aligned destination gets streaming stores.
+void SwizzleStandard64KB(
+    const void* linear,
+    size_t rowPitch,
+    void* tiled,
+    uint32_t width,
+    uint32_t height,
+    uint32_t bytesPerElement);
+
+// Tiles to linear rows; the source is read front to back.
+void UnswizzleStandard64KB(
+    const void* tiled,
+    void* linear,
+    size_t rowPitch,
+    uint32_t width,
+    uint32_t height,
+    uint32_t bytesPerElement);
+
+// One element at a time, depositing the coordinate bits into the address as the layout defines
+// them; what the chunk kernels above are checked against.
+void SwizzleStandard64KBReference(const void* linear, size_t rowPitch, void* tiled, uint32_t width, uint32_t height, uint32_t bytesPerElement);
+void UnswizzleStandard64KBReference(const void* tiled, void* linear, size_t rowPitch, uint32_t width, uint32_t height, uint32_t bytesPerElement);
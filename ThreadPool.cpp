@@ -0,0 +1,149 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+ThreadPool::ThreadPool(uint32_t threadCount) :
+    m_stopping(false)
+{
+    if (threadCount == 0)
+    {
+        const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    m_workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    if (m_workers.empty())
+    {
+        // No workers (single core machine): run inline so jobs still make progress.
+        job();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping && m_jobs.empty())
+            {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop();
+        }
+        job();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fn)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    const size_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (chunkCount == 1 || m_workers.empty())
+    {
+        fn(0, count);
+        return;
+    }
+
+    // Helpers may still be sitting in the queue after the caller has finished every chunk,
+    // so the shared state has to outlive this call.
+    struct State
+    {
+        std::atomic<size_t> nextChunk{ 0 };
+        std::atomic<size_t> doneChunks{ 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+
+    // Chunks are claimed one at a time, so a helper that starts late simply finds nothing left.
+    // fn is only touched for a successfully claimed chunk, which the caller always waits on.
+    auto runChunks = [state, count, grainSize, chunkCount, &fn]()
+    {
+        for (;;)
+        {
+            const size_t chunk = state->nextChunk.fetch_add(1);
+            if (chunk >= chunkCount)
+            {
+                return;
+            }
+
+            const size_t begin = chunk * grainSize;
+            try
+            {
+                fn(begin, std::min(begin + grainSize, count));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error)
+                {
+                    state->error = std::current_exception();
+                }
+            }
+
+            if (state->doneChunks.fetch_add(1) + 1 == chunkCount)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    const size_t helperCount = std::min(chunkCount - 1, m_workers.size());
+    for (size_t i = 0; i < helperCount; ++i)
+    {
+        Submit(runChunks);
+    }
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state, chunkCount] { return state->doneChunks.load() == chunkCount; });
+
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads shared by the CPU side systems (geometry processing, culling,
+// transform updates...).
+// ParallelFor lets the calling thread take part in the work, so it is safe to call it from
+// inside a job that is itself running on the pool.
+class ThreadPool
+{
+public:
+    // threadCount is the number of worker threads. 0 picks hardware_concurrency - 1 so that
+    // workers plus the calling thread fill the machine.
+    explicit ThreadPool(uint32_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads that can run a ParallelFor at the same time (workers + caller).
+    uint32_t GetConcurrency() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+
+    // Queues a job for a worker thread.
+    void Submit(std::function<void()> job);
+
+    // Splits [0, count) into chunks of at most grainSize elements and calls fn(begin, end) for
+    // each one across the pool. Returns once every chunk has run. The first exception thrown
+    // by fn is rethrown on the calling thread. Without workers, fn gets the whole range at once.
+    void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+};
@@ -0,0 +1,119 @@
+#include "TimelineFence.h"
+
+TimelineFence::TimelineFence() :
+    m_lastSignaled(0),
+    m_completed(0)
+{
+}
+
+uint64_t TimelineFence::Signal()
+{
+    // Values must reach the queue in order, so taking the value and signaling it are one step.
+    std::lock_guard<std::mutex> lock(m_signalMutex);
+    const uint64_t value = m_lastSignaled.load(std::memory_order_relaxed) + 1;
+    SignalValue(value);
+    m_lastSignaled.store(value, std::memory_order_release);
+    return value;
+}
+
+uint64_t TimelineFence::GetCompletedValue()
+{
+    const uint64_t completed = QueryCompletedValue();
+
+    // Keep the cache monotonic when several threads refresh it at once.
+    uint64_t cached = m_completed.load(std::memory_order_relaxed);
+    while (cached < completed && !m_completed.compare_exchange_weak(cached, completed, std::memory_order_relaxed))
+    {
+    }
+    return completed > cached ? completed : cached;
+}
+
+bool TimelineFence::IsComplete(uint64_t value)
+{
+    return value <= m_completed.load(std::memory_order_relaxed) || value <= GetCompletedValue();
+}
+
+void TimelineFence::Wait(uint64_t value)
+{
+    if (!IsComplete(value))
+    {
+        WaitForValue(value);
+        GetCompletedValue();
+    }
+}
+
+void SimulatedTimelineFence::Complete(uint64_t value)
+{
+    uint64_t completed = m_simulatedCompleted.load(std::memory_order_relaxed);
+    while (completed < value && !m_simulatedCompleted.compare_exchange_weak(completed, value, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+DeferredReleaseQueue::~DeferredReleaseQueue()
+{
+    for (Timeline& timeline : m_timelines)
+    {
+        for (const Entry& entry : timeline.Entries)
+        {
+            entry.Release(entry.Object);
+        }
+    }
+}
+
+void DeferredReleaseQueue::Release(TimelineFence& timeline, uint64_t fenceValue, void* object, ReleaseFunction release)
+{
+    if (!object)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Timeline* target = nullptr;
+    for (Timeline& existing : m_timelines)
+    {
+        if (existing.Fence == &timeline)
+        {
+            target = &existing;
+            break;
+        }
+    }
+    if (!target)
+    {
+        m_timelines.push_back({ &timeline, std::deque<Entry>() });
+        target = &m_timelines.back();
+    }
+
+    target->Entries.push_back({ fenceValue, object, release });
+    m_pendingCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t DeferredReleaseQueue::Collect()
+{
+    std::vector<Entry> releasing;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Timeline& timeline : m_timelines)
+        {
+            if (timeline.Entries.empty())
+            {
+                continue;
+            }
+
+            const uint64_t completed = timeline.Fence->GetCompletedValue();
+            while (!timeline.Entries.empty() && timeline.Entries.front().FenceValue <= completed)
+            {
+                releasing.push_back(timeline.Entries.front());
+                timeline.Entries.pop_front();
+            }
+        }
+        m_pendingCount.fetch_sub(releasing.size(), std::memory_order_relaxed);
+    }
+
+    // Release functions may be slow (freeing memory) or queue more releases: not under the lock.
+    for (const Entry& entry : releasing)
+    {
+        entry.Release(entry.Object);
+    }
+    return releasing.size();
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// One GPU timeline: a queue and the fence it signals. Every Signal uses the next value, so a value
+// identifies all the work submitted before it, and once the GPU has passed it that work is done.
+// The graphics API part (signal, query, wait) is supplied by a derived class.
+class TimelineFence
+{
+public:
+    TimelineFence();
+    virtual ~TimelineFence() {}
+
+    TimelineFence(const TimelineFence&) = delete;
+    TimelineFence& operator=(const TimelineFence&) = delete;
+
+    // Signals the next value after the work submitted so far and returns it.
+    uint64_t Signal();
+    uint64_t GetLastSignaledValue() const { return m_lastSignaled.load(std::memory_order_acquire); }
+
+    // Queries the GPU only when the cached completed value is not already past the value.
+    bool IsComplete(uint64_t value);
+    uint64_t GetCompletedValue();
+
+    // Blocks until the value has completed. Returns immediately if it already has.
+    void Wait(uint64_t value);
+    // Signals and waits for everything submitted so far.
+    void Flush() { Wait(Signal()); }
+
+protected:
+    virtual void SignalValue(uint64_t value) = 0;
+    virtual uint64_t QueryCompletedValue() = 0;
+    virtual void WaitForValue(uint64_t value) = 0;
+
+private:
+    std::mutex m_signalMutex;
+    std::atomic<uint64_t> m_lastSignaled;
+    std::atomic<uint64_t> m_completed;
+};
+
+// Timeline without a GPU, for tools and for testing on any platform. Values complete when
+// Complete is called (from any thread), or when a CPU wait needs them, as if the GPU had just
+// finished the work.
+class SimulatedTimelineFence : public TimelineFence
+{
+public:
+    SimulatedTimelineFence() : m_simulatedCompleted(0) {}
+
+    // The simulated GPU reaches the value. Values never go back.
+    void Complete(uint64_t value);
+
+protected:
+    void SignalValue(uint64_t /*value*/) override {}
+    uint64_t QueryCompletedValue() override { return m_simulatedCompleted.load(std::memory_order_acquire); }
+    void WaitForValue(uint64_t value) override { Complete(value); }
+
+private:
+    std::atomic<uint64_t> m_simulatedCompleted;
+};
+
+// Keeps objects alive until the GPU is done with them, instead of flushing the GPU to free them.
+// An object is queued with the timeline value signaled after its last use and released by the
+// first Collect that sees that value completed. Any number of timelines (queues) can share one
+// queue; an object used on several queues goes on the timeline that finishes last, typically
+// the one that waited on the others.
+// Release may be called from any thread. Releases run on the thread calling Collect.
+class DeferredReleaseQueue
+{
+public:
+    typedef void (*ReleaseFunction)(void* object);
+
+    DeferredReleaseQueue() : m_pendingCount(0) {}
+    // Releases whatever is left without waiting: the owner must have waited for the GPU.
+    ~DeferredReleaseQueue();
+
+    DeferredReleaseQueue(const DeferredReleaseQueue&) = delete;
+    DeferredReleaseQueue& operator=(const DeferredReleaseQueue&) = delete;
+
+    void Release(TimelineFence& timeline, uint64_t fenceValue, void* object, ReleaseFunction release);
+
+    // Takes over one reference of a COM style object (anything with Release()).
+    template <typename T>
+    void Release(TimelineFence& timeline, uint64_t fenceValue, T* object)
+    {
+        Release(timeline, fenceValue, object, [](void* p) { static_cast<T*>(p)->Release(); });
+    }
+
+    // Releases every object whose fence value has completed. Returns how many were released.
+    size_t Collect();
+
+    size_t GetPendingCount() const { return m_pendingCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry
+    {
+        uint64_t FenceValue;
+        void* Object;
+        ReleaseFunction Release;
+    };
+
+    // Entries of one timeline in submission order. Fence values only grow along a timeline, so
+    // the completed entries are always at the front. An entry queued with an older value than
+    // the one before it is released late, never early.
+    struct Timeline
+    {
+        TimelineFence* Fence;
+        std::deque<Entry> Entries;
+    };
+
+    std::mutex m_mutex;
+    std::vector<Timeline> m_timelines;
+    std::atomic<size_t> m_pendingCount;
+};
@@ -0,0 +1,185 @@
+#include "TransformSystem.h"
+#include "ThreadPool.h"
+
+#include <stdexcept>
+
+using namespace DirectX;
+
+namespace
+{
+    // Objects per ParallelFor chunk. Large enough to amortise scheduling, small enough
+    // to balance 100k objects across the workers.
+    const size_t UpdateGrainSize = 1024;
+}
+
+TransformSystem::TransformSystem() :
+    m_levelsDirty(false)
+{
+}
+
+void TransformSystem::Reserve(uint32_t objectCount)
+{
+    m_parent.reserve(objectCount);
+    m_depth.reserve(objectCount);
+    m_localPosition.reserve(objectCount);
+    m_localRotation.reserve(objectCount);
+    m_localScale.reserve(objectCount);
+    m_localCenter.reserve(objectCount);
+    m_localExtents.reserve(objectCount);
+    m_spinAxis.reserve(objectCount);
+    m_spinSpeed.reserve(objectCount);
+    m_world.reserve(objectCount);
+    m_worldCenter.reserve(objectCount);
+    m_worldExtents.reserve(objectCount);
+}
+
+uint32_t TransformSystem::AddObject(uint32_t parent, const XMFLOAT3& position, const XMFLOAT4& rotation, float scale)
+{
+    const uint32_t object = GetObjectCount();
+    if (parent != NoParent && parent >= object)
+    {
+        throw std::invalid_argument("TransformSystem: parent must be added before its children");
+    }
+
+    m_parent.push_back(parent);
+    m_depth.push_back(parent == NoParent ? 0 : m_depth[parent] + 1);
+    m_localPosition.push_back(position);
+    m_localRotation.push_back(rotation);
+    m_localScale.push_back(scale);
+    m_localCenter.push_back(XMFLOAT3(0.0f, 0.0f, 0.0f));
+    m_localExtents.push_back(XMFLOAT3(0.0f, 0.0f, 0.0f));
+    m_spinAxis.push_back(XMFLOAT3(0.0f, 1.0f, 0.0f));
+    m_spinSpeed.push_back(0.0f);
+
+    XMFLOAT4X4 identity;
+    XMStoreFloat4x4(&identity, XMMatrixIdentity());
+    m_world.push_back(identity);
+    m_worldCenter.push_back(position);
+    m_worldExtents.push_back(XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+    m_levelsDirty = true;
+    return object;
+}
+
+void TransformSystem::SetSpin(uint32_t object, const XMFLOAT3& axis, float radiansPerSecond)
+{
+    XMStoreFloat3(&m_spinAxis[object], XMVector3Normalize(XMLoadFloat3(&axis)));
+    m_spinSpeed[object] = radiansPerSecond;
+}
+
+void TransformSystem::SetLocalBounds(uint32_t object, const XMFLOAT3& center, const XMFLOAT3& extents)
+{
+    m_localCenter[object] = center;
+    m_localExtents[object] = extents;
+}
+
+void TransformSystem::RebuildLevels()
+{
+    // Counting sort by depth. Objects keep their relative order inside a depth, so flat scenes
+    // (everything at depth 0) are walked in plain array order.
+    uint32_t maxDepth = 0;
+    for (uint32_t depth : m_depth)
+    {
+        maxDepth = depth > maxDepth ? depth : maxDepth;
+    }
+
+    m_levelOffsets.assign(maxDepth + 2, 0);
+    for (uint32_t depth : m_depth)
+    {
+        m_levelOffsets[depth + 1]++;
+    }
+    for (uint32_t d = 0; d <= maxDepth; ++d)
+    {
+        m_levelOffsets[d + 1] += m_levelOffsets[d];
+    }
+
+    m_levelOrder.resize(m_depth.size());
+    std::vector<uint32_t> cursor(m_levelOffsets.begin(), m_levelOffsets.end() - 1);
+    for (uint32_t object = 0; object < GetObjectCount(); ++object)
+    {
+        m_levelOrder[cursor[m_depth[object]]++] = object;
+    }
+
+    m_levelsDirty = false;
+}
+
+void TransformSystem::UpdateRange(
+    const uint32_t* objects,
+    size_t count,
+    float deltaSeconds,
+    FXMMATRIX viewProjection,
+    ObjectConstants* constants)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint32_t object = objects[i];
+
+        XMVECTOR rotation = XMLoadFloat4(&m_localRotation[object]);
+        const float spin = m_spinSpeed[object] * deltaSeconds;
+        if (spin != 0.0f)
+        {
+            const XMVECTOR delta = XMQuaternionRotationNormal(XMLoadFloat3(&m_spinAxis[object]), spin);
+            rotation = XMQuaternionNormalize(XMQuaternionMultiply(rotation, delta));
+            XMStoreFloat4(&m_localRotation[object], rotation);
+        }
+
+        XMMATRIX world = XMMatrixAffineTransformation(
+            XMVectorReplicate(m_localScale[object]),
+            XMVectorZero(),
+            rotation,
+            XMLoadFloat3(&m_localPosition[object]));
+
+        const uint32_t parent = m_parent[object];
+        if (parent != NoParent)
+        {
+            world = XMMatrixMultiply(world, XMLoadFloat4x4(&m_world[parent]));
+        }
+
+        XMStoreFloat4x4(&m_world[object], world);
+
+        // World box of the local box: the center is transformed, and each world axis extent is
+        // the sum of the local extents projected on it through the absolute basis vectors.
+        const XMVECTOR localExtents = XMLoadFloat3(&m_localExtents[object]);
+        XMVECTOR worldExtents = XMVectorMultiply(XMVectorAbs(world.r[0]), XMVectorSplatX(localExtents));
+        worldExtents = XMVectorMultiplyAdd(XMVectorAbs(world.r[1]), XMVectorSplatY(localExtents), worldExtents);
+        worldExtents = XMVectorMultiplyAdd(XMVectorAbs(world.r[2]), XMVectorSplatZ(localExtents), worldExtents);
+        XMStoreFloat3(&m_worldCenter[object], XMVector3Transform(XMLoadFloat3(&m_localCenter[object]), world));
+        XMStoreFloat3(&m_worldExtents[object], worldExtents);
+
+        if (constants)
+        {
+            ObjectConstants& dest = constants[object];
+            XMStoreFloat4x4(&dest.WorldViewProjection, XMMatrixTranspose(XMMatrixMultiply(world, viewProjection)));
+            XMStoreFloat4x4(&dest.World, XMMatrixTranspose(world));
+        }
+    }
+}
+
+void TransformSystem::Update(float deltaSeconds, FXMMATRIX viewProjection, ObjectConstants* constants, ThreadPool* pool)
+{
+    if (m_levelsDirty)
+    {
+        RebuildLevels();
+    }
+
+    // FXMMATRIX may be passed in registers; keep a copy the worker lambdas can capture.
+    const XMMATRIX viewProj = viewProjection;
+
+    for (size_t level = 0; level + 1 < m_levelOffsets.size(); ++level)
+    {
+        const uint32_t* objects = m_levelOrder.data() + m_levelOffsets[level];
+        const size_t count = m_levelOffsets[level + 1] - m_levelOffsets[level];
+
+        if (pool)
+        {
+            pool->ParallelFor(count, UpdateGrainSize, [&](size_t begin, size_t end)
+            {
+                UpdateRange(objects + begin, end - begin, deltaSeconds, viewProj, constants);
+            });
+        }
+        else
+        {
+            UpdateRange(objects, count, deltaSeconds, viewProj, constants);
+        }
+    }
+}
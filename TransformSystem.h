@@ -0,0 +1,96 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Per-object shader constants. Each object owns one 256 byte slot
+// (D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT) so a root CBV can point straight at it.
+// Matrices are stored transposed for HLSL's default column-major packing.
+struct ObjectConstants
+{
+    DirectX::XMFLOAT4X4 WorldViewProjection;
+    DirectX::XMFLOAT4X4 World;
+    float Padding[32];
+};
+static_assert(sizeof(ObjectConstants) == 256, "ObjectConstants must fill exactly one constant buffer slot.");
+
+// Data-oriented transform hierarchy.
+// Every per-object attribute lives in its own array (structure of arrays), so the update loop
+// streams through memory linearly. Objects are processed one hierarchy depth at a time: all
+// objects of a depth are independent of each other and are split across the thread pool,
+// while their parents were finished by the previous depth.
+class TransformSystem
+{
+public:
+    static const uint32_t NoParent = 0xFFFFFFFF;
+
+    TransformSystem();
+
+    // parent must be NoParent or an object that was added earlier.
+    uint32_t AddObject(
+        uint32_t parent,
+        const DirectX::XMFLOAT3& position,
+        const DirectX::XMFLOAT4& rotation,
+        float scale);
+
+    void Reserve(uint32_t objectCount);
+    void SetLocalPosition(uint32_t object, const DirectX::XMFLOAT3& position) { m_localPosition[object] = position; }
+    void SetSpin(uint32_t object, const DirectX::XMFLOAT3& axis, float radiansPerSecond);
+
+    // Object space bounding box, transformed to a world space box by Update.
+    void SetLocalBounds(uint32_t object, const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents);
+
+    uint32_t GetObjectCount() const { return static_cast<uint32_t>(m_parent.size()); }
+    const DirectX::XMFLOAT4X4& GetWorld(uint32_t object) const { return m_world[object]; }
+    const DirectX::XMFLOAT3& GetWorldCenter(uint32_t object) const { return m_worldCenter[object]; }
+    const DirectX::XMFLOAT3& GetWorldExtents(uint32_t object) const { return m_worldExtents[object]; }
+
+    // Advances the spin animation, recomputes world matrices and writes each object's constants
+    // to constants[object]. constants is meant to point into persistently mapped upload memory:
+    // it is only ever written, front to back, never read.
+    void Update(
+        float deltaSeconds,
+        DirectX::FXMMATRIX viewProjection,
+        ObjectConstants* constants,
+        ThreadPool* pool = nullptr);
+
+private:
+    void RebuildLevels();
+
+    void UpdateRange(
+        const uint32_t* objects,
+        size_t count,
+        float deltaSeconds,
+        DirectX::FXMMATRIX viewProjection,
+        ObjectConstants* constants);
+
+    // Hierarchy.
+    std::vector<uint32_t> m_parent;
+    std::vector<uint32_t> m_depth;
+
+    // Local transform.
+    std::vector<DirectX::XMFLOAT3> m_localPosition;
+    std::vector<DirectX::XMFLOAT4> m_localRotation;
+    std::vector<float> m_localScale;
+
+    // Bounds.
+    std::vector<DirectX::XMFLOAT3> m_localCenter;
+    std::vector<DirectX::XMFLOAT3> m_localExtents;
+
+    // Animation.
+    std::vector<DirectX::XMFLOAT3> m_spinAxis;
+    std::vector<float> m_spinSpeed;
+
+    // Output.
+    std::vector<DirectX::XMFLOAT4X4> m_world;
+    std::vector<DirectX::XMFLOAT3> m_worldCenter;
+    std::vector<DirectX::XMFLOAT3> m_worldExtents;
+
+    // Objects sorted by depth; depth d covers m_levelOrder[m_levelOffsets[d] .. m_levelOffsets[d + 1]).
+    std::vector<uint32_t> m_levelOrder;
+    std::vector<uint32_t> m_levelOffsets;
+    bool m_levelsDirty;
+};
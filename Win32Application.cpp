@@ -13,18 +13,49 @@
 #include "Win32Application.h"
 
 HWND Win32Application::m_hwnd = nullptr;
+RenderThread* Win32Application::m_renderThread = nullptr;
+std::mutex Win32Application::m_windowTextMutex;
+std::wstring Win32Application::m_windowText;
+bool Win32Application::m_windowTextPosted = false;
+
+namespace
+{
+    // Posted by the render thread once it has finished: the window can go.
+    const UINT WM_RENDERTHREADEXITED = WM_APP;
+    // Posted by PostWindowText: m_windowText holds the new title.
+    const UINT WM_POSTEDWINDOWTEXT = WM_APP + 1;
+
+    // Shows what stopped the render thread. The window is gone by now, so the box has no owner.
+    void ReportRenderThreadError(const std::exception_ptr& error)
+    {
+        std::string message = "The render thread stopped on an unknown error.";
+        try
+        {
+            std::rethrow_exception(error);
+        }
+        catch (const std::exception& e)
+        {
+            message = e.what();
+        }
+        catch (...)
+        {
+        }
+        OutputDebugStringA((message + "\n").c_str());
+        MessageBoxA(nullptr, message.c_str(), "DX12Study", MB_OK | MB_ICONERROR);
+    }
+}
 
 int Win32Application::Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow)
 {
     // Parse the command line parameters
-    //   Ű   мѴ.
+    // 명령 줄 매개 변수를 구분 분석한다.
     int argc;
     LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
     pSample->ParseCommandLineArgs(argv, argc);
     LocalFree(argv);
 
     // Initialize the window class.
-    //  Ŭ ʱȭ Ѵ.
+    // 윈도우 클래스를 초기화 한다.
     WNDCLASSEX windowClass = { 0 };
     windowClass.cbSize = sizeof(WNDCLASSEX);
     windowClass.style = CS_HREDRAW | CS_VREDRAW;
@@ -34,13 +65,13 @@ int Win32Application::Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow)
     windowClass.lpszClassName = L"DXSampleClass";
     RegisterClassEx(&windowClass);
 
-    //  ũ⸦ ϴ  ƴ Ŭ̾Ʈ ũ⸦ ϴ .
-    //  ũ⸸ Ѵٸ      ϴ ȼ  © δ.
+    // 윈도우의 크기를 조절하는 것이 아닌 클라이언트의 크기를 조정하는 것.
+    // 윈도우의 크기만 조절한다면 실제 렌더링 했을 때 오른쪽 하단의 픽셀 영역이 짤려 보인다.
     RECT windowRect = { 0, 0, static_cast<LONG>(pSample->GetWidth()), static_cast<LONG>(pSample->GetHeight()) };
     AdjustWindowRect(&windowRect, WS_OVERLAPPEDWINDOW, FALSE);
 
     // Create the window and store a handle to it.
-    // 츦  ڵ Ѵ.
+    // 윈도우를 만들고 핸들을 저장한다.
     m_hwnd = CreateWindow(
         windowClass.lpszClassName,
         pSample->GetTitle(),
@@ -55,35 +86,77 @@ int Win32Application::Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow)
         pSample);
 
     // Initialize the sample. OnInit is defined in each child-implementation of DXSample.
-    // Sample  ʱȭѴ. OnInit  DXSample  ڽ Ŭ ǵȴ.
+    // Sample 을 초기화한다. OnInit 은 DXSample 의 자식 클래스에서 정의된다.
     pSample->OnInit();
 
+    // From here on the frames run on the render thread, which also destroys the sample.
+    // 이제부터 프레임은 렌더 스레드에서 실행하고, 샘플의 정리도 렌더 스레드가 한다.
+    RenderThread renderThread;
+    m_renderThread = &renderThread;
+
     ShowWindow(m_hwnd, nCmdShow);
 
-    // Main sample loop.
-    MSG msg = {};
-    while (msg.message != WM_QUIT)
+    RenderThreadHandlers handlers;
+    handlers.Event = [pSample](const WindowEvent& event)
     {
-        // Process any messages in the queue.
-        // ť ִ ޽ óѴ.
-        if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+        if (event.Type == WindowEventType::KeyDown)
+        {
+            pSample->OnKeyDown(static_cast<UINT8>(event.Value));
+        }
+        else
         {
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
+            pSample->OnKeyUp(static_cast<UINT8>(event.Value));
         }
+    };
+    handlers.Resize = [pSample](uint32_t width, uint32_t height) { pSample->OnSizeChanged(width, height); };
+    handlers.Frame = [pSample]()
+    {
+        pSample->OnUpdate();
+        pSample->OnRender();
+    };
+    handlers.Shutdown = [pSample]() { pSample->OnDestroy(); };
+    handlers.Exited = []() { PostMessage(m_hwnd, WM_RENDERTHREADEXITED, 0, 0); };
+    renderThread.Start(std::move(handlers), pSample->GetWidth(), pSample->GetHeight());
+
+    // Main sample loop. Rendering doesn't depend on it anymore, so it waits for messages instead
+    // of polling. 렌더링이 메시지 루프와 분리되어 있으므로 메시지가 올 때까지 기다린다.
+    MSG msg = {};
+    while (GetMessage(&msg, NULL, 0, 0) > 0)
+    {
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
     }
 
-    pSample->OnDestroy();
+    // Reports what stopped the render thread, a lost device for one. The sample was destroyed on
+    // the render thread either way, so only the exit code differs.
+    // 렌더 스레드를 멈추게 한 오류(장치 제거 등)를 알리고 실패 코드로 끝낸다.
+    m_renderThread = nullptr;
+    const std::exception_ptr error = renderThread.Join();
+    if (error)
+    {
+        ReportRenderThreadError(error);
+        return EXIT_FAILURE;
+    }
 
     // Return this part of the WM_QUIT message to Windows.
     return static_cast<char>(msg.wParam);
 }
 
+void Win32Application::PostWindowText(const std::wstring& text)
+{
+    // One message however many titles come before the window thread gets to it.
+    // 창 스레드가 처리하기 전에 여러 번 바뀌어도 메시지는 하나만 보낸다.
+    std::lock_guard<std::mutex> lock(m_windowTextMutex);
+    m_windowText = text;
+    if (!m_windowTextPosted)
+    {
+        m_windowTextPosted = PostMessage(m_hwnd, WM_POSTEDWINDOWTEXT, 0, 0) != FALSE;
+    }
+}
+
 // Main message handler for the sample.
 LRESULT CALLBACK Win32Application::WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
-    DXSample* pSample = reinterpret_cast<DXSample*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
-
     switch (message)
     {
     case WM_CREATE:
@@ -94,28 +167,62 @@ LRESULT CALLBACK Win32Application::WindowProc(HWND hWnd, UINT message, WPARAM wP
     }
     return 0;
 
+    // Input goes to the render thread through its event ring; when the ring is full the key is
+    // dropped rather than waiting on the render thread.
+    // 입력은 렌더 스레드의 이벤트 링으로 보낸다. 링이 가득 차면 기다리지 않고 버린다.
     case WM_KEYDOWN:
-        if (pSample)
+        if (m_renderThread)
         {
-            pSample->OnKeyDown(static_cast<UINT8>(wParam));
+            m_renderThread->PostEvent({ WindowEventType::KeyDown, static_cast<uint32_t>(wParam) });
         }
         return 0;
 
     case WM_KEYUP:
-        if (pSample)
+        if (m_renderThread)
+        {
+            m_renderThread->PostEvent({ WindowEventType::KeyUp, static_cast<uint32_t>(wParam) });
+        }
+        return 0;
+
+    case WM_SIZE:
+        if (m_renderThread)
         {
-            pSample->OnKeyUp(static_cast<UINT8>(wParam));
+            m_renderThread->PostResize(LOWORD(lParam), HIWORD(lParam));
         }
         return 0;
 
     case WM_PAINT:
-        if (pSample)
+        // The render thread presents continuously; there is nothing to paint here.
+        ValidateRect(hWnd, nullptr);
+        return 0;
+
+    case WM_CLOSE:
+        // The render thread finishes its frame and destroys the sample first; the window goes
+        // once it has exited, so it stays valid for as long as the swap chain presents to it.
+        // 렌더 스레드가 샘플을 정리하고 끝난 뒤에 창을 없앤다.
+        if (m_renderThread && m_renderThread->IsRunning())
         {
-            pSample->OnUpdate();
-            pSample->OnRender();
+            m_renderThread->RequestStop();
+            return 0;
         }
+        break;
+
+    case WM_RENDERTHREADEXITED:
+        DestroyWindow(hWnd);
         return 0;
 
+    case WM_POSTEDWINDOWTEXT:
+    {
+        std::wstring text;
+        {
+            std::lock_guard<std::mutex> lock(m_windowTextMutex);
+            text.swap(m_windowText);
+            m_windowTextPosted = false;
+        }
+        SetWindowText(hWnd, text.c_str());
+    }
+    return 0;
+
     case WM_DESTROY:
         PostQuitMessage(0);
         return 0;
@@ -12,19 +12,34 @@
 #pragma once
 
 #include "DXSample.h"
+#include "RenderThread.h"
+
+#include <mutex>
+#include <string>
 
 class DXSample;
 
-// Լ static  Ǿ ܺο  Ŭ ü  ʾƵ,  Ŭ ż带 ϴ  .
+// 함수가 static 으로 선언되어 외부에서 이 클래스의 객체를 만들지 않아도, 이 클래스의 매서드를 사용하는 것이 가능.
 class Win32Application
 {
 public:
     static int Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow);
     static HWND GetHwnd() { return m_hwnd; }
+    // Sets the title from any thread without waiting: the window thread sets the latest text
+    // posted once it gets to it. 어느 스레드에서든 기다리지 않고 제목을 바꾼다.
+    static void PostWindowText(const std::wstring& text);
 
 protected:
     static LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
 private:
     static HWND m_hwnd;
+    // Runs the sample's frames; this thread only pumps the window's messages.
+    // 샘플의 프레임은 렌더 스레드가 실행하고, 이 스레드는 창 메시지만 처리한다.
+    static RenderThread* m_renderThread;
+    // The title waiting for the window thread, and whether its message is already posted.
+    // 창 스레드가 아직 적용하지 않은 제목과, 그 메시지를 이미 보냈는지 여부.
+    static std::mutex m_windowTextMutex;
+    static std::wstring m_windowText;
+    static bool m_windowTextPosted;
 };
\ No newline at end of file
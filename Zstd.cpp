@@ -0,0 +1,1069 @@
+#include "Zstd.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const uint32_t FrameMagic = 0xFD2FB528;
+    const uint32_t SkippableMagic = 0x184D2A50;     // The low 4 bits are free.
+    const size_t MaxBlockSize = 128 * 1024;
+
+    const uint32_t MaxHuffmanBits = 11;
+    const uint32_t MaxHuffmanWeightLog = 6;
+    const uint32_t MaxLiteralLengthLog = 9;
+    const uint32_t MaxMatchLengthLog = 9;
+    const uint32_t MaxOffsetLog = 8;
+    const uint32_t MaxLiteralLengthCode = 35;
+    const uint32_t MaxMatchLengthCode = 52;
+    const uint32_t MaxOffsetCode = 31;
+
+    // Default distributions of the sequence codes, for the Predefined mode.
+    const int16_t DefaultLiteralLengths[MaxLiteralLengthCode + 1] =
+    {
+        4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+        -1, -1, -1, -1
+    };
+    const int16_t DefaultMatchLengths[MaxMatchLengthCode + 1] =
+    {
+        1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+        -1, -1, -1, -1, -1
+    };
+    const int16_t DefaultOffsets[29] =
+    {
+        1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+    };
+
+    // Base value and extra bits of each code above 15 (literal lengths) and 31 (match lengths);
+    // the codes below are the length itself (plus 3 for matches).
+    const uint32_t LiteralLengthBase[MaxLiteralLengthCode + 1] =
+    {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+        16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+        8192, 16384, 32768, 65536
+    };
+    const uint8_t LiteralLengthBits[MaxLiteralLengthCode + 1] =
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+        13, 14, 15, 16
+    };
+    const uint32_t MatchLengthBase[MaxMatchLengthCode + 1] =
+    {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+        19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+        35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051,
+        4099, 8195, 16387, 32771, 65539
+    };
+    const uint8_t MatchLengthBits[MaxMatchLengthCode + 1] =
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+        12, 13, 14, 15, 16
+    };
+
+    inline uint32_t Read16(const uint8_t* p)
+    {
+        return p[0] | p[1] << 8;
+    }
+
+    inline uint32_t Read24(const uint8_t* p)
+    {
+        return p[0] | p[1] << 8 | p[2] << 16;
+    }
+
+    inline uint32_t Read32(const uint8_t* p)
+    {
+        return p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24;
+    }
+
+    inline uint64_t Read64(const uint8_t* p)
+    {
+        return Read32(p) | static_cast<uint64_t>(Read32(p + 4)) << 32;
+    }
+
+    inline uint32_t HighestBit(uint32_t value)
+    {
+        uint32_t bit = 0;
+        while (value >>= 1)
+        {
+            ++bit;
+        }
+        return bit;
+    }
+
+    inline uint64_t Rotate(uint64_t value, int bits)
+    {
+        return value << bits | value >> (64 - bits);
+    }
+
+    // XXH64 with seed 0, whose low 32 bits are the content checksum.
+    uint64_t Xxh64(const uint8_t* data, size_t size)
+    {
+        const uint64_t Prime1 = 11400714785074694791ull;
+        const uint64_t Prime2 = 14029467366897019727ull;
+        const uint64_t Prime3 = 1609587929392839161ull;
+        const uint64_t Prime4 = 9650029242287828579ull;
+        const uint64_t Prime5 = 2870177450012600261ull;
+        const auto round = [&](uint64_t acc, uint64_t input) { return Rotate(acc + input * Prime2, 31) * Prime1; };
+
+        const uint8_t* p = data;
+        const uint8_t* end = data + size;
+        uint64_t hash;
+        if (size >= 32)
+        {
+            uint64_t v[4] = { Prime1 + Prime2, Prime2, 0, 0 - Prime1 };
+            for (; end - p >= 32; p += 32)
+            {
+                for (int i = 0; i < 4; ++i)
+                {
+                    v[i] = round(v[i], Read64(p + i * 8));
+                }
+            }
+            hash = Rotate(v[0], 1) + Rotate(v[1], 7) + Rotate(v[2], 12) + Rotate(v[3], 18);
+            for (int i = 0; i < 4; ++i)
+            {
+                hash = (hash ^ round(0, v[i])) * Prime1 + Prime4;
+            }
+        }
+        else
+        {
+            hash = Prime5;
+        }
+        hash += size;
+
+        for (; end - p >= 8; p += 8)
+        {
+            hash = Rotate(hash ^ round(0, Read64(p)), 27) * Prime1 + Prime4;
+        }
+        if (end - p >= 4)
+        {
+            hash = Rotate(hash ^ Read32(p) * Prime1, 23) * Prime2 + Prime3;
+            p += 4;
+        }
+        for (; p < end; ++p)
+        {
+            hash = Rotate(hash ^ *p * Prime5, 11) * Prime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= Prime2;
+        hash ^= hash >> 29;
+        hash *= Prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    // Reads the bitstreams of Huffman and FSE coded data: from the end of the stream towards its
+    // start, each value with its bits in order. The stream ends with a 1 bit marking where the
+    // values begin. Reading past the start returns zeros and leaves GetRemaining negative.
+    class BackwardBitReader
+    {
+    public:
+        BackwardBitReader() : m_data(nullptr), m_size(0), m_position(0) {}
+
+        bool Init(const uint8_t* data, size_t size)
+        {
+            if (size == 0 || data[size - 1] == 0)
+            {
+                return false;
+            }
+            m_data = data;
+            m_size = size;
+            m_position = static_cast<int64_t>(size - 1) * 8 + HighestBit(data[size - 1]);
+            return true;
+        }
+
+        // The next bits (at most 32) without consuming them, the first one read as the highest.
+        uint32_t Peek(uint32_t bits) const
+        {
+            if (bits == 0)
+            {
+                return 0;
+            }
+            const int64_t low = m_position - bits;
+            if (low < 0)
+            {
+                return m_position <= 0 ? 0 : static_cast<uint32_t>(Load(0) & ((1ull << m_position) - 1)) << -low;
+            }
+            return static_cast<uint32_t>(Load(static_cast<size_t>(low >> 3)) >> (low & 7)) & static_cast<uint32_t>((1ull << bits) - 1);
+        }
+
+        void Skip(uint32_t bits) { m_position -= bits; }
+
+        uint32_t Read(uint32_t bits)
+        {
+            const uint32_t value = Peek(bits);
+            Skip(bits);
+            return value;
+        }
+
+        // Bits not read yet; negative once reading went past the start.
+        int64_t GetRemaining() const { return m_position; }
+
+    private:
+        uint64_t Load(size_t byte) const
+        {
+            if (byte + 8 <= m_size)
+            {
+                return Read64(m_data + byte);
+            }
+            uint64_t value = 0;
+            for (size_t i = byte; i < m_size; ++i)
+            {
+                value |= static_cast<uint64_t>(m_data[i]) << (8 * (i - byte));
+            }
+            return value;
+        }
+
+        const uint8_t* m_data;
+        size_t m_size;
+        int64_t m_position;
+    };
+
+    struct FseEntry
+    {
+        uint16_t NewState;
+        uint8_t Symbol;
+        uint8_t Bits;
+    };
+
+    // A finite state entropy decoding table: 1 << Log states.
+    struct FseTable
+    {
+        std::vector<FseEntry> States;
+        uint32_t Log = 0;
+    };
+
+    // Builds the table of a normalized distribution; -1 is a probability "less than 1".
+    bool BuildFseTable(const int16_t* counts, uint32_t symbolCount, uint32_t log, FseTable& table)
+    {
+        const uint32_t size = 1u << log;
+        table.Log = log;
+        table.States.assign(size, FseEntry());
+
+        uint16_t next[256];
+        uint32_t highThreshold = size - 1;
+        for (uint32_t s = 0; s < symbolCount; ++s)
+        {
+            if (counts[s] == -1)
+            {
+                table.States[highThreshold--].Symbol = static_cast<uint8_t>(s);
+                next[s] = 1;
+            }
+            else
+            {
+                next[s] = static_cast<uint16_t>(counts[s]);
+            }
+        }
+
+        const uint32_t step = (size >> 1) + (size >> 3) + 3;
+        const uint32_t mask = size - 1;
+        uint32_t position = 0;
+        for (uint32_t s = 0; s < symbolCount; ++s)
+        {
+            for (int i = 0; i < counts[s]; ++i)
+            {
+                table.States[position].Symbol = static_cast<uint8_t>(s);
+                do
+                {
+                    position = (position + step) & mask;
+                } while (position > highThreshold);
+            }
+        }
+        if (position != 0)
+        {
+            return false;
+        }
+
+        for (FseEntry& entry : table.States)
+        {
+            const uint32_t state = next[entry.Symbol]++;
+            entry.Bits = static_cast<uint8_t>(log - HighestBit(state));
+            entry.NewState = static_cast<uint16_t>((state << entry.Bits) - size);
+        }
+        return true;
+    }
+
+    // A table that always decodes symbol, with no bits (the RLE mode).
+    void BuildRleTable(uint8_t symbol, FseTable& table)
+    {
+        table.Log = 0;
+        table.States.assign(1, FseEntry());
+        table.States[0].Symbol = symbol;
+    }
+
+    // Reads a normalized distribution (the FSE table description) from the start of data, and
+    // builds its table. Returns the bytes read, or 0 if malformed.
+    size_t ReadFseTable(const uint8_t* data, size_t size, uint32_t maxSymbol, uint32_t maxLog, FseTable& table)
+    {
+        // Bit reader, forward, low bits first; zeros past the end.
+        size_t bit = 0;
+        const auto read = [&](uint32_t bits, bool consume) -> uint32_t
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < bits; ++i)
+            {
+                const size_t at = bit + i;
+                if (at / 8 < size)
+                {
+                    value |= ((data[at / 8] >> (at % 8)) & 1u) << i;
+                }
+            }
+            if (consume)
+            {
+                bit += bits;
+            }
+            return value;
+        };
+
+        const uint32_t log = read(4, true) + 5;
+        if (log > maxLog)
+        {
+            return 0;
+        }
+
+        int16_t counts[256] = {};
+        int32_t remaining = (1 << log) + 1;
+        int32_t threshold = 1 << log;
+        uint32_t bits = log + 1;
+        uint32_t symbol = 0;
+        bool previousZero = false;
+        while (remaining > 1 && symbol <= maxSymbol)
+        {
+            if (previousZero)
+            {
+                // Runs of zero probabilities: 2-bit counts of extra zeros, 3 meaning more follow.
+                uint32_t repeat;
+                do
+                {
+                    repeat = read(2, true);
+                    symbol += repeat;
+                } while (repeat == 3);
+                if (symbol > maxSymbol)
+                {
+                    return 0;
+                }
+            }
+
+            const int32_t max = 2 * threshold - 1 - remaining;
+            int32_t value = static_cast<int32_t>(read(bits - 1, false));
+            if (value < max)
+            {
+                bit += bits - 1;
+            }
+            else
+            {
+                value = static_cast<int32_t>(read(bits, true));
+                if (value >= threshold)
+                {
+                    value -= max;
+                }
+            }
+
+            const int32_t count = value - 1;
+            remaining -= count < 0 ? -count : count;
+            counts[symbol++] = static_cast<int16_t>(count);
+            previousZero = count == 0;
+            while (remaining < threshold)
+            {
+                --bits;
+                threshold >>= 1;
+            }
+        }
+
+        const size_t bytes = (bit + 7) / 8;
+        if (remaining != 1 || bytes > size || !BuildFseTable(counts, symbol, log, table))
+        {
+            return 0;
+        }
+        return bytes;
+    }
+
+    struct HuffmanEntry
+    {
+        uint8_t Symbol;
+        uint8_t Bits;
+    };
+
+    struct HuffmanTable
+    {
+        std::vector<HuffmanEntry> Entries;  // Indexed by the next MaxBits bits.
+        uint32_t MaxBits = 0;
+    };
+
+    // Reads the Huffman tree description at the start of data and builds its table. Returns the
+    // bytes read, or 0 if malformed.
+    size_t ReadHuffmanTable(const uint8_t* data, size_t size, HuffmanTable& table)
+    {
+        if (size == 0)
+        {
+            return 0;
+        }
+
+        uint8_t weights[256] = {};
+        uint32_t weightCount = 0;
+        size_t bytes;
+        const uint32_t header = data[0];
+        if (header >= 128)
+        {
+            // 4-bit weights, two per byte, high nibble first.
+            weightCount = header - 127;
+            bytes = 1 + (weightCount + 1) / 2;
+            if (bytes > size)
+            {
+                return 0;
+            }
+            for (uint32_t i = 0; i < weightCount; ++i)
+            {
+                weights[i] = (data[1 + i / 2] >> (i % 2 == 0 ? 4 : 0)) & 15;
+            }
+        }
+        else
+        {
+            // FSE coded weights: two interleaved states over one bitstream, until it runs out.
+            bytes = 1 + header;
+            if (header == 0 || bytes > size)
+            {
+                return 0;
+            }
+            FseTable fse;
+            const size_t tableBytes = ReadFseTable(data + 1, header, 15, MaxHuffmanWeightLog, fse);
+            BackwardBitReader reader;
+            if (tableBytes == 0 || !reader.Init(data + 1 + tableBytes, header - tableBytes))
+            {
+                return 0;
+            }
+            uint32_t states[2] = { reader.Read(fse.Log), reader.Read(fse.Log) };
+            for (uint32_t current = 0;; current ^= 1)
+            {
+                if (weightCount >= 255)
+                {
+                    return 0;
+                }
+                const FseEntry& entry = fse.States[states[current]];
+                weights[weightCount++] = entry.Symbol;
+                states[current] = entry.NewState + reader.Read(entry.Bits);
+                if (reader.GetRemaining() < 0)
+                {
+                    weights[weightCount++] = fse.States[states[current ^ 1]].Symbol;
+                    break;
+                }
+            }
+        }
+
+        // The last symbol's weight is implied: it completes the sum to a power of two.
+        uint32_t total = 0;
+        for (uint32_t i = 0; i < weightCount; ++i)
+        {
+            if (weights[i] > MaxHuffmanBits)
+            {
+                return 0;
+            }
+            total += weights[i] ? 1u << (weights[i] - 1) : 0;
+        }
+        if (total == 0 || weightCount >= 256)
+        {
+            return 0;
+        }
+        const uint32_t maxBits = HighestBit(total) + 1;
+        const uint32_t rest = (1u << maxBits) - total;
+        if (maxBits > MaxHuffmanBits || (rest & (rest - 1)) != 0)
+        {
+            return 0;
+        }
+        weights[weightCount++] = static_cast<uint8_t>(HighestBit(rest) + 1);
+
+        // Canonical codes: the longest first, each length in symbol order.
+        uint32_t rankStart[MaxHuffmanBits + 2] = {};
+        for (uint32_t i = 0; i < weightCount; ++i)
+        {
+            if (weights[i])
+            {
+                rankStart[weights[i]] += 1u << (weights[i] - 1);
+            }
+        }
+        uint32_t position = 0;
+        for (uint32_t w = 1; w <= maxBits; ++w)
+        {
+            const uint32_t count = rankStart[w];
+            rankStart[w] = position;
+            position += count;
+        }
+
+        table.MaxBits = maxBits;
+        table.Entries.assign(size_t(1) << maxBits, HuffmanEntry());
+        for (uint32_t i = 0; i < weightCount; ++i)
+        {
+            const uint32_t w = weights[i];
+            if (w == 0)
+            {
+                continue;
+            }
+            const uint32_t length = 1u << (w - 1);
+            for (uint32_t j = 0; j < length; ++j)
+            {
+                table.Entries[rankStart[w] + j] = { static_cast<uint8_t>(i), static_cast<uint8_t>(maxBits + 1 - w) };
+            }
+            rankStart[w] += length;
+        }
+        return bytes;
+    }
+
+    bool DecodeHuffmanStream(const HuffmanTable& table, const uint8_t* data, size_t size, uint8_t* out, size_t count)
+    {
+        BackwardBitReader reader;
+        if (!reader.Init(data, size))
+        {
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            const HuffmanEntry& entry = table.Entries[reader.Peek(table.MaxBits)];
+            out[i] = entry.Symbol;
+            reader.Skip(entry.Bits);
+        }
+        return reader.GetRemaining() == 0;
+    }
+
+    // What carries over from one block of a frame to the next.
+    struct FrameState
+    {
+        HuffmanTable Huffman;
+        bool HasHuffman = false;
+        FseTable LiteralLengths;
+        FseTable Offsets;
+        FseTable MatchLengths;
+        bool HasTables[3] = {};
+        uint32_t RepeatOffsets[3] = { 1, 4, 8 };
+        std::vector<uint8_t> Literals;
+    };
+
+    // Reads the literals section of a compressed block into state.Literals. Returns the bytes
+    // read, or 0 if malformed.
+    size_t ReadLiterals(const uint8_t* data, size_t size, FrameState& state)
+    {
+        if (size == 0)
+        {
+            return 0;
+        }
+        const uint32_t type = data[0] & 3;
+        const uint32_t sizeFormat = (data[0] >> 2) & 3;
+
+        if (type < 2)
+        {
+            // Raw or RLE.
+            size_t headerSize;
+            size_t regenerated;
+            if ((sizeFormat & 1) == 0)
+            {
+                headerSize = 1;
+                regenerated = data[0] >> 3;
+            }
+            else if (sizeFormat == 1)
+            {
+                headerSize = 2;
+                if (size < headerSize)
+                {
+                    return 0;
+                }
+                regenerated = Read16(data) >> 4;
+            }
+            else
+            {
+                headerSize = 3;
+                if (size < headerSize)
+                {
+                    return 0;
+                }
+                regenerated = Read24(data) >> 4;
+            }
+            if (regenerated > MaxBlockSize)
+            {
+                return 0;
+            }
+            state.Literals.resize(regenerated);
+            if (type == 0)
+            {
+                if (size - headerSize < regenerated)
+                {
+                    return 0;
+                }
+                if (regenerated > 0)
+                {
+                    memcpy(state.Literals.data(), data + headerSize, regenerated);
+                }
+                return headerSize + regenerated;
+            }
+            if (size - headerSize < 1)
+            {
+                return 0;
+            }
+            memset(state.Literals.data(), data[headerSize], regenerated);
+            return headerSize + 1;
+        }
+
+        // Huffman coded, with a new tree (2) or the previous block's (3).
+        static const uint32_t HeaderSizes[4] = { 3, 3, 4, 5 };
+        static const uint32_t SizeBits[4] = { 10, 10, 14, 18 };
+        const size_t headerSize = HeaderSizes[sizeFormat];
+        if (size < headerSize)
+        {
+            return 0;
+        }
+        uint64_t header = 0;
+        for (size_t i = 0; i < headerSize; ++i)
+        {
+            header |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        const uint64_t sizeMask = (1ull << SizeBits[sizeFormat]) - 1;
+        const size_t regenerated = static_cast<size_t>((header >> 4) & sizeMask);
+        const size_t compressed = static_cast<size_t>((header >> (4 + SizeBits[sizeFormat])) & sizeMask);
+        const bool fourStreams = sizeFormat != 0;
+        if (regenerated > MaxBlockSize || compressed > size - headerSize)
+        {
+            return 0;
+        }
+
+        const uint8_t* in = data + headerSize;
+        size_t streamBytes = compressed;
+        if (type == 2)
+        {
+            const size_t treeBytes = ReadHuffmanTable(in, compressed, state.Huffman);
+            if (treeBytes == 0)
+            {
+                return 0;
+            }
+            state.HasHuffman = true;
+            in += treeBytes;
+            streamBytes -= treeBytes;
+        }
+        else if (!state.HasHuffman)
+        {
+            return 0;
+        }
+
+        state.Literals.resize(regenerated);
+        uint8_t* out = state.Literals.data();
+        if (!fourStreams)
+        {
+            return DecodeHuffmanStream(state.Huffman, in, streamBytes, out, regenerated) ? headerSize + compressed : 0;
+        }
+
+        // Four streams, each a quarter of the literals, after a table of the first three's sizes.
+        if (streamBytes < 6)
+        {
+            return 0;
+        }
+        const size_t sizes[3] = { Read16(in), Read16(in + 2), Read16(in + 4) };
+        in += 6;
+        streamBytes -= 6;
+        const size_t quarter = (regenerated + 3) / 4;
+        if (regenerated < 3 * quarter)
+        {
+            return 0;
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            const size_t bytes = i < 3 ? sizes[i] : streamBytes;
+            const size_t count = i < 3 ? quarter : regenerated - 3 * quarter;
+            if (bytes > streamBytes || !DecodeHuffmanStream(state.Huffman, in, bytes, out, count))
+            {
+                return 0;
+            }
+            in += bytes;
+            streamBytes -= bytes;
+            out += count;
+        }
+        return headerSize + compressed;
+    }
+
+    // Reads the table of one sequence code for the mode given. Returns the bytes read, or
+    // SIZE_MAX if malformed.
+    size_t ReadSequenceTable(uint32_t mode, const uint8_t* data, size_t size, const int16_t* defaults, uint32_t defaultCount,
+        uint32_t defaultLog, uint32_t maxSymbol, uint32_t maxLog, FseTable& table, bool& hasTable)
+    {
+        switch (mode)
+        {
+        case 0:
+            hasTable = BuildFseTable(defaults, defaultCount, defaultLog, table);
+            return 0;
+        case 1:
+            if (size < 1 || data[0] > maxSymbol)
+            {
+                return SIZE_MAX;
+            }
+            BuildRleTable(data[0], table);
+            hasTable = true;
+            return 1;
+        case 2:
+        {
+            const size_t bytes = ReadFseTable(data, size, maxSymbol, maxLog, table);
+            if (bytes == 0)
+            {
+                return SIZE_MAX;
+            }
+            hasTable = true;
+            return bytes;
+        }
+        default:
+            // Repeat: the previous block's table.
+            return hasTable ? 0 : SIZE_MAX;
+        }
+    }
+
+    bool DecompressBlock(const uint8_t* data, size_t size, uint8_t* outStart, uint8_t*& out, const uint8_t* outEnd, FrameState& state)
+    {
+        const size_t literalBytes = ReadLiterals(data, size, state);
+        if (literalBytes == 0)
+        {
+            return false;
+        }
+        const uint8_t* in = data + literalBytes;
+        const uint8_t* inEnd = data + size;
+
+        // Number of sequences.
+        if (in >= inEnd)
+        {
+            return false;
+        }
+        size_t sequenceCount = *in++;
+        if (sequenceCount >= 128)
+        {
+            if (sequenceCount == 255)
+            {
+                if (inEnd - in < 2)
+                {
+                    return false;
+                }
+                sequenceCount = Read16(in) + 0x7F00;
+                in += 2;
+            }
+            else
+            {
+                if (in >= inEnd)
+                {
+                    return false;
+                }
+                sequenceCount = ((sequenceCount - 128) << 8) + *in++;
+            }
+        }
+
+        const uint8_t* literals = state.Literals.data();
+        const uint8_t* literalsEnd = literals + state.Literals.size();
+        if (sequenceCount > 0)
+        {
+            if (in >= inEnd)
+            {
+                return false;
+            }
+            const uint32_t modes = *in++;
+            if ((modes & 3) != 0)
+            {
+                return false;
+            }
+            size_t bytes = ReadSequenceTable(modes >> 6, in, inEnd - in, DefaultLiteralLengths, MaxLiteralLengthCode + 1, 6,
+                MaxLiteralLengthCode, MaxLiteralLengthLog, state.LiteralLengths, state.HasTables[0]);
+            if (bytes == SIZE_MAX)
+            {
+                return false;
+            }
+            in += bytes;
+            bytes = ReadSequenceTable((modes >> 4) & 3, in, inEnd - in, DefaultOffsets, 29, 5, MaxOffsetCode, MaxOffsetLog,
+                state.Offsets, state.HasTables[1]);
+            if (bytes == SIZE_MAX)
+            {
+                return false;
+            }
+            in += bytes;
+            bytes = ReadSequenceTable((modes >> 2) & 3, in, inEnd - in, DefaultMatchLengths, MaxMatchLengthCode + 1, 6,
+                MaxMatchLengthCode, MaxMatchLengthLog, state.MatchLengths, state.HasTables[2]);
+            if (bytes == SIZE_MAX)
+            {
+                return false;
+            }
+            in += bytes;
+
+            BackwardBitReader reader;
+            if (!reader.Init(in, inEnd - in))
+            {
+                return false;
+            }
+            uint32_t literalLengthState = reader.Read(state.LiteralLengths.Log);
+            uint32_t offsetState = reader.Read(state.Offsets.Log);
+            uint32_t matchLengthState = reader.Read(state.MatchLengths.Log);
+            uint32_t* repeat = state.RepeatOffsets;
+
+            for (size_t i = 0; i < sequenceCount; ++i)
+            {
+                const FseEntry& literalLengthEntry = state.LiteralLengths.States[literalLengthState];
+                const FseEntry& offsetEntry = state.Offsets.States[offsetState];
+                const FseEntry& matchLengthEntry = state.MatchLengths.States[matchLengthState];
+
+                // Extra bits in order: offset, match length, literal length.
+                const uint32_t offsetCode = offsetEntry.Symbol;
+                if (offsetCode > MaxOffsetCode)
+                {
+                    return false;
+                }
+                const uint32_t offsetValue = (1u << offsetCode) + reader.Read(offsetCode);
+                const size_t matchLength = MatchLengthBase[matchLengthEntry.Symbol] + reader.Read(MatchLengthBits[matchLengthEntry.Symbol]);
+                const size_t literalLength = LiteralLengthBase[literalLengthEntry.Symbol] + reader.Read(LiteralLengthBits[literalLengthEntry.Symbol]);
+
+                size_t offset;
+                if (offsetValue > 3)
+                {
+                    offset = offsetValue - 3;
+                    repeat[2] = repeat[1];
+                    repeat[1] = repeat[0];
+                    repeat[0] = static_cast<uint32_t>(offset);
+                }
+                else
+                {
+                    // Repeat offsets, shifted by one after a sequence without literals.
+                    const uint32_t index = offsetValue - 1 + (literalLength == 0 ? 1 : 0);
+                    if (index == 0)
+                    {
+                        offset = repeat[0];
+                    }
+                    else
+                    {
+                        offset = index == 3 ? repeat[0] - 1 : repeat[index];
+                        if (index != 1)
+                        {
+                            repeat[2] = repeat[1];
+                        }
+                        repeat[1] = repeat[0];
+                        repeat[0] = static_cast<uint32_t>(offset);
+                    }
+                }
+
+                if (i + 1 < sequenceCount)
+                {
+                    literalLengthState = literalLengthEntry.NewState + reader.Read(literalLengthEntry.Bits);
+                    matchLengthState = matchLengthEntry.NewState + reader.Read(matchLengthEntry.Bits);
+                    offsetState = offsetEntry.NewState + reader.Read(offsetEntry.Bits);
+                }
+
+                if (static_cast<size_t>(literalsEnd - literals) < literalLength || static_cast<size_t>(outEnd - out) < literalLength)
+                {
+                    return false;
+                }
+                if (literalLength > 0)
+                {
+                    memcpy(out, literals, literalLength);
+                    literals += literalLength;
+                    out += literalLength;
+                }
+
+                if (offset == 0 || offset > static_cast<size_t>(out - outStart) || static_cast<size_t>(outEnd - out) < matchLength)
+                {
+                    return false;
+                }
+                const uint8_t* match = out - offset;
+                if (offset >= matchLength)
+                {
+                    memcpy(out, match, matchLength);
+                    out += matchLength;
+                }
+                else
+                {
+                    // Overlapping copy repeats the last offset bytes.
+                    for (size_t j = 0; j < matchLength; ++j)
+                    {
+                        *out++ = *match++;
+                    }
+                }
+            }
+            if (reader.GetRemaining() != 0)
+            {
+                return false;
+            }
+        }
+        else if (in != inEnd)
+        {
+            return false;
+        }
+
+        // The literals after the last match.
+        const size_t rest = literalsEnd - literals;
+        if (static_cast<size_t>(outEnd - out) < rest)
+        {
+            return false;
+        }
+        if (rest > 0)
+        {
+            memcpy(out, literals, rest);
+            out += rest;
+        }
+        return true;
+    }
+
+    // Decompresses the frame at in, after its magic number, advancing in and out past it.
+    bool DecompressFrame(const uint8_t*& in, const uint8_t* inEnd, uint8_t* outStart, uint8_t*& out, const uint8_t* outEnd)
+    {
+        if (in >= inEnd)
+        {
+            return false;
+        }
+        const uint32_t descriptor = *in++;
+        const uint32_t contentSizeFlag = descriptor >> 6;
+        const bool singleSegment = (descriptor & 0x20) != 0;
+        const bool checksum = (descriptor & 0x04) != 0;
+        const uint32_t dictionaryFlag = descriptor & 3;
+        if ((descriptor & 0x08) != 0 || dictionaryFlag != 0)
+        {
+            // Reserved bit, or a dictionary.
+            return false;
+        }
+
+        static const size_t ContentSizeBytes[4] = { 0, 2, 4, 8 };
+        const size_t headerRest = (singleSegment ? 0 : 1) + (contentSizeFlag == 0 && singleSegment ? 1 : ContentSizeBytes[contentSizeFlag]);
+        if (static_cast<size_t>(inEnd - in) < headerRest)
+        {
+            return false;
+        }
+        if (!singleSegment)
+        {
+            // Window descriptor: everything is decompressed into one buffer, so the window only
+            // bounds what a valid frame uses.
+            ++in;
+        }
+        uint64_t contentSize = UINT64_MAX;
+        switch (headerRest - (singleSegment ? 0 : 1))
+        {
+        case 1: contentSize = in[0]; break;
+        case 2: contentSize = Read16(in) + 256; break;
+        case 4: contentSize = Read32(in); break;
+        case 8: contentSize = Read64(in); break;
+        default: break;
+        }
+        in += headerRest - (singleSegment ? 0 : 1);
+        if (contentSize != UINT64_MAX && contentSize > static_cast<uint64_t>(outEnd - out))
+        {
+            return false;
+        }
+
+        uint8_t* const frameStart = out;
+        FrameState state;
+        for (bool last = false; !last;)
+        {
+            if (inEnd - in < 3)
+            {
+                return false;
+            }
+            const uint32_t header = Read24(in);
+            in += 3;
+            last = (header & 1) != 0;
+            const uint32_t type = (header >> 1) & 3;
+            const size_t size = header >> 3;
+            if (size > MaxBlockSize)
+            {
+                return false;
+            }
+            switch (type)
+            {
+            case 0:
+                if (static_cast<size_t>(inEnd - in) < size || static_cast<size_t>(outEnd - out) < size)
+                {
+                    return false;
+                }
+                if (size > 0)
+                {
+                    memcpy(out, in, size);
+                }
+                in += size;
+                out += size;
+                break;
+            case 1:
+                // RLE: size is the regenerated size, of one repeated byte.
+                if (in >= inEnd || static_cast<size_t>(outEnd - out) < size)
+                {
+                    return false;
+                }
+                if (size > 0)
+                {
+                    memset(out, *in, size);
+                }
+                ++in;
+                out += size;
+                break;
+            case 2:
+            {
+                if (static_cast<size_t>(inEnd - in) < size)
+                {
+                    return false;
+                }
+                uint8_t* const blockStart = out;
+                if (!DecompressBlock(in, size, outStart, out, outEnd, state) || static_cast<size_t>(out - blockStart) > MaxBlockSize)
+                {
+                    return false;
+                }
+                in += size;
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+
+        if (contentSize != UINT64_MAX && static_cast<uint64_t>(out - frameStart) != contentSize)
+        {
+            return false;
+        }
+        if (checksum)
+        {
+            if (inEnd - in < 4 || static_cast<uint32_t>(Xxh64(frameStart, out - frameStart)) != Read32(in))
+            {
+                return false;
+            }
+            in += 4;
+        }
+        return true;
+    }
+}
+
+bool ZstdDecompress(const void* source, size_t sourceSize, void* dest, size_t destSize)
+{
+    const uint8_t* in = static_cast<const uint8_t*>(source);
+    const uint8_t* inEnd = in + sourceSize;
+    uint8_t* outStart = static_cast<uint8_t*>(dest);
+    uint8_t* out = outStart;
+    const uint8_t* outEnd = outStart + destSize;
+
+    if (sourceSize == 0)
+    {
+        return false;
+    }
+    while (in < inEnd)
+    {
+        if (inEnd - in < 4)
+        {
+            return false;
+        }
+        const uint32_t magic = Read32(in);
+        in += 4;
+        if ((magic & 0xFFFFFFF0) == SkippableMagic)
+        {
+            if (inEnd - in < 4 || Read32(in) > static_cast<size_t>(inEnd - in) - 4)
+            {
+                return false;
+            }
+            in += 4 + Read32(in);
+            continue;
+        }
+        // Matches never reach into a previous frame.
+        uint8_t* frameStart = out;
+        if (magic != FrameMagic || !DecompressFrame(in, inEnd, frameStart, out, outEnd))
+        {
+            return false;
+        }
+    }
+    return out == outEnd;
+}
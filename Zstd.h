@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+// Zstandard decompression (RFC 8878), byte compatible with the reference ZSTD_decompress. Only
+// decompression is implemented: what it reads (KTX2 texture levels) is compressed offline by the
+// reference tools. Dictionaries are not supported.
+
+// Decompresses the frames in source, which must expand to exactly destSize bytes. Skippable frames
+// are skipped and content checksums verified. Malformed input never reads or writes out of
+// bounds; it just returns false. Matches are copied from the destination, so it should not be
+// write-combined memory such as a mapped upload heap.
+bool ZstdDecompress(const void* source, size_t sourceSize, void* dest, size_t destSize);